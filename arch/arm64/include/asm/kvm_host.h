@@ -1165,6 +1165,8 @@ static inline bool __vcpu_write_sys_reg_to_cpu(u64 val, int reg)
 
 struct kvm_vm_stat {
 	struct kvm_vm_stat_generic generic;
+	atomic64_t lpi_inject_cached;
+	atomic64_t lpi_inject_uncached;
 };
 
 struct kvm_vcpu_stat {
@@ -30,7 +30,9 @@
 #include "trace.h"
 
 const struct _kvm_stats_desc kvm_vm_stats_desc[] = {
-	KVM_GENERIC_VM_STATS()
+	KVM_GENERIC_VM_STATS(),
+	STATS_DESC_COUNTER(VM, lpi_inject_cached),
+	STATS_DESC_COUNTER(VM, lpi_inject_uncached)
 };
 
 const struct kvm_stats_header kvm_vm_stats_header = {
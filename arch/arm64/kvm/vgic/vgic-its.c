@@ -566,7 +566,8 @@ static unsigned long vgic_its_cache_key(u32 devid, u32 eventid)
 }
 
 static struct vgic_irq *vgic_its_check_cache(struct kvm *kvm, phys_addr_t db,
-					     u32 devid, u32 eventid)
+					     u32 devid, u32 eventid,
+					     struct vgic_its **itsp)
 {
 	unsigned long cache_key = vgic_its_cache_key(devid, eventid);
 	struct vgic_its *its;
@@ -578,6 +579,7 @@ static struct vgic_irq *vgic_its_check_cache(struct kvm *kvm, phys_addr_t db,
 	its = __vgic_doorbell_to_its(kvm, db);
 	if (IS_ERR(its))
 		return NULL;
+	*itsp = its;
 
 	rcu_read_lock();
 
@@ -728,14 +730,45 @@ static int vgic_its_trigger_msi(struct kvm *kvm, struct vgic_its *its,
 	return 0;
 }
 
+/*
+ * Injections can come from any CPU at a high rate, so they are counted per
+ * CPU and only added to the VM stats once a CPU has seen a batch of them.
+ * The stats fd can thus lag behind by up to a batch per CPU and ITS.
+ */
+#define VGIC_ITS_STAT_BATCH	64
+
+struct vgic_its_inject_stats {
+	u32	cached;
+	u32	uncached;
+};
+
+static void vgic_its_count(u32 __percpu *count, atomic64_t *stat)
+{
+	if (this_cpu_inc_return(*count) >= VGIC_ITS_STAT_BATCH)
+		atomic64_add(this_cpu_xchg(*count, 0), stat);
+}
+
+static void vgic_its_flush_stats(struct kvm *kvm, struct vgic_its *its)
+{
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		struct vgic_its_inject_stats *s = per_cpu_ptr(its->inject_stats, cpu);
+
+		atomic64_add(s->cached, &kvm->stat.lpi_inject_cached);
+		atomic64_add(s->uncached, &kvm->stat.lpi_inject_uncached);
+	}
+}
+
 int vgic_its_inject_cached_translation(struct kvm *kvm, struct kvm_msi *msi)
 {
+	struct vgic_its *its;
 	struct vgic_irq *irq;
 	unsigned long flags;
 	phys_addr_t db;
 
 	db = (u64)msi->address_hi << 32 | msi->address_lo;
-	irq = vgic_its_check_cache(kvm, db, msi->devid, msi->data);
+	irq = vgic_its_check_cache(kvm, db, msi->devid, msi->data, &its);
 	if (!irq)
 		return -EWOULDBLOCK;
 
@@ -743,6 +776,7 @@ int vgic_its_inject_cached_translation(struct kvm *kvm, struct kvm_msi *msi)
 	irq->pending_latch = true;
 	vgic_queue_irq_unlock(kvm, irq, flags);
 	vgic_put_irq(kvm, irq);
+	vgic_its_count(&its->inject_stats->cached, &kvm->stat.lpi_inject_cached);
 
 	return 0;
 }
@@ -772,6 +806,10 @@ int vgic_its_inject_msi(struct kvm *kvm, struct kvm_msi *msi)
 	if (ret < 0)
 		return ret;
 
+	if (!ret)
+		vgic_its_count(&its->inject_stats->uncached,
+			       &kvm->stat.lpi_inject_uncached);
+
 	/*
 	 * KVM_SIGNAL_MSI demands a return value > 0 for success and 0
 	 * if the guest has blocked the MSI. So we map any LPI mapping
@@ -1883,12 +1921,20 @@ static int vgic_its_create(struct kvm_device *dev, u32 type)
 	if (!its)
 		return -ENOMEM;
 
+	its->inject_stats = alloc_percpu_gfp(struct vgic_its_inject_stats,
+					     GFP_KERNEL_ACCOUNT);
+	if (!its->inject_stats) {
+		kfree(its);
+		return -ENOMEM;
+	}
+
 	mutex_lock(&dev->kvm->arch.config_lock);
 
 	if (vgic_initialized(dev->kvm)) {
 		ret = vgic_v4_init(dev->kvm);
 		if (ret < 0) {
 			mutex_unlock(&dev->kvm->arch.config_lock);
+			free_percpu(its->inject_stats);
 			kfree(its);
 			return ret;
 		}
@@ -1944,6 +1990,8 @@ static void vgic_its_destroy(struct kvm_device *kvm_dev)
 	xa_destroy(&its->translation_cache);
 
 	mutex_unlock(&its->its_lock);
+	vgic_its_flush_stats(kvm, its);
+	free_percpu(its->inject_stats);
 	kfree(its);
 	kfree(kvm_dev);/* alloc by kvm_ioctl_create_device, free by .destroy */
 }
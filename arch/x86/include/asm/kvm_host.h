@@ -1591,6 +1591,8 @@ struct kvm_vm_stat {
 	u64 nx_lpage_splits;
 	u64 max_mmu_page_hash_collisions;
 	u64 max_mmu_rmap_size;
+	u64 dirty_log_protect_pages;
+	u64 dirty_log_protect_ns;
 };
 
 struct kvm_vcpu_stat {
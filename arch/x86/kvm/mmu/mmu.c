@@ -41,6 +41,7 @@
 #include <linux/compiler.h>
 #include <linux/srcu.h>
 #include <linux/slab.h>
+#include <linux/sched/clock.h>
 #include <linux/sched/signal.h>
 #include <linux/uaccess.h>
 #include <linux/hash.h>
@@ -1419,6 +1420,8 @@ void kvm_arch_mmu_enable_log_dirty_pt_masked(struct kvm *kvm,
 				struct kvm_memory_slot *slot,
 				gfn_t gfn_offset, unsigned long mask)
 {
+	u64 start_ns = local_clock();
+
 	/*
 	 * If the slot was assumed to be "initially all dirty", write-protect
 	 * huge pages to ensure they are split to 4KiB on the first write (KVM
@@ -1460,6 +1463,10 @@ void kvm_arch_mmu_enable_log_dirty_pt_masked(struct kvm *kvm,
 		kvm_mmu_clear_dirty_pt_masked(kvm, slot, gfn_offset, mask);
 	else
 		kvm_mmu_write_protect_pt_masked(kvm, slot, gfn_offset, mask);
+
+	/* Harvesting for the dirty log and the dirty ring holds mmu_lock. */
+	kvm->stat.dirty_log_protect_pages += hweight_long(mask);
+	kvm->stat.dirty_log_protect_ns += local_clock() - start_ns;
 }
 
 int kvm_cpu_dirty_log_size(void)
@@ -527,6 +527,7 @@ static void broadcast_tlb_flush(struct flush_tlb_info *info)
 
 	/* Wait for the INVLPGBs kicked off above to finish. */
 	__tlbsync();
+	count_vm_tlb_event(NR_TLB_REMOTE_FLUSH_BROADCAST);
 }
 
 /*
@@ -1208,7 +1209,7 @@ static bool should_flush_tlb(int cpu, void *data)
 
 	/* Lazy TLB will get flushed at the next context switch. */
 	if (per_cpu(cpu_tlbstate_shared.is_lazy, cpu))
-		return false;
+		goto skip;
 
 	/* No mm means kernel memory flush. */
 	if (!info->mm)
@@ -1222,6 +1223,8 @@ static bool should_flush_tlb(int cpu, void *data)
 	if (info->trim_cpumask)
 		return true;
 
+skip:
+	count_vm_tlb_event(NR_TLB_REMOTE_FLUSH_SKIPPED);
 	return false;
 }
 
@@ -31,6 +31,10 @@ static unsigned int cryptd_max_cpu_qlen = 1000;
 module_param(cryptd_max_cpu_qlen, uint, 0);
 MODULE_PARM_DESC(cryptd_max_cpu_qlen, "Set cryptd Max queue depth");
 
+static unsigned int cryptd_batch = 1;
+module_param(cryptd_batch, uint, 0644);
+MODULE_PARM_DESC(cryptd_batch, "Max requests handled per cryptd work item run (default: 1)");
+
 static struct workqueue_struct *cryptd_wq;
 
 struct cryptd_cpu_queue {
@@ -163,22 +167,29 @@ static void cryptd_queue_worker(struct work_struct *work)
 {
 	struct cryptd_cpu_queue *cpu_queue;
 	struct crypto_async_request *req, *backlog;
+	unsigned int batch = max(READ_ONCE(cryptd_batch), 1U);
 
 	cpu_queue = container_of(work, struct cryptd_cpu_queue, work);
 	/*
-	 * Only handle one request at a time to avoid hogging crypto workqueue.
+	 * Only handle up to cryptd_batch requests at a time to avoid hogging
+	 * crypto workqueue.
 	 */
-	local_bh_disable();
-	backlog = crypto_get_backlog(&cpu_queue->queue);
-	req = crypto_dequeue_request(&cpu_queue->queue);
-	local_bh_enable();
+	while (batch--) {
+		local_bh_disable();
+		backlog = crypto_get_backlog(&cpu_queue->queue);
+		req = crypto_dequeue_request(&cpu_queue->queue);
+		local_bh_enable();
 
-	if (!req)
-		return;
+		if (!req)
+			return;
 
-	if (backlog)
-		crypto_request_complete(backlog, -EINPROGRESS);
-	crypto_request_complete(req, 0);
+		if (backlog)
+			crypto_request_complete(backlog, -EINPROGRESS);
+		crypto_request_complete(req, 0);
+
+		if (batch)
+			cond_resched();
+	}
 
 	if (cpu_queue->queue.qlen)
 		queue_work(cryptd_wq, &cpu_queue->work);
@@ -45,6 +45,12 @@ enum {
 	Lo_deleting,
 };
 
+struct loop_wait_stats {
+	u64			nr;
+	u64			ns;
+	u64			max_ns;
+};
+
 struct loop_device {
 	int		lo_number;
 	loff_t		lo_offset;
@@ -74,6 +80,9 @@ struct loop_device {
 	struct gendisk		*lo_disk;
 	struct mutex		lo_mutex;
 	bool			idr_visible;
+
+	/* time commands spend queued before reaching the backing file */
+	struct loop_wait_stats __percpu *lo_wait_stats;
 };
 
 struct loop_cmd {
@@ -85,11 +94,15 @@ struct loop_cmd {
 	struct bio_vec *bvec;
 	struct cgroup_subsys_state *blkcg_css;
 	struct cgroup_subsys_state *memcg_css;
+	u64 queued_ns;
 };
 
 #define LOOP_IDLE_WORKER_TIMEOUT (60 * HZ)
 #define LOOP_DEFAULT_HW_Q_DEPTH 128
 
+static bool auto_dio;
+static bool queue_wait_stats;
+
 static DEFINE_IDR(loop_index_idr);
 static DEFINE_MUTEX(loop_ctl_mutex);
 static DEFINE_MUTEX(loop_validate_mutex);
@@ -577,7 +590,8 @@ static void loop_assign_backing_file(struct loop_device *lo, struct file *file)
 	lo->old_gfp_mask = mapping_gfp_mask(file->f_mapping);
 	mapping_set_gfp_mask(file->f_mapping,
 			lo->old_gfp_mask & ~(__GFP_IO | __GFP_FS));
-	if (lo->lo_backing_file->f_flags & O_DIRECT)
+	/* loop_update_dio() drops the flag again if the file can't do it */
+	if ((lo->lo_backing_file->f_flags & O_DIRECT) || auto_dio)
 		lo->lo_flags |= LO_FLAGS_DIRECT_IO;
 	lo->lo_min_dio_size = loop_query_min_dio_size(lo);
 }
@@ -752,12 +766,57 @@ static ssize_t loop_attr_dio_show(struct loop_device *lo, char *buf)
 	return sysfs_emit(buf, "%s\n", dio ? "1" : "0");
 }
 
+static ssize_t loop_attr_queue_wait_show(struct loop_device *lo, char *buf)
+{
+	u64 nr = 0, ns = 0, max_ns = 0;
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		struct loop_wait_stats *stats = per_cpu_ptr(lo->lo_wait_stats, cpu);
+
+		nr += READ_ONCE(stats->nr);
+		ns += READ_ONCE(stats->ns);
+		max_ns = max(max_ns, READ_ONCE(stats->max_ns));
+	}
+
+	return sysfs_emit(buf, "%llu %llu %llu\n", nr,
+			  nr ? div64_u64(ns, nr * NSEC_PER_USEC) : 0,
+			  div_u64(max_ns, NSEC_PER_USEC));
+}
+
+static void loop_reset_wait_stats(struct loop_device *lo)
+{
+	int cpu;
+
+	for_each_possible_cpu(cpu)
+		memset(per_cpu_ptr(lo->lo_wait_stats, cpu), 0,
+		       sizeof(struct loop_wait_stats));
+}
+
+static void loop_account_wait(struct loop_device *lo, struct loop_cmd *cmd)
+{
+	struct loop_wait_stats *stats;
+	u64 wait;
+
+	if (!cmd->queued_ns)
+		return;
+
+	wait = ktime_get_ns() - cmd->queued_ns;
+	stats = get_cpu_ptr(lo->lo_wait_stats);
+	stats->nr++;
+	stats->ns += wait;
+	if (wait > stats->max_ns)
+		stats->max_ns = wait;
+	put_cpu_ptr(lo->lo_wait_stats);
+}
+
 LOOP_ATTR_RO(backing_file);
 LOOP_ATTR_RO(offset);
 LOOP_ATTR_RO(sizelimit);
 LOOP_ATTR_RO(autoclear);
 LOOP_ATTR_RO(partscan);
 LOOP_ATTR_RO(dio);
+LOOP_ATTR_RO(queue_wait);
 
 static struct attribute *loop_attrs[] = {
 	&loop_attr_backing_file.attr,
@@ -766,6 +825,7 @@ static struct attribute *loop_attrs[] = {
 	&loop_attr_autoclear.attr,
 	&loop_attr_partscan.attr,
 	&loop_attr_dio.attr,
+	&loop_attr_queue_wait.attr,
 	NULL,
 };
 
@@ -1168,6 +1228,7 @@ static void __loop_clr_fd(struct loop_device *lo)
 	lo->lo_offset = 0;
 	lo->lo_sizelimit = 0;
 	memset(lo->lo_file_name, 0, LO_NAME_SIZE);
+	loop_reset_wait_stats(lo);
 
 	/*
 	 * Reset the block size to the default.
@@ -1781,6 +1842,7 @@ static void lo_free_disk(struct gendisk *disk)
 	loop_free_idle_workers(lo, true);
 	timer_shutdown_sync(&lo->timer);
 	mutex_destroy(&lo->lo_mutex);
+	free_percpu(lo->lo_wait_stats);
 	kfree(lo);
 }
 
@@ -1865,6 +1927,35 @@ static const struct kernel_param_ops loop_hw_qdepth_param_ops = {
 device_param_cb(hw_queue_depth, &loop_hw_qdepth_param_ops, &hw_queue_depth, 0444);
 MODULE_PARM_DESC(hw_queue_depth, "Queue depth for each hardware queue. Default: " __stringify(LOOP_DEFAULT_HW_Q_DEPTH));
 
+static int nr_hw_queues = 1;
+
+static int loop_set_nr_hw_queues(const char *s, const struct kernel_param *p)
+{
+	int nr, ret;
+
+	ret = kstrtoint(s, 0, &nr);
+	if (ret < 0)
+		return ret;
+	if (nr < 1)
+		return -EINVAL;
+	nr_hw_queues = nr;
+	return 0;
+}
+
+static const struct kernel_param_ops loop_nr_hw_queues_param_ops = {
+	.set	= loop_set_nr_hw_queues,
+	.get	= param_get_int,
+};
+
+device_param_cb(nr_hw_queues, &loop_nr_hw_queues_param_ops, &nr_hw_queues, 0444);
+MODULE_PARM_DESC(nr_hw_queues, "Number of hardware queues, capped at the number of CPUs. Default: 1");
+
+module_param(auto_dio, bool, 0644);
+MODULE_PARM_DESC(auto_dio, "Use direct I/O to the backing file whenever it supports it");
+
+module_param(queue_wait_stats, bool, 0644);
+MODULE_PARM_DESC(queue_wait_stats, "Account the time commands wait before reaching the backing file, see loop/queue_wait");
+
 MODULE_DESCRIPTION("Loopback device support");
 MODULE_LICENSE("GPL");
 MODULE_ALIAS_BLOCKDEV_MAJOR(LOOP_MAJOR);
@@ -1881,6 +1972,8 @@ static blk_status_t loop_queue_rq(struct blk_mq_hw_ctx *hctx,
 	if (lo->lo_state != Lo_bound)
 		return BLK_STS_IOERR;
 
+	cmd->queued_ns = READ_ONCE(queue_wait_stats) ? ktime_get_ns() : 0;
+
 	switch (req_op(rq)) {
 	case REQ_OP_FLUSH:
 	case REQ_OP_DISCARD:
@@ -1923,6 +2016,8 @@ static void loop_handle_cmd(struct loop_cmd *cmd)
 	struct mem_cgroup *old_memcg = NULL;
 	const bool use_aio = cmd->use_aio;
 
+	loop_account_wait(lo, cmd);
+
 	if (write && (lo->lo_flags & LO_FLAGS_READ_ONLY)) {
 		ret = -EIO;
 		goto failed;
@@ -2030,6 +2125,9 @@ static int loop_add(int i)
 	lo = kzalloc(sizeof(*lo), GFP_KERNEL);
 	if (!lo)
 		goto out;
+	lo->lo_wait_stats = alloc_percpu(struct loop_wait_stats);
+	if (!lo->lo_wait_stats)
+		goto out_free_dev;
 	lo->worker_tree = RB_ROOT;
 	INIT_LIST_HEAD(&lo->idle_worker_list);
 	timer_setup(&lo->timer, loop_free_idle_workers_timer, TIMER_DEFERRABLE);
@@ -2053,7 +2151,8 @@ static int loop_add(int i)
 	i = err;
 
 	lo->tag_set.ops = &loop_mq_ops;
-	lo->tag_set.nr_hw_queues = 1;
+	lo->tag_set.nr_hw_queues = min_t(unsigned int, nr_hw_queues,
+					 nr_cpu_ids);
 	lo->tag_set.queue_depth = hw_queue_depth;
 	lo->tag_set.numa_node = NUMA_NO_NODE;
 	lo->tag_set.cmd_size = sizeof(struct loop_cmd);
@@ -2127,6 +2226,7 @@ static int loop_add(int i)
 	idr_remove(&loop_index_idr, i);
 	mutex_unlock(&loop_ctl_mutex);
 out_free_dev:
+	free_percpu(lo->lo_wait_stats);
 	kfree(lo);
 out:
 	return err;
@@ -63,6 +63,11 @@ struct nbd_sock {
 	int fallback_index;
 	int cookie;
 	struct work_struct work;
+
+	/* requests and payload bytes fully sent, under tx_lock */
+	u64 nr_sent;
+	u64 bytes_sent;
+	atomic64_t nr_replies;
 };
 
 struct recv_thread_args {
@@ -744,6 +749,14 @@ static blk_status_t nbd_send_cmd(struct nbd_device *nbd, struct nbd_cmd *cmd,
 			bool is_last = !next && bio_iter_last(bvec, iter);
 			int flags = is_last ? 0 : MSG_MORE;
 
+			/*
+			 * The request is only completed once the server has
+			 * replied, i.e. received the payload, so the pages
+			 * can be handed to the socket without a copy.
+			 */
+			if (sendpage_ok(bvec.bv_page))
+				flags |= MSG_SPLICE_PAGES;
+
 			dev_dbg(nbd_to_dev(nbd), "request %p: sending %d bytes data\n",
 				req, bvec.bv_len);
 			iov_iter_bvec(&from, ITER_SOURCE, &bvec, 1, bvec.bv_len);
@@ -781,6 +794,10 @@ static blk_status_t nbd_send_cmd(struct nbd_device *nbd, struct nbd_cmd *cmd,
 	trace_nbd_payload_sent(req, handle);
 	nsock->pending = NULL;
 	nsock->sent = 0;
+	WRITE_ONCE(nsock->nr_sent, nsock->nr_sent + 1);
+	if (type == NBD_CMD_WRITE)
+		WRITE_ONCE(nsock->bytes_sent,
+			   nsock->bytes_sent + blk_rq_bytes(req));
 	__set_bit(NBD_CMD_INFLIGHT, &cmd->flags);
 	return BLK_STS_OK;
 
@@ -999,6 +1016,7 @@ static void recv_work(struct work_struct *work)
 			percpu_ref_put(&q->q_usage_counter);
 			break;
 		}
+		atomic64_inc(&nsock->nr_replies);
 
 		rq = blk_mq_rq_from_pdu(cmd);
 		if (likely(!blk_should_fake_timeout(rq->q))) {
@@ -1111,6 +1129,43 @@ static int wait_for_reconnect(struct nbd_device *nbd)
 	return !test_bit(NBD_RT_DISCONNECTED, &config->runtime_flags);
 }
 
+static u64 nbd_sock_inflight(struct nbd_sock *nsock)
+{
+	u64 sent = READ_ONCE(nsock->nr_sent);
+	u64 replies = atomic64_read(&nsock->nr_replies);
+
+	return sent > replies ? sent - replies : 0;
+}
+
+/*
+ * Requests normally go out on the connection matching their hctx.  If that
+ * connection is backed up, move the request to a live connection carrying
+ * less than half as many outstanding requests so one slow link doesn't
+ * throttle the device.
+ */
+static int nbd_pick_sock(struct nbd_config *config, int index)
+{
+	u64 best = nbd_sock_inflight(config->socks[index]);
+	int i, pick = index;
+
+	if (best < 2)
+		return index;
+
+	for (i = 0; i < config->num_connections; i++) {
+		struct nbd_sock *nsock = config->socks[i];
+		u64 inflight;
+
+		if (i == index || READ_ONCE(nsock->dead))
+			continue;
+		inflight = nbd_sock_inflight(nsock);
+		if (inflight * 2 < best) {
+			best = inflight * 2;
+			pick = i;
+		}
+	}
+	return pick;
+}
+
 static blk_status_t nbd_handle_cmd(struct nbd_cmd *cmd, int index)
 {
 	struct request *req = blk_mq_rq_from_pdu(cmd);
@@ -1134,6 +1189,8 @@ static blk_status_t nbd_handle_cmd(struct nbd_cmd *cmd, int index)
 		nbd_config_put(nbd);
 		return BLK_STS_IOERR;
 	}
+	if (config->num_connections > 1)
+		index = nbd_pick_sock(config, index);
 	cmd->status = BLK_STS_OK;
 again:
 	nsock = config->socks[index];
@@ -1767,6 +1824,35 @@ static int nbd_dbg_tasks_show(struct seq_file *s, void *unused)
 
 DEFINE_SHOW_ATTRIBUTE(nbd_dbg_tasks);
 
+static int nbd_dbg_socks_show(struct seq_file *s, void *unused)
+{
+	struct nbd_device *nbd = s->private;
+	struct nbd_config *config = nbd->config;
+	int i;
+
+	/*
+	 * nbd_config_put() removes this file with config_lock held, so
+	 * don't wait for it here.
+	 */
+	if (!mutex_trylock(&nbd->config_lock))
+		return -EBUSY;
+	for (i = 0; i < config->num_connections; i++) {
+		struct nbd_sock *nsock = config->socks[i];
+
+		seq_printf(s, "%d: sent %llu bytes %llu replies %lld inflight %llu%s\n",
+			   i, READ_ONCE(nsock->nr_sent),
+			   READ_ONCE(nsock->bytes_sent),
+			   atomic64_read(&nsock->nr_replies),
+			   nbd_sock_inflight(nsock),
+			   READ_ONCE(nsock->dead) ? " dead" : "");
+	}
+	mutex_unlock(&nbd->config_lock);
+
+	return 0;
+}
+
+DEFINE_SHOW_ATTRIBUTE(nbd_dbg_socks);
+
 static int nbd_dbg_flags_show(struct seq_file *s, void *unused)
 {
 	struct nbd_device *nbd = s->private;
@@ -1817,6 +1903,7 @@ static int nbd_dev_dbg_init(struct nbd_device *nbd)
 	debugfs_create_u32("timeout", 0444, dir, &nbd->tag_set.timeout);
 	debugfs_create_u32("blocksize_bits", 0444, dir, &config->blksize_bits);
 	debugfs_create_file("flags", 0444, dir, nbd, &nbd_dbg_flags_fops);
+	debugfs_create_file("socks", 0444, dir, nbd, &nbd_dbg_socks_fops);
 
 	return 0;
 }
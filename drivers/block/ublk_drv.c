@@ -44,6 +44,7 @@
 #include <linux/task_work.h>
 #include <linux/namei.h>
 #include <linux/kref.h>
+#include <linux/debugfs.h>
 #include <uapi/linux/ublk_cmd.h>
 
 #define UBLK_MINORS		(1U << MINORBITS)
@@ -166,6 +167,10 @@ struct ublk_queue {
 	bool fail_io; /* copy of dev->state == UBLK_S_DEV_FAIL_IO */
 	unsigned short nr_io_ready;	/* how many ios setup */
 	spinlock_t		cancel_lock;
+
+	/* updated from the daemon's task work only */
+	unsigned long		nr_dispatch_batches;
+	unsigned long		nr_dispatched;
 	struct ublk_device *dev;
 	struct ublk_io ios[];
 };
@@ -201,6 +206,8 @@ struct ublk_device {
 	unsigned int		nr_privileged_daemon;
 
 	struct work_struct	nosrv_work;
+
+	struct dentry		*debugfs;
 };
 
 /* header of ublk_params */
@@ -1272,6 +1279,8 @@ static void ublk_cmd_tw_cb(struct io_uring_cmd *cmd,
 	struct ublk_uring_cmd_pdu *pdu = ublk_get_uring_cmd_pdu(cmd);
 	struct ublk_queue *ubq = pdu->ubq;
 
+	WRITE_ONCE(ubq->nr_dispatch_batches, ubq->nr_dispatch_batches + 1);
+	WRITE_ONCE(ubq->nr_dispatched, ubq->nr_dispatched + 1);
 	ublk_dispatch_req(ubq, pdu->req, issue_flags);
 }
 
@@ -1291,13 +1300,18 @@ static void ublk_cmd_list_tw_cb(struct io_uring_cmd *cmd,
 	struct request *rq = pdu->req_list;
 	struct ublk_queue *ubq = pdu->ubq;
 	struct request *next;
+	unsigned long nr = 0;
 
 	do {
 		next = rq->rq_next;
 		rq->rq_next = NULL;
 		ublk_dispatch_req(ubq, rq, issue_flags);
 		rq = next;
+		nr++;
 	} while (rq);
+
+	WRITE_ONCE(ubq->nr_dispatch_batches, ubq->nr_dispatch_batches + 1);
+	WRITE_ONCE(ubq->nr_dispatched, ubq->nr_dispatched + nr);
 }
 
 static void ublk_queue_cmd_list(struct ublk_queue *ubq, struct rq_list *l)
@@ -2334,6 +2348,28 @@ static void ublk_cdev_rel(struct device *dev)
 	kfree(ub);
 }
 
+static struct dentry *ublk_debugfs_root;
+
+/*
+ * Per queue "<batches> <requests>" handed to the server through task work,
+ * so the average number of requests per round trip can be derived.
+ */
+static int dispatch_stats_show(struct seq_file *m, void *unused)
+{
+	struct ublk_device *ub = m->private;
+	int i;
+
+	for (i = 0; i < ub->dev_info.nr_hw_queues; i++) {
+		struct ublk_queue *ubq = ublk_get_queue(ub, i);
+
+		seq_printf(m, "%d %lu %lu\n", i,
+			   READ_ONCE(ubq->nr_dispatch_batches),
+			   READ_ONCE(ubq->nr_dispatched));
+	}
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(dispatch_stats);
+
 static int ublk_add_chdev(struct ublk_device *ub)
 {
 	struct device *dev = &ub->cdev_dev;
@@ -2357,6 +2393,10 @@ static int ublk_add_chdev(struct ublk_device *ub)
 
 	if (ub->dev_info.flags & UBLK_F_UNPRIVILEGED_DEV)
 		unprivileged_ublks_added++;
+
+	ub->debugfs = debugfs_create_dir(dev_name(dev), ublk_debugfs_root);
+	debugfs_create_file("dispatch_stats", 0400, ub->debugfs, ub,
+			    &dispatch_stats_fops);
 	return 0;
  fail:
 	put_device(dev);
@@ -2387,6 +2427,7 @@ static void ublk_remove(struct ublk_device *ub)
 {
 	bool unprivileged;
 
+	debugfs_remove_recursive(ub->debugfs);
 	ublk_stop_dev(ub);
 	cancel_work_sync(&ub->nosrv_work);
 	cdev_device_del(&ub->cdev, &ub->cdev_dev);
@@ -3276,6 +3317,7 @@ static int __init ublk_init(void)
 	if (ret)
 		goto free_chrdev_region;
 
+	ublk_debugfs_root = debugfs_create_dir("ublk", NULL);
 	return 0;
 
 free_chrdev_region:
@@ -3293,6 +3335,7 @@ static void __exit ublk_exit(void)
 	idr_for_each_entry(&ublk_index_idr, ub, id)
 		ublk_remove(ub);
 
+	debugfs_remove_recursive(ublk_debugfs_root);
 	class_unregister(&ublk_chr_class);
 	misc_deregister(&ublk_misc);
 
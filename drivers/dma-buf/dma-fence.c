@@ -14,6 +14,7 @@
 #include <linux/export.h>
 #include <linux/atomic.h>
 #include <linux/dma-fence.h>
+#include <linux/sched/clock.h>
 #include <linux/sched/signal.h>
 #include <linux/seq_file.h>
 
@@ -369,6 +370,8 @@ int dma_fence_signal_timestamp_locked(struct dma_fence *fence,
 {
 	struct dma_fence_cb *cur, *tmp;
 	struct list_head cb_list;
+	unsigned int nr = 0;
+	u64 start = 0;
 
 	lockdep_assert_held(fence->lock);
 
@@ -383,11 +386,19 @@ int dma_fence_signal_timestamp_locked(struct dma_fence *fence,
 	set_bit(DMA_FENCE_FLAG_TIMESTAMP_BIT, &fence->flags);
 	trace_dma_fence_signaled(fence);
 
+	if (trace_dma_fence_callbacks_enabled())
+		start = local_clock();
+
 	list_for_each_entry_safe(cur, tmp, &cb_list, node) {
 		INIT_LIST_HEAD(&cur->node);
 		cur->func(fence, cur);
+		nr++;
 	}
 
+	/* Callbacks run under the fence lock, so this is also its hold time. */
+	if (start)
+		trace_dma_fence_callbacks(fence, nr, local_clock() - start);
+
 	return 0;
 }
 EXPORT_SYMBOL(dma_fence_signal_timestamp_locked);
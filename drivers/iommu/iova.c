@@ -5,6 +5,8 @@
  * Author: Anil S Keshavamurthy <anil.s.keshavamurthy@intel.com>
  */
 
+#include <linux/debugfs.h>
+#include <linux/iommu.h>
 #include <linux/iova.h>
 #include <linux/kmemleak.h>
 #include <linux/module.h>
@@ -12,12 +14,61 @@
 #include <linux/smp.h>
 #include <linux/bitops.h>
 #include <linux/cpu.h>
+#include <linux/seq_file.h>
 #include <linux/workqueue.h>
 
 /* The anchor node sits above the top of the usable address space */
 #define IOVA_ANCHOR	~0UL
 
-#define IOVA_RANGE_CACHE_MAX_SIZE 6	/* log of max cached IOVA range size (in pages) */
+/*
+ * Every cached size costs two magazines per CPU in every domain, so only
+ * sizes up to 32 pages are cached by default. Larger orders suit devices
+ * that map 64K-2M buffers.
+ */
+#define IOVA_RCACHE_MAX_ORDER_LIMIT 10
+static unsigned int iova_rcache_max_order __read_mostly = 5;
+
+static int iova_rcache_max_order_set(const char *val,
+				     const struct kernel_param *kp)
+{
+	return param_set_uint_minmax(val, kp, 0, IOVA_RCACHE_MAX_ORDER_LIMIT);
+}
+
+static const struct kernel_param_ops iova_rcache_max_order_ops = {
+	.set	= iova_rcache_max_order_set,
+	.get	= param_get_uint,
+};
+module_param_cb(rcache_max_order, &iova_rcache_max_order_ops,
+		&iova_rcache_max_order, 0444);
+MODULE_PARM_DESC(rcache_max_order,
+		 "Order of the largest IOVA range (in pages) cached per CPU (default: 5)");
+
+/* log of max cached IOVA range size (in pages) */
+#define IOVA_RANGE_CACHE_MAX_SIZE (iova_rcache_max_order + 1)
+
+#ifdef CONFIG_IOMMU_DEBUGFS
+struct iova_rcache_stats {
+	unsigned long hit[IOVA_RCACHE_MAX_ORDER_LIMIT + 1];
+	unsigned long miss[IOVA_RCACHE_MAX_ORDER_LIMIT + 1];
+	unsigned long uncached;
+};
+static DEFINE_PER_CPU(struct iova_rcache_stats, iova_rcache_stats);
+static struct dentry *iova_rcache_stats_file;
+
+static void iova_rcache_count(unsigned int log_size, bool hit)
+{
+	if (log_size >= IOVA_RANGE_CACHE_MAX_SIZE)
+		this_cpu_inc(iova_rcache_stats.uncached);
+	else if (hit)
+		this_cpu_inc(iova_rcache_stats.hit[log_size]);
+	else
+		this_cpu_inc(iova_rcache_stats.miss[log_size]);
+}
+#else
+static inline void iova_rcache_count(unsigned int log_size, bool hit)
+{
+}
+#endif
 
 static bool iova_rcache_insert(struct iova_domain *iovad,
 			       unsigned long pfn,
@@ -864,11 +915,16 @@ static unsigned long iova_rcache_get(struct iova_domain *iovad,
 				     unsigned long limit_pfn)
 {
 	unsigned int log_size = order_base_2(size);
+	unsigned long iova_pfn;
 
-	if (log_size >= IOVA_RANGE_CACHE_MAX_SIZE)
+	if (log_size >= IOVA_RANGE_CACHE_MAX_SIZE) {
+		iova_rcache_count(log_size, false);
 		return 0;
+	}
 
-	return __iova_rcache_get(&iovad->rcaches[log_size], limit_pfn - size);
+	iova_pfn = __iova_rcache_get(&iovad->rcaches[log_size], limit_pfn - size);
+	iova_rcache_count(log_size, iova_pfn);
+	return iova_pfn;
 }
 
 /*
@@ -950,6 +1006,29 @@ static int iova_cpuhp_dead(unsigned int cpu, struct hlist_node *node)
 	return 0;
 }
 
+#ifdef CONFIG_IOMMU_DEBUGFS
+static int iova_rcache_stats_show(struct seq_file *m, void *v)
+{
+	unsigned long hit, miss, uncached = 0;
+	unsigned int cpu, i;
+
+	seq_puts(m, "order hit miss\n");
+	for (i = 0; i < IOVA_RANGE_CACHE_MAX_SIZE; i++) {
+		hit = miss = 0;
+		for_each_possible_cpu(cpu) {
+			hit += per_cpu(iova_rcache_stats.hit[i], cpu);
+			miss += per_cpu(iova_rcache_stats.miss[i], cpu);
+		}
+		seq_printf(m, "%5u %lu %lu\n", i, hit, miss);
+	}
+	for_each_possible_cpu(cpu)
+		uncached += per_cpu(iova_rcache_stats.uncached, cpu);
+	seq_printf(m, "uncached %lu\n", uncached);
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(iova_rcache_stats);
+#endif
+
 int iova_cache_get(void)
 {
 	int err = -ENOMEM;
@@ -973,6 +1052,13 @@ int iova_cache_get(void)
 			pr_err("IOVA: Couldn't register cpuhp handler: %pe\n", ERR_PTR(err));
 			goto out_err;
 		}
+#ifdef CONFIG_IOMMU_DEBUGFS
+		if (iommu_debugfs_dir)
+			iova_rcache_stats_file =
+				debugfs_create_file("iova_rcache", 0444,
+						    iommu_debugfs_dir, NULL,
+						    &iova_rcache_stats_fops);
+#endif
 	}
 
 	iova_cache_users++;
@@ -997,6 +1083,9 @@ void iova_cache_put(void)
 	}
 	iova_cache_users--;
 	if (!iova_cache_users) {
+#ifdef CONFIG_IOMMU_DEBUGFS
+		debugfs_remove(iova_rcache_stats_file);
+#endif
 		cpuhp_remove_multi_state(CPUHP_IOMMU_IOVA_DEAD);
 		kmem_cache_destroy(iova_cache);
 		kmem_cache_destroy(iova_magazine_cache);
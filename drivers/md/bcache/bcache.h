@@ -341,6 +341,14 @@ struct cached_dev {
 
 	/* Limit number of writeback bios in flight */
 	struct semaphore	in_flight;
+	atomic_t		writeback_in_flight_nr;
+	/*
+	 * Backing device distance covered between consecutive writebacks,
+	 * only updated by the writeback thread.
+	 */
+	uint64_t		writeback_last_end;
+	uint64_t		writeback_seek_sectors;
+	uint64_t		writeback_seek_nr;
 	struct task_struct	*writeback_thread;
 	struct workqueue_struct	*writeback_write_wq;
 
@@ -714,6 +722,8 @@ struct cache_set {
 	struct time_stats	btree_read_time;
 
 	atomic_long_t		cache_read_races;
+	atomic_long_t		btree_cache_hits;
+	atomic_long_t		btree_cache_misses;
 	atomic_long_t		writeback_keys_done;
 	atomic_long_t		writeback_keys_failed;
 
@@ -1019,6 +1019,8 @@ struct btree *bch_btree_node_get(struct cache_set *c, struct btree_op *op,
 		if (current->bio_list)
 			return ERR_PTR(-EAGAIN);
 
+		atomic_long_inc(&c->btree_cache_misses);
+
 		mutex_lock(&c->bucket_lock);
 		b = mca_alloc(c, op, k, level);
 		mutex_unlock(&c->bucket_lock);
@@ -1039,6 +1041,7 @@ struct btree *bch_btree_node_get(struct cache_set *c, struct btree_op *op,
 			goto retry;
 		}
 		BUG_ON(b->level != level);
+		atomic_long_inc(&c->btree_cache_hits);
 	}
 
 	if (btree_node_io_error(b)) {
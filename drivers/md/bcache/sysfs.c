@@ -95,6 +95,8 @@ read_attribute(feature_incompat);
 
 read_attribute(state);
 read_attribute(cache_read_races);
+read_attribute(btree_cache_hits);
+read_attribute(btree_cache_misses);
 read_attribute(reclaim);
 read_attribute(reclaimed_journal_buckets);
 read_attribute(flush_write);
@@ -221,6 +223,7 @@ SHOW(__bch_cached_dev)
 		char proportional[20];
 		char integral[20];
 		char change[20];
+		char seek[20];
 		s64 next_io;
 
 		/*
@@ -239,6 +242,9 @@ SHOW(__bch_cached_dev)
 		bch_hprint(change, wb ? dc->writeback_rate_change << 9 : 0);
 		next_io = wb ? div64_s64(dc->writeback_rate.next-local_clock(),
 					 NSEC_PER_MSEC) : 0;
+		bch_hprint(seek, dc->writeback_seek_nr ?
+			   div64_u64(dc->writeback_seek_sectors,
+				     dc->writeback_seek_nr) << 9 : 0);
 
 		return sprintf(buf,
 			       "rate:\t\t%s/sec\n"
@@ -247,9 +253,12 @@ SHOW(__bch_cached_dev)
 			       "proportional:\t%s\n"
 			       "integral:\t%s\n"
 			       "change:\t\t%s/sec\n"
-			       "next io:\t%llims\n",
+			       "next io:\t%llims\n"
+			       "in flight:\t%i\n"
+			       "avg seek:\t%s\n",
 			       rate, dirty, target, proportional,
-			       integral, change, next_io);
+			       integral, change, next_io,
+			       atomic_read(&dc->writeback_in_flight_nr), seek);
 	}
 
 	sysfs_hprint(dirty_data,
@@ -751,6 +760,11 @@ SHOW(__bch_cache_set)
 	sysfs_print(cache_read_races,
 		    atomic_long_read(&c->cache_read_races));
 
+	sysfs_print(btree_cache_hits,
+		    atomic_long_read(&c->btree_cache_hits));
+	sysfs_print(btree_cache_misses,
+		    atomic_long_read(&c->btree_cache_misses));
+
 	sysfs_print(reclaim,
 		    atomic_long_read(&c->reclaim));
 
@@ -849,6 +863,8 @@ STORE(__bch_cache_set)
 	if (attr == &sysfs_clear_stats) {
 		atomic_long_set(&c->writeback_keys_done,	0);
 		atomic_long_set(&c->writeback_keys_failed,	0);
+		atomic_long_set(&c->btree_cache_hits,		0);
+		atomic_long_set(&c->btree_cache_misses,		0);
 
 		memset(&c->gc_stats, 0, sizeof(struct gc_stat));
 		bch_cache_accounting_clear(&c->accounting);
@@ -996,6 +1012,8 @@ static struct attribute *bch_cache_set_internal_attrs[] = {
 
 	&sysfs_bset_tree_stats,
 	&sysfs_cache_read_races,
+	&sysfs_btree_cache_hits,
+	&sysfs_btree_cache_misses,
 	&sysfs_reclaim,
 	&sysfs_reclaimed_journal_buckets,
 	&sysfs_flush_write,
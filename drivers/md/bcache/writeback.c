@@ -382,6 +382,7 @@ static CLOSURE_CALLBACK(write_dirty_finish)
 	}
 
 	bch_keybuf_del(&dc->writeback_keys, w);
+	atomic_dec(&dc->writeback_in_flight_nr);
 	up(&dc->in_flight);
 
 	closure_return_with_destructor(cl, dirty_io_destructor);
@@ -480,6 +481,7 @@ static void read_dirty(struct cached_dev *dc)
 	struct dirty_io *io;
 	struct closure cl;
 	uint16_t sequence = 0;
+	bool idle;
 
 	BUG_ON(!llist_empty(&dc->writeback_ordering_wait.list));
 	atomic_set(&dc->writeback_sequence_next, sequence);
@@ -497,6 +499,7 @@ static void read_dirty(struct cached_dev *dc)
 	       next) {
 		size = 0;
 		nk = 0;
+		idle = atomic_read(&dc->disk.c->at_max_writeback_rate);
 
 		do {
 			BUG_ON(ptr_stale(dc->disk.c, &next->key, 0));
@@ -517,15 +520,15 @@ static void read_dirty(struct cached_dev *dc)
 
 			/*
 			 * Operations are only eligible to be combined
-			 * if they are contiguous.
-			 *
-			 * TODO: add a heuristic willing to fire a
-			 * certain amount of non-contiguous IO per pass,
-			 * so that we can benefit from backing device
-			 * command queueing.
+			 * if they are contiguous, unless the cache set is
+			 * idle and writing back at the maximum rate.  Then
+			 * there is no foreground I/O to protect, and the
+			 * keybuf hands out keys in LBA order, so firing the
+			 * whole batch lets the backing device queue and
+			 * merge while the writes stay sorted.
 			 */
-			if ((nk != 0) && bkey_cmp(&keys[nk-1]->key,
-						&START_KEY(&next->key)))
+			if ((nk != 0) && !idle &&
+			    bkey_cmp(&keys[nk-1]->key, &START_KEY(&next->key)))
 				break;
 
 			size += KEY_SIZE(&next->key);
@@ -557,7 +560,14 @@ static void read_dirty(struct cached_dev *dc)
 
 			trace_bcache_writeback(&w->key);
 
+			if (dc->writeback_seek_nr++)
+				dc->writeback_seek_sectors +=
+					abs_diff(KEY_START(&w->key),
+						 dc->writeback_last_end);
+			dc->writeback_last_end = KEY_OFFSET(&w->key);
+
 			down(&dc->in_flight);
+			atomic_inc(&dc->writeback_in_flight_nr);
 
 			/*
 			 * We've acquired a semaphore for the maximum
@@ -154,6 +154,8 @@ struct mlx5e_sw_stats {
 	u64 rx_gro_bytes;
 	u64 rx_gro_skbs;
 	u64 rx_gro_large_hds;
+	u64 rx_hds_split_packets;
+	u64 rx_hds_split_bytes;
 	u64 rx_hds_nodata_packets;
 	u64 rx_hds_nodata_bytes;
 	u64 rx_hds_nosplit_packets;
@@ -358,6 +360,8 @@ struct mlx5e_rq_stats {
 	u64 gro_bytes;
 	u64 gro_skbs;
 	u64 gro_large_hds;
+	u64 hds_split_packets;
+	u64 hds_split_bytes;
 	u64 hds_nodata_packets;
 	u64 hds_nodata_bytes;
 	u64 hds_nosplit_packets;
@@ -226,6 +226,10 @@ struct stmmac_extra_stats {
 	unsigned long mtl_est_hlbf;
 	unsigned long mtl_est_btre;
 	unsigned long mtl_est_btrlm;
+	/* XSK zero-copy RX refill */
+	unsigned long rx_zc_refill;
+	unsigned long rx_zc_refill_bufs;
+	unsigned long rx_zc_alloc_fail;
 	unsigned long max_sdu_txq_drop[MTL_MAX_TX_QUEUES];
 	unsigned long mtl_est_txq_hlbf[MTL_MAX_TX_QUEUES];
 	/* per queue statistics */
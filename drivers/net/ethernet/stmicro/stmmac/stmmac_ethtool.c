@@ -162,6 +162,10 @@ static const struct stmmac_stats stmmac_gstrings_stats[] = {
 	STMMAC_STAT(mtl_est_hlbf),
 	STMMAC_STAT(mtl_est_btre),
 	STMMAC_STAT(mtl_est_btrlm),
+	/* XSK zero-copy RX refill */
+	STMMAC_STAT(rx_zc_refill),
+	STMMAC_STAT(rx_zc_refill_bufs),
+	STMMAC_STAT(rx_zc_alloc_fail),
 };
 #define STMMAC_STATS_LEN ARRAY_SIZE(stmmac_gstrings_stats)
 
@@ -5237,6 +5237,7 @@ static bool stmmac_rx_refill_zc(struct stmmac_priv *priv, u32 queue, u32 budget)
 		if (!buf->xdp) {
 			buf->xdp = xsk_buff_alloc(rx_q->xsk_pool);
 			if (!buf->xdp) {
+				priv->xstats.rx_zc_alloc_fail++;
 				ret = false;
 				break;
 			}
@@ -5269,6 +5270,10 @@ static bool stmmac_rx_refill_zc(struct stmmac_priv *priv, u32 queue, u32 budget)
 	}
 
 	if (rx_desc) {
+		/* Descriptors handed back per tail pointer update */
+		priv->xstats.rx_zc_refill++;
+		priv->xstats.rx_zc_refill_bufs +=
+			(entry - rx_q->dirty_rx) & (priv->dma_conf.dma_rx_size - 1);
 		rx_q->dirty_rx = entry;
 		rx_q->rx_tail_addr = rx_q->dma_rx_phy +
 				     (rx_q->dirty_rx * sizeof(struct dma_desc));
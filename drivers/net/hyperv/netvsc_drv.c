@@ -1479,8 +1479,8 @@ static const struct {
 /* statistics per queue (rx/tx packets/bytes) */
 #define NETVSC_PCPU_STATS_LEN (num_present_cpus() * ARRAY_SIZE(pcpu_stats))
 
-/* 8 statistics per queue (rx/tx packets/bytes, XDP actions) */
-#define NETVSC_QUEUE_STATS_LEN(dev) ((dev)->num_chn * 8)
+/* 9 statistics per queue (rx/tx packets/bytes, XDP actions, tx signals) */
+#define NETVSC_QUEUE_STATS_LEN(dev) ((dev)->num_chn * 9)
 
 static int netvsc_get_sset_count(struct net_device *dev, int string_set)
 {
@@ -1511,6 +1511,7 @@ static void netvsc_get_ethtool_stats(struct net_device *dev,
 	const struct netvsc_stats_rx *rx_stats;
 	struct netvsc_vf_pcpu_stats sum;
 	struct netvsc_ethtool_pcpu_stats *pcpu_sum;
+	struct vmbus_channel *channel;
 	unsigned int start;
 	u64 packets, bytes;
 	u64 xdp_drop;
@@ -1541,6 +1542,13 @@ static void netvsc_get_ethtool_stats(struct net_device *dev,
 		data[i++] = packets;
 		data[i++] = bytes;
 		data[i++] = xdp_xmit;
+		/*
+		 * Signals to the host on this channel, sent only into an empty
+		 * ring. Subchannels are opened asynchronously after num_chn is
+		 * set, report 0 until they are.
+		 */
+		channel = READ_ONCE(nvdev->chan_table[j].channel);
+		data[i++] = channel ? READ_ONCE(channel->intr_out_empty) : 0;
 
 		rx_stats = &nvdev->chan_table[j].rx_stats;
 		do {
@@ -1597,6 +1605,7 @@ static void netvsc_get_strings(struct net_device *dev, u32 stringset, u8 *data)
 			ethtool_sprintf(&p, "tx_queue_%u_packets", i);
 			ethtool_sprintf(&p, "tx_queue_%u_bytes", i);
 			ethtool_sprintf(&p, "tx_queue_%u_xdp_xmit", i);
+			ethtool_sprintf(&p, "tx_queue_%u_signals", i);
 			ethtool_sprintf(&p, "rx_queue_%u_packets", i);
 			ethtool_sprintf(&p, "rx_queue_%u_bytes", i);
 			ethtool_sprintf(&p, "rx_queue_%u_xdp_drop", i);
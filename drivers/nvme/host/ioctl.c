@@ -434,12 +434,20 @@ static enum rq_end_io_ret nvme_uring_cmd_end_io(struct request *req,
 	 * As that returns false if we're NOT on a polled queue, then it's
 	 * safe to use the polled completion helper.
 	 *
+	 * A command without a user mapping on an IOPOLL ring has nothing
+	 * left to do in task context either: completing it only marks it
+	 * done for the poller, which reaps and posts it with the rest of
+	 * the batch. Don't bounce it through task work just for that.
+	 *
 	 * Otherwise, move the completion to task work.
 	 */
 	if (blk_rq_is_poll(req)) {
 		if (pdu->bio)
 			blk_rq_unmap_user(pdu->bio);
 		io_uring_cmd_iopoll_done(ioucmd, pdu->result, pdu->status);
+	} else if (!pdu->bio && (req->cmd_flags & REQ_POLLED)) {
+		io_uring_cmd_done(ioucmd, pdu->status, pdu->result,
+				  IO_URING_F_UNLOCKED);
 	} else {
 		io_uring_cmd_do_in_task_lazy(ioucmd, nvme_uring_task_cb);
 	}
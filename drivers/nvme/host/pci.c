@@ -9,6 +9,7 @@
 #include <linux/blkdev.h>
 #include <linux/blk-mq.h>
 #include <linux/blk-integrity.h>
+#include <linux/debugfs.h>
 #include <linux/dmi.h>
 #include <linux/init.h>
 #include <linux/interrupt.h>
@@ -162,6 +163,8 @@ struct nvme_dev {
 	unsigned int nr_allocated_queues;
 	unsigned int nr_write_queues;
 	unsigned int nr_poll_queues;
+
+	struct dentry *debugfs;
 };
 
 static int io_queue_depth_set(const char *val, const struct kernel_param *kp)
@@ -217,6 +220,9 @@ struct nvme_queue {
 	__le32 *dbbuf_sq_ei;
 	__le32 *dbbuf_cq_ei;
 	struct completion delete_done;
+	/* interrupts taken and completions they reaped, see irq_stats */
+	u64 nr_irqs;
+	u64 nr_irq_cqes;
 };
 
 union nvme_descriptor {
@@ -1148,13 +1154,13 @@ static inline void nvme_update_cq_head(struct nvme_queue *nvmeq)
 	}
 }
 
-static inline bool nvme_poll_cq(struct nvme_queue *nvmeq,
-			        struct io_comp_batch *iob)
+static inline int nvme_poll_cq(struct nvme_queue *nvmeq,
+			       struct io_comp_batch *iob)
 {
-	bool found = false;
+	int found = 0;
 
 	while (nvme_cqe_pending(nvmeq)) {
-		found = true;
+		found++;
 		/*
 		 * load-load control dependency between phase and the rest of
 		 * the cqe requires a full read memory barrier
@@ -1173,8 +1179,11 @@ static irqreturn_t nvme_irq(int irq, void *data)
 {
 	struct nvme_queue *nvmeq = data;
 	DEFINE_IO_COMP_BATCH(iob);
+	int found = nvme_poll_cq(nvmeq, &iob);
 
-	if (nvme_poll_cq(nvmeq, &iob)) {
+	nvmeq->nr_irqs++;
+	if (found) {
+		nvmeq->nr_irq_cqes += found;
 		if (!rq_list_empty(&iob.req_list))
 			nvme_pci_complete_batch(&iob);
 		return IRQ_HANDLED;
@@ -3241,6 +3250,39 @@ static struct nvme_dev *nvme_pci_alloc_dev(struct pci_dev *pdev,
 	return ERR_PTR(ret);
 }
 
+static struct dentry *nvme_pci_debugfs_root;
+
+/*
+ * One line per interrupt driven queue: qid, interrupts taken and the
+ * completions reaped by them.  The ratio shows how well the interrupt
+ * coalescing settings match the workload.
+ */
+static int irq_stats_show(struct seq_file *m, void *unused)
+{
+	struct nvme_dev *dev = m->private;
+	unsigned int i;
+
+	for (i = 0; i < data_race(dev->online_queues); i++) {
+		struct nvme_queue *nvmeq = &dev->queues[i];
+
+		if (test_bit(NVMEQ_POLLED, &nvmeq->flags))
+			continue;
+		seq_printf(m, "%u %llu %llu\n", nvmeq->qid,
+			   data_race(nvmeq->nr_irqs),
+			   data_race(nvmeq->nr_irq_cqes));
+	}
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(irq_stats);
+
+static void nvme_pci_debugfs_init(struct nvme_dev *dev)
+{
+	dev->debugfs = debugfs_create_dir(dev_name(dev->ctrl.device),
+					  nvme_pci_debugfs_root);
+	debugfs_create_file("irq_stats", 0400, dev->debugfs, dev,
+			    &irq_stats_fops);
+}
+
 static int nvme_probe(struct pci_dev *pdev, const struct pci_device_id *id)
 {
 	struct nvme_dev *dev;
@@ -3324,6 +3366,7 @@ static int nvme_probe(struct pci_dev *pdev, const struct pci_device_id *id)
 	}
 
 	pci_set_drvdata(pdev, dev);
+	nvme_pci_debugfs_init(dev);
 
 	nvme_start_ctrl(&dev->ctrl);
 	nvme_put_ctrl(&dev->ctrl);
@@ -3390,6 +3433,7 @@ static void nvme_remove(struct pci_dev *pdev)
 
 	nvme_change_ctrl_state(&dev->ctrl, NVME_CTRL_DELETING);
 	pci_set_drvdata(pdev, NULL);
+	debugfs_remove_recursive(dev->debugfs);
 
 	if (!pci_device_is_present(pdev)) {
 		nvme_change_ctrl_state(&dev->ctrl, NVME_CTRL_DEAD);
@@ -3795,6 +3839,8 @@ static struct pci_driver nvme_driver = {
 
 static int __init nvme_init(void)
 {
+	int ret;
+
 	BUILD_BUG_ON(sizeof(struct nvme_create_cq) != 64);
 	BUILD_BUG_ON(sizeof(struct nvme_create_sq) != 64);
 	BUILD_BUG_ON(sizeof(struct nvme_delete_queue) != 64);
@@ -3803,12 +3849,17 @@ static int __init nvme_init(void)
 	BUILD_BUG_ON(sizeof(struct scatterlist) * NVME_MAX_SEGS > PAGE_SIZE);
 	BUILD_BUG_ON(nvme_pci_npages_prp() > NVME_MAX_NR_ALLOCATIONS);
 
-	return pci_register_driver(&nvme_driver);
+	nvme_pci_debugfs_root = debugfs_create_dir("nvme-pci", NULL);
+	ret = pci_register_driver(&nvme_driver);
+	if (ret)
+		debugfs_remove_recursive(nvme_pci_debugfs_root);
+	return ret;
 }
 
 static void __exit nvme_exit(void)
 {
 	pci_unregister_driver(&nvme_driver);
+	debugfs_remove_recursive(nvme_pci_debugfs_root);
 	flush_workqueue(nvme_wq);
 }
 
@@ -48,11 +48,10 @@ static void v9fs_begin_writeback(struct netfs_io_request *wreq)
 	wreq->io_streams[0].avail = true;
 }
 
-/*
- * Issue a subrequest to write to the server.
- */
-static void v9fs_issue_write(struct netfs_io_subrequest *subreq)
+static void v9fs_issue_write_worker(struct work_struct *work)
 {
+	struct netfs_io_subrequest *subreq =
+		container_of(work, struct netfs_io_subrequest, work);
 	struct p9_fid *fid = subreq->rreq->netfs_priv;
 	int err, len;
 
@@ -62,11 +61,31 @@ static void v9fs_issue_write(struct netfs_io_subrequest *subreq)
 	netfs_write_subrequest_terminated(subreq, len ?: err, false);
 }
 
+/*
+ * Issue a subrequest to write to the server.  Each subrequest is at most one
+ * Twrite, so run them from a workqueue to keep several of them in flight
+ * rather than waiting for each reply in turn.
+ */
+static void v9fs_issue_write(struct netfs_io_subrequest *subreq)
+{
+	subreq->work.func = v9fs_issue_write_worker;
+	if (!queue_work(system_unbound_wq, &subreq->work))
+		WARN_ON_ONCE(1);
+}
+
 /**
- * v9fs_issue_read - Issue a read from 9P
- * @subreq: The read to make
+ * v9fs_prepare_read - Limit a read subrequest to a single Tread
+ * @subreq: The read that is about to be issued
  */
-static void v9fs_issue_read(struct netfs_io_subrequest *subreq)
+static int v9fs_prepare_read(struct netfs_io_subrequest *subreq)
+{
+	struct netfs_io_request *rreq = subreq->rreq;
+
+	rreq->io_streams[0].sreq_max_len = rreq->rsize;
+	return 0;
+}
+
+static void v9fs_do_issue_read(struct netfs_io_subrequest *subreq)
 {
 	struct netfs_io_request *rreq = subreq->rreq;
 	struct p9_fid *fid = rreq->netfs_priv;
@@ -90,6 +109,34 @@ static void v9fs_issue_read(struct netfs_io_subrequest *subreq)
 	netfs_read_subreq_terminated(subreq);
 }
 
+static void v9fs_issue_read_worker(struct work_struct *work)
+{
+	v9fs_do_issue_read(container_of(work, struct netfs_io_subrequest, work));
+}
+
+/**
+ * v9fs_issue_read - Issue a read from 9P
+ * @subreq: The read to make
+ *
+ * Subrequests are at most one Tread each.  All but the last one of a request
+ * are passed to a workqueue so that several Treads are in flight at once,
+ * while a read that fits in a single message is still made inline.
+ */
+static void v9fs_issue_read(struct netfs_io_subrequest *subreq)
+{
+	struct netfs_io_request *rreq = subreq->rreq;
+
+	if (rreq->origin == NETFS_READ_SINGLE ||
+	    subreq->start + subreq->len >= rreq->start + rreq->len) {
+		v9fs_do_issue_read(subreq);
+		return;
+	}
+
+	subreq->work.func = v9fs_issue_read_worker;
+	if (!queue_work(system_unbound_wq, &subreq->work))
+		WARN_ON_ONCE(1);
+}
+
 /**
  * v9fs_init_request - Initialise a request
  * @rreq: The read request
@@ -123,6 +170,7 @@ static int v9fs_init_request(struct netfs_io_request *rreq, struct file *file)
 	rreq->wsize = fid->clnt->msize - P9_IOHDRSZ;
 	if (fid->iounit)
 		rreq->wsize = min(rreq->wsize, fid->iounit);
+	rreq->rsize = rreq->wsize;
 
 	/* we might need to read from a fid that was opened write-only
 	 * for read-modify-write of page cache, use the writeback fid
@@ -151,6 +199,7 @@ static void v9fs_free_request(struct netfs_io_request *rreq)
 const struct netfs_request_ops v9fs_req_ops = {
 	.init_request		= v9fs_init_request,
 	.free_request		= v9fs_free_request,
+	.prepare_read		= v9fs_prepare_read,
 	.issue_read		= v9fs_issue_read,
 	.begin_writeback	= v9fs_begin_writeback,
 	.issue_write		= v9fs_issue_write,
@@ -158,6 +158,8 @@ void cachefiles_flush_reqs(struct cachefiles_cache *cache)
 
 	xa_lock(xa);
 	xa_for_each(xa, index, req) {
+		if (xa_get_mark(xa, index, CACHEFILES_REQ_NEW))
+			fscache_count_ondemand_cancelled();
 		req->error = -EIO;
 		complete(&req->done);
 		__xa_erase(xa, index);
@@ -472,11 +472,14 @@ cachefiles_do_prepare_read(struct netfs_cache_resources *cres,
 
 	why = cachefiles_trace_read_have_data;
 	ret = NETFS_READ_FROM_CACHE;
+	if (test_bit(NETFS_SREQ_ONDEMAND, _flags))
+		fscache_count_ondemand_hit();
 	goto out;
 
 download_and_store:
 	__set_bit(NETFS_SREQ_COPY_TO_CACHE, _flags);
 	if (test_bit(NETFS_SREQ_ONDEMAND, _flags)) {
+		fscache_count_ondemand_miss();
 		rc = cachefiles_ondemand_read(object, start, len);
 		if (!rc) {
 			__clear_bit(NETFS_SREQ_ONDEMAND, _flags);
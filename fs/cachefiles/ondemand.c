@@ -42,6 +42,8 @@ static int cachefiles_ondemand_fd_release(struct inode *inode,
 	xas_for_each_marked(&xas, req, ULONG_MAX, CACHEFILES_REQ_NEW) {
 		if (req->msg.object_id == object_id &&
 		    req->msg.opcode == CACHEFILES_OP_CLOSE) {
+			if (xas_get_mark(&xas, CACHEFILES_REQ_NEW))
+				fscache_count_ondemand_cancelled();
 			complete(&req->done);
 			xas_store(&xas, NULL);
 		}
@@ -284,8 +286,12 @@ int cachefiles_ondemand_restore(struct cachefiles_cache *cache, char *args)
 	 * user daemon could be reprocessed after the recovery.
 	 */
 	xas_lock(&xas);
-	xas_for_each(&xas, req, ULONG_MAX)
+	xas_for_each(&xas, req, ULONG_MAX) {
+		/* they go back into the daemon's backlog */
+		if (!xas_get_mark(&xas, CACHEFILES_REQ_NEW))
+			fscache_count_ondemand_queued();
 		xas_set_mark(&xas, CACHEFILES_REQ_NEW);
+	}
 	xas_unlock(&xas);
 
 	wake_up_all(&cache->daemon_pollwq);
@@ -401,11 +407,20 @@ static struct cachefiles_req *cachefiles_ondemand_select_req(struct xa_state *xa
 static inline bool cachefiles_ondemand_finish_req(struct cachefiles_req *req,
 						  struct xa_state *xas, int err)
 {
+	bool unsent;
+
 	if (unlikely(!xas || !req))
 		return false;
 
-	if (xa_cmpxchg(xas->xa, xas->xa_index, req, NULL, 0) != req)
+	xa_lock(xas->xa);
+	unsent = xa_get_mark(xas->xa, xas->xa_index, CACHEFILES_REQ_NEW);
+	if (__xa_cmpxchg(xas->xa, xas->xa_index, req, NULL, 0) != req) {
+		xa_unlock(xas->xa);
 		return false;
+	}
+	xa_unlock(xas->xa);
+	if (unsent)
+		fscache_count_ondemand_cancelled();
 
 	req->error = err;
 	complete(&req->done);
@@ -449,6 +464,7 @@ ssize_t cachefiles_ondemand_daemon_read(struct cachefiles_cache *cache,
 	xas_clear_mark(&xas, CACHEFILES_REQ_NEW);
 	cache->req_id_next = xas.xa_index + 1;
 	refcount_inc(&req->ref);
+	fscache_count_ondemand_sent();
 	cachefiles_grab_object(req->object, cachefiles_obj_get_read_req);
 	xa_unlock(&cache->reqs);
 
@@ -580,6 +596,7 @@ static int cachefiles_ondemand_send_req(struct cachefiles_object *object,
 	if (ret)
 		goto out;
 
+	fscache_count_ondemand_queued();
 	wake_up_all(&cache->daemon_pollwq);
 wait:
 	ret = wait_for_completion_killable(&req->done);
@@ -719,6 +736,8 @@ void cachefiles_ondemand_clean_object(struct cachefiles_object *object)
 	cachefiles_ondemand_set_object_dropping(object);
 	xa_for_each(&cache->reqs, index, req) {
 		if (req->object == object) {
+			if (xa_get_mark(&cache->reqs, index, CACHEFILES_REQ_NEW))
+				fscache_count_ondemand_cancelled();
 			req->error = -EIO;
 			complete(&req->done);
 			__xa_erase(&cache->reqs, index);
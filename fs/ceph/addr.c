@@ -1573,6 +1573,8 @@ int ceph_submit_write(struct address_space *mapping,
 	req->r_mtime = inode_get_mtime(inode);
 	ceph_osdc_start_request(&fsc->client->osdc, req);
 	req = NULL;
+	atomic64_inc(&fsc->mdsc->metric.wb_osd_reqs);
+	atomic64_add(i, &fsc->mdsc->metric.wb_osd_pages);
 
 	wbc->nr_to_write -= i;
 	if (ceph_wbc->pages)
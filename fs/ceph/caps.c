@@ -1539,6 +1539,7 @@ static void __send_cap(struct cap_msg_args *arg, struct ceph_inode_info *ci)
 
 	encode_cap_msg(msg, arg);
 	ceph_con_send(&arg->session->s_con, msg);
+	atomic64_inc(&arg->session->s_mdsc->metric.cap_msgs_sent);
 	ceph_buffer_put(arg->old_xattr_buf);
 	ceph_buffer_put(arg->xattr_buf);
 	if (arg->wake)
@@ -1601,6 +1602,7 @@ static inline int __send_flush_snap(struct inode *inode,
 
 	encode_cap_msg(msg, &arg);
 	ceph_con_send(&arg.session->s_con, msg);
+	atomic64_inc(&arg.session->s_mdsc->metric.cap_msgs_sent);
 	return 0;
 }
 
@@ -161,6 +161,12 @@ static int metrics_file_show(struct seq_file *s, void *p)
 		   atomic64_read(&m->total_caps));
 	seq_printf(s, "%-35s%lld\n", "opened inodes",
 		   percpu_counter_sum(&m->opened_inodes));
+	seq_printf(s, "%-35s%lld\n", "cap messages sent",
+		   atomic64_read(&m->cap_msgs_sent));
+	seq_printf(s, "%-35s%lld\n", "writeback OSD requests",
+		   atomic64_read(&m->wb_osd_reqs));
+	seq_printf(s, "%-35s%lld\n", "writeback OSD pages",
+		   atomic64_read(&m->wb_osd_pages));
 	return 0;
 }
 
@@ -274,6 +274,9 @@ int ceph_metric_init(struct ceph_client_metric *m)
 	}
 
 	atomic64_set(&m->opened_files, 0);
+	atomic64_set(&m->cap_msgs_sent, 0);
+	atomic64_set(&m->wb_osd_reqs, 0);
+	atomic64_set(&m->wb_osd_pages, 0);
 	ret = percpu_counter_init(&m->opened_inodes, 0, GFP_KERNEL);
 	if (ret)
 		goto err_opened_inodes;
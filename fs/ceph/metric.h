@@ -183,6 +183,11 @@ struct ceph_client_metric {
 	struct percpu_counter opened_inodes;
 	struct percpu_counter total_inodes;
 
+	/* Cap messages sent to the MDSes and writeback OSD requests issued */
+	atomic64_t cap_msgs_sent;
+	atomic64_t wb_osd_reqs;
+	atomic64_t wb_osd_pages;
+
 	struct ceph_mds_session *session;
 	struct delayed_work delayed_work;  /* delayed work */
 };
@@ -693,6 +693,17 @@ static int dlm_send_queue_cnt_show(struct seq_file *file, void *offset)
 }
 DEFINE_SHOW_ATTRIBUTE(dlm_send_queue_cnt);
 
+static int dlm_ack_latency_show(struct seq_file *file, void *offset)
+{
+	u64 cnt, avg_us, max_us;
+
+	dlm_midcomms_ack_stats(file->private, &cnt, &avg_us, &max_us);
+	seq_printf(file, "acked %llu avg_us %llu max_us %llu\n",
+		   cnt, avg_us, max_us);
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(dlm_ack_latency);
+
 static int dlm_version_show(struct seq_file *file, void *offset)
 {
 	seq_printf(file, "0x%08x\n", dlm_midcomms_version(file->private));
@@ -748,6 +759,8 @@ void *dlm_create_debug_comms_file(int nodeid, void *data)
 	debugfs_create_file("flags", 0444, d_node, data, &dlm_flags_fops);
 	debugfs_create_file("send_queue_count", 0444, d_node, data,
 			    &dlm_send_queue_cnt_fops);
+	debugfs_create_file("ack_latency", 0444, d_node, data,
+			    &dlm_ack_latency_fops);
 	debugfs_create_file("version", 0444, d_node, data, &dlm_version_fops);
 	debugfs_create_file("rawmsg", 0200, d_node, data, &dlm_rawmsg_fops);
 
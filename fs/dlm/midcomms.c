@@ -164,6 +164,12 @@ struct midcomms_node {
 	struct list_head send_queue;
 	spinlock_t send_queue_lock;
 	atomic_t send_queue_cnt;
+	/* acknowledged messages and their send to ack latency,
+	 * protected by send_queue_lock
+	 */
+	u64 ack_cnt;
+	u64 ack_us_total;
+	u64 ack_us_max;
 #define DLM_NODE_FLAG_CLOSE	1
 #define DLM_NODE_FLAG_STOP_TX	2
 #define DLM_NODE_FLAG_STOP_RX	3
@@ -202,6 +208,7 @@ struct dlm_mhandle {
 	struct dlm_msg *msg;
 	bool committed;
 	uint32_t seq;
+	ktime_t stamp;
 
 	void (*ack_rcv)(struct midcomms_node *node);
 
@@ -271,6 +278,17 @@ uint32_t dlm_midcomms_version(struct midcomms_node *node)
 	return node->version;
 }
 
+void dlm_midcomms_ack_stats(struct midcomms_node *node, u64 *cnt,
+			    u64 *avg_us, u64 *max_us)
+{
+	spin_lock_bh(&node->send_queue_lock);
+	*cnt = node->ack_cnt;
+	*avg_us = node->ack_cnt ? div64_u64(node->ack_us_total,
+					    node->ack_cnt) : 0;
+	*max_us = node->ack_us_max;
+	spin_unlock_bh(&node->send_queue_lock);
+}
+
 static struct midcomms_node *__find_node(int nodeid, int r)
 {
 	struct midcomms_node *node;
@@ -450,6 +468,8 @@ static int dlm_send_fin(struct midcomms_node *node,
 static void dlm_receive_ack(struct midcomms_node *node, uint32_t seq)
 {
 	struct dlm_mhandle *mh;
+	ktime_t now = ktime_get();
+	u64 us;
 
 	rcu_read_lock();
 	list_for_each_entry_rcu(mh, &node->send_queue, list) {
@@ -465,6 +485,11 @@ static void dlm_receive_ack(struct midcomms_node *node, uint32_t seq)
 	spin_lock_bh(&node->send_queue_lock);
 	list_for_each_entry_rcu(mh, &node->send_queue, list) {
 		if (before(mh->seq, seq)) {
+			us = ktime_us_delta(now, mh->stamp);
+			node->ack_cnt++;
+			node->ack_us_total += us;
+			if (us > node->ack_us_max)
+				node->ack_us_max = us;
 			dlm_mhandle_delete(node, mh);
 		} else {
 			/* send queue should be ordered */
@@ -972,6 +997,7 @@ static void midcomms_new_msg_cb(void *data)
 	spin_unlock_bh(&mh->node->send_queue_lock);
 
 	mh->seq = atomic_fetch_inc(&mh->node->seq_send);
+	mh->stamp = ktime_get();
 }
 
 static struct dlm_msg *dlm_midcomms_get_msg_3_2(struct dlm_mhandle *mh, int nodeid,
@@ -76,4 +76,19 @@ int z_erofs_fixup_insize(struct z_erofs_decompress_req *rq, const char *padbuf,
 			 unsigned int padbufsize);
 int __init z_erofs_init_decompressor(void);
 void z_erofs_exit_decompressor(void);
+
+#ifdef CONFIG_EROFS_FS_ZIP_ACCEL
+int z_erofs_crypto_decompress(struct z_erofs_decompress_req *rq,
+			      struct page **pgpl);
+int z_erofs_crypto_enable_engine(const char *name, size_t len);
+ssize_t z_erofs_crypto_show_engine(char *buf);
+void z_erofs_crypto_disable_all_engines(void);
+#else
+static inline int z_erofs_crypto_decompress(struct z_erofs_decompress_req *rq,
+					    struct page **pgpl)
+{
+	return -EOPNOTSUPP;
+}
+static inline void z_erofs_crypto_disable_all_engines(void) {}
+#endif
 #endif
@@ -522,6 +522,7 @@ void z_erofs_exit_decompressor(void)
 {
 	int i;
 
+	z_erofs_crypto_disable_all_engines();
 	for (i = 0; i < Z_EROFS_COMPRESSION_MAX; ++i)
 		if (z_erofs_decomp[i])
 			z_erofs_decomp[i]->exit();
@@ -0,0 +1,150 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <linux/scatterlist.h>
+#include <linux/sysfs.h>
+#include <crypto/acompress.h>
+#include "compress.h"
+
+/*
+ * Offload engine for DEFLATE pclusters.  Any acomp driver implementing
+ * "deflate" (e.g. hardware accelerators) can be selected through
+ * /sys/fs/erofs/accel; the CPU decompressor is used if it is unset or if
+ * the engine fails a request.
+ */
+static struct crypto_acomp *z_erofs_deflate_tfm;
+static DECLARE_RWSEM(z_erofs_crypto_rwsem);
+
+static int __z_erofs_crypto_decompress(struct z_erofs_decompress_req *rq,
+				       struct crypto_acomp *tfm)
+{
+	struct sg_table st_src, st_dst;
+	struct acomp_req *req;
+	struct crypto_wait wait;
+	int ret;
+
+	req = acomp_request_alloc(tfm);
+	if (!req)
+		return -ENOMEM;
+
+	ret = sg_alloc_table_from_pages_segment(&st_src, rq->in, rq->inpages,
+			rq->pageofs_in, rq->inputsize, UINT_MAX, rq->gfp);
+	if (ret < 0)
+		goto failed_src_alloc;
+
+	ret = sg_alloc_table_from_pages_segment(&st_dst, rq->out, rq->outpages,
+			rq->pageofs_out, rq->outputsize, UINT_MAX, rq->gfp);
+	if (ret < 0)
+		goto failed_dst_alloc;
+
+	acomp_request_set_params(req, st_src.sgl, st_dst.sgl,
+				 rq->inputsize, rq->outputsize);
+	crypto_init_wait(&wait);
+	acomp_request_set_callback(req, CRYPTO_TFM_REQ_MAY_BACKLOG,
+				   crypto_req_done, &wait);
+	ret = crypto_wait_req(crypto_acomp_decompress(req), &wait);
+	if (!ret && req->dlen != rq->outputsize)
+		ret = -EIO;
+
+	sg_free_table(&st_dst);
+failed_dst_alloc:
+	sg_free_table(&st_src);
+failed_src_alloc:
+	acomp_request_free(req);
+	return ret;
+}
+
+/*
+ * Try to decompress @rq on the selected engine.  @rq->inputsize must already
+ * be fixed up.  Returns -EOPNOTSUPP if the request has to go through the CPU
+ * decompressor instead, either because no engine is usable for it or because
+ * the engine failed.
+ */
+int z_erofs_crypto_decompress(struct z_erofs_decompress_req *rq,
+			      struct page **pgpl)
+{
+	struct erofs_sb_info *sbi = EROFS_SB(rq->sb);
+	unsigned int i;
+	int ret;
+
+	/*
+	 * Engines can't decode into the buffer they are reading from, nor stop
+	 * early for partial decoding.
+	 */
+	if (rq->inplace_io || rq->partial_decoding ||
+	    !READ_ONCE(z_erofs_deflate_tfm))
+		return -EOPNOTSUPP;
+
+	/* The destination scatterlist can't have holes. */
+	for (i = 0; i < rq->outpages; i++) {
+		struct page *victim;
+
+		if (rq->out[i])
+			continue;
+		victim = __erofs_allocpage(pgpl, rq->gfp, true);
+		if (!victim)
+			return -ENOMEM;
+		set_page_private(victim, Z_EROFS_SHORTLIVED_PAGE);
+		rq->out[i] = victim;
+	}
+	rq->fillgaps = true;
+
+	down_read(&z_erofs_crypto_rwsem);
+	ret = -EOPNOTSUPP;
+	if (z_erofs_deflate_tfm)
+		ret = __z_erofs_crypto_decompress(rq, z_erofs_deflate_tfm);
+	up_read(&z_erofs_crypto_rwsem);
+
+	if (!ret) {
+		atomic64_inc(&sbi->decompress_accel);
+		return 0;
+	}
+	if (ret != -EOPNOTSUPP)
+		atomic64_inc(&sbi->decompress_accel_fallback);
+	return -EOPNOTSUPP;
+}
+
+int z_erofs_crypto_enable_engine(const char *name, size_t len)
+{
+	struct crypto_acomp *tfm = NULL, *old;
+	char drv[CRYPTO_MAX_ALG_NAME];
+
+	if (len >= sizeof(drv))
+		return -EINVAL;
+	memcpy(drv, name, len);
+	drv[len] = '\0';
+
+	if (drv[0]) {
+		tfm = crypto_alloc_acomp(drv, 0, 0);
+		if (IS_ERR(tfm))
+			return PTR_ERR(tfm);
+		if (strcmp(crypto_tfm_alg_name(crypto_acomp_tfm(tfm)),
+			   "deflate")) {
+			crypto_free_acomp(tfm);
+			return -EINVAL;
+		}
+	}
+
+	down_write(&z_erofs_crypto_rwsem);
+	old = z_erofs_deflate_tfm;
+	WRITE_ONCE(z_erofs_deflate_tfm, tfm);
+	up_write(&z_erofs_crypto_rwsem);
+	if (old)
+		crypto_free_acomp(old);
+	return 0;
+}
+
+ssize_t z_erofs_crypto_show_engine(char *buf)
+{
+	ssize_t len;
+
+	down_read(&z_erofs_crypto_rwsem);
+	len = sysfs_emit(buf, "%s\n", z_erofs_deflate_tfm ?
+		crypto_tfm_alg_driver_name(crypto_acomp_tfm(z_erofs_deflate_tfm)) :
+		"");
+	up_read(&z_erofs_crypto_rwsem);
+	return len;
+}
+
+void z_erofs_crypto_disable_all_engines(void)
+{
+	z_erofs_crypto_enable_engine("", 0);
+}
@@ -109,10 +109,15 @@ static int z_erofs_deflate_decompress(struct z_erofs_decompress_req *rq,
 	dctx.kin = kmap_local_page(*rq->in);
 	err = z_erofs_fixup_insize(rq, dctx.kin + rq->pageofs_in,
 			min(rq->inputsize, sb->s_blocksize - rq->pageofs_in));
-	if (err) {
-		kunmap_local(dctx.kin);
+	kunmap_local(dctx.kin);
+	if (err)
 		return err;
-	}
+
+	/* try the offload engine first, if one is configured */
+	err = z_erofs_crypto_decompress(rq, pgpl);
+	if (err != -EOPNOTSUPP)
+		return err;
+	dctx.kin = kmap_local_page(*rq->in);
 
 	/* 2. get an available DEFLATE context */
 again:
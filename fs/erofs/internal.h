@@ -123,6 +123,14 @@ struct erofs_sb_info {
 	struct inode *managed_cache;
 
 	struct erofs_sb_lz4_info lz4;
+
+	/* async jobs, their time queued, and time spent decompressing */
+	atomic64_t decompress_queued;
+	atomic64_t decompress_wait_us;
+	atomic64_t decompress_work_us;
+	/* pclusters decompressed by the offload engine, and its failures */
+	atomic64_t decompress_accel;
+	atomic64_t decompress_accel_fallback;
 #endif	/* CONFIG_EROFS_FS_ZIP */
 	struct inode *packed_inode;
 	struct erofs_dev_context *devs;
@@ -6,13 +6,15 @@
 #include <linux/sysfs.h>
 #include <linux/kobject.h>
 
-#include "internal.h"
+#include "compress.h"
 
 enum {
 	attr_feature,
 	attr_drop_caches,
 	attr_pointer_ui,
 	attr_pointer_bool,
+	attr_pointer_atomic64,
+	attr_accel,
 };
 
 enum {
@@ -54,22 +56,49 @@ static struct erofs_attr erofs_attr_##_name = {			\
 #define EROFS_ATTR_RW_BOOL(_name, _struct)	\
 	EROFS_ATTR_RW(_name, pointer_bool, _struct)
 
+#define EROFS_ATTR_RO_ATOMIC64(_name, _struct)	\
+	EROFS_RO_ATTR(_name, pointer_atomic64, _struct)
+
 #define ATTR_LIST(name) (&erofs_attr_##name.attr)
 
 #ifdef CONFIG_EROFS_FS_ZIP
 EROFS_ATTR_RW_UI(sync_decompress, erofs_mount_opts);
 EROFS_ATTR_FUNC(drop_caches, 0200);
+EROFS_ATTR_RO_ATOMIC64(decompress_queued, erofs_sb_info);
+EROFS_ATTR_RO_ATOMIC64(decompress_wait_us, erofs_sb_info);
+EROFS_ATTR_RO_ATOMIC64(decompress_work_us, erofs_sb_info);
+#ifdef CONFIG_EROFS_FS_ZIP_ACCEL
+EROFS_ATTR_RO_ATOMIC64(decompress_accel, erofs_sb_info);
+EROFS_ATTR_RO_ATOMIC64(decompress_accel_fallback, erofs_sb_info);
+EROFS_ATTR_FUNC(accel, 0644);
+#endif
 #endif
 
 static struct attribute *erofs_attrs[] = {
 #ifdef CONFIG_EROFS_FS_ZIP
 	ATTR_LIST(sync_decompress),
 	ATTR_LIST(drop_caches),
+	ATTR_LIST(decompress_queued),
+	ATTR_LIST(decompress_wait_us),
+	ATTR_LIST(decompress_work_us),
+#ifdef CONFIG_EROFS_FS_ZIP_ACCEL
+	ATTR_LIST(decompress_accel),
+	ATTR_LIST(decompress_accel_fallback),
+#endif
 #endif
 	NULL,
 };
 ATTRIBUTE_GROUPS(erofs);
 
+/* Attributes of /sys/fs/erofs itself */
+static struct attribute *erofs_root_attrs[] = {
+#ifdef CONFIG_EROFS_FS_ZIP_ACCEL
+	ATTR_LIST(accel),
+#endif
+	NULL,
+};
+ATTRIBUTE_GROUPS(erofs_root);
+
 /* Features this copy of erofs supports */
 EROFS_ATTR_FEATURE(zero_padding);
 EROFS_ATTR_FEATURE(compr_cfgs);
@@ -128,6 +157,14 @@ static ssize_t erofs_attr_show(struct kobject *kobj,
 		if (!ptr)
 			return 0;
 		return sysfs_emit(buf, "%d\n", *(bool *)ptr);
+	case attr_pointer_atomic64:
+		if (!ptr)
+			return 0;
+		return sysfs_emit(buf, "%lld\n", atomic64_read((atomic64_t *)ptr));
+#ifdef CONFIG_EROFS_FS_ZIP_ACCEL
+	case attr_accel:
+		return z_erofs_crypto_show_engine(buf);
+#endif
 	}
 	return 0;
 }
@@ -181,6 +218,11 @@ static ssize_t erofs_attr_store(struct kobject *kobj, struct attribute *attr,
 		if (t & 1)
 			invalidate_mapping_pages(MNGD_MAPPING(sbi), 0, -1);
 		return len;
+#endif
+#ifdef CONFIG_EROFS_FS_ZIP_ACCEL
+	case attr_accel:
+		ret = z_erofs_crypto_enable_engine(buf, strcspn(buf, "\n"));
+		return ret ?: len;
 #endif
 	}
 	return 0;
@@ -205,6 +247,7 @@ static const struct kobj_type erofs_sb_ktype = {
 };
 
 static const struct kobj_type erofs_ktype = {
+	.default_groups = erofs_root_groups,
 	.sysfs_ops	= &erofs_attr_ops,
 };
 
@@ -102,6 +102,7 @@ struct z_erofs_decompressqueue {
 		struct work_struct work;
 		struct kthread_work kthread_work;
 	} u;
+	ktime_t qtime;		/* when handed to a worker, 0 if inline */
 	bool eio, sync;
 };
 
@@ -1375,12 +1376,19 @@ static int z_erofs_decompress_queue(const struct z_erofs_decompressqueue *io,
 	};
 	struct z_erofs_pcluster *next;
 	int err = io->eio ? -EIO : 0;
+	ktime_t start;
 
+	if (be.pcl == Z_EROFS_PCLUSTER_TAIL)
+		return err;
+
+	start = ktime_get();
 	for (; be.pcl != Z_EROFS_PCLUSTER_TAIL; be.pcl = next) {
 		DBG_BUGON(!be.pcl);
 		next = READ_ONCE(be.pcl->next);
 		err = z_erofs_decompress_pcluster(&be, err) ?: err;
 	}
+	atomic64_add(ktime_us_delta(ktime_get(), start),
+		     &EROFS_SB(io->sb)->decompress_work_us);
 	return err;
 }
 
@@ -1388,8 +1396,12 @@ static void z_erofs_decompressqueue_work(struct work_struct *work)
 {
 	struct z_erofs_decompressqueue *bgq =
 		container_of(work, struct z_erofs_decompressqueue, u.work);
+	struct erofs_sb_info *const sbi = EROFS_SB(bgq->sb);
 	struct page *pagepool = NULL;
 
+	if (bgq->qtime)
+		atomic64_add(ktime_us_delta(ktime_get(), bgq->qtime),
+			     &sbi->decompress_wait_us);
 	DBG_BUGON(bgq->head == Z_EROFS_PCLUSTER_TAIL);
 	z_erofs_decompress_queue(bgq, &pagepool);
 	erofs_release_pages(&pagepool);
@@ -1421,7 +1433,11 @@ static void z_erofs_decompress_kickoff(struct z_erofs_decompressqueue *io,
 	if (!in_task() || irqs_disabled() || rcu_read_lock_any_held()) {
 #ifdef CONFIG_EROFS_FS_PCPU_KTHREAD
 		struct kthread_worker *worker;
+#endif
 
+		atomic64_inc(&sbi->decompress_queued);
+		io->qtime = ktime_get();
+#ifdef CONFIG_EROFS_FS_PCPU_KTHREAD
 		rcu_read_lock();
 		worker = rcu_dereference(
 				z_erofs_pcpu_workers[raw_smp_processor_id()]);
@@ -624,6 +624,7 @@ static int f2fs_compress_pages(struct compress_ctx *cc)
 				f2fs_cops[fi->i_compress_algorithm];
 	unsigned int max_len, new_nr_cpages;
 	u32 chksum = 0;
+	ktime_t start;
 	int i, ret;
 
 	trace_f2fs_compress_pages_start(cc->inode, cc->cluster_idx,
@@ -660,7 +661,9 @@ static int f2fs_compress_pages(struct compress_ctx *cc)
 		goto out_vunmap_rbuf;
 	}
 
+	start = ktime_get();
 	ret = cops->compress_pages(cc);
+	add_compr_time_stat(cc->inode, ktime_us_delta(ktime_get(), start));
 	if (ret)
 		goto out_vunmap_cbuf;
 
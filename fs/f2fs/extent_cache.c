@@ -511,19 +511,30 @@ static bool __lookup_extent_tree(struct inode *inode, pgoff_t pgofs,
 	if (!en)
 		goto out;
 
-	if (en == et->cached_en)
+	*ei = en->ei;
+	ret = true;
+
+	/*
+	 * The shrinker evicts single nodes from the LRU head, so hits still
+	 * have to refresh them. Repeated hits on the cached node skip the
+	 * global extent_lock as long as it is still the LRU tail, so that
+	 * readers of the same extent don't all serialize on that lock. The
+	 * unlocked check may be stale, that only costs or saves one move.
+	 */
+	if (en == et->cached_en) {
 		stat_inc_cached_node_hit(sbi, type);
-	else
+		if (data_race(list_is_last(&en->list, &eti->extent_list)))
+			goto out;
+	} else {
 		stat_inc_rbtree_node_hit(sbi, type);
+	}
 
-	*ei = en->ei;
 	spin_lock(&eti->extent_lock);
 	if (!list_empty(&en->list)) {
 		list_move_tail(&en->list, &eti->extent_list);
 		et->cached_en = en;
 	}
 	spin_unlock(&eti->extent_lock);
-	ret = true;
 out:
 	stat_inc_total_hit(sbi, type);
 	read_unlock(&et->lock);
@@ -1830,6 +1830,8 @@ struct f2fs_sb_info {
 	u64 compr_written_block;
 	u64 compr_saved_block;
 	u32 compr_new_inode;
+	u64 compr_cluster_count;		/* clusters run through compressor */
+	u64 compr_time_us;			/* time spent compressing them */
 
 	/* For compressed block cache */
 	struct inode *compress_inode;		/* cache compressed blocks */
@@ -4086,6 +4088,7 @@ struct f2fs_stat_info {
 	int prefree_count, free_segs, free_secs;
 	int cp_call_count[MAX_CALL_TYPE], cp_count;
 	int gc_call_count[MAX_CALL_TYPE];
+	unsigned int gc_time_ms[MAX_CALL_TYPE];
 	int gc_segs[2][2];
 	int gc_secs[2][2];
 	int tot_blks, data_blks, node_blks;
@@ -4199,6 +4202,8 @@ static inline struct f2fs_stat_info *F2FS_STAT(struct f2fs_sb_info *sbi)
 	} while (0)
 #define stat_inc_gc_call_count(sbi, foreground)				\
 		(F2FS_STAT(sbi)->gc_call_count[(foreground)]++)
+#define stat_add_gc_time(sbi, foreground, ms)				\
+		(F2FS_STAT(sbi)->gc_time_ms[(foreground)] += (ms))
 #define stat_inc_gc_sec_count(sbi, type, gc_type)			\
 		(F2FS_STAT(sbi)->gc_secs[(type)][(gc_type)]++)
 #define stat_inc_gc_seg_count(sbi, type, gc_type)			\
@@ -4259,6 +4264,7 @@ void f2fs_update_sit_info(struct f2fs_sb_info *sbi);
 #define stat_inc_block_count(sbi, curseg)		do { } while (0)
 #define stat_inc_inplace_blocks(sbi)			do { } while (0)
 #define stat_inc_gc_call_count(sbi, foreground)		do { } while (0)
+#define stat_add_gc_time(sbi, foreground, ms)		do { } while (0)
 #define stat_inc_gc_sec_count(sbi, type, gc_type)	do { } while (0)
 #define stat_inc_gc_seg_count(sbi, type, gc_type)	do { } while (0)
 #define stat_inc_tot_blk_count(si, blks)		do { } while (0)
@@ -4490,6 +4496,12 @@ void f2fs_invalidate_compress_pages(struct f2fs_sb_info *sbi, nid_t ino);
 		sbi->compr_written_block += blocks;			\
 		sbi->compr_saved_block += diff;				\
 	} while (0)
+#define add_compr_time_stat(inode, us)					\
+	do {								\
+		struct f2fs_sb_info *sbi = F2FS_I_SB(inode);		\
+		sbi->compr_cluster_count++;				\
+		sbi->compr_time_us += (us);				\
+	} while (0)
 #else
 static inline bool f2fs_is_compressed_page(struct page *page) { return false; }
 static inline bool f2fs_is_compress_backend_ready(struct inode *inode)
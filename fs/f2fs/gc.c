@@ -45,6 +45,7 @@ static int gc_thread_func(void *data)
 	set_freezable();
 	do {
 		bool sync_mode, foreground = false;
+		unsigned long start;
 
 		wait_event_freezable_timeout(*wq,
 				kthread_should_stop() ||
@@ -152,6 +153,7 @@ static int gc_thread_func(void *data)
 		gc_control.nr_free_secs = foreground ? 1 : 0;
 
 		/* if return value is not zero, no victim was selected */
+		start = jiffies;
 		if (f2fs_gc(sbi, &gc_control)) {
 			/* don't bother wait_ms by foreground gc */
 			if (!foreground)
@@ -162,6 +164,10 @@ static int gc_thread_func(void *data)
 				wait_ms = gc_th->min_sleep_time;
 		}
 
+		if (!foreground)
+			stat_add_gc_time(sbi, BACKGROUND,
+					jiffies_to_msecs(jiffies - start));
+
 		if (foreground)
 			wake_up_all(&gc_th->fggc_wq);
 
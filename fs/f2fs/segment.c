@@ -414,6 +414,8 @@ int f2fs_commit_atomic_write(struct inode *inode)
  */
 void f2fs_balance_fs(struct f2fs_sb_info *sbi, bool need)
 {
+	unsigned long start;
+
 	if (f2fs_cp_error(sbi))
 		return;
 
@@ -434,6 +436,7 @@ void f2fs_balance_fs(struct f2fs_sb_info *sbi, bool need)
 	if (has_enough_free_secs(sbi, 0, 0))
 		return;
 
+	start = jiffies;
 	if (test_opt(sbi, GC_MERGE) && sbi->gc_thread &&
 				sbi->gc_thread->f2fs_gc_task) {
 		DEFINE_WAIT(wait);
@@ -455,6 +458,7 @@ void f2fs_balance_fs(struct f2fs_sb_info *sbi, bool need)
 		stat_inc_gc_call_count(sbi, FOREGROUND);
 		f2fs_gc(sbi, &gc_control);
 	}
+	stat_add_gc_time(sbi, FOREGROUND, jiffies_to_msecs(jiffies - start));
 }
 
 static inline bool excess_dirty_threshold(struct f2fs_sb_info *sbi)
@@ -367,6 +367,12 @@ static ssize_t f2fs_sbi_show(struct f2fs_attr *a,
 
 	if (!strcmp(a->attr.name, "compr_new_inode"))
 		return sysfs_emit(buf, "%u\n", sbi->compr_new_inode);
+
+	if (!strcmp(a->attr.name, "compr_cluster_count"))
+		return sysfs_emit(buf, "%llu\n", sbi->compr_cluster_count);
+
+	if (!strcmp(a->attr.name, "compr_time_us"))
+		return sysfs_emit(buf, "%llu\n", sbi->compr_time_us);
 #endif
 
 	if (!strcmp(a->attr.name, "gc_segment_mode"))
@@ -665,6 +671,15 @@ static ssize_t __sbi_store(struct f2fs_attr *a,
 		return count;
 	}
 
+	if (!strcmp(a->attr.name, "compr_cluster_count") ||
+		!strcmp(a->attr.name, "compr_time_us")) {
+		if (t != 0)
+			return -EINVAL;
+		sbi->compr_cluster_count = 0;
+		sbi->compr_time_us = 0;
+		return count;
+	}
+
 	if (!strcmp(a->attr.name, "compress_percent")) {
 		if (t == 0 || t > 100)
 			return -EINVAL;
@@ -1104,6 +1119,8 @@ F2FS_SBI_GENERAL_RW_ATTR(max_fragment_hole);
 F2FS_SBI_GENERAL_RW_ATTR(compr_written_block);
 F2FS_SBI_GENERAL_RW_ATTR(compr_saved_block);
 F2FS_SBI_GENERAL_RW_ATTR(compr_new_inode);
+F2FS_SBI_GENERAL_RW_ATTR(compr_cluster_count);
+F2FS_SBI_GENERAL_RW_ATTR(compr_time_us);
 F2FS_SBI_GENERAL_RW_ATTR(compress_percent);
 F2FS_SBI_GENERAL_RW_ATTR(compress_watermark);
 #endif
@@ -1130,6 +1147,8 @@ STAT_INFO_RO_ATTR(cp_foreground_calls, cp_call_count[FOREGROUND]);
 STAT_INFO_RO_ATTR(cp_background_calls, cp_call_count[BACKGROUND]);
 STAT_INFO_RO_ATTR(gc_foreground_calls, gc_call_count[FOREGROUND]);
 STAT_INFO_RO_ATTR(gc_background_calls, gc_call_count[BACKGROUND]);
+STAT_INFO_RO_ATTR(gc_foreground_time_ms, gc_time_ms[FOREGROUND]);
+STAT_INFO_RO_ATTR(gc_background_time_ms, gc_time_ms[BACKGROUND]);
 #endif
 
 /* FAULT_INFO ATTR */
@@ -1276,6 +1295,8 @@ static struct attribute *f2fs_attrs[] = {
 	ATTR_LIST(cp_background_calls),
 	ATTR_LIST(gc_foreground_calls),
 	ATTR_LIST(gc_background_calls),
+	ATTR_LIST(gc_foreground_time_ms),
+	ATTR_LIST(gc_background_time_ms),
 	ATTR_LIST(moved_blocks_foreground),
 	ATTR_LIST(moved_blocks_background),
 	ATTR_LIST(avg_vblocks),
@@ -1288,6 +1309,8 @@ static struct attribute *f2fs_attrs[] = {
 	ATTR_LIST(compr_written_block),
 	ATTR_LIST(compr_saved_block),
 	ATTR_LIST(compr_new_inode),
+	ATTR_LIST(compr_cluster_count),
+	ATTR_LIST(compr_time_us),
 	ATTR_LIST(compress_percent),
 	ATTR_LIST(compress_watermark),
 #endif
@@ -1219,6 +1219,7 @@ int gfs2_glock_get(struct gfs2_sbd *sdp, u64 number,
 	preempt_enable();
 	gl->gl_stats.stats[GFS2_LKS_DCOUNT] = 0;
 	gl->gl_stats.stats[GFS2_LKS_QCOUNT] = 0;
+	gl->gl_stats.stats[GFS2_LKS_HCOUNT] = 0;
 	gl->gl_tchange = jiffies;
 	gl->gl_object = NULL;
 	gl->gl_hold_time = GL_GLOCK_DFT_HOLD;
@@ -1588,6 +1589,11 @@ int gfs2_glock_nq(struct gfs2_holder *gh)
 		gfs2_glock_queue_work(gl, 0);
 	}
 	run_queue(gl, 1);
+	/* Granted straight from the lock state cached on this node */
+	if (test_bit(HIF_HOLDER, &gh->gh_iflags)) {
+		gfs2_glstats_inc(gl, GFS2_LKS_HCOUNT);
+		gfs2_sbstats_inc(gl, GFS2_LKS_HCOUNT);
+	}
 	spin_unlock(&gl->gl_lockref.lock);
 
 	error = 0;
@@ -2422,7 +2428,7 @@ static int gfs2_glstats_seq_show(struct seq_file *seq, void *iter_ptr)
 {
 	struct gfs2_glock *gl = iter_ptr;
 
-	seq_printf(seq, "G: n:%u/%llx rtt:%llu/%llu rttb:%llu/%llu irt:%llu/%llu dcnt: %llu qcnt: %llu\n",
+	seq_printf(seq, "G: n:%u/%llx rtt:%llu/%llu rttb:%llu/%llu irt:%llu/%llu dcnt: %llu qcnt: %llu hcnt: %llu\n",
 		   gl->gl_name.ln_type,
 		   (unsigned long long)gl->gl_name.ln_number,
 		   (unsigned long long)gl->gl_stats.stats[GFS2_LKS_SRTT],
@@ -2432,7 +2438,8 @@ static int gfs2_glstats_seq_show(struct seq_file *seq, void *iter_ptr)
 		   (unsigned long long)gl->gl_stats.stats[GFS2_LKS_SIRT],
 		   (unsigned long long)gl->gl_stats.stats[GFS2_LKS_SIRTVAR],
 		   (unsigned long long)gl->gl_stats.stats[GFS2_LKS_DCOUNT],
-		   (unsigned long long)gl->gl_stats.stats[GFS2_LKS_QCOUNT]);
+		   (unsigned long long)gl->gl_stats.stats[GFS2_LKS_QCOUNT],
+		   (unsigned long long)gl->gl_stats.stats[GFS2_LKS_HCOUNT]);
 	return 0;
 }
 
@@ -2459,6 +2466,7 @@ static const char *gfs2_stype[] = {
 	[GFS2_LKS_SIRTVAR]	= "sirtvar",
 	[GFS2_LKS_DCOUNT]	= "dlm",
 	[GFS2_LKS_QCOUNT]	= "queue",
+	[GFS2_LKS_HCOUNT]	= "cached",
 };
 
 #define GFS2_NR_SBSTATS (ARRAY_SIZE(gfs2_gltype) * ARRAY_SIZE(gfs2_stype))
@@ -2466,9 +2474,9 @@ static const char *gfs2_stype[] = {
 static int gfs2_sbstats_seq_show(struct seq_file *seq, void *iter_ptr)
 {
 	struct gfs2_sbd *sdp = seq->private;
-	loff_t pos = *(loff_t *)iter_ptr;
-	unsigned index = pos >> 3;
-	unsigned subindex = pos & 0x07;
+	unsigned pos = *(loff_t *)iter_ptr;
+	unsigned index = pos / ARRAY_SIZE(gfs2_stype);
+	unsigned subindex = pos % ARRAY_SIZE(gfs2_stype);
 	int i;
 
 	if (index == 0 && subindex != 0)
@@ -241,6 +241,7 @@ enum {
 	GFS2_LKS_SIRTVAR = 5,	/* Smoothed Inter-request variance */
 	GFS2_LKS_DCOUNT = 6,	/* Count of dlm requests */
 	GFS2_LKS_QCOUNT = 7,	/* Count of gfs2_holder queues */
+	GFS2_LKS_HCOUNT = 8,	/* Count of queues granted without a dlm request */
 	GFS2_NR_LKSTATS
 };
 
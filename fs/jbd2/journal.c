@@ -1126,6 +1126,7 @@ static void *jbd2_seq_info_next(struct seq_file *seq, void *v, loff_t *pos)
 static int jbd2_seq_info_show(struct seq_file *seq, void *v)
 {
 	struct jbd2_stats_proc_session *s = seq->private;
+	int i;
 
 	if (v != SEQ_START_TOKEN)
 		return 0;
@@ -1157,6 +1158,12 @@ static int jbd2_seq_info_show(struct seq_file *seq, void *v)
 	    s->stats->run.rs_blocks / s->stats->ts_tid);
 	seq_printf(seq, "  %lu logged blocks per transaction\n",
 	    s->stats->run.rs_blocks_logged / s->stats->ts_tid);
+	seq_printf(seq, "commit time histogram:\n");
+	for (i = 0; i < JBD2_COMMIT_HIST_NR - 1; i++)
+		seq_printf(seq, "  <%ums: %lu\n", 1U << (2 * i),
+			   s->stats->ts_commit_hist[i]);
+	seq_printf(seq, "  >=%ums: %lu\n", 1U << (2 * (i - 1)),
+		   s->stats->ts_commit_hist[i]);
 	return 0;
 }
 
@@ -191,6 +191,7 @@ static void netfs_issue_read(struct netfs_io_request *rreq,
 {
 	switch (subreq->source) {
 	case NETFS_DOWNLOAD_FROM_SERVER:
+		netfs_stat_sreq_size(netfs_n_rh_sreq_size, subreq->len);
 		rreq->netfs_ops->issue_read(subreq);
 		break;
 	case NETFS_READ_FROM_CACHE:
@@ -50,6 +50,16 @@ atomic_t fscache_n_culled;
 EXPORT_SYMBOL(fscache_n_culled);
 atomic_t fscache_n_dio_misfit;
 EXPORT_SYMBOL(fscache_n_dio_misfit);
+atomic_t fscache_n_ondemand_hit;
+EXPORT_SYMBOL(fscache_n_ondemand_hit);
+atomic_t fscache_n_ondemand_miss;
+EXPORT_SYMBOL(fscache_n_ondemand_miss);
+atomic_t fscache_n_ondemand_queued;
+EXPORT_SYMBOL(fscache_n_ondemand_queued);
+atomic_t fscache_n_ondemand_sent;
+EXPORT_SYMBOL(fscache_n_ondemand_sent);
+atomic_t fscache_n_ondemand_cancelled;
+EXPORT_SYMBOL(fscache_n_ondemand_cancelled);
 
 /*
  * display the general statistics
@@ -99,5 +109,12 @@ int fscache_stats_show(struct seq_file *m)
 		   atomic_read(&fscache_n_read),
 		   atomic_read(&fscache_n_write),
 		   atomic_read(&fscache_n_dio_misfit));
+
+	seq_printf(m, "OnDmnd : hit=%u miss=%u req=%u sent=%u cancel=%u\n",
+		   atomic_read(&fscache_n_ondemand_hit),
+		   atomic_read(&fscache_n_ondemand_miss),
+		   atomic_read(&fscache_n_ondemand_queued),
+		   atomic_read(&fscache_n_ondemand_sent),
+		   atomic_read(&fscache_n_ondemand_cancelled));
 	return 0;
 }
@@ -155,8 +155,22 @@ extern atomic_t netfs_n_wb_lock_skip;
 extern atomic_t netfs_n_wb_lock_wait;
 extern atomic_t netfs_n_folioq;
 
+/* Histogram of server subrequest sizes: <=16K, <=64K, <=256K, <=1M, larger */
+#define NETFS_SREQ_SIZE_NR 5
+extern atomic_t netfs_n_rh_sreq_size[NETFS_SREQ_SIZE_NR];
+extern atomic_t netfs_n_wh_sreq_size[NETFS_SREQ_SIZE_NR];
+
 int netfs_stats_show(struct seq_file *m, void *v);
 
+static inline void netfs_stat_sreq_size(atomic_t *hist, size_t len)
+{
+	unsigned int i = 0;
+
+	for (len = (len - 1) >> 14; len && i < NETFS_SREQ_SIZE_NR - 1; len >>= 2)
+		i++;
+	atomic_inc(&hist[i]);
+}
+
 static inline void netfs_stat(atomic_t *stat)
 {
 	atomic_inc(stat);
@@ -170,6 +184,7 @@ static inline void netfs_stat_d(atomic_t *stat)
 #else
 #define netfs_stat(x) do {} while(0)
 #define netfs_stat_d(x) do {} while(0)
+#define netfs_stat_sreq_size(hist, len) do {} while(0)
 #endif
 
 /*
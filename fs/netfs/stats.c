@@ -48,6 +48,17 @@ atomic_t netfs_n_wh_retry_write_subreq;
 atomic_t netfs_n_wb_lock_skip;
 atomic_t netfs_n_wb_lock_wait;
 atomic_t netfs_n_folioq;
+atomic_t netfs_n_rh_sreq_size[NETFS_SREQ_SIZE_NR];
+atomic_t netfs_n_wh_sreq_size[NETFS_SREQ_SIZE_NR];
+
+static void netfs_show_sreq_sizes(struct seq_file *m, const char *name,
+				  atomic_t *hist)
+{
+	seq_printf(m, "%s: 16K=%u 64K=%u 256K=%u 1M=%u big=%u\n", name,
+		   atomic_read(&hist[0]), atomic_read(&hist[1]),
+		   atomic_read(&hist[2]), atomic_read(&hist[3]),
+		   atomic_read(&hist[4]));
+}
 
 int netfs_stats_show(struct seq_file *m, void *v)
 {
@@ -98,6 +109,8 @@ int netfs_stats_show(struct seq_file *m, void *v)
 	seq_printf(m, "WbLock : skip=%u wait=%u\n",
 		   atomic_read(&netfs_n_wb_lock_skip),
 		   atomic_read(&netfs_n_wb_lock_wait));
+	netfs_show_sreq_sizes(m, "DlSizes", netfs_n_rh_sreq_size);
+	netfs_show_sreq_sizes(m, "UlSizes", netfs_n_wh_sreq_size);
 	return fscache_stats_show(m);
 }
 EXPORT_SYMBOL(netfs_stats_show);
@@ -236,6 +236,8 @@ static void netfs_do_issue_write(struct netfs_io_stream *stream,
 		return netfs_write_subrequest_terminated(subreq, subreq->error, false);
 
 	trace_netfs_sreq(subreq, netfs_sreq_trace_submit);
+	if (stream->source == NETFS_UPLOAD_TO_SERVER)
+		netfs_stat_sreq_size(netfs_n_wh_sreq_size, subreq->len);
 	stream->issue_write(subreq);
 }
 
@@ -26,12 +26,59 @@ static int show_softirqs(struct seq_file *p, void *v)
 	return 0;
 }
 
+#ifdef CONFIG_IRQ_TIME_ACCOUNTING
+/*
+ * /proc/softirq_times  ... display the time spent in each softirq in us,
+ * followed by a histogram of the run time of one invocation of each
+ */
+static int show_softirq_times(struct seq_file *p, void *v)
+{
+	int i, j, b;
+
+	seq_puts(p, "                    ");
+	for_each_possible_cpu(i)
+		seq_printf(p, "CPU%-8d", i);
+	seq_putc(p, '\n');
+
+	for (i = 0; i < NR_SOFTIRQS; i++) {
+		seq_printf(p, "%12s:", softirq_to_name[i]);
+		for_each_possible_cpu(j)
+			seq_put_decimal_ull_width(p, " ",
+				div_u64(kstat_softirq_time_cpu(i, j), NSEC_PER_USEC), 10);
+		seq_putc(p, '\n');
+	}
+
+	seq_printf(p, "\n%12s:", "<us");
+	for (b = 0; b < SOFTIRQ_TIME_BUCKETS - 1; b++)
+		seq_printf(p, " %10u", 1U << b);
+	seq_printf(p, " %10s\n", "more");
+	for (i = 0; i < NR_SOFTIRQS; i++) {
+		seq_printf(p, "%12s:", softirq_to_name[i]);
+		for (b = 0; b < SOFTIRQ_TIME_BUCKETS; b++) {
+			unsigned long long sum = 0;
+
+			for_each_possible_cpu(j)
+				sum += kstat_softirq_hist_cpu(i, b, j);
+			seq_put_decimal_ull_width(p, " ", sum, 10);
+		}
+		seq_putc(p, '\n');
+	}
+	return 0;
+}
+#endif
+
 static int __init proc_softirqs_init(void)
 {
 	struct proc_dir_entry *pde;
 
 	pde = proc_create_single("softirqs", 0, NULL, show_softirqs);
 	pde_make_permanent(pde);
+#ifdef CONFIG_IRQ_TIME_ACCOUNTING
+	if (softirq_time_enabled()) {
+		pde = proc_create_single("softirq_times", 0, NULL, show_softirq_times);
+		pde_make_permanent(pde);
+	}
+#endif
 	return 0;
 }
 fs_initcall(proc_softirqs_init);
@@ -79,8 +79,33 @@ static void show_all_irqs(struct seq_file *p)
 	show_irq_gap(p, irq_get_nr_irqs() - next);
 }
 
+/* Columns of a cpu line, in the order they are printed */
+enum {
+	STAT_USER,
+	STAT_NICE,
+	STAT_SYSTEM,
+	STAT_IDLE,
+	STAT_IOWAIT,
+	STAT_IRQ,
+	STAT_SOFTIRQ,
+	STAT_STEAL,
+	STAT_GUEST,
+	STAT_GUEST_NICE,
+	NR_STAT_TIMES,
+};
+
+static void show_cpu_times(struct seq_file *p, const u64 *times)
+{
+	int i;
+
+	for (i = 0; i < NR_STAT_TIMES; i++)
+		seq_put_decimal_ull(p, " ", nsec_to_clock_t(times[i]));
+	seq_putc(p, '\n');
+}
+
 static int show_stat(struct seq_file *p, void *v)
 {
+	u64 (*cpu_times)[NR_STAT_TIMES] = p->private;
 	int i, j;
 	u64 user, nice, system, idle, iowait, irq, softirq, steal;
 	u64 guest, guest_nice;
@@ -99,19 +124,36 @@ static int show_stat(struct seq_file *p, void *v)
 	for_each_possible_cpu(i) {
 		struct kernel_cpustat kcpustat;
 		u64 *cpustat = kcpustat.cpustat;
+		u64 *times = cpu_times[i];
 
+		/*
+		 * Sample each CPU once and keep the result for its own line
+		 * below; fetching kcpustat and the NO_HZ idle times is not
+		 * free on large machines.
+		 */
 		kcpustat_cpu_fetch(&kcpustat, i);
 
-		user		+= cpustat[CPUTIME_USER];
-		nice		+= cpustat[CPUTIME_NICE];
-		system		+= cpustat[CPUTIME_SYSTEM];
-		idle		+= get_idle_time(&kcpustat, i);
-		iowait		+= get_iowait_time(&kcpustat, i);
-		irq		+= cpustat[CPUTIME_IRQ];
-		softirq		+= cpustat[CPUTIME_SOFTIRQ];
-		steal		+= cpustat[CPUTIME_STEAL];
-		guest		+= cpustat[CPUTIME_GUEST];
-		guest_nice	+= cpustat[CPUTIME_GUEST_NICE];
+		times[STAT_USER]	= cpustat[CPUTIME_USER];
+		times[STAT_NICE]	= cpustat[CPUTIME_NICE];
+		times[STAT_SYSTEM]	= cpustat[CPUTIME_SYSTEM];
+		times[STAT_IDLE]	= get_idle_time(&kcpustat, i);
+		times[STAT_IOWAIT]	= get_iowait_time(&kcpustat, i);
+		times[STAT_IRQ]		= cpustat[CPUTIME_IRQ];
+		times[STAT_SOFTIRQ]	= cpustat[CPUTIME_SOFTIRQ];
+		times[STAT_STEAL]	= cpustat[CPUTIME_STEAL];
+		times[STAT_GUEST]	= cpustat[CPUTIME_GUEST];
+		times[STAT_GUEST_NICE]	= cpustat[CPUTIME_GUEST_NICE];
+
+		user		+= times[STAT_USER];
+		nice		+= times[STAT_NICE];
+		system		+= times[STAT_SYSTEM];
+		idle		+= times[STAT_IDLE];
+		iowait		+= times[STAT_IOWAIT];
+		irq		+= times[STAT_IRQ];
+		softirq		+= times[STAT_SOFTIRQ];
+		steal		+= times[STAT_STEAL];
+		guest		+= times[STAT_GUEST];
+		guest_nice	+= times[STAT_GUEST_NICE];
 		sum		+= kstat_cpu_irqs_sum(i);
 		sum		+= arch_irq_stat_cpu(i);
 
@@ -137,34 +179,8 @@ static int show_stat(struct seq_file *p, void *v)
 	seq_putc(p, '\n');
 
 	for_each_online_cpu(i) {
-		struct kernel_cpustat kcpustat;
-		u64 *cpustat = kcpustat.cpustat;
-
-		kcpustat_cpu_fetch(&kcpustat, i);
-
-		/* Copy values here to work around gcc-2.95.3, gcc-2.96 */
-		user		= cpustat[CPUTIME_USER];
-		nice		= cpustat[CPUTIME_NICE];
-		system		= cpustat[CPUTIME_SYSTEM];
-		idle		= get_idle_time(&kcpustat, i);
-		iowait		= get_iowait_time(&kcpustat, i);
-		irq		= cpustat[CPUTIME_IRQ];
-		softirq		= cpustat[CPUTIME_SOFTIRQ];
-		steal		= cpustat[CPUTIME_STEAL];
-		guest		= cpustat[CPUTIME_GUEST];
-		guest_nice	= cpustat[CPUTIME_GUEST_NICE];
-		seq_printf(p, "cpu%d", i);
-		seq_put_decimal_ull(p, " ", nsec_to_clock_t(user));
-		seq_put_decimal_ull(p, " ", nsec_to_clock_t(nice));
-		seq_put_decimal_ull(p, " ", nsec_to_clock_t(system));
-		seq_put_decimal_ull(p, " ", nsec_to_clock_t(idle));
-		seq_put_decimal_ull(p, " ", nsec_to_clock_t(iowait));
-		seq_put_decimal_ull(p, " ", nsec_to_clock_t(irq));
-		seq_put_decimal_ull(p, " ", nsec_to_clock_t(softirq));
-		seq_put_decimal_ull(p, " ", nsec_to_clock_t(steal));
-		seq_put_decimal_ull(p, " ", nsec_to_clock_t(guest));
-		seq_put_decimal_ull(p, " ", nsec_to_clock_t(guest_nice));
-		seq_putc(p, '\n');
+		seq_put_decimal_ull(p, "cpu", i);
+		show_cpu_times(p, cpu_times[i]);
 	}
 	seq_put_decimal_ull(p, "intr ", (unsigned long long)sum);
 
@@ -194,10 +210,27 @@ static int show_stat(struct seq_file *p, void *v)
 static int stat_open(struct inode *inode, struct file *file)
 {
 	unsigned int size = 1024 + 128 * num_online_cpus();
+	u64 (*cpu_times)[NR_STAT_TIMES];
+	int ret;
+
+	cpu_times = kvmalloc_array(nr_cpu_ids, sizeof(*cpu_times), GFP_KERNEL);
+	if (!cpu_times)
+		return -ENOMEM;
 
 	/* minimum size to display an interrupt count : 2 bytes */
 	size += 2 * irq_get_nr_irqs();
-	return single_open_size(file, show_stat, NULL, size);
+	ret = single_open_size(file, show_stat, cpu_times, size);
+	if (ret)
+		kvfree(cpu_times);
+	return ret;
+}
+
+static int stat_release(struct inode *inode, struct file *file)
+{
+	struct seq_file *seq = file->private_data;
+
+	kvfree(seq->private);
+	return single_release(inode, file);
 }
 
 static const struct proc_ops stat_proc_ops = {
@@ -205,7 +238,7 @@ static const struct proc_ops stat_proc_ops = {
 	.proc_open	= stat_open,
 	.proc_read_iter	= seq_read_iter,
 	.proc_lseek	= seq_lseek,
-	.proc_release	= single_release,
+	.proc_release	= stat_release,
 };
 
 static int __init proc_stat_init(void)
@@ -23,6 +23,7 @@
 #include <linux/minmax.h>
 #include <linux/overflow.h>
 #include <linux/buildid.h>
+#include <linux/sysctl.h>
 
 #include <asm/elf.h>
 #include <asm/tlb.h>
@@ -1175,13 +1176,118 @@ static int show_smap(struct seq_file *m, void *v)
 	return 0;
 }
 
+/*
+ * Readers that poll smaps_rollup for many processes can accept a result up
+ * to vm.smaps_rollup_max_age_ms old. It is then served from the last walk of
+ * the mm without taking mmap_lock. 0 walks the page tables on every read.
+ */
+static unsigned int smaps_rollup_max_age_ms __read_mostly;
+
+struct smaps_rollup_cache {
+	spinlock_t lock;
+	bool valid;
+	unsigned long stamp;
+	unsigned long start;
+	unsigned long end;
+	struct mem_size_stats mss;
+};
+
+static bool smaps_rollup_cache_get(struct mm_struct *mm, unsigned int max_age,
+				   struct mem_size_stats *mss,
+				   unsigned long *start, unsigned long *end,
+				   unsigned long *age)
+{
+	struct smaps_rollup_cache *cache = READ_ONCE(mm->smaps_rollup_cache);
+	bool hit = false;
+
+	if (!cache)
+		return false;
+
+	spin_lock(&cache->lock);
+	if (cache->valid &&
+	    time_before(jiffies, cache->stamp + msecs_to_jiffies(max_age))) {
+		*mss = cache->mss;
+		*start = cache->start;
+		*end = cache->end;
+		*age = jiffies - cache->stamp;
+		hit = true;
+	}
+	spin_unlock(&cache->lock);
+	return hit;
+}
+
+static void smaps_rollup_cache_set(struct mm_struct *mm,
+				   const struct mem_size_stats *mss,
+				   unsigned long start, unsigned long end)
+{
+	struct smaps_rollup_cache *cache = READ_ONCE(mm->smaps_rollup_cache);
+
+	if (!cache) {
+		struct smaps_rollup_cache *new;
+
+		new = kzalloc(sizeof(*new), GFP_KERNEL);
+		if (!new)
+			return;
+		spin_lock_init(&new->lock);
+		cache = cmpxchg(&mm->smaps_rollup_cache, NULL, new);
+		if (cache)
+			kfree(new);
+		else
+			cache = new;
+	}
+
+	spin_lock(&cache->lock);
+	cache->mss = *mss;
+	cache->start = start;
+	cache->end = end;
+	cache->stamp = jiffies;
+	cache->valid = true;
+	spin_unlock(&cache->lock);
+}
+
+static const struct ctl_table smaps_rollup_sysctl_table[] = {
+	{
+		.procname	= "smaps_rollup_max_age_ms",
+		.data		= &smaps_rollup_max_age_ms,
+		.maxlen		= sizeof(smaps_rollup_max_age_ms),
+		.mode		= 0644,
+		.proc_handler	= proc_douintvec,
+	},
+};
+
+static int __init smaps_rollup_sysctl_init(void)
+{
+	register_sysctl_init("vm", smaps_rollup_sysctl_table);
+	return 0;
+}
+fs_initcall(smaps_rollup_sysctl_init);
+
+static void show_smaps_rollup_mss(struct seq_file *m, struct mm_struct *mm,
+				  const struct mem_size_stats *mss,
+				  unsigned long start, unsigned long end)
+{
+	show_vma_header_prefix(m, start, end, 0, 0, 0, 0);
+	seq_pad(m, ' ');
+	seq_puts(m, "[rollup]\n");
+
+	__show_smap(m, mss, true);
+#ifdef CONFIG_TRANSPARENT_HUGEPAGE
+	seq_put_decimal_ull_width(m, "THPCollapseOK:  ",
+				  atomic_long_read(&mm->thp_collapse_succeeded), 8);
+	seq_put_decimal_ull_width(m, "\nTHPCollapseErr: ",
+				  atomic_long_read(&mm->thp_collapse_failed), 8);
+	seq_putc(m, '\n');
+#endif
+}
+
 static int show_smaps_rollup(struct seq_file *m, void *v)
 {
 	struct proc_maps_private *priv = m->private;
 	struct mem_size_stats mss = {};
 	struct mm_struct *mm = priv->mm;
 	struct vm_area_struct *vma;
-	unsigned long vma_start = 0, last_vma_end = 0;
+	unsigned long vma_start = 0, last_vma_end = 0, age;
+	unsigned int max_age = READ_ONCE(smaps_rollup_max_age_ms);
 	int ret = 0;
 	VMA_ITERATOR(vmi, mm, 0);
 
@@ -1194,6 +1300,15 @@ static int show_smaps_rollup(struct seq_file *m, void *v)
 		goto out_put_task;
 	}
 
+	if (max_age && smaps_rollup_cache_get(mm, max_age, &mss, &vma_start,
+					      &last_vma_end, &age)) {
+		show_smaps_rollup_mss(m, mm, &mss, vma_start, last_vma_end);
+		seq_put_decimal_ull_width(m, "RollupAge:      ",
+					  jiffies_to_msecs(age), 8);
+		seq_puts(m, " ms\n");
+		goto out_put_mm;
+	}
+
 	ret = mmap_read_lock_killable(mm);
 	if (ret)
 		goto out_put_mm;
@@ -1279,11 +1394,12 @@ static int show_smaps_rollup(struct seq_file *m, void *v)
 	} for_each_vma(vmi, vma);
 
 empty_set:
-	show_vma_header_prefix(m, vma_start, last_vma_end, 0, 0, 0, 0);
-	seq_pad(m, ' ');
-	seq_puts(m, "[rollup]\n");
-
-	__show_smap(m, &mss, true);
+	show_smaps_rollup_mss(m, mm, &mss, vma_start, last_vma_end);
+	if (max_age) {
+		smaps_rollup_cache_set(mm, &mss, vma_start, last_vma_end);
+		seq_put_decimal_ull_width(m, "RollupAge:      ", 0, 8);
+		seq_puts(m, " ms\n");
+	}
 
 	release_task_mempolicy(priv);
 	mmap_read_unlock(mm);
@@ -147,7 +147,8 @@ cifs_dump_channel(struct seq_file *m, int i, struct cifs_chan *chan)
 		   "\n\t\tNumber of credits: %d,%d,%d Dialect 0x%x"
 		   "\n\t\tTCP status: %d Instance: %d"
 		   "\n\t\tLocal Users To Server: %d SecMode: 0x%x Req On Wire: %d"
-		   "\n\t\tIn Send: %d In MaxReq Wait: %d",
+		   "\n\t\tIn Send: %d In MaxReq Wait: %d"
+		   "\n\t\tBytes Read: %lld Bytes Written: %lld Credit Skips: %d",
 		   i+1, server->conn_id,
 		   server->credits,
 		   server->echo_credits,
@@ -159,7 +160,10 @@ cifs_dump_channel(struct seq_file *m, int i, struct cifs_chan *chan)
 		   server->sec_mode,
 		   in_flight(server),
 		   atomic_read(&server->in_send),
-		   atomic_read(&server->num_waiters));
+		   atomic_read(&server->num_waiters),
+		   atomic64_read(&server->bytes_read),
+		   atomic64_read(&server->bytes_written),
+		   atomic_read(&server->credit_skips));
 #ifdef CONFIG_NET_NS
 	if (server->net)
 		seq_printf(m, " Net namespace: %u ", server->net->ns.inum);
@@ -408,6 +412,10 @@ static int cifs_debug_data_proc_show(struct seq_file *m, void *v)
 			server->smbd_conn->count_get_receive_buffer,
 			server->smbd_conn->count_put_receive_buffer,
 			server->smbd_conn->count_send_empty);
+		seq_printf(m, "\nDebug count_post_send: %x "
+			"count_mr_register: %x",
+			server->smbd_conn->count_post_send,
+			server->smbd_conn->count_mr_register);
 		seq_printf(m, "\nRead Queue count_reassembly_queue: %x "
 			"count_enqueue_reassembly_queue: %x "
 			"count_dequeue_reassembly_queue: %x "
@@ -800,6 +800,10 @@ struct TCP_Server_Info {
 	unsigned int total_read; /* total amount of data read in this pass */
 	atomic_t in_send; /* requests trying to send */
 	atomic_t num_waiters;   /* blocked waiting to get in sendrecv */
+	/* per channel I/O, used to balance multichannel sessions */
+	atomic64_t bytes_read;
+	atomic64_t bytes_written;
+	atomic_t credit_skips;	/* times skipped by cifs_pick_channel */
 #ifdef CONFIG_CIFS_STATS2
 	atomic_t num_cmds[NUMBER_OF_SMB2_COMMANDS]; /* total requests by cmd */
 	atomic_t smb2slowcmd[NUMBER_OF_SMB2_COMMANDS]; /* count resps > 1 sec */
@@ -4554,6 +4554,7 @@ smb2_readv_callback(struct mid_q_entry *mid)
 		/* FIXME: should this be counted toward the initiating task? */
 		task_io_account_read(rdata->got_bytes);
 		cifs_stats_bytes_read(tcon, rdata->got_bytes);
+		atomic64_add(rdata->got_bytes, &server->bytes_read);
 		break;
 	case MID_REQUEST_SUBMITTED:
 	case MID_RETRY_NEEDED:
@@ -4841,6 +4842,7 @@ smb2_writev_callback(struct mid_q_entry *mid)
 			written &= 0xFFFF;
 
 		cifs_stats_bytes_written(tcon, written);
+		atomic64_add(written, &server->bytes_written);
 
 		if (written < wdata->subreq.len) {
 			wdata->result = -ENOSPC;
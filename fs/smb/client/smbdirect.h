@@ -170,6 +170,8 @@ struct smbd_connection {
 	unsigned int count_enqueue_reassembly_queue;
 	unsigned int count_dequeue_reassembly_queue;
 	unsigned int count_send_empty;
+	unsigned int count_post_send;
+	unsigned int count_mr_register;
 };
 
 enum smbd_message_type {
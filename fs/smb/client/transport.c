@@ -1018,7 +1018,7 @@ struct TCP_Server_Info *cifs_pick_channel(struct cifs_ses *ses)
 	uint index = 0;
 	unsigned int min_in_flight = UINT_MAX, max_in_flight = 0;
 	struct TCP_Server_Info *server = NULL;
-	int i;
+	int i, starved = 0;
 
 	if (!ses)
 		return NULL;
@@ -1032,6 +1032,18 @@ struct TCP_Server_Info *cifs_pick_channel(struct cifs_ses *ses)
 		if (CIFS_CHAN_NEEDS_RECONNECT(ses, i))
 			continue;
 
+		/*
+		 * A channel that ran out of credits would make the request
+		 * wait for the server to grant more while other channels
+		 * may be able to send right away, so leave it out unless
+		 * every channel is in the same state.
+		 */
+		if (!READ_ONCE(server->credits)) {
+			atomic_inc(&server->credit_skips);
+			starved++;
+			continue;
+		}
+
 		/*
 		 * strictly speaking, we should pick up req_lock to read
 		 * server->in_flight. But it shouldn't matter much here if we
@@ -1048,8 +1060,12 @@ struct TCP_Server_Info *cifs_pick_channel(struct cifs_ses *ses)
 			max_in_flight = server->in_flight;
 	}
 
-	/* if all channels are equally loaded, fall back to round-robin */
-	if (min_in_flight == max_in_flight) {
+	/*
+	 * if all channels are equally loaded, or all of them are out of
+	 * credits, fall back to round-robin
+	 */
+	if ((min_in_flight == max_in_flight && !starved) ||
+	    (min_in_flight == UINT_MAX && starved)) {
 		index = (uint)atomic_inc_return(&ses->chan_seq);
 		index %= ses->chan_count;
 	}
@@ -230,6 +230,7 @@ xfs_buf_alloc_backing_mem(
 		goto fallback;
 	}
 	bp->b_addr = folio_address(folio);
+	XFS_STATS_INC(bp->b_mount, xb_backing_folio);
 	trace_xfs_buf_backing_folio(bp, _RET_IP_);
 	return 0;
 
@@ -244,6 +245,7 @@ xfs_buf_alloc_backing_mem(
 		memalloc_retry_wait(gfp_mask);
 	}
 
+	XFS_STATS_INC(bp->b_mount, xb_backing_vmalloc);
 	trace_xfs_buf_backing_vmalloc(bp, _RET_IP_);
 	return 0;
 }
@@ -519,6 +521,7 @@ xfs_buf_find_insert(
 	if (bp && xfs_buf_try_hold(bp)) {
 		/* found an existing buffer */
 		rcu_read_unlock();
+		XFS_STATS_INC(btp->bt_mount, xb_insert_race);
 		error = xfs_buf_find_lock(bp, flags);
 		if (error)
 			xfs_buf_rele(bp);
@@ -1985,6 +1985,7 @@ xfs_inodegc_worker(
 		error = xfs_inodegc_inactivate(ip);
 		if (error && !gc->error)
 			gc->error = error;
+		XFS_STATS_INC(mp, xs_inodegc_inactivated);
 	}
 
 	memalloc_nofs_restore(nofs_flag);
@@ -2124,6 +2125,20 @@ xfs_inodegc_want_queue_work(
 	return false;
 }
 
+/*
+ * When the filesystem is almost full, the space held by inodes waiting on other
+ * CPUs' queues matters as much as our own, so kick every queue rather than
+ * waiting for each CPU to get around to it.
+ */
+static inline bool
+xfs_inodegc_want_push_all(
+	struct xfs_mount	*mp)
+{
+	return xfs_compare_freecounter(mp, XC_FREE_BLOCKS,
+				mp->m_low_space[XFS_LOWSP_1_PCNT],
+				XFS_FDBLOCKS_BATCH) < 0;
+}
+
 /*
  * Upper bound on the number of inodes in each AG that can be queued for
  * inactivation at any given time, to avoid monopolizing the workqueue.
@@ -2212,9 +2227,16 @@ xfs_inodegc_queue(
 	mod_delayed_work_on(current_cpu(), mp->m_inodegc_wq, &gc->work,
 			queue_delay);
 	put_cpu();
+	XFS_STATS_INC(mp, xs_inodegc_queued);
+
+	if (!queue_delay && xfs_inodegc_want_push_all(mp)) {
+		XFS_STATS_INC(mp, xs_inodegc_push_all);
+		xfs_inodegc_queue_all(mp);
+	}
 
 	if (xfs_inodegc_want_flush_work(ip, items, shrinker_hits)) {
 		trace_xfs_inodegc_throttle(mp, __return_address);
+		XFS_STATS_INC(mp, xs_inodegc_throttled);
 		flush_delayed_work(&gc->work);
 	}
 }
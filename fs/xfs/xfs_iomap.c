@@ -911,6 +911,9 @@ xfs_direct_write_iomap_begin(
 
 	seq = xfs_iomap_inode_sequence(ip, iomap_flags);
 	xfs_iunlock(ip, lockmode);
+	if ((flags & IOMAP_DIRECT) && imap.br_state == XFS_EXT_NORM &&
+	    lockmode == XFS_ILOCK_SHARED)
+		XFS_STATS_INC(mp, xs_dio_overwrite);
 	trace_xfs_iomap_found(ip, offset, length, XFS_DATA_FORK, &imap);
 	return xfs_bmbt_to_iomap(ip, iomap, &imap, flags, iomap_flags, seq);
 
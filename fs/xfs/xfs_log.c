@@ -249,6 +249,8 @@ xlog_grant_head_wait(
 	int			need_bytes) __releases(&head->lock)
 					    __acquires(&head->lock)
 {
+	ktime_t			start = ktime_get();
+
 	list_add_tail(&tic->t_queue, &head->waiters);
 
 	do {
@@ -273,6 +275,8 @@ xlog_grant_head_wait(
 	} while (xlog_grant_space_left(log, head) < need_bytes);
 
 	list_del_init(&tic->t_queue);
+	XFS_STATS_ADD(log->l_mp, xs_log_space_wait_us,
+			ktime_us_delta(ktime_get(), start));
 	return 0;
 shutdown:
 	list_del_init(&tic->t_queue);
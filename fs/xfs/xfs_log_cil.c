@@ -1290,7 +1290,7 @@ xlog_cil_cleanup_whiteouts(
  * contraints here.
  */
 static void
-xlog_cil_push_work(
+__xlog_cil_push_work(
 	struct work_struct	*work)
 {
 	unsigned int		nofs_flags = memalloc_nofs_save();
@@ -1535,6 +1535,34 @@ xlog_cil_push_work(
 	memalloc_nofs_restore(nofs_flags);
 }
 
+/*
+ * Up to four checkpoints can be formatted and written concurrently (see the
+ * xc_push_wq setup in xlog_cil_init()), with xc_committing keeping the commit
+ * records in sequence order. Account how long each push takes and how often
+ * pushes overlap so the depth of that pipeline is visible in the stats.
+ */
+static void
+xlog_cil_push_work(
+	struct work_struct	*work)
+{
+	struct xfs_cil_ctx	*ctx =
+		container_of(work, struct xfs_cil_ctx, push_work);
+	struct xfs_cil		*cil = ctx->cil;
+	struct xfs_mount	*mp = cil->xc_log->l_mp;
+	ktime_t			start = ktime_get();
+
+	XFS_STATS_INC(mp, xs_cil_pushes);
+	if (atomic_inc_return(&cil->xc_pushes_inflight) > 1)
+		XFS_STATS_INC(mp, xs_cil_push_overlap);
+
+	/* ctx may be freed once this returns, don't touch it again. */
+	__xlog_cil_push_work(work);
+
+	atomic_dec(&cil->xc_pushes_inflight);
+	XFS_STATS_ADD(mp, xs_cil_push_us,
+			ktime_us_delta(ktime_get(), start));
+}
+
 /*
  * We need to push CIL every so often so we don't cache more than we can fit in
  * the log. The limit really is that a checkpoint can't be more than half the
@@ -1438,6 +1438,13 @@ xfs_reflink_remap_extent(
 	return error;
 }
 
+/*
+ * Number of source extents to look up per ILOCK cycle when remapping.  The
+ * mappings live on the stack above a deep transaction call chain, so keep
+ * the batch as small as the xfs_bmapi_* callers usually do.
+ */
+#define XFS_REFLINK_REMAP_BATCH	4
+
 /* Remap a range of one file to the other. */
 int
 xfs_reflink_remap_blocks(
@@ -1448,7 +1455,7 @@ xfs_reflink_remap_blocks(
 	loff_t			remap_len,
 	loff_t			*remapped)
 {
-	struct xfs_bmbt_irec	imap;
+	struct xfs_bmbt_irec	imaps[XFS_REFLINK_REMAP_BATCH];
 	struct xfs_mount	*mp = src->i_mount;
 	xfs_fileoff_t		srcoff = XFS_B_TO_FSBT(mp, pos_in);
 	xfs_fileoff_t		destoff = XFS_B_TO_FSBT(mp, pos_out);
@@ -1456,6 +1463,7 @@ xfs_reflink_remap_blocks(
 	xfs_filblks_t		remapped_len = 0;
 	xfs_off_t		new_isize = pos_out + remap_len;
 	int			nimaps;
+	int			i;
 	int			error = 0;
 
 	len = min_t(xfs_filblks_t, XFS_B_TO_FSB(mp, remap_len),
@@ -1466,49 +1474,60 @@ xfs_reflink_remap_blocks(
 	while (len > 0) {
 		unsigned int	lock_mode;
 
-		/* Read extent from the source file */
-		nimaps = 1;
-		lock_mode = xfs_ilock_data_map_shared(src);
-		error = xfs_bmapi_read(src, srcoff, len, &imap, &nimaps, 0);
-		xfs_iunlock(src, lock_mode);
-		if (error)
-			break;
 		/*
-		 * The caller supposedly flushed all dirty pages in the source
-		 * file range, which means that writeback should have allocated
-		 * or deleted all delalloc reservations in that range.  If we
-		 * find one, that's a good sign that something is seriously
-		 * wrong here.
+		 * Read a batch of extents from the source file.  The caller
+		 * holds the IOLOCK and MMAPLOCK of both files, so the source
+		 * mappings cannot change while we remap them one by one and we
+		 * only need to cycle the ILOCK once per batch.
 		 */
-		ASSERT(nimaps == 1 && imap.br_startoff == srcoff);
-		if (imap.br_startblock == DELAYSTARTBLOCK) {
-			ASSERT(imap.br_startblock != DELAYSTARTBLOCK);
-			xfs_bmap_mark_sick(src, XFS_DATA_FORK);
-			error = -EFSCORRUPTED;
-			break;
-		}
-
-		trace_xfs_reflink_remap_extent_src(src, &imap);
-
-		/* Remap into the destination file at the given offset. */
-		imap.br_startoff = destoff;
-		error = xfs_reflink_remap_extent(dest, &imap, new_isize);
+		nimaps = XFS_REFLINK_REMAP_BATCH;
+		lock_mode = xfs_ilock_data_map_shared(src);
+		error = xfs_bmapi_read(src, srcoff, len, imaps, &nimaps, 0);
+		xfs_iunlock(src, lock_mode);
 		if (error)
 			break;
 
-		if (fatal_signal_pending(current)) {
-			error = -EINTR;
-			break;
+		for (i = 0; i < nimaps; i++) {
+			struct xfs_bmbt_irec	*imap = &imaps[i];
+
+			/*
+			 * The caller supposedly flushed all dirty pages in the
+			 * source file range, which means that writeback should
+			 * have allocated or deleted all delalloc reservations
+			 * in that range.  If we find one, that's a good sign
+			 * that something is seriously wrong here.
+			 */
+			ASSERT(imap->br_startoff == srcoff);
+			if (imap->br_startblock == DELAYSTARTBLOCK) {
+				ASSERT(imap->br_startblock != DELAYSTARTBLOCK);
+				xfs_bmap_mark_sick(src, XFS_DATA_FORK);
+				error = -EFSCORRUPTED;
+				goto out;
+			}
+
+			trace_xfs_reflink_remap_extent_src(src, imap);
+
+			/* Remap into the destination file at the given offset. */
+			imap->br_startoff = destoff;
+			error = xfs_reflink_remap_extent(dest, imap, new_isize);
+			if (error)
+				goto out;
+
+			if (fatal_signal_pending(current)) {
+				error = -EINTR;
+				goto out;
+			}
+
+			/* Advance drange/srange */
+			srcoff += imap->br_blockcount;
+			destoff += imap->br_blockcount;
+			len -= imap->br_blockcount;
+			remapped_len += imap->br_blockcount;
+			cond_resched();
 		}
-
-		/* Advance drange/srange */
-		srcoff += imap.br_blockcount;
-		destoff += imap.br_blockcount;
-		len -= imap.br_blockcount;
-		remapped_len += imap.br_blockcount;
-		cond_resched();
 	}
 
+out:
 	if (error)
 		trace_xfs_reflink_remap_blocks_error(dest, error, _RET_IP_);
 	*remapped = min_t(loff_t, remap_len,
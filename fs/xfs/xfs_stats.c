@@ -24,6 +24,8 @@ int xfs_stats_format(struct xfsstats __percpu *stats, char *buf)
 	uint64_t	xs_write_bytes = 0;
 	uint64_t	xs_read_bytes = 0;
 	uint64_t	defer_relog = 0;
+	uint64_t	cil_push_us = 0;
+	uint64_t	log_space_wait_us = 0;
 
 	static const struct xstats_entry {
 		char	*desc;
@@ -55,7 +57,9 @@ int xfs_stats_format(struct xfsstats __percpu *stats, char *buf)
 		{ "rcbagbt",		xfsstats_offset(xs_rtrmap_2)	},
 		{ "rtrmapbt",		xfsstats_offset(xs_rtrmap_mem_2)},
 		{ "rtrmapbt_mem",	xfsstats_offset(xs_rtrefcbt_2)	},
-		{ "rtrefcntbt",		xfsstats_offset(xs_qm_dqreclaims)},
+		{ "rtrefcntbt",		xfsstats_offset(xs_cil_pushes)	},
+		{ "cil",		xfsstats_offset(xs_inodegc_queued)},
+		{ "inodegc",		xfsstats_offset(xs_qm_dqreclaims)},
 		/* we print both series of quota information together */
 		{ "qm",			xfsstats_offset(xs_xstrat_bytes)},
 	};
@@ -77,12 +81,19 @@ int xfs_stats_format(struct xfsstats __percpu *stats, char *buf)
 		xs_write_bytes += per_cpu_ptr(stats, i)->s.xs_write_bytes;
 		xs_read_bytes += per_cpu_ptr(stats, i)->s.xs_read_bytes;
 		defer_relog += per_cpu_ptr(stats, i)->s.defer_relog;
+		cil_push_us += per_cpu_ptr(stats, i)->s.xs_cil_push_us;
+		log_space_wait_us +=
+			per_cpu_ptr(stats, i)->s.xs_log_space_wait_us;
 	}
 
 	len += scnprintf(buf + len, PATH_MAX-len, "xpc %llu %llu %llu\n",
 			xs_xstrat_bytes, xs_write_bytes, xs_read_bytes);
 	len += scnprintf(buf + len, PATH_MAX-len, "defer_relog %llu\n",
 			defer_relog);
+	len += scnprintf(buf + len, PATH_MAX-len, "cil_push_us %llu\n",
+			cil_push_us);
+	len += scnprintf(buf + len, PATH_MAX-len, "log_space_wait_us %llu\n",
+			log_space_wait_us);
 	len += scnprintf(buf + len, PATH_MAX-len, "debug %u\n",
 #if defined(DEBUG)
 		1);
@@ -93,6 +93,7 @@ struct __xfsstats {
 	uint32_t		xs_xstrat_split;
 	uint32_t		xs_write_calls;
 	uint32_t		xs_read_calls;
+	uint32_t		xs_dio_overwrite;
 	uint32_t		xs_attr_get;
 	uint32_t		xs_attr_set;
 	uint32_t		xs_attr_remove;
@@ -117,6 +118,9 @@ struct __xfsstats {
 	uint32_t		xb_page_retries;
 	uint32_t		xb_page_found;
 	uint32_t		xb_get_read;
+	uint32_t		xb_backing_folio;
+	uint32_t		xb_backing_vmalloc;
+	uint32_t		xb_insert_race;
 /* Version 2 btree counters */
 	uint32_t		xs_abtb_2[__XBTS_MAX];
 	uint32_t		xs_abtc_2[__XBTS_MAX];
@@ -130,6 +134,12 @@ struct __xfsstats {
 	uint32_t		xs_rtrmap_2[__XBTS_MAX];
 	uint32_t		xs_rtrmap_mem_2[__XBTS_MAX];
 	uint32_t		xs_rtrefcbt_2[__XBTS_MAX];
+	uint32_t		xs_cil_pushes;
+	uint32_t		xs_cil_push_overlap;
+	uint32_t		xs_inodegc_queued;
+	uint32_t		xs_inodegc_inactivated;
+	uint32_t		xs_inodegc_throttled;
+	uint32_t		xs_inodegc_push_all;
 	uint32_t		xs_qm_dqreclaims;
 	uint32_t		xs_qm_dqreclaim_misses;
 	uint32_t		xs_qm_dquot_dups;
@@ -143,6 +153,8 @@ struct __xfsstats {
 	uint64_t		xs_write_bytes;
 	uint64_t		xs_read_bytes;
 	uint64_t		defer_relog;
+	uint64_t		xs_cil_push_us;
+	uint64_t		xs_log_space_wait_us;
 };
 
 #define	xfsstats_offset(f)	(offsetof(struct __xfsstats, f)/sizeof(uint32_t))
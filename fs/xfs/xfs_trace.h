@@ -62,6 +62,7 @@ struct xfs_buf_log_item;
 struct xfs_da_args;
 struct xfs_da_node_entry;
 struct xfs_dquot;
+struct xfs_ail;
 struct xfs_log_item;
 struct xlog;
 struct xlog_ticket;
@@ -1550,6 +1551,32 @@ TRACE_EVENT(xfs_log_force,
 		  __entry->lsn, (void *)__entry->caller_ip)
 )
 
+TRACE_EVENT(xfsaild_push_done,
+	TP_PROTO(struct xfs_ail *ailp, int count, int stuck, int flushing,
+		 long tout),
+	TP_ARGS(ailp, count, stuck, flushing, tout),
+	TP_STRUCT__entry(
+		__field(dev_t, dev)
+		__field(xfs_lsn_t, target)
+		__field(int, count)
+		__field(int, stuck)
+		__field(int, flushing)
+		__field(long, tout)
+	),
+	TP_fast_assign(
+		__entry->dev = ailp->ail_log->l_mp->m_super->s_dev;
+		__entry->target = ailp->ail_target;
+		__entry->count = count;
+		__entry->stuck = stuck;
+		__entry->flushing = flushing;
+		__entry->tout = tout;
+	),
+	TP_printk("dev %d:%d target 0x%llx count %d stuck %d flushing %d tout %ld",
+		  MAJOR(__entry->dev), MINOR(__entry->dev),
+		  __entry->target, __entry->count, __entry->stuck,
+		  __entry->flushing, __entry->tout)
+)
+
 #define DEFINE_LOG_ITEM_EVENT(name) \
 DEFINE_EVENT(xfs_log_item_class, name, \
 	TP_PROTO(struct xfs_log_item *lip), \
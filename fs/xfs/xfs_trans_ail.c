@@ -624,6 +624,7 @@ xfsaild_push(
 		tout = 0;
 	}
 
+	trace_xfsaild_push_done(ailp, count, stuck, flushing, tout);
 	return tout;
 }
 
@@ -505,6 +505,7 @@ xfs_zone_gc_select_victim(
 		return false;
 
 	trace_xfs_zone_gc_select_victim(victim_rtg, bucket);
+	WRITE_ONCE(zi->zi_gc_victims, zi->zi_gc_victims + 1);
 	xfs_zone_gc_iter_init(iter, victim_rtg);
 	return true;
 }
@@ -853,6 +854,10 @@ xfs_zone_gc_finish_chunk(
 		chunk->new_daddr = chunk->bio.bi_iter.bi_sector;
 	error = xfs_zoned_end_io(ip, chunk->offset, chunk->len,
 			chunk->new_daddr, chunk->oz, chunk->old_startblock);
+	if (!error)
+		WRITE_ONCE(mp->m_zone_info->zi_gc_moved_blocks,
+			mp->m_zone_info->zi_gc_moved_blocks +
+			XFS_B_TO_FSBT(mp, chunk->len));
 free:
 	if (error)
 		xfs_force_shutdown(mp, SHUTDOWN_META_IO_ERROR);
@@ -874,6 +879,7 @@ xfs_zone_gc_finish_reset(
 
 	xfs_group_set_mark(&rtg->rtg_group, XFS_RTG_FREE);
 	atomic_inc(&zi->zi_nr_free_zones);
+	WRITE_ONCE(zi->zi_gc_resets, zi->zi_gc_resets + 1);
 
 	xfs_zoned_add_available(mp, rtg_blocks(rtg));
 
@@ -89,6 +89,12 @@ xfs_zoned_show_stats(
 		!list_empty_careful(&zi->zi_reclaim_reservations));
 	seq_printf(m, "\tRT GC required: %d\n",
 		xfs_zoned_need_gc(mp));
+	seq_printf(m, "\tRT GC victim zones: %llu\n",
+		READ_ONCE(zi->zi_gc_victims));
+	seq_printf(m, "\tRT GC moved blocks: %llu\n",
+		READ_ONCE(zi->zi_gc_moved_blocks));
+	seq_printf(m, "\tRT GC zone resets: %llu\n",
+		READ_ONCE(zi->zi_gc_resets));
 
 	seq_printf(m, "\tfree zones: %d\n", atomic_read(&zi->zi_nr_free_zones));
 	seq_puts(m, "\topen zones:\n");
@@ -90,6 +90,14 @@ struct xfs_zone_info {
 	struct task_struct      *zi_gc_thread;
 	struct xfs_open_zone	*zi_open_gc_zone;
 
+	/*
+	 * GC cost counters.  Only updated by the GC thread, read racily for
+	 * the zone statistics.
+	 */
+	uint64_t		zi_gc_victims;
+	uint64_t		zi_gc_moved_blocks;
+	uint64_t		zi_gc_resets;
+
 	/*
 	 * List of zones that need a reset:
 	 */
@@ -215,6 +215,9 @@ struct vgic_its {
 	 * LPIs that are mapped and enabled.
 	 */
 	struct xarray		translation_cache;
+
+	/* LPI injection counts, folded into kvm->stat in batches */
+	struct vgic_its_inject_stats __percpu *inject_stats;
 };
 
 struct vgic_state_iter;
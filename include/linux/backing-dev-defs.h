@@ -160,6 +160,12 @@ struct bdi_writeback {
 #endif
 };
 
+/*
+ * Dirty throttling pauses are counted in power of two buckets of
+ * milliseconds: [0, 1), [1, 2), [2, 4), ... and the last one is open ended.
+ */
+#define BDP_PAUSE_BUCKETS	10
+
 struct backing_dev_info {
 	u64 id;
 	struct rb_node rb_node; /* keyed by ->id */
@@ -171,6 +177,8 @@ struct backing_dev_info {
 	unsigned int capabilities; /* Device capabilities */
 	unsigned int min_ratio;
 	unsigned int max_ratio, max_prop_frac;
+	/* Writeback completion latency target in ms, 0 for none */
+	unsigned int writeback_latency_ms;
 
 	/*
 	 * Sum of avg_write_bw of wbs with dirty inodes.  > 0 if there are
@@ -182,6 +190,8 @@ struct backing_dev_info {
 	 * blk-wbt.
 	 */
 	unsigned long last_bdp_sleep;
+	/* Lengths of the balance_dirty_pages() pauses on this bdi */
+	atomic_long_t bdp_pause_hist[BDP_PAUSE_BUCKETS];
 
 	struct bdi_writeback wb;  /* the root writeback info for this bdi */
 	struct list_head wb_list; /* list of all wbs */
@@ -544,6 +544,8 @@ enum damon_ops_id {
  * @update:			Update operations-related data structures.
  * @prepare_access_checks:	Prepare next access check of target regions.
  * @check_accesses:		Check the accesses to target regions.
+ * @prepare_access_checks_shard: Prepare next access check of a run of regions.
+ * @check_accesses_shard:	Check the accesses to a run of regions.
  * @get_scheme_score:		Get the score of a region for a scheme.
  * @apply_scheme:		Apply a DAMON-based operation scheme.
  * @target_valid:		Determine if the target is valid.
@@ -570,6 +572,11 @@ enum damon_ops_id {
  * last preparation and update the number of observed accesses of each region.
  * It should also return max number of observed accesses that made as a result
  * of its update.  The value will be used for regions adjustment threshold.
+ * @prepare_access_checks_shard and @check_accesses_shard do the same for
+ * only @nr_regions regions of a target starting from a given region.  If both
+ * are set and &damon_attrs.nr_shards is larger than one, the regions are split
+ * in that many shards that are sampled in parallel, so these may be called
+ * concurrently for different shards of the same context.
  * @get_scheme_score should return the priority score of a region for a scheme
  * as an integer in [0, &DAMOS_MAX_SCORE].
  * @apply_scheme is called from @kdamond when a region for user provided
@@ -587,6 +594,12 @@ struct damon_operations {
 	void (*update)(struct damon_ctx *context);
 	void (*prepare_access_checks)(struct damon_ctx *context);
 	unsigned int (*check_accesses)(struct damon_ctx *context);
+	void (*prepare_access_checks_shard)(struct damon_ctx *context,
+			struct damon_target *t, struct damon_region *r,
+			unsigned int nr_regions);
+	unsigned int (*check_accesses_shard)(struct damon_ctx *context,
+			struct damon_target *t, struct damon_region *r,
+			unsigned int nr_regions);
 	int (*get_scheme_score)(struct damon_ctx *context,
 			struct damon_target *t, struct damon_region *r,
 			struct damos *scheme);
@@ -671,6 +684,11 @@ struct damon_intervals_goal {
 	unsigned long max_sample_us;
 };
 
+struct damon_shard;
+
+/* Max number of shards for &damon_attrs.nr_shards */
+#define DAMON_MAX_SHARDS	64
+
 /**
  * struct damon_attrs - Monitoring attributes for accuracy/overhead control.
  *
@@ -682,6 +700,8 @@ struct damon_intervals_goal {
  *				regions.
  * @max_nr_regions:		The maximum number of adaptive monitoring
  *				regions.
+ * @nr_shards:			The number of shards the access sampling is
+ *				split into.
  *
  * For each @sample_interval, DAMON checks whether each region is accessed or
  * not during the last @sample_interval.  If such access is found, DAMON
@@ -700,6 +720,7 @@ struct damon_attrs {
 	struct damon_intervals_goal intervals_goal;
 	unsigned long min_nr_regions;
 	unsigned long max_nr_regions;
+	unsigned int nr_shards;
 /* private: internal use only */
 	/*
 	 * @aggr_interval to @sample_interval ratio.
@@ -768,6 +789,9 @@ struct damon_ctx {
 	struct completion kdamond_started;
 	/* for scheme quotas prioritization */
 	unsigned long *regions_score_histogram;
+	/* for sharded access sampling */
+	struct damon_shard *shards;
+	unsigned int nr_shards_alloc;
 
 	struct damon_call_control *call_control;
 	struct mutex call_control_lock;
@@ -196,12 +196,22 @@ extern atomic_t fscache_n_no_write_space;
 extern atomic_t fscache_n_no_create_space;
 extern atomic_t fscache_n_culled;
 extern atomic_t fscache_n_dio_misfit;
+extern atomic_t fscache_n_ondemand_hit;
+extern atomic_t fscache_n_ondemand_miss;
+extern atomic_t fscache_n_ondemand_queued;
+extern atomic_t fscache_n_ondemand_sent;
+extern atomic_t fscache_n_ondemand_cancelled;
 #define fscache_count_read() atomic_inc(&fscache_n_read)
 #define fscache_count_write() atomic_inc(&fscache_n_write)
 #define fscache_count_no_write_space() atomic_inc(&fscache_n_no_write_space)
 #define fscache_count_no_create_space() atomic_inc(&fscache_n_no_create_space)
 #define fscache_count_culled() atomic_inc(&fscache_n_culled)
 #define fscache_count_dio_misfit() atomic_inc(&fscache_n_dio_misfit)
+#define fscache_count_ondemand_hit() atomic_inc(&fscache_n_ondemand_hit)
+#define fscache_count_ondemand_miss() atomic_inc(&fscache_n_ondemand_miss)
+#define fscache_count_ondemand_queued() atomic_inc(&fscache_n_ondemand_queued)
+#define fscache_count_ondemand_sent() atomic_inc(&fscache_n_ondemand_sent)
+#define fscache_count_ondemand_cancelled() atomic_inc(&fscache_n_ondemand_cancelled)
 #else
 #define fscache_count_read() do {} while(0)
 #define fscache_count_write() do {} while(0)
@@ -209,6 +219,11 @@ extern atomic_t fscache_n_dio_misfit;
 #define fscache_count_no_create_space() do {} while(0)
 #define fscache_count_culled() do {} while(0)
 #define fscache_count_dio_misfit() do {} while(0)
+#define fscache_count_ondemand_hit() do {} while(0)
+#define fscache_count_ondemand_miss() do {} while(0)
+#define fscache_count_ondemand_queued() do {} while(0)
+#define fscache_count_ondemand_sent() do {} while(0)
+#define fscache_count_ondemand_cancelled() do {} while(0)
 #endif
 
 #endif /* _LINUX_FSCACHE_CACHE_H */
@@ -234,6 +234,11 @@ unsigned long alloc_pages_bulk_noprof(gfp_t gfp, int preferred_nid,
 				struct page **page_array);
 #define __alloc_pages_bulk(...)			alloc_hooks(alloc_pages_bulk_noprof(__VA_ARGS__))
 
+unsigned long alloc_folios_bulk_noprof(gfp_t gfp, int preferred_nid,
+				nodemask_t *nodemask, unsigned int order,
+				int nr_folios, struct folio **folio_array);
+#define __alloc_folios_bulk(...)		alloc_hooks(alloc_folios_bulk_noprof(__VA_ARGS__))
+
 unsigned long alloc_pages_bulk_mempolicy_noprof(gfp_t gfp,
 				unsigned long nr_pages,
 				struct page **page_array);
@@ -257,6 +262,11 @@ alloc_pages_bulk_node_noprof(gfp_t gfp, int nid, unsigned long nr_pages,
 #define alloc_pages_bulk_node(...)				\
 	alloc_hooks(alloc_pages_bulk_node_noprof(__VA_ARGS__))
 
+/* Bulk allocate folios of a single order */
+#define alloc_folios_bulk(_gfp, _order, _nr_folios, _folio_array)	\
+	__alloc_folios_bulk(_gfp, numa_mem_id(), NULL, _order,		\
+			    _nr_folios, _folio_array)
+
 static inline void warn_if_node_offline(int this_node, gfp_t gfp_mask)
 {
 	gfp_t warn_gfp = gfp_mask & (__GFP_THISNODE|__GFP_NOWARN);
@@ -78,6 +78,10 @@ static inline size_t inet_diag_msg_attrs_size(void)
 #endif
 		+ nla_total_size(sizeof(struct inet_diag_sockopt))
 						     /* INET_DIAG_SOCKOPT */
+#ifdef CONFIG_NET_SOCK_MSG
+		+ nla_total_size(sizeof(struct inet_diag_psock))
+						     /* INET_DIAG_PSOCK */
+#endif
 		;
 }
 int inet_diag_msg_attrs_fill(struct sock *sk, struct sk_buff *skb,
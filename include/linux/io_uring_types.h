@@ -383,6 +383,8 @@ struct io_ring_ctx {
 
 	const struct cred	*sq_creds;	/* cred used for __io_sq_thread() */
 	struct io_sq_data	*sq_data;	/* if using sq thread polling */
+	u64			sq_ring_time;	/* ns of sq thread time spent here */
+	s64			sq_credit;	/* ns, for sharing the sq thread */
 
 	struct wait_queue_head	sqo_sq_wait;
 	struct list_head	sqd_list;
@@ -431,6 +433,11 @@ struct io_ring_ctx {
 	bool			napi_prefer_busy_poll;
 	u8			napi_track_mode;
 
+	/* busy poll passes, and for adaptive tracking the useful ones */
+	unsigned int		napi_round;
+	unsigned long		napi_polls;
+	unsigned long		napi_useful_polls;
+
 	DECLARE_HASHTABLE(napi_ht, 4);
 #endif
 
@@ -444,6 +451,18 @@ struct io_ring_ctx {
 	 */
 	struct mutex			mmap_lock;
 
+	/*
+	 * zerocopy notifications folded into another one's CQE, from task_work
+	 * that can run in several tasks at once
+	 */
+	atomic_long_t			notif_merged;
+	/* ns the last IORING_REGISTER_BUFFERS took */
+	u64				buf_reg_time;
+	/* MSG_RING posts delivered through task_work, and their latency */
+	unsigned long			msg_remote_nr;
+	u64				msg_remote_time;
+	u64				msg_remote_max;
+
 	struct io_mapped_region		sq_region;
 	struct io_mapped_region		ring_region;
 	/* used for optimised request parameter and wait argument passing  */
@@ -701,6 +720,8 @@ struct io_kiocb {
 		struct hlist_node	hash_node;
 		/* For IOPOLL setup queues, with hybrid polling */
 		u64                     iopoll_start;
+		/* For MSG_RING posts, when they were queued to the target */
+		u64			msg_queued;
 	};
 	/* internal polling, see IORING_FEAT_FAST_POLL */
 	struct async_poll		*apoll;
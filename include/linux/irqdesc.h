@@ -49,6 +49,9 @@ struct irqstat {
  * @affinity_hint:	hint to user space for preferred irq affinity
  * @affinity_notify:	context for notification of affinity changes
  * @pending_mask:	pending rebalanced interrupts
+ * @balance_count:	interrupt count at the last in-kernel balancer scan
+ * @balance_rate:	interrupts between the last two balancer scans
+ * @balance_owned:	the in-kernel balancer has set the affinity
  * @threads_oneshot:	bitfield to handle shared oneshot threads
  * @threads_active:	number of irqaction threads currently running
  * @wait_for_threads:	wait queue for sync_irq to wait for threaded handlers
@@ -89,6 +92,11 @@ struct irq_desc {
 #ifdef CONFIG_GENERIC_PENDING_IRQ
 	cpumask_var_t		pending_mask;
 #endif
+#ifdef CONFIG_IRQ_BALANCE
+	unsigned int		balance_count;
+	unsigned int		balance_rate;
+	bool			balance_owned;
+#endif
 #endif
 	unsigned long		threads_oneshot;
 	atomic_t		threads_active;
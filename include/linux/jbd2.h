@@ -713,12 +713,28 @@ struct transaction_run_stats_s {
 	__u32			rs_blocks_logged;
 };
 
+/*
+ * Commit times are counted in power-of-4 millisecond buckets: <1ms, <4ms,
+ * <16ms, ... with the last bucket holding everything above.
+ */
+#define JBD2_COMMIT_HIST_NR	7
+
 struct transaction_stats_s {
 	unsigned long		ts_tid;
 	unsigned long		ts_requested;
+	unsigned long		ts_commit_hist[JBD2_COMMIT_HIST_NR];
 	struct transaction_run_stats_s run;
 };
 
+static inline unsigned int jbd2_commit_hist_bucket(u64 commit_time_ns)
+{
+	u64 ms = div_u64(commit_time_ns, NSEC_PER_MSEC);
+
+	if (!ms)
+		return 0;
+	return min_t(unsigned int, ilog2(ms) / 2 + 1, JBD2_COMMIT_HIST_NR - 1);
+}
+
 static inline unsigned long
 jbd2_time_diff(unsigned long start, unsigned long end)
 {
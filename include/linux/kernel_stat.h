@@ -6,6 +6,8 @@
 #include <linux/threads.h>
 #include <linux/percpu.h>
 #include <linux/interrupt.h>
+#include <linux/jump_label.h>
+#include <linux/log2_hist.h>
 #include <linux/sched.h>
 #include <linux/vtime.h>
 #include <asm/irq.h>
@@ -42,6 +44,15 @@ struct kernel_stat {
 	unsigned int softirqs[NR_SOFTIRQS];
 };
 
+/* Softirq handler run time histogram: <1us, <2us, ... <16ms, more */
+#define SOFTIRQ_TIME_BUCKETS	16
+
+/* Only allocated when booted with "softirq_times" */
+struct softirq_time_stat {
+	u64 time[NR_SOFTIRQS];
+	unsigned int hist[NR_SOFTIRQS][SOFTIRQ_TIME_BUCKETS];
+};
+
 DECLARE_PER_CPU(struct kernel_stat, kstat);
 DECLARE_PER_CPU(struct kernel_cpustat, kernel_cpustat);
 
@@ -67,6 +78,38 @@ static inline unsigned int kstat_softirqs_cpu(unsigned int irq, int cpu)
        return kstat_cpu(cpu).softirqs[irq];
 }
 
+#ifdef CONFIG_IRQ_TIME_ACCOUNTING
+DECLARE_STATIC_KEY_FALSE(softirq_time_key);
+extern struct softirq_time_stat __percpu *softirq_time_stats;
+
+static inline bool softirq_time_enabled(void)
+{
+	return static_branch_unlikely(&softirq_time_key);
+}
+
+static inline void kstat_add_softirq_time_this_cpu(unsigned int irq, u64 delta)
+{
+	unsigned int b = log2_hist_bucket_us(delta, SOFTIRQ_TIME_BUCKETS);
+
+	__this_cpu_add(softirq_time_stats->time[irq], delta);
+	__this_cpu_inc(softirq_time_stats->hist[irq][b]);
+}
+
+static inline u64 kstat_softirq_time_cpu(unsigned int irq, int cpu)
+{
+	return READ_ONCE(per_cpu_ptr(softirq_time_stats, cpu)->time[irq]);
+}
+
+static inline unsigned int kstat_softirq_hist_cpu(unsigned int irq,
+						  unsigned int b, int cpu)
+{
+	return READ_ONCE(per_cpu_ptr(softirq_time_stats, cpu)->hist[irq][b]);
+}
+#else
+static inline bool softirq_time_enabled(void) { return false; }
+static inline void kstat_add_softirq_time_this_cpu(unsigned int irq, u64 delta) { }
+#endif
+
 static inline unsigned int kstat_cpu_softirqs_sum(int cpu)
 {
 	int i;
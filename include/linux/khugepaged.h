@@ -15,6 +15,7 @@ extern void khugepaged_enter_vma(struct vm_area_struct *vma,
 				 unsigned long vm_flags);
 extern void khugepaged_min_free_kbytes_update(void);
 extern bool current_is_khugepaged(void);
+extern void khugepaged_set_priority(struct mm_struct *mm, unsigned int prio);
 #ifdef CONFIG_SHMEM
 extern int collapse_pte_mapped_thp(struct mm_struct *mm, unsigned long addr,
 				   bool install_pmd);
@@ -62,6 +63,11 @@ static inline bool current_is_khugepaged(void)
 {
 	return false;
 }
+
+static inline void khugepaged_set_priority(struct mm_struct *mm,
+					   unsigned int prio)
+{
+}
 #endif /* CONFIG_TRANSPARENT_HUGEPAGE */
 
 #endif /* _LINUX_KHUGEPAGED_H */
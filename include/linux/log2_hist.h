@@ -0,0 +1,40 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+#ifndef _LINUX_LOG2_HIST_H
+#define _LINUX_LOG2_HIST_H
+
+#include <linux/atomic.h>
+#include <linux/log2.h>
+#include <linux/math64.h>
+#include <linux/minmax.h>
+#include <linux/time64.h>
+
+struct seq_file;
+
+/*
+ * Helpers for log2 histograms of latencies. Bucket 0 counts values below one
+ * unit, bucket b values in [2^(b-1), 2^b) units, and the last bucket all
+ * values from there on.
+ */
+static inline unsigned int log2_hist_bucket(u64 val, unsigned int nr_buckets)
+{
+	return val ? min_t(unsigned int, ilog2(val) + 1, nr_buckets - 1) : 0;
+}
+
+/* The bucket of a duration in ns, in a histogram of microseconds */
+static inline unsigned int log2_hist_bucket_us(u64 ns, unsigned int nr_buckets)
+{
+	return log2_hist_bucket(div_u64(ns, NSEC_PER_USEC), nr_buckets);
+}
+
+/* Raise @max to @val if it is larger, for a maximum shared between CPUs */
+static inline void log2_hist_update_max(atomic64_t *max, s64 val)
+{
+	s64 old = atomic64_read(max);
+
+	while (val > old && !atomic64_try_cmpxchg(max, &old, val))
+		;
+}
+
+void log2_hist_seq_us_header(struct seq_file *m, unsigned int nr_buckets);
+
+#endif /* _LINUX_LOG2_HIST_H */
@@ -15,6 +15,9 @@
 #define DMA_MAP_TO_DEVICE       1
 #define DMA_MAP_FROM_DEVICE     2
 
+#define DMA_MAP_SINGLE_MODE     0 /* dma_map_single() of one buffer */
+#define DMA_MAP_SG_MODE         1 /* dma_map_sgtable() of one page per entry */
+
 struct map_benchmark {
 	__u64 avg_map_100ns; /* average map latency in 100ns */
 	__u64 map_stddev; /* standard deviation of map latency */
@@ -27,5 +30,10 @@ struct map_benchmark {
 	__u32 dma_dir; /* DMA data direction */
 	__u32 dma_trans_ns; /* time for DMA transmission in ns */
 	__u32 granule;  /* how many PAGE_SIZE will do map/unmap once a time */
+	__u32 map_mode; /* DMA_MAP_SINGLE_MODE or DMA_MAP_SG_MODE */
+	__u64 max_map_100ns; /* worst map latency in 100ns */
+	__u64 max_unmap_100ns; /* as above */
+	__u64 p99_map_100ns; /* 99th percentile of map latency, rounded up to a power of 2 */
+	__u64 p99_unmap_100ns; /* as above */
 };
 #endif /* _KERNEL_DMA_BENCHMARK_H */
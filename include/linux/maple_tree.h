@@ -343,6 +343,16 @@ int mtree_store_range(struct maple_tree *mt, unsigned long first,
 		      unsigned long last, void *entry, gfp_t gfp);
 int mtree_store(struct maple_tree *mt, unsigned long index,
 		void *entry, gfp_t gfp);
+
+/* A range for mtree_store_ranges() */
+struct maple_range {
+	unsigned long index;
+	unsigned long last;
+	void *entry;
+};
+
+int mtree_store_ranges(struct maple_tree *mt, const struct maple_range *ranges,
+		       unsigned int nr, gfp_t gfp);
 void *mtree_erase(struct maple_tree *mt, unsigned long index);
 
 int mtree_dup(struct maple_tree *mt, struct maple_tree *new, gfp_t gfp);
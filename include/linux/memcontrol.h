@@ -55,6 +55,19 @@ enum memcg_memory_event {
 	MEMCG_NR_MEMORY_EVENTS,
 };
 
+/*
+ * Readahead folio sizing policy, selected through memory.readahead.policy:
+ * ADAPTIVE keeps the default ramp-up, STREAMING starts with the largest folio
+ * order and a full window, RANDOM sticks to the minimum folio order and does
+ * not speculate past non-sequential misses.
+ */
+enum mem_cgroup_ra_policy {
+	MEMCG_RA_ADAPTIVE,
+	MEMCG_RA_STREAMING,
+	MEMCG_RA_RANDOM,
+	MEMCG_NR_RA_POLICIES,
+};
+
 struct mem_cgroup_reclaim_cookie {
 	pg_data_t *pgdat;
 	int generation;
@@ -222,6 +235,9 @@ struct mem_cgroup {
 
 	int swappiness;
 
+	/* enum mem_cgroup_ra_policy, inherited from the parent on creation */
+	int ra_policy;
+
 	/* memory.events and memory.events.local */
 	struct cgroup_file events_file;
 	struct cgroup_file events_local_file;
@@ -903,6 +919,8 @@ struct mem_cgroup *mem_cgroup_get_oom_group(struct task_struct *victim,
 					    struct mem_cgroup *oom_domain);
 void mem_cgroup_print_oom_group(struct mem_cgroup *memcg);
 
+enum mem_cgroup_ra_policy mem_cgroup_ra_policy(void);
+
 void __mod_memcg_state(struct mem_cgroup *memcg, enum memcg_stat_item idx,
 		       int val);
 
@@ -939,6 +957,8 @@ unsigned long lruvec_page_state_local(struct lruvec *lruvec,
 
 void mem_cgroup_flush_stats(struct mem_cgroup *memcg);
 void mem_cgroup_flush_stats_ratelimited(struct mem_cgroup *memcg);
+void mem_cgroup_flush_stats_max_age(struct mem_cgroup *memcg,
+				    unsigned long max_age);
 
 void __mod_lruvec_kmem_state(void *p, enum node_stat_item idx, int val);
 
@@ -1374,6 +1394,11 @@ static inline void mem_cgroup_print_oom_group(struct mem_cgroup *memcg)
 {
 }
 
+static inline enum mem_cgroup_ra_policy mem_cgroup_ra_policy(void)
+{
+	return MEMCG_RA_ADAPTIVE;
+}
+
 static inline void __mod_memcg_state(struct mem_cgroup *memcg,
 				     enum memcg_stat_item idx,
 				     int nr)
@@ -1416,6 +1441,11 @@ static inline void mem_cgroup_flush_stats_ratelimited(struct mem_cgroup *memcg)
 {
 }
 
+static inline void mem_cgroup_flush_stats_max_age(struct mem_cgroup *memcg,
+						  unsigned long max_age)
+{
+}
+
 static inline void __mod_lruvec_kmem_state(void *p, enum node_stat_item idx,
 					   int val)
 {
@@ -152,4 +152,40 @@ static inline void mt_put_memory_types(struct list_head *memory_types)
 {
 }
 #endif	/* CONFIG_NUMA */
+
+/*
+ * A source of hot page candidates other than NUMA hinting faults, such as
+ * CPU access sampling or device hotness monitors. Reported pages on lower
+ * tiers are promoted in batches.
+ */
+struct memtier_hotness_source {
+	const char *name;
+	struct list_head list;
+	atomic_long_t nr_reported;
+	atomic_long_t nr_dropped;
+};
+
+#ifdef CONFIG_NUMA_BALANCING
+int memtier_register_hotness_source(struct memtier_hotness_source *src);
+void memtier_unregister_hotness_source(struct memtier_hotness_source *src);
+unsigned int memtier_report_hot_pfns(struct memtier_hotness_source *src,
+				     const unsigned long *pfns,
+				     unsigned int nr, int nid);
+#else
+static inline int memtier_register_hotness_source(struct memtier_hotness_source *src)
+{
+	return -EOPNOTSUPP;
+}
+
+static inline void memtier_unregister_hotness_source(struct memtier_hotness_source *src)
+{
+}
+
+static inline unsigned int memtier_report_hot_pfns(struct memtier_hotness_source *src,
+						   const unsigned long *pfns,
+						   unsigned int nr, int nid)
+{
+	return 0;
+}
+#endif /* CONFIG_NUMA_BALANCING */
 #endif  /* _LINUX_MEMORY_TIERS_H */
@@ -895,6 +895,7 @@ struct mm_cid {
 
 struct kioctx_table;
 struct iommu_mm_data;
+struct smaps_rollup_cache;
 struct mm_struct {
 	struct {
 		/*
@@ -932,6 +933,12 @@ struct mm_struct {
 		 * cache-line, which needs to be touched by switch_mm().
 		 */
 		atomic_t membarrier_state;
+		/**
+		 * @membarrier_seq: Rounds of private expedited membarrier
+		 * IPIs, odd while one is in progress. Lets concurrent
+		 * callers share a round.
+		 */
+		unsigned long membarrier_seq;
 #endif
 
 		/**
@@ -1148,6 +1155,17 @@ struct mm_struct {
 		 */
 		atomic_long_t ksm_zero_pages;
 #endif /* CONFIG_KSM */
+#ifdef CONFIG_TRANSPARENT_HUGEPAGE
+		/* khugepaged scan priority, see PR_SET_THP_COLLAPSE_PRIORITY */
+		unsigned int thp_collapse_priority;
+		/* Outcome of PMD collapse attempts on this mm */
+		atomic_long_t thp_collapse_succeeded;
+		atomic_long_t thp_collapse_failed;
+#endif
+#ifdef CONFIG_PROC_PAGE_MONITOR
+		/* last smaps_rollup result, see vm.smaps_rollup_max_age_ms */
+		struct smaps_rollup_cache *smaps_rollup_cache;
+#endif
 #ifdef CONFIG_LRU_GEN_WALKS_MMU
 		struct {
 			/* this mm_struct is on lru_gen_mm_list */
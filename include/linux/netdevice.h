@@ -368,6 +368,7 @@ struct napi_config {
 	u64 gro_flush_timeout;
 	u64 irq_suspend_timeout;
 	u32 defer_hard_irqs;
+	bool adaptive;
 	cpumask_t affinity_mask;
 	unsigned int napi_id;
 };
@@ -387,6 +388,12 @@ struct napi_struct {
 	unsigned long		state;
 	int			weight;
 	u32			defer_hard_irqs_count;
+	/* adaptive deferral state, see napi_adapt() */
+	u16			adapt_load;
+	u16			adapt_defer;
+	u32			adapt_timeout;
+	u32			adapt_bp_gap;
+	u64			adapt_bp_last;
 	int			(*poll)(struct napi_struct *, int);
 #ifdef CONFIG_NETPOLL
 	/* CPU actively polling if netpoll is configured */
@@ -403,6 +410,7 @@ struct napi_struct {
 	unsigned long		gro_flush_timeout;
 	unsigned long		irq_suspend_timeout;
 	u32			defer_hard_irqs;
+	bool			adaptive;
 	/* control-path-only fields follow */
 	u32			napi_id;
 	struct list_head	dev_list;
@@ -3462,6 +3470,7 @@ struct softnet_data {
 #endif
 
 	unsigned int		received_rps;
+	unsigned int		rps_flow_evictions;
 	bool			in_net_rx_action;
 	bool			in_napi_threaded_poll;
 
@@ -86,6 +86,7 @@ struct padata_cpumask {
  * @reorder_list: percpu reorder lists
  * @squeue: percpu padata queues used for serialuzation.
  * @refcnt: Number of objects holding a reference on this parallel_data.
+ * @reorder_objects: Number of objects waiting in the reorder lists.
  * @seq_nr: Sequence number of the parallelized data object.
  * @processed: Number of already processed objects.
  * @cpu: Next CPU to be processed.
@@ -98,6 +99,7 @@ struct parallel_data {
 	struct padata_list		__percpu *reorder_list;
 	struct padata_serial_queue	__percpu *squeue;
 	refcount_t			refcnt;
+	atomic_t			reorder_objects;
 	unsigned int			seq_nr;
 	unsigned int			processed;
 	int				cpu;
@@ -162,6 +164,9 @@ struct padata_mt_job {
  * @kobj: padata instance kernel object.
  * @lock: padata instance lock.
  * @flags: padata flags.
+ * @nr_parallel: Number of objects submitted to padata_do_parallel().
+ * @reorder_stalls: Number of times the reorder found the next object still
+ *                  being processed while later ones were done.
  */
 struct padata_instance {
 	struct hlist_node		cpu_online_node;
@@ -176,6 +181,8 @@ struct padata_instance {
 #define	PADATA_INIT	1
 #define	PADATA_RESET	2
 #define	PADATA_INVALID	4
+	unsigned long			 nr_parallel;
+	atomic_long_t			 reorder_stalls;
 };
 
 #ifdef CONFIG_PADATA
@@ -104,6 +104,14 @@ struct psi_group_cpu {
 	/* Delta detection against the sampling buckets */
 	u32 times_prev[NR_PSI_AGGREGATORS][NR_PSI_STATES]
 			____cacheline_aligned_in_smp;
+
+	/* Lazy aggregation, protected by psi_lazy_lock */
+
+	/* Times summed from the child groups while the group is lazy */
+	u32 lazy_times[NR_PSI_STATES];
+
+	/* Times of this group already summed into a lazy parent */
+	u32 lazy_pulled[NR_PSI_STATES];
 };
 
 /* PSI growth tracking window */
@@ -163,6 +171,15 @@ struct psi_group {
 	struct psi_group *parent;
 	bool enabled;
 
+	/*
+	 * Lazily aggregated: task changes below the group only update its
+	 * task counts and its times are summed from the child groups when
+	 * read. The children list is protected by psi_lazy_lock.
+	 */
+	bool lazy;
+	struct list_head children;
+	struct list_head sibling;
+
 	/* Protects data used by the aggregator */
 	struct mutex avgs_lock;
 
@@ -260,6 +260,7 @@ void rhashtable_free_and_destroy(struct rhashtable *ht,
 				 void (*free_fn)(void *ptr, void *arg),
 				 void *arg);
 void rhashtable_destroy(struct rhashtable *ht);
+int rhashtable_reserve(struct rhashtable *ht, unsigned int nelems);
 
 struct rhash_lock_head __rcu **rht_bucket_nested(
 	const struct bucket_table *tbl, unsigned int hash);
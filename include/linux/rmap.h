@@ -895,6 +895,13 @@ static inline int folio_try_share_anon_rmap_pmd(struct folio *folio,
 int folio_referenced(struct folio *, int is_locked,
 			struct mem_cgroup *memcg, unsigned long *vm_flags);
 
+/* Most folios folio_referenced_batch() takes at once */
+#define FOLIO_REFERENCED_BATCH	8
+
+void folio_referenced_batch(struct folio **folios, unsigned int nr,
+			    struct mem_cgroup *memcg, int *referenced,
+			    unsigned long *vm_flags);
+
 void try_to_migrate(struct folio *folio, enum ttu_flags flags);
 void try_to_unmap(struct folio *, enum ttu_flags flags);
 
@@ -1031,6 +1038,20 @@ static inline int folio_referenced(struct folio *folio, int is_locked,
 	return 0;
 }
 
+#define FOLIO_REFERENCED_BATCH	1
+
+static inline void folio_referenced_batch(struct folio **folios,
+		unsigned int nr, struct mem_cgroup *memcg, int *referenced,
+		unsigned long *vm_flags)
+{
+	unsigned int i;
+
+	for (i = 0; i < nr; i++) {
+		referenced[i] = 0;
+		vm_flags[i] = 0;
+	}
+}
+
 static inline void try_to_unmap(struct folio *folio, enum ttu_flags flags)
 {
 }
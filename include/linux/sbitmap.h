@@ -149,6 +149,15 @@ struct sbitmap_queue {
 	 * @wakeup_cnt: Number of thread wake ups issued.
 	 */
 	atomic_t wakeup_cnt;
+
+	/**
+	 * @remote_frees: Number of bits freed on a CPU other than the one
+	 * that allocated them, per freeing CPU. Only sbitmap_queue_clear()
+	 * knows the allocating CPU, so frees through
+	 * sbitmap_queue_clear_batch() are not counted and this is a lower
+	 * bound.
+	 */
+	unsigned long __percpu *remote_frees;
 };
 
 /**
@@ -425,6 +434,7 @@ int sbitmap_queue_init_node(struct sbitmap_queue *sbq, unsigned int depth,
  */
 static inline void sbitmap_queue_free(struct sbitmap_queue *sbq)
 {
+	free_percpu(sbq->remote_frees);
 	kfree(sbq->ws);
 	sbitmap_free(&sbq->sb);
 }
@@ -9,6 +9,8 @@
  */
 
 #define SCHED_CPUFREQ_IOWAIT	(1U << 0)
+#define SCHED_CPUFREQ_FORECAST	(1U << 1) /* a task woke up, util_est includes it */
+#define SCHED_CPUFREQ_LATENCY	(1U << 2) /* the woken task is latency sensitive */
 
 #ifdef CONFIG_CPU_FREQ
 struct cpufreq_policy;
@@ -78,8 +78,25 @@ struct sched_domain_shared {
 	atomic_t	nr_busy_cpus;
 	int		has_idle_cores;
 	int		nr_idle_scan;
+
+	/*
+	 * Index of the idle CPUs and of the fully idle cores of the LLC,
+	 * kept up to date on idle entry and exit. Two cpumasks, see
+	 * sds_idle_cpus() and sds_idle_cores().
+	 */
+	unsigned long	idle_mask[];
 };
 
+static inline struct cpumask *sds_idle_cpus(struct sched_domain_shared *sds)
+{
+	return to_cpumask(sds->idle_mask);
+}
+
+static inline struct cpumask *sds_idle_cores(struct sched_domain_shared *sds)
+{
+	return to_cpumask(sds->idle_mask + cpumask_size() / sizeof(long));
+}
+
 struct sched_domain {
 	/* These fields must be setup */
 	struct sched_domain __rcu *parent;	/* top domain must be null terminated */
@@ -106,6 +123,9 @@ struct sched_domain {
 	unsigned long last_decay_max_lb_cost;
 
 #ifdef CONFIG_SCHEDSTATS
+	/* time spent in sched_balance_rq() at this level, in ns */
+	u64 lb_time;
+
 	/* sched_balance_rq() stats */
 	unsigned int lb_count[CPU_MAX_IDLE_TYPES];
 	unsigned int lb_failed[CPU_MAX_IDLE_TYPES];
@@ -63,6 +63,15 @@ extern void wake_q_add(struct wake_q_head *head, struct task_struct *task);
 extern void wake_q_add_safe(struct wake_q_head *head, struct task_struct *task);
 extern void wake_up_q(struct wake_q_head *head);
 
+/* Batches disable preemption, which PREEMPT_RT's sleeping spinlocks forbid */
+#if defined(CONFIG_SMP) && !defined(CONFIG_PREEMPT_RT)
+extern void wake_batch_begin(void);
+extern void wake_batch_end(void);
+#else
+static inline void wake_batch_begin(void) { }
+static inline void wake_batch_end(void) { }
+#endif
+
 /* Spin unlock helpers to unlock and call wake_up_q with preempt disabled */
 static inline
 void raw_spin_unlock_wake(raw_spinlock_t *lock, struct wake_q_head *wake_q)
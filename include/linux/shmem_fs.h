@@ -54,6 +54,11 @@ struct shmem_quota_limits {
 	qsize_t grpquota_ihardlimit; /* Default group quota inode hard limit */
 };
 
+/* Folios allocated by a tmpfs mount, by order */
+struct shmem_order_stats {
+	unsigned long nr_alloc[NR_PAGE_ORDERS];
+};
+
 struct shmem_sb_info {
 	unsigned long max_blocks;   /* How many blocks are allowed */
 	struct percpu_counter used_blocks;  /* How many are allocated */
@@ -62,6 +67,7 @@ struct shmem_sb_info {
 	raw_spinlock_t stat_lock;   /* Serialize shmem_sb_info changes */
 	umode_t mode;		    /* Mount mode for root directory */
 	unsigned char huge;	    /* Whether to try for hugepages */
+	unsigned long huge_orders;  /* Large folio orders allowed, 0 for all */
 	kuid_t uid;		    /* Mount uid for root directory */
 	kgid_t gid;		    /* Mount gid for root directory */
 	bool full_inums;	    /* If i_ino should be uint or ino_t */
@@ -73,6 +79,7 @@ struct shmem_sb_info {
 	struct list_head shrinklist;  /* List of shinkable inodes */
 	unsigned long shrinklist_len; /* Length of shrinklist */
 	struct shmem_quota_limits qlimits; /* Default quota limits */
+	struct shmem_order_stats __percpu *order_stats;
 };
 
 static inline struct shmem_inode_info *SHMEM_I(struct inode *inode)
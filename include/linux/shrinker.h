@@ -112,6 +112,11 @@ struct shrinker {
 	int debugfs_id;
 	const char *name;
 	struct dentry *debugfs_entry;
+	/* reclaim cost, reported in the "stats" debugfs file */
+	atomic_long_t nr_calls;
+	atomic_long_t nr_scanned;
+	atomic_long_t nr_freed;
+	atomic64_t scan_ns;
 #endif
 	/* objs pending delete, per node */
 	atomic_long_t *nr_deferred;
@@ -119,6 +119,13 @@ struct sk_psock {
 	struct delayed_work		work;
 	struct sock			*sk_pair;
 	struct rcu_work			rwork;
+	/* Backlog stats, reported as INET_DIAG_PSOCK */
+	u64				backlog_ts;
+	u64				backlog_skbs;
+	u64				backlog_runs;
+	u64				backlog_delay_ns;
+	u64				redirect_direct;
+	u32				backlog_max;
 };
 
 int sk_msg_alloc(struct sock *sk, struct sk_msg *msg, int len,
@@ -323,6 +323,18 @@ struct kmem_cache_args {
 	 * @use_freeptr_offset: Whether a @freeptr_offset is used.
 	 */
 	bool use_freeptr_offset;
+	/**
+	 * @sheaf_capacity: Enable per cpu sheaves of this many objects.
+	 *
+	 * With sheaves, freed objects are kept in a per cpu array regardless
+	 * of the slab they belong to, and full arrays are exchanged between
+	 * cpus of a node. This makes freeing objects that were allocated on
+	 * another cpu cheap, at the cost of memory held in the sheaves.
+	 *
+	 * Ignored for caches with debugging enabled and with %CONFIG_SLUB_TINY.
+	 * %0 means no sheaves.
+	 */
+	unsigned int sheaf_capacity;
 	/**
 	 * @ctor: A constructor for the objects.
 	 *
@@ -177,6 +177,24 @@ depot_stack_handle_t stack_depot_save_flags(unsigned long *entries,
 depot_stack_handle_t stack_depot_save(unsigned long *entries,
 				      unsigned int nr_entries, gfp_t alloc_flags);
 
+/**
+ * stack_depot_prealloc - Make sure stack depot has a spare pool
+ *
+ * @alloc_flags:	Allocation GFP flags
+ *
+ * Stack depot keeps one spare pool to switch to when the current one fills
+ * up, but only refills it from a stack_depot_save_flags() call that has to
+ * store a new stack trace and is allowed to allocate. Users that save stacks
+ * without %STACK_DEPOT_FLAG_CAN_ALLOC can call this from a context that can
+ * allocate to keep the spare pool topped up.
+ *
+ * Context: Contexts where allocations via alloc_pages() are allowed.
+ *
+ * Return: 0 if a spare pool is available or the depot is full, -ENOMEM if
+ *         the allocation failed, -ENOENT if stack depot is disabled
+ */
+int stack_depot_prealloc(gfp_t alloc_flags);
+
 /**
  * __stack_depot_get_stack_record - Get a pointer to a stack_record struct
  *
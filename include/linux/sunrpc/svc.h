@@ -44,6 +44,8 @@ struct svc_pool {
 	struct percpu_counter	sp_messages_arrived;
 	struct percpu_counter	sp_sockets_queued;
 	struct percpu_counter	sp_threads_woken;
+	struct percpu_counter	sp_queue_wait_us; /* xprt time on sp_xprts */
+	struct percpu_counter	sp_threads_idle;
 
 	unsigned long		sp_flags;
 } ____cacheline_aligned_in_smp;
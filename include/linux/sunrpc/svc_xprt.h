@@ -55,6 +55,7 @@ struct svc_xprt {
 	struct kref		xpt_ref;
 	struct list_head	xpt_list;
 	struct lwq_node		xpt_ready;
+	ktime_t			xpt_qtime;	/* when put on xpt_ready */
 	unsigned long		xpt_flags;
 
 	struct svc_serv		*xpt_server;	/* service for transport */
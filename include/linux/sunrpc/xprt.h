@@ -287,7 +287,8 @@ struct rpc_xprt {
 					sends,		/* how many complete requests */
 					recvs,		/* how many complete requests */
 					bad_xids,	/* lookup_rqst didn't find XID */
-					max_slots;	/* max rpc_slots used */
+					max_slots,	/* max rpc_slots used */
+					xmit_batches;	/* xprt_transmit calls that sent */
 
 		unsigned long long	req_u,		/* average requests on the wire */
 					bklog_u,	/* backlog queue utilization */
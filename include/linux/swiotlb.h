@@ -104,6 +104,7 @@ struct io_tlb_pool {
  *		in debugfs.
  * @transient_nslabs: The total number of slots in all transient pools that
  *		are currently used across all areas.
+ * @alloc_stats: Per-CPU slot search statistics, reported in debugfs.
  */
 struct io_tlb_mem {
 	struct io_tlb_pool defpool;
@@ -122,6 +123,7 @@ struct io_tlb_mem {
 	atomic_long_t total_used;
 	atomic_long_t used_hiwater;
 	atomic_long_t transient_nslabs;
+	struct io_tlb_alloc_stats __percpu *alloc_stats;
 #endif
 };
 
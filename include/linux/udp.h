@@ -89,6 +89,10 @@ struct udp_sock {
 	int			(*gro_complete)(struct sock *sk,
 						struct sk_buff *skb,
 						int nhoff);
+	/* Returns the coalescing key of a datagram, see UDP_GRO_BPF */
+	struct bpf_prog __rcu	*gro_prog;
+	atomic_long_t		gro_packets;
+	atomic_long_t		gro_segs;
 
 	/* udp_recvmsg try to use this before splicing sk_receive_queue */
 	struct sk_buff_head	reader_queue ____cacheline_aligned_in_smp;
@@ -34,10 +34,15 @@ enum vm_event_item { PGPGIN, PGPGOUT, PSWPIN, PSWPOUT,
 		FOR_ALL_ZONES(ALLOCSTALL)
 		FOR_ALL_ZONES(PGSCAN_SKIP)
 		PGFREE, PGACTIVATE, PGDEACTIVATE, PGLAZYFREE,
+		PGALLOC_BULK_FOLIO, PGALLOC_BULK_FOLIO_FALLBACK,
 		PGFAULT, PGMAJFAULT,
 		PGLAZYFREED,
 		PGREFILL,
 		PGREUSE,
+		PGRA_SUBMIT,	/* pages submitted by readahead */
+		PGRA_HIT,	/* readahead pages consumed before the next window */
+		PGRA_MISS,	/* pages that had to be read synchronously */
+		PGRA_WASTED,	/* readahead marker folios evicted unused */
 		PGSTEAL_KSWAPD,
 		PGSTEAL_DIRECT,
 		PGSTEAL_KHUGEPAGED,
@@ -57,8 +62,10 @@ enum vm_event_item { PGPGIN, PGPGOUT, PSWPIN, PSWPOUT,
 #endif
 		PGINODESTEAL, SLABS_SCANNED, KSWAPD_INODESTEAL,
 		KSWAPD_LOW_WMARK_HIT_QUICKLY, KSWAPD_HIGH_WMARK_HIT_QUICKLY,
+		KSWAPD_WORKER_BATCH, KSWAPD_WORKER_SCAN, KSWAPD_WORKER_STEAL,
 		PAGEOUTRUN, PGROTATED,
 		DROP_PAGECACHE, DROP_SLAB,
+		RMAP_WALKS_SAVED,
 		OOM_KILL,
 #ifdef CONFIG_NUMA_BALANCING
 		NUMA_PTE_UPDATES,
@@ -72,6 +79,11 @@ enum vm_event_item { PGPGIN, PGPGOUT, PSWPIN, PSWPOUT,
 		THP_MIGRATION_SUCCESS,
 		THP_MIGRATION_FAIL,
 		THP_MIGRATION_SPLIT,
+		PGMIGRATE_BATCH_COPY,
+		PGMIGRATE_BATCH_COPY_US,
+		PGMIGRATE_BATCH_COPY_INELIGIBLE,
+		PGMIGRATE_BATCH_COPY_SMALL,
+		PGMIGRATE_BATCH_COPY_ERROR,
 #endif
 #ifdef CONFIG_COMPACTION
 		COMPACTMIGRATE_SCANNED, COMPACTFREE_SCANNED,
@@ -130,6 +142,8 @@ enum vm_event_item { PGPGIN, PGPGOUT, PSWPIN, PSWPOUT,
 #ifdef CONFIG_DEBUG_TLBFLUSH
 		NR_TLB_REMOTE_FLUSH,	/* cpu tried to flush others' tlbs */
 		NR_TLB_REMOTE_FLUSH_RECEIVED,/* cpu received ipi for flush */
+		NR_TLB_REMOTE_FLUSH_SKIPPED,/* ipi not sent, cpu flushes later */
+		NR_TLB_REMOTE_FLUSH_BROADCAST,/* flushed by broadcast, no ipi */
 		NR_TLB_LOCAL_FLUSH_ALL,
 		NR_TLB_LOCAL_FLUSH_ONE,
 #endif /* CONFIG_DEBUG_TLBFLUSH */
@@ -150,6 +164,25 @@ enum vm_event_item { PGPGIN, PGPGOUT, PSWPIN, PSWPOUT,
 		ZSWPOUT,
 		ZSWPWB,
 #endif
+#ifdef CONFIG_IO_URING
+		PGCACHE_BATCH_HIT,
+		PGCACHE_BATCH_MISS,
+#endif
+#ifdef CONFIG_MEMCG
+		MEMCG_STATS_FLUSH_SKIPPED,
+		MEMCG_STATS_FLUSH_SAVED_US,
+		ISOLATED_STOCK_DRAIN_SKIP,
+#endif
+#ifdef CONFIG_PREZERO_FOLIOS
+		PREZERO_ALLOC,
+		PREZERO_EMPTY,
+		PREZERO_FILL,
+#endif
+		ISOLATED_VMSTAT_SKIP,
+		ISOLATED_LRU_DRAIN,
+		EXIT_MMAP,
+		EXIT_MMAP_UNMAP_US,
+		EXIT_MMAP_FREE_US,
 #ifdef CONFIG_X86
 		DIRECT_MAP_LEVEL2_SPLIT,
 		DIRECT_MAP_LEVEL3_SPLIT,
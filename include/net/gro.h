@@ -98,6 +98,9 @@ struct napi_gro_cb {
 		};
 		u16 network_offsets[2];
 	};
+
+	/* Coalescing key from the socket's UDP_GRO_BPF program, 0 if none */
+	u32	udp_gro_key;
 };
 
 #define NAPI_GRO_CB(skb) ((struct napi_gro_cb *)(skb)->cb)
@@ -22,6 +22,10 @@ struct fqdir {
 
 	struct rhashtable       rhashtable ____cacheline_aligned_in_smp;
 
+	/* Live queues, oldest first, for eviction under memory pressure */
+	spinlock_t		lru_lock;
+	struct list_head	lru_list;
+
 	/* Keep atomic mem on separate cachelines in structs that include it */
 	atomic_long_t		mem ____cacheline_aligned_in_smp;
 	struct work_struct	destroy_work;
@@ -80,6 +84,7 @@ struct frag_v6_compare_key {
  * @flags: fragment queue flags
  * @max_size: maximum received fragment size
  * @fqdir: pointer to struct fqdir
+ * @lru: entry on fqdir->lru_list
  * @rcu: rcu head for freeing deferall
  */
 struct inet_frag_queue {
@@ -101,6 +106,7 @@ struct inet_frag_queue {
 	__u8			flags;
 	u16			max_size;
 	struct fqdir		*fqdir;
+	struct list_head	lru;
 	struct rcu_head		rcu;
 };
 
@@ -24,6 +24,7 @@
 #include <linux/refcount.h>
 #include <linux/ip.h>
 #include <linux/in_route.h>
+#include <linux/jump_label.h>
 
 struct fib_config {
 	u8			fc_dst_len;
@@ -289,6 +290,15 @@ struct fib_table *fib_trie_unmerge(struct fib_table *main_tb);
 void fib_table_flush_external(struct fib_table *table);
 void fib_free_table(struct fib_table *tb);
 
+#ifdef CONFIG_IP_FIB_TRIE_CACHE
+DECLARE_STATIC_KEY_FALSE(fib_lookup_cache);
+void fib_lookup_cache_invalidate(void);
+#else
+static inline void fib_lookup_cache_invalidate(void)
+{
+}
+#endif
+
 #ifndef CONFIG_IP_MULTIPLE_TABLES
 
 #define TABLE_LOCAL_INDEX	(RT_TABLE_LOCAL & (FIB_TABLE_HASHSZ - 1))
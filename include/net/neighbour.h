@@ -131,6 +131,11 @@ struct neigh_statistics {
 
 	unsigned long unres_discards;	/* number of unresolved drops */
 	unsigned long table_fulls;      /* times even gc couldn't help */
+
+	unsigned long periodic_gc_time;	/* usecs spent in periodic GC */
+	unsigned long lock_hold_max;	/* longest tbl->lock hold by GC or
+					 * resize, in usecs
+					 */
 };
 
 #define NEIGH_CACHE_STAT_INC(tbl, field) this_cpu_inc((tbl)->stats->field)
@@ -195,6 +200,8 @@ struct neigh_hash_table {
 	struct hlist_head	*hash_heads;
 	unsigned int		hash_shift;
 	__u32			hash_rnd[NEIGH_NUM_HASH_RND];
+	/* Table the entries are being moved to while resizing */
+	struct neigh_hash_table __rcu *future;
 	struct rcu_head		rcu;
 };
 
@@ -224,6 +231,8 @@ struct neigh_table {
 	int			gc_thresh3;
 	unsigned long		last_flush;
 	struct delayed_work	gc_work;
+	unsigned int		gc_bucket;
+	struct work_struct	grow_work;
 	struct delayed_work	managed_work;
 	struct timer_list 	proxy_timer;
 	struct sk_buff_head	proxy_queue;
@@ -303,10 +312,14 @@ static inline struct neighbour *___neigh_lookup_noref(
 	struct neighbour *n;
 	u32 hash_val;
 
-	hash_val = hash(pkey, dev, nht->hash_rnd) >> (32 - nht->hash_shift);
-	neigh_for_each_in_bucket_rcu(n, &nht->hash_heads[hash_val])
-		if (n->dev == dev && key_eq(n, pkey))
-			return n;
+	/* While the table is resized, entries are in either table. */
+	do {
+		hash_val = hash(pkey, dev, nht->hash_rnd) >> (32 - nht->hash_shift);
+		neigh_for_each_in_bucket_rcu(n, &nht->hash_heads[hash_val])
+			if (n->dev == dev && key_eq(n, pkey))
+				return n;
+		nht = rcu_dereference(nht->future);
+	} while (unlikely(nht));
 
 	return NULL;
 }
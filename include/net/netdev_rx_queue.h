@@ -14,6 +14,10 @@ struct netdev_rx_queue {
 #ifdef CONFIG_RPS
 	struct rps_map __rcu		*rps_map;
 	struct rps_dev_flow_table __rcu	*rps_flow_table;
+	/* RFS stats, written by the CPU receiving from the queue */
+	unsigned long			rfs_collisions;
+	unsigned long			rfs_steer_changes;
+	unsigned long			rfs_filter_updates;
 #endif
 	struct kobject			kobj;
 	const struct attribute_group	**groups;
@@ -134,7 +134,10 @@ struct nh_group {
 	bool			fdb_nh;
 	bool			has_v4;
 	bool			hw_stats;
+	u8			hthr_map_shift;
 
+	/* hash-threshold only: first candidate entry per hash range */
+	u16			*hthr_map;
 	struct nh_res_table __rcu *res_table;
 	struct nh_grp_entry	nh_entries[] __counted_by(num_nh);
 };
@@ -32,6 +32,10 @@ void net_mp_close_rxq(struct net_device *dev, unsigned ifq_idx,
 		      struct pp_memory_provider_params *old_p);
 void __net_mp_close_rxq(struct net_device *dev, unsigned int rxq_idx,
 			const struct pp_memory_provider_params *old_p);
+int __net_mp_swap_rxq(struct net_device *dev, unsigned int rxq_idx,
+		      const struct pp_memory_provider_params *old_p,
+		      const struct pp_memory_provider_params *p,
+		      struct netlink_ext_ack *extack);
 
 /**
   * net_mp_netmem_place_in_cache() - give a netmem to a page pool
@@ -102,6 +102,9 @@ struct page_pool_params {
  * @refill:	an allocation which triggered a refill of the cache
  * @waive:	pages obtained from the ptr ring that cannot be added to
  *		the cache due to a NUMA mismatch
+ * @remote:	pages drained from the per-CPU remote return rings
+ * @remote_latency: total ns remote return rings had pages waiting before
+ *		they were drained
  */
 struct page_pool_alloc_stats {
 	u64 fast;
@@ -110,6 +113,8 @@ struct page_pool_alloc_stats {
 	u64 empty;
 	u64 refill;
 	u64 waive;
+	u64 remote;
+	u64 remote_latency;
 };
 
 /**
@@ -119,6 +124,8 @@ struct page_pool_alloc_stats {
  * @ring:	page placed into the ptr ring
  * @ring_full:	page released from page pool because the ptr ring was full
  * @released_refcnt:	page released (and not recycled) because refcnt > 1
+ * @remote:	page placed into this CPU's remote return ring
+ * @remote_full: this CPU's remote return ring was full
  */
 struct page_pool_recycle_stats {
 	u64 cached;
@@ -126,6 +133,8 @@ struct page_pool_recycle_stats {
 	u64 ring;
 	u64 ring_full;
 	u64 released_refcnt;
+	u64 remote;
+	u64 remote_full;
 };
 
 /**
@@ -153,6 +162,7 @@ struct page_pool_stats {
 #define PAGE_POOL_FRAG_GROUP_ALIGN	(4 * sizeof(long))
 
 struct memory_provider_ops;
+struct page_pool_remote;
 
 struct pp_memory_provider_params {
 	void *mp_priv;
@@ -218,6 +228,16 @@ struct page_pool {
 	 */
 	struct ptr_ring ring;
 
+	/* Pages freed away from the NAPI CPU go into a lockless ring of
+	 * the freeing CPU first, so remote CPUs don't contend on the
+	 * ptr_ring producer lock. The allocation side drains the rings of
+	 * the CPUs set in @remote_pending in bulk. Only NAPI pools have them,
+	 * and only while net.core.page_pool_remote_recycle is enabled.
+	 */
+	struct page_pool_remote __percpu *remote;
+	cpumask_var_t remote_pending;
+	u32 remote_cap;
+
 	void *mp_priv;
 	const struct memory_provider_ops *mp_ops;
 
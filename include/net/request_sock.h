@@ -179,11 +179,24 @@ struct fastopen_queue {
 	struct tcp_fastopen_context __rcu *ctx; /* cipher context for cookie */
 };
 
+/* One per CPU accept FIFO of a sharded listener (TCP_ACCEPTQ_SHARDED).
+ * Children are queued on the CPU that completed the handshake, accept()
+ * takes from its own CPU first and steals from the others.
+ */
+struct reqsk_accept_shard {
+	spinlock_t		lock;
+	u32			qlen;
+	struct request_sock	*head;
+	struct request_sock	*tail;
+} ____cacheline_aligned_in_smp;
+
 /** struct request_sock_queue - queue of request_socks
  *
  * @rskq_accept_head - FIFO head of established children
  * @rskq_accept_tail - FIFO tail of established children
  * @rskq_defer_accept - User waits for some data after accept()
+ * @shards - per CPU FIFOs replacing rskq_accept_head/tail, if enabled
+ * @shards_qlen - children queued on all shards
  *
  */
 struct request_sock_queue {
@@ -196,18 +209,31 @@ struct request_sock_queue {
 
 	struct request_sock	*rskq_accept_head;
 	struct request_sock	*rskq_accept_tail;
+	struct reqsk_accept_shard __percpu *shards;
+	atomic_t		shards_qlen;
 	struct fastopen_queue	fastopenq;  /* Check max_qlen != 0 to determine
 					     * if TFO is enabled.
 					     */
 };
 
 void reqsk_queue_alloc(struct request_sock_queue *queue);
+int reqsk_queue_alloc_shards(struct request_sock_queue *queue);
+void reqsk_queue_free_shards(struct request_sock_queue *queue);
+void reqsk_queue_sync_backlog(struct request_sock_queue *queue,
+			      struct sock *parent);
+void reqsk_queue_quiesce_shards(struct request_sock_queue *queue);
+void reqsk_queue_add_sharded(struct request_sock_queue *queue,
+			     struct sock *parent, struct request_sock *req);
+struct request_sock *reqsk_queue_remove_sharded(struct request_sock_queue *queue,
+						struct sock *parent);
 
 void reqsk_fastopen_remove(struct sock *sk, struct request_sock *req,
 			   bool reset);
 
 static inline bool reqsk_queue_empty(const struct request_sock_queue *queue)
 {
+	if (queue->shards)
+		return !atomic_read(&queue->shards_qlen);
 	return READ_ONCE(queue->rskq_accept_head) == NULL;
 }
 
@@ -216,6 +242,9 @@ static inline struct request_sock *reqsk_queue_remove(struct request_sock_queue
 {
 	struct request_sock *req;
 
+	if (queue->shards)
+		return reqsk_queue_remove_sharded(queue, parent);
+
 	spin_lock_bh(&queue->rskq_lock);
 	req = queue->rskq_accept_head;
 	if (req) {
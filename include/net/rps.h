@@ -55,6 +55,12 @@ struct rps_dev_flow_table {
  * possible CPUs : rps_cpu_mask = roundup_pow_of_two(nr_cpu_ids) - 1
  * For example, if 64 CPUs are possible, rps_cpu_mask = 0x3f,
  * meaning we use 32-6=26 bits for the hash.
+ *
+ * The table is two-way set associative: a hash maps to a bucket of two
+ * adjacent entries, so that two flows colliding on the same index do not
+ * keep overwriting each other. The first entry of a bucket holds the most
+ * recently inserted flow; a new flow pushes it to the second entry and
+ * ages out whatever was there.
  */
 struct rps_sock_flow_table {
 	u32	mask;
@@ -65,20 +71,52 @@ struct rps_sock_flow_table {
 
 #define RPS_NO_CPU 0xffff
 
+#define RPS_SOCK_FLOW_WAYS	2
+
+static inline u32 *rps_sock_flow_bucket(const struct rps_sock_flow_table *table,
+					u32 hash)
+{
+	return (u32 *)&table->ents[hash & table->mask & ~(RPS_SOCK_FLOW_WAYS - 1)];
+}
+
+static inline bool rps_sock_flow_match(u32 ident, u32 hash)
+{
+	return !((ident ^ hash) & ~net_hotdata.rps_cpu_mask);
+}
+
 static inline void rps_record_sock_flow(struct rps_sock_flow_table *table,
 					u32 hash)
 {
-	unsigned int index = hash & table->mask;
+	u32 *bucket = rps_sock_flow_bucket(table, hash);
 	u32 val = hash & ~net_hotdata.rps_cpu_mask;
+	u32 first, second;
 
 	/* We only give a hint, preemption can change CPU under us */
 	val |= raw_smp_processor_id();
 
-	/* The following WRITE_ONCE() is paired with the READ_ONCE()
-	 * here, and another one in get_rps_cpu().
+	/* The following WRITE_ONCE()s are paired with the READ_ONCE()s
+	 * here, and in get_rps_cpu().
 	 */
-	if (READ_ONCE(table->ents[index]) != val)
-		WRITE_ONCE(table->ents[index], val);
+	first = READ_ONCE(bucket[0]);
+	if (rps_sock_flow_match(first, hash)) {
+		if (first != val)
+			WRITE_ONCE(bucket[0], val);
+		return;
+	}
+
+	second = READ_ONCE(bucket[1]);
+	if (rps_sock_flow_match(second, hash)) {
+		if (second != val)
+			WRITE_ONCE(bucket[1], val);
+		return;
+	}
+
+	/* New flow: age the first entry into the second slot. */
+	if (second != RPS_NO_CPU && first != RPS_NO_CPU)
+		this_cpu_inc(softnet_data.rps_flow_evictions);
+	if (first != RPS_NO_CPU)
+		WRITE_ONCE(bucket[1], first);
+	WRITE_ONCE(bucket[0], val);
 }
 
 #endif /* CONFIG_RPS */
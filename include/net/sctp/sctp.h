@@ -205,6 +205,7 @@ extern int sysctl_sctp_wmem[3];
 
 /* SCTP SNMP MIB stats handlers */
 #define SCTP_INC_STATS(net, field)	SNMP_INC_STATS((net)->sctp.sctp_statistics, field)
+#define SCTP_ADD_STATS(net, field, val)	SNMP_ADD_STATS((net)->sctp.sctp_statistics, field, val)
 #define __SCTP_INC_STATS(net, field)	__SNMP_INC_STATS((net)->sctp.sctp_statistics, field)
 #define SCTP_DEC_STATS(net, field)	SNMP_DEC_STATS((net)->sctp.sctp_statistics, field)
 
@@ -244,6 +245,9 @@ enum {
 	SCTP_MIB_IN_PKT_BACKLOG,
 	SCTP_MIB_IN_PKT_DISCARDS,
 	SCTP_MIB_IN_DATA_CHUNK_DISCARDS,
+	SCTP_MIB_OUTQ_FLUSHES,
+	SCTP_MIB_OUTQ_IDLE_FLUSHES,
+	SCTP_MIB_OUTQ_FLUSH_DATA_CHUNKS,
 	__SCTP_MIB_MAX
 };
 
@@ -2822,6 +2822,7 @@ void clean_acked_data_flush(void);
 #endif
 
 DECLARE_STATIC_KEY_FALSE(tcp_tx_delay_enabled);
+DECLARE_STATIC_KEY_FALSE(tcp_gro_ack_coalesce);
 static inline void tcp_add_tx_delay(struct sk_buff *skb,
 				    const struct tcp_sock *tp)
 {
@@ -101,6 +101,10 @@ struct tls_sw_context_tx {
 	atomic_t encrypt_pending;
 	u8 async_capable:1;
 
+	/* records handed to the AEAD, and sendmsg() calls that did so */
+	u64 tx_records;
+	u64 tx_batches;
+
 #define BIT_TX_SCHEDULED	0
 #define BIT_TX_CLOSING		1
 	unsigned long tx_bitmask;
@@ -294,6 +294,19 @@ static inline void udp_lib_init_sock(struct sock *sk)
 	set_bit(SOCK_CUSTOM_SOCKOPT, &sk->sk_socket->flags);
 }
 
+/* Account a datagram queued to a UDP_GRO socket, see UDP_GRO_STATS */
+static inline void udp_gro_account(struct sock *sk, const struct sk_buff *skb)
+{
+	struct udp_sock *up = udp_sk(sk);
+
+	if (!udp_test_bit(GRO_ENABLED, sk))
+		return;
+
+	atomic_long_inc(&up->gro_packets);
+	atomic_long_add(skb_is_gso(skb) ? skb_shinfo(skb)->gso_segs : 1,
+			&up->gro_segs);
+}
+
 /* hash routines shared between UDPv4/6 and UDP-Litev4/6 */
 static inline int udp_lib_hash(struct sock *sk)
 {
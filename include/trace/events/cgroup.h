@@ -296,6 +296,41 @@ DEFINE_EVENT(cgroup_rstat, cgroup_rstat_cpu_unlock_fastpath,
 	TP_ARGS(cgrp, cpu, contended)
 );
 
+/*
+ * One cgroup_rstat_flush() call: time waiting for cgroup_rstat_lock vs.
+ * flushing.  nr_cpu_flushes counts (cgroup, CPU) pairs, so a cgroup updated
+ * on several CPUs is counted once per CPU.
+ */
+TRACE_EVENT(cgroup_rstat_flush,
+
+	TP_PROTO(struct cgroup *cgrp, unsigned int nr_cpu_flushes, u64 wait_ns,
+		 u64 flush_ns),
+
+	TP_ARGS(cgrp, nr_cpu_flushes, wait_ns, flush_ns),
+
+	TP_STRUCT__entry(
+		__field(	int,		root			)
+		__field(	int,		level			)
+		__field(	u64,		id			)
+		__field(	unsigned int,	nr_cpu_flushes		)
+		__field(	u64,		wait_ns			)
+		__field(	u64,		flush_ns		)
+	),
+
+	TP_fast_assign(
+		__entry->root = cgrp->root->hierarchy_id;
+		__entry->id = cgroup_id(cgrp);
+		__entry->level = cgrp->level;
+		__entry->nr_cpu_flushes = nr_cpu_flushes;
+		__entry->wait_ns = wait_ns;
+		__entry->flush_ns = flush_ns;
+	),
+
+	TP_printk("root=%d id=%llu level=%d nr_cpu_flushes=%u wait_ns=%llu flush_ns=%llu",
+		  __entry->root, __entry->id, __entry->level,
+		  __entry->nr_cpu_flushes, __entry->wait_ns, __entry->flush_ns)
+);
+
 #endif /* _TRACE_CGROUP_H */
 
 /* This part must be outside protection */
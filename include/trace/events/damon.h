@@ -79,6 +79,33 @@ TRACE_EVENT(damon_aggregated,
 			__entry->nr_accesses, __entry->age)
 );
 
+TRACE_EVENT(damon_shard_sampled,
+
+	TP_PROTO(unsigned int shard_idx, unsigned int nr_regions, bool prepare,
+		u64 duration_ns),
+
+	TP_ARGS(shard_idx, nr_regions, prepare, duration_ns),
+
+	TP_STRUCT__entry(
+		__field(unsigned int, shard_idx)
+		__field(unsigned int, nr_regions)
+		__field(bool, prepare)
+		__field(u64, duration_ns)
+	),
+
+	TP_fast_assign(
+		__entry->shard_idx = shard_idx;
+		__entry->nr_regions = nr_regions;
+		__entry->prepare = prepare;
+		__entry->duration_ns = duration_ns;
+	),
+
+	TP_printk("shard_idx=%u nr_regions=%u %s duration_ns=%llu",
+			__entry->shard_idx, __entry->nr_regions,
+			__entry->prepare ? "prepare" : "check",
+			__entry->duration_ns)
+);
+
 #endif /* _TRACE_DAMON_H */
 
 /* This part must be outside protection */
@@ -83,6 +83,35 @@ DEFINE_EVENT(dma_fence, dma_fence_wait_end,
 	TP_ARGS(fence)
 );
 
+TRACE_EVENT(dma_fence_callbacks,
+
+	TP_PROTO(struct dma_fence *fence, unsigned int nr, u64 duration_ns),
+
+	TP_ARGS(fence, nr, duration_ns),
+
+	TP_STRUCT__entry(
+		__string(driver, fence->ops->get_driver_name(fence))
+		__string(timeline, fence->ops->get_timeline_name(fence))
+		__field(unsigned int, context)
+		__field(unsigned int, seqno)
+		__field(unsigned int, nr)
+		__field(u64, duration_ns)
+	),
+
+	TP_fast_assign(
+		__assign_str(driver);
+		__assign_str(timeline);
+		__entry->context = fence->context;
+		__entry->seqno = fence->seqno;
+		__entry->nr = nr;
+		__entry->duration_ns = duration_ns;
+	),
+
+	TP_printk("driver=%s timeline=%s context=%u seqno=%u callbacks=%u duration_ns=%llu",
+		  __get_str(driver), __get_str(timeline), __entry->context,
+		  __entry->seqno, __entry->nr, __entry->duration_ns)
+);
+
 #endif /*  _TRACE_DMA_FENCE_H */
 
 /* This part must be outside protection */
@@ -208,6 +208,37 @@ DEFINE_EVENT(cpu, cpu_frequency,
 	TP_ARGS(frequency, cpu_id)
 );
 
+TRACE_EVENT(schedutil_freq_decision,
+
+	TP_PROTO(unsigned int cpu_id, unsigned int freq, unsigned long util,
+		 unsigned int flags, u64 delay_ns),
+
+	TP_ARGS(cpu_id, freq, util, flags, delay_ns),
+
+	TP_STRUCT__entry(
+		__field(u32, cpu_id)
+		__field(u32, freq)
+		__field(unsigned long, util)
+		__field(u32, flags)
+		__field(u64, delay_ns)
+	),
+
+	TP_fast_assign(
+		__entry->cpu_id = cpu_id;
+		__entry->freq = freq;
+		__entry->util = util;
+		__entry->flags = flags;
+		__entry->delay_ns = delay_ns;
+	),
+
+	TP_printk("cpu_id=%lu freq=%lu util=%lu flags=0x%x delay_ns=%llu",
+		  (unsigned long)__entry->cpu_id,
+		  (unsigned long)__entry->freq,
+		  __entry->util,
+		  __entry->flags,
+		  (unsigned long long)__entry->delay_ns)
+);
+
 TRACE_EVENT(cpu_frequency_limits,
 
 	TP_PROTO(struct cpufreq_policy *policy),
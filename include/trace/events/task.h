@@ -53,6 +53,53 @@ TRACE_EVENT(task_rename,
 		  __entry->oldcomm, __entry->newcomm, __entry->oom_score_adj)
 );
 
+/**
+ * task_dup_mmap - called when fork has duplicated the address space
+ * @mm:		the child mm
+ * @nr_vmas:	number of vmas duplicated into the child
+ * @nr_copied:	number of those passed to copy_page_range()
+ * @lock_ns:	time spent waiting for the parent's mmap lock
+ * @copy_ns:	time spent in copy_page_range()
+ * @total_ns:	total time spent in dup_mmap()
+ * @ret:	0 or the error dup_mmap() failed with
+ *
+ * Breaks down the fork latency the parent's address space is responsible
+ * for. The parent's mmap lock is held for @total_ns - @lock_ns.
+ */
+TRACE_EVENT(task_dup_mmap,
+
+	TP_PROTO(struct mm_struct *mm, unsigned int nr_vmas,
+		 unsigned int nr_copied, u64 lock_ns, u64 copy_ns,
+		 u64 total_ns, int ret),
+
+	TP_ARGS(mm, nr_vmas, nr_copied, lock_ns, copy_ns, total_ns, ret),
+
+	TP_STRUCT__entry(
+		__field(	void *,		mm)
+		__field(	unsigned int,	nr_vmas)
+		__field(	unsigned int,	nr_copied)
+		__field(	u64,		lock_ns)
+		__field(	u64,		copy_ns)
+		__field(	u64,		total_ns)
+		__field(	int,		ret)
+	),
+
+	TP_fast_assign(
+		__entry->mm = mm;
+		__entry->nr_vmas = nr_vmas;
+		__entry->nr_copied = nr_copied;
+		__entry->lock_ns = lock_ns;
+		__entry->copy_ns = copy_ns;
+		__entry->total_ns = total_ns;
+		__entry->ret = ret;
+	),
+
+	TP_printk("mm=%p nr_vmas=%u nr_copied=%u lock_ns=%llu copy_ns=%llu total_ns=%llu ret=%d",
+		  __entry->mm, __entry->nr_vmas, __entry->nr_copied,
+		  __entry->lock_ns, __entry->copy_ns, __entry->total_ns,
+		  __entry->ret)
+);
+
 /**
  * task_prctl_unknown - called on unknown prctl() option
  * @option:	option passed
@@ -161,6 +161,8 @@ enum {
 	INET_DIAG_SK_BPF_STORAGES,
 	INET_DIAG_CGROUP_ID,
 	INET_DIAG_SOCKOPT,
+	INET_DIAG_PSOCK,
+	INET_DIAG_ACCEPTQ_SHARDS,	/* __u32 depth per possible CPU */
 	__INET_DIAG_MAX,
 };
 
@@ -201,6 +203,17 @@ struct inet_diag_sockopt {
 		unused:5;
 };
 
+/* INET_DIAG_PSOCK */
+
+struct inet_diag_psock {
+	__u64	psock_backlog_skbs;	/* skbs handled by the backlog worker */
+	__u64	psock_backlog_runs;	/* backlog worker runs */
+	__u64	psock_backlog_delay_ns;	/* sum of queueing to run delays */
+	__u64	psock_redirect_direct;	/* redirects that skipped the backlog */
+	__u32	psock_backlog_len;	/* skbs currently in the backlog */
+	__u32	psock_backlog_max;	/* max backlog length seen */
+};
+
 /* INET_DIAG_VEGASINFO */
 
 struct tcpvegas_info {
@@ -283,6 +283,9 @@ enum io_uring_op {
 	IORING_OP_EPOLL_WAIT,
 	IORING_OP_READV_FIXED,
 	IORING_OP_WRITEV_FIXED,
+	IORING_OP_READ_BATCH,
+	IORING_OP_GETDENTS,
+	IORING_OP_STATX_BATCH,
 
 	/* this goes last, obviously */
 	IORING_OP_LAST,
@@ -386,19 +389,28 @@ enum io_uring_op {
  *				the starting buffer ID in cqe->flags as per
  *				usual for provided buffer usage. The buffers
  *				will be	contiguous from the starting buffer ID.
+ *
+ * IORING_SEND_ZC_COALESCE	If set, SEND[MSG]_ZC notifications that
+ *				complete together, because the sends shared
+ *				an skb, are posted as one IORING_CQE_F_NOTIF
+ *				cqe. It carries the user_data of the first
+ *				send of the run, and cqe.res holds the number
+ *				of consecutive sends it covers.
  */
 #define IORING_RECVSEND_POLL_FIRST	(1U << 0)
 #define IORING_RECV_MULTISHOT		(1U << 1)
 #define IORING_RECVSEND_FIXED_BUF	(1U << 2)
 #define IORING_SEND_ZC_REPORT_USAGE	(1U << 3)
 #define IORING_RECVSEND_BUNDLE		(1U << 4)
+#define IORING_SEND_ZC_COALESCE		(1U << 5)
 
 /*
  * cqe.res for IORING_CQE_F_NOTIF if
  * IORING_SEND_ZC_REPORT_USAGE was requested
  *
  * It should be treated as a flag, all other
- * bits of cqe.res should be treated as reserved!
+ * bits of cqe.res should be treated as reserved, other
+ * than the count reported for IORING_SEND_ZC_COALESCE!
  */
 #define IORING_NOTIF_USAGE_ZC_COPIED    (1U << 31)
 
@@ -415,6 +427,19 @@ enum io_uring_op {
 enum io_uring_msg_ring_flags {
 	IORING_MSG_DATA,	/* pass sqe->len as 'res' and off as user_data */
 	IORING_MSG_SEND_FD,	/* send a registered fd to another ring */
+	IORING_MSG_DATA_VEC,	/* post sqe->len io_uring_msg's from off */
+};
+
+/*
+ * IORING_MSG_DATA_VEC entry, posted as one CQE on the target ring. flags
+ * is only passed through with IORING_MSG_RING_FLAGS_PASS. With
+ * IOSQE_CQE_SKIP_SUCCESS, the sender only gets a CQE if not every entry
+ * was posted.
+ */
+struct io_uring_msg {
+	__u64	user_data;
+	__s32	res;
+	__u32	flags;
 };
 
 /*
@@ -817,10 +842,21 @@ struct io_uring_buf_ring {
  *			use of it will consume only as much as it needs. This
  *			requires that both the kernel and application keep
  *			track of where the current read/recv index is at.
+ * IOU_PBUF_RING_SIZED:	All buffers in this ring are buf_size bytes. Makes
+ *			the ring usable as a size class.
+ * IOU_PBUF_RING_NEXT:	The ring is a size class and next_bgid is the ring
+ *			holding the next larger class. A recv selecting from
+ *			the smallest class picks the smallest class whose
+ *			buffers fit the data known to be queued and that
+ *			isn't empty, or else the largest one that isn't
+ *			empty. Buffer IDs should be unique across the
+ *			classes, the CQE only carries the buffer ID.
  */
 enum io_uring_register_pbuf_ring_flags {
 	IOU_PBUF_RING_MMAP	= 1,
 	IOU_PBUF_RING_INC	= 2,
+	IOU_PBUF_RING_SIZED	= 4,
+	IOU_PBUF_RING_NEXT	= 8,
 };
 
 /* argument for IORING_(UN)REGISTER_PBUF_RING */
@@ -829,14 +865,18 @@ struct io_uring_buf_reg {
 	__u32	ring_entries;
 	__u16	bgid;
 	__u16	flags;
-	__u64	resv[3];
+	__u32	buf_size;	/* IOU_PBUF_RING_SIZED */
+	__u16	next_bgid;	/* IOU_PBUF_RING_NEXT */
+	__u16	resv16;
+	__u64	resv[2];
 };
 
 /* argument for IORING_REGISTER_PBUF_STATUS */
 struct io_uring_buf_status {
 	__u32	buf_group;	/* input */
 	__u32	head;		/* output */
-	__u32	resv[8];
+	__u32	nr_exhausted;	/* output, size class found empty */
+	__u32	resv[7];
 };
 
 enum io_uring_napi_op {
@@ -852,6 +892,8 @@ enum io_uring_napi_tracking_strategy {
 	/* value must be 0 for backward compatibility */
 	IO_URING_NAPI_TRACKING_DYNAMIC = 0,
 	IO_URING_NAPI_TRACKING_STATIC = 1,
+	/* dynamic, but poll contexts that produce completions more often */
+	IO_URING_NAPI_TRACKING_ADAPTIVE = 2,
 	IO_URING_NAPI_TRACKING_INACTIVE = 255
 };
 
@@ -954,6 +996,34 @@ struct io_uring_recvmsg_out {
 	__u32 flags;
 };
 
+/*
+ * Argument for IORING_OP_READ_BATCH: sqe->addr points to an array of sqe->len
+ * of these. Each entry's result, bytes read or -errno, is stored in @res and
+ * the CQE res is the number of entries that succeeded.
+ */
+struct io_uring_read_batch_entry {
+	__s32	fd;
+	__s32	res;
+	__u64	off;
+	__u64	addr;
+	__u32	len;
+	__u32	resv;
+};
+
+/*
+ * Argument for IORING_OP_STATX_BATCH: sqe->addr points to an array of
+ * sqe->len of these, each a path looked up relative to sqe->fd with
+ * sqe->statx_flags and the statx mask in sqe->addr3. Each entry's result is
+ * stored in @res and the CQE res is the number of entries that succeeded.
+ * If the task is killed, the entries that were not looked up get -EINTR.
+ */
+struct io_uring_statx_entry {
+	__u64	path;
+	__u64	buf;
+	__s32	res;
+	__u32	resv;
+};
+
 /*
  * Argument for IORING_OP_URING_CMD when file is a socket
  */
@@ -984,7 +1054,7 @@ struct io_uring_zcrx_offsets {
 	__u32	head;
 	__u32	tail;
 	__u32	rqes;
-	__u32	__resv2;
+	__u32	rq_stride; /* distance between the refill rings of two rxqs */
 	__u64	__resv[2];
 };
 
@@ -1010,7 +1080,9 @@ struct io_uring_zcrx_ifq_reg {
 	__u64	region_ptr; /* struct io_uring_region_desc * */
 
 	struct io_uring_zcrx_offsets offsets;
-	__u64	__resv[4];
+	__u32	nr_rxqs; /* bind if_rxq .. if_rxq + nr_rxqs - 1, 0 means 1 */
+	__u32	__resv2;
+	__u64	__resv[3];
 };
 
 #ifdef __cplusplus
@@ -81,6 +81,7 @@ enum {
 	MPTCP_SUBFLOW_ATTR_ID_REM,
 	MPTCP_SUBFLOW_ATTR_ID_LOC,
 	MPTCP_SUBFLOW_ATTR_PAD,
+	MPTCP_SUBFLOW_ATTR_SCHED_COUNT,
 
 	__MPTCP_SUBFLOW_ATTR_MAX
 };
@@ -78,6 +78,9 @@ enum ovs_datapath_cmd {
  * datapath. Always present in notifications.
  * @OVS_DP_ATTR_IFINDEX: Interface index for a new datapath netdev. Only
  * valid for %OVS_DP_CMD_NEW requests.
+ * @OVS_DP_ATTR_MASKS_USAGE: Array of __u64 hit counts of the megaflow masks
+ * since they were last reordered, in lookup order.  Covers at most the first
+ * %OVS_DP_MASKS_USAGE_MAX masks.  Only present in replies.
  *
  * These attributes follow the &struct ovs_header within the Generic Netlink
  * payload for %OVS_DP_* commands.
@@ -95,11 +98,14 @@ enum ovs_datapath_attr {
 				     * per-cpu dispatch mode
 				     */
 	OVS_DP_ATTR_IFINDEX,
+	OVS_DP_ATTR_MASKS_USAGE,	/* array of u64 */
 	__OVS_DP_ATTR_MAX
 };
 
 #define OVS_DP_ATTR_MAX (__OVS_DP_ATTR_MAX - 1)
 
+#define OVS_DP_MASKS_USAGE_MAX 256
+
 struct ovs_dp_stats {
 	__u64 n_hit;             /* Number of flow table matches. */
 	__u64 n_missed;          /* Number of flow table misses. */
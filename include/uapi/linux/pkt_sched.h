@@ -446,6 +446,8 @@ struct tc_htb_xstats {
 	__u32 giants;	/* unused since 'Make HTB scheduler work with TSO.' */
 	__s32 tokens;
 	__s32 ctokens;
+	__u32 tokens_clamped;	/* rate debt beyond mbuffer was forgiven */
+	__u32 ctokens_clamped;	/* ceil debt beyond mbuffer was forgiven */
 };
 
 /* HFSC section */
@@ -838,6 +840,8 @@ enum {
 
 	TCA_FQ_OFFLOAD_HORIZON, /* dequeue paced packets within this horizon immediately (us units) */
 
+	TCA_FQ_TIMER_WHEEL,	/* timing wheel slot width for throttled flows (ns units, 0: disabled) */
+
 	__TCA_FQ_MAX
 };
 
@@ -866,6 +870,9 @@ struct tc_fq_qd_stats {
 	__u64	band_drops[FQ_BANDS];
 	__u32	band_pkt_count[FQ_BANDS];
 	__u32	pad;
+	__u64	wheel_slack_ns;		/* sum of delays added by wheel slots */
+	__u32	wheel_flows;		/* throttled flows on the timing wheel */
+	__u32	pad2;
 };
 
 /* Heavy-Hitter Filter */
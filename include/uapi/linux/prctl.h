@@ -364,4 +364,14 @@ struct prctl_mm_map {
 # define PR_TIMER_CREATE_RESTORE_IDS_ON		1
 # define PR_TIMER_CREATE_RESTORE_IDS_GET	2
 
+/*
+ * Set or get the priority khugepaged gives to this process when choosing
+ * which address space to scan for THP collapse.  0 is the default
+ * round-robin behaviour; higher values are scanned first and get a larger
+ * share of each scan pass.
+ */
+#define PR_SET_THP_COLLAPSE_PRIORITY		78
+#define PR_GET_THP_COLLAPSE_PRIORITY		79
+# define PR_THP_COLLAPSE_PRIORITY_MAX		7
+
 #endif /* _LINUX_PRCTL_H */
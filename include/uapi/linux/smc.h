@@ -227,6 +227,7 @@ enum {
 	SMC_NLA_STATS_RMB_REUSE_CNT,		/* u64 */
 	SMC_NLA_STATS_RMB_ALLOC_CNT,		/* u64 */
 	SMC_NLA_STATS_RMB_DGRADE_CNT,		/* u64 */
+	SMC_NLA_STATS_RMB_ALLOC_TIME_US,	/* u64 */
 	__SMC_NLA_STATS_RMB_MAX,
 	SMC_NLA_STATS_RMB_MAX = __SMC_NLA_STATS_RMB_MAX - 1
 };
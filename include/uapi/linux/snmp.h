@@ -304,6 +304,21 @@ enum
 	LINUX_MIB_TCPAOKEYNOTFOUND,		/* TCPAOKeyNotFound */
 	LINUX_MIB_TCPAOGOOD,			/* TCPAOGood */
 	LINUX_MIB_TCPAODROPPEDICMPS,		/* TCPAODroppedIcmps */
+	LINUX_MIB_TCPSACKSCOREBOARDACKS,	/* TCPSackScoreboardAcks */
+	LINUX_MIB_TCPSACKSCOREBOARDOPS,		/* TCPSackScoreboardOps */
+	LINUX_MIB_TCPGROACKCOALESCE,		/* TCPGROAckCoalesce */
+	LINUX_MIB_EPHEMERALPORTCONNECTS,	/* EphemeralPortConnects */
+	LINUX_MIB_EPHEMERALPORTPROBES,		/* EphemeralPortProbes */
+	LINUX_MIB_EPHEMERALPORTEXHAUSTED,	/* EphemeralPortExhausted */
+	LINUX_MIB_UDPREADERSPLICES,		/* UDPReaderSplices */
+	LINUX_MIB_UDPREADERSPLICEDPKTS,		/* UDPReaderSplicedPkts */
+	LINUX_MIB_FRAGEVICTED,			/* FragEvicted */
+	LINUX_MIB_FRAGEVICTEDAGEMSECS,		/* FragEvictedAgeMsecs */
+	LINUX_MIB_TCPBBRMODELUPDATES,		/* TCPBBRModelUpdates */
+	LINUX_MIB_TCPBBRMODELSKIPPED,		/* TCPBBRModelSkipped */
+	LINUX_MIB_TCPMETRICSLOCKCONTENDED,	/* TCPMetricsLockContended */
+	LINUX_MIB_TCACTCTFLOWTABLEHITS,		/* TCActCtFlowTableHits */
+	LINUX_MIB_TCACTCTFLOWTABLESEGS,		/* TCActCtFlowTableSegs */
 	__LINUX_MIB_MAX
 };
 
@@ -343,6 +358,8 @@ enum
 	LINUX_MIB_XFRMINSTATEDIRERROR,		/* XfrmInStateDirError */
 	LINUX_MIB_XFRMINIPTFSERROR,		/* XfrmInIptfsError */
 	LINUX_MIB_XFRMOUTNOQSPACE,		/* XfrmOutNoQueueSpace */
+	LINUX_MIB_XFRMPOLLOOKUPS,		/* XfrmPolicyLookups */
+	LINUX_MIB_XFRMPOLLOOKUPEVALS,		/* XfrmPolicyLookupEvals */
 	__LINUX_MIB_XFRMMAX
 };
 
@@ -367,6 +384,8 @@ enum
 	LINUX_MIB_TLSTXREKEYOK,			/* TlsTxRekeyOk */
 	LINUX_MIB_TLSTXREKEYERROR,		/* TlsTxRekeyError */
 	LINUX_MIB_TLSRXREKEYRECEIVED,		/* TlsRxRekeyReceived */
+	LINUX_MIB_TLSRXASYNCBATCHES,		/* TlsRxAsyncBatches */
+	LINUX_MIB_TLSRXASYNCRECORDS,		/* TlsRxAsyncRecords */
 	__LINUX_MIB_TLSMAX
 };
 
@@ -27,6 +27,20 @@ struct udphdr {
 	__sum16	check;
 };
 
+/*
+ * UDP_GRO_BPF takes the fd of a BPF_PROG_TYPE_SOCKET_FILTER program, or -1 to
+ * detach it. With UDP_GRO enabled the program runs on each datagram in GRO,
+ * with the data starting at the network header, and returns a coalescing key:
+ * a datagram only coalesces with a held packet of the same 4-tuple for which
+ * the program returned the same key, and a key of zero means don't coalesce.
+ */
+
+/* UDP_GRO_STATS */
+struct udp_gro_stats {
+	__u64	packets;	/* datagrams or GRO packets queued */
+	__u64	segments;	/* wire datagrams they carried */
+};
+
 /* UDP socket options */
 #define UDP_CORK	1	/* Never send partially complete segments */
 #define UDP_ENCAP	100	/* Set the socket to accept encapsulated packets */
@@ -34,6 +48,8 @@ struct udphdr {
 #define UDP_NO_CHECK6_RX 102	/* Disable accepting checksum for UDP6 */
 #define UDP_SEGMENT	103	/* Set GSO segmentation size */
 #define UDP_GRO		104	/* This socket can receive UDP GRO packets */
+#define UDP_GRO_BPF	105	/* BPF program returning the GRO coalescing key */
+#define UDP_GRO_STATS	106	/* struct udp_gro_stats, read only */
 
 /* UDP encapsulation types */
 #define UDP_ENCAP_ESPINUDP_NON_IKE	1 /* unused  draft-ietf-ipsec-nat-t-ike-00/01 */
@@ -14,6 +14,8 @@
 #include "fdinfo.h"
 #include "cancel.h"
 #include "rsrc.h"
+#include "zcrx.h"
+#include "tctx.h"
 
 #ifdef CONFIG_PROC_FS
 static __cold int io_uring_show_cred(struct seq_file *m, unsigned int id,
@@ -58,6 +60,10 @@ static __cold void common_tracking_show_fdinfo(struct io_ring_ctx *ctx,
 		seq_puts(m, "napi_prefer_busy_poll:\ttrue\n");
 	else
 		seq_puts(m, "napi_prefer_busy_poll:\tfalse\n");
+	seq_printf(m, "napi_polls:\t%lu\n", READ_ONCE(ctx->napi_polls));
+	if (READ_ONCE(ctx->napi_track_mode) == IO_URING_NAPI_TRACKING_ADAPTIVE)
+		seq_printf(m, "napi_useful_polls:\t%lu\n",
+			   READ_ONCE(ctx->napi_useful_polls));
 }
 
 static __cold void napi_show_fdinfo(struct io_ring_ctx *ctx,
@@ -75,6 +81,9 @@ static __cold void napi_show_fdinfo(struct io_ring_ctx *ctx,
 	case IO_URING_NAPI_TRACKING_STATIC:
 		common_tracking_show_fdinfo(ctx, m, "static");
 		break;
+	case IO_URING_NAPI_TRACKING_ADAPTIVE:
+		common_tracking_show_fdinfo(ctx, m, "adaptive");
+		break;
 	default:
 		seq_printf(m, "NAPI:\tunknown mode (%u)\n", mode);
 	}
@@ -106,6 +115,7 @@ __cold void io_uring_show_fdinfo(struct seq_file *m, struct file *file)
 	unsigned int sq_entries, cq_entries;
 	int sq_pid = -1, sq_cpu = -1;
 	u64 sq_total_time = 0, sq_work_time = 0;
+	unsigned long buf_pinned = 0;
 	bool has_lock;
 	unsigned int i;
 
@@ -205,6 +215,15 @@ __cold void io_uring_show_fdinfo(struct seq_file *m, struct file *file)
 	seq_printf(m, "SqThreadCpu:\t%d\n", sq_cpu);
 	seq_printf(m, "SqTotalTime:\t%llu\n", sq_total_time);
 	seq_printf(m, "SqWorkTime:\t%llu\n", sq_work_time);
+	if (ctx->flags & IORING_SETUP_SQPOLL)
+		seq_printf(m, "SqRingTime:\t%llu\n",
+			   div_u64(READ_ONCE(ctx->sq_ring_time), NSEC_PER_USEC));
+	seq_printf(m, "NotifMerged:\t%lu\n", atomic_long_read(&ctx->notif_merged));
+	seq_printf(m, "MsgRemote:\t%lu\n", READ_ONCE(ctx->msg_remote_nr));
+	seq_printf(m, "MsgRemoteTime:\t%llu\n",
+		   div_u64(READ_ONCE(ctx->msg_remote_time), NSEC_PER_USEC));
+	seq_printf(m, "MsgRemoteMax:\t%llu\n",
+		   div_u64(READ_ONCE(ctx->msg_remote_max), NSEC_PER_USEC));
 	seq_printf(m, "UserFiles:\t%u\n", ctx->file_table.data.nr);
 	for (i = 0; has_lock && i < ctx->file_table.data.nr; i++) {
 		struct file *f = NULL;
@@ -223,10 +242,22 @@ __cold void io_uring_show_fdinfo(struct seq_file *m, struct file *file)
 
 		if (ctx->buf_table.nodes[i])
 			buf = ctx->buf_table.nodes[i]->buf;
-		if (buf)
-			seq_printf(m, "%5u: 0x%llx/%u\n", i, buf->ubuf, buf->len);
-		else
+		if (buf) {
+			seq_printf(m, "%5u: 0x%llx/%u", i, buf->ubuf, buf->len);
+			if (!buf->is_kbuf)
+				seq_printf(m, ", bvecs:%u, pinned:%lu, folio_shift:%u",
+					   buf->nr_bvecs, buf->acct_pages,
+					   buf->folio_shift);
+			seq_puts(m, "\n");
+			buf_pinned += buf->is_kbuf ? 0 : buf->acct_pages;
+		} else {
 			seq_printf(m, "%5u: <none>\n", i);
+		}
+	}
+	if (has_lock) {
+		seq_printf(m, "UserBufsPinned:\t%lu\n", buf_pinned);
+		seq_printf(m, "UserBufsRegTime:\t%llu\n",
+			   div_u64(ctx->buf_reg_time, NSEC_PER_USEC));
 	}
 	if (has_lock && !xa_empty(&ctx->personalities)) {
 		unsigned long index;
@@ -247,8 +278,21 @@ __cold void io_uring_show_fdinfo(struct seq_file *m, struct file *file)
 					task_work_pending(req->tctx->task));
 	}
 
-	if (has_lock)
+	if (has_lock) {
+		struct io_tctx_node *node;
+
+		seq_puts(m, "IoWq:\n");
+		list_for_each_entry(node, &ctx->tctx_list, ctx_node) {
+			struct io_uring_task *tctx = node->task->io_uring;
+
+			if (!tctx || !tctx->io_wq)
+				continue;
+			seq_printf(m, "  task:%d\n", task_pid_nr(node->task));
+			io_wq_show_fdinfo(tctx->io_wq, m);
+		}
+		io_zcrx_show_fdinfo(ctx, m);
 		mutex_unlock(&ctx->uring_lock);
+	}
 
 	seq_puts(m, "CqOverflowList:\n");
 	spin_lock(&ctx->completion_lock);
@@ -17,6 +17,8 @@
 #include <linux/task_work.h>
 #include <linux/audit.h>
 #include <linux/mmu_context.h>
+#include <linux/seq_file.h>
+#include <linux/sched/clock.h>
 #include <uapi/linux/io_uring.h>
 
 #include "io-wq.h"
@@ -100,6 +102,13 @@ struct io_wq_acct {
 	raw_spinlock_t lock;
 	struct io_wq_work_list work_list;
 	unsigned long flags;
+
+	/* reported in fdinfo */
+	atomic_t nr_queued;
+	unsigned int max_queued;
+	atomic_long_t nr_done;
+	atomic64_t run_time;
+	u64 max_run_time;
 };
 
 enum {
@@ -277,23 +286,32 @@ static inline bool io_acct_run_queue(struct io_wq_acct *acct)
 }
 
 /*
- * Check head of free list for an available worker. If one isn't available,
- * caller must create one.
+ * Check free list for an available worker. If one isn't available, caller
+ * must create one. Workers that last ran on the local node are preferred,
+ * so work doesn't bounce across nodes while a local worker is idle; a remote
+ * one only picks up the work if none is.
  */
 static bool io_acct_activate_free_worker(struct io_wq_acct *acct)
 	__must_hold(RCU)
 {
 	struct hlist_nulls_node *n;
 	struct io_worker *worker;
+	int node = numa_node_id();
+	bool any_node = nr_node_ids == 1;
 
 	/*
 	 * Iterate free_list and see if we can find an idle worker to
 	 * activate. If a given worker is on the free_list but in the process
 	 * of exiting, keep trying.
 	 */
+again:
 	hlist_nulls_for_each_entry_rcu(worker, n, &acct->free_list, nulls_node) {
 		if (!io_worker_get(worker))
 			continue;
+		if (!any_node && cpu_to_node(task_cpu(worker->task)) != node) {
+			io_worker_release(worker);
+			continue;
+		}
 		/*
 		 * If the worker is already running, it's either already
 		 * starting work or finishing work. In either case, if it does
@@ -304,6 +322,10 @@ static bool io_acct_activate_free_worker(struct io_wq_acct *acct)
 		return true;
 	}
 
+	if (!any_node) {
+		any_node = true;
+		goto again;
+	}
 	return false;
 }
 
@@ -555,6 +577,14 @@ static void io_assign_current_work(struct io_worker *worker,
 	raw_spin_unlock(&worker->lock);
 }
 
+static void io_acct_account_run(struct io_wq_acct *acct, u64 delta)
+{
+	atomic_long_inc(&acct->nr_done);
+	atomic64_add(delta, &acct->run_time);
+	if (delta > READ_ONCE(acct->max_run_time))
+		WRITE_ONCE(acct->max_run_time, delta);
+}
+
 /*
  * Called with acct->lock held, drops it before returning
  */
@@ -564,6 +594,7 @@ static void io_worker_handle_work(struct io_wq_acct *acct,
 {
 	struct io_wq *wq = worker->wq;
 	bool do_kill = test_bit(IO_WQ_BIT_EXIT, &wq->state);
+	bool queued;
 
 	do {
 		struct io_wq_work *work;
@@ -600,26 +631,34 @@ static void io_worker_handle_work(struct io_wq_acct *acct,
 		__set_current_state(TASK_RUNNING);
 
 		/* handle a whole dependent link */
+		queued = true;
 		do {
 			struct io_wq_work *next_hashed, *linked;
 			unsigned int work_flags = atomic_read(&work->flags);
 			unsigned int hash = __io_wq_is_hashed(work_flags)
 				? __io_get_work_hash(work_flags)
 				: -1U;
+			u64 start;
 
 			next_hashed = wq_next_work(work);
 
 			if (do_kill &&
 			    (work_flags & IO_WQ_WORK_UNBOUND))
 				atomic_or(IO_WQ_WORK_CANCEL, &work->flags);
+			if (queued)
+				atomic_dec(&acct->nr_queued);
+			start = local_clock();
 			wq->do_work(work);
+			io_acct_account_run(acct, local_clock() - start);
 			io_assign_current_work(worker, NULL);
 
 			linked = wq->free_work(work);
 			work = next_hashed;
 			if (!work && linked && !io_wq_is_hashed(linked)) {
+				/* run directly, it never went through the queue */
 				work = linked;
 				linked = NULL;
+				queued = false;
 			}
 			io_assign_current_work(worker, work);
 			if (linked)
@@ -942,9 +981,13 @@ static void io_run_cancel(struct io_wq_work *work, struct io_wq *wq)
 static void io_wq_insert_work(struct io_wq *wq, struct io_wq_acct *acct,
 			      struct io_wq_work *work, unsigned int work_flags)
 {
-	unsigned int hash;
+	unsigned int hash, queued;
 	struct io_wq_work *tail;
 
+	queued = atomic_inc_return(&acct->nr_queued);
+	if (queued > acct->max_queued)
+		acct->max_queued = queued;
+
 	if (!__io_wq_is_hashed(work_flags)) {
 append:
 		wq_list_add_tail(&work->list, &acct->work_list);
@@ -1073,6 +1116,7 @@ static inline void io_wq_remove_pending(struct io_wq *wq,
 			wq->hash_tail[hash] = NULL;
 	}
 	wq_list_del(&acct->work_list, &work->list, prev);
+	atomic_dec(&acct->nr_queued);
 }
 
 static bool io_acct_cancel_pending_work(struct io_wq *wq,
@@ -1433,6 +1477,28 @@ int io_wq_max_workers(struct io_wq *wq, int *new_count)
 	return 0;
 }
 
+void io_wq_show_fdinfo(struct io_wq *wq, struct seq_file *m)
+{
+	static const char * const names[IO_WQ_ACCT_NR] = {
+		[IO_WQ_ACCT_BOUND]	= "bound",
+		[IO_WQ_ACCT_UNBOUND]	= "unbound",
+	};
+	int i;
+
+	for (i = 0; i < IO_WQ_ACCT_NR; i++) {
+		struct io_wq_acct *acct = &wq->acct[i];
+
+		seq_printf(m, "  %s: workers:%u/%u, running:%d, queued:%d, max_queued:%u, done:%lu, run_time:%llu, max_run_time:%llu\n",
+			   names[i], READ_ONCE(acct->nr_workers), acct->max_workers,
+			   atomic_read(&acct->nr_running),
+			   atomic_read(&acct->nr_queued),
+			   READ_ONCE(acct->max_queued),
+			   atomic_long_read(&acct->nr_done),
+			   div_u64(atomic64_read(&acct->run_time), NSEC_PER_USEC),
+			   div_u64(READ_ONCE(acct->max_run_time), NSEC_PER_USEC));
+	}
+}
+
 static __init int io_wq_init(void)
 {
 	int ret;
@@ -5,6 +5,7 @@
 #include <linux/io_uring_types.h>
 
 struct io_wq;
+struct seq_file;
 
 enum {
 	IO_WQ_WORK_CANCEL	= 1,
@@ -53,6 +54,7 @@ void io_wq_hash_work(struct io_wq_work *work, void *val);
 int io_wq_cpu_affinity(struct io_uring_task *tctx, cpumask_var_t mask);
 int io_wq_max_workers(struct io_wq *wq, int *new_count);
 bool io_wq_worker_stopped(void);
+void io_wq_show_fdinfo(struct io_wq *wq, struct seq_file *m);
 
 static inline bool __io_wq_is_hashed(unsigned int work_flags)
 {
@@ -846,6 +846,30 @@ bool io_post_aux_cqe(struct io_ring_ctx *ctx, u64 user_data, s32 res, u32 cflags
 	return filled;
 }
 
+/*
+ * Post a batch of aux CQEs under one completion lock and with one wakeup.
+ * Returns the number of CQEs posted, which is short of @nr only if an
+ * overflow entry couldn't be allocated.
+ */
+unsigned int io_post_aux_cqes(struct io_ring_ctx *ctx,
+			      const struct io_uring_msg *msgs, unsigned int nr)
+{
+	unsigned int i;
+
+	io_cq_lock(ctx);
+	for (i = 0; i < nr; i++) {
+		const struct io_uring_msg *msg = &msgs[i];
+
+		if (io_fill_cqe_aux(ctx, msg->user_data, msg->res, msg->flags))
+			continue;
+		if (!io_cqring_event_overflow(ctx, msg->user_data, msg->res,
+					      msg->flags, 0, 0))
+			break;
+	}
+	io_cq_unlock_post(ctx);
+	return i;
+}
+
 /*
  * Must be called from inline task_work so we now a flush will happen later,
  * and obviously with ctx->uring_lock held (tw always has that).
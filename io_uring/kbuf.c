@@ -20,6 +20,9 @@
 /* BIDs are addressed by a 16-bit field in a CQE */
 #define MAX_BIDS_PER_BGID (1 << 16)
 
+/* bounds a size class chain walk, the chain isn't checked for loops */
+#define IO_BUF_MAX_CLASSES	8
+
 /* Mapped buffer ring, return io_uring_buf from head */
 #define io_ring_head_to_buf(br, head, mask)	&(br)->bufs[(head) & (mask)]
 
@@ -192,8 +195,46 @@ static void __user *io_ring_buffer_select(struct io_kiocb *req, size_t *len,
 	return ret;
 }
 
-void __user *io_buffer_select(struct io_kiocb *req, size_t *len,
-			      unsigned int issue_flags)
+static inline bool io_ring_buffer_avail(struct io_buffer_list *bl)
+{
+	return smp_load_acquire(&bl->buf_ring->tail) != bl->head;
+}
+
+/*
+ * Walk the size classes starting at @bl, smallest first, and return the
+ * first one whose buffers fit @hint bytes and that has a buffer available.
+ * If none of those does, settle for the largest class that has one.
+ */
+static struct io_buffer_list *io_buffer_pick_class(struct io_ring_ctx *ctx,
+						   struct io_buffer_list *bl,
+						   size_t hint)
+{
+	struct io_buffer_list *fallback = NULL;
+	int i;
+
+	for (i = 0; i < IO_BUF_MAX_CLASSES; i++) {
+		struct io_buffer_list *next;
+
+		if (io_ring_buffer_avail(bl)) {
+			if (bl->buf_size >= hint)
+				return bl;
+			fallback = bl;
+		} else if (bl->buf_size >= hint) {
+			bl->nr_exhausted++;
+		}
+
+		if (!(bl->flags & IOBL_NEXT))
+			break;
+		next = io_buffer_get_list(ctx, bl->next_bgid);
+		if (!next || !(next->flags & IOBL_BUF_RING))
+			break;
+		bl = next;
+	}
+	return fallback ?: bl;
+}
+
+void __user *io_buffer_select_fit(struct io_kiocb *req, size_t *len,
+				  size_t hint, unsigned int issue_flags)
 {
 	struct io_ring_ctx *ctx = req->ctx;
 	struct io_buffer_list *bl;
@@ -203,6 +244,8 @@ void __user *io_buffer_select(struct io_kiocb *req, size_t *len,
 
 	bl = io_buffer_get_list(ctx, req->buf_index);
 	if (likely(bl)) {
+		if (bl->flags & IOBL_NEXT)
+			bl = io_buffer_pick_class(ctx, bl, hint);
 		if (bl->flags & IOBL_BUF_RING)
 			ret = io_ring_buffer_select(req, len, bl, issue_flags);
 		else
@@ -357,7 +400,7 @@ static inline bool __io_put_kbuf_ring(struct io_kiocb *req, int len, int nr)
 
 	if (bl) {
 		ret = io_kbuf_commit(req, bl, len, nr);
-		req->buf_index = bl->bgid;
+		req->buf_index = io_bl_group(bl);
 	}
 	req->flags &= ~REQ_F_BUFFER_RING;
 	return ret;
@@ -604,10 +647,27 @@ int io_register_pbuf_ring(struct io_ring_ctx *ctx, void __user *arg)
 	if (copy_from_user(&reg, arg, sizeof(reg)))
 		return -EFAULT;
 
-	if (reg.resv[0] || reg.resv[1] || reg.resv[2])
+	if (reg.resv[0] || reg.resv[1] || reg.resv16)
 		return -EINVAL;
-	if (reg.flags & ~(IOU_PBUF_RING_MMAP | IOU_PBUF_RING_INC))
+	if (reg.flags & ~(IOU_PBUF_RING_MMAP | IOU_PBUF_RING_INC |
+			  IOU_PBUF_RING_SIZED | IOU_PBUF_RING_NEXT))
 		return -EINVAL;
+	if (!(reg.flags & IOU_PBUF_RING_SIZED) && reg.buf_size)
+		return -EINVAL;
+	if ((reg.flags & IOU_PBUF_RING_SIZED) && !reg.buf_size)
+		return -EINVAL;
+	if (reg.flags & IOU_PBUF_RING_NEXT) {
+		struct io_buffer_list *next;
+
+		if (!(reg.flags & IOU_PBUF_RING_SIZED))
+			return -EINVAL;
+		next = io_buffer_get_list(ctx, reg.next_bgid);
+		if (!next || !(next->flags & IOBL_BUF_RING) ||
+		    next->flags & IOBL_CLASS || next->buf_size <= reg.buf_size)
+			return -EINVAL;
+	} else if (reg.next_bgid) {
+		return -EINVAL;
+	}
 	if (!is_power_of_2(reg.ring_entries))
 		return -EINVAL;
 	/* cannot disambiguate full vs empty due to head/tail size */
@@ -663,6 +723,22 @@ int io_register_pbuf_ring(struct io_ring_ctx *ctx, void __user *arg)
 	bl->buf_ring = br;
 	if (reg.flags & IOU_PBUF_RING_INC)
 		bl->flags |= IOBL_INC;
+	bl->buf_size = reg.buf_size;
+	if (reg.flags & IOU_PBUF_RING_NEXT) {
+		struct io_buffer_list *next = io_buffer_get_list(ctx, reg.next_bgid);
+		int i;
+
+		bl->flags |= IOBL_NEXT;
+		bl->next_bgid = reg.next_bgid;
+		/* larger classes complete into the group of the smallest one */
+		for (i = 0; next && i < IO_BUF_MAX_CLASSES; i++) {
+			next->flags |= IOBL_CLASS;
+			next->class_bgid = reg.bgid;
+			if (!(next->flags & IOBL_NEXT))
+				break;
+			next = io_buffer_get_list(ctx, next->next_bgid);
+		}
+	}
 	io_buffer_add_list(ctx, bl, reg.bgid);
 	return 0;
 fail:
@@ -671,6 +747,50 @@ int io_register_pbuf_ring(struct io_ring_ctx *ctx, void __user *arg)
 	return ret;
 }
 
+/*
+ * Take @bl out of its size class chain before it goes away. The class before
+ * it stops linking to it, and the class after it becomes the smallest class
+ * of the rest of the chain, so nothing keeps pointing at @bl.
+ */
+static void io_buffer_unlink_class(struct io_ring_ctx *ctx,
+				   struct io_buffer_list *bl)
+{
+	struct io_buffer_list *iter;
+	__u16 head;
+	int i;
+
+	if (bl->flags & IOBL_CLASS) {
+		iter = io_buffer_get_list(ctx, bl->class_bgid);
+		for (i = 0; iter && i < IO_BUF_MAX_CLASSES; i++) {
+			if (!(iter->flags & IOBL_NEXT))
+				break;
+			if (iter->next_bgid == bl->bgid) {
+				iter->flags &= ~IOBL_NEXT;
+				iter->next_bgid = 0;
+				break;
+			}
+			iter = io_buffer_get_list(ctx, iter->next_bgid);
+		}
+	}
+
+	if (!(bl->flags & IOBL_NEXT))
+		return;
+	iter = io_buffer_get_list(ctx, bl->next_bgid);
+	if (!iter)
+		return;
+	iter->flags &= ~IOBL_CLASS;
+	iter->class_bgid = 0;
+	head = iter->bgid;
+	for (i = 0; i < IO_BUF_MAX_CLASSES; i++) {
+		if (!(iter->flags & IOBL_NEXT))
+			break;
+		iter = io_buffer_get_list(ctx, iter->next_bgid);
+		if (!iter)
+			break;
+		iter->class_bgid = head;
+	}
+}
+
 int io_unregister_pbuf_ring(struct io_ring_ctx *ctx, void __user *arg)
 {
 	struct io_uring_buf_reg reg;
@@ -680,9 +800,9 @@ int io_unregister_pbuf_ring(struct io_ring_ctx *ctx, void __user *arg)
 
 	if (copy_from_user(&reg, arg, sizeof(reg)))
 		return -EFAULT;
-	if (reg.resv[0] || reg.resv[1] || reg.resv[2])
+	if (reg.resv[0] || reg.resv[1] || reg.resv16)
 		return -EINVAL;
-	if (reg.flags)
+	if (reg.flags || reg.buf_size || reg.next_bgid)
 		return -EINVAL;
 
 	bl = io_buffer_get_list(ctx, reg.bgid);
@@ -691,6 +811,7 @@ int io_unregister_pbuf_ring(struct io_ring_ctx *ctx, void __user *arg)
 	if (!(bl->flags & IOBL_BUF_RING))
 		return -EINVAL;
 
+	io_buffer_unlink_class(ctx, bl);
 	scoped_guard(mutex, &ctx->mmap_lock)
 		xa_erase(&ctx->io_bl_xa, bl->bgid);
 
@@ -718,6 +839,7 @@ int io_register_pbuf_status(struct io_ring_ctx *ctx, void __user *arg)
 		return -EINVAL;
 
 	buf_status.head = bl->head;
+	buf_status.nr_exhausted = bl->nr_exhausted;
 	if (copy_to_user(arg, &buf_status, sizeof(buf_status)))
 		return -EFAULT;
 
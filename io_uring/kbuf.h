@@ -10,6 +10,10 @@ enum {
 	IOBL_BUF_RING	= 1,
 	/* buffers are consumed incrementally rather than always fully */
 	IOBL_INC	= 2,
+	/* size class with a larger class in ->next_bgid */
+	IOBL_NEXT	= 4,
+	/* part of a size class chain starting at ->class_bgid */
+	IOBL_CLASS	= 8,
 };
 
 struct io_buffer_list {
@@ -31,6 +35,12 @@ struct io_buffer_list {
 
 	__u16 flags;
 
+	/* size classes, see IOU_PBUF_RING_SIZED */
+	__u16 next_bgid;
+	__u16 class_bgid;
+	__u32 buf_size;
+	__u32 nr_exhausted;
+
 	struct io_mapped_region region;
 };
 
@@ -57,8 +67,8 @@ struct buf_sel_arg {
 	unsigned short mode;
 };
 
-void __user *io_buffer_select(struct io_kiocb *req, size_t *len,
-			      unsigned int issue_flags);
+void __user *io_buffer_select_fit(struct io_kiocb *req, size_t *len,
+				  size_t hint, unsigned int issue_flags);
 int io_buffers_select(struct io_kiocb *req, struct buf_sel_arg *arg,
 		      unsigned int issue_flags);
 int io_buffers_peek(struct io_kiocb *req, struct buf_sel_arg *arg);
@@ -84,6 +94,18 @@ bool io_kbuf_commit(struct io_kiocb *req,
 struct io_mapped_region *io_pbuf_get_region(struct io_ring_ctx *ctx,
 					    unsigned int bgid);
 
+/* the group a request selected from, the smallest class for size classes */
+static inline unsigned int io_bl_group(struct io_buffer_list *bl)
+{
+	return bl->flags & IOBL_CLASS ? bl->class_bgid : bl->bgid;
+}
+
+static inline void __user *io_buffer_select(struct io_kiocb *req, size_t *len,
+					    unsigned int issue_flags)
+{
+	return io_buffer_select_fit(req, len, 0, issue_flags);
+}
+
 static inline bool io_kbuf_recycle_ring(struct io_kiocb *req)
 {
 	/*
@@ -94,7 +116,7 @@ static inline bool io_kbuf_recycle_ring(struct io_kiocb *req)
 	 * to monopolize the buffer.
 	 */
 	if (req->buf_list) {
-		req->buf_index = req->buf_list->bgid;
+		req->buf_index = io_bl_group(req->buf_list);
 		req->flags &= ~(REQ_F_BUFFER_RING|REQ_F_BUFFERS_COMMIT);
 		return true;
 	}
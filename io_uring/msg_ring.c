@@ -5,6 +5,7 @@
 #include <linux/slab.h>
 #include <linux/nospec.h>
 #include <linux/io_uring.h>
+#include <linux/sched/clock.h>
 
 #include <uapi/linux/io_uring.h>
 
@@ -18,6 +19,9 @@
 #define IORING_MSG_RING_MASK		(IORING_MSG_RING_CQE_SKIP | \
 					IORING_MSG_RING_FLAGS_PASS)
 
+/* Max number of CQEs a single IORING_MSG_DATA_VEC can post */
+#define IO_MSG_VEC_MAX			256
+
 struct io_msg {
 	struct file			*file;
 	struct file			*src_file;
@@ -33,6 +37,12 @@ struct io_msg {
 	u32 flags;
 };
 
+/* IORING_MSG_DATA_VEC payload, owned by the target kiocb if posted remotely */
+struct io_msg_vec {
+	unsigned int			nr;
+	struct io_uring_msg		msgs[] __counted_by(nr);
+};
+
 static void io_double_unlock_ctx(struct io_ring_ctx *octx)
 {
 	mutex_unlock(&octx->uring_lock);
@@ -71,11 +81,17 @@ static inline bool io_msg_need_remote(struct io_ring_ctx *target_ctx)
 	return target_ctx->task_complete;
 }
 
-static void io_msg_tw_complete(struct io_kiocb *req, io_tw_token_t tw)
+static void io_msg_tw_done(struct io_kiocb *req)
 {
 	struct io_ring_ctx *ctx = req->ctx;
+	u64 delay = local_clock() - req->msg_queued;
+
+	/* tw always runs with the target's uring_lock held */
+	ctx->msg_remote_nr++;
+	ctx->msg_remote_time += delay;
+	if (delay > ctx->msg_remote_max)
+		ctx->msg_remote_max = delay;
 
-	io_add_aux_cqe(ctx, req->cqe.user_data, req->cqe.res, req->cqe.flags);
 	if (spin_trylock(&ctx->msg_lock)) {
 		if (io_alloc_cache_put(&ctx->msg_cache, req))
 			req = NULL;
@@ -86,24 +102,52 @@ static void io_msg_tw_complete(struct io_kiocb *req, io_tw_token_t tw)
 	percpu_ref_put(&ctx->refs);
 }
 
-static int io_msg_remote_post(struct io_ring_ctx *ctx, struct io_kiocb *req,
-			      int res, u32 cflags, u64 user_data)
+static void io_msg_tw_complete(struct io_kiocb *req, io_tw_token_t tw)
+{
+	io_add_aux_cqe(req->ctx, req->cqe.user_data, req->cqe.res,
+		       req->cqe.flags);
+	io_msg_tw_done(req);
+}
+
+static void io_msg_tw_vec_complete(struct io_kiocb *req, io_tw_token_t tw)
+{
+	struct io_msg_vec *vec = req->async_data;
+	unsigned int i;
+
+	/* the flush at the end of this tw run posts them all at once */
+	for (i = 0; i < vec->nr; i++)
+		io_add_aux_cqe(req->ctx, vec->msgs[i].user_data,
+			       vec->msgs[i].res, vec->msgs[i].flags);
+	req->async_data = NULL;
+	kvfree(vec);
+	io_msg_tw_done(req);
+}
+
+static int io_msg_remote_queue(struct io_ring_ctx *ctx, struct io_kiocb *req,
+			       io_req_tw_func_t func)
 {
 	if (!READ_ONCE(ctx->submitter_task)) {
 		kmem_cache_free(req_cachep, req);
 		return -EOWNERDEAD;
 	}
 	req->opcode = IORING_OP_NOP;
-	req->cqe.user_data = user_data;
-	io_req_set_res(req, res, cflags);
 	percpu_ref_get(&ctx->refs);
 	req->ctx = ctx;
 	req->tctx = NULL;
-	req->io_task_work.func = io_msg_tw_complete;
+	req->msg_queued = local_clock();
+	req->io_task_work.func = func;
 	io_req_task_work_add_remote(req, IOU_F_TWQ_LAZY_WAKE);
 	return 0;
 }
 
+static int io_msg_remote_post(struct io_ring_ctx *ctx, struct io_kiocb *req,
+			      int res, u32 cflags, u64 user_data)
+{
+	req->cqe.user_data = user_data;
+	io_req_set_res(req, res, cflags);
+	return io_msg_remote_queue(ctx, req, io_msg_tw_complete);
+}
+
 static struct io_kiocb *io_msg_get_kiocb(struct io_ring_ctx *ctx)
 {
 	struct io_kiocb *req = NULL;
@@ -173,6 +217,83 @@ static int io_msg_ring_data(struct io_kiocb *req, unsigned int issue_flags)
 	return __io_msg_ring_data(target_ctx, msg, issue_flags);
 }
 
+static struct io_msg_vec *io_msg_import_vec(struct io_msg *msg)
+{
+	struct io_uring_msg __user *umsgs = u64_to_user_ptr(msg->user_data);
+	struct io_msg_vec *vec;
+	unsigned int i;
+
+	if (!msg->len || msg->len > IO_MSG_VEC_MAX)
+		return ERR_PTR(-EINVAL);
+
+	vec = kvmalloc(struct_size(vec, msgs, msg->len), GFP_KERNEL);
+	if (!vec)
+		return ERR_PTR(-ENOMEM);
+	vec->nr = msg->len;
+	if (copy_from_user(vec->msgs, umsgs,
+			   flex_array_size(vec, msgs, vec->nr))) {
+		kvfree(vec);
+		return ERR_PTR(-EFAULT);
+	}
+	if (!(msg->flags & IORING_MSG_RING_FLAGS_PASS)) {
+		for (i = 0; i < vec->nr; i++)
+			vec->msgs[i].flags = 0;
+	}
+	return vec;
+}
+
+/*
+ * Post a vector of data messages, waking the target once for all of them.
+ * Completes with the number of messages posted.
+ */
+static int __io_msg_ring_data_vec(struct io_ring_ctx *target_ctx,
+				  struct io_msg *msg, unsigned int issue_flags)
+{
+	struct io_msg_vec *vec;
+	unsigned int posted;
+
+	if (msg->src_fd || msg->dst_fd ||
+	    msg->flags & ~IORING_MSG_RING_FLAGS_PASS)
+		return -EINVAL;
+	if (target_ctx->flags & IORING_SETUP_R_DISABLED)
+		return -EBADFD;
+
+	vec = io_msg_import_vec(msg);
+	if (IS_ERR(vec))
+		return PTR_ERR(vec);
+
+	if (io_msg_need_remote(target_ctx)) {
+		struct io_kiocb *target = io_msg_get_kiocb(target_ctx);
+		int ret;
+
+		if (unlikely(!target)) {
+			kvfree(vec);
+			return -ENOMEM;
+		}
+		target->async_data = vec;
+		posted = vec->nr;
+		ret = io_msg_remote_queue(target_ctx, target,
+					  io_msg_tw_vec_complete);
+		if (ret) {
+			kvfree(vec);
+			return ret;
+		}
+		return posted;
+	}
+
+	if (target_ctx->flags & IORING_SETUP_IOPOLL) {
+		if (unlikely(io_lock_external_ctx(target_ctx, issue_flags))) {
+			kvfree(vec);
+			return -EAGAIN;
+		}
+	}
+	posted = io_post_aux_cqes(target_ctx, vec->msgs, vec->nr);
+	if (target_ctx->flags & IORING_SETUP_IOPOLL)
+		io_double_unlock_ctx(target_ctx);
+	kvfree(vec);
+	return posted ? posted : -EOVERFLOW;
+}
+
 static int io_msg_grab_file(struct io_kiocb *req, unsigned int issue_flags)
 {
 	struct io_msg *msg = io_kiocb_to_cmd(req, struct io_msg);
@@ -316,6 +437,13 @@ int io_msg_ring(struct io_kiocb *req, unsigned int issue_flags)
 	case IORING_MSG_SEND_FD:
 		ret = io_msg_send_fd(req, issue_flags);
 		break;
+	case IORING_MSG_DATA_VEC:
+		ret = __io_msg_ring_data_vec(req->file->private_data, msg,
+					     issue_flags);
+		/* Not all posted: fail links, and IOSQE_CQE_SKIP_SUCCESS */
+		if (ret >= 0 && ret != msg->len)
+			req_set_fail(req);
+		break;
 	default:
 		ret = -EINVAL;
 		break;
@@ -344,7 +472,7 @@ int io_uring_sync_msg_ring(struct io_uring_sqe *sqe)
 	 * Only data sending supported, not IORING_MSG_SEND_FD as that one
 	 * doesn't make sense without a source ring to send files from.
 	 */
-	if (io_msg.cmd != IORING_MSG_DATA)
+	if (io_msg.cmd != IORING_MSG_DATA && io_msg.cmd != IORING_MSG_DATA_VEC)
 		return -EINVAL;
 
 	CLASS(fd, f)(sqe->fd);
@@ -352,6 +480,9 @@ int io_uring_sync_msg_ring(struct io_uring_sqe *sqe)
 		return -EBADF;
 	if (!io_is_uring_fops(fd_file(f)))
 		return -EBADFD;
+	if (io_msg.cmd == IORING_MSG_DATA_VEC)
+		return __io_msg_ring_data_vec(fd_file(f)->private_data,
+					      &io_msg, IO_URING_F_UNLOCKED);
 	return  __io_msg_ring_data(fd_file(f)->private_data,
 				   &io_msg, IO_URING_F_UNLOCKED);
 }
@@ -8,6 +8,13 @@
 /* Timeout for cleanout of stale entries. */
 #define NAPI_TIMEOUT		(60 * SEC_CONVERSION)
 
+/* Adaptive tracking polls an idle entry at least every 1 << this passes */
+#define NAPI_MAX_BACKOFF	6
+
+/* __io_napi_do_busy_loop() results */
+#define NAPI_LOOP_STALE		1	/* some entries timed out */
+#define NAPI_LOOP_IDLE		2	/* every entry is fully backed off */
+
 struct io_napi_entry {
 	unsigned int		napi_id;
 	struct list_head	list;
@@ -15,6 +22,11 @@ struct io_napi_entry {
 	unsigned long		timeout;
 	struct hlist_node	node;
 
+	/* adaptive tracking: events seen, and as of the last poll */
+	unsigned long		events;
+	unsigned long		events_seen;
+	unsigned int		backoff;
+
 	struct rcu_head		rcu;
 };
 
@@ -38,7 +50,8 @@ static inline ktime_t net_to_ktime(unsigned long t)
 	return ns_to_ktime(t << 10);
 }
 
-int __io_napi_add_id(struct io_ring_ctx *ctx, unsigned int napi_id)
+int __io_napi_add_id(struct io_ring_ctx *ctx, unsigned int napi_id,
+		     bool event)
 {
 	struct hlist_head *hash_list;
 	struct io_napi_entry *e;
@@ -53,6 +66,8 @@ int __io_napi_add_id(struct io_ring_ctx *ctx, unsigned int napi_id)
 		e = io_napi_hash_find(hash_list, napi_id);
 		if (e) {
 			WRITE_ONCE(e->timeout, jiffies + NAPI_TIMEOUT);
+			if (event)
+				WRITE_ONCE(e->events, e->events + 1);
 			return -EEXIST;
 		}
 	}
@@ -63,6 +78,9 @@ int __io_napi_add_id(struct io_ring_ctx *ctx, unsigned int napi_id)
 
 	e->napi_id = napi_id;
 	e->timeout = jiffies + NAPI_TIMEOUT;
+	e->events = event;
+	e->events_seen = 0;
+	e->backoff = 0;
 
 	/*
 	 * guard(spinlock) is not used to manually unlock it before calling
@@ -122,12 +140,18 @@ static void __io_napi_remove_stale(struct io_ring_ctx *ctx)
 	}
 }
 
-static inline void io_napi_remove_stale(struct io_ring_ctx *ctx, bool is_stale)
+static inline void io_napi_remove_stale(struct io_ring_ctx *ctx,
+					unsigned int res)
 {
-	if (is_stale)
+	if (res & NAPI_LOOP_STALE)
 		__io_napi_remove_stale(ctx);
 }
 
+static inline void io_napi_stat_add(unsigned long *stat, unsigned long nr)
+{
+	WRITE_ONCE(*stat, *stat + nr);
+}
+
 static inline bool io_napi_busy_loop_timeout(ktime_t start_time,
 					     ktime_t bp)
 {
@@ -160,45 +184,105 @@ static bool io_napi_busy_loop_should_end(void *data,
 /*
  * never report stale entries
  */
-static bool static_tracking_do_busy_loop(struct io_ring_ctx *ctx,
-					 bool (*loop_end)(void *, unsigned long),
-					 void *loop_end_arg)
+static unsigned int
+static_tracking_do_busy_loop(struct io_ring_ctx *ctx,
+			     bool (*loop_end)(void *, unsigned long),
+			     void *loop_end_arg)
 {
 	struct io_napi_entry *e;
+	unsigned long polls = 0;
 
-	list_for_each_entry_rcu(e, &ctx->napi_list, list)
+	list_for_each_entry_rcu(e, &ctx->napi_list, list) {
 		napi_busy_loop_rcu(e->napi_id, loop_end, loop_end_arg,
 				   ctx->napi_prefer_busy_poll, BUSY_POLL_BUDGET);
-	return false;
+		polls++;
+	}
+	io_napi_stat_add(&ctx->napi_polls, polls);
+	return 0;
 }
 
-static bool
+static unsigned int
 dynamic_tracking_do_busy_loop(struct io_ring_ctx *ctx,
 			      bool (*loop_end)(void *, unsigned long),
 			      void *loop_end_arg)
 {
 	struct io_napi_entry *e;
-	bool is_stale = false;
+	unsigned long polls = 0;
+	unsigned int res = 0;
 
 	list_for_each_entry_rcu(e, &ctx->napi_list, list) {
 		napi_busy_loop_rcu(e->napi_id, loop_end, loop_end_arg,
 				   ctx->napi_prefer_busy_poll, BUSY_POLL_BUDGET);
+		polls++;
 
 		if (time_after(jiffies, READ_ONCE(e->timeout)))
-			is_stale = true;
+			res |= NAPI_LOOP_STALE;
 	}
+	io_napi_stat_add(&ctx->napi_polls, polls);
+	return res;
+}
+
+/*
+ * Like dynamic tracking, but an entry whose polls stop producing events
+ * for the ring is polled exponentially less often, down to once every
+ * 1 << NAPI_MAX_BACKOFF passes. An event seen since the last poll puts it
+ * back to being polled on every pass. Once every entry is fully backed
+ * off, the ring is idle and the busy loop can stop early.
+ */
+static unsigned int
+adaptive_tracking_do_busy_loop(struct io_ring_ctx *ctx,
+			       bool (*loop_end)(void *, unsigned long),
+			       void *loop_end_arg)
+{
+	unsigned int round = ctx->napi_round++;
+	unsigned long polls = 0, useful = 0;
+	unsigned int res = NAPI_LOOP_IDLE;
+	struct io_napi_entry *e;
+
+	list_for_each_entry_rcu(e, &ctx->napi_list, list) {
+		unsigned long events = READ_ONCE(e->events);
+
+		if (time_after(jiffies, READ_ONCE(e->timeout)))
+			res |= NAPI_LOOP_STALE;
+
+		if (events != e->events_seen) {
+			e->events_seen = events;
+			e->backoff = 0;
+			useful++;
+		} else if (round & ((1U << e->backoff) - 1)) {
+			/* Skipped this pass, but not idle until fully backed off */
+			if (e->backoff < NAPI_MAX_BACKOFF)
+				res &= ~NAPI_LOOP_IDLE;
+			continue;
+		} else if (e->backoff < NAPI_MAX_BACKOFF) {
+			e->backoff++;
+		}
 
-	return is_stale;
+		if (e->backoff < NAPI_MAX_BACKOFF)
+			res &= ~NAPI_LOOP_IDLE;
+		napi_busy_loop_rcu(e->napi_id, loop_end, loop_end_arg,
+				   ctx->napi_prefer_busy_poll, BUSY_POLL_BUDGET);
+		polls++;
+	}
+	io_napi_stat_add(&ctx->napi_polls, polls);
+	io_napi_stat_add(&ctx->napi_useful_polls, useful);
+	return res;
 }
 
-static inline bool
+static inline unsigned int
 __io_napi_do_busy_loop(struct io_ring_ctx *ctx,
 		       bool (*loop_end)(void *, unsigned long),
 		       void *loop_end_arg)
 {
-	if (READ_ONCE(ctx->napi_track_mode) == IO_URING_NAPI_TRACKING_STATIC)
+	switch (READ_ONCE(ctx->napi_track_mode)) {
+	case IO_URING_NAPI_TRACKING_STATIC:
 		return static_tracking_do_busy_loop(ctx, loop_end, loop_end_arg);
-	return dynamic_tracking_do_busy_loop(ctx, loop_end, loop_end_arg);
+	case IO_URING_NAPI_TRACKING_ADAPTIVE:
+		return adaptive_tracking_do_busy_loop(ctx, loop_end,
+						      loop_end_arg);
+	default:
+		return dynamic_tracking_do_busy_loop(ctx, loop_end, loop_end_arg);
+	}
 }
 
 static void io_napi_blocking_busy_loop(struct io_ring_ctx *ctx,
@@ -207,7 +291,7 @@ static void io_napi_blocking_busy_loop(struct io_ring_ctx *ctx,
 	unsigned long start_time = busy_loop_current_time();
 	bool (*loop_end)(void *, unsigned long) = NULL;
 	void *loop_end_arg = NULL;
-	bool is_stale = false;
+	unsigned int res = 0;
 
 	/* Singular lists use a different napi loop end check function and are
 	 * only executed once.
@@ -219,13 +303,13 @@ static void io_napi_blocking_busy_loop(struct io_ring_ctx *ctx,
 
 	scoped_guard(rcu) {
 		do {
-			is_stale = __io_napi_do_busy_loop(ctx, loop_end,
-							  loop_end_arg);
+			res = __io_napi_do_busy_loop(ctx, loop_end,
+						     loop_end_arg);
 		} while (!io_napi_busy_loop_should_end(iowq, start_time) &&
-			 !loop_end_arg);
+			 !loop_end_arg && !(res & NAPI_LOOP_IDLE));
 	}
 
-	io_napi_remove_stale(ctx, is_stale);
+	io_napi_remove_stale(ctx, res);
 }
 
 /*
@@ -269,12 +353,15 @@ static int io_napi_register_napi(struct io_ring_ctx *ctx,
 	switch (napi->op_param) {
 	case IO_URING_NAPI_TRACKING_DYNAMIC:
 	case IO_URING_NAPI_TRACKING_STATIC:
+	case IO_URING_NAPI_TRACKING_ADAPTIVE:
 		break;
 	default:
 		return -EINVAL;
 	}
 	/* clean the napi list for new settings */
 	io_napi_free(ctx);
+	WRITE_ONCE(ctx->napi_polls, 0);
+	WRITE_ONCE(ctx->napi_useful_polls, 0);
 	WRITE_ONCE(ctx->napi_track_mode, napi->op_param);
 	WRITE_ONCE(ctx->napi_busy_poll_dt, napi->busy_poll_to * NSEC_PER_USEC);
 	WRITE_ONCE(ctx->napi_prefer_busy_poll, !!napi->prefer_busy_poll);
@@ -313,7 +400,7 @@ int io_register_napi(struct io_ring_ctx *ctx, void __user *arg)
 	case IO_URING_NAPI_STATIC_ADD_ID:
 		if (curr.op_param != IO_URING_NAPI_TRACKING_STATIC)
 			return -EINVAL;
-		return __io_napi_add_id(ctx, napi.op_param);
+		return __io_napi_add_id(ctx, napi.op_param, false);
 	case IO_URING_NAPI_STATIC_DEL_ID:
 		if (curr.op_param != IO_URING_NAPI_TRACKING_STATIC)
 			return -EINVAL;
@@ -378,7 +465,7 @@ void __io_napi_busy_loop(struct io_ring_ctx *ctx, struct io_wait_queue *iowq)
  */
 int io_napi_sqpoll_busy_poll(struct io_ring_ctx *ctx)
 {
-	bool is_stale = false;
+	unsigned int res;
 
 	if (!READ_ONCE(ctx->napi_busy_poll_dt))
 		return 0;
@@ -386,10 +473,10 @@ int io_napi_sqpoll_busy_poll(struct io_ring_ctx *ctx)
 		return 0;
 
 	scoped_guard(rcu) {
-		is_stale = __io_napi_do_busy_loop(ctx, NULL, NULL);
+		res = __io_napi_do_busy_loop(ctx, NULL, NULL);
 	}
 
-	io_napi_remove_stale(ctx, is_stale);
+	io_napi_remove_stale(ctx, res);
 	return 1;
 }
 
@@ -15,7 +15,8 @@ void io_napi_free(struct io_ring_ctx *ctx);
 int io_register_napi(struct io_ring_ctx *ctx, void __user *arg);
 int io_unregister_napi(struct io_ring_ctx *ctx, void __user *arg);
 
-int __io_napi_add_id(struct io_ring_ctx *ctx, unsigned int napi_id);
+int __io_napi_add_id(struct io_ring_ctx *ctx, unsigned int napi_id,
+		     bool event);
 
 void __io_napi_busy_loop(struct io_ring_ctx *ctx, struct io_wait_queue *iowq);
 int io_napi_sqpoll_busy_poll(struct io_ring_ctx *ctx);
@@ -33,6 +34,21 @@ static inline void io_napi_busy_loop(struct io_ring_ctx *ctx,
 	__io_napi_busy_loop(ctx, iowq);
 }
 
+static inline void __io_napi_add(struct io_kiocb *req, bool event)
+{
+	struct io_ring_ctx *ctx = req->ctx;
+	unsigned int mode = READ_ONCE(ctx->napi_track_mode);
+	struct socket *sock;
+
+	if (mode != IO_URING_NAPI_TRACKING_DYNAMIC &&
+	    mode != IO_URING_NAPI_TRACKING_ADAPTIVE)
+		return;
+
+	sock = sock_from_file(req->file);
+	if (sock && sock->sk)
+		__io_napi_add_id(ctx, READ_ONCE(sock->sk->sk_napi_id), event);
+}
+
 /*
  * io_napi_add() - Add napi id to the busy poll list
  * @req: pointer to io_kiocb request
@@ -41,15 +57,19 @@ static inline void io_napi_busy_loop(struct io_ring_ctx *ctx,
  */
 static inline void io_napi_add(struct io_kiocb *req)
 {
-	struct io_ring_ctx *ctx = req->ctx;
-	struct socket *sock;
-
-	if (READ_ONCE(ctx->napi_track_mode) != IO_URING_NAPI_TRACKING_DYNAMIC)
-		return;
+	__io_napi_add(req, false);
+}
 
-	sock = sock_from_file(req->file);
-	if (sock && sock->sk)
-		__io_napi_add_id(ctx, READ_ONCE(sock->sk->sk_napi_id));
+/*
+ * io_napi_add_event() - Add napi id and credit it with an event
+ * @req: pointer to io_kiocb request that just got events
+ *
+ * Like io_napi_add(), but also tells adaptive tracking that polling this
+ * napi id produced work for the ring.
+ */
+static inline void io_napi_add_event(struct io_kiocb *req)
+{
+	__io_napi_add(req, true);
 }
 
 #else
@@ -75,6 +95,9 @@ static inline bool io_napi(struct io_ring_ctx *ctx)
 static inline void io_napi_add(struct io_kiocb *req)
 {
 }
+static inline void io_napi_add_event(struct io_kiocb *req)
+{
+}
 static inline void io_napi_busy_loop(struct io_ring_ctx *ctx,
 				     struct io_wait_queue *iowq)
 {
@@ -11,10 +11,42 @@
 
 static const struct ubuf_info_ops io_ubuf_ops;
 
+/*
+ * A chain is made of consecutive sends that shared the head's skb. Post a
+ * single CQE for it from the head, reporting how many sends it covers.
+ */
+static void io_notif_coalesce(struct io_kiocb *head)
+{
+	struct io_notif_data *nd = io_notif_to_data(head);
+	unsigned int nr = 0;
+	bool copied = false;
+
+	do {
+		struct io_kiocb *notif = cmd_to_io_kiocb(nd);
+
+		if (unlikely(nd->zc_report) && (nd->zc_copied || !nd->zc_used))
+			copied = true;
+		if (notif != head)
+			notif->flags |= REQ_F_CQE_SKIP;
+		nr++;
+		nd->zc_report = false;
+		nd = nd->next;
+	} while (nd);
+
+	head->cqe.res = nr;
+	if (copied)
+		head->cqe.res |= IORING_NOTIF_USAGE_ZC_COPIED;
+	if (nr > 1)
+		atomic_long_add(nr - 1, &head->ctx->notif_merged);
+}
+
 static void io_notif_tw_complete(struct io_kiocb *notif, io_tw_token_t tw)
 {
 	struct io_notif_data *nd = io_notif_to_data(notif);
 
+	if (nd->zc_coalesce)
+		io_notif_coalesce(notif);
+
 	do {
 		notif = cmd_to_io_kiocb(nd);
 
@@ -87,6 +119,10 @@ static int io_link_skb(struct sk_buff *skb, struct ubuf_info *uarg)
 	prev_nd = container_of(prev_uarg, struct io_notif_data, uarg);
 	prev_notif = cmd_to_io_kiocb(nd);
 
+	/* a chain is either coalesced as a whole or not at all */
+	if (nd->zc_coalesce != prev_nd->head->zc_coalesce)
+		return -EEXIST;
+
 	/* make sure all noifications can be finished in the same task_work */
 	if (unlikely(notif->ctx != prev_notif->ctx ||
 		     notif->tctx != prev_notif->tctx))
@@ -122,6 +158,7 @@ struct io_kiocb *io_alloc_notif(struct io_ring_ctx *ctx)
 
 	nd = io_notif_to_data(notif);
 	nd->zc_report = false;
+	nd->zc_coalesce = false;
 	nd->account_pages = 0;
 	nd->next = NULL;
 	nd->head = nd;
@@ -21,6 +21,7 @@ struct io_notif_data {
 	bool			zc_report;
 	bool			zc_used;
 	bool			zc_copied;
+	bool			zc_coalesce;
 };
 
 struct io_kiocb *io_alloc_notif(struct io_ring_ctx *ctx);
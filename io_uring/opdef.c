@@ -37,6 +37,8 @@
 #include "waitid.h"
 #include "futex.h"
 #include "truncate.h"
+#include "readbatch.h"
+#include "readdir.h"
 #include "zcrx.h"
 
 static int io_no_issue(struct io_kiocb *req, unsigned int issue_flags)
@@ -569,6 +571,21 @@ const struct io_issue_def io_issue_defs[] = {
 		.prep			= io_prep_writev_fixed,
 		.issue			= io_write,
 	},
+	[IORING_OP_READ_BATCH] = {
+		.audit_skip		= 1,
+		.prep			= io_read_batch_prep,
+		.issue			= io_read_batch,
+	},
+	[IORING_OP_GETDENTS] = {
+		.needs_file		= 1,
+		.prep			= io_getdents_prep,
+		.issue			= io_getdents,
+	},
+	[IORING_OP_STATX_BATCH] = {
+		.audit_skip		= 1,
+		.prep			= io_statx_batch_prep,
+		.issue			= io_statx_batch,
+	},
 };
 
 const struct io_cold_def io_cold_defs[] = {
@@ -815,6 +832,15 @@ const struct io_cold_def io_cold_defs[] = {
 		.cleanup		= io_readv_writev_cleanup,
 		.fail			= io_rw_fail,
 	},
+	[IORING_OP_READ_BATCH] = {
+		.name			= "READ_BATCH",
+	},
+	[IORING_OP_GETDENTS] = {
+		.name			= "GETDENTS",
+	},
+	[IORING_OP_STATX_BATCH] = {
+		.name			= "STATX_BATCH",
+	},
 };
 
 const char *io_uring_get_opcode(u8 opcode)
@@ -308,7 +308,7 @@ static int io_poll_check_events(struct io_kiocb *req, io_tw_token_t tw)
 		v &= IO_POLL_REF_MASK;
 	} while (atomic_sub_return(v, &req->poll_refs) & IO_POLL_REF_MASK);
 
-	io_napi_add(req);
+	io_napi_add_event(req);
 	return IOU_POLL_NO_ACTION;
 }
 
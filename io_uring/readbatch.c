@@ -0,0 +1,156 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * IORING_OP_READ_BATCH: read from many files in one request.
+ *
+ * Each entry is first read with IOCB_NOWAIT, which serves it from the page
+ * cache and starts readahead if it misses. Only if some entries missed is the
+ * request punted to io-wq, where those entries are read again, blocking, by
+ * which time the readahead started for all of them has been in flight.
+ * A nonblocking read that comes up short may only have run out of cached
+ * pages, so the remainder is read blocking too and a short read is reported
+ * only if that also stops early.
+ */
+#include <linux/kernel.h>
+#include <linux/errno.h>
+#include <linux/fs.h>
+#include <linux/file.h>
+#include <linux/fsnotify.h>
+#include <linux/uio.h>
+#include <linux/vmstat.h>
+#include <linux/io_uring.h>
+
+#include <uapi/linux/io_uring.h>
+
+#include "io_uring.h"
+#include "readbatch.h"
+
+#define IO_READ_BATCH_MAX	1024
+
+struct io_read_batch {
+	struct file				*file;
+	struct io_uring_read_batch_entry __user	*entries;
+	u32					nr;
+	/* the nonblocking pass ran, only its -EAGAIN and short entries remain */
+	bool					retry;
+};
+
+int io_read_batch_prep(struct io_kiocb *req, const struct io_uring_sqe *sqe)
+{
+	struct io_read_batch *rb = io_kiocb_to_cmd(req, struct io_read_batch);
+
+	if (sqe->off || sqe->rw_flags || sqe->buf_index ||
+	    sqe->splice_fd_in || sqe->addr3)
+		return -EINVAL;
+
+	rb->entries = u64_to_user_ptr(READ_ONCE(sqe->addr));
+	rb->nr = READ_ONCE(sqe->len);
+	if (!rb->nr || rb->nr > IO_READ_BATCH_MAX)
+		return -EINVAL;
+	rb->retry = false;
+	return 0;
+}
+
+static ssize_t io_read_batch_one(struct io_uring_read_batch_entry *e,
+				 size_t done, bool nonblock)
+{
+	struct iov_iter iter;
+	struct kiocb kiocb;
+	struct file *file;
+	ssize_t ret;
+
+	if (e->resv)
+		return -EINVAL;
+
+	file = fget(e->fd);
+	if (!file)
+		return -EBADF;
+
+	ret = -EBADF;
+	if (!(file->f_mode & FMODE_READ))
+		goto out;
+	ret = -EINVAL;
+	if (!file->f_op->read_iter)
+		goto out;
+	ret = -EAGAIN;
+	if (nonblock && !(file->f_mode & FMODE_NOWAIT))
+		goto out;
+	/* a short read from a stream is all there was, don't wait for more */
+	ret = 0;
+	if (done && (file->f_mode & FMODE_STREAM))
+		goto out;
+
+	ret = import_ubuf(ITER_DEST, u64_to_user_ptr(e->addr + done),
+			  e->len - done, &iter);
+	if (ret)
+		goto out;
+
+	init_sync_kiocb(&kiocb, file);
+	kiocb.ki_pos = e->off + done;
+	if (nonblock)
+		kiocb.ki_flags |= IOCB_NOWAIT;
+
+	ret = rw_verify_area(READ, file, &kiocb.ki_pos, e->len - done);
+	if (ret)
+		goto out;
+
+	ret = file->f_op->read_iter(&kiocb, &iter);
+	if (ret > 0)
+		fsnotify_access(file);
+out:
+	fput(file);
+	return ret;
+}
+
+int io_read_batch(struct io_kiocb *req, unsigned int issue_flags)
+{
+	struct io_read_batch *rb = io_kiocb_to_cmd(req, struct io_read_batch);
+	bool nonblock = issue_flags & IO_URING_F_NONBLOCK;
+	unsigned int i, nr_hit = 0, nr_miss = 0;
+	int nr_done = 0;
+
+	for (i = 0; i < rb->nr; i++) {
+		struct io_uring_read_batch_entry e;
+		size_t done = 0;
+		ssize_t ret;
+
+		if (copy_from_user(&e, &rb->entries[i], sizeof(e)))
+			goto fault;
+		if (rb->retry && e.res != -EAGAIN) {
+			if (e.res <= 0 || (u32)e.res >= e.len) {
+				nr_done += e.res >= 0;
+				continue;
+			}
+			/* short nonblocking read, fetch the rest blocking */
+			done = e.res;
+		}
+
+		ret = io_read_batch_one(&e, done, nonblock);
+		if (done)
+			ret = ret > 0 ? done + ret : done;
+		if (nonblock && (ret == -EAGAIN || (ret > 0 && ret < e.len)))
+			nr_miss++;
+		else if (nonblock)
+			nr_hit++;
+		if (ret >= 0)
+			nr_done++;
+
+		if (put_user((s32)min_t(ssize_t, ret, INT_MAX), &rb->entries[i].res))
+			goto fault;
+	}
+
+	if (nonblock) {
+		count_vm_events(PGCACHE_BATCH_HIT, nr_hit);
+		count_vm_events(PGCACHE_BATCH_MISS, nr_miss);
+		if (nr_miss) {
+			rb->retry = true;
+			return -EAGAIN;
+		}
+	}
+
+	io_req_set_res(req, nr_done, 0);
+	return IOU_OK;
+fault:
+	req_set_fail(req);
+	io_req_set_res(req, -EFAULT, 0);
+	return IOU_OK;
+}
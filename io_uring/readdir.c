@@ -0,0 +1,138 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * IORING_OP_GETDENTS: getdents64(2) on a directory file.
+ *
+ * Like the syscall this reads from, and advances, the file position of the
+ * directory, so a directory can be walked by issuing it until it returns 0.
+ */
+#include <linux/kernel.h>
+#include <linux/errno.h>
+#include <linux/fs.h>
+#include <linux/file.h>
+#include <linux/dirent.h>
+#include <linux/uaccess.h>
+#include <linux/io_uring.h>
+
+#include <uapi/linux/io_uring.h>
+
+#include "io_uring.h"
+#include "readdir.h"
+
+struct io_getdents {
+	struct file			*file;
+	struct linux_dirent64 __user	*dirent;
+	unsigned int			count;
+};
+
+struct io_getdents_callback {
+	struct dir_context		ctx;
+	struct linux_dirent64 __user	*current_dir;
+	int				prev_reclen;
+	int				count;
+	int				error;
+};
+
+static bool io_filldir64(struct dir_context *ctx, const char *name, int namlen,
+			 loff_t offset, u64 ino, unsigned int d_type)
+{
+	struct io_getdents_callback *buf =
+		container_of(ctx, struct io_getdents_callback, ctx);
+	struct linux_dirent64 __user *dirent, *prev;
+	int reclen = ALIGN(offsetof(struct linux_dirent64, d_name) + namlen + 1,
+			   sizeof(u64));
+	int prev_reclen;
+
+	/* see verify_dirent_name() */
+	if (WARN_ON_ONCE(!namlen || memchr(name, '/', namlen))) {
+		buf->error = -EIO;
+		return false;
+	}
+	buf->error = -EINVAL;	/* only used if we fail.. */
+	if (reclen > buf->count)
+		return false;
+	prev_reclen = buf->prev_reclen;
+	if (prev_reclen && signal_pending(current))
+		return false;
+	dirent = buf->current_dir;
+	prev = (void __user *)dirent - prev_reclen;
+	if (!user_write_access_begin(prev, reclen + prev_reclen))
+		goto efault;
+
+	/* This might be 'dirent->d_off', but if so it will get overwritten */
+	unsafe_put_user(offset, &prev->d_off, efault_end);
+	unsafe_put_user(ino, &dirent->d_ino, efault_end);
+	unsafe_put_user(reclen, &dirent->d_reclen, efault_end);
+	unsafe_put_user(d_type, &dirent->d_type, efault_end);
+	unsafe_copy_to_user(dirent->d_name, name, namlen, efault_end);
+	unsafe_put_user(0, dirent->d_name + namlen, efault_end);
+	user_write_access_end();
+
+	buf->prev_reclen = reclen;
+	buf->current_dir = (void __user *)dirent + reclen;
+	buf->count -= reclen;
+	return true;
+efault_end:
+	user_write_access_end();
+efault:
+	buf->error = -EFAULT;
+	return false;
+}
+
+int io_getdents_prep(struct io_kiocb *req, const struct io_uring_sqe *sqe)
+{
+	struct io_getdents *gd = io_kiocb_to_cmd(req, struct io_getdents);
+
+	if (sqe->off || sqe->rw_flags || sqe->buf_index ||
+	    sqe->splice_fd_in || sqe->addr3)
+		return -EINVAL;
+
+	gd->dirent = u64_to_user_ptr(READ_ONCE(sqe->addr));
+	gd->count = READ_ONCE(sqe->len);
+	if (gd->count > INT_MAX)
+		gd->count = INT_MAX;
+	if (!access_ok(gd->dirent, gd->count))
+		return -EFAULT;
+
+	/* iterate_dir() has no nonblocking mode */
+	req->flags |= REQ_F_FORCE_ASYNC;
+	return 0;
+}
+
+int io_getdents(struct io_kiocb *req, unsigned int issue_flags)
+{
+	struct io_getdents *gd = io_kiocb_to_cmd(req, struct io_getdents);
+	struct io_getdents_callback buf = {
+		.ctx.actor = io_filldir64,
+		.count = gd->count,
+		.current_dir = gd->dirent,
+	};
+	struct file *file = req->file;
+	bool pos_lock = file->f_mode & FMODE_ATOMIC_POS;
+	int ret;
+
+	WARN_ON_ONCE(issue_flags & IO_URING_F_NONBLOCK);
+
+	if (pos_lock)
+		mutex_lock(&file->f_pos_lock);
+	ret = iterate_dir(file, &buf.ctx);
+	if (pos_lock)
+		mutex_unlock(&file->f_pos_lock);
+
+	if (ret >= 0)
+		ret = buf.error;
+	if (buf.prev_reclen) {
+		struct linux_dirent64 __user *lastdirent;
+		typeof(lastdirent->d_off) d_off = buf.ctx.pos;
+
+		lastdirent = (void __user *)buf.current_dir - buf.prev_reclen;
+		if (put_user(d_off, &lastdirent->d_off))
+			ret = -EFAULT;
+		else
+			ret = gd->count - buf.count;
+	}
+
+	if (ret < 0)
+		req_set_fail(req);
+	io_req_set_res(req, ret, 0);
+	return IOU_OK;
+}
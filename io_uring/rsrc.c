@@ -8,6 +8,7 @@
 #include <linux/nospec.h>
 #include <linux/hugetlb.h>
 #include <linux/compat.h>
+#include <linux/sched/clock.h>
 #include <linux/io_uring.h>
 #include <linux/io_uring/cmd.h>
 
@@ -602,21 +603,14 @@ int io_sqe_buffers_unregister(struct io_ring_ctx *ctx)
  *
  * We check if the given compound head page has already been accounted, to
  * avoid double accounting it. This allows us to account the full size of the
- * page, not just the constituent pages of a huge page.
+ * page, not just the constituent pages of a huge page. Head pages of the
+ * buffer being registered are tracked in @seen by the caller, only previously
+ * registered buffers are searched here.
  */
-static bool headpage_already_acct(struct io_ring_ctx *ctx, struct page **pages,
-				  int nr_pages, struct page *hpage)
+static bool headpage_already_acct(struct io_ring_ctx *ctx, struct page *hpage)
 {
 	int i, j;
 
-	/* check current page array */
-	for (i = 0; i < nr_pages; i++) {
-		if (!PageCompound(pages[i]))
-			continue;
-		if (compound_head(pages[i]) == hpage)
-			return true;
-	}
-
 	/* check previously registered pages */
 	for (i = 0; i < ctx->buf_table.nr; i++) {
 		struct io_rsrc_node *node = ctx->buf_table.nodes[i];
@@ -640,8 +634,15 @@ static int io_buffer_account_pin(struct io_ring_ctx *ctx, struct page **pages,
 				 int nr_pages, struct io_mapped_ubuf *imu,
 				 struct page **last_hpage)
 {
+	struct xarray seen;
 	int i, ret;
 
+	/*
+	 * Searching the page array for every new head page is quadratic in
+	 * the number of huge pages, which dominates registering many GBs of
+	 * them. Remember the heads seen so far instead.
+	 */
+	xa_init(&seen);
 	imu->acct_pages = 0;
 	for (i = 0; i < nr_pages; i++) {
 		if (!PageCompound(pages[i])) {
@@ -653,11 +654,20 @@ static int io_buffer_account_pin(struct io_ring_ctx *ctx, struct page **pages,
 			if (hpage == *last_hpage)
 				continue;
 			*last_hpage = hpage;
-			if (headpage_already_acct(ctx, pages, i, hpage))
+			ret = xa_insert(&seen, page_to_pfn(hpage), hpage, GFP_KERNEL);
+			if (ret == -EBUSY)
+				continue;
+			if (ret) {
+				xa_destroy(&seen);
+				imu->acct_pages = 0;
+				return ret;
+			}
+			if (headpage_already_acct(ctx, hpage))
 				continue;
 			imu->acct_pages += page_size(hpage) >> PAGE_SHIFT;
 		}
 	}
+	xa_destroy(&seen);
 
 	if (!imu->acct_pages)
 		return 0;
@@ -844,6 +854,7 @@ int io_sqe_buffers_register(struct io_ring_ctx *ctx, void __user *arg,
 	struct io_rsrc_data data;
 	struct iovec fast_iov, *iov = &fast_iov;
 	const struct iovec __user *uvec;
+	u64 start = local_clock();
 	int i, ret;
 
 	BUILD_BUG_ON(IORING_MAX_REG_BUFFERS >= (1u << 16));
@@ -904,6 +915,8 @@ int io_sqe_buffers_register(struct io_ring_ctx *ctx, void __user *arg,
 	ctx->buf_table = data;
 	if (ret)
 		io_sqe_buffers_unregister(ctx);
+	else
+		ctx->buf_reg_time = local_clock() - start;
 	return ret;
 }
 
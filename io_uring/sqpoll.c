@@ -11,6 +11,7 @@
 #include <linux/audit.h>
 #include <linux/security.h>
 #include <linux/cpuset.h>
+#include <linux/sched/clock.h>
 #include <linux/io_uring.h>
 
 #include <uapi/linux/io_uring.h>
@@ -21,6 +22,7 @@
 
 #define IORING_SQPOLL_CAP_ENTRIES_VALUE 8
 #define IORING_TW_CAP_ENTRIES_VALUE	8
+#define IORING_SQPOLL_QUANTUM_NS	(50 * NSEC_PER_USEC)
 
 enum {
 	IO_SQ_THREAD_SHOULD_STOP = 0,
@@ -166,12 +168,26 @@ static int __io_sq_thread(struct io_ring_ctx *ctx, bool cap_entries)
 	int ret = 0;
 
 	to_submit = io_sqring_entries(ctx);
-	/* if we're handling multiple rings, cap submit size for fairness */
-	if (cap_entries && to_submit > IORING_SQPOLL_CAP_ENTRIES_VALUE)
-		to_submit = IORING_SQPOLL_CAP_ENTRIES_VALUE;
+
+	/*
+	 * If we're handling multiple rings, cap submit size and share the
+	 * thread's time between them: every pass hands each ring a quantum,
+	 * and a ring that overspent, e.g. because its requests are expensive
+	 * to issue, sits out passes until it is back in credit.
+	 */
+	if (cap_entries) {
+		ctx->sq_credit = min_t(s64, ctx->sq_credit + IORING_SQPOLL_QUANTUM_NS,
+				       IORING_SQPOLL_QUANTUM_NS);
+		if (ctx->sq_credit <= 0)
+			return to_submit ? 1 : 0;
+		if (to_submit > IORING_SQPOLL_CAP_ENTRIES_VALUE)
+			to_submit = IORING_SQPOLL_CAP_ENTRIES_VALUE;
+	}
 
 	if (to_submit || !wq_list_empty(&ctx->iopoll_list)) {
 		const struct cred *creds = NULL;
+		u64 start = local_clock();
+		s64 delta;
 
 		if (ctx->sq_creds != current_cred())
 			creds = override_creds(ctx->sq_creds);
@@ -193,11 +209,43 @@ static int __io_sq_thread(struct io_ring_ctx *ctx, bool cap_entries)
 			wake_up(&ctx->sqo_sq_wait);
 		if (creds)
 			revert_creds(creds);
+
+		delta = local_clock() - start;
+		WRITE_ONCE(ctx->sq_ring_time, ctx->sq_ring_time + delta);
+		if (cap_entries)
+			ctx->sq_credit -= delta;
 	}
 
 	return ret;
 }
 
+/*
+ * Track how far apart bursts of work arrive once the thread runs out of
+ * work, so that it doesn't keep a CPU busy for the full idle period when
+ * new work has consistently been arriving later than that.
+ */
+static void io_sqd_update_idle(struct io_sq_data *sqd, bool busy)
+{
+	if (busy) {
+		if (sqd->idling) {
+			unsigned long gap = jiffies - sqd->idle_start;
+
+			sqd->idle_gap_avg = (sqd->idle_gap_avg * 7 + gap) / 8;
+			sqd->idling = false;
+		}
+	} else if (!sqd->idling) {
+		sqd->idle_start = jiffies;
+		sqd->idling = true;
+	}
+}
+
+static unsigned long io_sqd_idle_timeout(struct io_sq_data *sqd)
+{
+	if (sqd->idle_gap_avg > 2 * sqd->sq_thread_idle)
+		return jiffies + max(sqd->sq_thread_idle / 4, 1U);
+	return jiffies + sqd->sq_thread_idle;
+}
+
 static bool io_sqd_handle_event(struct io_sq_data *sqd)
 {
 	bool did_sig = false;
@@ -303,7 +351,7 @@ static int io_sq_thread(void *data)
 		if (io_sqd_events_pending(sqd) || signal_pending(current)) {
 			if (io_sqd_handle_event(sqd))
 				break;
-			timeout = jiffies + sqd->sq_thread_idle;
+			timeout = io_sqd_idle_timeout(sqd);
 		}
 
 		cap_entries = !list_is_singular(&sqd->ctx_list);
@@ -321,10 +369,11 @@ static int io_sq_thread(void *data)
 			if (io_napi(ctx))
 				io_napi_sqpoll_busy_poll(ctx);
 
+		io_sqd_update_idle(sqd, sqt_spin);
 		if (sqt_spin || !time_after(jiffies, timeout)) {
 			if (sqt_spin) {
 				io_sq_update_worktime(sqd, &start);
-				timeout = jiffies + sqd->sq_thread_idle;
+				timeout = io_sqd_idle_timeout(sqd);
 			}
 			if (unlikely(need_resched())) {
 				mutex_unlock(&sqd->lock);
@@ -372,7 +421,7 @@ static int io_sq_thread(void *data)
 		}
 
 		finish_wait(&sqd->wait, &wait);
-		timeout = jiffies + sqd->sq_thread_idle;
+		timeout = io_sqd_idle_timeout(sqd);
 	}
 
 	if (retry_list)
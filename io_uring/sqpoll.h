@@ -17,6 +17,10 @@ struct io_sq_data {
 	pid_t			task_tgid;
 
 	u64			work_time;
+	/* average jiffies between new work after going idle */
+	unsigned long		idle_gap_avg;
+	unsigned long		idle_start;
+	bool			idling;
 	unsigned long		state;
 	struct completion	exited;
 };
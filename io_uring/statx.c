@@ -20,6 +20,17 @@ struct io_statx {
 	struct statx __user		*buffer;
 };
 
+#define IO_STATX_BATCH_MAX	1024
+
+struct io_statx_batch {
+	struct file				*file;
+	int					dfd;
+	unsigned int				mask;
+	unsigned int				flags;
+	u32					nr;
+	struct io_uring_statx_entry __user	*entries;
+};
+
 int io_statx_prep(struct io_kiocb *req, const struct io_uring_sqe *sqe)
 {
 	struct io_statx *sx = io_kiocb_to_cmd(req, struct io_statx);
@@ -69,3 +80,85 @@ void io_statx_cleanup(struct io_kiocb *req)
 	if (sx->filename)
 		putname(sx->filename);
 }
+
+int io_statx_batch_prep(struct io_kiocb *req, const struct io_uring_sqe *sqe)
+{
+	struct io_statx_batch *sb = io_kiocb_to_cmd(req, struct io_statx_batch);
+
+	if (sqe->off || sqe->buf_index || sqe->splice_fd_in || sqe->addr2)
+		return -EINVAL;
+	if (req->flags & REQ_F_FIXED_FILE)
+		return -EBADF;
+
+	sb->dfd = READ_ONCE(sqe->fd);
+	sb->entries = u64_to_user_ptr(READ_ONCE(sqe->addr));
+	sb->nr = READ_ONCE(sqe->len);
+	sb->flags = READ_ONCE(sqe->statx_flags);
+	sb->mask = READ_ONCE(sqe->addr3);
+	if (!sb->nr || sb->nr > IO_STATX_BATCH_MAX)
+		return -EINVAL;
+
+	req->flags |= REQ_F_FORCE_ASYNC;
+	return 0;
+}
+
+static int io_statx_batch_one(struct io_statx_batch *sb,
+			      struct io_uring_statx_entry *e)
+{
+	struct filename *filename;
+	int ret;
+
+	if (e->resv)
+		return -EINVAL;
+
+	filename = getname_uflags(u64_to_user_ptr(e->path), sb->flags);
+	if (IS_ERR(filename))
+		return PTR_ERR(filename);
+	ret = do_statx(sb->dfd, filename, sb->flags, sb->mask,
+		       u64_to_user_ptr(e->buf));
+	putname(filename);
+	return ret;
+}
+
+/*
+ * Unlike a chain of IORING_OP_STATX, all lookups in the batch run from one
+ * io-wq work item, and the directory dentries they share stay hot in cache.
+ */
+int io_statx_batch(struct io_kiocb *req, unsigned int issue_flags)
+{
+	struct io_statx_batch *sb = io_kiocb_to_cmd(req, struct io_statx_batch);
+	int nr_done = 0;
+	unsigned int i;
+
+	WARN_ON_ONCE(issue_flags & IO_URING_F_NONBLOCK);
+
+	for (i = 0; i < sb->nr; i++) {
+		struct io_uring_statx_entry e;
+		int ret;
+
+		if (copy_from_user(&e, &sb->entries[i], sizeof(e)))
+			goto fault;
+		ret = io_statx_batch_one(sb, &e);
+		if (!ret)
+			nr_done++;
+		if (put_user(ret, &sb->entries[i].res))
+			goto fault;
+		if (fatal_signal_pending(current))
+			break;
+	}
+
+	if (i < sb->nr) {
+		/* killed, leave no entry with a stale result behind */
+		while (++i < sb->nr) {
+			if (put_user(-EINTR, &sb->entries[i].res))
+				goto fault;
+		}
+		req_set_fail(req);
+	}
+	io_req_set_res(req, nr_done, 0);
+	return IOU_OK;
+fault:
+	req_set_fail(req);
+	io_req_set_res(req, -EFAULT, 0);
+	return IOU_OK;
+}
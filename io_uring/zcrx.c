@@ -8,6 +8,7 @@
 #include <linux/netdevice.h>
 #include <linux/rtnetlink.h>
 #include <linux/skbuff_ref.h>
+#include <linux/seq_file.h>
 
 #include <net/page_pool/helpers.h>
 #include <net/page_pool/memory_provider.h>
@@ -94,6 +95,7 @@ static void io_zcrx_sync_for_device(const struct page_pool *pool,
 }
 
 #define IO_RQ_MAX_ENTRIES		32768
+#define IO_ZCRX_MAX_RXQS		64
 
 #define IO_SKBS_PER_CALL_LIMIT	20
 
@@ -142,16 +144,30 @@ static inline struct page *io_zcrx_iov_page(const struct net_iov *niov)
 	return area->pages[net_iov_idx(niov)];
 }
 
+static inline struct io_zcrx_ifq *io_pp_to_ifq(const struct page_pool *pp)
+{
+	struct io_zcrx_rxq *rxq = pp->mp_priv;
+
+	return rxq->ifq;
+}
+
+/*
+ * All refill rings live in the one zcrx region, one after another and
+ * rq_stride bytes apart.
+ */
 static int io_allocate_rbuf_ring(struct io_zcrx_ifq *ifq,
 				 struct io_uring_zcrx_ifq_reg *reg,
 				 struct io_uring_region_desc *rd)
 {
-	size_t off, size;
+	size_t off, stride, size;
 	void *ptr;
-	int ret;
+	int i, ret;
 
 	off = sizeof(struct io_uring);
-	size = off + sizeof(struct io_uring_zcrx_rqe) * reg->rq_entries;
+	stride = off + sizeof(struct io_uring_zcrx_rqe) * reg->rq_entries;
+	if (ifq->nr_rxqs > 1)
+		stride = ALIGN(stride, SMP_CACHE_BYTES);
+	size = stride * ifq->nr_rxqs;
 	if (size > rd->size)
 		return -EINVAL;
 
@@ -161,16 +177,25 @@ static int io_allocate_rbuf_ring(struct io_zcrx_ifq *ifq,
 		return ret;
 
 	ptr = io_region_get_ptr(&ifq->ctx->zcrx_region);
-	ifq->rq_ring = (struct io_uring *)ptr;
-	ifq->rqes = (struct io_uring_zcrx_rqe *)(ptr + off);
+	for (i = 0; i < ifq->nr_rxqs; i++) {
+		struct io_zcrx_rxq *rxq = &ifq->rxqs[i];
+
+		rxq->rq_ring = (struct io_uring *)(ptr + i * stride);
+		rxq->rqes = (struct io_uring_zcrx_rqe *)(ptr + i * stride + off);
+	}
+	reg->offsets.rq_stride = stride;
 	return 0;
 }
 
 static void io_free_rbuf_ring(struct io_zcrx_ifq *ifq)
 {
+	int i;
+
 	io_free_region(ifq->ctx, &ifq->ctx->zcrx_region);
-	ifq->rq_ring = NULL;
-	ifq->rqes = NULL;
+	for (i = 0; i < ifq->nr_rxqs; i++) {
+		ifq->rxqs[i].rq_ring = NULL;
+		ifq->rxqs[i].rqes = NULL;
+	}
 }
 
 static void io_zcrx_free_area(struct io_zcrx_area *area)
@@ -262,18 +287,26 @@ static int io_zcrx_create_area(struct io_zcrx_ifq *ifq,
 	return ret;
 }
 
-static struct io_zcrx_ifq *io_zcrx_ifq_alloc(struct io_ring_ctx *ctx)
+static struct io_zcrx_ifq *io_zcrx_ifq_alloc(struct io_ring_ctx *ctx,
+					     u32 nr_rxqs)
 {
 	struct io_zcrx_ifq *ifq;
+	int i;
 
-	ifq = kzalloc(sizeof(*ifq), GFP_KERNEL);
+	ifq = kzalloc(struct_size(ifq, rxqs, nr_rxqs), GFP_KERNEL);
 	if (!ifq)
 		return NULL;
 
-	ifq->if_rxq = -1;
+	ifq->nr_rxqs = nr_rxqs;
+	for (i = 0; i < nr_rxqs; i++) {
+		struct io_zcrx_rxq *rxq = &ifq->rxqs[i];
+
+		rxq->ifq = ifq;
+		rxq->if_rxq = -1;
+		spin_lock_init(&rxq->rq_lock);
+	}
 	ifq->ctx = ctx;
 	spin_lock_init(&ifq->lock);
-	spin_lock_init(&ifq->rq_lock);
 	return ifq;
 }
 
@@ -287,16 +320,13 @@ static void io_zcrx_drop_netdev(struct io_zcrx_ifq *ifq)
 	spin_unlock(&ifq->lock);
 }
 
-static void io_close_queue(struct io_zcrx_ifq *ifq)
+static void io_close_queues(struct io_zcrx_ifq *ifq)
 {
 	struct net_device *netdev;
 	netdevice_tracker netdev_tracker;
-	struct pp_memory_provider_params p = {
-		.mp_ops = &io_uring_pp_zc_ops,
-		.mp_priv = ifq,
-	};
+	int i;
 
-	if (ifq->if_rxq == -1)
+	if (ifq->rxqs[0].if_rxq == -1)
 		return;
 
 	spin_lock(&ifq->lock);
@@ -305,16 +335,27 @@ static void io_close_queue(struct io_zcrx_ifq *ifq)
 	ifq->netdev = NULL;
 	spin_unlock(&ifq->lock);
 
-	if (netdev) {
-		net_mp_close_rxq(netdev, ifq->if_rxq, &p);
-		netdev_put(netdev, &netdev_tracker);
+	for (i = 0; i < ifq->nr_rxqs; i++) {
+		struct io_zcrx_rxq *rxq = &ifq->rxqs[i];
+		struct pp_memory_provider_params p = {
+			.mp_ops = &io_uring_pp_zc_ops,
+			.mp_priv = rxq,
+		};
+
+		if (rxq->if_rxq == -1)
+			break;
+		if (netdev)
+			net_mp_close_rxq(netdev, rxq->if_rxq, &p);
+		rxq->if_rxq = -1;
 	}
-	ifq->if_rxq = -1;
+
+	if (netdev)
+		netdev_put(netdev, &netdev_tracker);
 }
 
 static void io_zcrx_ifq_free(struct io_zcrx_ifq *ifq)
 {
-	io_close_queue(ifq);
+	io_close_queues(ifq);
 	io_zcrx_drop_netdev(ifq);
 
 	if (ifq->area)
@@ -334,7 +375,8 @@ int io_register_zcrx_ifq(struct io_ring_ctx *ctx,
 	struct io_uring_zcrx_ifq_reg reg;
 	struct io_uring_region_desc rd;
 	struct io_zcrx_ifq *ifq;
-	int ret;
+	u32 nr_rxqs;
+	int i, ret;
 
 	/*
 	 * 1. Interface queue allocation.
@@ -353,10 +395,13 @@ int io_register_zcrx_ifq(struct io_ring_ctx *ctx,
 		return -EFAULT;
 	if (copy_from_user(&rd, u64_to_user_ptr(reg.region_ptr), sizeof(rd)))
 		return -EFAULT;
-	if (memchr_inv(&reg.__resv, 0, sizeof(reg.__resv)))
+	if (memchr_inv(&reg.__resv, 0, sizeof(reg.__resv)) || reg.__resv2)
 		return -EINVAL;
 	if (reg.if_rxq == -1 || !reg.rq_entries || reg.flags)
 		return -EINVAL;
+	nr_rxqs = reg.nr_rxqs ?: 1;
+	if (nr_rxqs > IO_ZCRX_MAX_RXQS || reg.if_rxq + nr_rxqs < reg.if_rxq)
+		return -EINVAL;
 	if (reg.rq_entries > IO_RQ_MAX_ENTRIES) {
 		if (!(ctx->flags & IORING_SETUP_CLAMP))
 			return -EINVAL;
@@ -367,7 +412,7 @@ int io_register_zcrx_ifq(struct io_ring_ctx *ctx,
 	if (copy_from_user(&area, u64_to_user_ptr(reg.area_ptr), sizeof(area)))
 		return -EFAULT;
 
-	ifq = io_zcrx_ifq_alloc(ctx);
+	ifq = io_zcrx_ifq_alloc(ctx, nr_rxqs);
 	if (!ifq)
 		return -ENOMEM;
 
@@ -397,12 +442,17 @@ int io_register_zcrx_ifq(struct io_ring_ctx *ctx,
 	if (ret)
 		goto err;
 
-	mp_param.mp_ops = &io_uring_pp_zc_ops;
-	mp_param.mp_priv = ifq;
-	ret = net_mp_open_rxq(ifq->netdev, reg.if_rxq, &mp_param);
-	if (ret)
-		goto err;
-	ifq->if_rxq = reg.if_rxq;
+	ifq->first_rxq = reg.if_rxq;
+	for (i = 0; i < ifq->nr_rxqs; i++) {
+		struct io_zcrx_rxq *rxq = &ifq->rxqs[i];
+
+		mp_param.mp_ops = &io_uring_pp_zc_ops;
+		mp_param.mp_priv = rxq;
+		ret = net_mp_open_rxq(ifq->netdev, reg.if_rxq + i, &mp_param);
+		if (ret)
+			goto err;
+		rxq->if_rxq = reg.if_rxq + i;
+	}
 
 	reg.offsets.rqes = sizeof(struct io_uring);
 	reg.offsets.head = offsetof(struct io_uring, head);
@@ -493,43 +543,48 @@ void io_shutdown_zcrx_ifqs(struct io_ring_ctx *ctx)
 	if (!ctx->ifq)
 		return;
 	io_zcrx_scrub(ctx->ifq);
-	io_close_queue(ctx->ifq);
+	io_close_queues(ctx->ifq);
 }
 
-static inline u32 io_zcrx_rqring_entries(struct io_zcrx_ifq *ifq)
+static inline u32 io_zcrx_rqring_entries(struct io_zcrx_rxq *rxq)
 {
 	u32 entries;
 
-	entries = smp_load_acquire(&ifq->rq_ring->tail) - ifq->cached_rq_head;
-	return min(entries, ifq->rq_entries);
+	entries = smp_load_acquire(&rxq->rq_ring->tail) - rxq->cached_rq_head;
+	return min(entries, rxq->ifq->rq_entries);
 }
 
-static struct io_uring_zcrx_rqe *io_zcrx_get_rqe(struct io_zcrx_ifq *ifq,
+static struct io_uring_zcrx_rqe *io_zcrx_get_rqe(struct io_zcrx_rxq *rxq,
 						 unsigned mask)
 {
-	unsigned int idx = ifq->cached_rq_head++ & mask;
+	unsigned int idx = rxq->cached_rq_head++ & mask;
 
-	return &ifq->rqes[idx];
+	return &rxq->rqes[idx];
 }
 
+/*
+ * Buffers may be returned through the refill ring of any rxq; ones that
+ * belong to another queue's page pool are handed back to it.
+ */
 static void io_zcrx_ring_refill(struct page_pool *pp,
-				struct io_zcrx_ifq *ifq)
+				struct io_zcrx_rxq *rxq)
 {
+	struct io_zcrx_ifq *ifq = rxq->ifq;
 	unsigned int mask = ifq->rq_entries - 1;
 	unsigned int entries;
 	netmem_ref netmem;
 
-	spin_lock_bh(&ifq->rq_lock);
+	spin_lock_bh(&rxq->rq_lock);
 
-	entries = io_zcrx_rqring_entries(ifq);
+	entries = io_zcrx_rqring_entries(rxq);
 	entries = min_t(unsigned, entries, PP_ALLOC_CACHE_REFILL - pp->alloc.count);
 	if (unlikely(!entries)) {
-		spin_unlock_bh(&ifq->rq_lock);
+		spin_unlock_bh(&rxq->rq_lock);
 		return;
 	}
 
 	do {
-		struct io_uring_zcrx_rqe *rqe = io_zcrx_get_rqe(ifq, mask);
+		struct io_uring_zcrx_rqe *rqe = io_zcrx_get_rqe(rxq, mask);
 		struct io_zcrx_area *area;
 		struct net_iov *niov;
 		unsigned niov_idx, area_idx;
@@ -562,8 +617,8 @@ static void io_zcrx_ring_refill(struct page_pool *pp,
 		net_mp_netmem_place_in_cache(pp, netmem);
 	} while (--entries);
 
-	smp_store_release(&ifq->rq_ring->head, ifq->cached_rq_head);
-	spin_unlock_bh(&ifq->rq_lock);
+	smp_store_release(&rxq->rq_ring->head, rxq->cached_rq_head);
+	spin_unlock_bh(&rxq->rq_lock);
 }
 
 static void io_zcrx_refill_slow(struct page_pool *pp, struct io_zcrx_ifq *ifq)
@@ -584,17 +639,18 @@ static void io_zcrx_refill_slow(struct page_pool *pp, struct io_zcrx_ifq *ifq)
 
 static netmem_ref io_pp_zc_alloc_netmems(struct page_pool *pp, gfp_t gfp)
 {
-	struct io_zcrx_ifq *ifq = pp->mp_priv;
+	struct io_zcrx_rxq *rxq = pp->mp_priv;
 
 	/* pp should already be ensuring that */
 	if (unlikely(pp->alloc.count))
 		goto out_return;
 
-	io_zcrx_ring_refill(pp, ifq);
+	io_zcrx_ring_refill(pp, rxq);
 	if (likely(pp->alloc.count))
 		goto out_return;
 
-	io_zcrx_refill_slow(pp, ifq);
+	WRITE_ONCE(rxq->refill_misses, rxq->refill_misses + 1);
+	io_zcrx_refill_slow(pp, rxq->ifq);
 	if (!pp->alloc.count)
 		return 0;
 out_return:
@@ -616,10 +672,12 @@ static bool io_pp_zc_release_netmem(struct page_pool *pp, netmem_ref netmem)
 
 static int io_pp_zc_init(struct page_pool *pp)
 {
-	struct io_zcrx_ifq *ifq = pp->mp_priv;
+	struct io_zcrx_rxq *rxq = pp->mp_priv;
+	struct io_zcrx_ifq *ifq;
 
-	if (WARN_ON_ONCE(!ifq))
+	if (WARN_ON_ONCE(!rxq))
 		return -EINVAL;
+	ifq = rxq->ifq;
 	if (WARN_ON_ONCE(ifq->dev != pp->p.dev))
 		return -EINVAL;
 	if (WARN_ON_ONCE(!pp->dma_map))
@@ -629,16 +687,19 @@ static int io_pp_zc_init(struct page_pool *pp)
 	if (pp->p.dma_dir != DMA_FROM_DEVICE)
 		return -EOPNOTSUPP;
 
+	atomic_inc(&ifq->nr_pools);
 	percpu_ref_get(&ifq->ctx->refs);
 	return 0;
 }
 
 static void io_pp_zc_destroy(struct page_pool *pp)
 {
-	struct io_zcrx_ifq *ifq = pp->mp_priv;
+	struct io_zcrx_ifq *ifq = io_pp_to_ifq(pp);
 	struct io_zcrx_area *area = ifq->area;
 
-	if (WARN_ON_ONCE(area->free_count != area->nia.num_niovs))
+	/* the area is only fully returned once the last pool is gone */
+	if (atomic_dec_and_test(&ifq->nr_pools) &&
+	    WARN_ON_ONCE(area->free_count != area->nia.num_niovs))
 		return;
 	percpu_ref_put(&ifq->ctx->refs);
 }
@@ -661,9 +722,9 @@ static int io_pp_nl_fill(void *mp_priv, struct sk_buff *rsp,
 static void io_pp_uninstall(void *mp_priv, struct netdev_rx_queue *rxq)
 {
 	struct pp_memory_provider_params *p = &rxq->mp_params;
-	struct io_zcrx_ifq *ifq = mp_priv;
+	struct io_zcrx_rxq *zrxq = mp_priv;
 
-	io_zcrx_drop_netdev(ifq);
+	io_zcrx_drop_netdev(zrxq->ifq);
 	p->mp_ops = NULL;
 	p->mp_priv = NULL;
 }
@@ -790,7 +851,7 @@ static int io_zcrx_recv_frag(struct io_kiocb *req, struct io_zcrx_ifq *ifq,
 
 	niov = netmem_to_net_iov(frag->netmem);
 	if (niov->pp->mp_ops != &io_uring_pp_zc_ops ||
-	    niov->pp->mp_priv != ifq)
+	    io_pp_to_ifq(niov->pp) != ifq)
 		return -EFAULT;
 
 	if (!io_zcrx_queue_cqe(req, niov, ifq, off + skb_frag_off(frag), len))
@@ -805,6 +866,19 @@ static int io_zcrx_recv_frag(struct io_kiocb *req, struct io_zcrx_ifq *ifq,
 	return len;
 }
 
+/* Account a copy fallback to the rxq the skb arrived on */
+static void io_zcrx_count_copy(struct io_zcrx_ifq *ifq,
+			       const struct sk_buff *skb)
+{
+	u32 idx = 0;
+
+	if (skb_rx_queue_recorded(skb))
+		idx = skb_get_rx_queue(skb) - ifq->first_rxq;
+	if (idx >= ifq->nr_rxqs)
+		idx = 0;
+	atomic_long_inc(&ifq->rxqs[idx].copy_fallbacks);
+}
+
 static int
 io_zcrx_recv_skb(read_descriptor_t *desc, struct sk_buff *skb,
 		 unsigned int offset, size_t len)
@@ -833,6 +907,7 @@ io_zcrx_recv_skb(read_descriptor_t *desc, struct sk_buff *skb,
 		ssize_t copied;
 		size_t to_copy;
 
+		io_zcrx_count_copy(ifq, skb);
 		to_copy = min_t(size_t, skb_headlen(skb) - offset, len);
 		copied = io_zcrx_copy_chunk(req, ifq, skb->data, NULL,
 					    offset, to_copy);
@@ -865,6 +940,8 @@ io_zcrx_recv_skb(read_descriptor_t *desc, struct sk_buff *skb,
 				copy = len;
 
 			off = offset - start;
+			if (unlikely(!skb_frag_is_net_iov(frag)))
+				io_zcrx_count_copy(ifq, skb);
 			ret = io_zcrx_recv_frag(req, ifq, frag, off, copy);
 			if (ret < 0)
 				goto out;
@@ -966,3 +1043,23 @@ int io_zcrx_recv(struct io_kiocb *req, struct io_zcrx_ifq *ifq,
 	sock_rps_record_flow(sk);
 	return io_zcrx_tcp_recvmsg(req, ifq, sk, flags, issue_flags, len);
 }
+
+void io_zcrx_show_fdinfo(struct io_ring_ctx *ctx, struct seq_file *m)
+{
+	struct io_zcrx_ifq *ifq = ctx->ifq;
+	int i;
+
+	lockdep_assert_held(&ctx->uring_lock);
+
+	if (!ifq)
+		return;
+
+	seq_printf(m, "ZcrxRxqs:\t%u\n", ifq->nr_rxqs);
+	for (i = 0; i < ifq->nr_rxqs; i++) {
+		struct io_zcrx_rxq *rxq = &ifq->rxqs[i];
+
+		seq_printf(m, "%5d: rxq:%u, refill_misses:%llu, copy_fallbacks:%lu\n",
+			   i, ifq->first_rxq + i, READ_ONCE(rxq->refill_misses),
+			   atomic_long_read(&rxq->copy_fallbacks));
+	}
+}
@@ -7,6 +7,8 @@
 #include <net/page_pool/types.h>
 #include <net/net_trackers.h>
 
+struct seq_file;
+
 struct io_zcrx_area {
 	struct net_iov_area	nia;
 	struct io_zcrx_ifq	*ifq;
@@ -22,21 +24,38 @@ struct io_zcrx_area {
 	u32			*freelist;
 };
 
-struct io_zcrx_ifq {
-	struct io_ring_ctx		*ctx;
-	struct io_zcrx_area		*area;
+/* One hardware RX queue bound to an ifq, with its own refill ring */
+struct io_zcrx_rxq {
+	struct io_zcrx_ifq		*ifq;
 
 	struct io_uring			*rq_ring;
 	struct io_uring_zcrx_rqe	*rqes;
-	u32				rq_entries;
 	u32				cached_rq_head;
 	spinlock_t			rq_lock;
 
 	u32				if_rxq;
+
+	/* reported in fdinfo */
+	u64				refill_misses;
+	atomic_long_t			copy_fallbacks;
+} ____cacheline_aligned_in_smp;
+
+struct io_zcrx_ifq {
+	struct io_ring_ctx		*ctx;
+	struct io_zcrx_area		*area;
+	u32				rq_entries;
+
+	/* page pools of all rxqs allocate from the shared area */
+	atomic_t			nr_pools;
+
 	struct device			*dev;
 	struct net_device		*netdev;
 	netdevice_tracker		netdev_tracker;
 	spinlock_t			lock;
+
+	u32				first_rxq;
+	u32				nr_rxqs;
+	struct io_zcrx_rxq		rxqs[] __counted_by(nr_rxqs);
 };
 
 #if defined(CONFIG_IO_URING_ZCRX)
@@ -47,6 +66,7 @@ void io_shutdown_zcrx_ifqs(struct io_ring_ctx *ctx);
 int io_zcrx_recv(struct io_kiocb *req, struct io_zcrx_ifq *ifq,
 		 struct socket *sock, unsigned int flags,
 		 unsigned issue_flags, unsigned int *len);
+void io_zcrx_show_fdinfo(struct io_ring_ctx *ctx, struct seq_file *m);
 #else
 static inline int io_register_zcrx_ifq(struct io_ring_ctx *ctx,
 					struct io_uring_zcrx_ifq_reg __user *arg)
@@ -65,6 +85,10 @@ static inline int io_zcrx_recv(struct io_kiocb *req, struct io_zcrx_ifq *ifq,
 {
 	return -EOPNOTSUPP;
 }
+static inline void io_zcrx_show_fdinfo(struct io_ring_ctx *ctx,
+				       struct seq_file *m)
+{
+}
 #endif
 
 int io_recvzc(struct io_kiocb *req, unsigned int issue_flags);
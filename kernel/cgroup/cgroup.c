@@ -3911,7 +3911,7 @@ static int cgroup_pressure_show(struct seq_file *seq, void *v)
 	struct cgroup *cgrp = seq_css(seq)->cgroup;
 	struct psi_group *psi = cgroup_psi(cgrp);
 
-	seq_printf(seq, "%d\n", psi->enabled);
+	seq_printf(seq, "%d\n", psi->lazy ? 2 : psi->enabled);
 
 	return 0;
 }
@@ -3921,22 +3921,34 @@ static ssize_t cgroup_pressure_write(struct kernfs_open_file *of,
 				     loff_t off)
 {
 	ssize_t ret;
-	int enable;
+	int mode;
+	bool enable, lazy;
 	struct cgroup *cgrp;
 	struct psi_group *psi;
 
-	ret = kstrtoint(strstrip(buf), 0, &enable);
+	ret = kstrtoint(strstrip(buf), 0, &mode);
 	if (ret)
 		return ret;
 
-	if (enable < 0 || enable > 1)
+	/* 0: disabled, 1: enabled, 2: enabled and lazily aggregated */
+	if (mode < 0 || mode > 2)
 		return -ERANGE;
+	enable = mode != 0;
+	lazy = mode == 2;
 
 	cgrp = cgroup_kn_lock_live(of->kn, false);
 	if (!cgrp)
 		return -ENOENT;
 
+	if (lazy && !cgroup_parent(cgrp)) {
+		cgroup_kn_unlock(of->kn);
+		return -EINVAL;
+	}
+
 	psi = cgroup_psi(cgrp);
+	if (psi->lazy && !lazy)
+		psi_cgroup_set_lazy(psi, false);
+
 	if (psi->enabled != enable) {
 		int i;
 
@@ -3949,6 +3961,9 @@ static ssize_t cgroup_pressure_write(struct kernfs_open_file *of,
 			psi_cgroup_restart(psi);
 	}
 
+	if (lazy && !psi->lazy)
+		psi_cgroup_set_lazy(psi, true);
+
 	cgroup_kn_unlock(of->kn);
 
 	return nbytes;
@@ -2,6 +2,7 @@
 #include "cgroup-internal.h"
 
 #include <linux/sched/cputime.h>
+#include <linux/sched/clock.h>
 
 #include <linux/bpf.h>
 #include <linux/btf.h>
@@ -277,19 +278,23 @@ __bpf_hook_end();
  * production environments.  The parameter @cpu_in_loop indicate lock
  * was released and re-taken when collection data from the CPUs. The
  * value -1 is used when obtaining the main lock else this is the CPU
- * number processed last.
+ * number processed last. Returns the time spent waiting for the lock.
  */
-static inline void __cgroup_rstat_lock(struct cgroup *cgrp, int cpu_in_loop)
+static inline u64 __cgroup_rstat_lock(struct cgroup *cgrp, int cpu_in_loop)
 	__acquires(&cgroup_rstat_lock)
 {
 	bool contended;
+	u64 wait = 0;
 
 	contended = !spin_trylock_irq(&cgroup_rstat_lock);
 	if (contended) {
 		trace_cgroup_rstat_lock_contended(cgrp, cpu_in_loop, contended);
+		wait = local_clock();
 		spin_lock_irq(&cgroup_rstat_lock);
+		wait = local_clock() - wait;
 	}
 	trace_cgroup_rstat_locked(cgrp, cpu_in_loop, contended);
+	return wait;
 }
 
 static inline void __cgroup_rstat_unlock(struct cgroup *cgrp, int cpu_in_loop)
@@ -314,6 +319,8 @@ static inline void __cgroup_rstat_unlock(struct cgroup *cgrp, int cpu_in_loop)
  */
 __bpf_kfunc void cgroup_rstat_flush(struct cgroup *cgrp)
 {
+	u64 start = local_clock(), wait = 0;
+	unsigned int nr_cpu_flushes = 0;
 	int cpu;
 
 	might_sleep();
@@ -321,11 +328,13 @@ __bpf_kfunc void cgroup_rstat_flush(struct cgroup *cgrp)
 		struct cgroup *pos;
 
 		/* Reacquire for each CPU to avoid disabling IRQs too long */
-		__cgroup_rstat_lock(cgrp, cpu);
+		wait += __cgroup_rstat_lock(cgrp, cpu);
 		pos = cgroup_rstat_updated_list(cgrp, cpu);
 		for (; pos; pos = pos->rstat_flush_next) {
 			struct cgroup_subsys_state *css;
 
+			nr_cpu_flushes++;
+
 			cgroup_base_stat_flush(pos, cpu);
 			bpf_rstat_flush(pos, cgroup_parent(pos), cpu);
 
@@ -339,6 +348,8 @@ __bpf_kfunc void cgroup_rstat_flush(struct cgroup *cgrp)
 		if (!cond_resched())
 			cpu_relax();
 	}
+	trace_cgroup_rstat_flush(cgrp, nr_cpu_flushes, wait,
+				 local_clock() - start - wait);
 }
 
 int cgroup_rstat_init(struct cgroup *cgrp)
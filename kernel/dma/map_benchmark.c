@@ -11,14 +11,18 @@
 #include <linux/dma-mapping.h>
 #include <linux/kernel.h>
 #include <linux/kthread.h>
+#include <linux/log2_hist.h>
 #include <linux/map_benchmark.h>
 #include <linux/math64.h>
 #include <linux/module.h>
 #include <linux/pci.h>
 #include <linux/platform_device.h>
+#include <linux/scatterlist.h>
 #include <linux/slab.h>
 #include <linux/timekeeping.h>
 
+#define MAP_BENCHMARK_BUCKETS	32	/* log2 latency histogram, in 100ns */
+
 struct map_benchmark_data {
 	struct map_benchmark bparam;
 	struct device *dev;
@@ -29,20 +33,94 @@ struct map_benchmark_data {
 	atomic64_t sum_sq_map;
 	atomic64_t sum_sq_unmap;
 	atomic64_t loops;
+	atomic64_t max_map_100ns;
+	atomic64_t max_unmap_100ns;
+	atomic64_t hist_map[MAP_BENCHMARK_BUCKETS];
+	atomic64_t hist_unmap[MAP_BENCHMARK_BUCKETS];
 };
 
+static void map_benchmark_account(atomic64_t *max, atomic64_t *hist,
+				  u64 lat_100ns)
+{
+	log2_hist_update_max(max, lat_100ns);
+	/* bucket b > 0 holds latencies below 2^b */
+	atomic64_inc(&hist[log2_hist_bucket(lat_100ns, MAP_BENCHMARK_BUCKETS)]);
+}
+
+static u64 map_benchmark_p99(atomic64_t *hist, u64 loops)
+{
+	u64 seen = 0, target = loops - div64_u64(loops, 100);
+	int b;
+
+	for (b = 0; b < MAP_BENCHMARK_BUCKETS - 1; b++) {
+		seen += atomic64_read(&hist[b]);
+		if (seen >= target)
+			break;
+	}
+	return b ? 1ULL << b : 0;
+}
+
+static int map_benchmark_sg_alloc(struct sg_table *sgt, int npages)
+{
+	struct scatterlist *sg;
+	int i, ret;
+
+	ret = sg_alloc_table(sgt, npages, GFP_KERNEL);
+	if (ret)
+		return ret;
+
+	/* separate pages, so the mapping can't be merged up front */
+	for_each_sgtable_sg(sgt, sg, i) {
+		struct page *page = alloc_page(GFP_KERNEL);
+
+		if (!page)
+			goto fail;
+		sg_set_page(sg, page, PAGE_SIZE, 0);
+	}
+	return 0;
+
+fail:
+	npages = i;
+	for_each_sgtable_sg(sgt, sg, i) {
+		if (i == npages)
+			break;
+		__free_page(sg_page(sg));
+	}
+	sg_free_table(sgt);
+	return -ENOMEM;
+}
+
+static void map_benchmark_sg_free(struct sg_table *sgt)
+{
+	struct scatterlist *sg;
+	int i;
+
+	for_each_sgtable_sg(sgt, sg, i)
+		__free_page(sg_page(sg));
+	sg_free_table(sgt);
+}
+
 static int map_benchmark_thread(void *data)
 {
-	void *buf;
+	void *buf = NULL;
 	dma_addr_t dma_addr;
 	struct map_benchmark_data *map = data;
 	int npages = map->bparam.granule;
 	u64 size = npages * PAGE_SIZE;
-	int ret = 0;
+	bool sg_mode = map->bparam.map_mode == DMA_MAP_SG_MODE;
+	struct sg_table sgt;
+	struct scatterlist *sg;
+	int i, ret = 0;
 
-	buf = alloc_pages_exact(size, GFP_KERNEL);
-	if (!buf)
-		return -ENOMEM;
+	if (sg_mode) {
+		ret = map_benchmark_sg_alloc(&sgt, npages);
+		if (ret)
+			return ret;
+	} else {
+		buf = alloc_pages_exact(size, GFP_KERNEL);
+		if (!buf)
+			return -ENOMEM;
+	}
 
 	while (!kthread_should_stop())  {
 		u64 map_100ns, unmap_100ns, map_sq, unmap_sq;
@@ -55,16 +133,30 @@ static int map_benchmark_thread(void *data)
 		 * overhead of BIDIRECTIONAL or TO_DEVICE mappings;
 		 * 66 means evertything goes well! 66 is lucky.
 		 */
-		if (map->dir != DMA_FROM_DEVICE)
-			memset(buf, 0x66, size);
+		if (map->dir != DMA_FROM_DEVICE) {
+			if (sg_mode)
+				for_each_sgtable_sg(&sgt, sg, i)
+					memset(sg_virt(sg), 0x66, sg->length);
+			else
+				memset(buf, 0x66, size);
+		}
 
 		map_stime = ktime_get();
-		dma_addr = dma_map_single(map->dev, buf, size, map->dir);
-		if (unlikely(dma_mapping_error(map->dev, dma_addr))) {
-			pr_err("dma_map_single failed on %s\n",
-				dev_name(map->dev));
-			ret = -ENOMEM;
-			goto out;
+		if (sg_mode) {
+			ret = dma_map_sgtable(map->dev, &sgt, map->dir, 0);
+			if (unlikely(ret)) {
+				pr_err("dma_map_sgtable failed on %s\n",
+					dev_name(map->dev));
+				goto out;
+			}
+		} else {
+			dma_addr = dma_map_single(map->dev, buf, size, map->dir);
+			if (unlikely(dma_mapping_error(map->dev, dma_addr))) {
+				pr_err("dma_map_single failed on %s\n",
+					dev_name(map->dev));
+				ret = -ENOMEM;
+				goto out;
+			}
 		}
 		map_etime = ktime_get();
 		map_delta = ktime_sub(map_etime, map_stime);
@@ -73,7 +165,10 @@ static int map_benchmark_thread(void *data)
 		ndelay(map->bparam.dma_trans_ns);
 
 		unmap_stime = ktime_get();
-		dma_unmap_single(map->dev, dma_addr, size, map->dir);
+		if (sg_mode)
+			dma_unmap_sgtable(map->dev, &sgt, map->dir, 0);
+		else
+			dma_unmap_single(map->dev, dma_addr, size, map->dir);
 		unmap_etime = ktime_get();
 		unmap_delta = ktime_sub(unmap_etime, unmap_stime);
 
@@ -89,6 +184,10 @@ static int map_benchmark_thread(void *data)
 		atomic64_add(map_sq, &map->sum_sq_map);
 		atomic64_add(unmap_sq, &map->sum_sq_unmap);
 		atomic64_inc(&map->loops);
+		map_benchmark_account(&map->max_map_100ns, map->hist_map,
+				      map_100ns);
+		map_benchmark_account(&map->max_unmap_100ns, map->hist_unmap,
+				      unmap_100ns);
 
 		/*
 		 * We may test for a long time so periodically check whether
@@ -108,7 +207,10 @@ static int map_benchmark_thread(void *data)
 	}
 
 out:
-	free_pages_exact(buf, size);
+	if (sg_mode)
+		map_benchmark_sg_free(&sgt);
+	else
+		free_pages_exact(buf, size);
 	return ret;
 }
 
@@ -148,6 +250,12 @@ static int do_map_benchmark(struct map_benchmark_data *map)
 	atomic64_set(&map->sum_sq_map, 0);
 	atomic64_set(&map->sum_sq_unmap, 0);
 	atomic64_set(&map->loops, 0);
+	atomic64_set(&map->max_map_100ns, 0);
+	atomic64_set(&map->max_unmap_100ns, 0);
+	for (i = 0; i < MAP_BENCHMARK_BUCKETS; i++) {
+		atomic64_set(&map->hist_map[i], 0);
+		atomic64_set(&map->hist_unmap[i], 0);
+	}
 
 	for (i = 0; i < threads; i++) {
 		get_task_struct(tsk[i]);
@@ -188,6 +296,14 @@ static int do_map_benchmark(struct map_benchmark_data *map)
 				map->bparam.avg_unmap_100ns;
 		map->bparam.map_stddev = int_sqrt64(map_variance);
 		map->bparam.unmap_stddev = int_sqrt64(unmap_variance);
+
+		/* tail latency */
+		map->bparam.max_map_100ns = atomic64_read(&map->max_map_100ns);
+		map->bparam.max_unmap_100ns = atomic64_read(&map->max_unmap_100ns);
+		map->bparam.p99_map_100ns = map_benchmark_p99(map->hist_map,
+							      loops);
+		map->bparam.p99_unmap_100ns = map_benchmark_p99(map->hist_unmap,
+								loops);
 	}
 
 out:
@@ -238,6 +354,12 @@ static long map_benchmark_ioctl(struct file *file, unsigned int cmd,
 			return -EINVAL;
 		}
 
+		if (map->bparam.map_mode != DMA_MAP_SINGLE_MODE &&
+		    map->bparam.map_mode != DMA_MAP_SG_MODE) {
+			pr_err("invalid map mode\n");
+			return -EINVAL;
+		}
+
 		switch (map->bparam.dma_dir) {
 		case DMA_MAP_BIDIRECTIONAL:
 			map->dir = DMA_BIDIRECTIONAL;
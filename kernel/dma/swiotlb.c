@@ -37,6 +37,7 @@
 #include <linux/pfn.h>
 #include <linux/rculist.h>
 #include <linux/scatterlist.h>
+#include <linux/sched/clock.h>
 #include <linux/set_memory.h>
 #include <linux/spinlock.h>
 #include <linux/string.h>
@@ -118,6 +119,22 @@ struct io_tlb_area {
 	spinlock_t lock;
 };
 
+/**
+ * struct io_tlb_alloc_stats - per-CPU slot search statistics
+ *
+ * @alloc_nr:	Number of bounce buffer mappings attempted.
+ * @alloc_fail:	Number of those that found no free slots.
+ * @alloc_ns:	Total time spent searching for slots.
+ * @area_misses: Number of areas searched without finding a fit, a sign of
+ *		fragmentation or of areas that are too small.
+ */
+struct io_tlb_alloc_stats {
+	unsigned long alloc_nr;
+	unsigned long alloc_fail;
+	unsigned long alloc_ns;
+	unsigned long area_misses;
+};
+
 /*
  * Round up number of slabs to the next power of 2. The last area is going
  * be smaller than the rest if default_nslabs is not power of two.
@@ -966,6 +983,31 @@ static void dec_used(struct io_tlb_mem *mem, unsigned int nslots)
 	atomic_long_sub(nslots, &mem->total_used);
 }
 
+/*
+ * The slot search statistics are per-CPU so that concurrent mappings do not
+ * bounce a shared cache line. They are allocated along with the debugfs
+ * files, and nothing is counted before that.
+ */
+static void count_area_misses(struct io_tlb_mem *mem, int nr)
+{
+	struct io_tlb_alloc_stats __percpu *stats = READ_ONCE(mem->alloc_stats);
+
+	if (stats && nr)
+		this_cpu_add(stats->area_misses, nr);
+}
+
+static void count_alloc(struct io_tlb_mem *mem, u64 start, bool failed)
+{
+	struct io_tlb_alloc_stats __percpu *stats = READ_ONCE(mem->alloc_stats);
+
+	if (!stats)
+		return;
+	this_cpu_inc(stats->alloc_nr);
+	this_cpu_add(stats->alloc_ns, local_clock() - start);
+	if (failed)
+		this_cpu_inc(stats->alloc_fail);
+}
+
 #else /* !CONFIG_DEBUG_FS */
 static void inc_used_and_hiwater(struct io_tlb_mem *mem, unsigned int nslots)
 {
@@ -973,6 +1015,12 @@ static void inc_used_and_hiwater(struct io_tlb_mem *mem, unsigned int nslots)
 static void dec_used(struct io_tlb_mem *mem, unsigned int nslots)
 {
 }
+static void count_area_misses(struct io_tlb_mem *mem, int nr)
+{
+}
+static void count_alloc(struct io_tlb_mem *mem, u64 start, bool failed)
+{
+}
 #endif /* CONFIG_DEBUG_FS */
 
 #ifdef CONFIG_SWIOTLB_DYNAMIC
@@ -1197,9 +1245,12 @@ static int swiotlb_find_slots(struct device *dev, phys_addr_t orig_addr,
 	for (i = 0; i < default_nareas; ++i) {
 		index = swiotlb_search_area(dev, cpu, i, orig_addr, alloc_size,
 					    alloc_align_mask, &pool);
-		if (index >= 0)
+		if (index >= 0) {
+			count_area_misses(mem, i);
 			goto found;
+		}
 	}
+	count_area_misses(mem, default_nareas);
 
 	if (!mem->can_grow)
 		return -1;
@@ -1261,6 +1312,7 @@ static int swiotlb_find_slots(struct device *dev, phys_addr_t orig_addr,
 	struct io_tlb_pool *pool;
 	int start, i;
 	int index;
+	int misses = 0;
 
 	*retpool = pool = &dev->dma_io_tlb_mem->defpool;
 	i = start = raw_smp_processor_id() & (pool->nareas - 1);
@@ -1268,11 +1320,13 @@ static int swiotlb_find_slots(struct device *dev, phys_addr_t orig_addr,
 		index = swiotlb_search_pool_area(dev, pool, i, orig_addr,
 						 alloc_size, alloc_align_mask);
 		if (index >= 0)
-			return index;
+			break;
+		misses++;
 		if (++i >= pool->nareas)
 			i = 0;
 	} while (i != start);
-	return -1;
+	count_area_misses(dev->dma_io_tlb_mem, misses);
+	return index;
 }
 
 #endif /* CONFIG_SWIOTLB_DYNAMIC */
@@ -1378,6 +1432,7 @@ phys_addr_t swiotlb_tbl_map_single(struct device *dev, phys_addr_t orig_addr,
 	int index;
 	phys_addr_t tlb_addr;
 	unsigned short pad_slots;
+	u64 start;
 
 	if (!mem || !mem->nslabs) {
 		dev_warn_ratelimited(dev,
@@ -1400,7 +1455,9 @@ phys_addr_t swiotlb_tbl_map_single(struct device *dev, phys_addr_t orig_addr,
 
 	offset = swiotlb_align_offset(dev, alloc_align_mask, orig_addr);
 	size = ALIGN(mapping_size + offset, alloc_align_mask + 1);
+	start = IS_ENABLED(CONFIG_DEBUG_FS) ? local_clock() : 0;
 	index = swiotlb_find_slots(dev, orig_addr, size, alloc_align_mask, &pool);
+	count_alloc(mem, start, index == -1);
 	if (index == -1) {
 		if (!(attrs & DMA_ATTR_NO_WARN))
 			dev_warn_ratelimited(dev,
@@ -1711,6 +1768,25 @@ DEFINE_DEBUGFS_ATTRIBUTE(fops_io_tlb_used, io_tlb_used_get, NULL, "%llu\n");
 DEFINE_DEBUGFS_ATTRIBUTE(fops_io_tlb_hiwater, io_tlb_hiwater_get,
 				io_tlb_hiwater_set, "%llu\n");
 
+#define IO_TLB_ALLOC_STAT_ATTRIBUTE(name)				\
+static int io_tlb_##name##_get(void *data, u64 *val)			\
+{									\
+	struct io_tlb_mem *mem = data;					\
+	int cpu;							\
+									\
+	*val = 0;							\
+	for_each_possible_cpu(cpu)					\
+		*val += per_cpu_ptr(mem->alloc_stats, cpu)->name;	\
+	return 0;							\
+}									\
+DEFINE_DEBUGFS_ATTRIBUTE(fops_io_tlb_##name, io_tlb_##name##_get,	\
+			 NULL, "%llu\n")
+
+IO_TLB_ALLOC_STAT_ATTRIBUTE(alloc_nr);
+IO_TLB_ALLOC_STAT_ATTRIBUTE(alloc_fail);
+IO_TLB_ALLOC_STAT_ATTRIBUTE(alloc_ns);
+IO_TLB_ALLOC_STAT_ATTRIBUTE(area_misses);
+
 static void swiotlb_create_debugfs_files(struct io_tlb_mem *mem,
 					 const char *dirname)
 {
@@ -1727,6 +1803,18 @@ static void swiotlb_create_debugfs_files(struct io_tlb_mem *mem,
 	debugfs_create_file("io_tlb_transient_nslabs", 0400, mem->debugfs,
 			    mem, &fops_io_tlb_transient_used);
 #endif
+
+	WRITE_ONCE(mem->alloc_stats, alloc_percpu(struct io_tlb_alloc_stats));
+	if (!mem->alloc_stats)
+		return;
+	debugfs_create_file("io_tlb_alloc_nr", 0400, mem->debugfs, mem,
+			    &fops_io_tlb_alloc_nr);
+	debugfs_create_file("io_tlb_alloc_fail", 0400, mem->debugfs, mem,
+			    &fops_io_tlb_alloc_fail);
+	debugfs_create_file("io_tlb_alloc_ns", 0400, mem->debugfs, mem,
+			    &fops_io_tlb_alloc_ns);
+	debugfs_create_file("io_tlb_area_misses", 0400, mem->debugfs, mem,
+			    &fops_io_tlb_area_misses);
 }
 
 static int __init swiotlb_create_default_debugfs(void)
@@ -29,6 +29,9 @@
 #include <linux/workqueue.h>
 #include <linux/srcu.h>
 #include <linux/oom.h>          /* check_stable_address_space */
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/sched/clock.h>
 
 #include <linux/uprobes.h>
 
@@ -58,6 +61,15 @@ DEFINE_STATIC_SRCU(uretprobes_srcu);
 /* Have a copy of original instruction */
 #define UPROBE_COPY_INSN	0
 
+/* Per-cpu counters of a uprobe, see <debugfs>/uprobes/stats */
+struct uprobe_stats {
+	u64			nhit;		/* hits that ran the handlers */
+	u64			nsstep;		/* hits that had to single-step */
+	u64			handler_ns;	/* time spent in the handlers */
+};
+
+static DEFINE_STATIC_KEY_FALSE(uprobe_stats_key);
+
 struct uprobe {
 	struct rb_node		rb_node;	/* node in the rb tree */
 	refcount_t		ref;
@@ -74,6 +86,9 @@ struct uprobe {
 	loff_t			ref_ctr_offset;
 	unsigned long		flags;		/* "unsigned long" so bitops work */
 
+	/* Allocated on the first hit while uprobe_stats_key is on */
+	struct uprobe_stats __percpu *stats;
+
 	/*
 	 * The generic code assumes that it has two members of unknown type
 	 * owned by the arch-specific code:
@@ -646,6 +661,7 @@ static void uprobe_free_rcu_tasks_trace(struct rcu_head *rcu)
 {
 	struct uprobe *uprobe = container_of(rcu, struct uprobe, rcu);
 
+	free_percpu(uprobe->stats);
 	kfree(uprobe);
 }
 
@@ -2660,15 +2676,43 @@ bool __weak arch_uretprobe_is_alive(struct return_instance *ret, enum rp_check c
 	return true;
 }
 
+/*
+ * Return the per-cpu counters of @uprobe while statistics are enabled through
+ * <debugfs>/uprobes/enable, allocating them on the first hit. Hot probes are
+ * hit from many CPUs at once, so nothing shared is written on this path.
+ */
+static struct uprobe_stats __percpu *uprobe_get_stats(struct uprobe *uprobe)
+{
+	struct uprobe_stats __percpu *stats;
+
+	if (!static_branch_unlikely(&uprobe_stats_key))
+		return NULL;
+
+	stats = READ_ONCE(uprobe->stats);
+	if (likely(stats))
+		return stats;
+
+	stats = alloc_percpu_gfp(struct uprobe_stats, GFP_NOWAIT | __GFP_NOWARN);
+	if (!stats)
+		return NULL;
+	if (cmpxchg(&uprobe->stats, NULL, stats)) {
+		free_percpu(stats);
+		stats = READ_ONCE(uprobe->stats);
+	}
+	return stats;
+}
+
 /*
  * Run handler and ask thread to singlestep.
  * Ensure all non-fatal signals cannot interrupt thread while it singlesteps.
  */
 static void handle_swbp(struct pt_regs *regs)
 {
+	struct uprobe_stats __percpu *stats;
 	struct uprobe *uprobe;
 	unsigned long bp_vaddr;
 	int is_swbp;
+	u64 start = 0;
 
 	bp_vaddr = uprobe_get_swbp_addr(regs);
 	if (bp_vaddr == uprobe_get_trampoline_vaddr())
@@ -2722,7 +2766,14 @@ static void handle_swbp(struct pt_regs *regs)
 	if (arch_uprobe_ignore(&uprobe->arch, regs))
 		goto out;
 
+	stats = uprobe_get_stats(uprobe);
+	if (stats)
+		start = local_clock();
 	handler_chain(uprobe, regs);
+	if (stats) {
+		this_cpu_add(stats->handler_ns, local_clock() - start);
+		this_cpu_inc(stats->nhit);
+	}
 
 	if (arch_uprobe_skip_sstep(&uprobe->arch, regs))
 		goto out;
@@ -2730,6 +2781,8 @@ static void handle_swbp(struct pt_regs *regs)
 	if (pre_ssout(uprobe, regs, bp_vaddr))
 		goto out;
 
+	if (stats)
+		this_cpu_inc(stats->nsstep);
 out:
 	/* arch_uprobe_skip_sstep() succeeded, or restart if can't singlestep */
 	rcu_read_unlock_trace();
@@ -2831,6 +2884,69 @@ static struct notifier_block uprobe_exception_nb = {
 	.priority		= INT_MAX-1,	/* notified after kprobes, kgdb */
 };
 
+#ifdef CONFIG_DEBUG_FS
+static int uprobes_stats_show(struct seq_file *m, void *v)
+{
+	struct uprobe_stats __percpu *stats;
+	struct uprobe *uprobe;
+	struct rb_node *n;
+	int cpu;
+
+	seq_puts(m, "dev ino offset hits sstep handler_ns\n");
+	read_lock(&uprobes_treelock);
+	for (n = rb_first(&uprobes_tree); n; n = rb_next(n)) {
+		struct uprobe_stats sum = {};
+
+		uprobe = rb_entry(n, struct uprobe, rb_node);
+		stats = READ_ONCE(uprobe->stats);
+		if (!stats)
+			continue;
+		for_each_possible_cpu(cpu) {
+			struct uprobe_stats *cs = per_cpu_ptr(stats, cpu);
+
+			sum.nhit += READ_ONCE(cs->nhit);
+			sum.nsstep += READ_ONCE(cs->nsstep);
+			sum.handler_ns += READ_ONCE(cs->handler_ns);
+		}
+		seq_printf(m, "%s %lu 0x%llx %llu %llu %llu\n",
+			   uprobe->inode->i_sb->s_id, uprobe->inode->i_ino,
+			   uprobe->offset, sum.nhit, sum.nsstep,
+			   sum.handler_ns);
+	}
+	read_unlock(&uprobes_treelock);
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(uprobes_stats);
+
+static int uprobes_stats_enable_get(void *data, u64 *val)
+{
+	*val = static_key_enabled(&uprobe_stats_key);
+	return 0;
+}
+
+static int uprobes_stats_enable_set(void *data, u64 val)
+{
+	if (val)
+		static_branch_enable(&uprobe_stats_key);
+	else
+		static_branch_disable(&uprobe_stats_key);
+	return 0;
+}
+DEFINE_DEBUGFS_ATTRIBUTE(uprobes_stats_enable_fops, uprobes_stats_enable_get,
+			 uprobes_stats_enable_set, "%llu\n");
+
+static int __init uprobes_debugfs_init(void)
+{
+	struct dentry *dir = debugfs_create_dir("uprobes", NULL);
+
+	debugfs_create_file("stats", 0400, dir, NULL, &uprobes_stats_fops);
+	debugfs_create_file_unsafe("enable", 0600, dir, NULL,
+				   &uprobes_stats_enable_fops);
+	return 0;
+}
+late_initcall(uprobes_debugfs_init);
+#endif
+
 void __init uprobes_init(void)
 {
 	int i;
@@ -23,6 +23,7 @@
 #include <linux/sched/task_stack.h>
 #include <linux/sched/cputime.h>
 #include <linux/sched/ext.h>
+#include <linux/sched/clock.h>
 #include <linux/seq_file.h>
 #include <linux/rtmutex.h>
 #include <linux/init.h>
@@ -614,11 +615,18 @@ static __latent_entropy int dup_mmap(struct mm_struct *mm,
 	struct vm_area_struct *mpnt, *tmp;
 	int retval;
 	unsigned long charge = 0;
+	bool trace = trace_task_dup_mmap_enabled();
+	unsigned int nr_vmas = 0, nr_copied = 0;
+	u64 start = 0, lock_ns = 0, copy_ns = 0;
 	LIST_HEAD(uf);
 	VMA_ITERATOR(vmi, mm, 0);
 
+	if (trace)
+		start = local_clock();
 	if (mmap_write_lock_killable(oldmm))
 		return -EINTR;
+	if (trace)
+		lock_ns = local_clock() - start;
 	flush_cache_dup_mm(oldmm);
 	uprobe_dup_mmap(oldmm, mm);
 	/*
@@ -702,6 +710,7 @@ static __latent_entropy int dup_mmap(struct mm_struct *mm,
 		vma_iter_bulk_store(&vmi, tmp);
 
 		mm->map_count++;
+		nr_vmas++;
 
 		if (tmp->vm_ops && tmp->vm_ops->open)
 			tmp->vm_ops->open(tmp);
@@ -722,8 +731,14 @@ static __latent_entropy int dup_mmap(struct mm_struct *mm,
 			i_mmap_unlock_write(mapping);
 		}
 
-		if (!(tmp->vm_flags & VM_WIPEONFORK))
+		if (!(tmp->vm_flags & VM_WIPEONFORK)) {
+			u64 copy_start = trace ? local_clock() : 0;
+
 			retval = copy_page_range(tmp, mpnt);
+			if (trace)
+				copy_ns += local_clock() - copy_start;
+			nr_copied++;
+		}
 
 		if (retval) {
 			mpnt = vma_next(&vmi);
@@ -768,6 +783,9 @@ static __latent_entropy int dup_mmap(struct mm_struct *mm,
 		dup_userfaultfd_complete(&uf);
 	else
 		dup_userfaultfd_fail(&uf);
+	if (trace)
+		trace_task_dup_mmap(mm, nr_vmas, nr_copied, lock_ns, copy_ns,
+				    local_clock() - start, retval);
 	return retval;
 
 fail_nomem_anon_vma_fork:
@@ -945,6 +963,9 @@ void __mmdrop(struct mm_struct *mm)
 	mm_pasid_drop(mm);
 	mm_destroy_cid(mm);
 	percpu_counter_destroy_many(mm->rss_stat, NR_MM_COUNTERS);
+#ifdef CONFIG_PROC_PAGE_MONITOR
+	kfree(mm->smaps_rollup_cache);
+#endif
 
 	free_mm(mm);
 }
@@ -1307,9 +1328,19 @@ static struct mm_struct *mm_init(struct mm_struct *mm, struct task_struct *p,
 	init_tlb_flush_pending(mm);
 #if defined(CONFIG_TRANSPARENT_HUGEPAGE) && !defined(CONFIG_SPLIT_PMD_PTLOCKS)
 	mm->pmd_huge_pte = NULL;
+#endif
+#ifdef CONFIG_TRANSPARENT_HUGEPAGE
+	atomic_long_set(&mm->thp_collapse_succeeded, 0);
+	atomic_long_set(&mm->thp_collapse_failed, 0);
+#endif
+#ifdef CONFIG_PROC_PAGE_MONITOR
+	mm->smaps_rollup_cache = NULL;
 #endif
 	mm_init_uprobes_state(mm);
 	hugetlb_count_init(mm);
+#ifdef CONFIG_MEMBARRIER
+	mm->membarrier_seq = 0;
+#endif
 
 	if (current->mm) {
 		mm->flags = mmf_init_flags(current->mm->flags);
@@ -0,0 +1,226 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * In-kernel interrupt load balancer
+ *
+ * Every irq_balance.interval_ms the balancer samples the count of every
+ * interrupt, charges the rate to the CPU in its effective affinity and
+ * moves one interrupt from the busiest CPU to the least busy one, if that
+ * makes the two closer. Only interrupts that can be balanced at all are
+ * candidates: not managed, not per CPU, not NMIs and with an affinity that
+ * user space didn't restrict, or that the balancer set itself. Writing to
+ * /proc/irq/N/smp_affinity hands the interrupt back to the user. Isolated
+ * CPUs are never chosen as target.
+ */
+#include <linux/debugfs.h>
+#include <linux/interrupt.h>
+#include <linux/irq.h>
+#include <linux/moduleparam.h>
+#include <linux/sched/isolation.h>
+#include <linux/seq_file.h>
+#include <linux/slab.h>
+#include <linux/workqueue.h>
+
+#include "internals.h"
+
+#undef MODULE_PARAM_PREFIX
+#define MODULE_PARAM_PREFIX "irq_balance."
+
+static bool irq_balance_enabled;
+static unsigned int irq_balance_interval_ms = 1000;
+/* Ignore imbalances below this many interrupts per interval. */
+static unsigned int irq_balance_min_imbalance = 1000;
+
+static unsigned long *irq_balance_load;
+static void irq_balance_fn(struct work_struct *work);
+static DECLARE_DELAYED_WORK(irq_balance_work, irq_balance_fn);
+static DEFINE_MUTEX(irq_balance_mutex);
+
+static unsigned long irq_balance_rounds;
+static unsigned long irq_balance_migrations;
+static unsigned long irq_balance_failed;
+static unsigned long irq_balance_last_imbalance;
+
+static bool irq_balance_candidate(struct irq_desc *desc, unsigned int cpu)
+{
+	struct irq_data *data = irq_desc_get_irq_data(desc);
+	const struct cpumask *aff = irq_data_get_affinity_mask(data);
+
+	if (!desc->action || irq_is_nmi(desc) || !irqd_can_balance(data) ||
+	    irqd_affinity_is_managed(data) || irq_settings_is_per_cpu_devid(desc))
+		return false;
+
+	if (desc->balance_owned)
+		return cpumask_equal(aff, cpumask_of(cpu));
+
+	/* Leave interrupts alone that were restricted on purpose. */
+	return cpumask_subset(irq_default_affinity, aff);
+}
+
+static void irq_balance_scan(void)
+{
+	unsigned int irq, cpu, src = nr_cpu_ids, dst = nr_cpu_ids;
+	unsigned int best_irq = 0, best_rate = 0;
+	unsigned long imbalance;
+	struct irq_desc *desc;
+
+	memset(irq_balance_load, 0, nr_cpu_ids * sizeof(*irq_balance_load));
+
+	irq_lock_sparse();
+	for_each_active_irq(irq) {
+		unsigned int count;
+
+		desc = irq_to_desc(irq);
+		raw_spin_lock_irq(&desc->lock);
+		count = data_race(desc->tot_count);
+		desc->balance_rate = count - desc->balance_count;
+		desc->balance_count = count;
+		cpu = cpumask_first(irq_data_get_effective_affinity_mask(&desc->irq_data));
+		if (cpu < nr_cpu_ids)
+			irq_balance_load[cpu] += desc->balance_rate;
+		raw_spin_unlock_irq(&desc->lock);
+	}
+
+	for_each_online_cpu(cpu) {
+		if (src == nr_cpu_ids ||
+		    irq_balance_load[cpu] > irq_balance_load[src])
+			src = cpu;
+		if (cpu_is_isolated(cpu) ||
+		    !cpumask_test_cpu(cpu, irq_default_affinity))
+			continue;
+		if (dst == nr_cpu_ids ||
+		    irq_balance_load[cpu] < irq_balance_load[dst])
+			dst = cpu;
+	}
+	if (src == nr_cpu_ids || dst == nr_cpu_ids || src == dst)
+		goto out;
+
+	imbalance = irq_balance_load[src] - irq_balance_load[dst];
+	WRITE_ONCE(irq_balance_last_imbalance, imbalance);
+	if (imbalance < READ_ONCE(irq_balance_min_imbalance))
+		goto out;
+
+	/*
+	 * Move the busiest interrupt that still leaves the source at least
+	 * as loaded as the target, so the two never swap places.
+	 */
+	for_each_active_irq(irq) {
+		desc = irq_to_desc(irq);
+		raw_spin_lock_irq(&desc->lock);
+		if (desc->balance_rate > best_rate &&
+		    desc->balance_rate <= imbalance / 2 &&
+		    cpumask_test_cpu(src, irq_data_get_effective_affinity_mask(&desc->irq_data)) &&
+		    irq_balance_candidate(desc, src)) {
+			best_irq = irq;
+			best_rate = desc->balance_rate;
+		}
+		raw_spin_unlock_irq(&desc->lock);
+	}
+
+	if (best_rate) {
+		if (!irq_set_affinity(best_irq, cpumask_of(dst))) {
+			desc = irq_to_desc(best_irq);
+			WRITE_ONCE(desc->balance_owned, true);
+			WRITE_ONCE(irq_balance_migrations, irq_balance_migrations + 1);
+		} else {
+			WRITE_ONCE(irq_balance_failed, irq_balance_failed + 1);
+		}
+	}
+out:
+	irq_unlock_sparse();
+	WRITE_ONCE(irq_balance_rounds, irq_balance_rounds + 1);
+}
+
+static void irq_balance_fn(struct work_struct *work)
+{
+	mutex_lock(&irq_balance_mutex);
+	if (irq_balance_enabled) {
+		irq_balance_scan();
+		queue_delayed_work(system_unbound_wq, &irq_balance_work,
+				   msecs_to_jiffies(irq_balance_interval_ms));
+	}
+	mutex_unlock(&irq_balance_mutex);
+}
+
+static int irq_balance_set_enabled(const char *val,
+				   const struct kernel_param *kp)
+{
+	bool enable;
+	int ret;
+
+	ret = kstrtobool(val, &enable);
+	if (ret)
+		return ret;
+
+	mutex_lock(&irq_balance_mutex);
+	irq_balance_enabled = enable;
+	/* Before late init this only records the setting. */
+	if (enable && irq_balance_load)
+		mod_delayed_work(system_unbound_wq, &irq_balance_work, 0);
+	mutex_unlock(&irq_balance_mutex);
+	return 0;
+}
+
+static const struct kernel_param_ops irq_balance_enabled_ops = {
+	.set	= irq_balance_set_enabled,
+	.get	= param_get_bool,
+};
+module_param_cb(enabled, &irq_balance_enabled_ops, &irq_balance_enabled, 0644);
+MODULE_PARM_DESC(enabled, "Balance interrupt load between CPUs");
+
+static int irq_balance_set_interval(const char *val,
+				    const struct kernel_param *kp)
+{
+	return param_set_uint_minmax(val, kp, 10, 60 * MSEC_PER_SEC);
+}
+
+static const struct kernel_param_ops irq_balance_interval_ops = {
+	.set	= irq_balance_set_interval,
+	.get	= param_get_uint,
+};
+module_param_cb(interval_ms, &irq_balance_interval_ops,
+		&irq_balance_interval_ms, 0644);
+MODULE_PARM_DESC(interval_ms, "Interval between two balancing passes");
+module_param_named(min_imbalance, irq_balance_min_imbalance, uint, 0644);
+MODULE_PARM_DESC(min_imbalance, "Interrupts per interval below which CPUs count as balanced");
+
+/**
+ * irq_balance_release - Hand an interrupt back to the user
+ * @desc:	The interrupt descriptor
+ *
+ * Called when user space sets the affinity, so that the balancer no
+ * longer moves the interrupt.
+ */
+void irq_balance_release(struct irq_desc *desc)
+{
+	WRITE_ONCE(desc->balance_owned, false);
+}
+
+static int irq_balance_stats_show(struct seq_file *m, void *v)
+{
+	seq_printf(m, "enabled: %d\n", READ_ONCE(irq_balance_enabled));
+	seq_printf(m, "rounds: %lu\n", READ_ONCE(irq_balance_rounds));
+	seq_printf(m, "migrations: %lu\n", READ_ONCE(irq_balance_migrations));
+	seq_printf(m, "failed: %lu\n", READ_ONCE(irq_balance_failed));
+	seq_printf(m, "last imbalance: %lu\n",
+		   READ_ONCE(irq_balance_last_imbalance));
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(irq_balance_stats);
+
+static int __init irq_balance_init(void)
+{
+	irq_balance_load = kcalloc(nr_cpu_ids, sizeof(*irq_balance_load),
+				   GFP_KERNEL);
+	if (!irq_balance_load)
+		return -ENOMEM;
+
+	debugfs_create_file("irq_balance", 0400, NULL, NULL,
+			    &irq_balance_stats_fops);
+
+	mutex_lock(&irq_balance_mutex);
+	if (irq_balance_enabled)
+		queue_delayed_work(system_unbound_wq, &irq_balance_work, 0);
+	mutex_unlock(&irq_balance_mutex);
+	return 0;
+}
+late_initcall(irq_balance_init);
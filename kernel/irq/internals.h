@@ -462,6 +462,12 @@ static inline bool irq_fixup_move_pending(struct irq_desc *desc, bool fclear)
 static inline void irq_force_complete_move(struct irq_desc *desc) { }
 #endif /* !CONFIG_GENERIC_PENDING_IRQ */
 
+#ifdef CONFIG_IRQ_BALANCE
+void irq_balance_release(struct irq_desc *desc);
+#else
+static inline void irq_balance_release(struct irq_desc *desc) { }
+#endif
+
 #if !defined(CONFIG_IRQ_DOMAIN) || !defined(CONFIG_IRQ_DOMAIN_HIERARCHY)
 static inline int irq_domain_activate_irq(struct irq_data *data, bool reserve)
 {
@@ -35,6 +35,21 @@ static int __init setup_forced_irqthreads(char *arg)
 early_param("threadirqs", setup_forced_irqthreads);
 #endif
 
+/*
+ * Run interrupt threads as SCHED_NORMAL instead of SCHED_FIFO. They then
+ * no longer preempt real-time tasks, but are covered by the fair server
+ * bandwidth (sched/fair_server/cpuN/ in debugfs), so RT polling threads
+ * can't starve them indefinitely.
+ */
+static bool irqthreads_fair __ro_after_init;
+
+static int __init setup_irqthreads_fair(char *arg)
+{
+	irqthreads_fair = true;
+	return 0;
+}
+early_param("threadirqs_fair", setup_irqthreads_fair);
+
 static int __irq_get_irqchip_state(struct irq_data *d, enum irqchip_irq_state which, bool *state);
 
 static void __synchronize_hardirq(struct irq_desc *desc, bool sync_chip)
@@ -1302,7 +1317,10 @@ static int irq_thread(void *data)
 
 	irq_thread_set_ready(desc, action);
 
-	sched_set_fifo(current);
+	if (irqthreads_fair)
+		sched_set_normal(current, MIN_NICE);
+	else
+		sched_set_fifo(current);
 
 	if (force_irqthreads() && test_bit(IRQTF_FORCED_THREAD,
 					   &action->thread_flags))
@@ -40,6 +40,7 @@
 #include <linux/perf_event.h>
 #include <linux/execmem.h>
 #include <linux/cleanup.h>
+#include <linux/sched/clock.h>
 
 #include <asm/sections.h>
 #include <asm/cacheflush.h>
@@ -1586,6 +1587,11 @@ static int check_kprobe_address_safe(struct kprobe *p,
 	return 0;
 }
 
+/* Registration cost, see <debugfs>/kprobes/stats */
+static atomic_long_t kprobe_nr_registered;
+static atomic64_t kprobe_register_ns;
+static atomic64_t kprobe_arm_ns;
+
 static int __register_kprobe(struct kprobe *p)
 {
 	int ret;
@@ -1611,11 +1617,15 @@ static int __register_kprobe(struct kprobe *p)
 		       &kprobe_table[hash_ptr(p->addr, KPROBE_HASH_BITS)]);
 
 	if (!kprobes_all_disarmed && !kprobe_disabled(p)) {
+		u64 start = local_clock();
+
 		ret = arm_kprobe(p);
 		if (ret) {
 			hlist_del_rcu(&p->hlist);
 			synchronize_rcu();
+			return ret;
 		}
+		atomic64_add(local_clock() - start, &kprobe_arm_ns);
 	}
 
 	/* Try to optimize kprobe */
@@ -1629,6 +1639,7 @@ int register_kprobe(struct kprobe *p)
 	struct module *probed_mod;
 	kprobe_opcode_t *addr;
 	bool on_func_entry;
+	u64 start;
 
 	/* Canonicalize probe address from symbol */
 	addr = _kprobe_addr(p->addr, p->symbol_name, p->offset, &on_func_entry);
@@ -1651,7 +1662,12 @@ int register_kprobe(struct kprobe *p)
 	if (ret)
 		return ret;
 
+	start = local_clock();
 	ret = __register_kprobe(p);
+	if (!ret) {
+		atomic64_add(local_clock() - start, &kprobe_register_ns);
+		atomic_long_inc(&kprobe_nr_registered);
+	}
 
 	if (probed_mod)
 		module_put(probed_mod);
@@ -2975,6 +2991,16 @@ static const struct file_operations fops_kp = {
 	.llseek =	default_llseek,
 };
 
+static int kprobe_stats_show(struct seq_file *m, void *v)
+{
+	seq_printf(m, "registered: %ld\n",
+		   atomic_long_read(&kprobe_nr_registered));
+	seq_printf(m, "register_ns: %lld\n", atomic64_read(&kprobe_register_ns));
+	seq_printf(m, "arm_ns: %lld\n", atomic64_read(&kprobe_arm_ns));
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(kprobe_stats);
+
 static int __init debugfs_kprobe_init(void)
 {
 	struct dentry *dir;
@@ -2988,6 +3014,8 @@ static int __init debugfs_kprobe_init(void)
 	debugfs_create_file("blacklist", 0400, dir, NULL,
 			    &kprobe_blacklist_fops);
 
+	debugfs_create_file("stats", 0400, dir, NULL, &kprobe_stats_fops);
+
 	return 0;
 }
 
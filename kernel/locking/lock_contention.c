@@ -0,0 +1,367 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Sampling lock contention profiler
+ *
+ * The profiler attaches to the contention_begin/contention_end tracepoints
+ * only while <debugfs>/lock_contention/enable is set, so it costs nothing
+ * otherwise and doesn't need lockdep. One in "sample" contended acquisitions
+ * of spinlocks, rwlocks, mutexes, rwsems and semaphores is timed and charged
+ * to the stack that contended, saved in the stack depot.
+ *
+ * "stats" reports, for every contending stack, the number of sampled waits,
+ * their total and maximum wait time and a log2 histogram of the wait time.
+ * Writing to "reset" clears the collected data; the profiler has to be
+ * disabled for that. Once the stack depot is full, waits whose stack isn't
+ * in it yet are charged to a single "<no stack>" entry.
+ */
+#include <linux/debugfs.h>
+#include <linux/hash.h>
+#include <linux/irq_work.h>
+#include <linux/log2_hist.h>
+#include <linux/mutex.h>
+#include <linux/sched.h>
+#include <linux/sched/clock.h>
+#include <linux/seq_file.h>
+#include <linux/stackdepot.h>
+#include <linux/stacktrace.h>
+#include <linux/uaccess.h>
+#include <linux/workqueue.h>
+#include <trace/events/lock.h>
+
+#define LCP_WAIT_BITS		8	/* sampled waits in progress */
+#define LCP_NR_WAITS		(1 << LCP_WAIT_BITS)
+#define LCP_WAIT_PROBES		4
+#define LCP_SITE_BITS		10	/* distinct contending stacks */
+#define LCP_NR_SITES		(1 << LCP_SITE_BITS)
+#define LCP_SITE_PROBES		16
+#define LCP_NR_BUCKETS		16	/* <1us, <2us, ... <16ms, more */
+#define LCP_STACK_DEPTH		16
+
+struct lcp_wait {
+	struct task_struct	*task;
+	void			*lock;
+	u64			start;
+	depot_stack_handle_t	stack;
+	unsigned int		flags;
+};
+
+struct lcp_site {
+	depot_stack_handle_t	stack;
+	unsigned int		flags;
+	atomic64_t		count;
+	atomic64_t		total_ns;
+	atomic64_t		max_ns;
+	atomic_t		hist[LCP_NR_BUCKETS];
+};
+
+static struct lcp_wait lcp_waits[LCP_NR_WAITS];
+/* The last site collects waits whose stack couldn't be saved. */
+static struct lcp_site lcp_sites[LCP_NR_SITES + 1];
+static atomic_long_t lcp_dropped;
+
+static DEFINE_PER_CPU(unsigned int, lcp_seq);
+static DEFINE_PER_CPU(int, lcp_busy);
+static u32 lcp_sample = 64;
+static bool lcp_enabled;
+static DEFINE_MUTEX(lcp_mutex);
+
+/*
+ * Probes can run with any lock held and in NMI, so they never allocate.
+ * When the depot runs out of room for a new stack, the spare pool is
+ * refilled from a work item, kicked through irq_work since that is the
+ * only thing an NMI can do.
+ */
+static void lcp_refill_workfn(struct work_struct *work)
+{
+	stack_depot_prealloc(GFP_KERNEL);
+}
+static DECLARE_WORK(lcp_refill_work, lcp_refill_workfn);
+
+static void lcp_refill_irq_workfn(struct irq_work *work)
+{
+	schedule_work(&lcp_refill_work);
+}
+static DEFINE_IRQ_WORK(lcp_refill_irq_work, lcp_refill_irq_workfn);
+
+static struct lcp_wait *lcp_find_wait(void *lock, bool claim)
+{
+	unsigned int h = hash_ptr(current, LCP_WAIT_BITS);
+	struct lcp_wait *w;
+	int i;
+
+	for (i = 0; i < LCP_WAIT_PROBES; i++) {
+		w = &lcp_waits[(h + i) & (LCP_NR_WAITS - 1)];
+		if (READ_ONCE(w->task) == current && w->lock == lock)
+			return w;
+	}
+	if (!claim)
+		return NULL;
+
+	for (i = 0; i < LCP_WAIT_PROBES; i++) {
+		w = &lcp_waits[(h + i) & (LCP_NR_WAITS - 1)];
+		if (!cmpxchg(&w->task, NULL, current)) {
+			w->lock = NULL;
+			return w;
+		}
+	}
+	return NULL;
+}
+
+static struct lcp_site *lcp_find_site(depot_stack_handle_t stack,
+				      unsigned int flags)
+{
+	unsigned int h = hash_32(stack, LCP_SITE_BITS);
+	struct lcp_site *s;
+	int i;
+
+	if (!stack)
+		return &lcp_sites[LCP_NR_SITES];
+
+	for (i = 0; i < LCP_SITE_PROBES; i++) {
+		depot_stack_handle_t old;
+
+		s = &lcp_sites[(h + i) & (LCP_NR_SITES - 1)];
+		old = READ_ONCE(s->stack);
+		if (old == stack)
+			return s;
+		if (!old) {
+			old = cmpxchg(&s->stack, 0, stack);
+			if (!old) {
+				WRITE_ONCE(s->flags, flags);
+				return s;
+			}
+			if (old == stack)
+				return s;
+		}
+	}
+	return NULL;
+}
+
+static void lcp_account(struct lcp_wait *w, s64 delta)
+{
+	struct lcp_site *s = lcp_find_site(w->stack, w->flags);
+
+	if (!s) {
+		atomic_long_inc(&lcp_dropped);
+		return;
+	}
+
+	/* local_clock() isn't synchronized if a sleeping waiter migrated */
+	if (delta < 0)
+		delta = 0;
+
+	atomic64_inc(&s->count);
+	atomic64_add(delta, &s->total_ns);
+	atomic_inc(&s->hist[log2_hist_bucket_us(delta, LCP_NR_BUCKETS)]);
+	log2_hist_update_max(&s->max_ns, delta);
+}
+
+static void lcp_contention_begin(void *data, void *lock, unsigned int flags)
+{
+	unsigned long entries[LCP_STACK_DEPTH];
+	u32 rate = READ_ONCE(lcp_sample);
+	struct lcp_wait *w;
+	unsigned int nr;
+
+	if (rate > 1 && this_cpu_inc_return(lcp_seq) % rate)
+		return;
+
+	/* The stack depot may contend on its own lock. */
+	if (this_cpu_inc_return(lcp_busy) != 1)
+		goto out;
+
+	w = lcp_find_wait(lock, true);
+	if (!w) {
+		atomic_long_inc(&lcp_dropped);
+		goto out;
+	}
+	/* A mutex waiter reports contention again after spinning. */
+	if (w->lock == lock)
+		goto out;
+
+	nr = stack_trace_save(entries, ARRAY_SIZE(entries), 1);
+	w->stack = stack_depot_save_flags(entries, nr, 0, 0);
+	if (unlikely(!w->stack))
+		irq_work_queue(&lcp_refill_irq_work);
+	w->flags = flags;
+	w->start = local_clock();
+	w->lock = lock;
+out:
+	this_cpu_dec(lcp_busy);
+}
+
+static void lcp_contention_end(void *data, void *lock, int ret)
+{
+	struct lcp_wait *w;
+
+	if (this_cpu_inc_return(lcp_busy) != 1)
+		goto out;
+
+	w = lcp_find_wait(lock, false);
+	if (w) {
+		lcp_account(w, local_clock() - w->start);
+		smp_store_release(&w->task, NULL);
+	}
+out:
+	this_cpu_dec(lcp_busy);
+}
+
+static void *lcp_seq_start(struct seq_file *m, loff_t *pos)
+{
+	stack_depot_prealloc(GFP_KERNEL);
+	if (!*pos)
+		return SEQ_START_TOKEN;
+	return *pos <= LCP_NR_SITES + 1 ? &lcp_sites[*pos - 1] : NULL;
+}
+
+static void *lcp_seq_next(struct seq_file *m, void *v, loff_t *pos)
+{
+	++*pos;
+	return *pos <= LCP_NR_SITES + 1 ? &lcp_sites[*pos - 1] : NULL;
+}
+
+static void lcp_seq_stop(struct seq_file *m, void *v)
+{
+}
+
+static int lcp_seq_show(struct seq_file *m, void *v)
+{
+	struct lcp_site *s = v;
+	unsigned long *entries;
+	unsigned int nr, i;
+	u64 count;
+
+	if (v == SEQ_START_TOKEN) {
+		seq_printf(m, "dropped: %ld\n", atomic_long_read(&lcp_dropped));
+		log2_hist_seq_us_header(m, LCP_NR_BUCKETS);
+		return 0;
+	}
+
+	count = atomic64_read(&s->count);
+	if (!count)
+		return 0;
+
+	seq_printf(m, "\ncount %llu total_ns %lld max_ns %lld flags 0x%x\nhist:",
+		   count, atomic64_read(&s->total_ns),
+		   atomic64_read(&s->max_ns), READ_ONCE(s->flags));
+	for (i = 0; i < LCP_NR_BUCKETS; i++)
+		seq_printf(m, " %d", atomic_read(&s->hist[i]));
+	seq_putc(m, '\n');
+
+	if (s == &lcp_sites[LCP_NR_SITES]) {
+		seq_puts(m, "  <no stack>\n");
+		return 0;
+	}
+	nr = stack_depot_fetch(READ_ONCE(s->stack), &entries);
+	for (i = 0; i < nr; i++)
+		seq_printf(m, "  %pS\n", (void *)entries[i]);
+	return 0;
+}
+
+static const struct seq_operations lcp_stats_sops = {
+	.start	= lcp_seq_start,
+	.next	= lcp_seq_next,
+	.stop	= lcp_seq_stop,
+	.show	= lcp_seq_show,
+};
+DEFINE_SEQ_ATTRIBUTE(lcp_stats);
+
+static int lcp_set_enabled(bool enable)
+{
+	int ret = 0;
+
+	mutex_lock(&lcp_mutex);
+	if (enable == lcp_enabled)
+		goto out;
+
+	if (enable) {
+		stack_depot_prealloc(GFP_KERNEL);
+		ret = register_trace_contention_begin(lcp_contention_begin, NULL);
+		if (ret)
+			goto out;
+		ret = register_trace_contention_end(lcp_contention_end, NULL);
+		if (ret) {
+			unregister_trace_contention_begin(lcp_contention_begin,
+							  NULL);
+			tracepoint_synchronize_unregister();
+			goto out;
+		}
+	} else {
+		unregister_trace_contention_begin(lcp_contention_begin, NULL);
+		unregister_trace_contention_end(lcp_contention_end, NULL);
+		tracepoint_synchronize_unregister();
+		irq_work_sync(&lcp_refill_irq_work);
+		cancel_work_sync(&lcp_refill_work);
+		/* Waits that were in progress will never see their end. */
+		memset(lcp_waits, 0, sizeof(lcp_waits));
+	}
+	lcp_enabled = enable;
+out:
+	mutex_unlock(&lcp_mutex);
+	return ret;
+}
+
+static ssize_t lcp_enable_read(struct file *file, char __user *user_buf,
+			       size_t count, loff_t *ppos)
+{
+	char buf[3] = { READ_ONCE(lcp_enabled) ? 'Y' : 'N', '\n', '\0' };
+
+	return simple_read_from_buffer(user_buf, count, ppos, buf, 2);
+}
+
+static ssize_t lcp_enable_write(struct file *file, const char __user *user_buf,
+				size_t count, loff_t *ppos)
+{
+	bool enable;
+	int ret;
+
+	ret = kstrtobool_from_user(user_buf, count, &enable);
+	if (ret)
+		return ret;
+
+	ret = lcp_set_enabled(enable);
+	return ret ? ret : count;
+}
+
+static const struct file_operations lcp_enable_fops = {
+	.read	= lcp_enable_read,
+	.write	= lcp_enable_write,
+	.llseek	= default_llseek,
+};
+
+static ssize_t lcp_reset_write(struct file *file, const char __user *user_buf,
+			       size_t count, loff_t *ppos)
+{
+	ssize_t ret = count;
+
+	mutex_lock(&lcp_mutex);
+	if (lcp_enabled) {
+		ret = -EBUSY;
+	} else {
+		memset(lcp_sites, 0, sizeof(lcp_sites));
+		atomic_long_set(&lcp_dropped, 0);
+	}
+	mutex_unlock(&lcp_mutex);
+	return ret;
+}
+
+static const struct file_operations lcp_reset_fops = {
+	.write	= lcp_reset_write,
+	.llseek	= noop_llseek,
+};
+
+static int __init lcp_init(void)
+{
+	struct dentry *dir;
+
+	if (stack_depot_init())
+		return -ENOMEM;
+
+	dir = debugfs_create_dir("lock_contention", NULL);
+	debugfs_create_file("enable", 0600, dir, NULL, &lcp_enable_fops);
+	debugfs_create_u32("sample", 0600, dir, &lcp_sample);
+	debugfs_create_file("stats", 0400, dir, NULL, &lcp_stats_fops);
+	debugfs_create_file("reset", 0200, dir, NULL, &lcp_reset_fops);
+	return 0;
+}
+late_initcall(lcp_init);
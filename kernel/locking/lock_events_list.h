@@ -47,6 +47,8 @@ LOCK_EVENT(lock_use_node2)	/* # of locking ops that use 2nd percpu node */
 LOCK_EVENT(lock_use_node3)	/* # of locking ops that use 3rd percpu node */
 LOCK_EVENT(lock_use_node4)	/* # of locking ops that use 4th percpu node */
 LOCK_EVENT(lock_no_node)	/* # of locking ops w/o using percpu node    */
+LOCK_EVENT(lock_handoff_local)	/* # of MCS handoffs within a NUMA node	     */
+LOCK_EVENT(lock_handoff_remote)	/* # of MCS handoffs to another NUMA node    */
 #endif /* CONFIG_QUEUED_SPINLOCKS */
 
 /*
@@ -67,12 +69,20 @@ LOCK_EVENT(rwsem_opt_nospin)	/* # of disabled optspins		*/
 LOCK_EVENT(rwsem_rlock)		/* # of read locks acquired		*/
 LOCK_EVENT(rwsem_rlock_steal)	/* # of read locks by lock stealing	*/
 LOCK_EVENT(rwsem_rlock_fast)	/* # of fast read locks acquired	*/
+LOCK_EVENT(rwsem_rlock_shared)	/* # of read locks with readers already in */
 LOCK_EVENT(rwsem_rlock_fail)	/* # of failed read lock acquisitions	*/
 LOCK_EVENT(rwsem_rlock_handoff)	/* # of read lock handoffs		*/
 LOCK_EVENT(rwsem_wlock)		/* # of write locks acquired		*/
 LOCK_EVENT(rwsem_wlock_fail)	/* # of failed write lock acquisitions	*/
 LOCK_EVENT(rwsem_wlock_handoff)	/* # of write lock handoffs		*/
 
+/*
+ * Locking events for mutex optimistic spinning
+ */
+LOCK_EVENT(mutex_opt_lock)	/* # of locks acquired by optspin	*/
+LOCK_EVENT(mutex_opt_fail)	/* # of failed optspins			*/
+LOCK_EVENT(mutex_opt_wasted_us)	/* Total us spun before failed optspins	*/
+
 /*
  * Locking events for rtlock_slowlock()
  */
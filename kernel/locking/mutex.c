@@ -29,12 +29,14 @@
 #include <linux/interrupt.h>
 #include <linux/debug_locks.h>
 #include <linux/osq_lock.h>
+#include <linux/sched/clock.h>
 
 #define CREATE_TRACE_POINTS
 #include <trace/events/lock.h>
 
 #ifndef CONFIG_PREEMPT_RT
 #include "mutex.h"
+#include "lock_events.h"
 
 #ifdef CONFIG_DEBUG_MUTEXES
 # define MUTEX_WARN_ON(cond) DEBUG_LOCKS_WARN_ON(cond)
@@ -432,6 +434,8 @@ static __always_inline bool
 mutex_optimistic_spin(struct mutex *lock, struct ww_acquire_ctx *ww_ctx,
 		      struct mutex_waiter *waiter)
 {
+	u64 start = 0;
+
 	if (!waiter) {
 		/*
 		 * The purpose of the mutex_can_spin_on_owner() function is
@@ -452,6 +456,9 @@ mutex_optimistic_spin(struct mutex *lock, struct ww_acquire_ctx *ww_ctx,
 			goto fail;
 	}
 
+	if (IS_ENABLED(CONFIG_LOCK_EVENT_COUNTS))
+		start = sched_clock();
+
 	for (;;) {
 		struct task_struct *owner;
 
@@ -479,6 +486,7 @@ mutex_optimistic_spin(struct mutex *lock, struct ww_acquire_ctx *ww_ctx,
 	if (!waiter)
 		osq_unlock(&lock->osq);
 
+	lockevent_inc(mutex_opt_lock);
 	return true;
 
 
@@ -486,6 +494,15 @@ mutex_optimistic_spin(struct mutex *lock, struct ww_acquire_ctx *ww_ctx,
 	if (!waiter)
 		osq_unlock(&lock->osq);
 
+	lockevent_inc(mutex_opt_fail);
+	/*
+	 * Time spent spinning on an owner that didn't let go in time, in us
+	 * so that long spins don't overflow lockevent_add()'s int.
+	 */
+	if (IS_ENABLED(CONFIG_LOCK_EVENT_COUNTS))
+		lockevent_add(mutex_opt_wasted_us,
+			      div_u64(sched_clock() - start, NSEC_PER_USEC));
+
 fail:
 	/*
 	 * If we fell out of the spin path because of need_resched(),
@@ -93,6 +93,25 @@ static __always_inline u32  __pv_wait_head_or_lock(struct qspinlock *lock,
 						   struct mcs_spinlock *node)
 						   { return 0; }
 
+#ifdef CONFIG_LOCK_EVENT_COUNTS
+static __always_inline void qnode_init_numa(struct mcs_spinlock *node)
+{
+	((struct qnode *)node)->numa_node = numa_node_id();
+}
+
+/* Count whether the MCS handoff to @next stays on this NUMA node. */
+static __always_inline void qnode_count_handoff(struct mcs_spinlock *next)
+{
+	if (((struct qnode *)next)->numa_node == numa_node_id())
+		lockevent_inc(lock_handoff_local);
+	else
+		lockevent_inc(lock_handoff_remote);
+}
+#else
+static __always_inline void qnode_init_numa(struct mcs_spinlock *node) { }
+static __always_inline void qnode_count_handoff(struct mcs_spinlock *next) { }
+#endif
+
 #define pv_enabled()		false
 
 #define pv_init_node		__pv_init_node
@@ -251,6 +270,7 @@ void __lockfunc queued_spin_lock_slowpath(struct qspinlock *lock, u32 val)
 	node->locked = 0;
 	node->next = NULL;
 	pv_init_node(node);
+	qnode_init_numa(node);
 
 	/*
 	 * We touched a (possibly) cold cacheline in the per-cpu queue node;
@@ -367,6 +387,7 @@ void __lockfunc queued_spin_lock_slowpath(struct qspinlock *lock, u32 val)
 	if (!next)
 		next = smp_cond_load_relaxed(&node->next, (VAL));
 
+	qnode_count_handoff(next);
 	arch_mcs_spin_unlock_contended(&next->locked);
 	pv_kick_node(lock, next);
 
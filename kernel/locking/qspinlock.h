@@ -36,12 +36,18 @@
  * to have more than 2 levels of slowpath nesting in actual use. We don't
  * want to penalize pvqspinlocks to optimize for a rare case in native
  * qspinlocks.
+ *
+ * CONFIG_LOCK_EVENT_COUNTS adds the node id of the waiter, which is debug
+ * only and doesn't need to keep that layout.
  */
 struct qnode {
 	struct mcs_spinlock mcs;
 #ifdef CONFIG_PARAVIRT_SPINLOCKS
 	long reserved[2];
 #endif
+#ifdef CONFIG_LOCK_EVENT_COUNTS
+	int numa_node;		/* for lock_handoff_{local,remote} */
+#endif
 };
 
 /*
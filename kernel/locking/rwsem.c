@@ -253,6 +253,12 @@ static inline bool rwsem_read_trylock(struct rw_semaphore *sem, long *cntp)
 		rwsem_set_nonspinnable(sem);
 
 	if (!(*cntp & RWSEM_READ_FAILED_MASK)) {
+		/*
+		 * Other readers were in, so the count (and owner) cache
+		 * line most likely had to be pulled from another CPU.
+		 */
+		lockevent_cond_inc(rwsem_rlock_shared,
+				   (*cntp & RWSEM_READER_MASK) > RWSEM_READER_BIAS);
 		rwsem_set_reader_owned(sem);
 		return true;
 	}
@@ -194,8 +194,12 @@ extern atomic_long_t total_mod_size;
 extern atomic_long_t total_text_size;
 extern atomic_long_t invalid_kread_bytes;
 extern atomic_long_t invalid_decompress_bytes;
+extern atomic_long_t load_module_ns;
+extern atomic_long_t link_module_ns;
+extern atomic_long_t init_module_ns;
 
 extern atomic_t modcount;
+extern atomic_t initialized_modules;
 extern atomic_t failed_kreads;
 extern atomic_t failed_decompress;
 struct mod_fail_load {
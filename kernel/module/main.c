@@ -34,6 +34,7 @@
 #include <linux/vermagic.h>
 #include <linux/notifier.h>
 #include <linux/sched.h>
+#include <linux/sched/clock.h>
 #include <linux/device.h>
 #include <linux/string.h>
 #include <linux/mutex.h>
@@ -3258,6 +3259,8 @@ static int load_module(struct load_info *info, const char __user *uargs,
 	bool module_allocated = false;
 	long err = 0;
 	char *after_dashes;
+	u64 start __maybe_unused = local_clock();
+	u64 link_ns __maybe_unused, load_ns __maybe_unused;
 
 	/*
 	 * Do the signature check (if any) first. All that
@@ -3338,6 +3341,7 @@ static int load_module(struct load_info *info, const char __user *uargs,
 	setup_modinfo(mod, info);
 
 	/* Fix up syms, so that st_value is a pointer to location. */
+	link_ns = local_clock();
 	err = simplify_symbols(mod, info);
 	if (err < 0)
 		goto free_modinfo;
@@ -3345,6 +3349,7 @@ static int load_module(struct load_info *info, const char __user *uargs,
 	err = apply_relocations(mod, info);
 	if (err < 0)
 		goto free_modinfo;
+	link_ns = local_clock() - link_ns;
 
 	err = post_relocation(mod, info);
 	if (err < 0)
@@ -3406,7 +3411,16 @@ static int load_module(struct load_info *info, const char __user *uargs,
 	/* Done! */
 	trace_module_load(mod);
 
-	return do_init_module(mod);
+	load_ns = local_clock() - start;
+	start = local_clock();
+	err = do_init_module(mod);
+	if (!err) {
+		mod_stat_inc(&initialized_modules);
+		mod_stat_add_long(load_ns, &load_module_ns);
+		mod_stat_add_long(link_ns, &link_module_ns);
+		mod_stat_add_long(local_clock() - start, &init_module_ns);
+	}
+	return err;
 
  sysfs_cleanup:
 	mod_sysfs_teardown(mod);
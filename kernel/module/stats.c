@@ -191,6 +191,15 @@ static LIST_HEAD(dup_failed_modules);
  *    but it is perhaps not easy to fix them. A recent example are the modules
  *    requests incurred for frequency modules, a separate module request was
  *    being issued for each CPU on a system.
+ *  * initialized_modules: how many modules we've loaded whose init routine
+ *    succeeded. The three timing counters below only cover these modules.
+ *  * load_module_ns: total time spent by successful module loads from the
+ *    signature check to calling the module's init routine. This covers
+ *    the time spent waiting on module_mutex.
+ *  * link_module_ns: the part of load_module_ns spent resolving symbols and
+ *    applying relocations.
+ *  * init_module_ns: total time spent in do_init_module(), that is in the
+ *    modules' init routines and in freeing their init sections.
  */
 
 atomic_long_t total_mod_size;
@@ -200,10 +209,14 @@ atomic_long_t invalid_decompress_bytes;
 static atomic_long_t invalid_becoming_bytes;
 static atomic_long_t invalid_mod_bytes;
 atomic_t modcount;
+atomic_t initialized_modules;
 atomic_t failed_kreads;
 atomic_t failed_decompress;
 static atomic_t failed_becoming;
 static atomic_t failed_load_modules;
+atomic_long_t load_module_ns;
+atomic_long_t link_module_ns;
+atomic_long_t init_module_ns;
 
 static const char *mod_fail_to_str(struct mod_fail_load *mod_fail)
 {
@@ -277,15 +290,17 @@ static ssize_t read_file_mod_stats(struct file *file, char __user *user_buf,
 	unsigned int len, size, count_failed = 0;
 	char *buf;
 	int ret;
-	u32 live_mod_count, fkreads, fdecompress, fbecoming, floads;
+	u32 live_mod_count, fkreads, fdecompress, fbecoming, floads, inits;
 	unsigned long total_size, text_size, ikread_bytes, ibecoming_bytes,
 		idecompress_bytes, imod_bytes, total_virtual_lost;
+	unsigned long load_ns, link_ns, init_ns;
 
 	live_mod_count = atomic_read(&modcount);
 	fkreads = atomic_read(&failed_kreads);
 	fdecompress = atomic_read(&failed_decompress);
 	fbecoming = atomic_read(&failed_becoming);
 	floads = atomic_read(&failed_load_modules);
+	inits = atomic_read(&initialized_modules);
 
 	total_size = atomic_long_read(&total_mod_size);
 	text_size = atomic_long_read(&total_text_size);
@@ -293,6 +308,9 @@ static ssize_t read_file_mod_stats(struct file *file, char __user *user_buf,
 	idecompress_bytes = atomic_long_read(&invalid_decompress_bytes);
 	ibecoming_bytes = atomic_long_read(&invalid_becoming_bytes);
 	imod_bytes = atomic_long_read(&invalid_mod_bytes);
+	load_ns = atomic_long_read(&load_module_ns);
+	link_ns = atomic_long_read(&link_module_ns);
+	init_ns = atomic_long_read(&init_module_ns);
 
 	total_virtual_lost = ikread_bytes + idecompress_bytes + ibecoming_bytes + imod_bytes;
 
@@ -337,6 +355,15 @@ static ssize_t read_file_mod_stats(struct file *file, char __user *user_buf,
 				 DIV_ROUND_UP(text_size, live_mod_count));
 	}
 
+	if (inits) {
+		len += scnprintf(buf + len, size - len, "%25s\t%lu\n", "Average load ns",
+				 load_ns / inits);
+		len += scnprintf(buf + len, size - len, "%25s\t%lu\n", "Average link ns",
+				 link_ns / inits);
+		len += scnprintf(buf + len, size - len, "%25s\t%lu\n", "Average init ns",
+				 init_ns / inits);
+	}
+
 	/*
 	 * We use WARN_ON_ONCE() for the counters to ensure we always have parity
 	 * for keeping tabs on a type of failure with one type of byte counter.
@@ -416,8 +443,12 @@ static int __init module_stats_init(void)
 	mod_debug_add_ulong(invalid_decompress_bytes);
 	mod_debug_add_ulong(invalid_becoming_bytes);
 	mod_debug_add_ulong(invalid_mod_bytes);
+	mod_debug_add_ulong(load_module_ns);
+	mod_debug_add_ulong(link_module_ns);
+	mod_debug_add_ulong(init_module_ns);
 
 	mod_debug_add_atomic(modcount);
+	mod_debug_add_atomic(initialized_modules);
 	mod_debug_add_atomic(failed_kreads);
 	mod_debug_add_atomic(failed_decompress);
 	mod_debug_add_atomic(failed_becoming);
@@ -228,6 +228,7 @@ int padata_do_parallel(struct padata_shell *ps,
 
 	spin_lock(&padata_works_lock);
 	padata->seq_nr = ++pd->seq_nr;
+	pinst->nr_parallel++;
 	pw = padata_work_alloc();
 	spin_unlock(&padata_works_lock);
 
@@ -289,6 +290,7 @@ static struct padata_priv *padata_find_next(struct parallel_data *pd,
 
 	if (remove_object) {
 		list_del_init(&padata->list);
+		atomic_dec(&pd->reorder_objects);
 		++pd->processed;
 		pd->cpu = cpumask_next_wrap(cpu, pd->cpumask.pcpu);
 	}
@@ -326,8 +328,12 @@ static void padata_reorder(struct parallel_data *pd)
 		 * processed by another cpu and is still on it's way to the
 		 * cpu's reorder queue, nothing to do for now.
 		 */
-		if (!padata)
+		if (!padata) {
+			/* Done objects are waiting behind a missing one */
+			if (atomic_read(&pd->reorder_objects))
+				atomic_long_inc(&pinst->reorder_stalls);
 			break;
+		}
 
 		cb_cpu = padata->cb_cpu;
 		squeue = per_cpu_ptr(pd->squeue, cb_cpu);
@@ -432,6 +438,7 @@ void padata_do_serial(struct padata_priv *padata)
 			break;
 	}
 	list_add(&padata->list, pos);
+	atomic_inc(&pd->reorder_objects);
 	spin_unlock(&reorder->lock);
 
 	/*
@@ -631,6 +638,7 @@ static struct parallel_data *padata_alloc_pd(struct padata_shell *ps)
 	padata_init_squeues(pd);
 	pd->seq_nr = -1;
 	refcount_set(&pd->refcnt, 1);
+	atomic_set(&pd->reorder_objects, 0);
 	spin_lock_init(&pd->lock);
 	pd->cpu = cpumask_first(pd->cpumask.pcpu);
 	INIT_WORK(&pd->reorder_work, invoke_padata_reorder);
@@ -953,17 +961,58 @@ static ssize_t store_cpumask(struct padata_instance *pinst,
 	static struct padata_sysfs_entry _name##_attr = \
 		__ATTR(_name, 0400, _show_name, NULL)
 
+static ssize_t show_nr_parallel(struct padata_instance *pinst,
+				struct attribute *attr, char *buf)
+{
+	return sysfs_emit(buf, "%lu\n", data_race(pinst->nr_parallel));
+}
+
+static ssize_t show_in_flight(struct padata_instance *pinst,
+			      struct attribute *attr, char *buf)
+{
+	struct padata_shell *ps;
+	unsigned int in_flight = 0;
+
+	mutex_lock(&pinst->lock);
+	list_for_each_entry(ps, &pinst->pslist, list) {
+		struct parallel_data *pd;
+
+		pd = rcu_dereference_protected(ps->pd, 1);
+		in_flight += READ_ONCE(pd->seq_nr) + 1 - READ_ONCE(pd->processed);
+	}
+	mutex_unlock(&pinst->lock);
+
+	return sysfs_emit(buf, "%u\n", in_flight);
+}
+
+static ssize_t show_reorder_stalls(struct padata_instance *pinst,
+				   struct attribute *attr, char *buf)
+{
+	return sysfs_emit(buf, "%ld\n",
+			  atomic_long_read(&pinst->reorder_stalls));
+}
+
 PADATA_ATTR_RW(serial_cpumask, show_cpumask, store_cpumask);
 PADATA_ATTR_RW(parallel_cpumask, show_cpumask, store_cpumask);
+PADATA_ATTR_RO(nr_parallel, show_nr_parallel);
+PADATA_ATTR_RO(in_flight, show_in_flight);
+PADATA_ATTR_RO(reorder_stalls, show_reorder_stalls);
 
 /*
  * Padata sysfs provides the following objects:
  * serial_cpumask   [RW] - cpumask for serial workers
  * parallel_cpumask [RW] - cpumask for parallel workers
+ * nr_parallel      [RO] - objects submitted
+ * in_flight        [RO] - objects submitted but not yet serialized
+ * reorder_stalls   [RO] - times serialization waited for an object while
+ *                         later ones were already done
  */
 static struct attribute *padata_default_attrs[] = {
 	&serial_cpumask_attr.attr,
 	&parallel_cpumask_attr.attr,
+	&nr_parallel_attr.attr,
+	&in_flight_attr.attr,
+	&reorder_stalls_attr.attr,
 	NULL,
 };
 ATTRIBUTE_GROUPS(padata_default);
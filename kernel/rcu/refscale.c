@@ -92,6 +92,8 @@ torture_param(int, nreaders, -1, "Number of readers, -1 for 75% of CPUs.");
 torture_param(int, nruns, 30, "Number of experiments to run.");
 // Reader delay in nanoseconds, 0 for no delay.
 torture_param(int, readdelay, 0, "Read-side delay in nanoseconds.");
+// Grace periods timed after each experiment, 0 to skip.
+torture_param(int, gp_loops, 0, "Grace periods timed per experiment.");
 
 #ifdef MODULE
 # define REFSCALE_SHUTDOWN 0
@@ -136,6 +138,7 @@ struct ref_scale_ops {
 	void (*cleanup)(void);
 	void (*readsection)(const int nloops);
 	void (*delaysection)(const int nloops, const int udl, const int ndl);
+	void (*sync)(void);
 	const char *name;
 };
 
@@ -179,6 +182,7 @@ static const struct ref_scale_ops rcu_ops = {
 	.init		= rcu_sync_scale_init,
 	.readsection	= ref_rcu_read_section,
 	.delaysection	= ref_rcu_delay_section,
+	.sync		= synchronize_rcu,
 	.name		= "rcu"
 };
 
@@ -186,6 +190,11 @@ static const struct ref_scale_ops rcu_ops = {
 DEFINE_STATIC_SRCU(srcu_refctl_scale);
 static struct srcu_struct *srcu_ctlp = &srcu_refctl_scale;
 
+static void srcu_ref_scale_sync(void)
+{
+	synchronize_srcu(srcu_ctlp);
+}
+
 static void srcu_ref_scale_read_section(const int nloops)
 {
 	int i;
@@ -213,6 +222,7 @@ static const struct ref_scale_ops srcu_ops = {
 	.init		= rcu_sync_scale_init,
 	.readsection	= srcu_ref_scale_read_section,
 	.delaysection	= srcu_ref_scale_delay_section,
+	.sync		= srcu_ref_scale_sync,
 	.name		= "srcu"
 };
 
@@ -243,6 +253,7 @@ static const struct ref_scale_ops srcu_fast_ops = {
 	.init		= rcu_sync_scale_init,
 	.readsection	= srcu_fast_ref_scale_read_section,
 	.delaysection	= srcu_fast_ref_scale_delay_section,
+	.sync		= srcu_ref_scale_sync,
 	.name		= "srcu-fast"
 };
 
@@ -273,6 +284,7 @@ static const struct ref_scale_ops srcu_lite_ops = {
 	.init		= rcu_sync_scale_init,
 	.readsection	= srcu_lite_ref_scale_read_section,
 	.delaysection	= srcu_lite_ref_scale_delay_section,
+	.sync		= srcu_ref_scale_sync,
 	.name		= "srcu-lite"
 };
 
@@ -300,6 +312,7 @@ static const struct ref_scale_ops rcu_tasks_ops = {
 	.init		= rcu_sync_scale_init,
 	.readsection	= rcu_tasks_ref_scale_read_section,
 	.delaysection	= rcu_tasks_ref_scale_delay_section,
+	.sync		= synchronize_rcu_tasks,
 	.name		= "rcu-tasks"
 };
 
@@ -339,6 +352,7 @@ static const struct ref_scale_ops rcu_trace_ops = {
 	.init		= rcu_sync_scale_init,
 	.readsection	= rcu_trace_ref_scale_read_section,
 	.delaysection	= rcu_trace_ref_scale_delay_section,
+	.sync		= synchronize_rcu_tasks_trace,
 	.name		= "rcu-trace"
 };
 
@@ -1034,6 +1048,20 @@ static u64 process_durations(int n)
 	return sum;
 }
 
+// Average grace-period latency in nanoseconds over gp_loops grace periods,
+// measured with the readers idle, so that it reflects the cost of scanning
+// every CPU rather than waiting for readers.
+static u64 ref_scale_gp_latency(void)
+{
+	u64 start;
+	int i;
+
+	start = ktime_get_mono_fast_ns();
+	for (i = 0; i < gp_loops && !torture_must_stop(); i++)
+		cur_ops->sync();
+	return div_u64(ktime_get_mono_fast_ns() - start, gp_loops);
+}
+
 // The main_func is the main orchestrator, it performs a bunch of
 // experiments.  For every experiment, it orders all the readers
 // involved to start and waits for them to finish the experiment. It
@@ -1046,6 +1074,7 @@ static int main_func(void *arg)
 	char buf1[64];
 	char *buf;
 	u64 *result_avg;
+	u64 *result_gp = NULL;
 
 	set_cpus_allowed_ptr(current, cpumask_of(nreaders % nr_cpu_ids));
 	set_user_nice(current, MAX_NICE);
@@ -1053,7 +1082,9 @@ static int main_func(void *arg)
 	VERBOSE_SCALEOUT("main_func task started");
 	result_avg = kzalloc(nruns * sizeof(*result_avg), GFP_KERNEL);
 	buf = kzalloc(800 + 64, GFP_KERNEL);
-	if (!result_avg || !buf) {
+	if (gp_loops > 0)
+		result_gp = kcalloc(nruns, sizeof(*result_gp), GFP_KERNEL);
+	if (!result_avg || !buf || (gp_loops > 0 && !result_gp)) {
 		SCALEOUT_ERRSTRING("out of memory");
 		goto oom_exit;
 	}
@@ -1096,19 +1127,25 @@ static int main_func(void *arg)
 			goto end;
 
 		result_avg[exp] = div_u64(1000 * process_durations(nreaders), nreaders * loops);
+		if (result_gp)
+			result_gp[exp] = ref_scale_gp_latency();
 	}
 	rcu_scale_warm_cool();
 
 	// Print the average of all experiments
 	SCALEOUT("END OF TEST. Calculating average duration per loop (nanoseconds)...\n");
 
-	pr_alert("Runs\tTime(ns)\n");
+	pr_alert("Runs\tTime(ns)%s\n", result_gp ? "\tGP(ns)" : "");
 	for (exp = 0; exp < nruns; exp++) {
 		u64 avg;
 		u32 rem;
 
 		avg = div_u64_rem(result_avg[exp], 1000, &rem);
-		sprintf(buf1, "%d\t%llu.%03u\n", exp + 1, avg, rem);
+		if (result_gp)
+			sprintf(buf1, "%d\t%llu.%03u\t%llu\n", exp + 1, avg, rem,
+				result_gp[exp]);
+		else
+			sprintf(buf1, "%d\t%llu.%03u\n", exp + 1, avg, rem);
 		strcat(buf, buf1);
 		if (strlen(buf) >= 800) {
 			pr_alert("%s", buf);
@@ -1132,6 +1169,7 @@ static int main_func(void *arg)
 end:
 	torture_kthread_stopping("main_func");
 	kfree(result_avg);
+	kfree(result_gp);
 	kfree(buf);
 	return 0;
 }
@@ -1140,8 +1178,8 @@ static void
 ref_scale_print_module_parms(const struct ref_scale_ops *cur_ops, const char *tag)
 {
 	pr_alert("%s" SCALE_FLAG
-		 "--- %s:  verbose=%d verbose_batched=%d shutdown=%d holdoff=%d lookup_instances=%ld loops=%ld nreaders=%d nruns=%d readdelay=%d\n", scale_type, tag,
-		 verbose, verbose_batched, shutdown, holdoff, lookup_instances, loops, nreaders, nruns, readdelay);
+		 "--- %s:  verbose=%d verbose_batched=%d shutdown=%d holdoff=%d lookup_instances=%ld loops=%ld nreaders=%d nruns=%d readdelay=%d gp_loops=%d\n", scale_type, tag,
+		 verbose, verbose_batched, shutdown, holdoff, lookup_instances, loops, nreaders, nruns, readdelay, gp_loops);
 }
 
 static void
@@ -1223,6 +1261,11 @@ ref_scale_init(void)
 			goto unwind;
 		}
 
+	if (gp_loops > 0 && !cur_ops->sync) {
+		pr_alert("%s: gp_loops not supported, ignored\n", cur_ops->name);
+		gp_loops = 0;
+	}
+
 	ref_scale_print_module_parms(cur_ops, "Start of test");
 
 	// Shutdown task
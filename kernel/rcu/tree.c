@@ -2484,6 +2484,41 @@ static bool rcu_do_batch_check_time(long count, long tlimit,
 	       local_clock() >= tlimit;
 }
 
+#ifdef CONFIG_RCU_CB_LATENCY
+/*
+ * Time one callback at a time per CPU from call_rcu() to its invocation.
+ * A callback that goes elsewhere, for example because its CPU went offline,
+ * is given up on after ten seconds.  Called with interrupts disabled.
+ */
+static void rcu_cb_lat_sample(struct rcu_data *rdp, struct rcu_head *head)
+{
+	if (READ_ONCE(rdp->cb_lat_head) &&
+	    time_before(jiffies, rdp->cb_lat_jiffies + 10 * HZ))
+		return;
+	rdp->cb_lat_start = local_clock();
+	rdp->cb_lat_jiffies = jiffies;
+	smp_store_release(&rdp->cb_lat_head, head);
+}
+
+/* Account the timed callback if @rhp is it. */
+static void rcu_cb_lat_check(struct rcu_data *rdp, struct rcu_head *rhp)
+{
+	u64 lat;
+
+	if (likely(rhp != smp_load_acquire(&rdp->cb_lat_head)))
+		return;
+	lat = local_clock() - rdp->cb_lat_start;
+	WRITE_ONCE(rdp->cb_lat_nr, rdp->cb_lat_nr + 1);
+	WRITE_ONCE(rdp->cb_lat_total, rdp->cb_lat_total + lat);
+	if (lat > rdp->cb_lat_max)
+		WRITE_ONCE(rdp->cb_lat_max, lat);
+	WRITE_ONCE(rdp->cb_lat_head, NULL);
+}
+#else /* #ifdef CONFIG_RCU_CB_LATENCY */
+static void rcu_cb_lat_sample(struct rcu_data *rdp, struct rcu_head *head) { }
+static void rcu_cb_lat_check(struct rcu_data *rdp, struct rcu_head *rhp) { }
+#endif /* #else #ifdef CONFIG_RCU_CB_LATENCY */
+
 /*
  * Invoke any RCU callbacks that have made it to the end of their grace
  * period.  Throttle as specified by rdp->blimit.
@@ -2558,6 +2593,7 @@ static void rcu_do_batch(struct rcu_data *rdp)
 
 		count++;
 		debug_rcu_head_unqueue(rhp);
+		rcu_cb_lat_check(rdp, rhp);
 
 		rcu_lock_acquire(&rcu_callback_map);
 		trace_rcu_invoke_callback(rcu_state.name, rhp);
@@ -3099,6 +3135,7 @@ __call_rcu_common(struct rcu_head *head, rcu_callback_t func, bool lazy_in)
 	}
 
 	check_cb_ovld(rdp);
+	rcu_cb_lat_sample(rdp, head);
 
 	if (unlikely(rcu_rdp_is_offloaded(rdp)))
 		call_rcu_nocb(rdp, head, func, flags, lazy);
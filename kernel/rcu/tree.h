@@ -204,6 +204,14 @@ struct rcu_data {
 	unsigned long	n_force_qs_snap;
 					/* did other CPU force QS recently? */
 	long		blimit;		/* Upper limit on a processed batch */
+#ifdef CONFIG_RCU_CB_LATENCY
+	struct rcu_head	*cb_lat_head;	/* Callback being timed, if any. */
+	u64		cb_lat_start;	/*  ... local_clock() at call_rcu(). */
+	unsigned long	cb_lat_jiffies;	/*  ... and jiffies at call_rcu(). */
+	unsigned long	cb_lat_nr;	/* # of timed callbacks. */
+	u64		cb_lat_total;	/* Their total latency (ns). */
+	u64		cb_lat_max;	/* The largest of them (ns). */
+#endif /* #ifdef CONFIG_RCU_CB_LATENCY */
 
 	/* 3) dynticks interface. */
 	int  watching_snap;		/* Per-GP tracking for dynticks. */
@@ -375,6 +383,8 @@ struct rcu_state {
 	struct mutex exp_mutex;			/* Serialize expedited GP. */
 	struct mutex exp_wake_mutex;		/* Serialize wakeup. */
 	unsigned long expedited_sequence;	/* Take a ticket. */
+	atomic_long_t expedited_ipis;		/* # IPIs sent for exp GPs. */
+	atomic_long_t expedited_merged;		/* # callers that piggybacked. */
 	atomic_t expedited_need_qs;		/* # CPUs left to check in. */
 	struct swait_queue_head expedited_wq;	/* Wait for check-ins. */
 	int ncpus_snap;				/* # CPUs seen last time. */
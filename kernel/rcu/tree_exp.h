@@ -420,8 +420,10 @@ static void __sync_rcu_exp_select_node_cpus(struct rcu_exp_work *rewp)
 		ret = smp_call_function_single(cpu, rcu_exp_handler, NULL, 0);
 		put_cpu();
 		/* The CPU will report the QS in response to the IPI. */
-		if (!ret)
+		if (!ret) {
+			atomic_long_inc(&rcu_state.expedited_ipis);
 			continue;
+		}
 
 		/* Failed, raced with CPU hotplug operation. */
 		raw_spin_lock_irqsave_rcu_node(rnp, flags);
@@ -915,6 +917,7 @@ static void sync_sched_exp_online_cleanup(int cpu)
 	ret = smp_call_function_single(cpu, rcu_exp_handler, NULL, 0);
 	put_cpu();
 	WARN_ON_ONCE(ret);
+	atomic_long_inc(&rcu_state.expedited_ipis);
 }
 
 /*
@@ -995,8 +998,10 @@ void synchronize_rcu_expedited(void)
 
 	/* Take a snapshot of the sequence number.  */
 	s = rcu_exp_gp_seq_snap();
-	if (exp_funnel_lock(s))
+	if (exp_funnel_lock(s)) {
+		atomic_long_inc(&rcu_state.expedited_merged);
 		return;  /* Someone else did our work for us. */
+	}
 
 	/* Ensure that load happens before action based on it. */
 	if (unlikely((rcu_scheduler_active == RCU_SCHEDULER_INIT) || !rcu_exp_worker_started())) {
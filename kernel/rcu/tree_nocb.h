@@ -1607,6 +1607,15 @@ static void show_rcu_nocb_state(struct rcu_data *rdp)
 		rdp->nocb_cb_kthread ? (int)task_cpu(rdp->nocb_cb_kthread) : -1,
 		show_rcu_should_be_on_cpu(rdp->nocb_cb_kthread));
 
+#ifdef CONFIG_RCU_CB_LATENCY
+	if (READ_ONCE(rdp->cb_lat_nr))
+		pr_info("   CB %d latency: %lu timed, avg %llu us, max %llu us\n",
+			rdp->cpu, READ_ONCE(rdp->cb_lat_nr),
+			div64_ul(READ_ONCE(rdp->cb_lat_total),
+				 READ_ONCE(rdp->cb_lat_nr) * NSEC_PER_USEC),
+			div_u64(READ_ONCE(rdp->cb_lat_max), NSEC_PER_USEC));
+#endif /* #ifdef CONFIG_RCU_CB_LATENCY */
+
 	/* It is OK for GP kthreads to have GP state. */
 	if (rdp->nocb_gp_rdp == rdp)
 		return;
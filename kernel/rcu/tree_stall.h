@@ -931,6 +931,10 @@ void show_rcu_gp_kthreads(void)
 			show_rcu_nocb_state(rdp);
 	}
 	pr_info("RCU callbacks invoked since boot: %lu\n", cbs);
+	pr_info("RCU expedited GPs: %lu IPIs: %ld merged requests: %ld\n",
+		rcu_seq_ctr(data_race(READ_ONCE(rcu_state.expedited_sequence))),
+		atomic_long_read(&rcu_state.expedited_ipis),
+		atomic_long_read(&rcu_state.expedited_merged));
 	show_rcu_tasks_gp_kthreads();
 }
 EXPORT_SYMBOL_GPL(show_rcu_gp_kthreads);
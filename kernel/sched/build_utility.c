@@ -18,6 +18,7 @@
 #include <linux/sched/mm.h>
 #include <linux/sched/rseq_api.h>
 #include <linux/sched/task_stack.h>
+#include <linux/sched/wake_q.h>
 
 #include <linux/cpufreq.h>
 #include <linux/cpumask_api.h>
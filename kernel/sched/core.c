@@ -1064,6 +1064,10 @@ void wake_up_q(struct wake_q_head *head)
 {
 	struct wake_q_node *node = head->first;
 
+	if (node == WAKE_Q_TAIL)
+		return;
+
+	wake_batch_begin();
 	while (node != WAKE_Q_TAIL) {
 		struct task_struct *task;
 
@@ -1080,6 +1084,7 @@ void wake_up_q(struct wake_q_head *head)
 		wake_up_process(task);
 		put_task_struct(task);
 	}
+	wake_batch_end();
 }
 
 /*
@@ -3864,6 +3869,60 @@ bool call_function_single_prep_ipi(int cpu)
 	return true;
 }
 
+/*
+ * Wakeups queued between wake_batch_begin() and wake_batch_end() only kick
+ * each target CPU once, at the end of the batch, rather than once per
+ * wakeup that finds the target's queue empty. The target then activates
+ * all the tasks of the batch in one go from sched_ttwu_pending().
+ */
+#define WAKE_BATCH_NR_CPUS	16
+
+struct wake_batch {
+	unsigned int	nesting;
+	unsigned int	nr_queued;
+	unsigned int	nr_cpus;
+	int		cpus[WAKE_BATCH_NR_CPUS];
+};
+
+static DEFINE_PER_CPU(struct wake_batch, wake_batch);
+
+static void wake_batch_flush(struct wake_batch *wb)
+{
+	unsigned int i;
+
+	for (i = 0; i < wb->nr_cpus; i++)
+		smp_call_single_queue_kick(wb->cpus[i]);
+
+	schedstat_add(this_rq()->ttwu_coalesced, wb->nr_queued - wb->nr_cpus);
+	wb->nr_queued = 0;
+	wb->nr_cpus = 0;
+}
+
+#ifndef CONFIG_PREEMPT_RT
+/**
+ * wake_batch_begin - start coalescing the IPIs of remote wakeups
+ *
+ * Disables preemption until the matching wake_batch_end(). Batches nest.
+ */
+void wake_batch_begin(void)
+{
+	preempt_disable();
+	this_cpu_inc(wake_batch.nesting);
+}
+
+/**
+ * wake_batch_end - send the IPIs of the wakeups queued since wake_batch_begin()
+ */
+void wake_batch_end(void)
+{
+	struct wake_batch *wb = this_cpu_ptr(&wake_batch);
+
+	if (!--wb->nesting && wb->nr_queued)
+		wake_batch_flush(wb);
+	preempt_enable();
+}
+#endif /* !CONFIG_PREEMPT_RT */
+
 /*
  * Queue a task on the target CPUs wake_list and wake the CPU via IPI if
  * necessary. The wakee CPU on receipt of the IPI will queue the task
@@ -3872,12 +3931,26 @@ bool call_function_single_prep_ipi(int cpu)
  */
 static void __ttwu_queue_wakelist(struct task_struct *p, int cpu, int wake_flags)
 {
+	struct wake_batch *wb = this_cpu_ptr(&wake_batch);
 	struct rq *rq = cpu_rq(cpu);
 
 	p->sched_remote_wakeup = !!(wake_flags & WF_MIGRATED);
 
 	WRITE_ONCE(rq->ttwu_pending, 1);
-	__smp_call_single_queue(cpu, &p->wake_entry.llist);
+
+	/* Interrupts don't know when the batch they interrupted ends */
+	if (!wb->nesting || !in_task()) {
+		__smp_call_single_queue(cpu, &p->wake_entry.llist);
+		return;
+	}
+
+	wb->nr_queued++;
+	if (!__smp_call_single_queue_noipi(cpu, &p->wake_entry.llist))
+		return;
+
+	if (wb->nr_cpus == WAKE_BATCH_NR_CPUS)
+		wake_batch_flush(wb);
+	wb->cpus[wb->nr_cpus++] = cpu;
 }
 
 void wake_up_if_idle(int cpu)
@@ -9823,6 +9896,20 @@ static int cpu_idle_write_s64(struct cgroup_subsys_state *css,
 }
 #endif
 
+#ifdef CONFIG_FAIR_GROUP_SCHED
+static s64 cpu_latency_nice_read_s64(struct cgroup_subsys_state *css,
+				     struct cftype *cft)
+{
+	return READ_ONCE(css_tg(css)->latency_nice);
+}
+
+static int cpu_latency_nice_write_s64(struct cgroup_subsys_state *css,
+				      struct cftype *cft, s64 latency_nice)
+{
+	return sched_group_set_latency_nice(css_tg(css), latency_nice);
+}
+#endif
+
 static struct cftype cpu_legacy_files[] = {
 #ifdef CONFIG_GROUP_SCHED_WEIGHT
 	{
@@ -9836,6 +9923,13 @@ static struct cftype cpu_legacy_files[] = {
 		.write_s64 = cpu_idle_write_s64,
 	},
 #endif
+#ifdef CONFIG_FAIR_GROUP_SCHED
+	{
+		.name = "latency_nice",
+		.read_s64 = cpu_latency_nice_read_s64,
+		.write_s64 = cpu_latency_nice_write_s64,
+	},
+#endif
 #ifdef CONFIG_CFS_BANDWIDTH
 	{
 		.name = "cfs_quota_us",
@@ -9930,6 +10024,29 @@ static int cpu_local_stat_show(struct seq_file *sf,
 		seq_printf(sf, "throttled_usec %llu\n",
 			   throttled_self_usec);
 	}
+#endif
+#ifdef CONFIG_FAIR_GROUP_SCHED
+	{
+		struct task_group *tg = css_tg(css);
+		unsigned long hist[CFS_WAIT_HIST_BUCKETS] = {};
+		unsigned long nr_preempt = 0, limit;
+		int cpu, i;
+
+		for_each_possible_cpu(cpu) {
+			struct cfs_rq *cfs_rq = tg->cfs_rq[cpu];
+
+			nr_preempt += READ_ONCE(cfs_rq->nr_wakeup_preempt);
+			for (i = 0; i < CFS_WAIT_HIST_BUCKETS; i++)
+				hist[i] += READ_ONCE(cfs_rq->wait_hist[i]);
+		}
+
+		seq_printf(sf, "nr_wakeup_preempt %lu\n", nr_preempt);
+		/* Labelled by bucket upper bound, the last one is unbounded */
+		for (i = 0, limit = CFS_WAIT_HIST_MIN_USEC;
+		     i < CFS_WAIT_HIST_BUCKETS - 1; i++, limit *= 4)
+			seq_printf(sf, "wait_usec_lt_%lu %lu\n", limit, hist[i]);
+		seq_printf(sf, "wait_usec_ge_%lu %lu\n", limit / 4, hist[i]);
+	}
 #endif
 	return 0;
 }
@@ -10076,6 +10193,14 @@ static struct cftype cpu_files[] = {
 		.write_s64 = cpu_idle_write_s64,
 	},
 #endif
+#ifdef CONFIG_FAIR_GROUP_SCHED
+	{
+		.name = "latency_nice",
+		.flags = CFTYPE_NOT_ON_ROOT,
+		.read_s64 = cpu_latency_nice_read_s64,
+		.write_s64 = cpu_latency_nice_write_s64,
+	},
+#endif
 #ifdef CONFIG_CFS_BANDWIDTH
 	{
 		.name = "max",
@@ -11,6 +11,8 @@
 struct sugov_tunables {
 	struct gov_attr_set	attr_set;
 	unsigned int		rate_limit_us;
+	unsigned int		util_est_forecast;
+	unsigned int		latency_boost;
 };
 
 struct sugov_policy {
@@ -23,6 +25,7 @@ struct sugov_policy {
 	u64			last_freq_update_time;
 	s64			freq_update_delay_ns;
 	unsigned int		next_freq;
+	unsigned int		next_flags;
 	unsigned int		cached_raw_freq;
 
 	/* The next fields are only needed if fast switch cannot be used: */
@@ -35,6 +38,7 @@ struct sugov_policy {
 
 	bool			limits_changed;
 	bool			need_freq_update;
+	bool			forecast_pending;
 };
 
 struct sugov_cpu {
@@ -44,6 +48,7 @@ struct sugov_cpu {
 
 	bool			iowait_boost_pending;
 	unsigned int		iowait_boost;
+	bool			latency_boost_pending;
 	u64			last_update;
 
 	unsigned long		util;
@@ -87,13 +92,18 @@ static bool sugov_should_update_freq(struct sugov_policy *sg_policy, u64 time)
 		return true;
 	}
 
+	if (sg_policy->forecast_pending) {
+		sg_policy->forecast_pending = false;
+		return true;
+	}
+
 	delta_ns = time - sg_policy->last_freq_update_time;
 
 	return delta_ns >= sg_policy->freq_update_delay_ns;
 }
 
 static bool sugov_update_next_freq(struct sugov_policy *sg_policy, u64 time,
-				   unsigned int next_freq)
+				   unsigned int next_freq, unsigned int flags)
 {
 	if (sg_policy->need_freq_update)
 		sg_policy->need_freq_update = false;
@@ -101,6 +111,7 @@ static bool sugov_update_next_freq(struct sugov_policy *sg_policy, u64 time,
 		return false;
 
 	sg_policy->next_freq = next_freq;
+	sg_policy->next_flags = flags;
 	sg_policy->last_freq_update_time = time;
 
 	return true;
@@ -358,6 +369,53 @@ static bool sugov_hold_freq(struct sugov_cpu *sg_cpu)
 static inline bool sugov_hold_freq(struct sugov_cpu *sg_cpu) { return false; }
 #endif /* CONFIG_NO_HZ_COMMON */
 
+/**
+ * sugov_forecast() - Act on the wakeup of a task ahead of PELT.
+ * @sg_cpu: the sugov data for the CPU the task woke up on
+ * @flags: SCHED_CPUFREQ_* flags of the update
+ *
+ * On wakeup the task's util_est is already accounted to the CPU while its
+ * PELT contribution only builds up over the next milliseconds. With
+ * util_est_forecast set, let the next frequency decision bypass the rate limit
+ * if the forecast asks for more than the last decision did, so that bursty
+ * work doesn't run its first slices at a low frequency.
+ *
+ * The wakeup of a latency sensitive task (negative cpu.latency_nice) also
+ * requests a one-off latency_boost for the next decision.
+ */
+static void sugov_forecast(struct sugov_cpu *sg_cpu, unsigned int flags)
+{
+	struct sugov_policy *sg_policy = sg_cpu->sg_policy;
+	struct sugov_tunables *tunables = sg_policy->tunables;
+
+	if ((flags & SCHED_CPUFREQ_LATENCY) && READ_ONCE(tunables->latency_boost)) {
+		sg_cpu->latency_boost_pending = true;
+		sg_policy->forecast_pending = true;
+		return;
+	}
+
+	if (!(flags & SCHED_CPUFREQ_FORECAST) ||
+	    !READ_ONCE(tunables->util_est_forecast))
+		return;
+
+	if (map_util_perf(cpu_util_cfs_boost(sg_cpu->cpu)) > sg_cpu->util)
+		sg_policy->forecast_pending = true;
+}
+
+static unsigned long sugov_latency_apply(struct sugov_cpu *sg_cpu,
+					 unsigned long max_cap)
+{
+	unsigned int boost;
+
+	if (!sg_cpu->latency_boost_pending)
+		return 0;
+
+	sg_cpu->latency_boost_pending = false;
+	boost = READ_ONCE(sg_cpu->sg_policy->tunables->latency_boost);
+
+	return (boost * max_cap) >> SCHED_CAPACITY_SHIFT;
+}
+
 /*
  * Make sugov_should_update_freq() ignore the rate limit when DL
  * has increased the utilization.
@@ -378,11 +436,13 @@ static inline bool sugov_update_single_common(struct sugov_cpu *sg_cpu,
 	sg_cpu->last_update = time;
 
 	ignore_dl_rate_limit(sg_cpu);
+	sugov_forecast(sg_cpu, flags);
 
 	if (!sugov_should_update_freq(sg_cpu->sg_policy, time))
 		return false;
 
-	boost = sugov_iowait_apply(sg_cpu, time, max_cap);
+	boost = max(sugov_iowait_apply(sg_cpu, time, max_cap),
+		    sugov_latency_apply(sg_cpu, max_cap));
 	sugov_get_util(sg_cpu, boost);
 
 	return true;
@@ -412,7 +472,7 @@ static void sugov_update_single_freq(struct update_util_data *hook, u64 time,
 		sg_policy->cached_raw_freq = cached_freq;
 	}
 
-	if (!sugov_update_next_freq(sg_policy, time, next_f))
+	if (!sugov_update_next_freq(sg_policy, time, next_f, flags))
 		return;
 
 	/*
@@ -422,6 +482,8 @@ static void sugov_update_single_freq(struct update_util_data *hook, u64 time,
 	 */
 	if (sg_policy->policy->fast_switch_enabled) {
 		cpufreq_driver_fast_switch(sg_policy->policy, next_f);
+		trace_schedutil_freq_decision(sg_cpu->cpu, next_f, sg_cpu->util,
+					      flags, local_clock() - time);
 	} else {
 		raw_spin_lock(&sg_policy->update_lock);
 		sugov_deferred_update(sg_policy);
@@ -456,6 +518,8 @@ static void sugov_update_single_perf(struct update_util_data *hook, u64 time,
 
 	cpufreq_driver_adjust_perf(sg_cpu->cpu, sg_cpu->bw_min,
 				   sg_cpu->util, max_cap);
+	trace_schedutil_freq_decision(sg_cpu->cpu, 0, sg_cpu->util, flags,
+				      local_clock() - time);
 
 	sg_cpu->sg_policy->last_freq_update_time = time;
 }
@@ -473,7 +537,8 @@ static unsigned int sugov_next_freq_shared(struct sugov_cpu *sg_cpu, u64 time)
 		struct sugov_cpu *j_sg_cpu = &per_cpu(sugov_cpu, j);
 		unsigned long boost;
 
-		boost = sugov_iowait_apply(j_sg_cpu, time, max_cap);
+		boost = max(sugov_iowait_apply(j_sg_cpu, time, max_cap),
+			    sugov_latency_apply(j_sg_cpu, max_cap));
 		sugov_get_util(j_sg_cpu, boost);
 
 		util = max(j_sg_cpu->util, util);
@@ -495,17 +560,22 @@ sugov_update_shared(struct update_util_data *hook, u64 time, unsigned int flags)
 	sg_cpu->last_update = time;
 
 	ignore_dl_rate_limit(sg_cpu);
+	sugov_forecast(sg_cpu, flags);
 
 	if (sugov_should_update_freq(sg_policy, time)) {
 		next_f = sugov_next_freq_shared(sg_cpu, time);
 
-		if (!sugov_update_next_freq(sg_policy, time, next_f))
+		if (!sugov_update_next_freq(sg_policy, time, next_f, flags))
 			goto unlock;
 
-		if (sg_policy->policy->fast_switch_enabled)
+		if (sg_policy->policy->fast_switch_enabled) {
 			cpufreq_driver_fast_switch(sg_policy->policy, next_f);
-		else
+			trace_schedutil_freq_decision(sg_policy->policy->cpu,
+						      next_f, sg_cpu->util,
+						      flags, local_clock() - time);
+		} else {
 			sugov_deferred_update(sg_policy);
+		}
 	}
 unlock:
 	raw_spin_unlock(&sg_policy->update_lock);
@@ -514,8 +584,9 @@ sugov_update_shared(struct update_util_data *hook, u64 time, unsigned int flags)
 static void sugov_work(struct kthread_work *work)
 {
 	struct sugov_policy *sg_policy = container_of(work, struct sugov_policy, work);
-	unsigned int freq;
+	unsigned int freq, update_flags;
 	unsigned long flags;
+	u64 time;
 
 	/*
 	 * Hold sg_policy->update_lock shortly to handle the case where:
@@ -529,12 +600,17 @@ static void sugov_work(struct kthread_work *work)
 	 */
 	raw_spin_lock_irqsave(&sg_policy->update_lock, flags);
 	freq = sg_policy->next_freq;
+	update_flags = sg_policy->next_flags;
+	time = sg_policy->last_freq_update_time;
 	sg_policy->work_in_progress = false;
 	raw_spin_unlock_irqrestore(&sg_policy->update_lock, flags);
 
 	mutex_lock(&sg_policy->work_lock);
 	__cpufreq_driver_target(sg_policy->policy, freq, CPUFREQ_RELATION_L);
 	mutex_unlock(&sg_policy->work_lock);
+
+	trace_schedutil_freq_decision(sg_policy->policy->cpu, freq, 0,
+				      update_flags, local_clock() - time);
 }
 
 static void sugov_irq_work(struct irq_work *irq_work)
@@ -583,8 +659,87 @@ rate_limit_us_store(struct gov_attr_set *attr_set, const char *buf, size_t count
 
 static struct governor_attr rate_limit_us = __ATTR_RW(rate_limit_us);
 
+/*
+ * enqueue_task_fair() only reports wakeups to cpufreq while the tunables of
+ * some policy act on them. Stores are serialized by the attr_set update_lock.
+ * The tunables can be freed from cpufreq_offline() with cpu_hotplug_lock
+ * held, so the last decrement is left to a work item.
+ */
+DEFINE_STATIC_KEY_DEFERRED_FALSE(sched_cpufreq_forecast, HZ);
+
+static bool sugov_tunables_forecast(struct sugov_tunables *tunables)
+{
+	return tunables->util_est_forecast || tunables->latency_boost;
+}
+
+static void sugov_forecast_key_update(struct sugov_tunables *tunables,
+				      bool was_enabled)
+{
+	bool enabled = sugov_tunables_forecast(tunables);
+
+	if (enabled && !was_enabled)
+		static_branch_deferred_inc(&sched_cpufreq_forecast);
+	else if (!enabled && was_enabled)
+		static_branch_slow_dec_deferred(&sched_cpufreq_forecast);
+}
+
+static ssize_t util_est_forecast_show(struct gov_attr_set *attr_set, char *buf)
+{
+	struct sugov_tunables *tunables = to_sugov_tunables(attr_set);
+
+	return sprintf(buf, "%u\n", tunables->util_est_forecast);
+}
+
+static ssize_t
+util_est_forecast_store(struct gov_attr_set *attr_set, const char *buf, size_t count)
+{
+	struct sugov_tunables *tunables = to_sugov_tunables(attr_set);
+	bool was_enabled = sugov_tunables_forecast(tunables);
+	bool enable;
+
+	if (kstrtobool(buf, &enable))
+		return -EINVAL;
+
+	WRITE_ONCE(tunables->util_est_forecast, enable);
+	sugov_forecast_key_update(tunables, was_enabled);
+
+	return count;
+}
+
+static struct governor_attr util_est_forecast = __ATTR_RW(util_est_forecast);
+
+static ssize_t latency_boost_show(struct gov_attr_set *attr_set, char *buf)
+{
+	struct sugov_tunables *tunables = to_sugov_tunables(attr_set);
+
+	return sprintf(buf, "%u\n", tunables->latency_boost);
+}
+
+static ssize_t
+latency_boost_store(struct gov_attr_set *attr_set, const char *buf, size_t count)
+{
+	struct sugov_tunables *tunables = to_sugov_tunables(attr_set);
+	bool was_enabled = sugov_tunables_forecast(tunables);
+	unsigned int latency_boost;
+
+	if (kstrtouint(buf, 10, &latency_boost))
+		return -EINVAL;
+
+	if (latency_boost > SCHED_CAPACITY_SCALE)
+		return -EINVAL;
+
+	WRITE_ONCE(tunables->latency_boost, latency_boost);
+	sugov_forecast_key_update(tunables, was_enabled);
+
+	return count;
+}
+
+static struct governor_attr latency_boost = __ATTR_RW(latency_boost);
+
 static struct attribute *sugov_attrs[] = {
 	&rate_limit_us.attr,
+	&util_est_forecast.attr,
+	&latency_boost.attr,
 	NULL
 };
 ATTRIBUTE_GROUPS(sugov);
@@ -592,8 +747,11 @@ ATTRIBUTE_GROUPS(sugov);
 static void sugov_tunables_free(struct kobject *kobj)
 {
 	struct gov_attr_set *attr_set = to_gov_attr_set(kobj);
+	struct sugov_tunables *tunables = to_sugov_tunables(attr_set);
 
-	kfree(to_sugov_tunables(attr_set));
+	if (sugov_tunables_forecast(tunables))
+		static_branch_slow_dec_deferred(&sched_cpufreq_forecast);
+	kfree(tunables);
 }
 
 static const struct kobj_type sugov_tunables_ktype = {
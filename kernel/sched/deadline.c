@@ -1212,6 +1212,29 @@ static void __push_dl_task(struct rq *rq, struct rq_flags *rf)
 #endif
 }
 
+/*
+ * Account the time the fair server spends throttled with its runtime
+ * exhausted, i.e. the time fair tasks were held off by higher classes
+ * after having used up their guaranteed bandwidth for the period.
+ */
+static void dl_server_throttle_start(struct rq *rq, struct sched_dl_entity *dl_se)
+{
+	if (dl_se != &rq->fair_server)
+		return;
+
+	rq->fair_server_throttle_start = rq_clock(rq);
+	rq->fair_server_nr_throttled++;
+}
+
+static void dl_server_throttle_end(struct rq *rq, struct sched_dl_entity *dl_se)
+{
+	if (dl_se != &rq->fair_server || !rq->fair_server_throttle_start)
+		return;
+
+	rq->fair_server_throttled_time += rq_clock(rq) - rq->fair_server_throttle_start;
+	rq->fair_server_throttle_start = 0;
+}
+
 /* a defer timer will not be reset if the runtime consumed was < dl_server_min_res */
 static const u64 dl_server_min_res = 1 * NSEC_PER_MSEC;
 
@@ -1233,6 +1256,7 @@ static enum hrtimer_restart dl_server_timer(struct hrtimer *timer, struct sched_
 			return HRTIMER_NORESTART;
 
 		if (!dl_se->server_has_tasks(dl_se)) {
+			dl_server_throttle_end(rq, dl_se);
 			replenish_dl_entity(dl_se);
 			return HRTIMER_NORESTART;
 		}
@@ -1257,6 +1281,7 @@ static enum hrtimer_restart dl_server_timer(struct hrtimer *timer, struct sched_
 			dl_se->dl_defer_running = 1;
 		}
 
+		dl_server_throttle_end(rq, dl_se);
 		enqueue_dl_entity(dl_se, ENQUEUE_REPLENISH);
 
 		if (!dl_task(dl_se->rq->curr) || dl_entity_preempt(dl_se, &dl_se->rq->curr->dl))
@@ -1527,6 +1552,7 @@ static void update_curr_dl_se(struct rq *rq, struct sched_dl_entity *dl_se, s64
 
 		hrtimer_try_to_cancel(&dl_se->dl_timer);
 
+		dl_server_throttle_end(rq, dl_se);
 		replenish_dl_new_period(dl_se, dl_se->rq);
 
 		/*
@@ -1553,13 +1579,17 @@ static void update_curr_dl_se(struct rq *rq, struct sched_dl_entity *dl_se, s64
 		if (!dl_server(dl_se)) {
 			update_stats_dequeue_dl(&rq->dl, dl_se, 0);
 			dequeue_pushable_dl_task(rq, dl_task_of(dl_se));
+		} else if (dl_runtime_exceeded(dl_se)) {
+			dl_server_throttle_start(rq, dl_se);
 		}
 
 		if (unlikely(is_dl_boosted(dl_se) || !start_dl_timer(dl_se))) {
-			if (dl_server(dl_se))
+			if (dl_server(dl_se)) {
+				dl_server_throttle_end(rq, dl_se);
 				enqueue_dl_entity(dl_se, ENQUEUE_REPLENISH);
-			else
+			} else {
 				enqueue_task_dl(rq, dl_task_of(dl_se), ENQUEUE_REPLENISH);
+			}
 		}
 
 		if (!is_leftmost(dl_se, &rq->dl))
@@ -1677,6 +1707,7 @@ void dl_server_stop(struct sched_dl_entity *dl_se)
 	if (!dl_se->dl_runtime)
 		return;
 
+	dl_server_throttle_end(dl_se->rq, dl_se);
 	dequeue_dl_entity(dl_se, DEQUEUE_SLEEP);
 	hrtimer_try_to_cancel(&dl_se->dl_timer);
 	dl_se->dl_defer_armed = 0;
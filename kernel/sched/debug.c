@@ -492,12 +492,15 @@ static void debugfs_fair_server_init(void)
 
 		debugfs_create_file("runtime", 0644, d_cpu, (void *) cpu, &fair_server_runtime_fops);
 		debugfs_create_file("period", 0644, d_cpu, (void *) cpu, &fair_server_period_fops);
+		debugfs_create_u64("throttled_time", 0444, d_cpu, &cpu_rq(cpu)->fair_server_throttled_time);
+		debugfs_create_u64("nr_throttled", 0444, d_cpu, &cpu_rq(cpu)->fair_server_nr_throttled);
 	}
 }
 
 static __init int sched_init_debug(void)
 {
 	struct dentry __maybe_unused *numa;
+	struct dentry __maybe_unused *membarrier;
 
 	debugfs_sched = debugfs_create_dir("sched", NULL);
 
@@ -516,6 +519,7 @@ static __init int sched_init_debug(void)
 	debugfs_create_file("tunable_scaling", 0644, debugfs_sched, NULL, &sched_scaling_fops);
 	debugfs_create_u32("migration_cost_ns", 0644, debugfs_sched, &sysctl_sched_migration_cost);
 	debugfs_create_u32("nr_migrate", 0644, debugfs_sched, &sysctl_sched_nr_migrate);
+	debugfs_create_u32("blocked_load_min", 0644, debugfs_sched, &sysctl_sched_blocked_load_min);
 
 	sched_domains_mutex_lock();
 	update_sched_domain_debugfs();
@@ -534,6 +538,15 @@ static __init int sched_init_debug(void)
 
 	debugfs_create_file("debug", 0444, debugfs_sched, NULL, &sched_debug_fops);
 
+#ifdef CONFIG_MEMBARRIER
+	membarrier = debugfs_create_dir("membarrier", debugfs_sched);
+
+	debugfs_create_u64("rounds", 0444, membarrier, &membarrier_stats.rounds);
+	debugfs_create_u64("rounds_shared", 0444, membarrier, &membarrier_stats.rounds_shared);
+	debugfs_create_u64("ipis", 0444, membarrier, &membarrier_stats.ipis);
+	debugfs_create_u64("ipis_avoided", 0444, membarrier, &membarrier_stats.ipis_avoided);
+#endif
+
 	debugfs_fair_server_init();
 
 	return 0;
@@ -582,6 +595,9 @@ static void register_sd(struct sched_domain *sd, struct dentry *parent)
 	SDM(u32,   0644, imbalance_pct);
 	SDM(u32,   0644, cache_nice_tries);
 	SDM(str,   0444, name);
+#ifdef CONFIG_SCHEDSTATS
+	SDM(u64,   0444, lb_time);
+#endif
 
 #undef SDM
 
@@ -986,6 +1002,9 @@ do {									\
 		P(sched_goidle);
 		P(ttwu_count);
 		P(ttwu_local);
+		P(blocked_update_skipped);
+		SEQ_printf(m, "  .%-30s: %Ld\n", "blocked_update_time",
+			   (long long)rq->blocked_update_time);
 	}
 #undef P
 
@@ -992,6 +992,28 @@ static const struct rhashtable_params dsq_hash_params = {
 static struct rhashtable dsq_hash;
 static LLIST_HEAD(dsqs_to_free);
 
+enum scx_dsq_shards_consts {
+	/*
+	 * destroy_dsq() holds every shard lock at once, keep the number of
+	 * shards well below MAX_LOCK_DEPTH. Further LLCs share shards.
+	 */
+	SCX_DSQ_MAX_SHARDS	= 32,
+};
+
+/*
+ * A sharded user DSQ, created with scx_bpf_create_sharded_dsq(), is split into
+ * one shard per LLC. Only the parent DSQ is on dsq_hash and it never holds any
+ * task itself. Tasks are inserted into the shard of the LLC of their CPU and
+ * consumers drain the shard of their own LLC first before stealing from the
+ * others, so the shard locks are only shared inside an LLC in the common case.
+ */
+struct scx_dsq_shards {
+	u32			nr;
+	u32			*cpu_to_shard;
+	struct rcu_head		rcu;
+	struct scx_dispatch_q	dsqs[];
+};
+
 /* dispatch buf */
 struct scx_dsp_buf_ent {
 	struct task_struct	*task;
@@ -1094,6 +1116,29 @@ static struct scx_dispatch_q *find_user_dsq(u64 dsq_id)
 	return rhashtable_lookup_fast(&dsq_hash, &dsq_id, dsq_hash_params);
 }
 
+static struct scx_dispatch_q *dsq_shard(struct scx_dispatch_q *dsq, s32 cpu)
+{
+	struct scx_dsq_shards *shards = dsq->shards;
+
+	if (!shards)
+		return dsq;
+	return &shards->dsqs[shards->cpu_to_shard[cpu]];
+}
+
+/*
+ * Lock a non-local DSQ and count the acquisitions that had to wait for it. The
+ * count is exposed through scx_bpf_dsq_nr_contended() to help BPF schedulers
+ * decide whether a DSQ should be sharded.
+ */
+static void dsq_lock(struct scx_dispatch_q *dsq)
+{
+	if (likely(raw_spin_trylock(&dsq->lock)))
+		return;
+
+	raw_spin_lock(&dsq->lock);
+	WRITE_ONCE(dsq->nr_contended, dsq->nr_contended + 1);
+}
+
 /*
  * scx_kf_mask enforcement. Some kfuncs can only be called from specific SCX
  * ops. When invoking SCX ops, SCX_CALL_OP[_RET]() should be used to indicate
@@ -1825,7 +1870,7 @@ static void dispatch_enqueue(struct scx_dispatch_q *dsq, struct task_struct *p,
 		     !RB_EMPTY_NODE(&p->scx.dsq_priq));
 
 	if (!is_local) {
-		raw_spin_lock(&dsq->lock);
+		dsq_lock(dsq);
 		if (unlikely(dsq->id == SCX_DSQ_INVALID)) {
 			scx_ops_error("attempting to dispatch to a destroyed dsq");
 			/* fall back to the global dsq */
@@ -2024,7 +2069,7 @@ static struct scx_dispatch_q *find_dsq_for_dispatch(struct rq *rq, u64 dsq_id,
 		return find_global_dsq(p);
 	}
 
-	return dsq;
+	return dsq_shard(dsq, task_cpu(p));
 }
 
 static void mark_direct_dispatch(struct task_struct *ddsp_task,
@@ -2701,7 +2746,7 @@ static bool consume_dispatch_q(struct rq *rq, struct scx_dispatch_q *dsq)
 	if (list_empty(&dsq->list))
 		return false;
 
-	raw_spin_lock(&dsq->lock);
+	dsq_lock(dsq);
 
 	nldsq_for_each_task(p, dsq) {
 		struct rq *task_rq = task_rq(p);
@@ -2731,6 +2776,27 @@ static bool consume_global_dsq(struct rq *rq)
 	return consume_dispatch_q(rq, global_dsqs[node]);
 }
 
+static bool consume_user_dsq(struct rq *rq, struct scx_dispatch_q *dsq)
+{
+	struct scx_dsq_shards *shards = dsq->shards;
+	u32 home, i;
+
+	if (!shards)
+		return consume_dispatch_q(rq, dsq);
+
+	/* drain the shard of our own LLC first and then steal from the others */
+	home = shards->cpu_to_shard[cpu_of(rq)];
+	for (i = 0; i < shards->nr; i++) {
+		u32 idx = home + i;
+
+		if (idx >= shards->nr)
+			idx -= shards->nr;
+		if (consume_dispatch_q(rq, &shards->dsqs[idx]))
+			return true;
+	}
+	return false;
+}
+
 /**
  * dispatch_to_local_dsq - Dispatch a task to a local dsq
  * @rq: current rq which is locked
@@ -4157,7 +4223,65 @@ static void init_dsq(struct scx_dispatch_q *dsq, u64 dsq_id)
 	dsq->id = dsq_id;
 }
 
-static struct scx_dispatch_q *create_dsq(u64 dsq_id, int node)
+static s32 scx_cpu_llc_id(s32 cpu)
+{
+#ifdef CONFIG_SMP
+	s32 llc = per_cpu(sd_llc_id, cpu);
+
+	/* offline CPUs may not have been attached to any domain yet */
+	if (llc >= 0 && llc < nr_cpu_ids)
+		return llc;
+#endif
+	return 0;
+}
+
+/*
+ * Build the per-LLC shards of a sharded DSQ. The CPU to shard mapping is taken
+ * from the LLC topology at creation time and stays fixed for the lifetime of
+ * the DSQ. Topology changes afterwards only make the mapping less precise.
+ */
+static struct scx_dsq_shards *alloc_dsq_shards(u64 dsq_id)
+{
+	struct scx_dsq_shards *shards;
+	cpumask_var_t seen;
+	u32 nr = 0, i;
+	s32 cpu;
+
+	if (!zalloc_cpumask_var(&seen, GFP_KERNEL))
+		return NULL;
+
+	for_each_possible_cpu(cpu)
+		if (!cpumask_test_and_set_cpu(scx_cpu_llc_id(cpu), seen))
+			nr++;
+	nr = min_t(u32, nr, SCX_DSQ_MAX_SHARDS);
+
+	shards = kzalloc(struct_size(shards, dsqs, nr) +
+			 nr_cpu_ids * sizeof(u32), GFP_KERNEL);
+	if (!shards)
+		goto out_free_seen;
+
+	shards->nr = nr;
+	shards->cpu_to_shard = (u32 *)&shards->dsqs[nr];
+	for (i = 0; i < nr; i++)
+		init_dsq(&shards->dsqs[i], dsq_id);
+
+	/* the LLC ID is the first CPU of the LLC, use its slot to number LLCs */
+	cpumask_clear(seen);
+	nr = 0;
+	for_each_possible_cpu(cpu) {
+		s32 llc = scx_cpu_llc_id(cpu);
+
+		if (!cpumask_test_and_set_cpu(llc, seen))
+			shards->cpu_to_shard[llc] = nr++ % SCX_DSQ_MAX_SHARDS;
+		shards->cpu_to_shard[cpu] = shards->cpu_to_shard[llc];
+	}
+
+out_free_seen:
+	free_cpumask_var(seen);
+	return shards;
+}
+
+static struct scx_dispatch_q *create_dsq(u64 dsq_id, int node, bool sharded)
 {
 	struct scx_dispatch_q *dsq;
 	int ret;
@@ -4171,9 +4295,18 @@ static struct scx_dispatch_q *create_dsq(u64 dsq_id, int node)
 
 	init_dsq(dsq, dsq_id);
 
+	if (sharded) {
+		dsq->shards = alloc_dsq_shards(dsq_id);
+		if (!dsq->shards) {
+			kfree(dsq);
+			return ERR_PTR(-ENOMEM);
+		}
+	}
+
 	ret = rhashtable_lookup_insert_fast(&dsq_hash, &dsq->hash_node,
 					    dsq_hash_params);
 	if (ret) {
+		kfree(dsq->shards);
 		kfree(dsq);
 		return ERR_PTR(ret);
 	}
@@ -4185,16 +4318,32 @@ static void free_dsq_irq_workfn(struct irq_work *irq_work)
 	struct llist_node *to_free = llist_del_all(&dsqs_to_free);
 	struct scx_dispatch_q *dsq, *tmp_dsq;
 
-	llist_for_each_entry_safe(dsq, tmp_dsq, to_free, free_node)
+	llist_for_each_entry_safe(dsq, tmp_dsq, to_free, free_node) {
+		if (dsq->shards)
+			kfree_rcu(dsq->shards, rcu);
 		kfree_rcu(dsq, rcu);
+	}
+}
+
+static u32 dsq_nr_queued(struct scx_dispatch_q *dsq)
+{
+	struct scx_dsq_shards *shards = dsq->shards;
+	u32 nr = READ_ONCE(dsq->nr), i;
+
+	if (shards)
+		for (i = 0; i < shards->nr; i++)
+			nr += READ_ONCE(shards->dsqs[i].nr);
+	return nr;
 }
 
 static DEFINE_IRQ_WORK(free_dsq_irq_work, free_dsq_irq_workfn);
 
 static void destroy_dsq(u64 dsq_id)
 {
+	struct scx_dsq_shards *shards;
 	struct scx_dispatch_q *dsq;
 	unsigned long flags;
+	u32 i;
 
 	rcu_read_lock();
 
@@ -4204,14 +4353,24 @@ static void destroy_dsq(u64 dsq_id)
 
 	raw_spin_lock_irqsave(&dsq->lock, flags);
 
-	if (dsq->nr) {
+	/*
+	 * dispatch_enqueue() only takes the lock of the shard it queues on.
+	 * Hold every shard lock across the emptiness check and the
+	 * invalidation below so that no task can slip into a shard in between.
+	 */
+	shards = dsq->shards;
+	if (shards)
+		for (i = 0; i < shards->nr; i++)
+			raw_spin_lock_nest_lock(&shards->dsqs[i].lock, &dsq->lock);
+
+	if (dsq_nr_queued(dsq)) {
 		scx_ops_error("attempting to destroy in-use dsq 0x%016llx (nr=%u)",
-			      dsq->id, dsq->nr);
-		goto out_unlock_dsq;
+			      dsq->id, dsq_nr_queued(dsq));
+		goto out_unlock_shards;
 	}
 
 	if (rhashtable_remove_fast(&dsq_hash, &dsq->hash_node, dsq_hash_params))
-		goto out_unlock_dsq;
+		goto out_unlock_shards;
 
 	/*
 	 * Mark dead by invalidating ->id to prevent dispatch_enqueue() from
@@ -4219,11 +4378,17 @@ static void destroy_dsq(u64 dsq_id)
 	 * freeing is bounced through an irq work to avoid nesting RCU
 	 * operations inside scheduler locks.
 	 */
+	if (shards)
+		for (i = 0; i < shards->nr; i++)
+			shards->dsqs[i].id = SCX_DSQ_INVALID;
 	dsq->id = SCX_DSQ_INVALID;
 	llist_add(&dsq->free_node, &dsqs_to_free);
 	irq_work_queue(&free_dsq_irq_work);
 
-out_unlock_dsq:
+out_unlock_shards:
+	if (shards)
+		for (i = 0; i < shards->nr; i++)
+			raw_spin_unlock(&shards->dsqs[i].lock);
 	raw_spin_unlock_irqrestore(&dsq->lock, flags);
 out_unlock_rcu:
 	rcu_read_unlock();
@@ -6412,7 +6577,7 @@ __bpf_kfunc bool scx_bpf_dsq_move_to_local(u64 dsq_id)
 		return false;
 	}
 
-	if (consume_dispatch_q(dspc->rq, dsq)) {
+	if (consume_user_dsq(dspc->rq, dsq)) {
 		/*
 		 * A successfully consumed task can be dequeued before it starts
 		 * running while the CPU is trying to migrate other dispatched
@@ -6669,13 +6834,31 @@ __bpf_kfunc s32 scx_bpf_create_dsq(u64 dsq_id, s32 node)
 	if (unlikely(node >= (int)nr_node_ids ||
 		     (node < 0 && node != NUMA_NO_NODE)))
 		return -EINVAL;
-	return PTR_ERR_OR_ZERO(create_dsq(dsq_id, node));
+	return PTR_ERR_OR_ZERO(create_dsq(dsq_id, node, false));
+}
+
+/**
+ * scx_bpf_create_sharded_dsq - Create a custom DSQ sharded per LLC
+ * @dsq_id: DSQ to create
+ *
+ * Create a custom DSQ identified by @dsq_id which is internally split into one
+ * shard per LLC. Tasks inserted into the DSQ are queued on the shard of the LLC
+ * of their CPU and scx_bpf_dsq_move_to_local() moves from the shard of the
+ * current LLC before stealing from the other shards. Ordering is only
+ * maintained within each shard and iterating the DSQ with bpf_iter_scx_dsq
+ * walks the shard of the current LLC. Can be called from any sleepable scx
+ * callback, and any BPF_PROG_TYPE_SYSCALL prog.
+ */
+__bpf_kfunc s32 scx_bpf_create_sharded_dsq(u64 dsq_id)
+{
+	return PTR_ERR_OR_ZERO(create_dsq(dsq_id, NUMA_NO_NODE, true));
 }
 
 __bpf_kfunc_end_defs();
 
 BTF_KFUNCS_START(scx_kfunc_ids_unlocked)
 BTF_ID_FLAGS(func, scx_bpf_create_dsq, KF_SLEEPABLE)
+BTF_ID_FLAGS(func, scx_bpf_create_sharded_dsq, KF_SLEEPABLE)
 BTF_ID_FLAGS(func, scx_bpf_dsq_move_set_slice)
 BTF_ID_FLAGS(func, scx_bpf_dsq_move_set_vtime)
 BTF_ID_FLAGS(func, scx_bpf_dsq_move, KF_RCU)
@@ -6783,7 +6966,7 @@ __bpf_kfunc s32 scx_bpf_dsq_nr_queued(u64 dsq_id)
 	} else {
 		dsq = find_user_dsq(dsq_id);
 		if (dsq) {
-			ret = READ_ONCE(dsq->nr);
+			ret = dsq_nr_queued(dsq);
 			goto out;
 		}
 	}
@@ -6793,6 +6976,50 @@ __bpf_kfunc s32 scx_bpf_dsq_nr_queued(u64 dsq_id)
 	return ret;
 }
 
+/**
+ * scx_bpf_dsq_nr_contended - Return the number of contended DSQ lock acquisitions
+ * @dsq_id: id of a custom DSQ
+ * @cpu: CPU whose shard to report, or -1 for the whole DSQ
+ *
+ * Return the number of times inserting into or moving from the DSQ matching
+ * @dsq_id had to wait for its lock. For a DSQ created with
+ * scx_bpf_create_sharded_dsq(), report the shard serving @cpu or, if @cpu is
+ * negative, the sum over all shards. If not found, -%ENOENT is returned.
+ */
+__bpf_kfunc s64 scx_bpf_dsq_nr_contended(u64 dsq_id, s32 cpu)
+{
+	struct scx_dsq_shards *shards;
+	struct scx_dispatch_q *dsq;
+	s64 ret;
+	u32 i;
+
+	preempt_disable();
+
+	dsq = find_user_dsq(dsq_id);
+	if (!dsq) {
+		ret = -ENOENT;
+		goto out;
+	}
+
+	if (cpu >= 0) {
+		if (!ops_cpu_valid(cpu, NULL)) {
+			ret = -EINVAL;
+			goto out;
+		}
+		ret = READ_ONCE(dsq_shard(dsq, cpu)->nr_contended);
+		goto out;
+	}
+
+	ret = READ_ONCE(dsq->nr_contended);
+	shards = dsq->shards;
+	if (shards)
+		for (i = 0; i < shards->nr; i++)
+			ret += READ_ONCE(shards->dsqs[i].nr_contended);
+out:
+	preempt_enable();
+	return ret;
+}
+
 /**
  * scx_bpf_destroy_dsq - Destroy a custom DSQ
  * @dsq_id: DSQ to destroy
@@ -6833,6 +7060,7 @@ __bpf_kfunc int bpf_iter_scx_dsq_new(struct bpf_iter_scx_dsq *it, u64 dsq_id,
 	kit->dsq = find_user_dsq(dsq_id);
 	if (!kit->dsq)
 		return -ENOENT;
+	kit->dsq = dsq_shard(kit->dsq, raw_smp_processor_id());
 
 	INIT_LIST_HEAD(&kit->cursor.node);
 	kit->cursor.flags = SCX_DSQ_LNODE_ITER_CURSOR | flags;
@@ -7335,6 +7563,7 @@ __bpf_kfunc_end_defs();
 BTF_KFUNCS_START(scx_kfunc_ids_any)
 BTF_ID_FLAGS(func, scx_bpf_kick_cpu)
 BTF_ID_FLAGS(func, scx_bpf_dsq_nr_queued)
+BTF_ID_FLAGS(func, scx_bpf_dsq_nr_contended)
 BTF_ID_FLAGS(func, scx_bpf_destroy_dsq)
 BTF_ID_FLAGS(func, bpf_iter_scx_dsq_new, KF_ITER_NEW | KF_RCU_PROTECTED)
 BTF_ID_FLAGS(func, bpf_iter_scx_dsq_next, KF_ITER_NEXT | KF_RET_NULL)
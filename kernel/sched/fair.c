@@ -81,6 +81,13 @@ static unsigned int normalized_sysctl_sched_base_slice	= 700000ULL;
 
 __read_mostly unsigned int sysctl_sched_migration_cost	= 500000UL;
 
+/*
+ * Idle cfs_rqs whose load, runnable and util averages are all below this
+ * are only refreshed by the blocked load update once per PELT half-life.
+ * 0 updates every cfs_rq on the leaf list each time.
+ */
+__read_mostly unsigned int sysctl_sched_blocked_load_min;
+
 static int __init setup_sched_thermal_decay_shift(char *str)
 {
 	pr_warn("Ignoring the deprecated sched_thermal_decay_shift= option\n");
@@ -1012,6 +1019,28 @@ int sched_update_scaling(void)
 
 static void clear_buddies(struct cfs_rq *cfs_rq, struct sched_entity *se);
 
+/*
+ * The request size of the tasks of @cfs_rq that don't have a custom slice:
+ * sysctl_sched_base_slice, scaled by the latency nice of their group the way
+ * nice scales the weight, so that each step makes it about 25% shorter or
+ * longer. A shorter request gets an earlier deadline, and so gets picked
+ * and preempts sooner.
+ */
+static u64 cfs_rq_base_slice(struct cfs_rq *cfs_rq)
+{
+	u64 slice = sysctl_sched_base_slice;
+#ifdef CONFIG_FAIR_GROUP_SCHED
+	int latency_nice = READ_ONCE(cfs_rq->tg->latency_nice_eff);
+
+	if (latency_nice) {
+		slice = div_u64(slice * NICE_0_LOAD,
+				scale_load(sched_prio_to_weight[latency_nice - MIN_NICE]));
+		slice = clamp_t(u64, slice, NSEC_PER_MSEC/10, NSEC_PER_MSEC*100);
+	}
+#endif
+	return slice;
+}
+
 /*
  * XXX: strictly: vd_i += N*r_i/w_i such that: vd_i > ve_i
  * this is probably good enough.
@@ -1024,10 +1053,10 @@ static bool update_deadline(struct cfs_rq *cfs_rq, struct sched_entity *se)
 	/*
 	 * For EEVDF the virtual time slope is determined by w_i (iow.
 	 * nice) while the request time r_i is determined by
-	 * sysctl_sched_base_slice.
+	 * sysctl_sched_base_slice, see cfs_rq_base_slice().
 	 */
 	if (!se->custom_slice)
-		se->slice = sysctl_sched_base_slice;
+		se->slice = cfs_rq_base_slice(cfs_rq);
 
 	/*
 	 * EEVDF: vd_i = ve_i + r_i / w_i
@@ -1293,6 +1322,22 @@ update_stats_wait_start_fair(struct cfs_rq *cfs_rq, struct sched_entity *se)
 	__update_stats_wait_start(rq_of(cfs_rq), p, stats);
 }
 
+static inline void update_wait_hist(struct cfs_rq *cfs_rq,
+				    struct sched_statistics *stats)
+{
+#ifdef CONFIG_FAIR_GROUP_SCHED
+	u64 delta = rq_clock(rq_of(cfs_rq)) - schedstat_val(stats->wait_start);
+	u64 limit = CFS_WAIT_HIST_MIN_USEC * NSEC_PER_USEC;
+	int bucket = 0;
+
+	while (delta >= limit && bucket < CFS_WAIT_HIST_BUCKETS - 1) {
+		limit *= 4;
+		bucket++;
+	}
+	cfs_rq->wait_hist[bucket]++;
+#endif
+}
+
 static inline void
 update_stats_wait_end_fair(struct cfs_rq *cfs_rq, struct sched_entity *se)
 {
@@ -1313,8 +1358,11 @@ update_stats_wait_end_fair(struct cfs_rq *cfs_rq, struct sched_entity *se)
 	if (unlikely(!schedstat_val(stats->wait_start)))
 		return;
 
-	if (entity_is_task(se))
+	if (entity_is_task(se)) {
 		p = task_of(se);
+		if (!task_on_rq_migrating(p))
+			update_wait_hist(cfs_rq, stats);
+	}
 
 	__update_stats_wait_end(rq_of(cfs_rq), p, stats);
 }
@@ -5204,7 +5252,7 @@ place_entity(struct cfs_rq *cfs_rq, struct sched_entity *se, int flags)
 	s64 lag = 0;
 
 	if (!se->custom_slice)
-		se->slice = sysctl_sched_base_slice;
+		se->slice = cfs_rq_base_slice(cfs_rq);
 	vslice = calc_delta_fair(se->slice, se);
 
 	/*
@@ -6919,6 +6967,15 @@ requeue_delayed_entity(struct sched_entity *se)
 	clear_delayed(se);
 }
 
+static inline int task_latency_nice(struct task_struct *p)
+{
+#ifdef CONFIG_FAIR_GROUP_SCHED
+	return READ_ONCE(task_cfs_rq(p)->tg->latency_nice_eff);
+#else
+	return 0;
+#endif
+}
+
 /*
  * The enqueue_task method is called before nr_running is
  * increased. Here we update the fair scheduling stats and
@@ -7045,6 +7102,15 @@ enqueue_task_fair(struct rq *rq, struct task_struct *p, int flags)
 	if (!task_new)
 		check_update_overutilized_status(rq);
 
+	/*
+	 * The woken task's util_est is already part of the root cfs_rq's, let
+	 * schedutil act on it before the PELT signal catches up.
+	 */
+	if (!task_new && cpufreq_wants_forecast())
+		cpufreq_update_util(rq, SCHED_CPUFREQ_FORECAST |
+				    (task_latency_nice(p) < 0 ?
+				     SCHED_CPUFREQ_LATENCY : 0));
+
 enqueue_throttle:
 	assert_list_leaf_cfs_rq(rq);
 
@@ -7658,6 +7724,26 @@ static int select_idle_smt(struct task_struct *p, struct sched_domain *sd, int t
 		 */
 		if (!cpumask_test_cpu(cpu, sched_domain_span(sd)))
 			continue;
+		if ((available_idle_cpu(cpu) || sched_idle_cpu(cpu)) &&
+		    sched_core_cookie_match(cpu_rq(cpu), p))
+			return cpu;
+	}
+
+	return -1;
+}
+
+/*
+ * Look for an idle SMT sibling of @target on a core that runs @p's cookie.
+ */
+static int select_idle_core_pair(struct task_struct *p, int target)
+{
+	int cpu;
+
+	if (!sched_feat(SIS_CORE_PAIR) ||
+	    !sched_core_cookie_paired(cpu_rq(target), p))
+		return -1;
+
+	for_each_cpu_and(cpu, cpu_smt_mask(target), p->cpus_ptr) {
 		if (available_idle_cpu(cpu) || sched_idle_cpu(cpu))
 			return cpu;
 	}
@@ -7686,8 +7772,93 @@ static inline int select_idle_smt(struct task_struct *p, struct sched_domain *sd
 	return -1;
 }
 
+static inline int select_idle_core_pair(struct task_struct *p, int target)
+{
+	return -1;
+}
+
 #endif /* CONFIG_SCHED_SMT */
 
+/*
+ * Record idle entry and exit in the idle index of the LLC, used by
+ * select_idle_cpu() with SIS_INDEX. A core is marked idle once all its SMT
+ * siblings are, and unmarked as soon as one of them leaves idle. The bits
+ * are only tested before being written so an idle CPU that keeps going
+ * through idle does not keep dirtying the shared masks.
+ */
+void __update_idle_index(struct rq *rq, bool idle)
+{
+	struct sched_domain_shared *sds;
+	int cpu = cpu_of(rq);
+	struct cpumask *cpus;
+
+	rcu_read_lock();
+	sds = rcu_dereference(per_cpu(sd_llc_shared, cpu));
+	if (!sds)
+		goto unlock;
+
+	cpus = sds_idle_cpus(sds);
+	if (idle) {
+		if (!cpumask_test_cpu(cpu, cpus))
+			cpumask_set_cpu(cpu, cpus);
+#ifdef CONFIG_SCHED_SMT
+		if (!cpumask_test_cpu(cpu, sds_idle_cores(sds)) &&
+		    cpumask_subset(cpu_smt_mask(cpu), cpus))
+			cpumask_set_cpu(cpumask_first(cpu_smt_mask(cpu)),
+					sds_idle_cores(sds));
+#endif
+	} else {
+		if (cpumask_test_cpu(cpu, cpus))
+			cpumask_clear_cpu(cpu, cpus);
+#ifdef CONFIG_SCHED_SMT
+		cpu = cpumask_first(cpu_smt_mask(cpu));
+		if (cpumask_test_cpu(cpu, sds_idle_cores(sds)))
+			cpumask_clear_cpu(cpu, sds_idle_cores(sds));
+#endif
+	}
+unlock:
+	rcu_read_unlock();
+}
+
+/*
+ * Look for an idle core, then for an idle CPU, among the ones the idle index
+ * of the LLC has recorded as idle. The index can be stale by the time it is
+ * read, so every candidate is still checked, but the search no longer grows
+ * with the size of the LLC.
+ */
+static int select_idle_cpu_index(struct task_struct *p, struct sched_domain *sd,
+				 struct sched_domain_shared *sds,
+				 bool has_idle_core, int target)
+{
+	struct cpumask *cpus = this_cpu_cpumask_var_ptr(select_rq_mask);
+	int i, cpu, idle_cpu = -1;
+
+	if (has_idle_core) {
+		cpumask_and(cpus, sched_domain_span(sd), p->cpus_ptr);
+		cpumask_and(cpus, cpus, sds_idle_cores(sds));
+		for_each_cpu_wrap(cpu, cpus, target + 1) {
+			schedstat_inc(this_rq()->sis_scanned);
+			i = select_idle_core(p, cpu, cpus, &idle_cpu);
+			if ((unsigned int)i < nr_cpumask_bits)
+				return i;
+		}
+		set_idle_cores(target, false);
+		if ((unsigned int)idle_cpu < nr_cpumask_bits)
+			return idle_cpu;
+	}
+
+	cpumask_and(cpus, sched_domain_span(sd), p->cpus_ptr);
+	cpumask_and(cpus, cpus, sds_idle_cpus(sds));
+	for_each_cpu_wrap(cpu, cpus, target + 1) {
+		schedstat_inc(this_rq()->sis_scanned);
+		idle_cpu = __select_idle_cpu(cpu, p);
+		if ((unsigned int)idle_cpu < nr_cpumask_bits)
+			return idle_cpu;
+	}
+
+	return -1;
+}
+
 /*
  * Scan the LLC domain for idle CPUs; this is dynamically regulated by
  * comparing the average scan cost (tracked in sd->avg_scan_cost) against the
@@ -7699,6 +7870,13 @@ static int select_idle_cpu(struct task_struct *p, struct sched_domain *sd, bool
 	int i, cpu, idle_cpu = -1, nr = INT_MAX;
 	struct sched_domain_shared *sd_share;
 
+	if (sched_feat(SIS_INDEX)) {
+		sd_share = rcu_dereference(per_cpu(sd_llc_shared, target));
+		if (sd_share)
+			return select_idle_cpu_index(p, sd, sd_share,
+						     has_idle_core, target);
+	}
+
 	cpumask_and(cpus, sched_domain_span(sd), p->cpus_ptr);
 
 	if (sched_feat(SIS_UTIL)) {
@@ -7720,6 +7898,7 @@ static int select_idle_cpu(struct task_struct *p, struct sched_domain *sd, bool
 				if (!cpumask_test_cpu(cpu, cpus))
 					continue;
 
+				schedstat_inc(this_rq()->sis_scanned);
 				if (has_idle_core) {
 					i = select_idle_core(p, cpu, cpus, &idle_cpu);
 					if ((unsigned int)i < nr_cpumask_bits)
@@ -7737,6 +7916,7 @@ static int select_idle_cpu(struct task_struct *p, struct sched_domain *sd, bool
 	}
 
 	for_each_cpu_wrap(cpu, cpus, target + 1) {
+		schedstat_inc(this_rq()->sis_scanned);
 		if (has_idle_core) {
 			i = select_idle_core(p, cpu, cpus, &idle_cpu);
 			if ((unsigned int)i < nr_cpumask_bits)
@@ -7851,7 +8031,26 @@ static int select_idle_sibling(struct task_struct *p, int prev, int target)
 	 */
 	lockdep_assert_irqs_disabled();
 
+	/*
+	 * With core scheduling, an idle sibling next to our own cookie is
+	 * better than any idle CPU that would force a sibling idle.
+	 */
+	if (sched_smt_active()) {
+		i = select_idle_core_pair(p, target);
+		if ((unsigned int)i < nr_cpumask_bits &&
+		    asym_fits_cpu(task_util, util_min, util_max, i))
+			return i;
+
+		if (prev != target && cpus_share_cache(prev, target)) {
+			i = select_idle_core_pair(p, prev);
+			if ((unsigned int)i < nr_cpumask_bits &&
+			    asym_fits_cpu(task_util, util_min, util_max, i))
+				return i;
+		}
+	}
+
 	if ((available_idle_cpu(target) || sched_idle_cpu(target)) &&
+	    sched_core_cookie_match(cpu_rq(target), p) &&
 	    asym_fits_cpu(task_util, util_min, util_max, target))
 		return target;
 
@@ -7860,6 +8059,7 @@ static int select_idle_sibling(struct task_struct *p, int prev, int target)
 	 */
 	if (prev != target && cpus_share_cache(prev, target) &&
 	    (available_idle_cpu(prev) || sched_idle_cpu(prev)) &&
+	    sched_core_cookie_match(cpu_rq(prev), p) &&
 	    asym_fits_cpu(task_util, util_min, util_max, prev)) {
 
 		if (!static_branch_unlikely(&sched_cluster_active) ||
@@ -7892,6 +8092,7 @@ static int select_idle_sibling(struct task_struct *p, int prev, int target)
 	    recent_used_cpu != target &&
 	    cpus_share_cache(recent_used_cpu, target) &&
 	    (available_idle_cpu(recent_used_cpu) || sched_idle_cpu(recent_used_cpu)) &&
+	    sched_core_cookie_match(cpu_rq(recent_used_cpu), p) &&
 	    cpumask_test_cpu(recent_used_cpu, p->cpus_ptr) &&
 	    asym_fits_cpu(task_util, util_min, util_max, recent_used_cpu)) {
 
@@ -7937,9 +8138,12 @@ static int select_idle_sibling(struct task_struct *p, int prev, int target)
 		}
 	}
 
+	schedstat_inc(this_rq()->sis_search);
 	i = select_idle_cpu(p, sd, has_idle_core, target);
-	if ((unsigned)i < nr_cpumask_bits)
+	if ((unsigned)i < nr_cpumask_bits) {
+		schedstat_inc(this_rq()->sis_found);
 		return i;
+	}
 
 	/*
 	 * For cluster machines which have lower sharing cache like L2 or
@@ -8811,9 +9015,10 @@ static void check_preempt_wakeup_fair(struct rq *rq, struct task_struct *p, int
 		return;
 
 	/*
-	 * BATCH and IDLE tasks do not preempt others.
+	 * BATCH and IDLE tasks do not preempt others, and neither do the
+	 * tasks of groups with a positive latency nice.
 	 */
-	if (unlikely(!normal_policy(p->policy)))
+	if (unlikely(!normal_policy(p->policy)) || task_latency_nice(p) > 0)
 		return;
 
 	cfs_rq = cfs_rq_of(se);
@@ -8837,6 +9042,9 @@ static void check_preempt_wakeup_fair(struct rq *rq, struct task_struct *p, int
 	return;
 
 preempt:
+#ifdef CONFIG_FAIR_GROUP_SCHED
+	task_cfs_rq(p)->nr_wakeup_preempt++;
+#endif
 	resched_curr_lazy(rq);
 }
 
@@ -9285,6 +9493,13 @@ static int task_hot(struct task_struct *p, struct lb_env *env)
 	if (!sched_core_cookie_match(cpu_rq(env->dst_cpu), p))
 		return 1;
 
+	/*
+	 * Pulling a task next to siblings that run its cookie fills a
+	 * forced idle SMT thread, which beats keeping its cache warm.
+	 */
+	if (sched_core_cookie_paired(cpu_rq(env->dst_cpu), p))
+		return 0;
+
 	if (sysctl_sched_migration_cost == 0)
 		return 0;
 
@@ -9785,8 +10000,36 @@ static bool __update_blocked_others(struct rq *rq, bool *done)
 
 #ifdef CONFIG_FAIR_GROUP_SCHED
 
+/*
+ * Whether the blocked load update can leave @cfs_rq alone this time. Its
+ * decay is computed exactly whenever it is eventually updated, and until
+ * then the error in the load it contributes to its tg and parent is
+ * bounded by @min.
+ */
+static inline bool cfs_rq_skip_blocked_update(struct cfs_rq *cfs_rq,
+					      unsigned int min)
+{
+	struct sched_avg *sa = &cfs_rq->avg;
+
+	if (!min || cfs_rq == &rq_of(cfs_rq)->cfs)
+		return false;
+
+	if (cfs_rq->load.weight || cfs_rq->propagate ||
+	    READ_ONCE(cfs_rq->removed.nr))
+		return false;
+
+	if (sa->load_avg >= min || sa->runnable_avg >= min ||
+	    sa->util_avg >= min)
+		return false;
+
+	/* Still refresh it once per half-life */
+	return cfs_rq_clock_pelt(cfs_rq) - sa->last_update_time <
+	       LOAD_AVG_PERIOD * NSEC_PER_MSEC;
+}
+
 static bool __update_blocked_fair(struct rq *rq, bool *done)
 {
+	unsigned int min = READ_ONCE(sysctl_sched_blocked_load_min);
 	struct cfs_rq *cfs_rq, *pos;
 	bool decayed = false;
 	int cpu = cpu_of(rq);
@@ -9798,6 +10041,12 @@ static bool __update_blocked_fair(struct rq *rq, bool *done)
 	for_each_leaf_cfs_rq_safe(rq, cfs_rq, pos) {
 		struct sched_entity *se;
 
+		if (cfs_rq_skip_blocked_update(cfs_rq, min)) {
+			schedstat_inc(rq->blocked_update_skipped);
+			*done = false;
+			continue;
+		}
+
 		if (update_cfs_rq_load_avg(cfs_rq_clock_pelt(cfs_rq), cfs_rq)) {
 			update_tg_load_avg(cfs_rq);
 
@@ -9898,6 +10147,10 @@ static void sched_balance_update_blocked_averages(int cpu)
 	bool decayed = false, done = true;
 	struct rq *rq = cpu_rq(cpu);
 	struct rq_flags rf;
+	u64 t0 = 0;
+
+	if (schedstat_enabled())
+		t0 = sched_clock_cpu(cpu);
 
 	rq_lock_irqsave(rq, &rf);
 	update_blocked_load_tick(rq);
@@ -9909,6 +10162,8 @@ static void sched_balance_update_blocked_averages(int cpu)
 	update_blocked_load_status(rq, !done);
 	if (decayed)
 		cpufreq_update_util(rq, 0);
+
+	schedstat_add(rq->blocked_update_time, sched_clock_cpu(cpu) - t0);
 	rq_unlock_irqrestore(rq, &rf);
 }
 
@@ -12227,6 +12482,10 @@ static void sched_balance_domains(struct rq *rq, enum cpu_idle_type idle)
 		}
 
 		if (time_after_eq(jiffies, sd->last_balance + interval)) {
+			u64 t0 = 0;
+
+			if (schedstat_enabled())
+				t0 = sched_clock_cpu(cpu);
 			if (sched_balance_rq(cpu, rq, sd, idle, &continue_balancing)) {
 				/*
 				 * The LBF_DST_PINNED logic could have changed
@@ -12236,6 +12495,7 @@ static void sched_balance_domains(struct rq *rq, enum cpu_idle_type idle)
 				idle = idle_cpu(cpu);
 				busy = !idle && !sched_idle_cpu(cpu);
 			}
+			schedstat_add(sd->lb_time, sched_clock_cpu(cpu) - t0);
 			sd->last_balance = jiffies;
 			interval = get_sd_balance_interval(sd, busy);
 		}
@@ -12855,6 +13115,7 @@ static int sched_balance_newidle(struct rq *this_rq, struct rq_flags *rf)
 			t1 = sched_clock_cpu(this_cpu);
 			domain_cost = t1 - t0;
 			update_newidle_cost(sd, domain_cost);
+			schedstat_add(sd->lb_time, domain_cost);
 
 			curr_cost += domain_cost;
 			t0 = t1;
@@ -13394,6 +13655,24 @@ int alloc_fair_sched_group(struct task_group *tg, struct task_group *parent)
 	return 0;
 }
 
+static DEFINE_MUTEX(latency_nice_mutex);
+
+/*
+ * A group can't be more latency sensitive than its parent: its effective
+ * latency nice is its own value, raised to the parent's effective one.
+ */
+static int tg_latency_nice_down(struct task_group *tg, void *data)
+{
+	int latency_nice = tg->latency_nice;
+
+	lockdep_assert_held(&latency_nice_mutex);
+
+	if (tg->parent)
+		latency_nice = max(latency_nice, tg->parent->latency_nice_eff);
+	WRITE_ONCE(tg->latency_nice_eff, latency_nice);
+	return 0;
+}
+
 void online_fair_sched_group(struct task_group *tg)
 {
 	struct sched_entity *se;
@@ -13401,6 +13680,10 @@ void online_fair_sched_group(struct task_group *tg)
 	struct rq *rq;
 	int i;
 
+	mutex_lock(&latency_nice_mutex);
+	tg_latency_nice_down(tg, NULL);
+	mutex_unlock(&latency_nice_mutex);
+
 	for_each_possible_cpu(i) {
 		rq = cpu_rq(i);
 		se = tg->se[i];
@@ -13529,6 +13812,25 @@ int sched_group_set_shares(struct task_group *tg, unsigned long shares)
 	return ret;
 }
 
+int sched_group_set_latency_nice(struct task_group *tg, long latency_nice)
+{
+	if (tg == &root_task_group)
+		return -EINVAL;
+
+	if (latency_nice < MIN_NICE || latency_nice > MAX_NICE)
+		return -EINVAL;
+
+	mutex_lock(&latency_nice_mutex);
+	WRITE_ONCE(tg->latency_nice, latency_nice);
+	/* Picked up by the groups' tasks at their next deadline update */
+	rcu_read_lock();
+	walk_tg_tree_from(tg, tg_latency_nice_down, tg_nop, NULL);
+	rcu_read_unlock();
+	mutex_unlock(&latency_nice_mutex);
+
+	return 0;
+}
+
 int sched_group_set_idle(struct task_group *tg, long idle)
 {
 	int i;
@@ -87,6 +87,19 @@ SCHED_FEAT(TTWU_QUEUE, true)
  */
 SCHED_FEAT(SIS_UTIL, true)
 
+/*
+ * When doing wakeups, only look at the CPUs and cores of the LLC that the
+ * idle index has recorded as idle rather than scanning the whole LLC.
+ */
+SCHED_FEAT(SIS_INDEX, false)
+
+/*
+ * With core scheduling, place a waking cookied task on an idle SMT sibling
+ * of a core that already runs its cookie, so the pair can run together
+ * instead of one of them being forced idle.
+ */
+SCHED_FEAT(SIS_CORE_PAIR, true)
+
 /*
  * Issue a WARN when we do multiple update_rq_clock() calls
  * in a single rq->lock section. Default disabled because the
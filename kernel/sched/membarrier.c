@@ -165,6 +165,9 @@
 static DEFINE_MUTEX(membarrier_ipi_mutex);
 #define SERIALIZE_IPI() guard(mutex)(&membarrier_ipi_mutex)
 
+/* Protected by membarrier_ipi_mutex */
+struct membarrier_stats membarrier_stats;
+
 static void ipi_mb(void *info)
 {
 	smp_mb();	/* IPIs should be serializing but paranoid. */
@@ -311,11 +314,35 @@ static int membarrier_global_expedited(void)
 	return 0;
 }
 
+/*
+ * Snapshot the context switch counts of all CPUs after the membarrier entry
+ * barrier. A CPU whose count moved by the time the IPIs are sent went through
+ * __schedule(), which provides the full barriers membarrier needs around the
+ * rq->curr update and calls rseq_preempt() on the task switched out, so it
+ * doesn't need an IPI.
+ */
+static u64 *membarrier_snapshot_switches(void)
+{
+	u64 *snap;
+	int cpu;
+
+	snap = kmalloc_array(nr_cpu_ids, sizeof(*snap), GFP_KERNEL | __GFP_NOWARN);
+	if (!snap)
+		return NULL;
+
+	for_each_possible_cpu(cpu)
+		snap[cpu] = READ_ONCE(cpu_rq(cpu)->nr_switches);
+
+	return snap;
+}
+
 static int membarrier_private_expedited(int flags, int cpu_id)
 {
 	cpumask_var_t tmpmask;
 	struct mm_struct *mm = current->mm;
 	smp_call_func_t ipi_func = ipi_mb;
+	unsigned long seq_done = 0;
+	u64 *snap = NULL;
 
 	if (flags == MEMBARRIER_FLAG_SYNC_CORE) {
 		if (!IS_ENABLED(CONFIG_ARCH_HAS_MEMBARRIER_SYNC_CORE))
@@ -356,7 +383,39 @@ static int membarrier_private_expedited(int flags, int cpu_id)
 	if (cpu_id < 0 && !zalloc_cpumask_var(&tmpmask, GFP_KERNEL))
 		return -ENOMEM;
 
-	SERIALIZE_IPI();
+	/*
+	 * A plain barrier is satisfied by any round of IPIs that scans the
+	 * CPUs after our entry barrier, including one issued by a concurrent
+	 * caller while we wait for the mutex. Like rcu_seq_snap(), wait for
+	 * the end of the next round to start after this point.
+	 */
+	if (cpu_id < 0 && !flags)
+		seq_done = (READ_ONCE(mm->membarrier_seq) + 3) & ~1UL;
+
+	if (!mutex_trylock(&membarrier_ipi_mutex)) {
+		/*
+		 * Waiting gives the other CPUs a chance to switch tasks. Only
+		 * do this for rounds that are not shared: a CPU that switched
+		 * after our snapshot may have done so before the entry barrier
+		 * of a caller sharing the round.
+		 */
+		if (cpu_id < 0 && flags == MEMBARRIER_FLAG_RSEQ)
+			snap = membarrier_snapshot_switches();
+		mutex_lock(&membarrier_ipi_mutex);
+	}
+
+	if (seq_done && ULONG_CMP_GE(READ_ONCE(mm->membarrier_seq), seq_done)) {
+		membarrier_stats.rounds_shared++;
+		mutex_unlock(&membarrier_ipi_mutex);
+		goto out_free;
+	}
+
+	if (cpu_id < 0 && !flags) {
+		WRITE_ONCE(mm->membarrier_seq, mm->membarrier_seq + 1);
+		/* Order the round start before the rq->curr reads below. */
+		smp_mb();
+	}
+
 	cpus_read_lock();
 
 	if (cpu_id >= 0) {
@@ -379,12 +438,20 @@ static int membarrier_private_expedited(int flags, int cpu_id)
 			struct task_struct *p;
 
 			p = rcu_dereference(cpu_rq(cpu)->curr);
-			if (p && p->mm == mm)
-				__cpumask_set_cpu(cpu, tmpmask);
+			if (!p || p->mm != mm)
+				continue;
+			if (snap && READ_ONCE(cpu_rq(cpu)->nr_switches) != snap[cpu]) {
+				membarrier_stats.ipis_avoided++;
+				continue;
+			}
+			__cpumask_set_cpu(cpu, tmpmask);
 		}
 		rcu_read_unlock();
 	}
 
+	membarrier_stats.rounds++;
+	membarrier_stats.ipis += cpu_id >= 0 ? 1 : cpumask_weight(tmpmask);
+
 	if (cpu_id >= 0) {
 		/*
 		 * smp_call_function_single() will call ipi_func() if cpu_id
@@ -419,9 +486,19 @@ static int membarrier_private_expedited(int flags, int cpu_id)
 	}
 
 out:
+	cpus_read_unlock();
+
+	if (cpu_id < 0 && !flags) {
+		/* Order the IPIs before the round end seen by waiters. */
+		smp_mb();
+		WRITE_ONCE(mm->membarrier_seq, mm->membarrier_seq + 1);
+	}
+	mutex_unlock(&membarrier_ipi_mutex);
+
+out_free:
+	kfree(snap);
 	if (cpu_id < 0)
 		free_cpumask_var(tmpmask);
-	cpus_read_unlock();
 
 	/*
 	 * Memory barrier on the caller thread _after_ we finished
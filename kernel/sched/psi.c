@@ -176,11 +176,16 @@ static void psi_avgs_work(struct work_struct *work);
 
 static void poll_timer_fn(struct timer_list *t);
 
+/* Serializes lazy aggregation and the psi_group children lists */
+static DEFINE_MUTEX(psi_lazy_lock);
+
 static void group_init(struct psi_group *group)
 {
 	int cpu;
 
 	group->enabled = true;
+	INIT_LIST_HEAD(&group->children);
+	INIT_LIST_HEAD(&group->sibling);
 	for_each_possible_cpu(cpu)
 		seqcount_init(&per_cpu_ptr(group->pcpu, cpu)->seq);
 	group->avg_last_update = sched_clock();
@@ -246,6 +251,94 @@ static u32 test_states(unsigned int *tasks, u32 state_mask)
 	return state_mask;
 }
 
+static void psi_lazy_pull(struct psi_group *group, int cpu);
+
+/*
+ * Cumulative times of @group on @cpu, including the currently active states,
+ * as seen by a lazily aggregated parent.
+ */
+static void psi_group_cum_times(struct psi_group *group, int cpu, u32 *times)
+{
+	struct psi_group_cpu *groupc = per_cpu_ptr(group->pcpu, cpu);
+	u64 now, state_start;
+	enum psi_states s;
+	unsigned int seq;
+	u32 state_mask;
+
+	lockdep_assert_held(&psi_lazy_lock);
+
+	if (group->lazy) {
+		psi_lazy_pull(group, cpu);
+		memcpy(times, groupc->lazy_times, sizeof(groupc->lazy_times));
+		return;
+	}
+
+	do {
+		seq = read_seqcount_begin(&groupc->seq);
+		now = cpu_clock(cpu);
+		memcpy(times, groupc->times, sizeof(groupc->times));
+		state_mask = groupc->state_mask;
+		state_start = groupc->state_start;
+	} while (read_seqcount_retry(&groupc->seq, seq));
+
+	for (s = 0; s < NR_PSI_STATES; s++)
+		if (state_mask & (1 << s))
+			times[s] += now - state_start;
+}
+
+/*
+ * Sum the times the child groups of a lazily aggregated @group accumulated on
+ * @cpu since the last pull into @group's lazy_times. Each group has a single
+ * parent, so lazy_pulled tracks exactly what has been summed so far.
+ *
+ * A state that is active in several children at once is counted once per
+ * child, so SOME and FULL of a lazy group are an upper bound of what tracking
+ * its tasks directly would report. Tasks attached to the lazy group itself are
+ * not accounted.
+ */
+static void psi_lazy_pull(struct psi_group *group, int cpu)
+{
+	struct psi_group_cpu *groupc = per_cpu_ptr(group->pcpu, cpu);
+	struct psi_group *child;
+	enum psi_states s;
+
+	list_for_each_entry(child, &group->children, sibling) {
+		struct psi_group_cpu *childc = per_cpu_ptr(child->pcpu, cpu);
+		u32 times[NR_PSI_STATES];
+
+		psi_group_cum_times(child, cpu, times);
+		for (s = 0; s < NR_PSI_STATES; s++) {
+			groupc->lazy_times[s] += times[s] - childc->lazy_pulled[s];
+			childc->lazy_pulled[s] = times[s];
+		}
+	}
+}
+
+static void get_lazy_times(struct psi_group *group, int cpu,
+			   enum psi_aggregators aggregator, u32 *times,
+			   u32 *pchanged_states)
+{
+	struct psi_group_cpu *groupc = per_cpu_ptr(group->pcpu, cpu);
+	enum psi_states s;
+
+	*pchanged_states = 0;
+
+	psi_lazy_pull(group, cpu);
+
+	for (s = 0; s < NR_PSI_STATES; s++) {
+		times[s] = groupc->lazy_times[s] -
+			   groupc->times_prev[aggregator][s];
+		groupc->times_prev[aggregator][s] = groupc->lazy_times[s];
+		if (times[s])
+			*pchanged_states |= (1 << s);
+	}
+
+	/* Lazy groups have no task state of their own to look at */
+	if (current_work() == &group->avgs_work.work &&
+	    (*pchanged_states & (1 << PSI_NONIDLE)))
+		*pchanged_states |= PSI_STATE_RESCHEDULE;
+}
+
 static void get_recent_times(struct psi_group *group, int cpu,
 			     enum psi_aggregators aggregator, u32 *times,
 			     u32 *pchanged_states)
@@ -344,9 +437,17 @@ static void collect_percpu_times(struct psi_group *group,
 	u64 deltas[NR_PSI_STATES - 1] = { 0, };
 	unsigned long nonidle_total = 0;
 	u32 changed_states = 0;
+	bool lazy = false;
 	int cpu;
 	int s;
 
+	if (READ_ONCE(group->lazy)) {
+		mutex_lock(&psi_lazy_lock);
+		lazy = group->lazy;
+		if (!lazy)
+			mutex_unlock(&psi_lazy_lock);
+	}
+
 	/*
 	 * Collect the per-cpu time buckets and average them into a
 	 * single time sample that is normalized to wall clock time.
@@ -360,8 +461,12 @@ static void collect_percpu_times(struct psi_group *group,
 		u32 nonidle;
 		u32 cpu_changed_states;
 
-		get_recent_times(group, cpu, aggregator, times,
-				&cpu_changed_states);
+		if (lazy)
+			get_lazy_times(group, cpu, aggregator, times,
+				       &cpu_changed_states);
+		else
+			get_recent_times(group, cpu, aggregator, times,
+					 &cpu_changed_states);
 		changed_states |= cpu_changed_states;
 
 		nonidle = nsecs_to_jiffies(times[PSI_NONIDLE]);
@@ -371,6 +476,9 @@ static void collect_percpu_times(struct psi_group *group,
 			deltas[s] += (u64)times[s] * nonidle;
 	}
 
+	if (lazy)
+		mutex_unlock(&psi_lazy_lock);
+
 	/*
 	 * Integrate the sample into the running statistics that are
 	 * reported to userspace: the cumulative stall times and the
@@ -790,7 +898,6 @@ static void psi_group_change(struct psi_group *group, int cpu,
 	 * SOME and FULL time these may have resulted in.
 	 */
 	write_seqcount_begin(&groupc->seq);
-	now = cpu_clock(cpu);
 
 	/*
 	 * Start with TSK_ONCPU, which doesn't have a corresponding
@@ -830,7 +937,7 @@ static void psi_group_change(struct psi_group *group, int cpu,
 		if (set & (1 << t))
 			groupc->tasks[t]++;
 
-	if (!group->enabled) {
+	if (!group->enabled || group->lazy) {
 		/*
 		 * On the first group change after disabling PSI, conclude
 		 * the current state and flush its time. This is unlikely
@@ -839,14 +946,26 @@ static void psi_group_change(struct psi_group *group, int cpu,
 		 * avoid a delta sample underflow when PSI is later re-enabled.
 		 */
 		if (unlikely(groupc->state_mask & (1 << PSI_NONIDLE)))
-			record_times(groupc, now);
+			record_times(groupc, cpu_clock(cpu));
 
 		groupc->state_mask = state_mask;
 
 		write_seqcount_end(&groupc->seq);
+
+		/*
+		 * A lazy group is only aggregated when read, keep its
+		 * workers going while there is activity below it.
+		 */
+		if (group->lazy) {
+			if (group->rtpoll_states)
+				psi_schedule_rtpoll_work(group, 1, false);
+			if (wake_clock && !delayed_work_pending(&group->avgs_work))
+				schedule_delayed_work(&group->avgs_work, PSI_FREQ);
+		}
 		return;
 	}
 
+	now = cpu_clock(cpu);
 	state_mask = test_states(groupc->tasks, state_mask);
 
 	/*
@@ -1018,7 +1137,7 @@ void psi_account_irqtime(struct rq *rq, struct task_struct *curr, struct task_st
 	do {
 		u64 now;
 
-		if (!group->enabled)
+		if (!group->enabled || group->lazy)
 			continue;
 
 		groupc = per_cpu_ptr(group->pcpu, cpu);
@@ -1116,6 +1235,10 @@ int psi_cgroup_alloc(struct cgroup *cgroup)
 	}
 	group_init(cgroup->psi);
 	cgroup->psi->parent = cgroup_psi(cgroup_parent(cgroup));
+
+	mutex_lock(&psi_lazy_lock);
+	list_add_tail(&cgroup->psi->sibling, &cgroup->psi->parent->children);
+	mutex_unlock(&psi_lazy_lock);
 	return 0;
 }
 
@@ -1124,6 +1247,10 @@ void psi_cgroup_free(struct cgroup *cgroup)
 	if (!static_branch_likely(&psi_cgroups_enabled))
 		return;
 
+	mutex_lock(&psi_lazy_lock);
+	list_del(&cgroup->psi->sibling);
+	mutex_unlock(&psi_lazy_lock);
+
 	cancel_delayed_work_sync(&cgroup->psi->avgs_work);
 	free_percpu(cgroup->psi->pcpu);
 	/* All triggers must be removed by now */
@@ -1229,6 +1356,73 @@ void psi_cgroup_restart(struct psi_group *group)
 		rq_unlock_irq(rq, &rf);
 	}
 }
+
+/**
+ * psi_cgroup_set_lazy - switch a cgroup's PSI to lazy aggregation
+ * @group: the psi_group of an enabled, non-root cgroup
+ * @lazy: whether to aggregate lazily
+ *
+ * A lazy group stops tracking the state times of the tasks below it on every
+ * task change and sums the times of its child groups when its pressure is
+ * read or its triggers are evaluated instead. This takes the group out of the
+ * expensive part of the per task change walk up the hierarchy.
+ *
+ * The cumulative times are carried over between the two modes in both
+ * directions so that neither the averages of @group nor the aggregation of a
+ * lazy parent see a jump.
+ */
+void psi_cgroup_set_lazy(struct psi_group *group, bool lazy)
+{
+	struct psi_group *child;
+	int cpu;
+
+	mutex_lock(&psi_lazy_lock);
+
+	if (group->lazy == lazy)
+		goto out_unlock;
+
+	if (lazy) {
+		/* only count what the children do from now on */
+		list_for_each_entry(child, &group->children, sibling) {
+			for_each_possible_cpu(cpu)
+				psi_group_cum_times(child, cpu,
+					per_cpu_ptr(child->pcpu, cpu)->lazy_pulled);
+		}
+	}
+
+	group->lazy = lazy;
+
+	for_each_possible_cpu(cpu) {
+		struct psi_group_cpu *groupc = per_cpu_ptr(group->pcpu, cpu);
+		struct rq *rq = cpu_rq(cpu);
+		struct rq_flags rf;
+
+		rq_lock_irq(rq, &rf);
+		write_seqcount_begin(&groupc->seq);
+		if (lazy) {
+			/* conclude the live state before freezing the times */
+			record_times(groupc, cpu_clock(cpu));
+			groupc->state_mask &= PSI_ONCPU;
+			memcpy(groupc->lazy_times, groupc->times,
+			       sizeof(groupc->times));
+		} else {
+			memcpy(groupc->times, groupc->lazy_times,
+			       sizeof(groupc->times));
+			groupc->state_start = cpu_clock(cpu);
+		}
+		write_seqcount_end(&groupc->seq);
+
+		/* recompute the state mask from the task counts */
+		if (!lazy)
+			psi_group_change(group, cpu, 0, 0, true);
+		rq_unlock_irq(rq, &rf);
+	}
+
+	if (lazy)
+		schedule_delayed_work(&group->avgs_work, PSI_FREQ);
+out_unlock:
+	mutex_unlock(&psi_lazy_lock);
+}
 #endif /* CONFIG_CGROUPS */
 
 int psi_show(struct seq_file *m, struct psi_group *group, enum psi_res res)
@@ -37,6 +37,7 @@
 #include <linux/interrupt.h>
 #include <linux/irq_work.h>
 #include <linux/jiffies.h>
+#include <linux/jump_label_ratelimit.h>
 #include <linux/kref_api.h>
 #include <linux/kthread.h>
 #include <linux/ktime_api.h>
@@ -442,6 +443,10 @@ struct task_group {
 	/* runqueue "owned" by this group on each CPU */
 	struct cfs_rq		**cfs_rq;
 	unsigned long		shares;
+	/* Scales the slice of the group's tasks, see cfs_rq_base_slice() */
+	int			latency_nice;
+	/* latency_nice, bounded by the parent's, see tg_latency_nice_down() */
+	int			latency_nice_eff;
 #ifdef	CONFIG_SMP
 	/*
 	 * load_avg can be heavily contended at clock tick time, so put
@@ -573,6 +578,8 @@ extern int sched_group_set_shares(struct task_group *tg, unsigned long shares);
 
 extern int sched_group_set_idle(struct task_group *tg, long idle);
 
+extern int sched_group_set_latency_nice(struct task_group *tg, long latency_nice);
+
 #ifdef CONFIG_SMP
 extern void set_task_rq_fair(struct sched_entity *se,
 			     struct cfs_rq *prev, struct cfs_rq *next);
@@ -642,6 +649,13 @@ struct balance_callback {
 };
 
 /* CFS-related fields in a runqueue */
+/*
+ * Buckets of the per cfs_rq run queue wait time histogram, each one four
+ * times as wide as the previous: <64us, <256us, ..., <16384us, >=16384us.
+ */
+#define CFS_WAIT_HIST_BUCKETS	6
+#define CFS_WAIT_HIST_MIN_USEC	64
+
 struct cfs_rq {
 	struct load_weight	load;
 	unsigned int		nr_queued;
@@ -719,6 +733,11 @@ struct cfs_rq {
 	/* Locally cached copy of our task_group's idle value */
 	int			idle;
 
+	/* Wakeups of this group's tasks that preempted the running task */
+	unsigned long		nr_wakeup_preempt;
+	/* Run queue wait times of this group's tasks */
+	unsigned long		wait_hist[CFS_WAIT_HIST_BUCKETS];
+
 #ifdef CONFIG_CFS_BANDWIDTH
 	int			runtime_enabled;
 	s64			runtime_remaining;
@@ -1134,6 +1153,10 @@ struct rq {
 #endif
 
 	struct sched_dl_entity	fair_server;
+	/* Time fair tasks waited on an exhausted fair_server: */
+	u64			fair_server_throttle_start;
+	u64			fair_server_throttled_time;
+	u64			fair_server_nr_throttled;
 
 #ifdef CONFIG_FAIR_GROUP_SCHED
 	/* list of leaf cfs_rq on this CPU: */
@@ -1262,6 +1285,17 @@ struct rq {
 	/* try_to_wake_up() stats */
 	unsigned int		ttwu_count;
 	unsigned int		ttwu_local;
+	/* remote wakeups that shared the IPI of a wake batch */
+	unsigned int		ttwu_coalesced;
+
+	/* sched_balance_update_blocked_averages() stats */
+	u64			blocked_update_time;
+	unsigned int		blocked_update_skipped;
+
+	/* select_idle_cpu() stats */
+	unsigned int		sis_search;
+	unsigned int		sis_scanned;
+	unsigned int		sis_found;
 #endif
 
 #ifdef CONFIG_CPU_IDLE
@@ -1430,6 +1464,18 @@ static inline bool sched_core_cookie_match(struct rq *rq, struct task_struct *p)
 	return idle_core || rq->core->core_cookie == p->core_cookie;
 }
 
+/*
+ * Whether @p has a cookie and the core of @rq currently runs that cookie, i.e.
+ * @p could run on @rq alongside the tasks on its SMT siblings.
+ */
+static inline bool sched_core_cookie_paired(struct rq *rq, struct task_struct *p)
+{
+	if (!sched_core_enabled(rq))
+		return false;
+
+	return p->core_cookie && rq->core->core_cookie == p->core_cookie;
+}
+
 static inline bool sched_group_cookie_match(struct rq *rq,
 					    struct task_struct *p,
 					    struct sched_group *group)
@@ -1490,6 +1536,11 @@ static inline bool sched_core_cookie_match(struct rq *rq, struct task_struct *p)
 	return true;
 }
 
+static inline bool sched_core_cookie_paired(struct rq *rq, struct task_struct *p)
+{
+	return false;
+}
+
 static inline bool sched_group_cookie_match(struct rq *rq,
 					    struct task_struct *p,
 					    struct sched_group *group)
@@ -2220,6 +2271,22 @@ extern struct static_key sched_feat_keys[__SCHED_FEAT_NR];
 extern struct static_key_false sched_numa_balancing;
 extern struct static_key_false sched_schedstats;
 
+#ifdef CONFIG_SMP
+extern void __update_idle_index(struct rq *rq, bool idle);
+
+/*
+ * Only keep the idle index up to date while SIS_INDEX is on. CPUs that were
+ * idle when it got enabled are picked up on their next pass through idle.
+ */
+static inline void update_idle_index(struct rq *rq, bool idle)
+{
+	if (sched_feat(SIS_INDEX))
+		__update_idle_index(rq, idle);
+}
+#else
+static inline void update_idle_index(struct rq *rq, bool idle) { }
+#endif
+
 static inline u64 global_rt_period(void)
 {
 	return (u64)sysctl_sched_rt_period * NSEC_PER_USEC;
@@ -2798,6 +2865,7 @@ extern void wakeup_preempt(struct rq *rq, struct task_struct *p, int flags);
 
 extern __read_mostly unsigned int sysctl_sched_nr_migrate;
 extern __read_mostly unsigned int sysctl_sched_migration_cost;
+extern __read_mostly unsigned int sysctl_sched_blocked_load_min;
 
 extern unsigned int sysctl_sched_base_slice;
 
@@ -3276,6 +3344,18 @@ static inline void cpufreq_update_util(struct rq *rq, unsigned int flags)
 static inline void cpufreq_update_util(struct rq *rq, unsigned int flags) { }
 #endif /* !CONFIG_CPU_FREQ */
 
+#ifdef CONFIG_CPU_FREQ_GOV_SCHEDUTIL
+extern struct static_key_false_deferred sched_cpufreq_forecast;
+
+/* Some schedutil policy acts on SCHED_CPUFREQ_FORECAST/LATENCY updates */
+static inline bool cpufreq_wants_forecast(void)
+{
+	return static_branch_unlikely(&sched_cpufreq_forecast.key);
+}
+#else
+static inline bool cpufreq_wants_forecast(void) { return false; }
+#endif
+
 #ifdef arch_scale_freq_capacity
 # ifndef arch_scale_freq_invariant
 #  define arch_scale_freq_invariant()	true
@@ -3543,6 +3623,15 @@ static inline void membarrier_switch_mm(struct rq *rq,
 	WRITE_ONCE(rq->membarrier_state, membarrier_state);
 }
 
+struct membarrier_stats {
+	u64	rounds;		/* private expedited IPI rounds */
+	u64	rounds_shared;	/* callers served by another caller's round */
+	u64	ipis;		/* CPUs targeted by a round */
+	u64	ipis_avoided;	/* CPUs skipped for having switched tasks */
+};
+
+extern struct membarrier_stats membarrier_stats;
+
 #else /* !CONFIG_MEMBARRIER :*/
 
 static inline void membarrier_switch_mm(struct rq *rq,
@@ -102,10 +102,12 @@ static int __wake_up_common_lock(struct wait_queue_head *wq_head, unsigned int m
 	unsigned long flags;
 	int remaining;
 
+	wake_batch_begin();
 	spin_lock_irqsave(&wq_head->lock, flags);
 	remaining = __wake_up_common(wq_head, mode, nr_exclusive, wake_flags,
 			key);
 	spin_unlock_irqrestore(&wq_head->lock, flags);
+	wake_batch_end();
 
 	return nr_exclusive - remaining;
 }
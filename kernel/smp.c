@@ -8,6 +8,9 @@
 #define pr_fmt(fmt) KBUILD_MODNAME ": " fmt
 
 #include <linux/irq_work.h>
+#include <linux/debugfs.h>
+#include <linux/hash.h>
+#include <linux/seq_file.h>
 #include <linux/rcupdate.h>
 #include <linux/rculist.h>
 #include <linux/kernel.h>
@@ -373,9 +376,117 @@ static __always_inline void csd_unlock(call_single_data_t *csd)
 	smp_store_release(&csd->node.u_flags, 0);
 }
 
+#ifdef CONFIG_DEBUG_FS
+/*
+ * Per callback function count of the remote calls queued and of the IPIs
+ * they needed.  A call queued on a CPU that has calls pending already
+ * shares the IPI sent for those, so the difference is what was coalesced.
+ * Only collected while <debugfs>/smp_call/enable is set.
+ */
+#define CSD_STATS_BITS		8
+#define CSD_STATS_PROBES	8
+
+struct csd_stats_site {
+	smp_call_func_t		func;
+	atomic_long_t		queued;
+	atomic_long_t		ipis;
+};
+
+static struct csd_stats_site csd_stats_sites[1 << CSD_STATS_BITS];
+static atomic_long_t csd_stats_dropped;
+static DEFINE_STATIC_KEY_FALSE(csd_stats_enabled);
+static DEFINE_MUTEX(csd_stats_mutex);
+
+static void __csd_stats_account(smp_call_func_t func, int queued, int ipis)
+{
+	unsigned int h = hash_ptr(func, CSD_STATS_BITS);
+	struct csd_stats_site *s;
+	int i;
+
+	for (i = 0; i < CSD_STATS_PROBES; i++) {
+		smp_call_func_t old;
+
+		s = &csd_stats_sites[(h + i) & ((1 << CSD_STATS_BITS) - 1)];
+		old = READ_ONCE(s->func);
+		if (!old)
+			old = cmpxchg(&s->func, NULL, func) ? : func;
+		if (old == func) {
+			atomic_long_add(queued, &s->queued);
+			atomic_long_add(ipis, &s->ipis);
+			return;
+		}
+	}
+	atomic_long_inc(&csd_stats_dropped);
+}
+
+static __always_inline void csd_stats_account(smp_call_func_t func,
+					      int queued, int ipis)
+{
+	if (static_branch_unlikely(&csd_stats_enabled) && queued)
+		__csd_stats_account(func, queued, ipis);
+}
+
+static int csd_stats_show(struct seq_file *m, void *v)
+{
+	int i;
+
+	seq_printf(m, "dropped: %ld\n", atomic_long_read(&csd_stats_dropped));
+	for (i = 0; i < ARRAY_SIZE(csd_stats_sites); i++) {
+		struct csd_stats_site *s = &csd_stats_sites[i];
+		long queued = atomic_long_read(&s->queued);
+		long ipis = atomic_long_read(&s->ipis);
+
+		if (!READ_ONCE(s->func) || !queued)
+			continue;
+		seq_printf(m, "%-40ps queued %ld ipis %ld coalesced %ld\n",
+			   READ_ONCE(s->func), queued, ipis, queued - ipis);
+	}
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(csd_stats);
+
+static int csd_stats_enable_get(void *data, u64 *val)
+{
+	*val = static_key_enabled(&csd_stats_enabled);
+	return 0;
+}
+
+static int csd_stats_enable_set(void *data, u64 val)
+{
+	mutex_lock(&csd_stats_mutex);
+	if (val && !static_key_enabled(&csd_stats_enabled)) {
+		/* Accounting runs preempt-disabled; let a previous run finish. */
+		synchronize_rcu();
+		memset(csd_stats_sites, 0, sizeof(csd_stats_sites));
+		atomic_long_set(&csd_stats_dropped, 0);
+		static_branch_enable(&csd_stats_enabled);
+	} else if (!val) {
+		static_branch_disable(&csd_stats_enabled);
+	}
+	mutex_unlock(&csd_stats_mutex);
+	return 0;
+}
+DEFINE_DEBUGFS_ATTRIBUTE(csd_stats_enable_fops, csd_stats_enable_get,
+			 csd_stats_enable_set, "%llu\n");
+
+static int __init csd_stats_init(void)
+{
+	struct dentry *dir = debugfs_create_dir("smp_call", NULL);
+
+	debugfs_create_file("enable", 0600, dir, NULL, &csd_stats_enable_fops);
+	debugfs_create_file("stats", 0400, dir, NULL, &csd_stats_fops);
+	return 0;
+}
+late_initcall(csd_stats_init);
+#else
+static inline void csd_stats_account(smp_call_func_t func, int queued,
+				     int ipis) { }
+#endif
+
 static DEFINE_PER_CPU_SHARED_ALIGNED(call_single_data_t, csd_data);
 
-void __smp_call_single_queue(int cpu, struct llist_node *node)
+static __always_inline bool smp_call_single_queue(int cpu,
+						  struct llist_node *node)
 {
 	/*
 	 * We have to check the type of the CSD before queueing it, because
@@ -407,10 +518,29 @@ void __smp_call_single_queue(int cpu, struct llist_node *node)
 	 * locking and barrier primitives. Generic code isn't really
 	 * equipped to do the right thing...
 	 */
-	if (llist_add(node, &per_cpu(call_single_queue, cpu)))
+	return llist_add(node, &per_cpu(call_single_queue, cpu));
+}
+
+void __smp_call_single_queue(int cpu, struct llist_node *node)
+{
+	if (smp_call_single_queue(cpu, node))
 		send_call_function_single_ipi(cpu);
 }
 
+/*
+ * Like __smp_call_single_queue(), but leave the IPI to the caller: if this
+ * returns true, the caller must smp_call_single_queue_kick() @cpu.
+ */
+bool __smp_call_single_queue_noipi(int cpu, struct llist_node *node)
+{
+	return smp_call_single_queue(cpu, node);
+}
+
+void smp_call_single_queue_kick(int cpu)
+{
+	send_call_function_single_ipi(cpu);
+}
+
 /*
  * Insert a previously allocated call_single_data_t element
  * for execution on the given CPU. data must already have
@@ -418,6 +548,8 @@ void __smp_call_single_queue(int cpu, struct llist_node *node)
  */
 static int generic_exec_single(int cpu, call_single_data_t *csd)
 {
+	smp_call_func_t stats_func = csd->func;
+
 	if (cpu == smp_processor_id()) {
 		smp_call_func_t func = csd->func;
 		void *info = csd->info;
@@ -441,7 +573,12 @@ static int generic_exec_single(int cpu, call_single_data_t *csd)
 		return -ENXIO;
 	}
 
-	__smp_call_single_queue(cpu, &csd->node.llist);
+	if (smp_call_single_queue(cpu, &csd->node.llist)) {
+		send_call_function_single_ipi(cpu);
+		csd_stats_account(stats_func, 1, 1);
+	} else {
+		csd_stats_account(stats_func, 1, 0);
+	}
 
 	return 0;
 }
@@ -790,7 +927,7 @@ static void smp_call_function_many_cond(const struct cpumask *mask,
 	int cpu, last_cpu, this_cpu = smp_processor_id();
 	struct call_function_data *cfd;
 	bool wait = scf_flags & SCF_WAIT;
-	int nr_cpus = 0;
+	int nr_cpus = 0, nr_queued = 0;
 	bool run_remote = false;
 	bool run_local = false;
 
@@ -851,6 +988,7 @@ static void smp_call_function_many_cond(const struct cpumask *mask,
 #endif
 			trace_csd_queue_cpu(cpu, _RET_IP_, func, csd);
 
+			nr_queued++;
 			if (llist_add(&csd->node.llist, &per_cpu(call_single_queue, cpu))) {
 				__cpumask_set_cpu(cpu, cfd->cpumask_ipi);
 				nr_cpus++;
@@ -867,6 +1005,7 @@ static void smp_call_function_many_cond(const struct cpumask *mask,
 			send_call_function_single_ipi(last_cpu);
 		else if (likely(nr_cpus > 1))
 			send_call_function_ipi_mask(cfd->cpumask_ipi);
+		csd_stats_account(func, nr_queued, nr_cpus);
 	}
 
 	if (run_local) {
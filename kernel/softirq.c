@@ -21,6 +21,7 @@
 #include <linux/freezer.h>
 #include <linux/kthread.h>
 #include <linux/rcupdate.h>
+#include <linux/sched/clock.h>
 #include <linux/ftrace.h>
 #include <linux/smp.h>
 #include <linux/smpboot.h>
@@ -66,6 +67,36 @@ const char * const softirq_to_name[NR_SOFTIRQS] = {
 	"TASKLET", "SCHED", "HRTIMER", "RCU"
 };
 
+#ifdef CONFIG_IRQ_TIME_ACCOUNTING
+/*
+ * Per-vector run time accounting costs two extra clock reads per handler,
+ * so it is only done when booted with "softirq_times".
+ */
+DEFINE_STATIC_KEY_FALSE(softirq_time_key);
+struct softirq_time_stat __percpu *softirq_time_stats;
+static bool softirq_time_requested __initdata;
+
+static int __init setup_softirq_times(char *str)
+{
+	softirq_time_requested = true;
+	return 1;
+}
+__setup("softirq_times", setup_softirq_times);
+
+static __init int softirq_time_init(void)
+{
+	if (!softirq_time_requested)
+		return 0;
+
+	softirq_time_stats = alloc_percpu(struct softirq_time_stat);
+	if (!softirq_time_stats)
+		return -ENOMEM;
+	static_branch_enable(&softirq_time_key);
+	return 0;
+}
+early_initcall(softirq_time_init);
+#endif
+
 /*
  * we cannot loop indefinitely here to avoid userspace starvation,
  * but we also don't want to introduce a worst case 1/HZ latency
@@ -567,6 +598,7 @@ static void handle_softirqs(bool ksirqd)
 	while ((softirq_bit = ffs(pending))) {
 		unsigned int vec_nr;
 		int prev_count;
+		u64 start = 0;
 
 		h += softirq_bit - 1;
 
@@ -575,9 +607,13 @@ static void handle_softirqs(bool ksirqd)
 
 		kstat_incr_softirqs_this_cpu(vec_nr);
 
+		if (softirq_time_enabled())
+			start = local_clock();
 		trace_softirq_entry(vec_nr);
 		h->action();
 		trace_softirq_exit(vec_nr);
+		if (softirq_time_enabled())
+			kstat_add_softirq_time_this_cpu(vec_nr, local_clock() - start);
 		if (unlikely(prev_count != preempt_count())) {
 			pr_err("huh, entered softirq %u %s %p with preempt_count %08x, exited with %08x?\n",
 			       vec_nr, softirq_to_name[vec_nr], h->action,
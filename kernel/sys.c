@@ -16,6 +16,7 @@
 #include <linux/fs.h>
 #include <linux/kmod.h>
 #include <linux/ksm.h>
+#include <linux/khugepaged.h>
 #include <linux/perf_event.h>
 #include <linux/resource.h>
 #include <linux/kernel.h>
@@ -2658,6 +2659,22 @@ SYSCALL_DEFINE5(prctl, int, option, unsigned long, arg2, unsigned long, arg3,
 			clear_bit(MMF_DISABLE_THP, &me->mm->flags);
 		mmap_write_unlock(me->mm);
 		break;
+#ifdef CONFIG_TRANSPARENT_HUGEPAGE
+	case PR_SET_THP_COLLAPSE_PRIORITY:
+		if (arg2 > PR_THP_COLLAPSE_PRIORITY_MAX || arg3 || arg4 || arg5)
+			return -EINVAL;
+		/* Raising the priority takes khugepaged time from others */
+		if (arg2 > READ_ONCE(me->mm->thp_collapse_priority) &&
+		    !capable(CAP_SYS_NICE))
+			return -EPERM;
+		khugepaged_set_priority(me->mm, arg2);
+		break;
+	case PR_GET_THP_COLLAPSE_PRIORITY:
+		if (arg2 || arg3 || arg4 || arg5)
+			return -EINVAL;
+		error = READ_ONCE(me->mm->thp_collapse_priority);
+		break;
+#endif
 	case PR_MPX_ENABLE_MANAGEMENT:
 	case PR_MPX_DISABLE_MANAGEMENT:
 		/* No longer implemented: */
@@ -5,6 +5,9 @@
  * Copyright(C) 2022 linutronix GmbH
  */
 #include <linux/cpuhotplug.h>
+#include <linux/debugfs.h>
+#include <linux/log2_hist.h>
+#include <linux/seq_file.h>
 #include <linux/slab.h>
 #include <linux/smp.h>
 #include <linux/spinlock.h>
@@ -900,8 +903,20 @@ static u64 tmigr_new_timer(struct tmigr_cpu *tmc, u64 nextexp)
 	return data.firstexp;
 }
 
-static void tmigr_handle_remote_cpu(unsigned int cpu, u64 now,
-				    unsigned long jif)
+static void tmigr_account_remote_lat(struct tmigr_group *group, u64 expires)
+{
+	s64 delta = ktime_get() - expires;
+
+	if (delta < 0)
+		delta = 0;
+
+	atomic_long_inc(&group->lat_nr);
+	atomic_inc(&group->lat_hist[log2_hist_bucket_us(delta, TMIGR_LAT_BUCKETS)]);
+	log2_hist_update_max(&group->lat_max, delta);
+}
+
+static void tmigr_handle_remote_cpu(struct tmigr_group *group, unsigned int cpu,
+				    u64 now, unsigned long jif)
 {
 	struct timer_events tevt;
 	struct tmigr_walk data;
@@ -933,6 +948,7 @@ static void tmigr_handle_remote_cpu(unsigned int cpu, u64 now,
 	}
 
 	trace_tmigr_handle_remote_cpu(tmc);
+	tmigr_account_remote_lat(group, tmc->cpuevt.nextevt.expires);
 
 	tmc->remote = true;
 	WRITE_ONCE(tmc->wakeup, KTIME_MAX);
@@ -1032,7 +1048,7 @@ static bool tmigr_handle_remote_up(struct tmigr_group *group,
 
 		raw_spin_unlock_irq(&group->lock);
 
-		tmigr_handle_remote_cpu(remote_cpu, now, jif);
+		tmigr_handle_remote_cpu(group, remote_cpu, now, jif);
 
 		/* check if there is another event, that needs to be handled */
 		goto again;
@@ -1861,3 +1877,46 @@ static int __init tmigr_init(void)
 	return ret;
 }
 early_initcall(tmigr_init);
+
+#ifdef CONFIG_DEBUG_FS
+/*
+ * Delay between the first expiring timer of an idle CPU and its expiry by the
+ * migrator, per group the expiry was handled in. A large delay in a group
+ * means its migrator is often busy when timers of its idle children fire.
+ */
+static int tmigr_latency_show(struct seq_file *m, void *v)
+{
+	struct tmigr_group *group;
+	unsigned int lvl;
+	int i;
+
+	log2_hist_seq_us_header(m, TMIGR_LAT_BUCKETS);
+
+	mutex_lock(&tmigr_mutex);
+	for (lvl = 0; lvl < tmigr_hierarchy_levels; lvl++) {
+		list_for_each_entry(group, &tmigr_level_list[lvl], list) {
+			seq_printf(m, "lvl %u node %d group %p: nr %ld max_ns %lld hist:",
+				   group->level, group->numa_node, group,
+				   atomic_long_read(&group->lat_nr),
+				   atomic64_read(&group->lat_max));
+			for (i = 0; i < TMIGR_LAT_BUCKETS; i++)
+				seq_printf(m, " %d", atomic_read(&group->lat_hist[i]));
+			seq_putc(m, '\n');
+		}
+	}
+	mutex_unlock(&tmigr_mutex);
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(tmigr_latency);
+
+static int __init tmigr_debugfs_init(void)
+{
+	if (!tmigr_level_list)
+		return 0;
+
+	debugfs_create_file("timer_migration_latency", 0400, NULL, NULL,
+			    &tmigr_latency_fops);
+	return 0;
+}
+late_initcall(tmigr_debugfs_init);
+#endif
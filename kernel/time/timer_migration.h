@@ -5,6 +5,9 @@
 /* Per group capacity. Must be a power of 2! */
 #define TMIGR_CHILDREN_PER_GROUP 8
 
+/* Remote expiry delay histogram: <1us, <2us, ... <16ms, more */
+#define TMIGR_LAT_BUCKETS 16
+
 /**
  * struct tmigr_event - a timer event associated to a CPU
  * @nextevt:	The node to enqueue an event in the parent group queue
@@ -57,6 +60,10 @@ struct tmigr_event {
  *			tmigr_level_list; is required during setup when a
  *			new group needs to be connected to the existing
  *			hierarchy groups
+ * @lat_nr:		Number of remote CPU expiries done through the group
+ * @lat_max:		Largest delay in ns between the expiry time of the
+ *			first timer of a remote CPU and its remote expiry
+ * @lat_hist:		log2 histogram in us of that delay
  */
 struct tmigr_group {
 	raw_spinlock_t		lock;
@@ -70,6 +77,9 @@ struct tmigr_group {
 	unsigned int		num_children;
 	u8			groupmask;
 	struct list_head	list;
+	atomic_long_t		lat_nr;
+	atomic64_t		lat_max;
+	atomic_t		lat_hist[TMIGR_LAT_BUCKETS];
 };
 
 /**
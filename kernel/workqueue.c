@@ -243,6 +243,7 @@ enum pool_workqueue_stats {
 	PWQ_STAT_REPATRIATED,	/* unbound workers brought back into scope */
 	PWQ_STAT_MAYDAY,	/* maydays to rescuer */
 	PWQ_STAT_RESCUED,	/* linked work items executed by rescuer */
+	PWQ_STAT_INACTIVE,	/* work items held back by max_active */
 
 	PWQ_NR_STATS,
 };
@@ -2343,6 +2344,7 @@ static void __queue_work(int cpu, struct workqueue_struct *wq,
 	} else {
 		work_flags |= WORK_STRUCT_INACTIVE;
 		insert_work(pwq, work, &pwq->inactive_works, work_flags);
+		pwq->stats[PWQ_STAT_INACTIVE]++;
 	}
 
 out:
@@ -7023,6 +7025,8 @@ module_param_cb(default_affinity_scope, &wq_affn_dfl_ops, NULL, 0644);
  *
  *  per_cpu		RO bool	: whether the workqueue is per-cpu or unbound
  *  max_active		RW int	: maximum number of in-flight work items
+ *  stats/		RO u64	: pool_workqueue counters summed over all pwqs,
+ *			  one file each (started, completed, inactive...)
  *
  * Unbound workqueues have the following extra attributes.
  *
@@ -7075,12 +7079,79 @@ static ssize_t max_active_store(struct device *dev,
 }
 static DEVICE_ATTR_RW(max_active);
 
+/* One file per pwq counter under stats/, summed over all the pwqs */
+struct wq_stat_attribute {
+	struct device_attribute		attr;
+	enum pool_workqueue_stats	stat;
+};
+
+static ssize_t wq_stat_show(struct device *dev, struct device_attribute *attr,
+			    char *buf)
+{
+	struct wq_stat_attribute *sattr =
+		container_of(attr, struct wq_stat_attribute, attr);
+	struct workqueue_struct *wq = dev_to_wq(dev);
+	struct pool_workqueue *pwq;
+	u64 sum = 0;
+
+	/* Racy but good enough for monitoring, like wq_monitor.py */
+	rcu_read_lock();
+	for_each_pwq(pwq, wq)
+		sum += READ_ONCE(pwq->stats[sattr->stat]);
+	rcu_read_unlock();
+
+	return sysfs_emit(buf, "%llu\n", sum);
+}
+
+#define WQ_STAT_ATTR(_name, _stat)					\
+	static struct wq_stat_attribute wq_stat_attr_##_name = {	\
+		.attr	= __ATTR(_name, 0444, wq_stat_show, NULL),	\
+		.stat	= _stat,					\
+	}
+
+WQ_STAT_ATTR(started, PWQ_STAT_STARTED);
+WQ_STAT_ATTR(completed, PWQ_STAT_COMPLETED);
+WQ_STAT_ATTR(cpu_time_us, PWQ_STAT_CPU_TIME);
+WQ_STAT_ATTR(cpu_intensive, PWQ_STAT_CPU_INTENSIVE);
+WQ_STAT_ATTR(cm_wakeup, PWQ_STAT_CM_WAKEUP);
+WQ_STAT_ATTR(repatriated, PWQ_STAT_REPATRIATED);
+WQ_STAT_ATTR(mayday, PWQ_STAT_MAYDAY);
+WQ_STAT_ATTR(rescued, PWQ_STAT_RESCUED);
+WQ_STAT_ATTR(inactive, PWQ_STAT_INACTIVE);
+
+static struct attribute *wq_sysfs_stats_attrs[] = {
+	&wq_stat_attr_started.attr.attr,
+	&wq_stat_attr_completed.attr.attr,
+	&wq_stat_attr_cpu_time_us.attr.attr,
+	&wq_stat_attr_cpu_intensive.attr.attr,
+	&wq_stat_attr_cm_wakeup.attr.attr,
+	&wq_stat_attr_repatriated.attr.attr,
+	&wq_stat_attr_mayday.attr.attr,
+	&wq_stat_attr_rescued.attr.attr,
+	&wq_stat_attr_inactive.attr.attr,
+	NULL,
+};
+
+static const struct attribute_group wq_sysfs_stats_group = {
+	.name	= "stats",
+	.attrs	= wq_sysfs_stats_attrs,
+};
+
 static struct attribute *wq_sysfs_attrs[] = {
 	&dev_attr_per_cpu.attr,
 	&dev_attr_max_active.attr,
 	NULL,
 };
-ATTRIBUTE_GROUPS(wq_sysfs);
+
+static const struct attribute_group wq_sysfs_group = {
+	.attrs	= wq_sysfs_attrs,
+};
+
+static const struct attribute_group *wq_sysfs_groups[] = {
+	&wq_sysfs_group,
+	&wq_sysfs_stats_group,
+	NULL,
+};
 
 static ssize_t wq_nice_show(struct device *dev, struct device_attribute *attr,
 			    char *buf)
@@ -0,0 +1,21 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Helpers for log2 latency histograms, see <linux/log2_hist.h>
+ */
+#include <linux/log2_hist.h>
+#include <linux/seq_file.h>
+
+/**
+ * log2_hist_seq_us_header - print the bucket labels of a histogram in us
+ * @m: seq_file to print to
+ * @nr_buckets: number of buckets of the histogram, at least two
+ */
+void log2_hist_seq_us_header(struct seq_file *m, unsigned int nr_buckets)
+{
+	unsigned int i;
+
+	seq_puts(m, "buckets: <1us");
+	for (i = 1; i < nr_buckets - 1; i++)
+		seq_printf(m, " <%uus", 1U << i);
+	seq_printf(m, " >=%uus\n", 1U << (nr_buckets - 2));
+}
@@ -6329,6 +6329,69 @@ int mtree_store_range(struct maple_tree *mt, unsigned long index,
 }
 EXPORT_SYMBOL(mtree_store_range);
 
+/**
+ * mtree_store_ranges() - Store a batch of entries at the given ranges.
+ * @mt: The maple tree
+ * @ranges: The ranges and their entries, stored in order
+ * @nr: The number of ranges
+ * @gfp: The GFP_FLAGS to use for allocations
+ *
+ * Equivalent to calling mtree_store_range() for every range, but the tree
+ * lock is only taken once and the nodes allocated for the worst case of one
+ * store that it did not use are kept for the following ones instead of being
+ * freed and allocated again.  Ranges may overlap, later ones overwrite
+ * earlier ones.
+ *
+ * The ranges are checked before anything is stored.  If allocating memory
+ * fails, the ranges before the failing one remain stored.
+ *
+ * Return: 0 on success, -EINVAL on invalid request, -ENOMEM if memory could not
+ * be allocated.
+ */
+int mtree_store_ranges(struct maple_tree *mt, const struct maple_range *ranges,
+		       unsigned int nr, gfp_t gfp)
+{
+	MA_STATE(mas, mt, 0, 0);
+	unsigned int i;
+	int ret = 0;
+
+	for (i = 0; i < nr; i++) {
+		if (WARN_ON_ONCE(xa_is_advanced(ranges[i].entry)))
+			return -EINVAL;
+
+		if (ranges[i].index > ranges[i].last)
+			return -EINVAL;
+	}
+
+	mtree_lock(mt);
+	for (i = 0; i < nr; i++) {
+		const struct maple_range *r = &ranges[i];
+		MA_WR_STATE(wr_mas, &mas, r->entry);
+
+		mas_set_range(&mas, r->index, r->last);
+		trace_ma_write(__func__, &mas, 0, r->entry);
+retry:
+		mas_wr_preallocate(&wr_mas, r->entry);
+		if (unlikely(mas_nomem(&mas, gfp))) {
+			if (!r->entry)
+				__mas_set_range(&mas, r->index, r->last);
+			goto retry;
+		}
+
+		if (mas_is_err(&mas)) {
+			ret = xa_err(mas.node);
+			break;
+		}
+
+		mas_wr_store_entry(&wr_mas);
+	}
+	mas_destroy(&mas);
+	mtree_unlock(mt);
+
+	return ret;
+}
+EXPORT_SYMBOL(mtree_store_ranges);
+
 /**
  * mtree_store() - Store an entry at a given index.
  * @mt: The maple tree
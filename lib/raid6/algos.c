@@ -18,6 +18,7 @@
 #else
 #include <linux/module.h>
 #include <linux/gfp.h>
+#include <linux/sysfs.h>
 /* In .bss so it's zeroed */
 const char raid6_empty_zero_page[PAGE_SIZE] __attribute__((aligned(256)));
 EXPORT_SYMBOL(raid6_empty_zero_page);
@@ -122,15 +123,22 @@ const struct raid6_recov_calls *const raid6_recov_algos[] = {
 
 #ifdef __KERNEL__
 #define RAID6_TIME_JIFFIES_LG2	4
+/* Best of several windows, so one interrupt doesn't decide the choice */
+#define RAID6_TIME_ROUNDS	3
 #else
 /* Need more time to be stable in userspace */
 #define RAID6_TIME_JIFFIES_LG2	9
+#define RAID6_TIME_ROUNDS	1
 #define time_before(x, y) ((x) < (y))
 #endif
 
 #define RAID6_TEST_DISKS	8
 #define RAID6_TEST_DISKS_ORDER	3
 
+/* Results of the selection, 0 MB/s if the benchmark was skipped */
+static const struct raid6_recov_calls *raid6_recov_best;
+static unsigned long raid6_gen_mbps, raid6_xor_mbps;
+
 static inline const struct raid6_recov_calls *raid6_choose_recov(void)
 {
 	const struct raid6_recov_calls *const *algo;
@@ -144,6 +152,7 @@ static inline const struct raid6_recov_calls *raid6_choose_recov(void)
 	if (best) {
 		raid6_2data_recov = best->data2;
 		raid6_datap_recov = best->datap;
+		raid6_recov_best = best;
 
 		pr_info("raid6: using %s recovery algorithm\n", best->name);
 	} else
@@ -155,8 +164,9 @@ static inline const struct raid6_recov_calls *raid6_choose_recov(void)
 static inline const struct raid6_calls *raid6_choose_gen(
 	void *(*const dptrs)[RAID6_TEST_DISKS], const int disks)
 {
-	unsigned long perf, bestgenperf, j0, j1;
+	unsigned long perf, n, bestgenperf, j0, j1;
 	int start = (disks>>1)-1, stop = disks-3;	/* work on the second half of the disks */
+	int round;
 	const struct raid6_calls *const *algo;
 	const struct raid6_calls *best;
 
@@ -172,16 +182,24 @@ static inline const struct raid6_calls *raid6_choose_gen(
 
 			perf = 0;
 
-			preempt_disable();
-			j0 = jiffies;
-			while ((j1 = jiffies) == j0)
-				cpu_relax();
-			while (time_before(jiffies,
-					    j1 + (1<<RAID6_TIME_JIFFIES_LG2))) {
-				(*algo)->gen_syndrome(disks, PAGE_SIZE, *dptrs);
-				perf++;
+			for (round = 0; round < RAID6_TIME_ROUNDS; round++) {
+				n = 0;
+
+				preempt_disable();
+				j0 = jiffies;
+				while ((j1 = jiffies) == j0)
+					cpu_relax();
+				while (time_before(jiffies, j1 +
+					(1 << RAID6_TIME_JIFFIES_LG2))) {
+					(*algo)->gen_syndrome(disks, PAGE_SIZE,
+							      *dptrs);
+					n++;
+				}
+				preempt_enable();
+
+				if (n > perf)
+					perf = n;
 			}
-			preempt_enable();
 
 			if (perf > bestgenperf) {
 				bestgenperf = perf;
@@ -206,29 +224,37 @@ static inline const struct raid6_calls *raid6_choose_gen(
 		goto out;
 	}
 
+	raid6_gen_mbps = (bestgenperf * HZ * (disks - 2)) >>
+		(20 - PAGE_SHIFT + RAID6_TIME_JIFFIES_LG2);
 	pr_info("raid6: using algorithm %s gen() %ld MB/s\n",
-		best->name,
-		(bestgenperf * HZ * (disks - 2)) >>
-		(20 - PAGE_SHIFT + RAID6_TIME_JIFFIES_LG2));
+		best->name, raid6_gen_mbps);
 
 	if (best->xor_syndrome) {
 		perf = 0;
 
-		preempt_disable();
-		j0 = jiffies;
-		while ((j1 = jiffies) == j0)
-			cpu_relax();
-		while (time_before(jiffies,
-				   j1 + (1 << RAID6_TIME_JIFFIES_LG2))) {
-			best->xor_syndrome(disks, start, stop,
-					   PAGE_SIZE, *dptrs);
-			perf++;
+		for (round = 0; round < RAID6_TIME_ROUNDS; round++) {
+			n = 0;
+
+			preempt_disable();
+			j0 = jiffies;
+			while ((j1 = jiffies) == j0)
+				cpu_relax();
+			while (time_before(jiffies,
+					   j1 + (1 << RAID6_TIME_JIFFIES_LG2))) {
+				best->xor_syndrome(disks, start, stop,
+						   PAGE_SIZE, *dptrs);
+				n++;
+			}
+			preempt_enable();
+
+			if (n > perf)
+				perf = n;
 		}
-		preempt_enable();
 
+		raid6_xor_mbps = (perf * HZ * (disks - 2)) >>
+			(20 - PAGE_SHIFT + RAID6_TIME_JIFFIES_LG2 + 1);
 		pr_info("raid6: .... xor() %ld MB/s, rmw enabled\n",
-			(perf * HZ * (disks - 2)) >>
-			(20 - PAGE_SHIFT + RAID6_TIME_JIFFIES_LG2 + 1));
+			raid6_xor_mbps);
 	}
 
 out:
@@ -280,6 +306,40 @@ int __init raid6_select_algo(void)
 	return gen_best && rec_best ? 0 : -EINVAL;
 }
 
+#ifdef __KERNEL__
+static int raid6_gen_algo_get(char *buffer, const struct kernel_param *kp)
+{
+	return sysfs_emit(buffer, "%s\n", raid6_call.name ?: "none");
+}
+
+static const struct kernel_param_ops raid6_gen_algo_ops = {
+	.get	= raid6_gen_algo_get,
+};
+module_param_cb(gen_algorithm, &raid6_gen_algo_ops, NULL, 0444);
+MODULE_PARM_DESC(gen_algorithm, "Selected gen_syndrome algorithm");
+
+static int raid6_recov_algo_get(char *buffer, const struct kernel_param *kp)
+{
+	return sysfs_emit(buffer, "%s\n",
+			  raid6_recov_best ? raid6_recov_best->name : "none");
+}
+
+static const struct kernel_param_ops raid6_recov_algo_ops = {
+	.get	= raid6_recov_algo_get,
+};
+module_param_cb(recov_algorithm, &raid6_recov_algo_ops, NULL, 0444);
+MODULE_PARM_DESC(recov_algorithm, "Selected recovery algorithm");
+
+/* Read-only, so the benchmark results can't be set from the command line */
+static const struct kernel_param_ops raid6_mbps_ops = {
+	.get	= param_get_ulong,
+};
+module_param_cb(gen_mbps, &raid6_mbps_ops, &raid6_gen_mbps, 0444);
+MODULE_PARM_DESC(gen_mbps, "Benchmarked gen() throughput in MB/s, 0 if not run");
+module_param_cb(xor_mbps, &raid6_mbps_ops, &raid6_xor_mbps, 0444);
+MODULE_PARM_DESC(xor_mbps, "Benchmarked xor() throughput in MB/s, 0 if not run");
+#endif
+
 static void raid6_exit(void)
 {
 	do { } while (0);
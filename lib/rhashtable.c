@@ -1088,6 +1088,76 @@ int rhashtable_init_noprof(struct rhashtable *ht,
 }
 EXPORT_SYMBOL_GPL(rhashtable_init_noprof);
 
+/**
+ * rhashtable_reserve - grow hash table ahead of a known number of insertions
+ * @ht:		hash table
+ * @nelems:	number of elements the table is expected to hold
+ *
+ * Resizes @ht so that it holds @nelems elements without growing again,
+ * which spares callers that are about to insert a large batch the repeated
+ * doubling and rehashing of every chain on the way. The table is rehashed
+ * synchronously, it remains usable by concurrent readers and writers while
+ * that happens. Tables that are already large enough are left alone.
+ *
+ * If automatic_shrinking is set, the table may shrink back before the
+ * elements are inserted.
+ *
+ * Must be called in process context, may sleep.
+ *
+ * Returns zero on success, -E2BIG if @nelems exceeds the maximum number of
+ * elements of @ht or -ENOMEM if the table could not be allocated.
+ */
+int rhashtable_reserve(struct rhashtable *ht, unsigned int nelems)
+{
+	struct bucket_table *tbl;
+	unsigned int size, limit;
+	int err;
+
+	if (nelems > ht->max_elems)
+		return -E2BIG;
+
+	/* Stay at or below the 75% load factor that triggers a resize. */
+	size = nelems + nelems / 3;
+	limit = ht->p.max_size ?: 1U << 31;
+	size = size < limit ? roundup_pow_of_two(size) : limit;
+
+	mutex_lock(&ht->mutex);
+
+	/*
+	 * Inserters may attach a table of their own at any time, -EEXIST
+	 * and -EAGAIN mean there is another table to rehash into before
+	 * checking the size again.
+	 */
+	do {
+		bool raced;
+
+		tbl = rht_dereference(ht->tbl, ht);
+		tbl = rhashtable_last_table(ht, tbl);
+
+		err = 0;
+		if (tbl->size < size)
+			err = rhashtable_rehash_alloc(ht, tbl, size);
+		else if (tbl->nest)
+			err = rhashtable_rehash_alloc(ht, tbl, tbl->size);
+		raced = err == -EEXIST;
+		if (err && !raced)
+			break;
+
+		err = rhashtable_rehash_table(ht);
+		if (!err && raced)
+			err = -EAGAIN;
+		cond_resched();
+	} while (err == -EAGAIN);
+
+	mutex_unlock(&ht->mutex);
+
+	if (err)
+		schedule_work(&ht->run_work);
+
+	return err;
+}
+EXPORT_SYMBOL_GPL(rhashtable_reserve);
+
 /**
  * rhltable_init - initialize a new hash list table
  * @hlt:	hash list table to be initialized
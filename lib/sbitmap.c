@@ -447,8 +447,15 @@ int sbitmap_queue_init_node(struct sbitmap_queue *sbq, unsigned int depth,
 	atomic_set(&sbq->completion_cnt, 0);
 	atomic_set(&sbq->wakeup_cnt, 0);
 
+	sbq->remote_frees = alloc_percpu_gfp(unsigned long, flags);
+	if (!sbq->remote_frees) {
+		sbitmap_free(&sbq->sb);
+		return -ENOMEM;
+	}
+
 	sbq->ws = kzalloc_node(SBQ_WAIT_QUEUES * sizeof(*sbq->ws), flags, node);
 	if (!sbq->ws) {
+		free_percpu(sbq->remote_frees);
 		sbitmap_free(&sbq->sb);
 		return -ENOMEM;
 	}
@@ -682,6 +689,10 @@ void sbitmap_queue_clear(struct sbitmap_queue *sbq, unsigned int nr,
 	smp_mb__after_atomic();
 	sbitmap_queue_wake_up(sbq, 1);
 	sbitmap_update_cpu_hint(&sbq->sb, cpu, nr);
+
+	/* Freeing on another CPU bounces the word and the hint between them. */
+	if (cpu != raw_smp_processor_id())
+		this_cpu_inc(*sbq->remote_frees);
 }
 EXPORT_SYMBOL_GPL(sbitmap_queue_clear);
 
@@ -737,6 +748,16 @@ void sbitmap_queue_show(struct sbitmap_queue *sbq, struct seq_file *m)
 
 	seq_printf(m, "round_robin=%d\n", sbq->sb.round_robin);
 	seq_printf(m, "min_shallow_depth=%u\n", sbq->min_shallow_depth);
+
+	seq_puts(m, "remote_frees={");
+	first = true;
+	for_each_possible_cpu(i) {
+		if (!first)
+			seq_puts(m, ", ");
+		first = false;
+		seq_printf(m, "%lu", *per_cpu_ptr(sbq->remote_frees, i));
+	}
+	seq_puts(m, "}\n");
 }
 EXPORT_SYMBOL_GPL(sbitmap_queue_show);
 
@@ -692,6 +692,35 @@ depot_stack_handle_t stack_depot_save(unsigned long *entries,
 }
 EXPORT_SYMBOL_GPL(stack_depot_save);
 
+int stack_depot_prealloc(gfp_t alloc_flags)
+{
+	unsigned long flags;
+	struct page *page;
+	void *prealloc;
+
+	if (stack_depot_disabled)
+		return -ENOENT;
+
+	/* A spare pool is already kept, or the depot is at its limit */
+	if (READ_ONCE(new_pool))
+		return 0;
+
+	page = alloc_pages(gfp_nested_mask(alloc_flags), DEPOT_POOL_ORDER);
+	if (!page)
+		return -ENOMEM;
+	prealloc = page_address(page);
+
+	raw_spin_lock_irqsave(&pool_lock, flags);
+	depot_keep_new_pool(&prealloc);
+	raw_spin_unlock_irqrestore(&pool_lock, flags);
+
+	/* Lost a race with another saver */
+	if (prealloc)
+		free_pages((unsigned long)prealloc, DEPOT_POOL_ORDER);
+	return 0;
+}
+EXPORT_SYMBOL_GPL(stack_depot_prealloc);
+
 struct stack_record *__stack_depot_get_stack_record(depot_stack_handle_t handle)
 {
 	if (!handle)
@@ -48,6 +48,7 @@ atomic_t maple_tree_tests_passed;
 /* #define BENCH_FORK */
 /* #define BENCH_MAS_FOR_EACH */
 /* #define BENCH_MAS_PREV */
+/* #define BENCH_STORE_RANGES */
 
 #ifdef __KERNEL__
 #define mt_set_non_kernel(x)		do {} while (0)
@@ -1831,6 +1832,27 @@ static noinline void __init bench_node_store(struct maple_tree *mt)
 }
 #endif
 
+#if defined(BENCH_STORE_RANGES)
+static noinline void __init bench_store_ranges(struct maple_tree *mt)
+{
+	int i, j, max = 2400, count = 2000000;
+	struct maple_range ranges[16];
+
+	for (i = 0; i < max; i += 10)
+		mtree_store_range(mt, i, i + 5, xa_mk_value(i), GFP_KERNEL);
+
+	/* Map and unmap a batch of ranges at a time, like a busy allocator. */
+	for (i = 0; i < count; i++) {
+		for (j = 0; j < ARRAY_SIZE(ranges); j++) {
+			ranges[j].index = (j * 150 + i % 100) % max;
+			ranges[j].last = ranges[j].index + 7;
+			ranges[j].entry = i & 1 ? NULL : xa_mk_value(j);
+		}
+		mtree_store_ranges(mt, ranges, ARRAY_SIZE(ranges), GFP_KERNEL);
+	}
+}
+#endif
+
 #if defined(BENCH_AWALK)
 static noinline void __init bench_awalk(struct maple_tree *mt)
 {
@@ -2106,6 +2128,44 @@ static noinline void __init check_mas_store_gfp(struct maple_tree *mt)
 	mtree_destroy(&newmt);
 }
 
+static noinline void __init check_store_ranges(struct maple_tree *mt)
+{
+	struct maple_range ranges[50];
+	unsigned long i;
+
+	for (i = 0; i < ARRAY_SIZE(ranges); i++) {
+		ranges[i].index = i * 10;
+		ranges[i].last = i * 10 + 5;
+		ranges[i].entry = xa_mk_value(i);
+	}
+	MT_BUG_ON(mt, mtree_store_ranges(mt, ranges, ARRAY_SIZE(ranges),
+					 GFP_KERNEL));
+	mt_validate(mt);
+	for (i = 0; i < ARRAY_SIZE(ranges); i++) {
+		MT_BUG_ON(mt, mtree_load(mt, i * 10) != xa_mk_value(i));
+		MT_BUG_ON(mt, mtree_load(mt, i * 10 + 5) != xa_mk_value(i));
+		MT_BUG_ON(mt, mtree_load(mt, i * 10 + 6) != NULL);
+	}
+
+	/* Overwrite every other range, spanning the gaps, then clear some. */
+	for (i = 0; i < ARRAY_SIZE(ranges) / 2; i++) {
+		ranges[i].index = i * 20;
+		ranges[i].last = i * 20 + 12;
+		ranges[i].entry = i % 4 ? xa_mk_value(i + 1000) : NULL;
+	}
+	MT_BUG_ON(mt, mtree_store_ranges(mt, ranges, ARRAY_SIZE(ranges) / 2,
+					 GFP_KERNEL));
+	mt_validate(mt);
+	for (i = 0; i < ARRAY_SIZE(ranges) / 2; i++)
+		MT_BUG_ON(mt, mtree_load(mt, i * 20 + 11) != ranges[i].entry);
+
+	/* An invalid range fails the whole batch before storing anything. */
+	ranges[0].entry = xa_mk_value(1);
+	ranges[1].index = ranges[1].last + 1;
+	MT_BUG_ON(mt, mtree_store_ranges(mt, ranges, 2, GFP_KERNEL) != -EINVAL);
+	MT_BUG_ON(mt, mtree_load(mt, 0) != NULL);
+}
+
 #if defined(BENCH_FORK)
 static noinline void __init bench_forking(void)
 {
@@ -3847,6 +3907,13 @@ static int __init maple_tree_seed(void)
 	mtree_destroy(&tree);
 	goto skip;
 #endif
+#if defined(BENCH_STORE_RANGES)
+#define BENCH
+	mt_init_flags(&tree, MT_FLAGS_ALLOC_RANGE);
+	bench_store_ranges(&tree);
+	mtree_destroy(&tree);
+	goto skip;
+#endif
 
 	mt_init_flags(&tree, MT_FLAGS_ALLOC_RANGE);
 	check_deficient_node(&tree);
@@ -3870,6 +3937,10 @@ static int __init maple_tree_seed(void)
 	check_mas_store_gfp(&tree);
 	mtree_destroy(&tree);
 
+	mt_init_flags(&tree, MT_FLAGS_ALLOC_RANGE);
+	check_store_ranges(&tree);
+	mtree_destroy(&tree);
+
 	/* Test ranges (store and insert) */
 	mt_init_flags(&tree, 0);
 	check_ranges(&tree);
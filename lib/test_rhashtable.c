@@ -75,6 +75,8 @@ struct thread_data {
 	int id;
 	struct task_struct *task;
 	struct test_obj *objs;
+	u64 insert_ns;
+	u64 insert_max_ns;
 };
 
 static u32 my_hashfn(const void *data, u32 len, u32 seed)
@@ -467,6 +469,62 @@ static int __init test_rhashtable_max(struct test_obj *array,
 	return err;
 }
 
+static int __init test_rhashtable_reserve(struct test_obj *array,
+					  unsigned int entries)
+{
+	struct rhashtable_params params = test_rht_params;
+	unsigned int i, size, old_size;
+	int err;
+
+	/*
+	 * Leave room above the reserved size, so that it is the 75% load
+	 * factor that has to keep the table from growing, not max_size.
+	 */
+	params.max_size = 4 * roundup_pow_of_two(entries);
+	params.automatic_shrinking = false;
+	err = rhashtable_init(&ht, &params);
+	if (err)
+		return err;
+
+	mutex_lock(&ht.mutex);
+	old_size = rht_dereference(ht.tbl, &ht)->size;
+	mutex_unlock(&ht.mutex);
+
+	err = rhashtable_reserve(&ht, entries);
+	if (err)
+		goto out;
+
+	mutex_lock(&ht.mutex);
+	size = rht_dereference(ht.tbl, &ht)->size;
+	mutex_unlock(&ht.mutex);
+
+	for (i = 0; i < entries; i++) {
+		struct test_obj *obj = &array[i];
+
+		obj->value.id = i * 2;
+		err = insert_retry(&ht, obj, params);
+		if (err < 0)
+			goto out;
+	}
+
+	/*
+	 * Inserting the reserved number of entries must not grow the table,
+	 * and the reserved table must not be larger than needed.
+	 */
+	flush_work(&ht.run_work);
+	mutex_lock(&ht.mutex);
+	if (rht_dereference(ht.tbl, &ht)->size != size ||
+	    (size > old_size && size / 2 >= entries + entries / 3) ||
+	    rht_dereference(rht_dereference(ht.tbl, &ht)->future_tbl, &ht))
+		err = -EINVAL;
+	else
+		err = 0;
+	mutex_unlock(&ht.mutex);
+out:
+	rhashtable_destroy(&ht);
+	return err;
+}
+
 static unsigned int __init print_ht(struct rhltable *rhlt)
 {
 	struct rhashtable *ht;
@@ -627,9 +685,15 @@ static int threadfunc(void *data)
 	}
 
 	for (i = 0; i < tdata->entries; i++) {
+		u64 start, delta;
+
 		tdata->objs[i].value.id = i;
 		tdata->objs[i].value.tid = tdata->id;
+		start = ktime_get_ns();
 		err = insert_retry(&ht, &tdata->objs[i], test_rht_params);
+		delta = ktime_get_ns() - start;
+		tdata->insert_ns += delta;
+		tdata->insert_max_ns = max(tdata->insert_max_ns, delta);
 		if (err > 0) {
 			insert_retries += err;
 		} else if (err) {
@@ -683,7 +747,7 @@ static int __init test_rht_init(void)
 {
 	unsigned int entries;
 	int i, err, started_threads = 0, failed_threads = 0;
-	u64 total_time = 0;
+	u64 total_time = 0, insert_ns = 0, insert_max_ns = 0;
 	struct thread_data *tdata;
 	struct test_obj *objs;
 
@@ -728,6 +792,11 @@ static int __init test_rht_init(void)
 		total_time += time;
 	}
 
+	memset(objs, 0, test_rht_params.max_size * sizeof(struct test_obj));
+	pr_info("test if reserving %u entries avoids resizing: %s\n", entries,
+		test_rhashtable_reserve(objs, entries) == 0 ?
+		"yes, ok" : "NO, failed");
+
 	pr_info("test if its possible to exceed max_size %d: %s\n",
 			test_rht_params.max_size, test_rhashtable_max(objs, entries) == 0 ?
 			"no, ok" : "YES, failed");
@@ -789,7 +858,13 @@ static int __init test_rht_init(void)
 			        i, err);
 			failed_threads++;
 		}
+		insert_ns += tdata[i].insert_ns;
+		insert_max_ns = max(insert_max_ns, tdata[i].insert_max_ns);
 	}
+	if (started_threads)
+		pr_info("Concurrent insert latency while resizing: average %llu ns, max %llu ns\n",
+			div_u64(insert_ns, started_threads * entries),
+			insert_max_ns);
 	rhashtable_destroy(&ht);
 	vfree(tdata);
 	vfree(objs);
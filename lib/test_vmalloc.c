@@ -54,6 +54,7 @@ __param(int, run_test_mask, INT_MAX,
 		"\t\tid: 256,  name: kvfree_rcu_1_arg_vmalloc_test\n"
 		"\t\tid: 512,  name: kvfree_rcu_2_arg_vmalloc_test\n"
 		"\t\tid: 1024, name: vm_map_ram_test\n"
+		"\t\tid: 2048, name: medium_size_alloc_test\n"
 		/* Add a new test case description here. */
 );
 
@@ -168,6 +169,31 @@ static int random_size_alloc_test(void)
 	return 0;
 }
 
+/*
+ * Sizes between 1M and 16M, a few distinct ones so that freed areas can be
+ * reused from the vmap node pools.
+ */
+static int medium_size_alloc_test(void)
+{
+	unsigned int n;
+	void *p;
+	int i;
+
+	for (i = 0; i < test_loop_count; i++) {
+		n = 256 << get_random_u32_below(4);
+		n += get_random_u32_below(4) * 64;
+		p = vmalloc(n * PAGE_SIZE);
+
+		if (!p)
+			return -1;
+
+		*((__u8 *)p) = 1;
+		vfree(p);
+	}
+
+	return 0;
+}
+
 static int long_busy_list_alloc_test(void)
 {
 	void *ptr_1, *ptr_2;
@@ -411,6 +437,7 @@ static struct test_case_desc test_case_array[] = {
 	{ "kvfree_rcu_1_arg_vmalloc_test", kvfree_rcu_1_arg_vmalloc_test },
 	{ "kvfree_rcu_2_arg_vmalloc_test", kvfree_rcu_2_arg_vmalloc_test },
 	{ "vm_map_ram_test", vm_map_ram_test },
+	{ "medium_size_alloc_test", medium_size_alloc_test },
 	/* Add a new test case here. */
 };
 
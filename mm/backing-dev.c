@@ -230,6 +230,26 @@ static int cgwb_debug_stats_show(struct seq_file *m, void *v)
 }
 DEFINE_SHOW_ATTRIBUTE(cgwb_debug_stats);
 
+static int bdi_pause_hist_show(struct seq_file *m, void *v)
+{
+	struct backing_dev_info *bdi = m->private;
+	int i;
+
+	for (i = 0; i < BDP_PAUSE_BUCKETS; i++) {
+		unsigned int lo = i ? 1U << (i - 1) : 0;
+
+		if (i == BDP_PAUSE_BUCKETS - 1)
+			seq_printf(m, "%5u+     ms: %lu\n", lo,
+				   atomic_long_read(&bdi->bdp_pause_hist[i]));
+		else
+			seq_printf(m, "%5u-%-5u ms: %lu\n", lo, 1U << i,
+				   atomic_long_read(&bdi->bdp_pause_hist[i]));
+	}
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(bdi_pause_hist);
+
 static void bdi_debug_register(struct backing_dev_info *bdi, const char *name)
 {
 	bdi->debug_dir = debugfs_create_dir(name, bdi_debug_root);
@@ -238,6 +258,8 @@ static void bdi_debug_register(struct backing_dev_info *bdi, const char *name)
 			    &bdi_debug_stats_fops);
 	debugfs_create_file("wb_stats", 0444, bdi->debug_dir, bdi,
 			    &cgwb_debug_stats_fops);
+	debugfs_create_file("pause_hist", 0444, bdi->debug_dir, bdi,
+			    &bdi_pause_hist_fops);
 }
 
 static void bdi_debug_unregister(struct backing_dev_info *bdi)
@@ -456,6 +478,33 @@ static ssize_t strict_limit_show(struct device *dev,
 }
 static DEVICE_ATTR_RW(strict_limit);
 
+static ssize_t writeback_latency_ms_store(struct device *dev,
+		struct device_attribute *attr, const char *buf, size_t count)
+{
+	struct backing_dev_info *bdi = dev_get_drvdata(dev);
+	unsigned int ms;
+	ssize_t ret;
+
+	ret = kstrtouint(buf, 10, &ms);
+	if (ret < 0)
+		return ret;
+
+	ret = bdi_set_writeback_latency(bdi, ms);
+	if (!ret)
+		ret = count;
+
+	return ret;
+}
+
+static ssize_t writeback_latency_ms_show(struct device *dev,
+		struct device_attribute *attr, char *buf)
+{
+	struct backing_dev_info *bdi = dev_get_drvdata(dev);
+
+	return sysfs_emit(buf, "%u\n", READ_ONCE(bdi->writeback_latency_ms));
+}
+static DEVICE_ATTR_RW(writeback_latency_ms);
+
 static struct attribute *bdi_dev_attrs[] = {
 	&dev_attr_read_ahead_kb.attr,
 	&dev_attr_min_ratio.attr,
@@ -466,6 +515,7 @@ static struct attribute *bdi_dev_attrs[] = {
 	&dev_attr_max_bytes.attr,
 	&dev_attr_stable_pages_required.attr,
 	&dev_attr_strict_limit.attr,
+	&dev_attr_writeback_latency_ms.attr,
 	NULL,
 };
 ATTRIBUTE_GROUPS(bdi_dev);
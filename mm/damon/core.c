@@ -12,6 +12,7 @@
 #include <linux/kthread.h>
 #include <linux/mm.h>
 #include <linux/psi.h>
+#include <linux/sched/clock.h>
 #include <linux/slab.h>
 #include <linux/string.h>
 #include <linux/string_choices.h>
@@ -32,6 +33,19 @@ static DEFINE_MUTEX(damon_ops_lock);
 static struct damon_operations damon_registered_ops[NR_DAMON_OPS];
 
 static struct kmem_cache *damon_region_cache __ro_after_init;
+static struct workqueue_struct *damon_shard_wq __ro_after_init;
+
+/* A run of regions of a target whose access is sampled by one worker */
+struct damon_shard {
+	struct work_struct work;
+	struct damon_ctx *ctx;
+	struct damon_target *t;
+	struct damon_region *r;
+	unsigned int nr_regions;
+	unsigned int idx;
+	bool prepare;
+	unsigned int max_nr_accesses;
+};
 
 /* Should be called under damon_ops_lock with id smaller than NR_DAMON_OPS */
 static bool __damon_is_registered_ops(enum damon_ops_id id)
@@ -701,6 +715,8 @@ int damon_set_attrs(struct damon_ctx *ctx, struct damon_attrs *attrs)
 		return -EINVAL;
 	if (attrs->sample_interval > attrs->aggr_interval)
 		return -EINVAL;
+	if (attrs->nr_shards > DAMON_MAX_SHARDS)
+		return -EINVAL;
 
 	/* calls from core-external doesn't set this. */
 	if (!attrs->aggr_samples)
@@ -2384,6 +2400,116 @@ static void kdamond_init_ctx(struct damon_ctx *ctx)
 	}
 }
 
+static void damon_shard_workfn(struct work_struct *work)
+{
+	struct damon_shard *shard = container_of(work, struct damon_shard,
+			work);
+	struct damon_ctx *ctx = shard->ctx;
+	u64 start = local_clock();
+
+	if (shard->prepare)
+		ctx->ops.prepare_access_checks_shard(ctx, shard->t, shard->r,
+				shard->nr_regions);
+	else
+		shard->max_nr_accesses = ctx->ops.check_accesses_shard(ctx,
+				shard->t, shard->r, shard->nr_regions);
+	trace_damon_shard_sampled(shard->idx, shard->nr_regions,
+			shard->prepare, local_clock() - start);
+}
+
+static bool kdamond_sharded(struct damon_ctx *ctx)
+{
+	return ctx->attrs.nr_shards > 1 && damon_shard_wq &&
+		ctx->ops.prepare_access_checks_shard &&
+		ctx->ops.check_accesses_shard;
+}
+
+/*
+ * Split the regions of @ctx into about &damon_attrs.nr_shards runs of
+ * similar size that don't cross target boundaries, and prepare (@prepare) or
+ * do the access check of the runs in parallel.  The per-shard results are
+ * merged into the max nr_accesses, like &damon_operations.check_accesses.
+ *
+ * Returns -ENOMEM if the shards couldn't be set up.
+ */
+static int kdamond_run_shards(struct damon_ctx *ctx, bool prepare,
+		unsigned int *max_nr_accesses)
+{
+	unsigned int nr_regions = 0, nr_targets = 0, nr = 0, per_shard, i;
+	struct damon_shard *shard = NULL;
+	struct damon_target *t;
+	struct damon_region *r;
+
+	damon_for_each_target(t, ctx) {
+		nr_regions += damon_nr_regions(t);
+		nr_targets++;
+	}
+	/* Splitting targets at shard boundaries adds at most one per target */
+	if (ctx->attrs.nr_shards + nr_targets > ctx->nr_shards_alloc) {
+		struct damon_shard *shards;
+
+		shards = krealloc_array(ctx->shards,
+				ctx->attrs.nr_shards + nr_targets,
+				sizeof(*shards), GFP_KERNEL);
+		if (!shards)
+			return -ENOMEM;
+		ctx->shards = shards;
+		ctx->nr_shards_alloc = ctx->attrs.nr_shards + nr_targets;
+	}
+
+	per_shard = max(DIV_ROUND_UP(nr_regions, ctx->attrs.nr_shards), 1U);
+	damon_for_each_target(t, ctx) {
+		unsigned int left = 0;
+
+		damon_for_each_region(r, t) {
+			if (!left) {
+				shard = &ctx->shards[nr];
+				*shard = (struct damon_shard){
+					.ctx = ctx, .t = t, .r = r, .idx = nr,
+					.prepare = prepare,
+				};
+				INIT_WORK(&shard->work, damon_shard_workfn);
+				left = per_shard;
+				nr++;
+			}
+			shard->nr_regions++;
+			left--;
+		}
+	}
+
+	for (i = 0; i < nr; i++)
+		queue_work(damon_shard_wq, &ctx->shards[i].work);
+	*max_nr_accesses = 0;
+	for (i = 0; i < nr; i++) {
+		flush_work(&ctx->shards[i].work);
+		*max_nr_accesses = max(*max_nr_accesses,
+				ctx->shards[i].max_nr_accesses);
+	}
+	return 0;
+}
+
+static void kdamond_prepare_access_checks(struct damon_ctx *ctx)
+{
+	unsigned int unused;
+
+	if (kdamond_sharded(ctx) && !kdamond_run_shards(ctx, true, &unused))
+		return;
+	if (ctx->ops.prepare_access_checks)
+		ctx->ops.prepare_access_checks(ctx);
+}
+
+static unsigned int kdamond_check_accesses(struct damon_ctx *ctx)
+{
+	unsigned int max_nr_accesses;
+
+	if (kdamond_sharded(ctx) &&
+			!kdamond_run_shards(ctx, false, &max_nr_accesses))
+		return max_nr_accesses;
+	if (ctx->ops.check_accesses)
+		return ctx->ops.check_accesses(ctx);
+	return 0;
+}
+
 /*
  * The monitoring daemon that runs as a kernel thread
  */
@@ -2424,14 +2550,12 @@ static int kdamond_fn(void *data)
 		if (kdamond_wait_activation(ctx))
 			break;
 
-		if (ctx->ops.prepare_access_checks)
-			ctx->ops.prepare_access_checks(ctx);
+		kdamond_prepare_access_checks(ctx);
 
 		kdamond_usleep(sample_interval);
 		ctx->passed_sample_intervals++;
 
-		if (ctx->ops.check_accesses)
-			max_nr_accesses = ctx->ops.check_accesses(ctx);
+		max_nr_accesses = kdamond_check_accesses(ctx);
 
 		if (ctx->passed_sample_intervals >= next_aggregation_sis) {
 			kdamond_merge_regions(ctx,
@@ -2511,6 +2635,9 @@ static int kdamond_fn(void *data)
 	if (ctx->ops.cleanup)
 		ctx->ops.cleanup(ctx);
 	kfree(ctx->regions_score_histogram);
+	kfree(ctx->shards);
+	ctx->shards = NULL;
+	ctx->nr_shards_alloc = 0;
 
 	pr_debug("kdamond (%d) finishes\n", current->pid);
 	mutex_lock(&ctx->kdamond_lock);
@@ -2680,6 +2807,9 @@ static int __init damon_init(void)
 		return -ENOMEM;
 	}
 
+	/* Sharded sampling falls back to the kdamond thread without this */
+	damon_shard_wq = alloc_workqueue("damon_shard", WQ_UNBOUND, 0);
+
 	return 0;
 }
 
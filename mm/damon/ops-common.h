@@ -7,6 +7,16 @@
 
 #include <linux/damon.h>
 
+/*
+ * The result of the last access check, reused for following regions that
+ * are sampled in the same folio.
+ */
+struct damon_last_access {
+	unsigned long addr;
+	unsigned long folio_sz;
+	bool accessed;
+};
+
 struct folio *damon_get_folio(unsigned long pfn);
 
 void damon_ptep_mkold(pte_t *pte, struct vm_area_struct *vma, unsigned long addr);
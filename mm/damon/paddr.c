@@ -171,34 +171,31 @@ static bool damon_pa_young(unsigned long paddr, unsigned long *folio_sz)
 }
 
 static void __damon_pa_check_access(struct damon_region *r,
-		struct damon_attrs *attrs)
+		struct damon_attrs *attrs, struct damon_last_access *last)
 {
-	static unsigned long last_addr;
-	static unsigned long last_folio_sz = PAGE_SIZE;
-	static bool last_accessed;
-
 	/* If the region is in the last checked page, reuse the result */
-	if (ALIGN_DOWN(last_addr, last_folio_sz) ==
-				ALIGN_DOWN(r->sampling_addr, last_folio_sz)) {
-		damon_update_region_access_rate(r, last_accessed, attrs);
+	if (ALIGN_DOWN(last->addr, last->folio_sz) ==
+				ALIGN_DOWN(r->sampling_addr, last->folio_sz)) {
+		damon_update_region_access_rate(r, last->accessed, attrs);
 		return;
 	}
 
-	last_accessed = damon_pa_young(r->sampling_addr, &last_folio_sz);
-	damon_update_region_access_rate(r, last_accessed, attrs);
+	last->accessed = damon_pa_young(r->sampling_addr, &last->folio_sz);
+	damon_update_region_access_rate(r, last->accessed, attrs);
 
-	last_addr = r->sampling_addr;
+	last->addr = r->sampling_addr;
 }
 
 static unsigned int damon_pa_check_accesses(struct damon_ctx *ctx)
 {
+	static struct damon_last_access last = { .folio_sz = PAGE_SIZE };
 	struct damon_target *t;
 	struct damon_region *r;
 	unsigned int max_nr_accesses = 0;
 
 	damon_for_each_target(t, ctx) {
 		damon_for_each_region(r, t) {
-			__damon_pa_check_access(r, &ctx->attrs);
+			__damon_pa_check_access(r, &ctx->attrs, &last);
 			max_nr_accesses = max(r->nr_accesses, max_nr_accesses);
 		}
 	}
@@ -206,6 +203,29 @@ static unsigned int damon_pa_check_accesses(struct damon_ctx *ctx)
 	return max_nr_accesses;
 }
 
+static void damon_pa_prepare_access_checks_shard(struct damon_ctx *ctx,
+		struct damon_target *t, struct damon_region *r,
+		unsigned int nr_regions)
+{
+	for (; nr_regions; nr_regions--, r = damon_next_region(r))
+		__damon_pa_prepare_access_check(r);
+}
+
+static unsigned int damon_pa_check_accesses_shard(struct damon_ctx *ctx,
+		struct damon_target *t, struct damon_region *r,
+		unsigned int nr_regions)
+{
+	struct damon_last_access last = { .folio_sz = PAGE_SIZE };
+	unsigned int max_nr_accesses = 0;
+
+	for (; nr_regions; nr_regions--, r = damon_next_region(r)) {
+		__damon_pa_check_access(r, &ctx->attrs, &last);
+		max_nr_accesses = max(r->nr_accesses, max_nr_accesses);
+	}
+
+	return max_nr_accesses;
+}
+
 static bool damos_pa_filter_match(struct damos_filter *filter,
 		struct folio *folio)
 {
@@ -624,6 +644,9 @@ static int __init damon_pa_initcall(void)
 		.update = NULL,
 		.prepare_access_checks = damon_pa_prepare_access_checks,
 		.check_accesses = damon_pa_check_accesses,
+		.prepare_access_checks_shard =
+			damon_pa_prepare_access_checks_shard,
+		.check_accesses_shard = damon_pa_check_accesses_shard,
 		.target_valid = NULL,
 		.cleanup = NULL,
 		.apply_scheme = damon_pa_apply_scheme,
@@ -562,32 +562,30 @@ static bool damon_va_young(struct mm_struct *mm, unsigned long addr,
  */
 static void __damon_va_check_access(struct mm_struct *mm,
 				struct damon_region *r, bool same_target,
-				struct damon_attrs *attrs)
+				struct damon_attrs *attrs,
+				struct damon_last_access *last)
 {
-	static unsigned long last_addr;
-	static unsigned long last_folio_sz = PAGE_SIZE;
-	static bool last_accessed;
-
 	if (!mm) {
 		damon_update_region_access_rate(r, false, attrs);
 		return;
 	}
 
 	/* If the region is in the last checked page, reuse the result */
-	if (same_target && (ALIGN_DOWN(last_addr, last_folio_sz) ==
-				ALIGN_DOWN(r->sampling_addr, last_folio_sz))) {
-		damon_update_region_access_rate(r, last_accessed, attrs);
+	if (same_target && (ALIGN_DOWN(last->addr, last->folio_sz) ==
+				ALIGN_DOWN(r->sampling_addr, last->folio_sz))) {
+		damon_update_region_access_rate(r, last->accessed, attrs);
 		return;
 	}
 
-	last_accessed = damon_va_young(mm, r->sampling_addr, &last_folio_sz);
-	damon_update_region_access_rate(r, last_accessed, attrs);
+	last->accessed = damon_va_young(mm, r->sampling_addr, &last->folio_sz);
+	damon_update_region_access_rate(r, last->accessed, attrs);
 
-	last_addr = r->sampling_addr;
+	last->addr = r->sampling_addr;
 }
 
 static unsigned int damon_va_check_accesses(struct damon_ctx *ctx)
 {
+	static struct damon_last_access last = { .folio_sz = PAGE_SIZE };
 	struct damon_target *t;
 	struct mm_struct *mm;
 	struct damon_region *r;
@@ -599,7 +597,7 @@ static unsigned int damon_va_check_accesses(struct damon_ctx *ctx)
 		same_target = false;
 		damon_for_each_region(r, t) {
 			__damon_va_check_access(mm, r, same_target,
-					&ctx->attrs);
+					&ctx->attrs, &last);
 			max_nr_accesses = max(r->nr_accesses, max_nr_accesses);
 			same_target = true;
 		}
@@ -610,6 +608,40 @@ static unsigned int damon_va_check_accesses(struct damon_ctx *ctx)
 	return max_nr_accesses;
 }
 
+static void damon_va_prepare_access_checks_shard(struct damon_ctx *ctx,
+		struct damon_target *t, struct damon_region *r,
+		unsigned int nr_regions)
+{
+	struct mm_struct *mm = damon_get_mm(t);
+
+	if (!mm)
+		return;
+	for (; nr_regions; nr_regions--, r = damon_next_region(r))
+		__damon_va_prepare_access_check(mm, r);
+	mmput(mm);
+}
+
+static unsigned int damon_va_check_accesses_shard(struct damon_ctx *ctx,
+		struct damon_target *t, struct damon_region *r,
+		unsigned int nr_regions)
+{
+	struct damon_last_access last = { .folio_sz = PAGE_SIZE };
+	struct mm_struct *mm = damon_get_mm(t);
+	unsigned int max_nr_accesses = 0;
+	bool same_target = false;
+
+	for (; nr_regions; nr_regions--, r = damon_next_region(r)) {
+		__damon_va_check_access(mm, r, same_target, &ctx->attrs,
+				&last);
+		max_nr_accesses = max(r->nr_accesses, max_nr_accesses);
+		same_target = true;
+	}
+	if (mm)
+		mmput(mm);
+
+	return max_nr_accesses;
+}
+
 /*
  * Functions for the target validity check and cleanup
  */
@@ -710,6 +742,9 @@ static int __init damon_va_initcall(void)
 		.update = damon_va_update,
 		.prepare_access_checks = damon_va_prepare_access_checks,
 		.check_accesses = damon_va_check_accesses,
+		.prepare_access_checks_shard =
+			damon_va_prepare_access_checks_shard,
+		.check_accesses_shard = damon_va_check_accesses_shard,
 		.target_valid = damon_va_target_valid,
 		.cleanup = NULL,
 		.apply_scheme = damon_va_apply_scheme,
@@ -191,6 +191,16 @@ static void filemap_unaccount_folio(struct address_space *mapping,
 		filemap_nr_thps_dec(mapping);
 	}
 
+	/*
+	 * A readahead marker that is still set was never reached by a reader,
+	 * so the speculative window it was guarding was read for nothing.
+	 * Shmem does not do readahead and uses this bit as PG_reclaim.
+	 */
+	if (!folio_test_swapbacked(folio) && folio_test_readahead(folio)) {
+		__count_vm_events(PGRA_WASTED, nr);
+		count_memcg_folio_events(folio, PGRA_WASTED, nr);
+	}
+
 	/*
 	 * At this point folio must be either written or cleaned by
 	 * truncate.  Dirty folio here signals a bug and loss of
@@ -1535,6 +1535,40 @@ void __meminit __init_page_from_nid(unsigned long pfn, int nid);
 unsigned long shrink_slab(gfp_t gfp_mask, int nid, struct mem_cgroup *memcg,
 			  int priority);
 
+/*
+ * Memcgs whose slab caches are shrunk together by shrink_slab_batch_flush(),
+ * spread over vm.shrinker_parallel_workers workers.
+ */
+#define SHRINK_SLAB_BATCH_MAX	16
+
+struct shrink_slab_batch {
+	gfp_t gfp_mask;
+	int nid;
+	int priority;
+	int nr;
+	atomic_t next;
+	/* stop shrinking once this many slab pages were freed */
+	unsigned long nr_to_reclaim;
+	atomic_long_t reclaimed;
+	struct mem_cgroup *memcgs[SHRINK_SLAB_BATCH_MAX];
+};
+
+static inline void shrink_slab_batch_init(struct shrink_slab_batch *batch,
+					  gfp_t gfp_mask, int nid, int priority,
+					  unsigned long nr_to_reclaim)
+{
+	batch->gfp_mask = gfp_mask;
+	batch->nid = nid;
+	batch->priority = priority;
+	batch->nr = 0;
+	batch->nr_to_reclaim = nr_to_reclaim;
+	atomic_long_set(&batch->reclaimed, 0);
+}
+
+bool shrink_slab_batch_add(struct shrink_slab_batch *batch,
+			   struct mem_cgroup *memcg);
+void shrink_slab_batch_flush(struct shrink_slab_batch *batch);
+
 #ifdef CONFIG_SHRINKER_DEBUG
 static inline __printf(2, 0) int shrinker_debugfs_name_alloc(
 			struct shrinker *shrinker, const char *fmt, va_list ap)
@@ -1555,6 +1589,9 @@ extern struct dentry *shrinker_debugfs_detach(struct shrinker *shrinker,
 					      int *debugfs_id);
 extern void shrinker_debugfs_remove(struct dentry *debugfs_entry,
 				    int debugfs_id);
+extern void shrinker_debugfs_account(struct shrinker *shrinker, u64 start,
+				     unsigned long scanned,
+				     unsigned long freed);
 #else /* CONFIG_SHRINKER_DEBUG */
 static inline int shrinker_debugfs_add(struct shrinker *shrinker)
 {
@@ -1578,6 +1615,11 @@ static inline void shrinker_debugfs_remove(struct dentry *debugfs_entry,
 					   int debugfs_id)
 {
 }
+static inline void shrinker_debugfs_account(struct shrinker *shrinker,
+					    u64 start, unsigned long scanned,
+					    unsigned long freed)
+{
+}
 #endif /* CONFIG_SHRINKER_DEBUG */
 
 /* Only track the nodes of mappings with shadow entries */
@@ -1624,5 +1666,16 @@ static inline bool reclaim_pt_is_enabled(unsigned long start, unsigned long end,
 }
 #endif /* CONFIG_PT_RECLAIM */
 
+/* prezero.c */
+#ifdef CONFIG_PREZERO_FOLIOS
+struct folio *prezero_folio_alloc(struct vm_area_struct *vma,
+				  unsigned int order);
+#else
+static inline struct folio *prezero_folio_alloc(struct vm_area_struct *vma,
+						unsigned int order)
+{
+	return NULL;
+}
+#endif /* CONFIG_PREZERO_FOLIOS */
 
 #endif	/* __MM_INTERNAL_H */
@@ -130,6 +130,33 @@ static struct khugepaged_scan khugepaged_scan = {
 	.mm_head = LIST_HEAD_INIT(khugepaged_scan.mm_head),
 };
 
+/*
+ * Queue @slot just behind the scanning cursor, after any slots that have
+ * at least the same priority, so that prioritized mms are scanned next and
+ * in priority order.
+ */
+static void khugepaged_queue_slot(struct mm_slot *slot, unsigned int prio)
+{
+	struct list_head *pos;
+
+	lockdep_assert_held(&khugepaged_mm_lock);
+
+	if (khugepaged_scan.mm_slot)
+		pos = &khugepaged_scan.mm_slot->slot.mm_node;
+	else
+		pos = &khugepaged_scan.mm_head;
+
+	while (pos->next != &khugepaged_scan.mm_head) {
+		struct mm_slot *next = list_entry(pos->next, struct mm_slot,
+						  mm_node);
+
+		if (READ_ONCE(next->mm->thp_collapse_priority) < prio)
+			break;
+		pos = pos->next;
+	}
+	list_add(&slot->mm_node, pos);
+}
+
 #ifdef CONFIG_SYSFS
 static ssize_t scan_sleep_millisecs_show(struct kobject *kobj,
 					 struct kobj_attribute *attr,
@@ -456,12 +483,17 @@ void __khugepaged_enter(struct mm_struct *mm)
 
 	spin_lock(&khugepaged_mm_lock);
 	mm_slot_insert(mm_slots_hash, mm, slot);
-	/*
-	 * Insert just behind the scanning cursor, to let the area settle
-	 * down a little.
-	 */
 	wakeup = list_empty(&khugepaged_scan.mm_head);
-	list_add_tail(&slot->mm_node, &khugepaged_scan.mm_head);
+	if (READ_ONCE(mm->thp_collapse_priority)) {
+		khugepaged_queue_slot(slot, mm->thp_collapse_priority);
+		wakeup = 1;
+	} else {
+		/*
+		 * Insert just behind the scanning cursor, to let the area
+		 * settle down a little.
+		 */
+		list_add_tail(&slot->mm_node, &khugepaged_scan.mm_head);
+	}
 	spin_unlock(&khugepaged_mm_lock);
 
 	mmgrab(mm);
@@ -480,6 +512,38 @@ void khugepaged_enter_vma(struct vm_area_struct *vma,
 	}
 }
 
+/**
+ * khugepaged_set_priority - set the khugepaged scan priority of an mm
+ * @mm: the mm
+ * @prio: the new priority, 0 restores plain round-robin scanning
+ *
+ * A raised priority moves an mm that is already registered with khugepaged
+ * ahead of the lower priority ones, so it is scanned on the next pass.
+ */
+void khugepaged_set_priority(struct mm_struct *mm, unsigned int prio)
+{
+	struct khugepaged_mm_slot *mm_slot;
+	struct mm_slot *slot;
+	bool wakeup = false;
+
+	WRITE_ONCE(mm->thp_collapse_priority, prio);
+	if (!prio)
+		return;
+
+	spin_lock(&khugepaged_mm_lock);
+	slot = mm_slot_lookup(mm_slots_hash, mm);
+	mm_slot = mm_slot_entry(slot, struct khugepaged_mm_slot, slot);
+	if (mm_slot && khugepaged_scan.mm_slot != mm_slot) {
+		list_del(&slot->mm_node);
+		khugepaged_queue_slot(slot, prio);
+		wakeup = true;
+	}
+	spin_unlock(&khugepaged_mm_lock);
+
+	if (wakeup)
+		wake_up_interruptible(&khugepaged_wait);
+}
+
 void __khugepaged_exit(struct mm_struct *mm)
 {
 	struct khugepaged_mm_slot *mm_slot;
@@ -1260,6 +1324,10 @@ static int collapse_huge_page(struct mm_struct *mm, unsigned long address,
 out_nolock:
 	if (folio)
 		folio_put(folio);
+	if (result == SCAN_SUCCEED)
+		atomic_long_inc(&mm->thp_collapse_succeeded);
+	else
+		atomic_long_inc(&mm->thp_collapse_failed);
 	trace_mm_collapse_huge_page(mm, result == SCAN_SUCCEED, result);
 	return result;
 }
@@ -2260,6 +2328,10 @@ static int collapse_file(struct mm_struct *mm, unsigned long addr,
 	folio_put(new_folio);
 out:
 	VM_BUG_ON(!list_empty(&pagelist));
+	if (result == SCAN_SUCCEED)
+		atomic_long_inc(&mm->thp_collapse_succeeded);
+	else
+		atomic_long_inc(&mm->thp_collapse_failed);
 	trace_mm_khugepaged_collapse_file(mm, new_folio, index, addr, is_shmem, file, HPAGE_PMD_NR, result);
 	return result;
 }
@@ -2373,6 +2445,7 @@ static unsigned int khugepaged_scan_mm_slot(unsigned int pages, int *result,
 	struct mm_slot *slot;
 	struct mm_struct *mm;
 	struct vm_area_struct *vma;
+	unsigned int prio;
 	int progress = 0;
 
 	VM_BUG_ON(!pages);
@@ -2392,6 +2465,8 @@ static unsigned int khugepaged_scan_mm_slot(unsigned int pages, int *result,
 	spin_unlock(&khugepaged_mm_lock);
 
 	mm = slot->mm;
+	prio = min_t(unsigned int, READ_ONCE(mm->thp_collapse_priority),
+		     ilog2(HPAGE_PMD_NR));
 	/*
 	 * Don't wait for semaphore (to avoid long wait times).  Just move to
 	 * the next mm on the list.
@@ -2467,7 +2542,11 @@ static unsigned int khugepaged_scan_mm_slot(unsigned int pages, int *result,
 
 			/* move to next address */
 			khugepaged_scan.address += HPAGE_PMD_SIZE;
-			progress += HPAGE_PMD_NR;
+			/*
+			 * Prioritized mms are charged less against the scan
+			 * budget, so they get more of each pass.
+			 */
+			progress += HPAGE_PMD_NR >> prio;
 			if (!mmap_locked)
 				/*
 				 * We released mmap_lock so break loop.  Note
@@ -154,6 +154,7 @@ struct ksm_scan {
  * @kpfn: page frame number of this ksm page (perhaps temporarily on wrong nid)
  * @chain_prune_time: time of the last full garbage collection
  * @rmap_hlist_len: number of rmap_item entries in hlist or STABLE_NODE_CHAIN
+ * @checksum: checksum of the ksm page, as accounted in the stable filter
  * @nid: NUMA node id of stable tree in which linked (may not match kpfn)
  */
 struct ksm_stable_node {
@@ -179,6 +180,7 @@ struct ksm_stable_node {
 	 */
 #define STABLE_NODE_CHAIN -1024
 	int rmap_hlist_len;
+	u32 checksum;
 #ifdef CONFIG_NUMA
 	int nid;
 #endif
@@ -300,6 +302,27 @@ atomic_long_t ksm_zero_pages = ATOMIC_LONG_INIT(0);
 /* The number of pages that have been skipped due to "smart scanning" */
 static unsigned long ksm_pages_skipped;
 
+/*
+ * Counting filter over the checksums of all pages in the stable tree.
+ * Identical pages have identical checksums, so a page whose checksum
+ * bucket is empty cannot match anything in the stable tree and the tree
+ * walk, with its memcmp per level, can be skipped.  Counters saturate and
+ * then stay set, which only costs a useless walk.  Like the stable tree
+ * itself it is serialized by ksm_thread_mutex.
+ */
+#define STABLE_FILTER_BITS	16
+static u16 *ksm_stable_filter;
+static bool ksm_stable_filter_enabled = true;
+
+/* The number of stable tree searches avoided by the filter */
+static unsigned long ksm_stable_filter_skips;
+
+/* Cost of the current and of the last complete scan */
+static u64 ksm_scan_start_cpu;
+static unsigned long ksm_scan_merged;
+static u64 ksm_last_scan_cpu;
+static unsigned long ksm_last_scan_merged;
+
 /* Don't scan more than max pages per batch. */
 static unsigned long ksm_advisor_max_pages_to_scan = 30000;
 
@@ -814,6 +837,41 @@ static inline void free_stable_node_chain(struct ksm_stable_node *chain,
 	ksm_stable_node_chains--;
 }
 
+static u16 *stable_filter_slot(u32 checksum)
+{
+	return &ksm_stable_filter[checksum & ((1U << STABLE_FILTER_BITS) - 1)];
+}
+
+static void stable_filter_add(struct ksm_stable_node *stable_node)
+{
+	u16 *cnt;
+
+	if (!ksm_stable_filter)
+		return;
+	cnt = stable_filter_slot(stable_node->checksum);
+	if (*cnt != U16_MAX)
+		(*cnt)++;
+}
+
+static void stable_filter_del(struct ksm_stable_node *stable_node)
+{
+	u16 *cnt;
+
+	if (!ksm_stable_filter)
+		return;
+	cnt = stable_filter_slot(stable_node->checksum);
+	/* A saturated counter lost track of its population, keep it set */
+	if (*cnt && *cnt != U16_MAX)
+		(*cnt)--;
+}
+
+static bool stable_filter_may_contain(u32 checksum)
+{
+	if (!ksm_stable_filter || !READ_ONCE(ksm_stable_filter_enabled))
+		return true;
+	return *stable_filter_slot(checksum);
+}
+
 static void remove_node_from_stable_tree(struct ksm_stable_node *stable_node)
 {
 	struct ksm_rmap_item *rmap_item;
@@ -853,6 +911,7 @@ static void remove_node_from_stable_tree(struct ksm_stable_node *stable_node)
 		list_del(&stable_node->list);
 	else
 		stable_node_dup_del(stable_node);
+	stable_filter_del(stable_node);
 	free_stable_node(stable_node);
 }
 
@@ -2068,6 +2127,8 @@ static struct ksm_stable_node *stable_tree_insert(struct folio *kfolio)
 	INIT_HLIST_HEAD(&stable_node_dup->hlist);
 	stable_node_dup->kpfn = kpfn;
 	stable_node_dup->rmap_hlist_len = 0;
+	/* The folio is write protected now, its content can't change */
+	stable_node_dup->checksum = calc_checksum(&kfolio->page);
 	DO_NUMA(stable_node_dup->nid = nid);
 	if (!need_chain) {
 		rb_link_node(&stable_node_dup->node, parent, new);
@@ -2085,6 +2146,7 @@ static struct ksm_stable_node *stable_tree_insert(struct folio *kfolio)
 		stable_node_chain_add_dup(stable_node_dup, stable_node);
 	}
 
+	stable_filter_add(stable_node_dup);
 	folio_set_stable_node(kfolio, stable_node_dup);
 
 	return stable_node_dup;
@@ -2262,12 +2324,22 @@ static void cmp_and_merge_page(struct page *page, struct ksm_rmap_item *rmap_ite
 			return;
 		}
 
-		if (!try_to_merge_with_zero_page(rmap_item, page))
+		if (!try_to_merge_with_zero_page(rmap_item, page)) {
+			ksm_scan_merged++;
 			return;
+		}
 	}
 
-	/* Start by searching for the folio in the stable tree */
-	kfolio = stable_tree_search(page);
+	/*
+	 * Start by searching for the folio in the stable tree, unless the
+	 * filter already tells that no stable page has this content.
+	 */
+	if (!stable_node && !stable_filter_may_contain(checksum)) {
+		ksm_stable_filter_skips++;
+		kfolio = NULL;
+	} else {
+		kfolio = stable_tree_search(page);
+	}
 	if (&kfolio->page == page && rmap_item->head == stable_node) {
 		folio_put(kfolio);
 		return;
@@ -2289,6 +2361,7 @@ static void cmp_and_merge_page(struct page *page, struct ksm_rmap_item *rmap_ite
 			stable_tree_append(rmap_item, folio_stable_node(kfolio),
 					   max_page_sharing_bypass);
 			folio_unlock(kfolio);
+			ksm_scan_merged++;
 		}
 		folio_put(kfolio);
 		return;
@@ -2326,6 +2399,7 @@ static void cmp_and_merge_page(struct page *page, struct ksm_rmap_item *rmap_ite
 						   false);
 				stable_tree_append(rmap_item, stable_node,
 						   false);
+				ksm_scan_merged += 2;
 			}
 			folio_unlock(kfolio);
 
@@ -2470,6 +2544,8 @@ static struct ksm_rmap_item *scan_get_next_rmap_item(struct page **page)
 	mm_slot = ksm_scan.mm_slot;
 	if (mm_slot == &ksm_mm_head) {
 		advisor_start_scan();
+		ksm_scan_start_cpu = task_sched_runtime(current);
+		ksm_scan_merged = 0;
 		trace_ksm_start_scan(ksm_scan.seqnr, ksm_rmap_items);
 
 		/*
@@ -2638,6 +2714,8 @@ static struct ksm_rmap_item *scan_get_next_rmap_item(struct page **page)
 		goto next_mm;
 
 	advisor_stop_scan();
+	ksm_last_scan_cpu = task_sched_runtime(current) - ksm_scan_start_cpu;
+	ksm_last_scan_merged = ksm_scan_merged;
 
 	trace_ksm_stop_scan(ksm_scan.seqnr, ksm_rmap_items);
 	ksm_scan.seqnr++;
@@ -3642,6 +3720,60 @@ static ssize_t full_scans_show(struct kobject *kobj,
 }
 KSM_ATTR_RO(full_scans);
 
+static ssize_t stable_filter_show(struct kobject *kobj,
+				  struct kobj_attribute *attr, char *buf)
+{
+	return sysfs_emit(buf, "%u\n", ksm_stable_filter_enabled);
+}
+
+static ssize_t stable_filter_store(struct kobject *kobj,
+				   struct kobj_attribute *attr,
+				   const char *buf, size_t count)
+{
+	int err;
+	bool value;
+
+	err = kstrtobool(buf, &value);
+	if (err)
+		return -EINVAL;
+
+	WRITE_ONCE(ksm_stable_filter_enabled, value);
+	return count;
+}
+KSM_ATTR(stable_filter);
+
+static ssize_t stable_filter_skips_show(struct kobject *kobj,
+					struct kobj_attribute *attr, char *buf)
+{
+	return sysfs_emit(buf, "%lu\n", ksm_stable_filter_skips);
+}
+KSM_ATTR_RO(stable_filter_skips);
+
+static ssize_t last_scan_cpu_ms_show(struct kobject *kobj,
+				     struct kobj_attribute *attr, char *buf)
+{
+	return sysfs_emit(buf, "%llu\n", div_u64(ksm_last_scan_cpu,
+						  NSEC_PER_MSEC));
+}
+KSM_ATTR_RO(last_scan_cpu_ms);
+
+static ssize_t last_scan_merged_show(struct kobject *kobj,
+				     struct kobj_attribute *attr, char *buf)
+{
+	return sysfs_emit(buf, "%lu\n", ksm_last_scan_merged);
+}
+KSM_ATTR_RO(last_scan_merged);
+
+static ssize_t last_scan_ns_per_merge_show(struct kobject *kobj,
+					   struct kobj_attribute *attr,
+					   char *buf)
+{
+	unsigned long merged = max(ksm_last_scan_merged, 1UL);
+
+	return sysfs_emit(buf, "%llu\n", div64_ul(ksm_last_scan_cpu, merged));
+}
+KSM_ATTR_RO(last_scan_ns_per_merge);
+
 static ssize_t smart_scan_show(struct kobject *kobj,
 			       struct kobj_attribute *attr, char *buf)
 {
@@ -3800,6 +3932,11 @@ static struct attribute *ksm_attrs[] = {
 	&pages_skipped_attr.attr,
 	&ksm_zero_pages_attr.attr,
 	&full_scans_attr.attr,
+	&stable_filter_attr.attr,
+	&stable_filter_skips_attr.attr,
+	&last_scan_cpu_ms_attr.attr,
+	&last_scan_merged_attr.attr,
+	&last_scan_ns_per_merge_attr.attr,
 #ifdef CONFIG_NUMA
 	&merge_across_nodes_attr.attr,
 #endif
@@ -3838,6 +3975,10 @@ static int __init ksm_init(void)
 	if (err)
 		goto out;
 
+	/* Without the filter every page just walks the stable tree */
+	ksm_stable_filter = kvcalloc(1U << STABLE_FILTER_BITS,
+				     sizeof(*ksm_stable_filter), GFP_KERNEL);
+
 	ksm_thread = kthread_run(ksm_scan_thread, NULL, "ksmd");
 	if (IS_ERR(ksm_thread)) {
 		pr_err("ksm: creating kthread failed\n");
@@ -3864,6 +4005,7 @@ static int __init ksm_init(void)
 	return 0;
 
 out_free:
+	kvfree(ksm_stable_filter);
 	ksm_slab_free();
 out:
 	return err;
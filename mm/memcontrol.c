@@ -30,6 +30,7 @@
 #include <linux/memcontrol.h>
 #include <linux/cgroup.h>
 #include <linux/sched/mm.h>
+#include <linux/sched/clock.h>
 #include <linux/shmem_fs.h>
 #include <linux/hugetlb.h>
 #include <linux/pagemap.h>
@@ -444,6 +445,10 @@ static const unsigned int memcg_vm_event_stat[] = {
 	PGDEACTIVATE,
 	PGLAZYFREE,
 	PGLAZYFREED,
+	PGRA_SUBMIT,
+	PGRA_HIT,
+	PGRA_MISS,
+	PGRA_WASTED,
 #ifdef CONFIG_SWAP
 	SWPIN_ZERO,
 	SWPOUT_ZERO,
@@ -521,6 +526,12 @@ struct memcg_vmstats {
 
 	/* Stats updates since the last flush */
 	atomic64_t		stats_updates;
+
+	/* jiffies_64 of the last flush of this subtree, 0 if never flushed */
+	u64			last_flush;
+
+	/* Staleness memory.stat readers accept, in jiffies */
+	unsigned long		stat_max_age;
 };
 
 /*
@@ -537,10 +548,16 @@ struct memcg_vmstats {
  *    (MEMCG_CHARGE_BATCH * nr_cpus) update events. Though this optimization
  *    will let stats be out of sync by atmost (MEMCG_CHARGE_BATCH * nr_cpus) but
  *    only for 2 seconds due to (1).
+ * 3) Readers that declared which staleness they accept, through
+ *    mem_cgroup_flush_stats_max_age() or memory.stat_max_age_ms, skip the
+ *    flush entirely if the memcg or one of its ancestors was flushed recently
+ *    enough.
  */
 static void flush_memcg_stats_dwork(struct work_struct *w);
 static DECLARE_DEFERRABLE_WORK(stats_flush_dwork, flush_memcg_stats_dwork);
 static u64 flush_last_time;
+/* Moving average of the cost of a flush, for the skipped flush accounting */
+static u64 flush_avg_ns;
 
 #define FLUSH_TIME (2UL*HZ)
 
@@ -604,6 +621,7 @@ static inline void memcg_rstat_updated(struct mem_cgroup *memcg, int val)
 static void __mem_cgroup_flush_stats(struct mem_cgroup *memcg, bool force)
 {
 	bool needs_flush = memcg_vmstats_needs_flush(memcg->vmstats);
+	u64 start;
 
 	trace_memcg_flush_stats(memcg, atomic64_read(&memcg->vmstats->stats_updates),
 		force, needs_flush);
@@ -614,7 +632,12 @@ static void __mem_cgroup_flush_stats(struct mem_cgroup *memcg, bool force)
 	if (mem_cgroup_is_root(memcg))
 		WRITE_ONCE(flush_last_time, jiffies_64);
 
+	start = local_clock();
 	cgroup_rstat_flush(memcg->css.cgroup);
+	WRITE_ONCE(memcg->vmstats->last_flush, jiffies_64);
+	/* Racy, but it only has to be roughly right */
+	WRITE_ONCE(flush_avg_ns, (READ_ONCE(flush_avg_ns) * 7 +
+				  local_clock() - start) / 8);
 }
 
 /*
@@ -644,6 +667,51 @@ void mem_cgroup_flush_stats_ratelimited(struct mem_cgroup *memcg)
 		mem_cgroup_flush_stats(memcg);
 }
 
+/*
+ * Whether the stats of @memcg were flushed in the last @max_age jiffies,
+ * either directly or as part of an ancestor's subtree.
+ */
+static bool memcg_stats_fresh(struct mem_cgroup *memcg, unsigned long max_age)
+{
+	u64 now = get_jiffies_64();
+
+	for (; memcg; memcg = parent_mem_cgroup(memcg)) {
+		u64 last_flush = READ_ONCE(memcg->vmstats->last_flush);
+
+		/* jiffies_64 starts at INITIAL_JIFFIES, so it is never 0 */
+		if (last_flush && time_before_eq64(now, last_flush + max_age))
+			return true;
+	}
+	return false;
+}
+
+/**
+ * mem_cgroup_flush_stats_max_age - flush the stats unless they are recent
+ * @memcg: root of the subtree to flush
+ * @max_age: staleness the caller accepts, in jiffies, 0 for none
+ *
+ * Like mem_cgroup_flush_stats(), but skip the flush, and with it the rstat
+ * lock, if the stats of @memcg were flushed in the last @max_age jiffies.
+ */
+void mem_cgroup_flush_stats_max_age(struct mem_cgroup *memcg,
+				    unsigned long max_age)
+{
+	if (mem_cgroup_disabled())
+		return;
+
+	if (!memcg)
+		memcg = root_mem_cgroup;
+
+	if (max_age && memcg_stats_fresh(memcg, max_age)) {
+		count_vm_event(MEMCG_STATS_FLUSH_SKIPPED);
+		count_vm_events(MEMCG_STATS_FLUSH_SAVED_US,
+				div_u64(READ_ONCE(flush_avg_ns), NSEC_PER_USEC));
+		return;
+	}
+
+	__mem_cgroup_flush_stats(memcg, false);
+}
+
 static void flush_memcg_stats_dwork(struct work_struct *w)
 {
 	/*
@@ -1490,7 +1558,8 @@ static void memcg_stat_format(struct mem_cgroup *memcg, struct seq_buf *s)
 	 *
 	 * Current memory state:
 	 */
-	mem_cgroup_flush_stats(memcg);
+	mem_cgroup_flush_stats_max_age(memcg,
+				       READ_ONCE(memcg->vmstats->stat_max_age));
 
 	for (i = 0; i < ARRAY_SIZE(memory_stats); i++) {
 		u64 size;
@@ -1758,6 +1827,31 @@ void mem_cgroup_print_oom_group(struct mem_cgroup *memcg)
 	pr_cont(" are going to be killed due to memory.oom.group set\n");
 }
 
+/**
+ * mem_cgroup_ra_policy - readahead policy of the current task's memcg
+ *
+ * Readahead allocates and charges folios on behalf of the current task (or
+ * the active memcg, if one is set), so that is whose policy applies.
+ */
+enum mem_cgroup_ra_policy mem_cgroup_ra_policy(void)
+{
+	struct mem_cgroup *memcg;
+	int policy = MEMCG_RA_ADAPTIVE;
+
+	if (mem_cgroup_disabled())
+		return policy;
+
+	rcu_read_lock();
+	memcg = active_memcg();
+	if (!memcg)
+		memcg = mem_cgroup_from_task(current);
+	if (memcg)
+		policy = READ_ONCE(memcg->ra_policy);
+	rcu_read_unlock();
+
+	return policy;
+}
+
 struct memcg_stock_pcp {
 	localtry_lock_t stock_lock;
 	struct mem_cgroup *cached; /* this never be root cgroup */
@@ -1949,6 +2043,8 @@ void drain_all_stock(struct mem_cgroup *root_memcg)
 				drain_local_stock(&stock->work);
 			else if (!cpu_is_isolated(cpu))
 				schedule_work_on(cpu, &stock->work);
+			else
+				count_vm_event(ISOLATED_STOCK_DRAIN_SKIP);
 		}
 	}
 	migrate_enable();
@@ -3685,6 +3781,7 @@ mem_cgroup_css_alloc(struct cgroup_subsys_state *parent_css)
 	page_counter_set_high(&memcg->swap, PAGE_COUNTER_MAX);
 	if (parent) {
 		WRITE_ONCE(memcg->swappiness, mem_cgroup_swappiness(parent));
+		WRITE_ONCE(memcg->ra_policy, READ_ONCE(parent->ra_policy));
 
 		page_counter_init(&memcg->memory, &parent->memory, memcg_on_dfl);
 		page_counter_init(&memcg->swap, &parent->swap, false);
@@ -4036,6 +4133,27 @@ static int seq_puts_memcg_tunable(struct seq_file *m, unsigned long value)
 	return 0;
 }
 
+static u64 memory_stat_max_age_read(struct cgroup_subsys_state *css,
+				    struct cftype *cft)
+{
+	struct mem_cgroup *memcg = mem_cgroup_from_css(css);
+
+	return jiffies_to_msecs(READ_ONCE(memcg->vmstats->stat_max_age));
+}
+
+static int memory_stat_max_age_write(struct cgroup_subsys_state *css,
+				     struct cftype *cft, u64 val)
+{
+	struct mem_cgroup *memcg = mem_cgroup_from_css(css);
+
+	/* Stats older than the periodic flush can't be asked for anyway */
+	if (val > jiffies_to_msecs(FLUSH_TIME) * 2)
+		return -EINVAL;
+
+	WRITE_ONCE(memcg->vmstats->stat_max_age, msecs_to_jiffies(val));
+	return 0;
+}
+
 static u64 memory_current_read(struct cgroup_subsys_state *css,
 			       struct cftype *cft)
 {
@@ -4338,7 +4456,8 @@ static int memory_numa_stat_show(struct seq_file *m, void *v)
 	int i;
 	struct mem_cgroup *memcg = mem_cgroup_from_seq(m);
 
-	mem_cgroup_flush_stats(memcg);
+	mem_cgroup_flush_stats_max_age(memcg,
+				       READ_ONCE(memcg->vmstats->stat_max_age));
 
 	for (i = 0; i < ARRAY_SIZE(memory_stats); i++) {
 		int nid;
@@ -4394,6 +4513,42 @@ static ssize_t memory_oom_group_write(struct kernfs_open_file *of,
 	return nbytes;
 }
 
+static const char * const memcg_ra_policy_names[MEMCG_NR_RA_POLICIES] = {
+	[MEMCG_RA_ADAPTIVE]	= "adaptive",
+	[MEMCG_RA_STREAMING]	= "streaming",
+	[MEMCG_RA_RANDOM]	= "random",
+};
+
+static int memory_ra_policy_show(struct seq_file *m, void *v)
+{
+	struct mem_cgroup *memcg = mem_cgroup_from_seq(m);
+	int policy = READ_ONCE(memcg->ra_policy);
+	int i;
+
+	for (i = 0; i < MEMCG_NR_RA_POLICIES; i++)
+		seq_printf(m, i == policy ? "%s[%s]" : "%s%s", i ? " " : "",
+			   memcg_ra_policy_names[i]);
+	seq_putc(m, '\n');
+
+	return 0;
+}
+
+static ssize_t memory_ra_policy_write(struct kernfs_open_file *of,
+				      char *buf, size_t nbytes, loff_t off)
+{
+	struct mem_cgroup *memcg = mem_cgroup_from_css(of_css(of));
+	int policy;
+
+	buf = strstrip(buf);
+	policy = sysfs_match_string(memcg_ra_policy_names, buf);
+	if (policy < 0)
+		return policy;
+
+	WRITE_ONCE(memcg->ra_policy, policy);
+
+	return nbytes;
+}
+
 enum {
 	MEMORY_RECLAIM_SWAPPINESS = 0,
 	MEMORY_RECLAIM_NULL,
@@ -4524,6 +4679,11 @@ static struct cftype memory_files[] = {
 		.name = "stat",
 		.seq_show = memory_stat_show,
 	},
+	{
+		.name = "stat_max_age_ms",
+		.read_u64 = memory_stat_max_age_read,
+		.write_u64 = memory_stat_max_age_write,
+	},
 #ifdef CONFIG_NUMA
 	{
 		.name = "numa_stat",
@@ -4536,6 +4696,12 @@ static struct cftype memory_files[] = {
 		.seq_show = memory_oom_group_show,
 		.write = memory_oom_group_write,
 	},
+	{
+		.name = "readahead.policy",
+		.flags = CFTYPE_NOT_ON_ROOT | CFTYPE_NS_DELEGATABLE,
+		.seq_show = memory_ra_policy_show,
+		.write = memory_ra_policy_write,
+	},
 	{
 		.name = "reclaim",
 		.flags = CFTYPE_NS_DELEGATABLE,
@@ -7,6 +7,8 @@
 #include <linux/memory-tiers.h>
 #include <linux/notifier.h>
 #include <linux/sched/sysctl.h>
+#include <linux/migrate.h>
+#include <linux/workqueue.h>
 
 #include "internal.h"
 
@@ -180,8 +182,59 @@ static ssize_t nodelist_show(struct device *dev,
 }
 static DEVICE_ATTR_RO(nodelist);
 
+static unsigned long memtier_node_stat_sum(struct memory_tier *memtier,
+					   enum node_stat_item first,
+					   enum node_stat_item last)
+{
+	unsigned long sum = 0;
+	enum node_stat_item item;
+	nodemask_t nmask;
+	int nid;
+
+	nmask = get_memtier_nodemask(memtier);
+	for_each_node_mask(nid, nmask) {
+		if (!node_online(nid))
+			continue;
+		for (item = first; item <= last; item++)
+			sum += node_page_state(NODE_DATA(nid), item);
+	}
+	return sum;
+}
+
+/* Pages promoted into the nodes of this tier */
+static ssize_t pgpromote_show(struct device *dev,
+			      struct device_attribute *attr, char *buf)
+{
+	unsigned long sum = 0;
+
+#ifdef CONFIG_NUMA_BALANCING
+	mutex_lock(&memory_tier_lock);
+	sum = memtier_node_stat_sum(to_memory_tier(dev), PGPROMOTE_SUCCESS,
+				    PGPROMOTE_SUCCESS);
+	mutex_unlock(&memory_tier_lock);
+#endif
+	return sysfs_emit(buf, "%lu\n", sum);
+}
+static DEVICE_ATTR_RO(pgpromote);
+
+/* Pages demoted out of the nodes of this tier */
+static ssize_t pgdemote_show(struct device *dev,
+			     struct device_attribute *attr, char *buf)
+{
+	unsigned long sum;
+
+	mutex_lock(&memory_tier_lock);
+	sum = memtier_node_stat_sum(to_memory_tier(dev), PGDEMOTE_KSWAPD,
+				    PGDEMOTE_PROACTIVE);
+	mutex_unlock(&memory_tier_lock);
+	return sysfs_emit(buf, "%lu\n", sum);
+}
+static DEVICE_ATTR_RO(pgdemote);
+
 static struct attribute *memtier_dev_attrs[] = {
 	&dev_attr_nodelist.attr,
+	&dev_attr_pgpromote.attr,
+	&dev_attr_pgdemote.attr,
 	NULL
 };
 
@@ -934,6 +987,200 @@ static int __init memory_tier_init(void)
 }
 subsys_initcall(memory_tier_init);
 
+#ifdef CONFIG_NUMA_BALANCING
+/*
+ * Hot page candidates reported by hotness sources wait in a small ring
+ * until the promotion work gets to them. Reports that find the ring full
+ * are dropped; the source will find the page hot again if it stays hot.
+ */
+#define MEMTIER_HOT_RING_SIZE	1024
+#define MEMTIER_PROMOTE_BATCH	64
+
+struct memtier_hot_entry {
+	unsigned long pfn;
+	int nid;
+};
+
+static struct {
+	spinlock_t lock;
+	unsigned int head;
+	unsigned int tail;
+	struct memtier_hot_entry entries[MEMTIER_HOT_RING_SIZE];
+} memtier_hot_ring = {
+	.lock = __SPIN_LOCK_UNLOCKED(memtier_hot_ring.lock),
+};
+
+static LIST_HEAD(hotness_sources);
+static DEFINE_MUTEX(hotness_source_lock);
+
+static void memtier_promote_workfn(struct work_struct *work);
+static DECLARE_WORK(memtier_promote_work, memtier_promote_workfn);
+
+/**
+ * memtier_register_hotness_source - register a source of hot pages
+ * @src: the source, with @src->name set
+ *
+ * Return: 0 on success, -EBUSY if @src is already registered.
+ */
+int memtier_register_hotness_source(struct memtier_hotness_source *src)
+{
+	struct memtier_hotness_source *iter;
+
+	mutex_lock(&hotness_source_lock);
+	list_for_each_entry(iter, &hotness_sources, list) {
+		if (iter == src) {
+			mutex_unlock(&hotness_source_lock);
+			return -EBUSY;
+		}
+	}
+	atomic_long_set(&src->nr_reported, 0);
+	atomic_long_set(&src->nr_dropped, 0);
+	list_add_tail(&src->list, &hotness_sources);
+	mutex_unlock(&hotness_source_lock);
+	return 0;
+}
+EXPORT_SYMBOL_GPL(memtier_register_hotness_source);
+
+/**
+ * memtier_unregister_hotness_source - unregister a source of hot pages
+ * @src: the source
+ *
+ * Candidates already reported by @src may still be promoted afterwards.
+ */
+void memtier_unregister_hotness_source(struct memtier_hotness_source *src)
+{
+	mutex_lock(&hotness_source_lock);
+	list_del(&src->list);
+	mutex_unlock(&hotness_source_lock);
+}
+EXPORT_SYMBOL_GPL(memtier_unregister_hotness_source);
+
+/**
+ * memtier_report_hot_pfns - report hot page candidates for promotion
+ * @src: the registered source reporting them
+ * @pfns: page frame numbers found to be hot
+ * @nr: number of entries in @pfns
+ * @nid: node to promote to, or NUMA_NO_NODE for the nearest top tier node
+ *
+ * The pages are promoted asynchronously, and only if they sit on a lower
+ * tier and are on the LRU by then. Can be called from any context except
+ * NMI.
+ *
+ * Return: the number of candidates queued.
+ */
+unsigned int memtier_report_hot_pfns(struct memtier_hotness_source *src,
+				     const unsigned long *pfns,
+				     unsigned int nr, int nid)
+{
+	unsigned long flags;
+	unsigned int i;
+
+	spin_lock_irqsave(&memtier_hot_ring.lock, flags);
+	for (i = 0; i < nr; i++) {
+		unsigned int head = memtier_hot_ring.head;
+
+		if (head - memtier_hot_ring.tail == MEMTIER_HOT_RING_SIZE)
+			break;
+		memtier_hot_ring.entries[head % MEMTIER_HOT_RING_SIZE] =
+			(struct memtier_hot_entry){ .pfn = pfns[i], .nid = nid };
+		memtier_hot_ring.head = head + 1;
+	}
+	spin_unlock_irqrestore(&memtier_hot_ring.lock, flags);
+
+	atomic_long_add(i, &src->nr_reported);
+	if (i < nr)
+		atomic_long_add(nr - i, &src->nr_dropped);
+	if (i)
+		queue_work(system_unbound_wq, &memtier_promote_work);
+	return i;
+}
+EXPORT_SYMBOL_GPL(memtier_report_hot_pfns);
+
+static bool memtier_hot_pop(struct memtier_hot_entry *entry)
+{
+	bool ret = false;
+
+	spin_lock_irq(&memtier_hot_ring.lock);
+	if (memtier_hot_ring.head != memtier_hot_ring.tail) {
+		*entry = memtier_hot_ring.entries[memtier_hot_ring.tail %
+						  MEMTIER_HOT_RING_SIZE];
+		memtier_hot_ring.tail++;
+		ret = true;
+	}
+	spin_unlock_irq(&memtier_hot_ring.lock);
+	return ret;
+}
+
+/* The top tier node with memory that is closest to @nid */
+static int memtier_promotion_target(int nid)
+{
+	int node, best = NUMA_NO_NODE, best_distance = INT_MAX;
+
+	for_each_node_state(node, N_MEMORY) {
+		if (!node_is_toptier(node))
+			continue;
+		if (node_distance(nid, node) < best_distance) {
+			best_distance = node_distance(nid, node);
+			best = node;
+		}
+	}
+	return best;
+}
+
+/* Return a referenced LRU folio on a lower tier at @pfn, or NULL */
+static struct folio *memtier_hot_folio(unsigned long pfn)
+{
+	struct page *page = pfn_to_online_page(pfn);
+	struct folio *folio;
+
+	if (!page)
+		return NULL;
+	folio = page_folio(page);
+	if (!folio_test_lru(folio) || !folio_try_get(folio))
+		return NULL;
+	if (unlikely(page_folio(page) != folio) || !folio_test_lru(folio) ||
+	    node_is_toptier(folio_nid(folio))) {
+		folio_put(folio);
+		return NULL;
+	}
+	return folio;
+}
+
+static void memtier_promote_workfn(struct work_struct *work)
+{
+	struct folio *batch[MEMTIER_PROMOTE_BATCH];
+	struct memtier_hot_entry entry;
+	int batch_nid = NUMA_NO_NODE;
+	unsigned int nr = 0;
+
+	while (memtier_hot_pop(&entry)) {
+		struct folio *folio = memtier_hot_folio(entry.pfn);
+		int nid = entry.nid;
+
+		if (!folio)
+			continue;
+		if (nid == NUMA_NO_NODE)
+			nid = memtier_promotion_target(folio_nid(folio));
+		if (nid == NUMA_NO_NODE || !node_online(nid) ||
+		    !node_is_toptier(nid)) {
+			folio_put(folio);
+			continue;
+		}
+
+		if (nr && (nid != batch_nid || nr == MEMTIER_PROMOTE_BATCH)) {
+			migrate_misplaced_folios(batch, nr, batch_nid);
+			nr = 0;
+			cond_resched();
+		}
+		batch_nid = nid;
+		batch[nr++] = folio;
+	}
+
+	if (nr)
+		migrate_misplaced_folios(batch, nr, batch_nid);
+}
+#endif /* CONFIG_NUMA_BALANCING */
+
 bool numa_demotion_enabled = false;
 
 #ifdef CONFIG_MIGRATION
@@ -960,8 +1207,32 @@ static ssize_t demotion_enabled_store(struct kobject *kobj,
 static struct kobj_attribute numa_demotion_enabled_attr =
 	__ATTR_RW(demotion_enabled);
 
+#ifdef CONFIG_NUMA_BALANCING
+static ssize_t hotness_sources_show(struct kobject *kobj,
+				    struct kobj_attribute *attr, char *buf)
+{
+	struct memtier_hotness_source *src;
+	int len = 0;
+
+	mutex_lock(&hotness_source_lock);
+	list_for_each_entry(src, &hotness_sources, list)
+		len += sysfs_emit_at(buf, len, "%s reported %ld dropped %ld\n",
+				     src->name,
+				     atomic_long_read(&src->nr_reported),
+				     atomic_long_read(&src->nr_dropped));
+	mutex_unlock(&hotness_source_lock);
+	return len;
+}
+
+static struct kobj_attribute numa_hotness_sources_attr =
+	__ATTR_RO(hotness_sources);
+#endif
+
 static struct attribute *numa_attrs[] = {
 	&numa_demotion_enabled_attr.attr,
+#ifdef CONFIG_NUMA_BALANCING
+	&numa_hotness_sources_attr.attr,
+#endif
 	NULL,
 };
 
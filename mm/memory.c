@@ -1050,9 +1050,11 @@ static inline struct folio *folio_prealloc(struct mm_struct *src_mm,
 {
 	struct folio *new_folio;
 
-	if (need_zero)
-		new_folio = vma_alloc_zeroed_movable_folio(vma, addr);
-	else
+	if (need_zero) {
+		new_folio = prezero_folio_alloc(vma, 0);
+		if (!new_folio)
+			new_folio = vma_alloc_zeroed_movable_folio(vma, addr);
+	} else
 		new_folio = vma_alloc_folio(GFP_HIGHUSER_MOVABLE, 0, vma, addr);
 
 	if (!new_folio)
@@ -44,6 +44,10 @@
 #include <linux/sched/sysctl.h>
 #include <linux/memory-tiers.h>
 #include <linux/pagewalk.h>
+#include <linux/sched/clock.h>
+#include <linux/sysctl.h>
+#include <linux/workqueue.h>
+#include <linux/slab.h>
 
 #include <asm/tlbflush.h>
 
@@ -747,7 +751,7 @@ EXPORT_SYMBOL(folio_migrate_flags);
 
 static int __migrate_folio(struct address_space *mapping, struct folio *dst,
 			   struct folio *src, void *src_private,
-			   enum migrate_mode mode)
+			   enum migrate_mode mode, bool copied)
 {
 	int rc, expected_count = folio_expected_refs(mapping, src);
 
@@ -755,9 +759,11 @@ static int __migrate_folio(struct address_space *mapping, struct folio *dst,
 	if (folio_ref_count(src) != expected_count)
 		return -EAGAIN;
 
-	rc = folio_mc_copy(dst, src);
-	if (unlikely(rc))
-		return rc;
+	if (!copied) {
+		rc = folio_mc_copy(dst, src);
+		if (unlikely(rc))
+			return rc;
+	}
 
 	rc = __folio_migrate_mapping(mapping, dst, src, expected_count);
 	if (rc != MIGRATEPAGE_SUCCESS)
@@ -786,7 +792,7 @@ int migrate_folio(struct address_space *mapping, struct folio *dst,
 		  struct folio *src, enum migrate_mode mode)
 {
 	BUG_ON(folio_test_writeback(src));	/* Writeback must be complete */
-	return __migrate_folio(mapping, dst, src, NULL, mode);
+	return __migrate_folio(mapping, dst, src, NULL, mode, false);
 }
 EXPORT_SYMBOL(migrate_folio);
 
@@ -940,7 +946,8 @@ EXPORT_SYMBOL_GPL(buffer_migrate_folio_norefs);
 int filemap_migrate_folio(struct address_space *mapping,
 		struct folio *dst, struct folio *src, enum migrate_mode mode)
 {
-	return __migrate_folio(mapping, dst, src, folio_get_private(src), mode);
+	return __migrate_folio(mapping, dst, src, folio_get_private(src), mode,
+			       false);
 }
 EXPORT_SYMBOL_GPL(filemap_migrate_folio);
 
@@ -1019,12 +1026,16 @@ static int fallback_migrate_folio(struct address_space *mapping,
  * The new page will have replaced the old page if this function
  * is successful.
  *
+ * If @copied is set, the contents of @src were already copied to @dst by
+ * migrate_batch_copy(), which only does so for folios that go through
+ * migrate_folio().
+ *
  * Return value:
  *   < 0 - error code
  *  MIGRATEPAGE_SUCCESS - success
  */
 static int move_to_new_folio(struct folio *dst, struct folio *src,
-				enum migrate_mode mode)
+				enum migrate_mode mode, bool copied)
 {
 	int rc = -EAGAIN;
 	bool is_lru = !__folio_test_movable(src);
@@ -1035,7 +1046,9 @@ static int move_to_new_folio(struct folio *dst, struct folio *src,
 	if (likely(is_lru)) {
 		struct address_space *mapping = folio_mapping(src);
 
-		if (!mapping)
+		if (copied)
+			rc = __migrate_folio(mapping, dst, src, NULL, mode, true);
+		else if (!mapping)
 			rc = migrate_folio(mapping, dst, src, mode);
 		else if (mapping_inaccessible(mapping))
 			rc = -EOPNOTSUPP;
@@ -1343,7 +1356,7 @@ static int migrate_folio_unmap(new_folio_t get_new_folio,
 static int migrate_folio_move(free_folio_t put_new_folio, unsigned long private,
 			      struct folio *src, struct folio *dst,
 			      enum migrate_mode mode, enum migrate_reason reason,
-			      struct list_head *ret)
+			      bool copied, struct list_head *ret)
 {
 	int rc;
 	int old_page_state = 0;
@@ -1355,7 +1368,7 @@ static int migrate_folio_move(free_folio_t put_new_folio, unsigned long private,
 	prev = dst->lru.prev;
 	list_del(&dst->lru);
 
-	rc = move_to_new_folio(dst, src, mode);
+	rc = move_to_new_folio(dst, src, mode, copied);
 	if (rc)
 		goto out;
 
@@ -1510,7 +1523,7 @@ static int unmap_and_move_huge_page(new_folio_t get_new_folio,
 	}
 
 	if (!folio_mapped(src))
-		rc = move_to_new_folio(dst, src, mode);
+		rc = move_to_new_folio(dst, src, mode, false);
 
 	if (page_was_mapped)
 		remove_migration_ptes(src,
@@ -1688,7 +1701,7 @@ static int migrate_hugetlbs(struct list_head *from, new_folio_t get_new_folio,
 static void migrate_folios_move(struct list_head *src_folios,
 		struct list_head *dst_folios,
 		free_folio_t put_new_folio, unsigned long private,
-		enum migrate_mode mode, int reason,
+		enum migrate_mode mode, int reason, bool copied,
 		struct list_head *ret_folios,
 		struct migrate_pages_stats *stats,
 		int *retry, int *thp_retry, int *nr_failed,
@@ -1709,7 +1722,7 @@ static void migrate_folios_move(struct list_head *src_folios,
 
 		rc = migrate_folio_move(put_new_folio, private,
 				folio, dst, mode,
-				reason, ret_folios);
+				reason, copied, ret_folios);
 		/*
 		 * The rules are:
 		 *	Success: folio will be freed
@@ -1737,6 +1750,212 @@ static void migrate_folios_move(struct list_head *src_folios,
 	}
 }
 
+/*
+ * Copying the folios of a batch can be spread over several threads once they
+ * are all unmapped. vm.migrate_copy_threads sets how many, 1 keeps copying
+ * each folio from migrate_folio_move().
+ */
+#define MIGRATE_COPY_MAX_THREADS	16
+/* Pages a copy thread should have to do to be worth waking */
+#define MIGRATE_COPY_MIN_PAGES		32
+
+static unsigned int sysctl_migrate_copy_threads __read_mostly = 1;
+/* Migration can be on the way to free memory, the copy threads must not stall */
+static struct workqueue_struct *migrate_copy_wq;
+
+struct migrate_copy_work {
+	struct work_struct work;
+	struct folio *src;
+	struct folio *dst;
+	unsigned int nr_folios;
+	int rc;
+};
+
+static void migrate_copy_chunk(struct migrate_copy_work *mcw)
+{
+	struct folio *src = mcw->src, *dst = mcw->dst;
+	unsigned int i;
+
+	for (i = 0; i < mcw->nr_folios; i++) {
+		mcw->rc = folio_mc_copy(dst, src);
+		if (mcw->rc)
+			return;
+		src = list_next_entry(src, lru);
+		dst = list_next_entry(dst, lru);
+	}
+}
+
+static void migrate_copy_workfn(struct work_struct *work)
+{
+	migrate_copy_chunk(container_of(work, struct migrate_copy_work, work));
+}
+
+/*
+ * Only plain anonymous folios are copied ahead of migrate_folio_move(): their
+ * migrate_folio() is just a copy and a mapping update, and once they are
+ * unmapped and locked nobody can take a new reference that could write to
+ * them. Checking for extra references before the copy, like __migrate_folio()
+ * does, covers the ones taken before the unmap.
+ */
+static bool migrate_batch_copy_eligible(struct folio *src)
+{
+	struct address_space *mapping;
+
+	if (__folio_test_movable(src) || !folio_test_anon(src))
+		return false;
+
+	mapping = folio_mapping(src);
+	if (mapping && mapping->a_ops->migrate_folio != migrate_folio)
+		return false;
+
+	return folio_ref_count(src) == folio_expected_refs(mapping, src);
+}
+
+/*
+ * Copy the unmapped folios of a batch in parallel. The folios that were
+ * copied are moved, with their destinations, to @copied_src and @copied_dst,
+ * in the same order. Returns false if nothing was copied, in which case all
+ * folios stay on @src_folios and @dst_folios.
+ */
+static bool migrate_batch_copy(struct list_head *src_folios,
+		struct list_head *dst_folios, struct list_head *copied_src,
+		struct list_head *copied_dst)
+{
+	struct migrate_copy_work *works;
+	unsigned int nr_threads = READ_ONCE(sysctl_migrate_copy_threads);
+	struct folio *folio, *folio2, *dst, *dst2;
+	unsigned long nr_pages = 0, per_thread, chunk_pages;
+	unsigned int i, nr_works;
+	bool failed = false;
+	u64 start;
+
+	if (nr_threads <= 1 || list_empty(src_folios) || !migrate_copy_wq)
+		return false;
+	/* Don't make reclaim and compaction wait for other threads */
+	if (current->flags & PF_MEMALLOC)
+		return false;
+
+	dst = list_first_entry(dst_folios, struct folio, lru);
+	dst2 = list_next_entry(dst, lru);
+	list_for_each_entry_safe(folio, folio2, src_folios, lru) {
+		if (migrate_batch_copy_eligible(folio)) {
+			list_move_tail(&folio->lru, copied_src);
+			list_move_tail(&dst->lru, copied_dst);
+			nr_pages += folio_nr_pages(folio);
+		} else {
+			count_vm_events(PGMIGRATE_BATCH_COPY_INELIGIBLE,
+					folio_nr_pages(folio));
+		}
+		dst = dst2;
+		dst2 = list_next_entry(dst, lru);
+	}
+
+	nr_threads = min_t(unsigned long, nr_threads,
+			   nr_pages / MIGRATE_COPY_MIN_PAGES);
+	if (nr_threads <= 1) {
+		if (nr_pages)
+			count_vm_event(PGMIGRATE_BATCH_COPY_SMALL);
+		goto undo;
+	}
+
+	works = kmalloc_array(nr_threads, sizeof(*works),
+			      GFP_NOWAIT | __GFP_NOWARN);
+	if (!works)
+		goto undo;
+
+	/* Split the batch in chunks of roughly the same number of pages */
+	per_thread = DIV_ROUND_UP(nr_pages, nr_threads);
+	nr_works = 0;
+	chunk_pages = 0;
+	dst = list_first_entry(copied_dst, struct folio, lru);
+	list_for_each_entry(folio, copied_src, lru) {
+		struct migrate_copy_work *mcw = &works[nr_works];
+
+		if (!chunk_pages) {
+			mcw->src = folio;
+			mcw->dst = dst;
+			mcw->nr_folios = 0;
+			mcw->rc = 0;
+		}
+		mcw->nr_folios++;
+		chunk_pages += folio_nr_pages(folio);
+		if (chunk_pages >= per_thread && nr_works < nr_threads - 1) {
+			nr_works++;
+			chunk_pages = 0;
+		}
+		dst = list_next_entry(dst, lru);
+	}
+	if (chunk_pages)
+		nr_works++;
+
+	start = local_clock();
+	/* The first chunk is copied by the caller */
+	for (i = 1; i < nr_works; i++) {
+		INIT_WORK(&works[i].work, migrate_copy_workfn);
+		queue_work(migrate_copy_wq, &works[i].work);
+	}
+	migrate_copy_chunk(&works[0]);
+	failed = works[0].rc != 0;
+	for (i = 1; i < nr_works; i++) {
+		flush_work(&works[i].work);
+		if (works[i].rc)
+			failed = true;
+	}
+	kfree(works);
+
+	/*
+	 * Let migrate_folio_move() copy again, so that the folio that failed
+	 * to copy is handled and reported the usual way.
+	 */
+	if (failed) {
+		count_vm_event(PGMIGRATE_BATCH_COPY_ERROR);
+		goto undo;
+	}
+
+	count_vm_events(PGMIGRATE_BATCH_COPY, nr_pages);
+	count_vm_events(PGMIGRATE_BATCH_COPY_US,
+			div_u64(local_clock() - start, NSEC_PER_USEC));
+	return true;
+
+undo:
+	list_splice(copied_src, src_folios);
+	list_splice(copied_dst, dst_folios);
+	INIT_LIST_HEAD(copied_src);
+	INIT_LIST_HEAD(copied_dst);
+	return false;
+}
+
+static int __init migrate_copy_init(void)
+{
+	migrate_copy_wq = alloc_workqueue("migrate_copy",
+					  WQ_UNBOUND | WQ_MEM_RECLAIM, 0);
+	return 0;
+}
+late_initcall(migrate_copy_init);
+
+#ifdef CONFIG_SYSCTL
+static const unsigned int migrate_copy_max_threads = MIGRATE_COPY_MAX_THREADS;
+
+static const struct ctl_table migrate_sysctl_table[] = {
+	{
+		.procname	= "migrate_copy_threads",
+		.data		= &sysctl_migrate_copy_threads,
+		.maxlen		= sizeof(sysctl_migrate_copy_threads),
+		.mode		= 0644,
+		.proc_handler	= proc_douintvec_minmax,
+		.extra1		= SYSCTL_ONE,
+		.extra2		= (void *)&migrate_copy_max_threads,
+	},
+};
+
+static int __init migrate_sysctl_init(void)
+{
+	register_sysctl_init("vm", migrate_sysctl_table);
+	return 0;
+}
+late_initcall(migrate_sysctl_init);
+#endif
+
 static void migrate_folios_undo(struct list_head *src_folios,
 		struct list_head *dst_folios,
 		free_folio_t put_new_folio, unsigned long private,
@@ -1786,6 +2005,8 @@ static int migrate_pages_batch(struct list_head *from,
 	int rc, rc_saved = 0, nr_pages;
 	LIST_HEAD(unmap_folios);
 	LIST_HEAD(dst_folios);
+	LIST_HEAD(copied_folios);
+	LIST_HEAD(copied_dst_folios);
 	bool nosplit = (reason == MR_NUMA_MISPLACED);
 
 	VM_WARN_ON_ONCE(mode != MIGRATE_ASYNC &&
@@ -1947,6 +2168,17 @@ static int migrate_pages_batch(struct list_head *from,
 	/* Flush TLBs for all unmapped folios */
 	try_to_unmap_flush();
 
+	if (migrate_batch_copy(&unmap_folios, &dst_folios, &copied_folios,
+			       &copied_dst_folios)) {
+		migrate_folios_move(&copied_folios, &copied_dst_folios,
+				put_new_folio, private, mode, reason, true,
+				ret_folios, stats, &retry, &thp_retry,
+				&nr_failed, &nr_retry_pages);
+		/* Whatever could not be moved yet has to be copied again */
+		list_splice(&copied_folios, &unmap_folios);
+		list_splice(&copied_dst_folios, &dst_folios);
+	}
+
 	retry = 1;
 	for (pass = 0; pass < nr_pass && retry; pass++) {
 		retry = 0;
@@ -1955,7 +2187,7 @@ static int migrate_pages_batch(struct list_head *from,
 
 		/* Move the unmapped folios */
 		migrate_folios_move(&unmap_folios, &dst_folios,
-				put_new_folio, private, mode, reason,
+				put_new_folio, private, mode, reason, false,
 				ret_folios, stats, &retry, &thp_retry,
 				&nr_failed, &nr_retry_pages);
 	}
@@ -2731,5 +2963,83 @@ int migrate_misplaced_folio(struct folio *folio, int node)
 	BUG_ON(!list_empty(&migratepages));
 	return nr_remaining ? -EAGAIN : 0;
 }
+
+/**
+ * migrate_misplaced_folios - migrate a batch of misplaced folios
+ * @folios: the folios, each with a reference held by the caller
+ * @nr: number of folios in @folios
+ * @node: the destination node
+ *
+ * Batched variant of migrate_misplaced_folio() for callers that found the
+ * folios by pfn rather than through a page table, such as a hardware
+ * hotness feed. The folios are isolated here and go through a single
+ * migrate_pages() call. The caller's references are always dropped.
+ *
+ * Return: the number of base pages migrated.
+ */
+unsigned int migrate_misplaced_folios(struct folio **folios, unsigned int nr,
+				      int node)
+{
+	pg_data_t *pgdat = NODE_DATA(node);
+	unsigned int nr_succeeded = 0;
+	unsigned long nr_pages = 0;
+	LIST_HEAD(migratepages);
+	unsigned int i;
+	int nr_remaining;
+
+	for (i = 0; i < nr; i++)
+		nr_pages += folio_nr_pages(folios[i]);
+
+	/* Avoid migrating to a node that is nearly full, but make room */
+	if (!migrate_balanced_pgdat(pgdat, nr_pages)) {
+		int z;
+
+		for (z = pgdat->nr_zones - 1; z >= 0; z--) {
+			if (managed_zone(pgdat->node_zones + z)) {
+				wakeup_kswapd(pgdat->node_zones + z, 0, 0,
+					      ZONE_MOVABLE);
+				break;
+			}
+		}
+		goto out_put;
+	}
+
+	for (i = 0; i < nr; i++) {
+		struct folio *folio = folios[i];
+
+		if (folio_nid(folio) == node)
+			continue;
+		/* See migrate_misplaced_folio_prepare() */
+		if (folio_is_file_lru(folio) &&
+		    (folio_test_dirty(folio) || folio_maybe_mapped_shared(folio)))
+			continue;
+		if (!folio_isolate_lru(folio))
+			continue;
+		node_stat_mod_folio(folio,
+				    NR_ISOLATED_ANON + folio_is_file_lru(folio),
+				    folio_nr_pages(folio));
+		list_add_tail(&folio->lru, &migratepages);
+	}
+
+	if (!list_empty(&migratepages)) {
+		nr_remaining = migrate_pages(&migratepages,
+					     alloc_misplaced_dst_folio, NULL,
+					     node, MIGRATE_ASYNC,
+					     MR_NUMA_MISPLACED, &nr_succeeded);
+		if (nr_remaining && !list_empty(&migratepages))
+			putback_movable_pages(&migratepages);
+	}
+
+	if (nr_succeeded) {
+		count_vm_numa_events(NUMA_PAGE_MIGRATE, nr_succeeded);
+		if (node_is_toptier(node))
+			mod_node_page_state(pgdat, PGPROMOTE_SUCCESS,
+					    nr_succeeded);
+	}
+out_put:
+	for (i = 0; i < nr; i++)
+		folio_put(folios[i]);
+	return nr_succeeded;
+}
 #endif /* CONFIG_NUMA_BALANCING */
 #endif /* CONFIG_NUMA */
@@ -46,6 +46,7 @@
 #include <linux/pkeys.h>
 #include <linux/oom.h>
 #include <linux/sched/mm.h>
+#include <linux/sched/clock.h>
 #include <linux/ksm.h>
 #include <linux/memfd.h>
 
@@ -1262,6 +1263,7 @@ void exit_mmap(struct mm_struct *mm)
 	unsigned long nr_accounted = 0;
 	VMA_ITERATOR(vmi, mm, 0);
 	int count = 0;
+	u64 start, unmapped;
 
 	/* mm's last user has gone, and its about to be pulled down */
 	mmu_notifier_release(mm);
@@ -1277,12 +1279,14 @@ void exit_mmap(struct mm_struct *mm)
 		goto destroy;
 	}
 
+	start = local_clock();
 	flush_cache_mm(mm);
 	tlb_gather_mmu_fullmm(&tlb, mm);
 	/* update_hiwater_rss(mm) here? but nobody should be looking */
 	/* Use ULONG_MAX here to ensure all VMAs in the mm are unmapped */
 	unmap_vmas(&tlb, &vmi.mas, vma, 0, ULONG_MAX, ULONG_MAX, false);
 	mmap_read_unlock(mm);
+	unmapped = local_clock();
 
 	/*
 	 * Set MMF_OOM_SKIP to hide this task from the oom killer/reaper
@@ -1314,6 +1318,11 @@ void exit_mmap(struct mm_struct *mm)
 
 	BUG_ON(count != mm->map_count);
 
+	count_vm_event(EXIT_MMAP);
+	count_vm_events(EXIT_MMAP_UNMAP_US,
+			div_u64(unmapped - start, NSEC_PER_USEC));
+	count_vm_events(EXIT_MMAP_FREE_US,
+			div_u64(local_clock() - unmapped, NSEC_PER_USEC));
 	trace_exit_mmap(mm);
 destroy:
 	__mt_destroy(&mm->mm_mt);
@@ -817,6 +817,26 @@ int bdi_set_strict_limit(struct backing_dev_info *bdi, unsigned int strict_limit
 	return 0;
 }
 
+/*
+ * With a writeback latency target, a wb may only hold as much dirty memory as
+ * it can write back within the target, and it is throttled against its own
+ * limit rather than the global one, like with strictlimit.
+ */
+int bdi_set_writeback_latency(struct backing_dev_info *bdi, unsigned int ms)
+{
+	if (ms > jiffies_to_msecs(MAX_PAUSE) * 50)
+		return -EINVAL;
+
+	WRITE_ONCE(bdi->writeback_latency_ms, ms);
+	return 0;
+}
+
+static bool bdi_strictlimit(struct backing_dev_info *bdi)
+{
+	return (bdi->capabilities & BDI_CAP_STRICTLIMIT) ||
+		READ_ONCE(bdi->writeback_latency_ms);
+}
+
 static unsigned long dirty_freerun_ceiling(unsigned long thresh,
 					   unsigned long bg_thresh)
 {
@@ -905,6 +925,7 @@ static unsigned long __wb_calc_thresh(struct dirty_throttle_control *dtc,
 	u64 wb_max_thresh;
 	unsigned long numerator, denominator;
 	unsigned long wb_min_ratio, wb_max_ratio;
+	unsigned int latency_ms;
 
 	/*
 	 * Calculate this wb's share of the thresh ratio.
@@ -928,7 +949,7 @@ static unsigned long __wb_calc_thresh(struct dirty_throttle_control *dtc,
 	 * writes can rampup the threshold quickly.
 	 */
 	if (thresh > dtc->dirty) {
-		if (unlikely(wb->bdi->capabilities & BDI_CAP_STRICTLIMIT))
+		if (unlikely(bdi_strictlimit(wb->bdi)))
 			wb_thresh = max(wb_thresh, (thresh - dtc->dirty) / 100);
 		else
 			wb_thresh = max(wb_thresh, (thresh - dtc->dirty) / 8);
@@ -938,6 +959,19 @@ static unsigned long __wb_calc_thresh(struct dirty_throttle_control *dtc,
 	if (wb_thresh > wb_max_thresh)
 		wb_thresh = wb_max_thresh;
 
+	latency_ms = READ_ONCE(wb->bdi->writeback_latency_ms);
+	if (latency_ms) {
+		/*
+		 * What can be written back within the target at the estimated
+		 * bandwidth, but not less than the per-cpu counter error.
+		 */
+		wb_max_thresh = div_u64((u64)READ_ONCE(wb->avg_write_bandwidth) *
+					latency_ms, MSEC_PER_SEC);
+		wb_max_thresh = max_t(u64, wb_max_thresh, 4 * wb_stat_error());
+		if (wb_thresh > wb_max_thresh)
+			wb_thresh = wb_max_thresh;
+	}
+
 	return wb_thresh;
 }
 
@@ -1119,7 +1153,7 @@ static void wb_position_ratio(struct dirty_throttle_control *dtc)
 	 * much earlier than global "freerun" is reached (~23MB vs. ~2.3GB
 	 * in the example above).
 	 */
-	if (unlikely(wb->bdi->capabilities & BDI_CAP_STRICTLIMIT)) {
+	if (unlikely(bdi_strictlimit(wb->bdi))) {
 		long long wb_pos_ratio;
 
 		if (dtc->wb_dirty >= wb_thresh)
@@ -1448,7 +1482,7 @@ static void wb_update_dirty_ratelimit(struct dirty_throttle_control *dtc,
 	 * Hence, to calculate "step" properly, we have to use wb_dirty as
 	 * "dirty" and wb_setpoint as "setpoint".
 	 */
-	if (unlikely(wb->bdi->capabilities & BDI_CAP_STRICTLIMIT)) {
+	if (unlikely(bdi_strictlimit(wb->bdi))) {
 		dirty = dtc->wb_dirty;
 		setpoint = (dtc->wb_thresh + dtc->wb_bg_thresh) / 2;
 	}
@@ -1826,7 +1860,8 @@ static int balance_dirty_pages(struct bdi_writeback *wb,
 	unsigned long task_ratelimit;
 	unsigned long dirty_ratelimit;
 	struct backing_dev_info *bdi = wb->bdi;
-	bool strictlimit = bdi->capabilities & BDI_CAP_STRICTLIMIT;
+	bool strictlimit = bdi_strictlimit(bdi);
+	unsigned int latency_ms = READ_ONCE(bdi->writeback_latency_ms);
 	unsigned long start_time = jiffies;
 	int ret = 0;
 
@@ -1917,6 +1952,10 @@ static int balance_dirty_pages(struct bdi_writeback *wb,
 		task_ratelimit = ((u64)dirty_ratelimit * sdtc->pos_ratio) >>
 							RATELIMIT_CALC_SHIFT;
 		max_pause = wb_max_pause(wb, sdtc->wb_dirty);
+		/* A single pause should not blow the latency target either */
+		if (latency_ms)
+			max_pause = clamp_t(long, msecs_to_jiffies(latency_ms),
+					    1, max_pause);
 		min_pause = wb_min_pause(wb, max_pause,
 					 task_ratelimit, dirty_ratelimit,
 					 &nr_dirtied_pause);
@@ -1978,6 +2017,9 @@ static int balance_dirty_pages(struct bdi_writeback *wb,
 		__set_current_state(TASK_KILLABLE);
 		bdi->last_bdp_sleep = jiffies;
 		io_schedule_timeout(pause);
+		atomic_long_inc(&bdi->bdp_pause_hist[min_t(int,
+				fls(jiffies_to_msecs(pause)),
+				BDP_PAUSE_BUCKETS - 1)]);
 
 		current->dirty_paused_when = now + pause;
 		current->nr_dirtied = 0;
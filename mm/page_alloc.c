@@ -4892,6 +4892,172 @@ unsigned long alloc_pages_bulk_noprof(gfp_t gfp, int preferred_nid,
 }
 EXPORT_SYMBOL_GPL(alloc_pages_bulk_noprof);
 
+/*
+ * alloc_folios_bulk_noprof - Allocate a batch of folios of one order
+ * @gfp: GFP flags for the allocation
+ * @preferred_nid: The preferred NUMA node ID to allocate from
+ * @nodemask: Set of nodes to allocate from, may be NULL
+ * @order: The order of every folio in the batch
+ * @nr_folios: The number of folios desired in the array
+ * @folio_array: Array to store the folios
+ *
+ * This is the high-order counterpart of alloc_pages_bulk_noprof().  Orders
+ * that are cached on the per-cpu lists are served from there with a single
+ * zone watermark check and pcp lock round trip for the whole batch; the pcp
+ * list refills itself from the buddy in pcp->batch sized chunks.  Other
+ * orders, or requests the fast path cannot handle, fall back to allocating
+ * one folio at a time.
+ *
+ * Empty array slots are filled, populated ones are skipped.  Returns the
+ * number of folios in the array; on a partial allocation the caller may
+ * retry or use the folios it got.
+ */
+unsigned long alloc_folios_bulk_noprof(gfp_t gfp, int preferred_nid,
+			nodemask_t *nodemask, unsigned int order,
+			int nr_folios, struct folio **folio_array)
+{
+	struct page *page;
+	struct folio *folio;
+	unsigned long __maybe_unused UP_flags;
+	struct zone *zone;
+	struct zoneref *z;
+	struct per_cpu_pages *pcp;
+	struct list_head *pcp_list;
+	struct alloc_context ac;
+	gfp_t alloc_gfp;
+	unsigned int alloc_flags = ALLOC_WMARK_LOW;
+	int nr_populated = 0, nr_account = 0;
+
+	while (nr_populated < nr_folios && folio_array[nr_populated])
+		nr_populated++;
+
+	if (unlikely(nr_folios <= 0 || nr_folios - nr_populated == 0))
+		goto out;
+
+	gfp |= __GFP_COMP;
+
+	/* Orders that never sit on the pcp lists gain nothing from batching. */
+	if (!pcp_allowed_order(order))
+		goto fallback;
+
+	/* Bulk allocator does not support memcg accounting. */
+	if (memcg_kmem_online() && (gfp & __GFP_ACCOUNT))
+		goto fallback;
+
+	if (nr_folios - nr_populated == 1)
+		goto failed;
+
+#ifdef CONFIG_PAGE_OWNER
+	/* See alloc_pages_bulk_noprof() */
+	if (static_branch_unlikely(&page_owner_inited))
+		goto fallback;
+#endif
+
+	gfp &= gfp_allowed_mask;
+	alloc_gfp = gfp;
+	if (!prepare_alloc_pages(gfp, order, preferred_nid, nodemask, &ac,
+				 &alloc_gfp, &alloc_flags))
+		goto out;
+	gfp = alloc_gfp;
+
+	z = ac.preferred_zoneref;
+	for_next_zone_zonelist_nodemask(zone, z, ac.highest_zoneidx, ac.nodemask) {
+		unsigned long mark;
+
+		if (cpusets_enabled() && (alloc_flags & ALLOC_CPUSET) &&
+		    !__cpuset_zone_allowed(zone, gfp)) {
+			continue;
+		}
+
+		if (nr_online_nodes > 1 && zone != zonelist_zone(ac.preferred_zoneref) &&
+		    zone_to_nid(zone) != zonelist_node_idx(ac.preferred_zoneref)) {
+			goto failed;
+		}
+
+		cond_accept_memory(zone, order);
+retry_this_zone:
+		mark = wmark_pages(zone, alloc_flags & ALLOC_WMARK_MASK) +
+			((unsigned long)nr_folios << order);
+		if (zone_watermark_fast(zone, order, mark,
+				zonelist_zone_idx(ac.preferred_zoneref),
+				alloc_flags, gfp)) {
+			break;
+		}
+
+		if (cond_accept_memory(zone, order))
+			goto retry_this_zone;
+
+		if (deferred_pages_enabled()) {
+			if (_deferred_grow_zone(zone, order))
+				goto retry_this_zone;
+		}
+	}
+
+	if (unlikely(!zone))
+		goto failed;
+
+	pcp_trylock_prepare(UP_flags);
+	pcp = pcp_spin_trylock(zone->per_cpu_pageset);
+	if (!pcp)
+		goto failed_irq;
+
+	pcp_list = &pcp->lists[order_to_pindex(ac.migratetype, order)];
+	while (nr_populated < nr_folios) {
+		if (folio_array[nr_populated]) {
+			nr_populated++;
+			continue;
+		}
+
+		page = __rmqueue_pcplist(zone, order, ac.migratetype,
+					 alloc_flags, pcp, pcp_list);
+		if (unlikely(!page)) {
+			if (!nr_account) {
+				pcp_spin_unlock(pcp);
+				goto failed_irq;
+			}
+			break;
+		}
+		nr_account++;
+
+		prep_new_page(page, order, gfp, 0);
+		set_page_refcounted(page);
+		folio_array[nr_populated++] = page_rmappable_folio(page);
+	}
+
+	pcp_spin_unlock(pcp);
+	pcp_trylock_finish(UP_flags);
+
+	__count_zid_vm_events(PGALLOC, zone_idx(zone), nr_account << order);
+	zone_statistics(zonelist_zone(ac.preferred_zoneref), zone, nr_account);
+	count_vm_events(PGALLOC_BULK_FOLIO, nr_account);
+
+out:
+	return nr_populated;
+
+failed_irq:
+	pcp_trylock_finish(UP_flags);
+
+failed:
+	folio = __folio_alloc_noprof(gfp, order, preferred_nid, nodemask);
+	if (folio) {
+		count_vm_event(PGALLOC_BULK_FOLIO_FALLBACK);
+		folio_array[nr_populated++] = folio;
+	}
+	goto out;
+
+fallback:
+	for (; nr_populated < nr_folios; nr_populated++) {
+		if (folio_array[nr_populated])
+			continue;
+		folio = __folio_alloc_noprof(gfp, order, preferred_nid, nodemask);
+		if (!folio)
+			break;
+		count_vm_event(PGALLOC_BULK_FOLIO_FALLBACK);
+		folio_array[nr_populated] = folio;
+	}
+	goto out;
+}
+
 /*
  * This is the 'heart' of the zoned buddy allocator.
  */
@@ -165,6 +165,7 @@ static inline size_t pcpu_obj_full_size(size_t size)
 #ifdef CONFIG_PERCPU_STATS
 
 #include <linux/spinlock.h>
+#include <linux/sched/clock.h>
 
 struct percpu_stats {
 	u64 nr_alloc;		/* lifetime # of allocations */
@@ -175,6 +176,9 @@ struct percpu_stats {
 	u32 nr_max_chunks;	/* max # of live chunks */
 	size_t min_alloc_size;	/* min allocation size */
 	size_t max_alloc_size;	/* max allocation size */
+	u64 nr_alloc_populated;	/* # of allocations that populated pages */
+	u64 alloc_ns_total;	/* total time spent in pcpu_alloc() */
+	u64 alloc_ns_max;	/* slowest pcpu_alloc() */
 };
 
 extern struct percpu_stats pcpu_stats;
@@ -261,6 +265,32 @@ static inline void pcpu_stats_chunk_dealloc(void)
 	spin_unlock_irqrestore(&pcpu_lock, flags);
 }
 
+/*
+ * pcpu_stats_clock - timestamp the start of an allocation
+ */
+static inline u64 pcpu_stats_clock(void)
+{
+	return local_clock();
+}
+
+/*
+ * pcpu_stats_alloc_latency - account the latency of a successful allocation
+ * @ns: time spent in pcpu_alloc()
+ * @populated: whether the allocation had to populate pages itself
+ */
+static inline void pcpu_stats_alloc_latency(u64 ns, bool populated)
+{
+	unsigned long flags;
+	spin_lock_irqsave(&pcpu_lock, flags);
+
+	pcpu_stats.alloc_ns_total += ns;
+	pcpu_stats.alloc_ns_max = max(pcpu_stats.alloc_ns_max, ns);
+	if (populated)
+		pcpu_stats.nr_alloc_populated++;
+
+	spin_unlock_irqrestore(&pcpu_lock, flags);
+}
+
 #else
 
 static inline void pcpu_stats_save_ai(const struct pcpu_alloc_info *ai)
@@ -283,6 +313,15 @@ static inline void pcpu_stats_chunk_dealloc(void)
 {
 }
 
+static inline u64 pcpu_stats_clock(void)
+{
+	return 0;
+}
+
+static inline void pcpu_stats_alloc_latency(u64 ns, bool populated)
+{
+}
+
 #endif /* !CONFIG_PERCPU_STATS */
 
 #endif
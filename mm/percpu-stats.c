@@ -9,6 +9,7 @@
  */
 #include <linux/debugfs.h>
 #include <linux/list.h>
+#include <linux/math64.h>
 #include <linux/percpu.h>
 #include <linux/seq_file.h>
 #include <linux/sort.h>
@@ -188,6 +189,10 @@ static int percpu_stats_show(struct seq_file *m, void *v)
 	PU(nr_max_chunks);
 	PU(min_alloc_size);
 	PU(max_alloc_size);
+	PU(nr_alloc_populated);
+	PU(alloc_ns_max);
+	P("alloc_ns_avg", (pcpu_stats.nr_alloc ?
+	  div64_u64(pcpu_stats.alloc_ns_total, pcpu_stats.nr_alloc) : 0));
 	P("empty_pop_pages", pcpu_nr_empty_pop_pages);
 	seq_putc(m, '\n');
 
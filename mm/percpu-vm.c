@@ -405,6 +405,7 @@ static bool pcpu_should_reclaim_chunk(struct pcpu_chunk *chunk)
 	 */
 	return ((chunk->isolated && chunk->nr_empty_pop_pages) ||
 		(pcpu_nr_empty_pop_pages >
-		 (PCPU_EMPTY_POP_PAGES_HIGH + chunk->nr_empty_pop_pages) &&
+		 (READ_ONCE(pcpu_empty_pop_pages_high) +
+		  chunk->nr_empty_pop_pages) &&
 		 chunk->nr_empty_pop_pages >= chunk->nr_pages / 4));
 }
@@ -86,7 +86,9 @@
 #include <linux/kmemleak.h>
 #include <linux/sched.h>
 #include <linux/sched/mm.h>
+#include <linux/sched/clock.h>
 #include <linux/memcontrol.h>
+#include <linux/sysctl.h>
 
 #include <asm/cacheflush.h>
 #include <asm/sections.h>
@@ -106,8 +108,8 @@
 /* chunks in slots below this are subject to being sidelined on failed alloc */
 #define PCPU_SLOT_FAIL_THRESHOLD	3
 
-#define PCPU_EMPTY_POP_PAGES_LOW	2
-#define PCPU_EMPTY_POP_PAGES_HIGH	4
+#define PCPU_EMPTY_POP_PAGES_DEFAULT	4
+#define PCPU_EMPTY_POP_PAGES_MAX	256
 
 #ifdef CONFIG_SMP
 /* default addr <-> pcpu_ptr mapping, override in asm/percpu.h if necessary */
@@ -187,11 +189,26 @@ int pcpu_nr_empty_pop_pages;
  */
 static unsigned long pcpu_nr_populated;
 
+/*
+ * Target number of populated free pages, tunable through
+ * vm.percpu_empty_pop_pages.  Bursts of allocations, e.g. while a batch of
+ * containers creates its cgroups and sockets, run ahead of the balance work
+ * with the default; raising it lets the work pre-populate further ahead so
+ * that fewer allocations have to populate pages under pcpu_alloc_mutex.
+ */
+static unsigned int pcpu_empty_pop_pages_high __read_mostly =
+	PCPU_EMPTY_POP_PAGES_DEFAULT;
+
+static inline int pcpu_empty_pop_pages_low(void)
+{
+	return max(READ_ONCE(pcpu_empty_pop_pages_high) / 2, 1U);
+}
+
 /*
  * Balance work is used to populate or destroy chunks asynchronously.  We
  * try to keep the number of populated free pages between
- * PCPU_EMPTY_POP_PAGES_LOW and HIGH for atomic allocations and at most one
- * empty chunk.
+ * pcpu_empty_pop_pages_low() and pcpu_empty_pop_pages_high for atomic
+ * allocations and at most one empty chunk.
  */
 static void pcpu_balance_workfn(struct work_struct *work);
 static DECLARE_WORK(pcpu_balance_work, pcpu_balance_workfn);
@@ -1741,6 +1758,8 @@ void __percpu *pcpu_alloc_noprof(size_t size, size_t align, bool reserved,
 	unsigned long flags;
 	void __percpu *ptr;
 	size_t bits, bit_align;
+	bool populated = false;
+	u64 start = pcpu_stats_clock();
 
 	gfp = current_gfp_context(gfp);
 	/* whitelisted flags that can be passed to the backing allocators */
@@ -1852,7 +1871,7 @@ void __percpu *pcpu_alloc_noprof(size_t size, size_t align, bool reserved,
 area_found:
 	pcpu_stats_area_alloc(chunk, size);
 
-	if (pcpu_nr_empty_pop_pages < PCPU_EMPTY_POP_PAGES_LOW)
+	if (pcpu_nr_empty_pop_pages < pcpu_empty_pop_pages_low())
 		pcpu_schedule_balance_work();
 
 	spin_unlock_irqrestore(&pcpu_lock, flags);
@@ -1868,6 +1887,7 @@ void __percpu *pcpu_alloc_noprof(size_t size, size_t align, bool reserved,
 			WARN_ON(chunk->immutable);
 
 			ret = pcpu_populate_chunk(chunk, rs, re, pcpu_gfp);
+			populated = true;
 
 			spin_lock_irqsave(&pcpu_lock, flags);
 			if (ret) {
@@ -1897,6 +1917,9 @@ void __percpu *pcpu_alloc_noprof(size_t size, size_t align, bool reserved,
 
 	pcpu_alloc_tag_alloc_hook(chunk, off, size);
 
+	if (start)
+		pcpu_stats_alloc_latency(local_clock() - start, populated);
+
 	return ptr;
 
 fail_unlock:
@@ -1997,7 +2020,7 @@ static void pcpu_balance_populated(void)
 	/* gfp flags passed to underlying allocators */
 	const gfp_t gfp = GFP_KERNEL | __GFP_NORETRY | __GFP_NOWARN;
 	struct pcpu_chunk *chunk;
-	int slot, nr_to_pop, ret;
+	int slot, nr_to_pop, high, ret;
 
 	lockdep_assert_held(&pcpu_lock);
 
@@ -2012,14 +2035,13 @@ static void pcpu_balance_populated(void)
 	 * inefficient.
 	 */
 retry_pop:
+	high = READ_ONCE(pcpu_empty_pop_pages_high);
 	if (pcpu_atomic_alloc_failed) {
-		nr_to_pop = PCPU_EMPTY_POP_PAGES_HIGH;
+		nr_to_pop = high;
 		/* best effort anyway, don't worry about synchronization */
 		pcpu_atomic_alloc_failed = false;
 	} else {
-		nr_to_pop = clamp(PCPU_EMPTY_POP_PAGES_HIGH -
-				  pcpu_nr_empty_pop_pages,
-				  0, PCPU_EMPTY_POP_PAGES_HIGH);
+		nr_to_pop = clamp(high - pcpu_nr_empty_pop_pages, 0, high);
 	}
 
 	for (slot = pcpu_size_to_slot(PAGE_SIZE); slot <= pcpu_free_slot; slot++) {
@@ -2119,7 +2141,8 @@ static void pcpu_reclaim_populated(void)
 				break;
 
 			/* reintegrate chunk to prevent atomic alloc failures */
-			if (pcpu_nr_empty_pop_pages < PCPU_EMPTY_POP_PAGES_HIGH) {
+			if (pcpu_nr_empty_pop_pages <
+			    READ_ONCE(pcpu_empty_pop_pages_high)) {
 				reintegrate = true;
 				break;
 			}
@@ -3358,6 +3381,34 @@ unsigned long pcpu_nr_pages(void)
 	return pcpu_nr_populated * pcpu_nr_units;
 }
 
+static int pcpu_empty_pop_pages_handler(const struct ctl_table *table,
+					int write, void *buffer, size_t *lenp,
+					loff_t *ppos)
+{
+	int ret = proc_douintvec_minmax(table, write, buffer, lenp, ppos);
+
+	/* let the balance work catch up with a raised target right away */
+	if (!ret && write)
+		pcpu_schedule_balance_work();
+
+	return ret;
+}
+
+static const unsigned int pcpu_empty_pop_pages_min = 2;
+static const unsigned int pcpu_empty_pop_pages_max = PCPU_EMPTY_POP_PAGES_MAX;
+
+static const struct ctl_table pcpu_sysctl_table[] = {
+	{
+		.procname	= "percpu_empty_pop_pages",
+		.data		= &pcpu_empty_pop_pages_high,
+		.maxlen		= sizeof(pcpu_empty_pop_pages_high),
+		.mode		= 0644,
+		.proc_handler	= pcpu_empty_pop_pages_handler,
+		.extra1		= (void *)&pcpu_empty_pop_pages_min,
+		.extra2		= (void *)&pcpu_empty_pop_pages_max,
+	},
+};
+
 /*
  * Percpu allocator is initialized early during boot when neither slab or
  * workqueue is available.  Plug async management until everything is up
@@ -3366,6 +3417,7 @@ unsigned long pcpu_nr_pages(void)
 static int __init percpu_enable_async(void)
 {
 	pcpu_async_enabled = true;
+	register_sysctl_init("vm", pcpu_sysctl_table);
 	return 0;
 }
 subsys_initcall(percpu_enable_async);
@@ -0,0 +1,363 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Pool of pre-zeroed folios for anonymous faults.
+ *
+ * Zeroing a folio is the bulk of the cost of first touching anonymous
+ * memory, and for PMD sized folios it dominates the fault latency. A low
+ * priority kthread keeps a per node, per order pool of folios that were
+ * zeroed ahead of time, and the anonymous fault paths take from it before
+ * falling back to allocating and zeroing synchronously.
+ *
+ * The pool is sized by vm.prezero_pages (order-0 folios per node) and
+ * vm.prezero_thp_folios (PMD sized folios per node). Both default to 0,
+ * which disables it. Pooled folios are returned to the page allocator
+ * under memory pressure through a shrinker.
+ *
+ * The pool is a private list that migration, memory offlining and
+ * alloc_contig_range() know nothing about, so it is filled from unmovable
+ * pageblocks outside ZONE_MOVABLE and CMA. That keeps it out of the way of
+ * anything that has to empty a movable range.
+ */
+
+#include <linux/mm.h>
+#include <linux/highmem.h>
+#include <linux/kthread.h>
+#include <linux/cpuset.h>
+#include <linux/mempolicy.h>
+#include <linux/shrinker.h>
+#include <linux/sysctl.h>
+#include <linux/vmstat.h>
+#include <linux/huge_mm.h>
+
+#include "internal.h"
+
+enum {
+	PREZERO_ORDER_0,
+#ifdef CONFIG_TRANSPARENT_HUGEPAGE
+	PREZERO_ORDER_PMD,
+#endif
+	PREZERO_NR_ORDERS,
+};
+
+struct prezero_pool {
+	spinlock_t lock;
+	struct list_head folios;
+	unsigned long nr;
+};
+
+static struct prezero_pool (*prezero_pools)[PREZERO_NR_ORDERS];
+static unsigned int prezero_pages __read_mostly;
+static unsigned int prezero_thp_folios __read_mostly;
+static struct task_struct *kprezerod;
+static DECLARE_WAIT_QUEUE_HEAD(kprezerod_wait);
+static struct shrinker *prezero_shrinker;
+/* Don't refill a pool the shrinker just drained until this time. */
+static unsigned long prezero_backoff_until;
+/* The pool sizes were changed, retry right away */
+static bool prezero_kicked;
+
+/* Longest wait between refill attempts while a target can't be reached */
+#define PREZERO_MAX_RETRY_DELAY	(64 * HZ)
+
+static unsigned int prezero_order(int idx)
+{
+#ifdef CONFIG_TRANSPARENT_HUGEPAGE
+	if (idx == PREZERO_ORDER_PMD)
+		return HPAGE_PMD_ORDER;
+#endif
+	return 0;
+}
+
+static int prezero_order_idx(unsigned int order)
+{
+	if (!order)
+		return PREZERO_ORDER_0;
+#ifdef CONFIG_TRANSPARENT_HUGEPAGE
+	if (order == HPAGE_PMD_ORDER)
+		return PREZERO_ORDER_PMD;
+#endif
+	return -1;
+}
+
+static unsigned long prezero_target(int idx)
+{
+	if (idx == PREZERO_ORDER_0)
+		return READ_ONCE(prezero_pages);
+	return READ_ONCE(prezero_thp_folios);
+}
+
+static bool prezero_pool_low(struct prezero_pool *pool, int idx)
+{
+	return READ_ONCE(pool->nr) < prezero_target(idx) / 2 + 1;
+}
+
+/**
+ * prezero_folio_alloc - take a pre-zeroed folio for an anonymous fault
+ * @vma: the faulting vma
+ * @order: the order of the folio
+ *
+ * Return: a zeroed, uncharged folio of @order on the local node, or NULL
+ * if the pool is empty or cannot satisfy the vma's placement constraints.
+ */
+struct folio *prezero_folio_alloc(struct vm_area_struct *vma,
+				  unsigned int order)
+{
+	struct prezero_pool *pool;
+	struct folio *folio;
+	int idx = prezero_order_idx(order);
+	int nid = numa_node_id();
+
+	if (idx < 0 || !prezero_pools || !prezero_target(idx))
+		return NULL;
+
+	/*
+	 * Pooled folios come from the local node, so only use them when that
+	 * is what the fault would get.
+	 */
+	if (vma_policy(vma) || current->mempolicy ||
+	    !node_isset(nid, cpuset_current_mems_allowed))
+		return NULL;
+
+	/* See user_alloc_needs_zeroing() */
+	if (cpu_dcache_is_aliasing() || cpu_icache_is_aliasing())
+		return NULL;
+
+	pool = &prezero_pools[nid][idx];
+	if (!READ_ONCE(pool->nr)) {
+		count_vm_event(PREZERO_EMPTY);
+		wake_up_interruptible(&kprezerod_wait);
+		return NULL;
+	}
+
+	spin_lock(&pool->lock);
+	folio = list_first_entry_or_null(&pool->folios, struct folio, lru);
+	if (folio) {
+		list_del(&folio->lru);
+		pool->nr--;
+	}
+	spin_unlock(&pool->lock);
+
+	if (!folio)
+		return NULL;
+
+	count_vm_event(PREZERO_ALLOC);
+	if (prezero_pool_low(pool, idx))
+		wake_up_interruptible(&kprezerod_wait);
+
+	return folio;
+}
+
+static bool prezero_fill_one(int nid, int idx)
+{
+	/* Not movable while pooled, see the comment at the top */
+	gfp_t gfp = (GFP_HIGHUSER & ~__GFP_RECLAIM) | __GFP_THISNODE |
+		    __GFP_NOWARN;
+	unsigned int order = prezero_order(idx);
+	struct prezero_pool *pool = &prezero_pools[nid][idx];
+	struct folio *folio;
+	long i;
+
+	/* Only take memory that is free anyway, never reclaim for the pool */
+	folio = __folio_alloc_node(gfp, order, nid);
+	if (!folio)
+		return false;
+
+	for (i = 0; i < folio_nr_pages(folio); i++) {
+		clear_highpage(folio_page(folio, i));
+		cond_resched();
+	}
+	count_vm_events(PREZERO_FILL, folio_nr_pages(folio));
+
+	spin_lock(&pool->lock);
+	list_add_tail(&folio->lru, &pool->folios);
+	pool->nr++;
+	spin_unlock(&pool->lock);
+
+	return true;
+}
+
+static void prezero_trim(struct prezero_pool *pool, unsigned long target)
+{
+	LIST_HEAD(free);
+	struct folio *folio, *next;
+
+	spin_lock(&pool->lock);
+	while (pool->nr > target) {
+		folio = list_last_entry(&pool->folios, struct folio, lru);
+		list_move(&folio->lru, &free);
+		pool->nr--;
+	}
+	spin_unlock(&pool->lock);
+
+	list_for_each_entry_safe(folio, next, &free, lru) {
+		list_del(&folio->lru);
+		folio_put(folio);
+	}
+}
+
+static bool prezero_needs_work(void)
+{
+	int nid, idx;
+
+	for_each_node_state(nid, N_MEMORY)
+		for (idx = 0; idx < PREZERO_NR_ORDERS; idx++)
+			if (READ_ONCE(prezero_pools[nid][idx].nr) !=
+			    prezero_target(idx))
+				return true;
+	return false;
+}
+
+static int kprezerod_fn(void *data)
+{
+	unsigned long delay = HZ;
+	int nid, idx;
+
+	set_freezable();
+	set_user_nice(current, MAX_NICE);
+
+	while (!kthread_should_stop()) {
+		wait_event_freezable(kprezerod_wait,
+				     prezero_needs_work() ||
+				     kthread_should_stop());
+
+		if (time_before(jiffies, READ_ONCE(prezero_backoff_until))) {
+			schedule_timeout_interruptible(HZ);
+			continue;
+		}
+
+		for_each_node_state(nid, N_MEMORY) {
+			for (idx = 0; idx < PREZERO_NR_ORDERS; idx++) {
+				struct prezero_pool *pool = &prezero_pools[nid][idx];
+
+				prezero_trim(pool, prezero_target(idx));
+				while (READ_ONCE(pool->nr) < prezero_target(idx) &&
+				       !kthread_should_stop()) {
+					if (!prezero_fill_one(nid, idx))
+						break;
+				}
+			}
+		}
+
+		/*
+		 * Don't spin on a node that has no free memory to give, and
+		 * retry less and less often while the target stays out of
+		 * reach. Changing the pool sizes starts over.
+		 */
+		if (prezero_needs_work()) {
+			wait_event_freezable_timeout(kprezerod_wait,
+						     READ_ONCE(prezero_kicked) ||
+						     kthread_should_stop(),
+						     delay);
+			delay = min_t(unsigned long, delay * 2,
+				      PREZERO_MAX_RETRY_DELAY);
+		} else {
+			delay = HZ;
+		}
+		if (xchg(&prezero_kicked, false))
+			delay = HZ;
+	}
+
+	return 0;
+}
+
+static unsigned long prezero_shrink_count(struct shrinker *shrink,
+					  struct shrink_control *sc)
+{
+	unsigned long nr = 0;
+	int idx;
+
+	for (idx = 0; idx < PREZERO_NR_ORDERS; idx++)
+		nr += READ_ONCE(prezero_pools[sc->nid][idx].nr) <<
+			prezero_order(idx);
+
+	return nr ? nr : SHRINK_EMPTY;
+}
+
+static unsigned long prezero_shrink_scan(struct shrinker *shrink,
+					 struct shrink_control *sc)
+{
+	unsigned long freed = 0;
+	int idx;
+
+	/*
+	 * Drop the whole node pool: it is cheap to refill once the pressure
+	 * is gone and keeping part of it would only delay reclaim. Large
+	 * folios go first.
+	 */
+	for (idx = PREZERO_NR_ORDERS - 1; idx >= 0; idx--) {
+		struct prezero_pool *pool = &prezero_pools[sc->nid][idx];
+
+		freed += READ_ONCE(pool->nr) << prezero_order(idx);
+		prezero_trim(pool, 0);
+	}
+	WRITE_ONCE(prezero_backoff_until, jiffies + 5 * HZ);
+
+	return freed ? freed : SHRINK_STOP;
+}
+
+static int prezero_sysctl_handler(const struct ctl_table *table, int write,
+				  void *buffer, size_t *lenp, loff_t *ppos)
+{
+	int ret = proc_douintvec_minmax(table, write, buffer, lenp, ppos);
+
+	if (!ret && write) {
+		WRITE_ONCE(prezero_kicked, true);
+		wake_up_interruptible(&kprezerod_wait);
+	}
+
+	return ret;
+}
+
+static const struct ctl_table prezero_sysctl_table[] = {
+	{
+		.procname	= "prezero_pages",
+		.data		= &prezero_pages,
+		.maxlen		= sizeof(prezero_pages),
+		.mode		= 0644,
+		.proc_handler	= prezero_sysctl_handler,
+	},
+#ifdef CONFIG_TRANSPARENT_HUGEPAGE
+	{
+		.procname	= "prezero_thp_folios",
+		.data		= &prezero_thp_folios,
+		.maxlen		= sizeof(prezero_thp_folios),
+		.mode		= 0644,
+		.proc_handler	= prezero_sysctl_handler,
+	},
+#endif
+};
+
+static int __init prezero_init(void)
+{
+	int nid, idx;
+
+	prezero_pools = kcalloc(nr_node_ids, sizeof(*prezero_pools),
+				GFP_KERNEL);
+	if (!prezero_pools)
+		return -ENOMEM;
+
+	for (nid = 0; nid < nr_node_ids; nid++) {
+		for (idx = 0; idx < PREZERO_NR_ORDERS; idx++) {
+			spin_lock_init(&prezero_pools[nid][idx].lock);
+			INIT_LIST_HEAD(&prezero_pools[nid][idx].folios);
+		}
+	}
+
+	prezero_shrinker = shrinker_alloc(SHRINKER_NUMA_AWARE, "mm-prezero");
+	if (prezero_shrinker) {
+		prezero_shrinker->count_objects = prezero_shrink_count;
+		prezero_shrinker->scan_objects = prezero_shrink_scan;
+		shrinker_register(prezero_shrinker);
+	}
+
+	kprezerod = kthread_run(kprezerod_fn, NULL, "kprezerod");
+	if (IS_ERR(kprezerod)) {
+		pr_err("prezero: failed to start kprezerod\n");
+		kprezerod = NULL;
+		return 0;
+	}
+
+	register_sysctl_init("vm", prezero_sysctl_table);
+	return 0;
+}
+subsys_initcall(prezero_init);
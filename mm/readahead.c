@@ -125,6 +125,7 @@
 #include <linux/syscalls.h>
 #include <linux/file.h>
 #include <linux/mm_inline.h>
+#include <linux/memcontrol.h>
 #include <linux/blk-cgroup.h>
 #include <linux/fadvise.h>
 #include <linux/sched/mm.h>
@@ -453,6 +454,8 @@ static inline int ra_alloc_folio(struct readahead_control *ractl, pgoff_t index,
 
 	ractl->_nr_pages += 1UL << order;
 	ractl->_workingset |= folio_test_workingset(folio);
+	count_vm_events(PGRA_SUBMIT, 1UL << order);
+	count_memcg_folio_events(folio, PGRA_SUBMIT, 1UL << order);
 	return 0;
 }
 
@@ -479,8 +482,23 @@ void page_cache_ra_order(struct readahead_control *ractl,
 
 	limit = min(limit, index + ra->size - 1);
 
-	if (new_order < mapping_max_folio_order(mapping))
-		new_order += 2;
+	switch (mem_cgroup_ra_policy()) {
+	case MEMCG_RA_RANDOM:
+		/*
+		 * Keep speculative folios small so that a large folio does
+		 * not have to be reclaimed as a whole when only a page of it
+		 * was ever read.
+		 */
+		new_order = min_order;
+		break;
+	case MEMCG_RA_STREAMING:
+		new_order = mapping_max_folio_order(mapping);
+		break;
+	default:
+		if (new_order < mapping_max_folio_order(mapping))
+			new_order += 2;
+		break;
+	}
 
 	new_order = min(mapping_max_folio_order(mapping), new_order);
 	new_order = min_t(unsigned int, new_order, ilog2(ra->size));
@@ -554,9 +572,14 @@ void page_cache_sync_ra(struct readahead_control *ractl,
 	pgoff_t index = readahead_index(ractl);
 	bool do_forced_ra = ractl->file && (ractl->file->f_mode & FMODE_RANDOM);
 	struct file_ra_state *ra = ractl->ra;
+	enum mem_cgroup_ra_policy policy;
 	unsigned long max_pages, contig_count;
 	pgoff_t prev_index, miss;
 
+	count_vm_events(PGRA_MISS, req_count);
+	if (current->mm)
+		count_memcg_events_mm(current->mm, PGRA_MISS, req_count);
+
 	/*
 	 * Even if readahead is disabled, issue this request as readahead
 	 * as we'll need it to satisfy the requested range. The forced
@@ -577,6 +600,7 @@ void page_cache_sync_ra(struct readahead_control *ractl,
 	}
 
 	max_pages = ractl_max_pages(ractl, req_count);
+	policy = mem_cgroup_ra_policy();
 	prev_index = (unsigned long long)ra->prev_pos >> PAGE_SHIFT;
 	/*
 	 * A start of file, oversized read, or sequential cache miss:
@@ -585,12 +609,24 @@ void page_cache_sync_ra(struct readahead_control *ractl,
 	 */
 	if (!index || req_count > max_pages || index - prev_index <= 1UL) {
 		ra->start = index;
-		ra->size = get_init_ra_size(req_count, max_pages);
+		if (policy == MEMCG_RA_STREAMING)
+			ra->size = max_pages;
+		else
+			ra->size = get_init_ra_size(req_count, max_pages);
 		ra->async_size = ra->size > req_count ? ra->size - req_count :
 							ra->size >> 1;
 		goto readit;
 	}
 
+	/*
+	 * The memcg asked for random-read behaviour: don't try to detect an
+	 * interleaved stream from the page cache history, read as is.
+	 */
+	if (policy == MEMCG_RA_RANDOM) {
+		do_page_cache_ra(ractl, req_count, 0);
+		return;
+	}
+
 	/*
 	 * Query the page cache and look for the traces(cached history pages)
 	 * that a sequential stream would leave behind.
@@ -654,6 +690,10 @@ void page_cache_async_ra(struct readahead_control *ractl,
 	expected = round_down(ra->start + ra->size - ra->async_size,
 			1UL << order);
 	if (index == expected) {
+		unsigned long consumed = ra->size - ra->async_size;
+
+		count_vm_events(PGRA_HIT, consumed);
+		count_memcg_folio_events(folio, PGRA_HIT, consumed);
 		ra->start += ra->size;
 		/*
 		 * In the case of MADV_HUGEPAGE, the actual size might exceed
@@ -841,6 +841,8 @@ struct folio_referenced_arg {
 	int referenced;
 	unsigned long vm_flags;
 	struct mem_cgroup *memcg;
+	/* Only test the young bits, see folio_referenced_batch() */
+	bool test_only;
 };
 
 /*
@@ -895,7 +897,12 @@ static bool folio_referenced_one(struct folio *folio,
 			return false;
 		}
 
-		if (lru_gen_enabled() && pvmw.pte) {
+		if (pra->test_only) {
+			/* A pmd mapping is left to folio_referenced() */
+			if (!pvmw.pte || pte_young(ptep_get(pvmw.pte)) ||
+			    mmu_notifier_test_young(vma->vm_mm, address))
+				referenced++;
+		} else if (lru_gen_enabled() && pvmw.pte) {
 			if (lru_gen_look_around(&pvmw))
 				referenced++;
 		} else if (pvmw.pte) {
@@ -933,7 +940,8 @@ static bool folio_referenced_one(struct folio *folio,
 
 	if (referenced)
 		folio_clear_idle(folio);
-	if (folio_test_clear_young(folio))
+	if (pra->test_only ? folio_test_young(folio) :
+			     folio_test_clear_young(folio))
 		referenced++;
 
 	if (referenced) {
@@ -1021,6 +1029,119 @@ int folio_referenced(struct folio *folio, int is_locked,
 	return rwc.contended ? -1 : pra.referenced;
 }
 
+/**
+ * folio_referenced_batch() - folio_referenced() for folios of one anon_vma
+ * @folios: The anonymous, non-KSM folios to test.
+ * @nr: Number of folios, at most FOLIO_REFERENCED_BATCH.
+ * @memcg: target memory cgroup
+ * @referenced: Returns what folio_referenced() would for the first folio,
+ *	and for the others zero if they have no young mapping.
+ * @vm_flags: Returns the vm_flags folio_referenced() would for each folio.
+ *
+ * Reclaim usually sees the folios of a heap shared by many forked processes
+ * one after the other. Rather than locking their anon_vma and walking its
+ * interval tree once per folio, lock it once and test every folio against
+ * each vma found in a single walk over the range they span.
+ *
+ * Only the first folio has its young bits cleared: reclaim may never get to
+ * the others, and clearing theirs would lose their references. The others
+ * are only tested, and those found referenced (a non-zero result) must be
+ * passed to folio_referenced() once they are actually looked at. The same
+ * goes for a folio that turns out not to belong to the anon_vma of the first
+ * one.
+ */
+void folio_referenced_batch(struct folio **folios, unsigned int nr,
+			    struct mem_cgroup *memcg, int *referenced,
+			    unsigned long *vm_flags)
+{
+	struct folio_referenced_arg pra[FOLIO_REFERENCED_BATCH];
+	struct rmap_walk_control rwc = {
+		.try_lock = true,
+	};
+	unsigned long todo = 0, alone = 0;
+	pgoff_t pgoff_start = ULONG_MAX, pgoff_end = 0;
+	struct anon_vma_chain *avc;
+	struct anon_vma *anon_vma;
+	unsigned int i, saved = 0;
+
+	VM_WARN_ON_ONCE(nr > FOLIO_REFERENCED_BATCH);
+
+	anon_vma = folio_lock_anon_vma_read(folios[0], &rwc);
+	if (!anon_vma) {
+		for (i = 0; i < nr; i++) {
+			referenced[i] = rwc.contended ? -1 : 0;
+			vm_flags[i] = 0;
+		}
+		return;
+	}
+
+	for (i = 0; i < nr; i++) {
+		struct folio *folio = folios[i];
+
+		VM_WARN_ON_ONCE_FOLIO(!folio_test_anon(folio) ||
+				      folio_test_ksm(folio), folio);
+		pra[i] = (struct folio_referenced_arg) {
+			.mapcount = folio_mapcount(folio),
+			.memcg = memcg,
+			.test_only = i > 0,
+		};
+		if (i && folio_anon_vma(folio) != anon_vma) {
+			__set_bit(i, &alone);
+			continue;
+		}
+		if (!pra[i].mapcount)
+			continue;
+
+		__set_bit(i, &todo);
+		pgoff_start = min(pgoff_start, folio_pgoff(folio));
+		pgoff_end = max(pgoff_end,
+				folio_pgoff(folio) + folio_nr_pages(folio) - 1);
+	}
+
+	if (todo)
+		anon_vma_interval_tree_foreach(avc, &anon_vma->rb_root,
+					       pgoff_start, pgoff_end) {
+			struct vm_area_struct *vma = avc->vma;
+
+			cond_resched();
+
+			if (invalid_folio_referenced_vma(vma, &pra[0]))
+				continue;
+
+			for_each_set_bit(i, &todo, nr) {
+				struct folio *folio = folios[i];
+				unsigned long address;
+
+				address = vma_address(vma, folio_pgoff(folio),
+						      folio_nr_pages(folio));
+				if (address == -EFAULT)
+					continue;
+
+				if (!folio_referenced_one(folio, vma, address,
+							  &pra[i]))
+					__clear_bit(i, &todo);
+			}
+			if (!todo)
+				break;
+		}
+
+	anon_vma_unlock_read(anon_vma);
+
+	for (i = 0; i < nr; i++) {
+		if (test_bit(i, &alone)) {
+			referenced[i] = 1;
+			vm_flags[i] = 0;
+			continue;
+		}
+		referenced[i] = pra[i].referenced;
+		vm_flags[i] = pra[i].vm_flags;
+		if (i && !referenced[i])
+			saved++;
+	}
+
+	count_vm_events(RMAP_WALKS_SAVED, saved);
+}
+
 static int page_vma_mkclean_one(struct page_vma_mapped_walk *pvmw)
 {
 	int cleaned = 0;
@@ -119,6 +119,7 @@ struct shmem_options {
 	umode_t mode;
 	bool full_inums;
 	int huge;
+	unsigned long huge_orders;
 	int seen;
 	bool noswap;
 	unsigned short quota_types;
@@ -133,6 +134,7 @@ struct shmem_options {
 #define SHMEM_SEEN_INUMS 8
 #define SHMEM_SEEN_NOSWAP 16
 #define SHMEM_SEEN_QUOTA 32
+#define SHMEM_SEEN_HUGE_ORDERS 64
 };
 
 #ifdef CONFIG_TRANSPARENT_HUGEPAGE
@@ -619,6 +621,7 @@ static unsigned int shmem_huge_global_enabled(struct inode *inode, pgoff_t index
 {
 	unsigned int maybe_pmd_order = HPAGE_PMD_ORDER > MAX_PAGECACHE_ORDER ?
 		0 : BIT(HPAGE_PMD_ORDER);
+	unsigned long huge_orders = SHMEM_SB(inode->i_sb)->huge_orders;
 	unsigned long within_size_orders;
 
 	if (!S_ISREG(inode->i_mode))
@@ -639,19 +642,28 @@ static unsigned int shmem_huge_global_enabled(struct inode *inode, pgoff_t index
 	 * Otherwise, tmpfs will allow getting a highest order hint based on
 	 * the size of write and fallocate paths, then will try each allowable
 	 * huge orders.
+	 *
+	 * The huge_orders mount option, if set, restricts all of these to the
+	 * orders it lists, so that a mount can stick to one folio size.
 	 */
+	if (!huge_orders)
+		huge_orders = ~0UL;
+	maybe_pmd_order &= huge_orders;
+
 	switch (SHMEM_SB(inode->i_sb)->huge) {
 	case SHMEM_HUGE_ALWAYS:
 		if (vma)
 			return maybe_pmd_order;
 
-		return shmem_mapping_size_orders(inode->i_mapping, index, write_end);
+		return shmem_mapping_size_orders(inode->i_mapping, index,
+						 write_end) & huge_orders;
 	case SHMEM_HUGE_WITHIN_SIZE:
 		if (vma)
 			within_size_orders = maybe_pmd_order;
 		else
 			within_size_orders = shmem_mapping_size_orders(inode->i_mapping,
-								       index, write_end);
+								       index, write_end) &
+					     huge_orders;
 
 		within_size_orders = shmem_get_orders_within_size(inode, within_size_orders,
 								  index, write_end);
@@ -1857,6 +1869,14 @@ static struct folio *shmem_alloc_folio(gfp_t gfp, int order,
 	return folio;
 }
 
+static void shmem_count_order(struct inode *inode, unsigned int order)
+{
+	struct shmem_sb_info *sbinfo = SHMEM_SB(inode->i_sb);
+
+	if (sbinfo->order_stats)
+		this_cpu_inc(sbinfo->order_stats->nr_alloc[order]);
+}
+
 static struct folio *shmem_alloc_and_add_folio(struct vm_fault *vmf,
 		gfp_t gfp, struct inode *inode, pgoff_t index,
 		struct mm_struct *fault_mm, unsigned long orders)
@@ -1950,6 +1970,7 @@ static struct folio *shmem_alloc_and_add_folio(struct vm_fault *vmf,
 
 	shmem_recalc_inode(inode, pages, 0);
 	folio_add_lru(folio);
+	shmem_count_order(inode, folio_order(folio));
 	return folio;
 
 unlock:
@@ -4477,6 +4498,7 @@ static const struct export_operations shmem_export_ops = {
 enum shmem_param {
 	Opt_gid,
 	Opt_huge,
+	Opt_huge_orders,
 	Opt_mode,
 	Opt_mpol,
 	Opt_nr_blocks,
@@ -4509,6 +4531,7 @@ static const struct constant_table shmem_param_enums_huge[] = {
 const struct fs_parameter_spec shmem_fs_parameters[] = {
 	fsparam_gid   ("gid",		Opt_gid),
 	fsparam_enum  ("huge",		Opt_huge,  shmem_param_enums_huge),
+	fsparam_string("huge_orders",	Opt_huge_orders),
 	fsparam_u32oct("mode",		Opt_mode),
 	fsparam_string("mpol",		Opt_mpol),
 	fsparam_string("nr_blocks",	Opt_nr_blocks),
@@ -4650,6 +4673,16 @@ static int shmem_parse_one(struct fs_context *fc, struct fs_parameter *param)
 			goto unsupported_parameter;
 		ctx->seen |= SHMEM_SEEN_HUGE;
 		break;
+	case Opt_huge_orders:
+		if (!(IS_ENABLED(CONFIG_TRANSPARENT_HUGEPAGE) &&
+		      has_transparent_hugepage()))
+			goto unsupported_parameter;
+		if (kstrtoul(param->string, 0, &ctx->huge_orders))
+			goto bad_value;
+		if (ctx->huge_orders & ~THP_ORDERS_ALL_FILE_DEFAULT)
+			goto bad_value;
+		ctx->seen |= SHMEM_SEEN_HUGE_ORDERS;
+		break;
 	case Opt_mpol:
 		if (IS_ENABLED(CONFIG_NUMA)) {
 			mpol_put(ctx->mpol);
@@ -4856,6 +4889,8 @@ static int shmem_reconfigure(struct fs_context *fc)
 
 	if (ctx->seen & SHMEM_SEEN_HUGE)
 		sbinfo->huge = ctx->huge;
+	if (ctx->seen & SHMEM_SEEN_HUGE_ORDERS)
+		WRITE_ONCE(sbinfo->huge_orders, ctx->huge_orders);
 	if (ctx->seen & SHMEM_SEEN_INUMS)
 		sbinfo->full_inums = ctx->full_inums;
 	if (ctx->seen & SHMEM_SEEN_BLOCKS)
@@ -4929,6 +4964,8 @@ static int shmem_show_options(struct seq_file *seq, struct dentry *root)
 	/* Rightly or wrongly, show huge mount option unmasked by shmem_huge */
 	if (sbinfo->huge)
 		seq_printf(seq, ",huge=%s", shmem_format_huge(sbinfo->huge));
+	if (sbinfo->huge_orders)
+		seq_printf(seq, ",huge_orders=0x%lx", sbinfo->huge_orders);
 #endif
 	mpol = shmem_get_sbmpol(sbinfo);
 	shmem_show_mpol(seq, mpol);
@@ -4956,6 +4993,30 @@ static int shmem_show_options(struct seq_file *seq, struct dentry *root)
 	return 0;
 }
 
+/* Folio allocations by order, for /proc/<pid>/mountstats */
+static int shmem_show_stats(struct seq_file *seq, struct dentry *root)
+{
+	struct shmem_sb_info *sbinfo = SHMEM_SB(root->d_sb);
+	unsigned long nr[NR_PAGE_ORDERS] = { };
+	int cpu, order;
+
+	if (!sbinfo->order_stats)
+		return 0;
+
+	for_each_possible_cpu(cpu) {
+		struct shmem_order_stats *stats =
+			per_cpu_ptr(sbinfo->order_stats, cpu);
+
+		for (order = 0; order < NR_PAGE_ORDERS; order++)
+			nr[order] += stats->nr_alloc[order];
+	}
+
+	seq_puts(seq, "\n\tfolio_orders:");
+	for (order = 0; order < NR_PAGE_ORDERS; order++)
+		seq_printf(seq, " %lu", nr[order]);
+	return 0;
+}
+
 #endif /* CONFIG_TMPFS */
 
 static void shmem_put_super(struct super_block *sb)
@@ -4971,6 +5032,7 @@ static void shmem_put_super(struct super_block *sb)
 	shmem_disable_quotas(sb);
 #endif
 	free_percpu(sbinfo->ino_batch);
+	free_percpu(sbinfo->order_stats);
 	percpu_counter_destroy(&sbinfo->used_blocks);
 	mpol_put(sbinfo->mpol);
 	kfree(sbinfo);
@@ -5055,7 +5117,13 @@ static int shmem_fill_super(struct super_block *sb, struct fs_context *fc)
 		sbinfo->huge = ctx->huge;
 	else
 		sbinfo->huge = tmpfs_huge;
+	sbinfo->huge_orders = ctx->huge_orders;
 #endif
+	if (!(sb->s_flags & SB_KERNMOUNT)) {
+		sbinfo->order_stats = alloc_percpu(struct shmem_order_stats);
+		if (!sbinfo->order_stats)
+			goto failed;
+	}
 	sbinfo->mpol = ctx->mpol;
 	ctx->mpol = NULL;
 
@@ -5273,6 +5341,7 @@ static const struct super_operations shmem_ops = {
 #ifdef CONFIG_TMPFS
 	.statfs		= shmem_statfs,
 	.show_options	= shmem_show_options,
+	.show_stats	= shmem_show_stats,
 #endif
 #ifdef CONFIG_TMPFS_QUOTA
 	.get_dquots	= shmem_get_dquots,
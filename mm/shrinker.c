@@ -3,6 +3,11 @@
 #include <linux/rwsem.h>
 #include <linux/shrinker.h>
 #include <linux/rculist.h>
+#include <linux/sched/clock.h>
+#include <linux/sched/mm.h>
+#include <linux/swap.h>
+#include <linux/sysctl.h>
+#include <linux/workqueue.h>
 #include <trace/events/vmscan.h>
 
 #include "internal.h"
@@ -380,6 +385,7 @@ static unsigned long do_shrink_slab(struct shrink_control *shrinkctl,
 	long batch_size = shrinker->batch ? shrinker->batch
 					  : SHRINK_BATCH;
 	long scanned = 0, next_deferred;
+	u64 start = IS_ENABLED(CONFIG_SHRINKER_DEBUG) ? local_clock() : 0;
 
 	freeable = shrinker->count_objects(shrinker, shrinkctl);
 	if (freeable == 0 || freeable == SHRINK_EMPTY)
@@ -462,6 +468,7 @@ static unsigned long do_shrink_slab(struct shrink_control *shrinkctl,
 	new_nr = add_nr_deferred(next_deferred, shrinker, shrinkctl);
 
 	trace_mm_shrink_slab_end(shrinker, shrinkctl->nid, freed, nr, new_nr, total_scan);
+	shrinker_debugfs_account(shrinker, start, scanned, freed);
 	return freed;
 }
 
@@ -675,6 +682,131 @@ unsigned long shrink_slab(gfp_t gfp_mask, int nid, struct mem_cgroup *memcg,
 	return freed;
 }
 
+/*
+ * Slab reclaim of a reclaim walk over many memcgs can be spread over
+ * vm.shrinker_parallel_workers workers. Each memcg has its own shrinker
+ * lists, so the workers don't contend on them. 0 shrinks every memcg from
+ * the reclaiming task, in turn with its LRU reclaim.
+ */
+#define SHRINKER_PARALLEL_MAX	8
+
+static unsigned int sysctl_shrinker_parallel_workers __read_mostly;
+static struct workqueue_struct *shrinker_wq;
+
+struct shrink_slab_work {
+	struct work_struct work;
+	struct shrink_slab_batch *batch;
+	unsigned long reclaimed;
+};
+
+/**
+ * shrink_slab_batch_add - queue a memcg for shrink_slab_batch_flush()
+ * @batch: the batch to add to
+ * @memcg: memory cgroup whose slab caches to target
+ *
+ * The batch is flushed when it is full. The caller has to flush it once
+ * its walk is done.
+ *
+ * Returns false if parallel slab reclaim is disabled or does not apply to
+ * @memcg, in which case the caller should shrink_slab() it directly.
+ */
+bool shrink_slab_batch_add(struct shrink_slab_batch *batch,
+			   struct mem_cgroup *memcg)
+{
+#ifdef CONFIG_MEMCG
+	if (!READ_ONCE(sysctl_shrinker_parallel_workers) || !shrinker_wq ||
+	    mem_cgroup_disabled() || mem_cgroup_is_root(memcg))
+		return false;
+
+	if (atomic_long_read(&batch->reclaimed) >= batch->nr_to_reclaim)
+		return true;
+
+	css_get(&memcg->css);
+	batch->memcgs[batch->nr++] = memcg;
+	if (batch->nr == SHRINK_SLAB_BATCH_MAX)
+		shrink_slab_batch_flush(batch);
+	return true;
+#else
+	return false;
+#endif
+}
+
+static void shrink_slab_batch_run(struct shrink_slab_batch *batch)
+{
+	struct reclaim_state *rs = current->reclaim_state;
+	int i;
+
+	while ((i = atomic_inc_return(&batch->next) - 1) < batch->nr) {
+		unsigned long before = rs ? rs->reclaimed : 0;
+
+		/* Leave the rest once the walk freed enough */
+		if (atomic_long_read(&batch->reclaimed) >= batch->nr_to_reclaim)
+			break;
+
+		shrink_slab(batch->gfp_mask, batch->nid, batch->memcgs[i],
+			    batch->priority);
+		if (rs)
+			atomic_long_add(rs->reclaimed - before,
+					&batch->reclaimed);
+	}
+}
+
+static void shrink_slab_workfn(struct work_struct *work)
+{
+	struct shrink_slab_work *ssw =
+		container_of(work, struct shrink_slab_work, work);
+	struct reclaim_state rs = {};
+	unsigned int noreclaim_flag;
+
+	/* Run the shrinkers like the reclaiming task would */
+	noreclaim_flag = memalloc_noreclaim_save();
+	current->reclaim_state = &rs;
+	shrink_slab_batch_run(ssw->batch);
+	current->reclaim_state = NULL;
+	memalloc_noreclaim_restore(noreclaim_flag);
+
+	ssw->reclaimed = rs.reclaimed;
+}
+
+/**
+ * shrink_slab_batch_flush - shrink the slab caches of a batch of memcgs
+ * @batch: the batch to shrink
+ *
+ * The reclaiming task works through the batch along with the workers, and
+ * the slab pages the workers freed are accounted to it.
+ */
+void shrink_slab_batch_flush(struct shrink_slab_batch *batch)
+{
+	struct shrink_slab_work works[SHRINKER_PARALLEL_MAX];
+	unsigned int nr_works, i;
+
+	if (!batch->nr)
+		return;
+
+	nr_works = min_t(unsigned int,
+			 READ_ONCE(sysctl_shrinker_parallel_workers),
+			 batch->nr - 1);
+	atomic_set(&batch->next, 0);
+
+	for (i = 0; i < nr_works; i++) {
+		works[i].batch = batch;
+		works[i].reclaimed = 0;
+		INIT_WORK_ONSTACK(&works[i].work, shrink_slab_workfn);
+		/* Shrink the node's objects from CPUs of that node */
+		queue_work_node(batch->nid, shrinker_wq, &works[i].work);
+	}
+	shrink_slab_batch_run(batch);
+	for (i = 0; i < nr_works; i++) {
+		flush_work(&works[i].work);
+		destroy_work_on_stack(&works[i].work);
+		mm_account_reclaimed_pages(works[i].reclaimed);
+	}
+
+	for (i = 0; i < batch->nr; i++)
+		mem_cgroup_put(batch->memcgs[i]);
+	batch->nr = 0;
+}
+
 struct shrinker *shrinker_alloc(unsigned int flags, const char *fmt, ...)
 {
 	struct shrinker *shrinker;
@@ -809,3 +941,34 @@ void shrinker_free(struct shrinker *shrinker)
 	call_rcu(&shrinker->rcu, shrinker_free_rcu_cb);
 }
 EXPORT_SYMBOL_GPL(shrinker_free);
+
+#ifdef CONFIG_SYSCTL
+static const unsigned int shrinker_parallel_max = SHRINKER_PARALLEL_MAX;
+
+static const struct ctl_table shrinker_sysctl_table[] = {
+	{
+		.procname	= "shrinker_parallel_workers",
+		.data		= &sysctl_shrinker_parallel_workers,
+		.maxlen		= sizeof(sysctl_shrinker_parallel_workers),
+		.mode		= 0644,
+		.proc_handler	= proc_douintvec_minmax,
+		.extra1		= SYSCTL_ZERO,
+		.extra2		= (void *)&shrinker_parallel_max,
+	},
+};
+#endif
+
+static int __init shrinker_parallel_init(void)
+{
+	/* Slab reclaim must make progress even if no worker can be created */
+	shrinker_wq = alloc_workqueue("shrinker", WQ_UNBOUND | WQ_MEM_RECLAIM,
+				      0);
+	if (!shrinker_wq)
+		return -ENOMEM;
+
+#ifdef CONFIG_SYSCTL
+	register_sysctl_init("vm", shrinker_sysctl_table);
+#endif
+	return 0;
+}
+subsys_initcall(shrinker_parallel_init);
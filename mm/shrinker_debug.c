@@ -5,6 +5,7 @@
 #include <linux/seq_file.h>
 #include <linux/shrinker.h>
 #include <linux/memcontrol.h>
+#include <linux/sched/clock.h>
 
 #include "internal.h"
 
@@ -95,6 +96,28 @@ static int shrinker_debugfs_count_show(struct seq_file *m, void *v)
 }
 DEFINE_SHOW_ATTRIBUTE(shrinker_debugfs_count);
 
+void shrinker_debugfs_account(struct shrinker *shrinker, u64 start,
+			      unsigned long scanned, unsigned long freed)
+{
+	atomic_long_inc(&shrinker->nr_calls);
+	atomic_long_add(scanned, &shrinker->nr_scanned);
+	atomic_long_add(freed, &shrinker->nr_freed);
+	atomic64_add(local_clock() - start, &shrinker->scan_ns);
+}
+
+static int shrinker_debugfs_stats_show(struct seq_file *m, void *v)
+{
+	struct shrinker *shrinker = m->private;
+
+	seq_printf(m, "calls %lu\n", atomic_long_read(&shrinker->nr_calls));
+	seq_printf(m, "scanned %lu\n", atomic_long_read(&shrinker->nr_scanned));
+	seq_printf(m, "freed %lu\n", atomic_long_read(&shrinker->nr_freed));
+	seq_printf(m, "scan_ns %llu\n",
+		   (unsigned long long)atomic64_read(&shrinker->scan_ns));
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(shrinker_debugfs_stats);
+
 static int shrinker_debugfs_scan_open(struct inode *inode, struct file *file)
 {
 	file->private_data = inode->i_private;
@@ -190,6 +213,8 @@ int shrinker_debugfs_add(struct shrinker *shrinker)
 			    &shrinker_debugfs_count_fops);
 	debugfs_create_file("scan", 0220, entry, shrinker,
 			    &shrinker_debugfs_scan_fops);
+	debugfs_create_file("stats", 0440, entry, shrinker,
+			    &shrinker_debugfs_stats_fops);
 	return 0;
 }
 
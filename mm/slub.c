@@ -372,6 +372,13 @@ enum stat_item {
 	CPU_PARTIAL_FREE,	/* Refill cpu partial on free */
 	CPU_PARTIAL_NODE,	/* Refill cpu partial from node partial */
 	CPU_PARTIAL_DRAIN,	/* Drain cpu partial to node partial */
+	SHEAF_ALLOC,		/* Allocation served from the cpu sheaf */
+	SHEAF_FREE,		/* Free to the cpu sheaf */
+	SHEAF_FLUSH,		/* Objects flushed from a sheaf back to slabs */
+	BARN_GET,		/* Full sheaf taken from the node barn */
+	BARN_GET_FAIL,		/* Node barn had no full sheaf */
+	BARN_PUT,		/* Full sheaf handed to the node barn */
+	BARN_PUT_FAIL,		/* Node barn was full, sheaf flushed instead */
 	NR_SLUB_STAT_ITEMS
 };
 
@@ -397,6 +404,37 @@ struct kmem_cache_cpu {
 	unsigned int stat[NR_SLUB_STAT_ITEMS];
 #endif
 };
+
+/*
+ * A sheaf is an array of free objects that may come from any slab of the
+ * cache on the node of its cpu. Caches created with a sheaf_capacity free
+ * into and allocate from a per cpu sheaf without touching slab freelists,
+ * which makes freeing an object allocated on another cpu as cheap as
+ * freeing a local one.
+ */
+struct slab_sheaf {
+	struct llist_node llnode;	/* Linkage in the node barn */
+	unsigned int size;
+	void *objects[];
+};
+
+struct slub_percpu_sheaves {
+	local_lock_t lock;		/* Protects main */
+	struct slab_sheaf *main;	/* Never NULL when sheaves are enabled */
+};
+
+/*
+ * Full sheaves are exchanged between cpus through a per node barn. Producers
+ * add to it without locking; consumers serialize on the lock, as required by
+ * llist_del_first().
+ */
+struct node_barn {
+	spinlock_t lock;
+	struct llist_head sheaves_full;
+	atomic_t nr_full;
+};
+
+#define MAX_FULL_SHEAVES	10
 #endif /* CONFIG_SLUB_TINY */
 
 static inline void stat(const struct kmem_cache *s, enum stat_item si)
@@ -430,6 +468,9 @@ struct kmem_cache_node {
 	atomic_long_t total_objects;
 	struct list_head full;
 #endif
+#ifndef CONFIG_SLUB_TINY
+	struct node_barn barn;
+#endif
 };
 
 static inline struct kmem_cache_node *get_node(struct kmem_cache *s, int node)
@@ -3274,6 +3315,279 @@ static inline void put_partials_cpu(struct kmem_cache *s,
 
 #endif	/* CONFIG_SLUB_CPU_PARTIAL */
 
+static void __kmem_cache_free_bulk(struct kmem_cache *s, size_t size, void **p);
+
+static struct slab_sheaf *alloc_empty_sheaf(struct kmem_cache *s, gfp_t gfp)
+{
+	return kzalloc(struct_size_t(struct slab_sheaf, objects,
+				     s->sheaf_capacity), gfp);
+}
+
+/*
+ * Return the objects of a sheaf to their slabs. The objects already went
+ * through the free hooks when they were put into the sheaf.
+ */
+static void sheaf_flush(struct kmem_cache *s, struct slab_sheaf *sheaf)
+{
+	if (!sheaf->size)
+		return;
+
+	stat_add(s, SHEAF_FLUSH, sheaf->size);
+	__kmem_cache_free_bulk(s, sheaf->size, &sheaf->objects[0]);
+	sheaf->size = 0;
+}
+
+static void barn_put_full(struct kmem_cache *s, struct slab_sheaf *sheaf,
+			  int node)
+{
+	struct node_barn *barn = &get_node(s, node)->barn;
+
+	if (atomic_inc_return(&barn->nr_full) <= MAX_FULL_SHEAVES) {
+		llist_add(&sheaf->llnode, &barn->sheaves_full);
+		stat(s, BARN_PUT);
+		return;
+	}
+
+	atomic_dec(&barn->nr_full);
+	stat(s, BARN_PUT_FAIL);
+	sheaf_flush(s, sheaf);
+	kfree(sheaf);
+}
+
+/* Called with the cpu sheaves lock held, hence with irqs disabled. */
+static struct slab_sheaf *barn_get_full(struct kmem_cache *s)
+{
+	struct node_barn *barn = &get_node(s, numa_mem_id())->barn;
+	struct llist_node *node;
+
+	if (!atomic_read(&barn->nr_full)) {
+		stat(s, BARN_GET_FAIL);
+		return NULL;
+	}
+
+	spin_lock(&barn->lock);
+	node = llist_del_first(&barn->sheaves_full);
+	spin_unlock(&barn->lock);
+
+	if (!node) {
+		stat(s, BARN_GET_FAIL);
+		return NULL;
+	}
+
+	atomic_dec(&barn->nr_full);
+	stat(s, BARN_GET);
+	return llist_entry(node, struct slab_sheaf, llnode);
+}
+
+static void barn_shrink(struct kmem_cache *s, struct node_barn *barn)
+{
+	struct slab_sheaf *sheaf, *next;
+	struct llist_node *list;
+	unsigned long flags;
+
+	spin_lock_irqsave(&barn->lock, flags);
+	list = llist_del_all(&barn->sheaves_full);
+	spin_unlock_irqrestore(&barn->lock, flags);
+
+	llist_for_each_entry_safe(sheaf, next, list, llnode) {
+		atomic_dec(&barn->nr_full);
+		sheaf_flush(s, sheaf);
+		kfree(sheaf);
+	}
+}
+
+/*
+ * Flush the sheaf of the local cpu, in batches so that the objects are not
+ * freed to their slabs with the sheaves lock held.
+ */
+static void pcs_flush_local(struct kmem_cache *s)
+{
+	struct slub_percpu_sheaves *pcs;
+	void *batch[16];
+	unsigned long flags;
+	unsigned int nr;
+
+	do {
+		local_lock_irqsave(&s->cpu_sheaves->lock, flags);
+		pcs = this_cpu_ptr(s->cpu_sheaves);
+		nr = min_t(unsigned int, pcs->main->size, ARRAY_SIZE(batch));
+		pcs->main->size -= nr;
+		memcpy(batch, &pcs->main->objects[pcs->main->size],
+		       nr * sizeof(void *));
+		local_unlock_irqrestore(&s->cpu_sheaves->lock, flags);
+
+		if (nr) {
+			stat_add(s, SHEAF_FLUSH, nr);
+			__kmem_cache_free_bulk(s, nr, batch);
+		}
+	} while (nr == ARRAY_SIZE(batch));
+}
+
+/* The cpu is offline, nobody else can access its sheaf. */
+static void pcs_flush_cpu(struct kmem_cache *s, int cpu)
+{
+	sheaf_flush(s, per_cpu_ptr(s->cpu_sheaves, cpu)->main);
+}
+
+/*
+ * Objects of other nodes are not taken, so that the sheaves never hand out
+ * memory of a node other than the local one. @node is the node of @object.
+ */
+static bool free_to_pcs(struct kmem_cache *s, void *object, int node)
+{
+	struct slub_percpu_sheaves *pcs;
+	struct slab_sheaf *empty, *full = NULL;
+	unsigned long flags;
+
+	local_lock_irqsave(&s->cpu_sheaves->lock, flags);
+	if (unlikely(node != numa_mem_id()))
+		goto fail;
+	pcs = this_cpu_ptr(s->cpu_sheaves);
+	if (likely(pcs->main->size < s->sheaf_capacity))
+		goto do_free;
+	local_unlock_irqrestore(&s->cpu_sheaves->lock, flags);
+
+	empty = alloc_empty_sheaf(s, GFP_NOWAIT | __GFP_NOWARN);
+	if (!empty)
+		return false;
+
+	local_lock_irqsave(&s->cpu_sheaves->lock, flags);
+	if (unlikely(node != numa_mem_id())) {
+		local_unlock_irqrestore(&s->cpu_sheaves->lock, flags);
+		kfree(empty);
+		return false;
+	}
+	pcs = this_cpu_ptr(s->cpu_sheaves);
+	/* We may have been migrated or raced with an allocation. */
+	if (pcs->main->size < s->sheaf_capacity) {
+		full = empty;
+	} else {
+		full = pcs->main;
+		pcs->main = empty;
+	}
+
+do_free:
+	pcs->main->objects[pcs->main->size++] = object;
+	local_unlock_irqrestore(&s->cpu_sheaves->lock, flags);
+
+	stat(s, SHEAF_FREE);
+
+	if (full) {
+		if (full->size)
+			barn_put_full(s, full, node);
+		else
+			kfree(full);
+	}
+	return true;
+
+fail:
+	local_unlock_irqrestore(&s->cpu_sheaves->lock, flags);
+	return false;
+}
+
+/*
+ * Free objects that went through the free hooks to the cpu sheaf, taking the
+ * sheaves lock once for as many objects as fit. All objects must be from
+ * @node. Returns the number of objects at the start of @p that were consumed.
+ */
+static size_t free_to_pcs_bulk(struct kmem_cache *s, size_t size, void **p,
+			       int node)
+{
+	struct slub_percpu_sheaves *pcs;
+	unsigned long flags;
+	unsigned int batch;
+	size_t i = 0;
+
+	local_lock_irqsave(&s->cpu_sheaves->lock, flags);
+	/* Migrated to another node since the objects were sorted */
+	if (unlikely(node != numa_mem_id())) {
+		local_unlock_irqrestore(&s->cpu_sheaves->lock, flags);
+		return 0;
+	}
+	pcs = this_cpu_ptr(s->cpu_sheaves);
+	batch = min_t(size_t, size, s->sheaf_capacity - pcs->main->size);
+	memcpy(&pcs->main->objects[pcs->main->size], p, batch * sizeof(void *));
+	pcs->main->size += batch;
+	local_unlock_irqrestore(&s->cpu_sheaves->lock, flags);
+
+	stat_add(s, SHEAF_FREE, batch);
+	i = batch;
+
+	/* The rest goes one by one, rotating in a new sheaf when needed. */
+	for (; i < size; i++) {
+		if (!free_to_pcs(s, p[i], node))
+			break;
+	}
+
+	return i;
+}
+
+static void *alloc_from_pcs(struct kmem_cache *s, int node)
+{
+	struct slub_percpu_sheaves *pcs;
+	struct slab_sheaf *empty = NULL;
+	unsigned long flags;
+	void *object;
+
+	/* Sheaves only hold local objects, leave other nodes to slabs. */
+	if (node != NUMA_NO_NODE && node != numa_mem_id())
+		return NULL;
+
+	local_lock_irqsave(&s->cpu_sheaves->lock, flags);
+	pcs = this_cpu_ptr(s->cpu_sheaves);
+	if (unlikely(!pcs->main->size)) {
+		struct slab_sheaf *full = barn_get_full(s);
+
+		if (!full) {
+			local_unlock_irqrestore(&s->cpu_sheaves->lock, flags);
+			return NULL;
+		}
+		empty = pcs->main;
+		pcs->main = full;
+	}
+	object = pcs->main->objects[--pcs->main->size];
+	local_unlock_irqrestore(&s->cpu_sheaves->lock, flags);
+
+	stat(s, SHEAF_ALLOC);
+	kfree(empty);
+
+	return object;
+}
+
+static int init_percpu_sheaves(struct kmem_cache *s)
+{
+	int cpu;
+
+	s->cpu_sheaves = alloc_percpu(struct slub_percpu_sheaves);
+	if (!s->cpu_sheaves)
+		return -ENOMEM;
+
+	for_each_possible_cpu(cpu) {
+		struct slub_percpu_sheaves *pcs = per_cpu_ptr(s->cpu_sheaves, cpu);
+
+		local_lock_init(&pcs->lock);
+		pcs->main = alloc_empty_sheaf(s, GFP_KERNEL);
+		if (!pcs->main)
+			return -ENOMEM;
+	}
+
+	return 0;
+}
+
+/* The cache is being destroyed, its sheaves have been flushed. */
+static void free_percpu_sheaves(struct kmem_cache *s)
+{
+	int cpu;
+
+	if (!s->cpu_sheaves)
+		return;
+
+	for_each_possible_cpu(cpu)
+		kfree(per_cpu_ptr(s->cpu_sheaves, cpu)->main);
+	free_percpu(s->cpu_sheaves);
+	s->cpu_sheaves = NULL;
+}
+
 static inline void flush_slab(struct kmem_cache *s, struct kmem_cache_cpu *c)
 {
 	unsigned long flags;
@@ -3337,6 +3651,9 @@ static void flush_cpu_slab(struct work_struct *w)
 	s = sfw->s;
 	c = this_cpu_ptr(s->cpu_slab);
 
+	if (s->cpu_sheaves)
+		pcs_flush_local(s);
+
 	if (c->slab)
 		flush_slab(s, c);
 
@@ -3347,6 +3664,9 @@ static bool has_cpu_slab(int cpu, struct kmem_cache *s)
 {
 	struct kmem_cache_cpu *c = per_cpu_ptr(s->cpu_slab, cpu);
 
+	if (s->cpu_sheaves && per_cpu_ptr(s->cpu_sheaves, cpu)->main->size)
+		return true;
+
 	return c->slab || slub_percpu_partial(c);
 }
 
@@ -3399,13 +3719,29 @@ static int slub_cpu_dead(unsigned int cpu)
 	struct kmem_cache *s;
 
 	mutex_lock(&slab_mutex);
-	list_for_each_entry(s, &slab_caches, list)
+	list_for_each_entry(s, &slab_caches, list) {
+		if (s->cpu_sheaves)
+			pcs_flush_cpu(s, cpu);
 		__flush_cpu_slab(s, cpu);
+	}
 	mutex_unlock(&slab_mutex);
 	return 0;
 }
 
 #else /* CONFIG_SLUB_TINY */
+static inline bool free_to_pcs(struct kmem_cache *s, void *object, int node)
+{
+	return false;
+}
+static inline size_t free_to_pcs_bulk(struct kmem_cache *s, size_t size,
+				      void **p, int node)
+{
+	return 0;
+}
+static inline void *alloc_from_pcs(struct kmem_cache *s, int node)
+{
+	return NULL;
+}
 static inline void flush_all_cpus_locked(struct kmem_cache *s) { }
 static inline void flush_all(struct kmem_cache *s) { }
 static inline void __flush_cpu_slab(struct kmem_cache *s, int cpu) { }
@@ -4185,7 +4521,11 @@ static __fastpath_inline void *slab_alloc_node(struct kmem_cache *s, struct list
 	if (unlikely(object))
 		goto out;
 
-	object = __slab_alloc_node(s, gfpflags, node, addr, orig_size);
+	if (s->sheaf_capacity)
+		object = alloc_from_pcs(s, node);
+
+	if (!object)
+		object = __slab_alloc_node(s, gfpflags, node, addr, orig_size);
 
 	maybe_wipe_obj_freeptr(s, object);
 	init = slab_want_init_on_alloc(gfpflags, s);
@@ -4643,8 +4983,14 @@ void slab_free(struct kmem_cache *s, struct slab *slab, void *object,
 	memcg_slab_free_hook(s, slab, &object, 1);
 	alloc_tagging_slab_free_hook(s, slab, &object, 1);
 
-	if (likely(slab_free_hook(s, object, slab_want_init_on_free(s), false)))
-		do_slab_free(s, slab, object, object, 1, addr);
+	if (unlikely(!slab_free_hook(s, object, slab_want_init_on_free(s), false)))
+		return;
+
+	if (s->sheaf_capacity && likely(!slab_test_pfmemalloc(slab)) &&
+	    free_to_pcs(s, object, slab_nid(slab)))
+		return;
+
+	do_slab_free(s, slab, object, object, 1, addr);
 }
 
 #ifdef CONFIG_MEMCG
@@ -5231,12 +5577,52 @@ static void __kmem_cache_free_bulk(struct kmem_cache *s, size_t size, void **p)
 	} while (likely(size));
 }
 
+/*
+ * Run the free hooks on a bulk of objects of a sheaf enabled cache and hand
+ * them to the cpu sheaf. Objects that cannot go there are freed to their
+ * slabs as usual.
+ */
+static void kmem_cache_free_bulk_sheaf(struct kmem_cache *s, size_t size,
+				       void **p)
+{
+	int node = numa_mem_id();
+	size_t i, nr = 0, done;
+
+	for (i = 0; i < size; i++) {
+		void *object = p[i];
+		struct slab *slab = virt_to_slab(object);
+
+		memcg_slab_free_hook(s, slab, &object, 1);
+		alloc_tagging_slab_free_hook(s, slab, &object, 1);
+
+		if (unlikely(!slab_free_hook(s, object,
+					     slab_want_init_on_free(s), false)))
+			continue;
+
+		if (unlikely(slab_test_pfmemalloc(slab) ||
+			     slab_nid(slab) != node)) {
+			do_slab_free(s, slab, object, object, 1, _RET_IP_);
+			continue;
+		}
+		p[nr++] = object;
+	}
+
+	done = free_to_pcs_bulk(s, nr, p, node);
+	if (done < nr)
+		__kmem_cache_free_bulk(s, nr - done, &p[done]);
+}
+
 /* Note that interrupts must be enabled when calling this function. */
 void kmem_cache_free_bulk(struct kmem_cache *s, size_t size, void **p)
 {
 	if (!size)
 		return;
 
+	if (s && s->sheaf_capacity) {
+		kmem_cache_free_bulk_sheaf(s, size, p);
+		return;
+	}
+
 	do {
 		struct detached_freelist df;
 
@@ -5524,6 +5910,11 @@ init_kmem_cache_node(struct kmem_cache_node *n)
 	atomic_long_set(&n->total_objects, 0);
 	INIT_LIST_HEAD(&n->full);
 #endif
+#ifndef CONFIG_SLUB_TINY
+	spin_lock_init(&n->barn.lock);
+	init_llist_head(&n->barn.sheaves_full);
+	atomic_set(&n->barn.nr_full, 0);
+#endif
 }
 
 #ifndef CONFIG_SLUB_TINY
@@ -5614,6 +6005,7 @@ void __kmem_cache_release(struct kmem_cache *s)
 {
 	cache_random_seq_destroy(s);
 #ifndef CONFIG_SLUB_TINY
+	free_percpu_sheaves(s);
 	free_percpu(s->cpu_slab);
 #endif
 	free_kmem_cache_nodes(s);
@@ -5895,6 +6287,10 @@ int __kmem_cache_shutdown(struct kmem_cache *s)
 	flush_all_cpus_locked(s);
 	/* Attempt to free all objects */
 	for_each_kmem_cache_node(s, node, n) {
+#ifndef CONFIG_SLUB_TINY
+		if (s->cpu_sheaves)
+			barn_shrink(s, &n->barn);
+#endif
 		free_partial(s, n);
 		if (n->nr_partial || node_nr_slabs(n))
 			return 1;
@@ -6147,6 +6543,15 @@ static int __kmem_cache_do_shrink(struct kmem_cache *s)
 int __kmem_cache_shrink(struct kmem_cache *s)
 {
 	flush_all(s);
+#ifndef CONFIG_SLUB_TINY
+	if (s->cpu_sheaves) {
+		struct kmem_cache_node *n;
+		int node;
+
+		for_each_kmem_cache_node(s, node, n)
+			barn_shrink(s, &n->barn);
+	}
+#endif
 	return __kmem_cache_do_shrink(s);
 }
 
@@ -6461,6 +6866,18 @@ int do_kmem_cache_create(struct kmem_cache *s, const char *name,
 	if (!alloc_kmem_cache_cpus(s))
 		goto out;
 
+#ifndef CONFIG_SLUB_TINY
+	/*
+	 * Sheaves bypass the per object debugging done on the slab freelists,
+	 * so they are only used for caches that do not debug.
+	 */
+	if (args->sheaf_capacity && !(s->flags & SLAB_DEBUG_FLAGS)) {
+		s->sheaf_capacity = args->sheaf_capacity;
+		if (init_percpu_sheaves(s))
+			goto out;
+	}
+#endif
+
 	err = 0;
 
 	/* Mutex is not taken during early boot */
@@ -6907,6 +7324,12 @@ static ssize_t objs_per_slab_show(struct kmem_cache *s, char *buf)
 }
 SLAB_ATTR_RO(objs_per_slab);
 
+static ssize_t sheaf_capacity_show(struct kmem_cache *s, char *buf)
+{
+	return sysfs_emit(buf, "%u\n", s->sheaf_capacity);
+}
+SLAB_ATTR_RO(sheaf_capacity);
+
 static ssize_t order_show(struct kmem_cache *s, char *buf)
 {
 	return sysfs_emit(buf, "%u\n", oo_order(s->oo));
@@ -7286,6 +7709,13 @@ STAT_ATTR(CPU_PARTIAL_ALLOC, cpu_partial_alloc);
 STAT_ATTR(CPU_PARTIAL_FREE, cpu_partial_free);
 STAT_ATTR(CPU_PARTIAL_NODE, cpu_partial_node);
 STAT_ATTR(CPU_PARTIAL_DRAIN, cpu_partial_drain);
+STAT_ATTR(SHEAF_ALLOC, sheaf_alloc);
+STAT_ATTR(SHEAF_FREE, sheaf_free);
+STAT_ATTR(SHEAF_FLUSH, sheaf_flush);
+STAT_ATTR(BARN_GET, barn_get);
+STAT_ATTR(BARN_GET_FAIL, barn_get_fail);
+STAT_ATTR(BARN_PUT, barn_put);
+STAT_ATTR(BARN_PUT_FAIL, barn_put_fail);
 #endif	/* CONFIG_SLUB_STATS */
 
 #ifdef CONFIG_KFENCE
@@ -7318,6 +7748,7 @@ static struct attribute *slab_attrs[] = {
 	&order_attr.attr,
 	&min_partial_attr.attr,
 	&cpu_partial_attr.attr,
+	&sheaf_capacity_attr.attr,
 	&objects_partial_attr.attr,
 	&partial_attr.attr,
 	&cpu_slabs_attr.attr,
@@ -7373,6 +7804,13 @@ static struct attribute *slab_attrs[] = {
 	&cpu_partial_free_attr.attr,
 	&cpu_partial_node_attr.attr,
 	&cpu_partial_drain_attr.attr,
+	&sheaf_alloc_attr.attr,
+	&sheaf_free_attr.attr,
+	&sheaf_flush_attr.attr,
+	&barn_get_attr.attr,
+	&barn_get_fail_attr.attr,
+	&barn_put_attr.attr,
+	&barn_put_fail_attr.attr,
 #endif
 #ifdef CONFIG_FAILSLAB
 	&failslab_attr.attr,
@@ -37,6 +37,7 @@
 #include <linux/page_idle.h>
 #include <linux/local_lock.h>
 #include <linux/buffer_head.h>
+#include <linux/sched/isolation.h>
 
 #include "internal.h"
 
@@ -868,6 +869,9 @@ static inline void __lru_add_drain_all(bool force_all_cpus)
 			INIT_WORK(work, lru_add_drain_per_cpu);
 			queue_work_on(cpu, mm_percpu_wq, work);
 			__cpumask_set_cpu(cpu, &has_work);
+			/* The batches can only be drained by their CPU. */
+			if (cpu_is_isolated(cpu))
+				count_vm_event(ISOLATED_LRU_DRAIN);
 		}
 	}
 
@@ -863,6 +863,15 @@ struct rb_list {
  */
 #define MAX_VA_SIZE_PAGES 256
 
+/*
+ * Medium sized VAs, up to 16M, are kept in power of two size classes
+ * placed after the fixed size pools. A class mixes sizes, so a lookup
+ * scans a few entries for an exact fit.
+ */
+#define NR_VA_MEDIUM_CLASSES 4
+#define NR_VA_POOLS (MAX_VA_SIZE_PAGES + NR_VA_MEDIUM_CLASSES)
+#define VA_MEDIUM_POOL_SCAN 8
+
 struct vmap_pool {
 	struct list_head head;
 	unsigned long len;
@@ -875,7 +884,7 @@ struct vmap_pool {
  */
 static struct vmap_node {
 	/* Simple size segregated storage. */
-	struct vmap_pool pool[MAX_VA_SIZE_PAGES];
+	struct vmap_pool pool[NR_VA_POOLS];
 	spinlock_t pool_lock;
 	bool skip_populate;
 
@@ -1845,6 +1854,28 @@ size_to_va_pool(struct vmap_node *vn, unsigned long size)
 	if (idx < MAX_VA_SIZE_PAGES)
 		return &vn->pool[idx];
 
+	idx = order_base_2(size >> PAGE_SHIFT) - ilog2(MAX_VA_SIZE_PAGES) - 1;
+	if (idx < NR_VA_MEDIUM_CLASSES)
+		return &vn->pool[MAX_VA_SIZE_PAGES + idx];
+
+	return NULL;
+}
+
+static struct vmap_area *
+va_pool_first_fit(struct vmap_pool *vp, unsigned long size,
+		unsigned long align)
+{
+	struct vmap_area *va;
+	int nr = 0;
+
+	list_for_each_entry(va, &vp->head, list) {
+		if (va_size(va) == size && IS_ALIGNED(va->va_start, align))
+			return va;
+
+		if (++nr == VA_MEDIUM_POOL_SCAN)
+			break;
+	}
+
 	return NULL;
 }
 
@@ -1880,7 +1911,13 @@ node_pool_del_va(struct vmap_node *vn, unsigned long size,
 
 	spin_lock(&vn->pool_lock);
 	if (!list_empty(&vp->head)) {
-		va = list_first_entry(&vp->head, struct vmap_area, list);
+		if (size > MAX_VA_SIZE_PAGES * PAGE_SIZE) {
+			va = va_pool_first_fit(vp, size, align);
+			if (!va)
+				goto out_unlock;
+		} else {
+			va = list_first_entry(&vp->head, struct vmap_area, list);
+		}
 
 		if (IS_ALIGNED(va->va_start, align)) {
 			/*
@@ -1902,6 +1939,7 @@ node_pool_del_va(struct vmap_node *vn, unsigned long size,
 			va = NULL;
 		}
 	}
+out_unlock:
 	spin_unlock(&vn->pool_lock);
 
 	return va;
@@ -2137,7 +2175,7 @@ decay_va_pool_node(struct vmap_node *vn, bool full_decay)
 	unsigned long n_decay;
 	int i;
 
-	for (i = 0; i < MAX_VA_SIZE_PAGES; i++) {
+	for (i = 0; i < NR_VA_POOLS; i++) {
 		LIST_HEAD(tmp_list);
 
 		if (list_empty(&vn->pool[i].head))
@@ -5129,7 +5167,7 @@ static void vmap_init_nodes(void)
 		INIT_LIST_HEAD(&vn->lazy.head);
 		spin_lock_init(&vn->lazy.lock);
 
-		for (i = 0; i < MAX_VA_SIZE_PAGES; i++) {
+		for (i = 0; i < NR_VA_POOLS; i++) {
 			INIT_LIST_HEAD(&vn->pool[i].head);
 			WRITE_ONCE(vn->pool[i].len, 0);
 		}
@@ -5148,7 +5186,7 @@ vmap_node_shrink_count(struct shrinker *shrink, struct shrink_control *sc)
 	for (count = 0, i = 0; i < nr_vmap_nodes; i++) {
 		vn = &vmap_nodes[i];
 
-		for (j = 0; j < MAX_VA_SIZE_PAGES; j++)
+		for (j = 0; j < NR_VA_POOLS; j++)
 			count += READ_ONCE(vn->pool[j].len);
 	}
 
@@ -202,6 +202,14 @@ struct scan_control {
  */
 int vm_swappiness = 60;
 
+/*
+ * Number of threads kswapd spreads shrink_folio_list() over, itself
+ * included. 1 keeps reclaim single threaded.
+ */
+#define KSWAPD_MAX_RECLAIM_WORKERS	16
+static int kswapd_reclaim_workers __read_mostly = 1;
+static struct workqueue_struct *kswapd_reclaim_wq;
+
 #ifdef CONFIG_MEMCG
 
 /* Returns true for reclaim through cgroup limits or cgroup interfaces. */
@@ -902,14 +910,80 @@ static bool lru_gen_set_refs(struct folio *folio)
 }
 #endif /* CONFIG_LRU_GEN */
 
+/*
+ * Results of folio_referenced_batch() for the folios reclaim is about to look
+ * at. The lists reclaim works on are consumed from the tail, so the batch is
+ * filled from the folio at hand and those following it at the tail.
+ */
+struct folio_ref_batch {
+	unsigned int nr;
+	unsigned int pos;
+	struct folio *folios[FOLIO_REFERENCED_BATCH];
+	int referenced[FOLIO_REFERENCED_BATCH];
+	unsigned long vm_flags[FOLIO_REFERENCED_BATCH];
+};
+
+static int folio_referenced_batched(struct folio *folio, int is_locked,
+				    struct list_head *list,
+				    struct folio_ref_batch *batch,
+				    struct mem_cgroup *memcg,
+				    unsigned long *vm_flags)
+{
+	struct folio *next;
+	unsigned int i;
+
+	for (i = batch->pos; i < batch->nr; i++) {
+		if (batch->folios[i] == folio) {
+			batch->pos = i + 1;
+			/* Only tested so far, see folio_referenced_batch() */
+			if (batch->referenced[i])
+				return folio_referenced(folio, is_locked, memcg,
+							vm_flags);
+			*vm_flags = batch->vm_flags[i];
+			return 0;
+		}
+	}
+
+	batch->nr = 0;
+	batch->pos = 0;
+	if (FOLIO_REFERENCED_BATCH == 1 || !folio_test_anon(folio) ||
+	    folio_test_ksm(folio) || !folio_mapped(folio))
+		return folio_referenced(folio, is_locked, memcg, vm_flags);
+
+	batch->folios[batch->nr++] = folio;
+	list_for_each_entry_reverse(next, list, lru) {
+		if (batch->nr == FOLIO_REFERENCED_BATCH)
+			break;
+		/* Rechecked under the anon_vma lock */
+		if (!folio_test_anon(next) || folio_test_ksm(next) ||
+		    READ_ONCE(next->mapping) != READ_ONCE(folio->mapping))
+			break;
+		batch->folios[batch->nr++] = next;
+	}
+
+	if (batch->nr == 1) {
+		batch->nr = 0;
+		return folio_referenced(folio, is_locked, memcg, vm_flags);
+	}
+
+	folio_referenced_batch(batch->folios, batch->nr, memcg,
+			       batch->referenced, batch->vm_flags);
+	batch->pos = 1;
+	*vm_flags = batch->vm_flags[0];
+	return batch->referenced[0];
+}
+
 static enum folio_references folio_check_references(struct folio *folio,
-						  struct scan_control *sc)
+						  struct scan_control *sc,
+						  struct list_head *folio_list,
+						  struct folio_ref_batch *batch)
 {
 	int referenced_ptes, referenced_folio;
 	unsigned long vm_flags;
 
-	referenced_ptes = folio_referenced(folio, 1, sc->target_mem_cgroup,
-					   &vm_flags);
+	referenced_ptes = folio_referenced_batched(folio, 1, folio_list, batch,
+						   sc->target_mem_cgroup,
+						   &vm_flags);
 
 	/*
 	 * The supposedly reclaimable folio was found to be in a VM_LOCKED vma.
@@ -1105,6 +1179,7 @@ static unsigned int shrink_folio_list(struct list_head *folio_list,
 	unsigned int pgactivate = 0;
 	bool do_demote_pass;
 	struct swap_iocb *plug = NULL;
+	struct folio_ref_batch ref_batch;
 
 	folio_batch_init(&free_folios);
 	memset(stat, 0, sizeof(*stat));
@@ -1112,6 +1187,7 @@ static unsigned int shrink_folio_list(struct list_head *folio_list,
 	do_demote_pass = can_demote(pgdat->node_id, sc);
 
 retry:
+	ref_batch.nr = 0;
 	while (!list_empty(folio_list)) {
 		struct address_space *mapping;
 		struct folio *folio;
@@ -1253,7 +1329,9 @@ static unsigned int shrink_folio_list(struct list_head *folio_list,
 		}
 
 		if (!ignore_references)
-			references = folio_check_references(folio, sc);
+			references = folio_check_references(folio, sc,
+							    folio_list,
+							    &ref_batch);
 
 		switch (references) {
 		case FOLIOREF_ACTIVATE:
@@ -1981,6 +2059,135 @@ static int current_may_throttle(void)
 	return !(current->flags & PF_LOCAL_THROTTLE);
 }
 
+struct kswapd_reclaim_batch {
+	struct work_struct work;
+	struct list_head folio_list;
+	struct pglist_data *pgdat;
+	struct scan_control sc;
+	struct reclaim_stat stat;
+	unsigned int nr_reclaimed;
+};
+
+static void kswapd_reclaim_workfn(struct work_struct *work)
+{
+	struct kswapd_reclaim_batch *batch;
+	unsigned int noreclaim_flag;
+
+	batch = container_of(work, struct kswapd_reclaim_batch, work);
+
+	/*
+	 * Reclaim on behalf of kswapd: behave like it with respect to
+	 * writeback and throttling, and never recurse into reclaim.
+	 */
+	noreclaim_flag = memalloc_noreclaim_save();
+	current->flags |= PF_KSWAPD;
+	batch->nr_reclaimed = shrink_folio_list(&batch->folio_list, batch->pgdat,
+						&batch->sc, &batch->stat, false);
+	current->flags &= ~PF_KSWAPD;
+	memalloc_noreclaim_restore(noreclaim_flag);
+}
+
+static void reclaim_stat_add(struct reclaim_stat *dst,
+			     const struct reclaim_stat *src)
+{
+	dst->nr_dirty += src->nr_dirty;
+	dst->nr_unqueued_dirty += src->nr_unqueued_dirty;
+	dst->nr_congested += src->nr_congested;
+	dst->nr_writeback += src->nr_writeback;
+	dst->nr_immediate += src->nr_immediate;
+	dst->nr_pageout += src->nr_pageout;
+	dst->nr_activate[0] += src->nr_activate[0];
+	dst->nr_activate[1] += src->nr_activate[1];
+	dst->nr_ref_keep += src->nr_ref_keep;
+	dst->nr_unmap_fail += src->nr_unmap_fail;
+	dst->nr_lazyfree_fail += src->nr_lazyfree_fail;
+	dst->nr_demoted += src->nr_demoted;
+}
+
+static int kswapd_nr_reclaim_workers(struct scan_control *sc)
+{
+	if (!current_is_kswapd() || !kswapd_reclaim_wq)
+		return 1;
+
+	return READ_ONCE(kswapd_reclaim_workers);
+}
+
+/*
+ * kswapd isolates SWAP_CLUSTER_MAX folios per worker so that every worker
+ * gets a full batch.
+ */
+static unsigned long reclaim_batch_size(struct scan_control *sc)
+{
+	return SWAP_CLUSTER_MAX * kswapd_nr_reclaim_workers(sc);
+}
+
+/*
+ * shrink_folio_list() for kswapd, fanned out to the reclaim workqueue in
+ * SWAP_CLUSTER_MAX sized chunks when kswapd_reclaim_workers is set. kswapd
+ * keeps the first chunk for itself and waits for the rest, so the caller
+ * sees the same result as from a single call.
+ */
+static unsigned int kswapd_shrink_folio_list(struct list_head *folio_list,
+		unsigned long nr_taken, struct pglist_data *pgdat,
+		struct scan_control *sc, struct reclaim_stat *stat)
+{
+	struct kswapd_reclaim_batch *batches;
+	int nr_workers = kswapd_nr_reclaim_workers(sc);
+	int nr_batches, i;
+	unsigned int nr_reclaimed;
+
+	nr_batches = min_t(unsigned long, nr_workers,
+			   DIV_ROUND_UP(nr_taken, SWAP_CLUSTER_MAX));
+	if (nr_batches <= 1)
+		goto single;
+
+	/* kswapd runs with PF_MEMALLOC, this is not expected to fail. */
+	batches = kcalloc(nr_batches - 1, sizeof(*batches),
+			  GFP_NOWAIT | __GFP_NOWARN);
+	if (!batches)
+		goto single;
+
+	for (i = 0; i < nr_batches - 1; i++) {
+		struct kswapd_reclaim_batch *batch = &batches[i];
+		unsigned long nr = 0;
+
+		INIT_LIST_HEAD(&batch->folio_list);
+		while (nr < SWAP_CLUSTER_MAX && !list_empty(folio_list)) {
+			struct folio *folio = lru_to_folio(folio_list);
+
+			list_move(&folio->lru, &batch->folio_list);
+			nr += folio_nr_pages(folio);
+		}
+		batch->pgdat = pgdat;
+		batch->sc = *sc;
+		batch->sc.nr_scanned = 0;
+		INIT_WORK(&batch->work, kswapd_reclaim_workfn);
+		queue_work_node(pgdat->node_id, kswapd_reclaim_wq, &batch->work);
+	}
+
+	nr_reclaimed = shrink_folio_list(folio_list, pgdat, sc, stat, false);
+
+	for (i = 0; i < nr_batches - 1; i++) {
+		struct kswapd_reclaim_batch *batch = &batches[i];
+
+		flush_work(&batch->work);
+		nr_reclaimed += batch->nr_reclaimed;
+		sc->nr_scanned += batch->sc.nr_scanned;
+		reclaim_stat_add(stat, &batch->stat);
+		list_splice_tail(&batch->folio_list, folio_list);
+
+		count_vm_event(KSWAPD_WORKER_BATCH);
+		count_vm_events(KSWAPD_WORKER_SCAN, batch->sc.nr_scanned);
+		count_vm_events(KSWAPD_WORKER_STEAL, batch->nr_reclaimed);
+	}
+	kfree(batches);
+
+	return nr_reclaimed;
+
+single:
+	return shrink_folio_list(folio_list, pgdat, sc, stat, false);
+}
+
 /*
  * shrink_inactive_list() is a helper for shrink_node().  It returns the number
  * of reclaimed pages
@@ -2031,7 +2238,8 @@ static unsigned long shrink_inactive_list(unsigned long nr_to_scan,
 	if (nr_taken == 0)
 		return 0;
 
-	nr_reclaimed = shrink_folio_list(&folio_list, pgdat, sc, &stat, false);
+	nr_reclaimed = kswapd_shrink_folio_list(&folio_list, nr_taken, pgdat,
+						sc, &stat);
 
 	spin_lock_irq(&lruvec->lru_lock);
 	move_folios_to_lru(lruvec, &folio_list);
@@ -2120,6 +2328,7 @@ static void shrink_active_list(unsigned long nr_to_scan,
 	unsigned nr_rotated = 0;
 	bool file = is_file_lru(lru);
 	struct pglist_data *pgdat = lruvec_pgdat(lruvec);
+	struct folio_ref_batch ref_batch = { };
 
 	lru_add_drain();
 
@@ -2157,8 +2366,9 @@ static void shrink_active_list(unsigned long nr_to_scan,
 		}
 
 		/* Referenced or rmap lock contention: rotate */
-		if (folio_referenced(folio, 0, sc->target_mem_cgroup,
-				     &vm_flags) != 0) {
+		if (folio_referenced_batched(folio, 0, &l_hold, &ref_batch,
+					     sc->target_mem_cgroup,
+					     &vm_flags) != 0) {
 			/*
 			 * Identify referenced, file-backed active folios and
 			 * give them one more trip around the active list. So
@@ -5781,7 +5991,7 @@ static void shrink_lruvec(struct lruvec *lruvec, struct scan_control *sc)
 
 		for_each_evictable_lru(lru) {
 			if (nr[lru]) {
-				nr_to_scan = min(nr[lru], SWAP_CLUSTER_MAX);
+				nr_to_scan = min(nr[lru], reclaim_batch_size(sc));
 				nr[lru] -= nr_to_scan;
 
 				nr_reclaimed += shrink_list(lru, nr_to_scan,
@@ -5933,6 +6143,7 @@ static void shrink_node_memcgs(pg_data_t *pgdat, struct scan_control *sc)
 		.pgdat = pgdat,
 	};
 	struct mem_cgroup_reclaim_cookie *partial = &reclaim;
+	struct shrink_slab_batch slab_batch;
 	struct mem_cgroup *memcg;
 
 	/*
@@ -5947,6 +6158,12 @@ static void shrink_node_memcgs(pg_data_t *pgdat, struct scan_control *sc)
 	if (current_is_kswapd() || sc->memcg_full_walk)
 		partial = NULL;
 
+	/* Partial walks can also stop shrinking slabs once the goal is met */
+	shrink_slab_batch_init(&slab_batch, sc->gfp_mask, pgdat->node_id,
+			       sc->priority,
+			       partial && sc->nr_to_reclaim > sc->nr_reclaimed ?
+			       sc->nr_to_reclaim - sc->nr_reclaimed : ULONG_MAX);
+
 	memcg = mem_cgroup_iter(target_memcg, NULL, partial);
 	do {
 		struct lruvec *lruvec = mem_cgroup_lruvec(memcg, pgdat);
@@ -5988,8 +6205,9 @@ static void shrink_node_memcgs(pg_data_t *pgdat, struct scan_control *sc)
 
 		shrink_lruvec(lruvec, sc);
 
-		shrink_slab(sc->gfp_mask, pgdat->node_id, memcg,
-			    sc->priority);
+		if (!shrink_slab_batch_add(&slab_batch, memcg))
+			shrink_slab(sc->gfp_mask, pgdat->node_id, memcg,
+				    sc->priority);
 
 		/* Record the group's reclaim efficiency */
 		if (!sc->proactive)
@@ -6003,6 +6221,8 @@ static void shrink_node_memcgs(pg_data_t *pgdat, struct scan_control *sc)
 			break;
 		}
 	} while ((memcg = mem_cgroup_iter(target_memcg, memcg, partial)));
+
+	shrink_slab_batch_flush(&slab_batch);
 }
 
 static void shrink_node(pg_data_t *pgdat, struct scan_control *sc)
@@ -7432,6 +7652,8 @@ void __meminit kswapd_stop(int nid)
 	pgdat_kswapd_unlock(pgdat);
 }
 
+static int kswapd_max_reclaim_workers = KSWAPD_MAX_RECLAIM_WORKERS;
+
 static const struct ctl_table vmscan_sysctl_table[] = {
 	{
 		.procname	= "swappiness",
@@ -7442,6 +7664,15 @@ static const struct ctl_table vmscan_sysctl_table[] = {
 		.extra1		= SYSCTL_ZERO,
 		.extra2		= SYSCTL_TWO_HUNDRED,
 	},
+	{
+		.procname	= "kswapd_reclaim_workers",
+		.data		= &kswapd_reclaim_workers,
+		.maxlen		= sizeof(kswapd_reclaim_workers),
+		.mode		= 0644,
+		.proc_handler	= proc_dointvec_minmax,
+		.extra1		= SYSCTL_ONE,
+		.extra2		= &kswapd_max_reclaim_workers,
+	},
 #ifdef CONFIG_NUMA
 	{
 		.procname	= "zone_reclaim_mode",
@@ -7459,6 +7690,9 @@ static int __init kswapd_init(void)
 	int nid;
 
 	swap_setup();
+	/* Without the workqueue kswapd just reclaims single threaded. */
+	kswapd_reclaim_wq = alloc_workqueue("kswapd_reclaim",
+					    WQ_UNBOUND | WQ_MEM_RECLAIM, 0);
 	for_each_node_state(nid, N_MEMORY)
  		kswapd_run(nid);
 	register_sysctl_init("vm", vmscan_sysctl_table);
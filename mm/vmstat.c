@@ -1303,6 +1303,8 @@ const char * const vmstat_text[] = {
 	"pgactivate",
 	"pgdeactivate",
 	"pglazyfree",
+	"pgalloc_bulk_folio",
+	"pgalloc_bulk_folio_fallback",
 
 	"pgfault",
 	"pgmajfault",
@@ -1310,6 +1312,10 @@ const char * const vmstat_text[] = {
 
 	"pgrefill",
 	"pgreuse",
+	"pgra_submit",
+	"pgra_hit",
+	"pgra_miss",
+	"pgra_wasted",
 	"pgsteal_kswapd",
 	"pgsteal_direct",
 	"pgsteal_khugepaged",
@@ -1333,12 +1339,16 @@ const char * const vmstat_text[] = {
 	"kswapd_inodesteal",
 	"kswapd_low_wmark_hit_quickly",
 	"kswapd_high_wmark_hit_quickly",
+	"kswapd_worker_batch",
+	"kswapd_worker_scan",
+	"kswapd_worker_steal",
 	"pageoutrun",
 
 	"pgrotated",
 
 	"drop_pagecache",
 	"drop_slab",
+	"rmap_walks_saved",
 	"oom_kill",
 
 #ifdef CONFIG_NUMA_BALANCING
@@ -1354,6 +1364,11 @@ const char * const vmstat_text[] = {
 	"thp_migration_success",
 	"thp_migration_fail",
 	"thp_migration_split",
+	"pgmigrate_batch_copy",
+	"pgmigrate_batch_copy_us",
+	"pgmigrate_batch_copy_ineligible",
+	"pgmigrate_batch_copy_small",
+	"pgmigrate_batch_copy_error",
 #endif
 #ifdef CONFIG_COMPACTION
 	"compact_migrate_scanned",
@@ -1419,6 +1434,8 @@ const char * const vmstat_text[] = {
 #ifdef CONFIG_DEBUG_TLBFLUSH
 	"nr_tlb_remote_flush",
 	"nr_tlb_remote_flush_received",
+	"nr_tlb_remote_flush_skipped",
+	"nr_tlb_remote_flush_broadcast",
 	"nr_tlb_local_flush_all",
 	"nr_tlb_local_flush_one",
 #endif /* CONFIG_DEBUG_TLBFLUSH */
@@ -1440,6 +1457,25 @@ const char * const vmstat_text[] = {
 	"zswpout",
 	"zswpwb",
 #endif
+#ifdef CONFIG_IO_URING
+	"pgcache_batch_hit",
+	"pgcache_batch_miss",
+#endif
+#ifdef CONFIG_MEMCG
+	"memcg_stats_flush_skipped",
+	"memcg_stats_flush_saved_us",
+	"isolated_stock_drain_skip",
+#endif
+#ifdef CONFIG_PREZERO_FOLIOS
+	"prezero_alloc",
+	"prezero_empty",
+	"prezero_fill",
+#endif
+	"isolated_vmstat_skip",
+	"isolated_lru_drain",
+	"exit_mmap",
+	"exit_mmap_unmap_us",
+	"exit_mmap_free_us",
 #ifdef CONFIG_X86
 	"direct_map_level2_splits",
 	"direct_map_level3_splits",
@@ -2114,8 +2150,11 @@ static void vmstat_shepherd(struct work_struct *w)
 		 * infrastructure ever noticing. Skip regular flushing from vmstat_shepherd
 		 * for all isolated CPUs to avoid interference with the isolated workload.
 		 */
-		if (cpu_is_isolated(cpu))
+		if (cpu_is_isolated(cpu)) {
+			if (need_update(cpu))
+				count_vm_event(ISOLATED_VMSTAT_SKIP);
 			continue;
+		}
 
 		if (!delayed_work_pending(dw) && need_update(cpu))
 			queue_delayed_work_on(cpu, mm_percpu_wq, dw, 0);
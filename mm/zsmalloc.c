@@ -49,6 +49,7 @@
 #include <linux/pagemap.h>
 #include <linux/fs.h>
 #include <linux/local_lock.h>
+#include <linux/workqueue.h>
 #include "zpdesc.h"
 
 #define ZSPAGE_MAGIC	0x58
@@ -226,8 +227,30 @@ struct zs_pool {
 	/* protect zspage migration/compaction */
 	rwlock_t lock;
 	atomic_t compaction_in_progress;
+	/* Background compaction kicked by the shrinker */
+	struct work_struct compact_work;
 };
 
+/*
+ * Back multi-page zspages with one physically contiguous allocation when
+ * possible, so objects spanning two pages can be accessed in place.
+ */
+static bool zs_contig_zspages = true;
+module_param_named(contig_zspages, zs_contig_zspages, bool, 0644);
+
+/*
+ * Let the shrinker queue compaction to a worker instead of compacting
+ * synchronously in reclaim context.
+ */
+static bool zs_async_compaction;
+module_param_named(async_compaction, zs_async_compaction, bool, 0644);
+
+/* Skip classes that would free fewer pages than this when compacted */
+static unsigned int zs_compact_min_pages = 1;
+module_param_named(compact_min_pages, zs_compact_min_pages, uint, 0644);
+
+static struct workqueue_struct *zs_compact_wq;
+
 static inline void zpdesc_set_first(struct zpdesc *zpdesc)
 {
 	SetPagePrivate(zpdesc_page(zpdesc));
@@ -1039,6 +1062,37 @@ static void create_page_chain(struct size_class *class, struct zspage *zspage,
 	}
 }
 
+/*
+ * Try to get the pages of a zspage from a single higher order allocation.
+ * The pages are split so that they remain individually movable; they stay
+ * contiguous until migration moves one of them.
+ */
+static bool alloc_contig_zpdescs(struct size_class *class, gfp_t gfp,
+				 struct zpdesc **zpdescs)
+{
+	unsigned int order = get_order(class->pages_per_zspage << PAGE_SHIFT);
+	struct page *page;
+	int i;
+
+	if (!zs_contig_zspages || class->pages_per_zspage == 1)
+		return false;
+
+	gfp = (gfp & ~(__GFP_COMP | __GFP_RECLAIM)) | __GFP_NOWARN |
+		__GFP_NORETRY;
+	page = alloc_pages(gfp, order);
+	if (!page)
+		return false;
+
+	split_page(page, order);
+	for (i = class->pages_per_zspage; i < (1 << order); i++)
+		__free_page(page + i);
+
+	for (i = 0; i < class->pages_per_zspage; i++)
+		zpdescs[i] = page_zpdesc(page + i);
+
+	return true;
+}
+
 /*
  * Allocate a zspage for the given size class
  */
@@ -1049,6 +1103,7 @@ static struct zspage *alloc_zspage(struct zs_pool *pool,
 	int i;
 	struct zpdesc *zpdescs[ZS_MAX_PAGES_PER_ZSPAGE];
 	struct zspage *zspage = cache_alloc_zspage(pool, gfp);
+	bool contig;
 
 	if (!zspage)
 		return NULL;
@@ -1058,10 +1113,12 @@ static struct zspage *alloc_zspage(struct zs_pool *pool,
 	zspage->class = class->index;
 	zspage_lock_init(zspage);
 
+	contig = alloc_contig_zpdescs(class, gfp, zpdescs);
+
 	for (i = 0; i < class->pages_per_zspage; i++) {
 		struct zpdesc *zpdesc;
 
-		zpdesc = alloc_zpdesc(gfp);
+		zpdesc = contig ? zpdescs[i] : alloc_zpdesc(gfp);
 		if (!zpdesc) {
 			while (--i >= 0) {
 				zpdesc_dec_zone_page_state(zpdescs[i]);
@@ -1145,6 +1202,24 @@ unsigned long zs_get_total_pages(struct zs_pool *pool)
 }
 EXPORT_SYMBOL_GPL(zs_get_total_pages);
 
+/*
+ * An object spanning two pages can be accessed in place if both pages are
+ * in the direct map and physically adjacent.
+ */
+static void *zs_obj_contig_addr(struct zpdesc *zpdesc, unsigned long off)
+{
+	struct zpdesc *next;
+
+	if (IS_ENABLED(CONFIG_HIGHMEM))
+		return NULL;
+
+	next = get_next_zpdesc(zpdesc);
+	if (!next || zpdesc_pfn(next) != zpdesc_pfn(zpdesc) + 1)
+		return NULL;
+
+	return page_address(zpdesc_page(zpdesc)) + off;
+}
+
 void *zs_obj_read_begin(struct zs_pool *pool, unsigned long handle,
 			void *local_copy)
 {
@@ -1172,6 +1247,8 @@ void *zs_obj_read_begin(struct zs_pool *pool, unsigned long handle,
 		/* this object is contained entirely within a page */
 		addr = kmap_local_zpdesc(zpdesc);
 		addr += off;
+	} else if ((addr = zs_obj_contig_addr(zpdesc, off))) {
+		/* this object spans two contiguous pages */
 	} else {
 		size_t sizes[2];
 
@@ -1229,6 +1306,7 @@ void zs_obj_write(struct zs_pool *pool, unsigned long handle,
 	unsigned long obj, off;
 	unsigned int obj_idx;
 	struct size_class *class;
+	void *dst;
 
 	/* Guarantee we can get zspage from handle safely */
 	read_lock(&pool->lock);
@@ -1245,12 +1323,15 @@ void zs_obj_write(struct zs_pool *pool, unsigned long handle,
 
 	if (off + class->size <= PAGE_SIZE) {
 		/* this object is contained entirely within a page */
-		void *dst = kmap_local_zpdesc(zpdesc);
+		dst = kmap_local_zpdesc(zpdesc);
 
 		if (!ZsHugePage(zspage))
 			off += ZS_HANDLE_SIZE;
 		memcpy(dst + off, handle_mem, mem_len);
 		kunmap_local(dst);
+	} else if ((dst = zs_obj_contig_addr(zpdesc, off))) {
+		/* this object spans two contiguous pages */
+		memcpy(dst + ZS_HANDLE_SIZE, handle_mem, mem_len);
 	} else {
 		/* this object spans two pages */
 		size_t sizes[2];
@@ -1996,6 +2077,8 @@ unsigned long zs_compact(struct zs_pool *pool)
 		class = pool->size_class[i];
 		if (class->index != i)
 			continue;
+		if (zs_can_compact(class) < READ_ONCE(zs_compact_min_pages))
+			continue;
 		pages_freed += __zs_compact(pool, class);
 	}
 	atomic_long_add(pages_freed, &pool->stats.pages_compacted);
@@ -2011,12 +2094,28 @@ void zs_pool_stats(struct zs_pool *pool, struct zs_pool_stats *stats)
 }
 EXPORT_SYMBOL_GPL(zs_pool_stats);
 
+static void zs_compact_workfn(struct work_struct *work)
+{
+	struct zs_pool *pool = container_of(work, struct zs_pool, compact_work);
+
+	zs_compact(pool);
+}
+
 static unsigned long zs_shrinker_scan(struct shrinker *shrinker,
 		struct shrink_control *sc)
 {
 	unsigned long pages_freed;
 	struct zs_pool *pool = shrinker->private_data;
 
+	/*
+	 * Keep the reclaiming task out of pool->lock; the pages will be
+	 * freed shortly by the worker.
+	 */
+	if (READ_ONCE(zs_async_compaction) && zs_compact_wq) {
+		queue_work(zs_compact_wq, &pool->compact_work);
+		return SHRINK_STOP;
+	}
+
 	/*
 	 * Compact classes and calculate compaction delta.
 	 * Can run concurrently with a manually triggered
@@ -2111,6 +2210,7 @@ struct zs_pool *zs_create_pool(const char *name)
 	init_deferred_free(pool);
 	rwlock_init(&pool->lock);
 	atomic_set(&pool->compaction_in_progress, 0);
+	INIT_WORK(&pool->compact_work, zs_compact_workfn);
 
 	pool->name = kstrdup(name, GFP_KERNEL);
 	if (!pool->name)
@@ -2217,6 +2317,7 @@ void zs_destroy_pool(struct zs_pool *pool)
 	int i;
 
 	zs_unregister_shrinker(pool);
+	cancel_work_sync(&pool->compact_work);
 	zs_flush_migration(pool);
 	zs_pool_stat_destroy(pool);
 
@@ -2248,6 +2349,8 @@ EXPORT_SYMBOL_GPL(zs_destroy_pool);
 
 static int __init zs_init(void)
 {
+	/* Compaction falls back to the synchronous shrinker path without it */
+	zs_compact_wq = alloc_workqueue("zs_compact", WQ_UNBOUND, 0);
 #ifdef CONFIG_ZPOOL
 	zpool_register_driver(&zs_zpool_driver);
 #endif
@@ -2261,6 +2364,8 @@ static void __exit zs_exit(void)
 	zpool_unregister_driver(&zs_zpool_driver);
 #endif
 	zs_stat_exit();
+	if (zs_compact_wq)
+		destroy_workqueue(zs_compact_wq);
 }
 
 module_init(zs_init);
@@ -35,6 +35,8 @@
 #include <linux/pagemap.h>
 #include <linux/workqueue.h>
 #include <linux/list_lru.h>
+#include <linux/blkdev.h>
+#include <linux/sort.h>
 
 #include "swap.h"
 #include "internal.h"
@@ -68,6 +70,12 @@ static u64 zswap_decompress_fail;
 static u64 zswap_reject_alloc_fail;
 /* Store failed because the entry metadata could not be allocated (rare) */
 static u64 zswap_reject_kmemcache_fail;
+/* Batches submitted by the batched shrinker writeback */
+static u64 zswap_wb_batches;
+/* Entries written back as part of a batch */
+static u64 zswap_wb_batch_entries;
+/* Compressed bytes released from the pool by batched writeback */
+static u64 zswap_wb_bytes_saved;
 
 /* Shrinker work queue */
 static struct workqueue_struct *shrink_wq;
@@ -129,6 +137,16 @@ static bool zswap_shrinker_enabled = IS_ENABLED(
 		CONFIG_ZSWAP_SHRINKER_DEFAULT_ON);
 module_param_named(shrinker_enabled, zswap_shrinker_enabled, bool, 0644);
 
+/*
+ * Number of entries the shrinker writes back at once, 0 for one at a time.
+ * Batches are picked by worst compression ratio and submitted in swap
+ * offset order under a block plug so that adjacent slots merge into
+ * larger requests.
+ */
+#define ZSWAP_WB_BATCH_MAX	256
+static unsigned int zswap_writeback_batch;
+module_param_named(writeback_batch, zswap_writeback_batch, uint, 0644);
+
 bool zswap_is_enabled(void)
 {
 	return zswap_enabled;
@@ -1251,11 +1269,139 @@ static enum lru_status shrink_memcg_cb(struct list_head *item, struct list_lru_o
 	return ret;
 }
 
+struct zswap_wb_candidate {
+	struct zswap_entry *entry;
+	swp_entry_t swpentry;
+	unsigned int length;
+};
+
+struct zswap_wb_batch {
+	unsigned int nr;
+	unsigned int max;
+	struct zswap_wb_candidate candidates[];
+};
+
+/*
+ * Collect writeback candidates instead of writing them back one by one. Like
+ * shrink_memcg_cb(), the entry is rotated and must not be dereferenced again
+ * before zswap_writeback_entry() has validated it against the tree.
+ */
+static enum lru_status shrink_memcg_batch_cb(struct list_head *item,
+		struct list_lru_one *l, void *arg)
+{
+	struct zswap_entry *entry = container_of(item, struct zswap_entry, lru);
+	struct zswap_wb_batch *batch = arg;
+	struct zswap_wb_candidate *c;
+
+	if (entry->referenced) {
+		entry->referenced = false;
+		return LRU_ROTATE;
+	}
+
+	if (batch->nr == batch->max)
+		return LRU_STOP;
+
+	c = &batch->candidates[batch->nr++];
+	c->entry = entry;
+	c->swpentry = entry->swpentry;
+	c->length = entry->length;
+
+	return LRU_ROTATE;
+}
+
+/* Worst compression ratio, i.e. most pool space released, first */
+static int zswap_wb_cmp_length(const void *a, const void *b)
+{
+	const struct zswap_wb_candidate *ca = a, *cb = b;
+
+	return cmp_int(cb->length, ca->length);
+}
+
+static int zswap_wb_cmp_slot(const void *a, const void *b)
+{
+	const struct zswap_wb_candidate *ca = a, *cb = b;
+
+	return cmp_int(ca->swpentry.val, cb->swpentry.val);
+}
+
+static unsigned long zswap_writeback_batch_submit(struct zswap_wb_batch *batch,
+		unsigned int batch_size, bool *encountered_page_in_swapcache)
+{
+	unsigned long written = 0, bytes = 0;
+	struct blk_plug plug;
+	unsigned int i;
+	int ret;
+
+	if (batch->nr > batch_size) {
+		sort(batch->candidates, batch->nr, sizeof(batch->candidates[0]),
+		     zswap_wb_cmp_length, NULL);
+		batch->nr = batch_size;
+	}
+	sort(batch->candidates, batch->nr, sizeof(batch->candidates[0]),
+	     zswap_wb_cmp_slot, NULL);
+
+	blk_start_plug(&plug);
+	for (i = 0; i < batch->nr; i++) {
+		struct zswap_wb_candidate *c = &batch->candidates[i];
+
+		/* c->entry is only valid until it is written back */
+		ret = zswap_writeback_entry(c->entry, c->swpentry);
+		if (ret) {
+			zswap_reject_reclaim_fail++;
+			if (ret == -EEXIST)
+				*encountered_page_in_swapcache = true;
+			continue;
+		}
+		zswap_written_back_pages++;
+		written++;
+		bytes += c->length;
+	}
+	blk_finish_plug(&plug);
+
+	if (written) {
+		zswap_wb_batches++;
+		zswap_wb_batch_entries += written;
+		zswap_wb_bytes_saved += bytes;
+	}
+
+	return written;
+}
+
+static unsigned long zswap_shrinker_scan_batch(struct shrink_control *sc,
+		unsigned int batch_size)
+{
+	struct zswap_wb_batch *batch;
+	bool encountered_page_in_swapcache = false;
+	unsigned long written;
+
+	/*
+	 * Look at twice as many candidates as we write back so that the
+	 * compression ratio has something to choose from.
+	 */
+	batch = kmalloc(struct_size(batch, candidates, 2 * batch_size),
+			GFP_NOWAIT | __GFP_NOWARN);
+	if (!batch)
+		return 0;
+	batch->nr = 0;
+	batch->max = 2 * batch_size;
+
+	list_lru_shrink_walk(&zswap_list_lru, sc, &shrink_memcg_batch_cb, batch);
+	written = zswap_writeback_batch_submit(batch, batch_size,
+					       &encountered_page_in_swapcache);
+	kfree(batch);
+
+	if (encountered_page_in_swapcache)
+		return SHRINK_STOP;
+
+	return written ? written : SHRINK_STOP;
+}
+
 static unsigned long zswap_shrinker_scan(struct shrinker *shrinker,
 		struct shrink_control *sc)
 {
 	unsigned long shrink_ret;
 	bool encountered_page_in_swapcache = false;
+	unsigned int batch_size;
 
 	if (!zswap_shrinker_enabled ||
 			!mem_cgroup_zswap_writeback_enabled(sc->memcg)) {
@@ -1263,6 +1409,15 @@ static unsigned long zswap_shrinker_scan(struct shrinker *shrinker,
 		return SHRINK_STOP;
 	}
 
+	batch_size = min_t(unsigned int, READ_ONCE(zswap_writeback_batch),
+			   ZSWAP_WB_BATCH_MAX);
+	if (batch_size > 1) {
+		shrink_ret = zswap_shrinker_scan_batch(sc, batch_size);
+		if (shrink_ret)
+			return shrink_ret;
+		/* Could not allocate the batch, fall back to one by one */
+	}
+
 	shrink_ret = list_lru_shrink_walk(&zswap_list_lru, sc, &shrink_memcg_cb,
 		&encountered_page_in_swapcache);
 
@@ -1302,7 +1457,7 @@ static unsigned long zswap_shrinker_count(struct shrinker *shrinker,
 	 * Without memcg, use the zswap pool-wide metrics.
 	 */
 	if (!mem_cgroup_disabled()) {
-		mem_cgroup_flush_stats(memcg);
+		mem_cgroup_flush_stats_max_age(memcg, HZ);
 		nr_backing = memcg_page_state(memcg, MEMCG_ZSWAP_B) >> PAGE_SHIFT;
 		nr_stored = memcg_page_state(memcg, MEMCG_ZSWAPPED);
 	} else {
@@ -1816,6 +1971,12 @@ static int zswap_debugfs_init(void)
 			   zswap_debugfs_root, &zswap_reject_compress_poor);
 	debugfs_create_u64("decompress_fail", 0444,
 			   zswap_debugfs_root, &zswap_decompress_fail);
+	debugfs_create_u64("writeback_batches", 0444,
+			   zswap_debugfs_root, &zswap_wb_batches);
+	debugfs_create_u64("writeback_batch_entries", 0444,
+			   zswap_debugfs_root, &zswap_wb_batch_entries);
+	debugfs_create_u64("writeback_bytes_saved", 0444,
+			   zswap_debugfs_root, &zswap_wb_bytes_saved);
 	debugfs_create_u64("written_back_pages", 0444,
 			   zswap_debugfs_root, &zswap_written_back_pages);
 	debugfs_create_file("pool_total_size", 0444,
@@ -880,6 +880,31 @@ static bool __fdb_mark_active(struct net_bridge_fdb_entry *fdb)
 		  test_and_clear_bit(BR_FDB_NOTIFY_INACTIVE, &fdb->flags));
 }
 
+/* Dynamic learning on @p is limited to learn_rate new or moved entries per
+ * second, so a storm of new source addresses can't monopolize hash_lock and
+ * the notification path.
+ */
+static bool br_fdb_learn_limited(struct net_bridge_port *p,
+				 unsigned long flags)
+{
+	u32 rate = READ_ONCE(p->learn_rate);
+	unsigned long now;
+
+	if (likely(!rate) || test_bit(BR_FDB_ADDED_BY_USER, &flags))
+		return false;
+
+	now = jiffies;
+	if (time_after_eq(now, READ_ONCE(p->learn_window) + HZ)) {
+		WRITE_ONCE(p->learn_window, now);
+		atomic_set(&p->learn_count, 0);
+	}
+	if (atomic_inc_return(&p->learn_count) <= rate)
+		return false;
+
+	atomic_long_inc(&p->learn_dropped);
+	return true;
+}
+
 void br_fdb_update(struct net_bridge *br, struct net_bridge_port *source,
 		   const unsigned char *addr, u16 vid, unsigned long flags)
 {
@@ -907,7 +932,8 @@ void br_fdb_update(struct net_bridge *br, struct net_bridge_port *source,
 
 			/* fastpath: update of existing entry */
 			if (unlikely(source != READ_ONCE(fdb->dst) &&
-				     !test_bit(BR_FDB_STICKY, &fdb->flags))) {
+				     !test_bit(BR_FDB_STICKY, &fdb->flags) &&
+				     !br_fdb_learn_limited(source, flags))) {
 				br_switchdev_fdb_notify(br, fdb, RTM_DELNEIGH);
 				WRITE_ONCE(fdb->dst, source);
 				fdb_modified = true;
@@ -934,7 +960,7 @@ void br_fdb_update(struct net_bridge *br, struct net_bridge_port *source,
 				fdb_notify(br, fdb, RTM_NEWNEIGH, true);
 			}
 		}
-	} else {
+	} else if (!br_fdb_learn_limited(source, flags)) {
 		spin_lock(&br->hash_lock);
 		fdb = fdb_create(br, source, addr, vid, flags);
 		if (fdb) {
@@ -212,6 +212,8 @@ static inline size_t br_port_info_size(void)
 		+ nla_total_size(sizeof(u32))	/* IFLA_BRPORT_MCAST_EHT_HOSTS_LIMIT */
 		+ nla_total_size(sizeof(u32))	/* IFLA_BRPORT_MCAST_EHT_HOSTS_CNT */
 		+ nla_total_size(sizeof(u32))	/* IFLA_BRPORT_BACKUP_NHID */
+		+ nla_total_size(sizeof(u32))	/* IFLA_BRPORT_LEARNING_RATE */
+		+ nla_total_size_64bit(sizeof(u64)) /* IFLA_BRPORT_LEARNING_DROPS */
 		+ 0;
 }
 
@@ -324,6 +326,13 @@ static int br_port_fill_attrs(struct sk_buff *skb,
 	    nla_put_u32(skb, IFLA_BRPORT_BACKUP_NHID, p->backup_nhid))
 		return -EMSGSIZE;
 
+	if (nla_put_u32(skb, IFLA_BRPORT_LEARNING_RATE,
+			READ_ONCE(p->learn_rate)) ||
+	    nla_put_u64_64bit(skb, IFLA_BRPORT_LEARNING_DROPS,
+			      atomic_long_read(&p->learn_dropped),
+			      IFLA_BRPORT_PAD))
+		return -EMSGSIZE;
+
 	return 0;
 }
 
@@ -902,6 +911,8 @@ static const struct nla_policy br_port_policy[IFLA_BRPORT_MAX + 1] = {
 	[IFLA_BRPORT_MCAST_MAX_GROUPS] = { .type = NLA_U32 },
 	[IFLA_BRPORT_NEIGH_VLAN_SUPPRESS] = NLA_POLICY_MAX(NLA_U8, 1),
 	[IFLA_BRPORT_BACKUP_NHID] = { .type = NLA_U32 },
+	[IFLA_BRPORT_LEARNING_RATE] = { .type = NLA_U32 },
+	[IFLA_BRPORT_LEARNING_DROPS] = { .type = NLA_REJECT },
 };
 
 /* Change the state of the port and notify spanning tree */
@@ -1078,6 +1089,10 @@ static int br_setport(struct net_bridge_port *p, struct nlattr *tb[],
 		WRITE_ONCE(p->backup_nhid, backup_nhid);
 	}
 
+	if (tb[IFLA_BRPORT_LEARNING_RATE])
+		WRITE_ONCE(p->learn_rate,
+			   nla_get_u32(tb[IFLA_BRPORT_LEARNING_RATE]));
+
 	return 0;
 }
 
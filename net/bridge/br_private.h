@@ -392,6 +392,12 @@ struct net_bridge_port {
 	struct net_bridge_port		__rcu *backup_port;
 	u32				backup_nhid;
 
+	/* dynamic learning rate limit, see br_fdb_learn_limited() */
+	u32				learn_rate;
+	atomic_t			learn_count;
+	unsigned long			learn_window;
+	atomic_long_t			learn_dropped;
+
 	/* STP */
 	u8				priority;
 	u8				state;
@@ -77,6 +77,7 @@
 #include <linux/hash.h>
 #include <linux/slab.h>
 #include <linux/sched.h>
+#include <linux/sched/clock.h>
 #include <linux/sched/isolation.h>
 #include <linux/sched/mm.h>
 #include <linux/smpboot.h>
@@ -4793,6 +4794,8 @@ set_rps_cpu(struct net_device *dev, struct sk_buff *skb,
 		old_rflow = rflow;
 		rflow = &flow_table->flows[flow_id];
 		WRITE_ONCE(rflow->filter, rc);
+		WRITE_ONCE(rxqueue->rfs_filter_updates,
+			   rxqueue->rfs_filter_updates + 1);
 		if (old_rflow->filter == rc)
 			WRITE_ONCE(old_rflow->filter, RPS_NO_FILTER);
 	out:
@@ -4848,6 +4851,7 @@ static int get_rps_cpu(struct net_device *dev, struct sk_buff *skb,
 
 	sock_flow_table = rcu_dereference(net_hotdata.rps_sock_flow_table);
 	if (flow_table && sock_flow_table) {
+		const u32 *bucket = rps_sock_flow_bucket(sock_flow_table, hash);
 		struct rps_dev_flow *rflow;
 		u32 next_cpu;
 		u32 ident;
@@ -4855,9 +4859,17 @@ static int get_rps_cpu(struct net_device *dev, struct sk_buff *skb,
 		/* First check into global flow table if there is a match.
 		 * This READ_ONCE() pairs with WRITE_ONCE() from rps_record_sock_flow().
 		 */
-		ident = READ_ONCE(sock_flow_table->ents[hash & sock_flow_table->mask]);
-		if ((ident ^ hash) & ~net_hotdata.rps_cpu_mask)
-			goto try_rps;
+		ident = READ_ONCE(bucket[0]);
+		if (!rps_sock_flow_match(ident, hash)) {
+			ident = READ_ONCE(bucket[1]);
+			if (!rps_sock_flow_match(ident, hash)) {
+				/* Bucket taken by other flows */
+				if (ident != RPS_NO_CPU)
+					WRITE_ONCE(rxqueue->rfs_collisions,
+						   rxqueue->rfs_collisions + 1);
+				goto try_rps;
+			}
+		}
 
 		next_cpu = ident & net_hotdata.rps_cpu_mask;
 
@@ -4884,6 +4896,8 @@ static int get_rps_cpu(struct net_device *dev, struct sk_buff *skb,
 		      rflow->last_qtail)) >= 0)) {
 			tcpu = next_cpu;
 			rflow = set_rps_cpu(dev, skb, rflow, next_cpu);
+			WRITE_ONCE(rxqueue->rfs_steer_changes,
+				   rxqueue->rfs_steer_changes + 1);
 		}
 
 		if (tcpu < nr_cpu_ids && cpu_online(tcpu)) {
@@ -6461,6 +6475,88 @@ void __napi_schedule_irqoff(struct napi_struct *n)
 }
 EXPORT_SYMBOL(__napi_schedule_irqoff);
 
+/* Adaptive deferral: fixed point load, and the bounds used when the NAPI
+ * has no defer_hard_irqs / gro_flush_timeout configured to cap them.
+ */
+#define NAPI_ADAPT_SCALE	256
+#define NAPI_ADAPT_SHIFT	3
+#define NAPI_ADAPT_MAX_DEFER	8
+#define NAPI_ADAPT_MAX_TIMEOUT	(100 * NSEC_PER_USEC)
+/* Busy polls further apart than this don't count as an active poller */
+#define NAPI_ADAPT_BP_WINDOW	(10 * NSEC_PER_MSEC)
+
+/*
+ * Pick defer_hard_irqs and gro_flush_timeout from the share of the budget
+ * recent polls used: interrupts are cheap at low load, so keep them on for
+ * latency, and defer them more the busier the queue gets. An application
+ * busy polling the NAPI gets its interrupts held off for a bit longer than
+ * the gap between its polls, so they don't fire in between.
+ *
+ * Must be called by the NAPI owner, i.e. with NAPI_STATE_SCHED held.
+ */
+static void napi_adapt(struct napi_struct *n, int work)
+{
+	unsigned long max_timeout, timeout = 0;
+	u32 load, max_defer, defer = 0;
+
+	if (!napi_get_adaptive(n) || unlikely(n->weight <= 0))
+		return;
+
+	load = n->adapt_load;
+	load = load - (load >> NAPI_ADAPT_SHIFT) +
+	       ((u32)min(work, n->weight) * NAPI_ADAPT_SCALE / n->weight >>
+		NAPI_ADAPT_SHIFT);
+	WRITE_ONCE(n->adapt_load, load);
+
+	max_defer = napi_get_defer_hard_irqs(n) ?: NAPI_ADAPT_MAX_DEFER;
+	max_timeout = napi_get_gro_flush_timeout(n) ?: NAPI_ADAPT_MAX_TIMEOUT;
+
+	if (load >= NAPI_ADAPT_SCALE / 4) {
+		defer = DIV_ROUND_UP(max_defer * load, NAPI_ADAPT_SCALE);
+		timeout = max_timeout * load / NAPI_ADAPT_SCALE;
+	}
+
+	if (n->adapt_bp_gap &&
+	    local_clock() - n->adapt_bp_last < NAPI_ADAPT_BP_WINDOW) {
+		defer = max(defer, 1U);
+		timeout = max(timeout, min(2UL * n->adapt_bp_gap, max_timeout));
+	}
+
+	WRITE_ONCE(n->adapt_defer, defer);
+	WRITE_ONCE(n->adapt_timeout, min_t(unsigned long, timeout, U32_MAX));
+}
+
+/* Track how far apart an application's busy polls of this NAPI are */
+static void napi_adapt_busy_poll(struct napi_struct *n)
+{
+	u64 now = local_clock();
+	u64 gap = now - n->adapt_bp_last;
+
+	n->adapt_bp_last = now;
+	if (gap >= NAPI_ADAPT_BP_WINDOW)
+		n->adapt_bp_gap = 0;
+	else if (!n->adapt_bp_gap)
+		n->adapt_bp_gap = gap;
+	else
+		n->adapt_bp_gap = n->adapt_bp_gap -
+				  (n->adapt_bp_gap >> NAPI_ADAPT_SHIFT) +
+				  (gap >> NAPI_ADAPT_SHIFT);
+}
+
+static u32 napi_defer_hard_irqs_eff(const struct napi_struct *n)
+{
+	if (napi_get_adaptive(n))
+		return READ_ONCE(n->adapt_defer);
+	return napi_get_defer_hard_irqs(n);
+}
+
+static unsigned long napi_gro_flush_timeout_eff(const struct napi_struct *n)
+{
+	if (napi_get_adaptive(n))
+		return READ_ONCE(n->adapt_timeout);
+	return napi_get_gro_flush_timeout(n);
+}
+
 bool napi_complete_done(struct napi_struct *n, int work_done)
 {
 	unsigned long flags, val, new, timeout = 0;
@@ -6476,14 +6572,16 @@ bool napi_complete_done(struct napi_struct *n, int work_done)
 				 NAPIF_STATE_IN_BUSY_POLL)))
 		return false;
 
+	napi_adapt(n, work_done);
+
 	if (work_done) {
 		if (n->gro.bitmask)
-			timeout = napi_get_gro_flush_timeout(n);
-		n->defer_hard_irqs_count = napi_get_defer_hard_irqs(n);
+			timeout = napi_gro_flush_timeout_eff(n);
+		n->defer_hard_irqs_count = napi_defer_hard_irqs_eff(n);
 	}
 	if (n->defer_hard_irqs_count > 0) {
 		n->defer_hard_irqs_count--;
-		timeout = napi_get_gro_flush_timeout(n);
+		timeout = napi_gro_flush_timeout_eff(n);
 		if (timeout)
 			ret = false;
 	}
@@ -6598,9 +6696,12 @@ static void busy_poll_stop(struct napi_struct *napi, void *have_poll_lock,
 	local_bh_disable();
 	bpf_net_ctx = bpf_net_ctx_set(&__bpf_net_ctx);
 
+	if (napi_get_adaptive(napi))
+		napi_adapt_busy_poll(napi);
+
 	if (flags & NAPI_F_PREFER_BUSY_POLL) {
-		napi->defer_hard_irqs_count = napi_get_defer_hard_irqs(napi);
-		timeout = napi_get_gro_flush_timeout(napi);
+		napi->defer_hard_irqs_count = napi_defer_hard_irqs_eff(napi);
+		timeout = napi_gro_flush_timeout_eff(napi);
 		if (napi->defer_hard_irqs_count && timeout) {
 			hrtimer_start(&napi->timer, ns_to_ktime(timeout), HRTIMER_MODE_REL_PINNED);
 			skip_schedule = true;
@@ -7085,6 +7186,7 @@ static void napi_restore_config(struct napi_struct *n)
 	n->defer_hard_irqs = n->config->defer_hard_irqs;
 	n->gro_flush_timeout = n->config->gro_flush_timeout;
 	n->irq_suspend_timeout = n->config->irq_suspend_timeout;
+	napi_set_adaptive(n, n->config->adaptive);
 
 	if (n->dev->irq_affinity_auto &&
 	    test_bit(NAPI_STATE_HAS_NOTIFIER, &n->state))
@@ -7106,6 +7208,7 @@ static void napi_save_config(struct napi_struct *n)
 	n->config->defer_hard_irqs = n->defer_hard_irqs;
 	n->config->gro_flush_timeout = n->gro_flush_timeout;
 	n->config->irq_suspend_timeout = n->irq_suspend_timeout;
+	n->config->adaptive = n->adaptive;
 	napi_hash_del(n);
 }
 
@@ -7341,6 +7444,9 @@ static int __napi_poll(struct napi_struct *n, bool *repoll)
 	if (likely(work < weight))
 		return work;
 
+	/* A full budget poll never reaches napi_complete_done() */
+	napi_adapt(n, work);
+
 	/* Drivers must not modify the NAPI state if they
 	 * consume the entire weight.  In such cases this code
 	 * still "owns" the NAPI instance and therefore can
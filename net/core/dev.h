@@ -228,6 +228,33 @@ static inline void netdev_set_defer_hard_irqs(struct net_device *netdev,
 		netdev->napi_config[i].defer_hard_irqs = defer;
 }
 
+/**
+ * napi_get_adaptive - get whether a napi adapts its interrupt deferral
+ * @n: napi struct to get the adaptive field from
+ *
+ * Return: true if the NAPI picks its own defer_hard_irqs and
+ * gro_flush_timeout, using the configured ones as upper bounds.
+ */
+static inline bool napi_get_adaptive(const struct napi_struct *n)
+{
+	return READ_ONCE(n->adaptive);
+}
+
+/**
+ * napi_set_adaptive - enable or disable adaptive deferral for a napi
+ * @n: napi_struct to set the adaptive field
+ * @adaptive: the value the field should be set to
+ */
+static inline void napi_set_adaptive(struct napi_struct *n, bool adaptive)
+{
+	if (adaptive && !n->adaptive) {
+		WRITE_ONCE(n->adapt_load, 0);
+		WRITE_ONCE(n->adapt_defer, 0);
+		WRITE_ONCE(n->adapt_timeout, 0);
+	}
+	WRITE_ONCE(n->adaptive, adaptive);
+}
+
 /**
  * napi_get_gro_flush_timeout - get the gro_flush_timeout
  * @n: napi struct to get the gro_flush_timeout from
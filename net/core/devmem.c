@@ -165,6 +165,77 @@ int net_devmem_bind_dmabuf_to_queue(struct net_device *dev, u32 rxq_idx,
 	return err;
 }
 
+/* Return the dmabuf binding @rxq_idx is currently bound to, if any. */
+struct net_devmem_dmabuf_binding *
+net_devmem_rxq_binding(struct net_device *dev, u32 rxq_idx)
+{
+	struct netdev_rx_queue *rxq;
+
+	if (rxq_idx >= dev->real_num_rx_queues)
+		return NULL;
+
+	rxq = __netif_get_rx_queue(dev, rxq_idx);
+	if (rxq->mp_params.mp_ops != &dmabuf_devmem_ops)
+		return NULL;
+
+	return rxq->mp_params.mp_priv;
+}
+
+static void net_devmem_unlink_rxq(struct net_devmem_dmabuf_binding *binding,
+				  struct netdev_rx_queue *rxq)
+{
+	struct netdev_rx_queue *bound_rxq;
+	unsigned long xa_idx;
+
+	xa_for_each(&binding->bound_rxqs, xa_idx, bound_rxq) {
+		if (bound_rxq == rxq) {
+			xa_erase(&binding->bound_rxqs, xa_idx);
+			break;
+		}
+	}
+}
+
+/* Move @rxq_idx from @old to @binding with a single queue restart, rather
+ * than tearing the queue down to no provider and bringing it back up. RX
+ * keeps flowing into @old until the new page pool takes over; buffers
+ * already handed to userspace from @old stay valid until they are returned.
+ */
+int net_devmem_rebind_dmabuf_queue(struct net_device *dev, u32 rxq_idx,
+				   struct net_devmem_dmabuf_binding *old,
+				   struct net_devmem_dmabuf_binding *binding,
+				   struct netlink_ext_ack *extack)
+{
+	struct pp_memory_provider_params old_params = {
+		.mp_priv	= old,
+		.mp_ops		= &dmabuf_devmem_ops,
+	};
+	struct pp_memory_provider_params mp_params = {
+		.mp_priv	= binding,
+		.mp_ops		= &dmabuf_devmem_ops,
+	};
+	struct netdev_rx_queue *rxq;
+	u32 xa_idx;
+	int err;
+
+	if (old->dev != dev || binding->dev != dev)
+		return -EINVAL;
+
+	rxq = __netif_get_rx_queue(dev, rxq_idx);
+	err = xa_alloc(&binding->bound_rxqs, &xa_idx, rxq, xa_limit_32b,
+		       GFP_KERNEL);
+	if (err)
+		return err;
+
+	err = __net_mp_swap_rxq(dev, rxq_idx, &old_params, &mp_params, extack);
+	if (err) {
+		xa_erase(&binding->bound_rxqs, xa_idx);
+		return err;
+	}
+
+	net_devmem_unlink_rxq(old, rxq);
+	return 0;
+}
+
 struct net_devmem_dmabuf_binding *
 net_devmem_bind_dmabuf(struct net_device *dev, unsigned int dmabuf_fd,
 		       struct netlink_ext_ack *extack)
@@ -366,22 +437,30 @@ static int mp_dmabuf_devmem_nl_fill(void *mp_priv, struct sk_buff *rsp,
 	const struct net_devmem_dmabuf_binding *binding = mp_priv;
 	int type = rxq ? NETDEV_A_QUEUE_DMABUF : NETDEV_A_PAGE_POOL_DMABUF;
 
-	return nla_put_u32(rsp, type, binding->id);
+	if (nla_put_u32(rsp, type, binding->id))
+		return -EMSGSIZE;
+
+	if (!rxq)
+		return 0;
+
+	if (nla_put_uint(rsp, NETDEV_A_QUEUE_DMABUF_BOUND_BYTES,
+			 binding->dmabuf->size) ||
+	    nla_put_uint(rsp, NETDEV_A_QUEUE_DMABUF_INUSE_BYTES,
+			 gen_pool_size(binding->chunk_pool) -
+			 gen_pool_avail(binding->chunk_pool)) ||
+	    nla_put_uint(rsp, NETDEV_A_QUEUE_DMABUF_TOKENS,
+			 atomic_long_read(&binding->tokens)) ||
+	    nla_put_uint(rsp, NETDEV_A_QUEUE_DMABUF_COPIED_BYTES,
+			 atomic_long_read(&binding->copied_bytes)))
+		return -EMSGSIZE;
+
+	return 0;
 }
 
 static void mp_dmabuf_devmem_uninstall(void *mp_priv,
 				       struct netdev_rx_queue *rxq)
 {
-	struct net_devmem_dmabuf_binding *binding = mp_priv;
-	struct netdev_rx_queue *bound_rxq;
-	unsigned long xa_idx;
-
-	xa_for_each(&binding->bound_rxqs, xa_idx, bound_rxq) {
-		if (bound_rxq == rxq) {
-			xa_erase(&binding->bound_rxqs, xa_idx);
-			break;
-		}
-	}
+	net_devmem_unlink_rxq(mp_priv, rxq);
 }
 
 static const struct memory_provider_ops dmabuf_devmem_ops = {
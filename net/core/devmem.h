@@ -44,6 +44,15 @@ struct net_devmem_dmabuf_binding {
 	 * active.
 	 */
 	u32 id;
+
+	/* Frags handed to userspace as tokens and not yet returned via
+	 * SO_DEVMEM_DONTNEED.
+	 */
+	atomic_long_t tokens;
+	/* Payload of devmem skbs that had to be copied to the user buffer
+	 * (SO_DEVMEM_LINEAR) rather than handed out as a token.
+	 */
+	atomic_long_t copied_bytes;
 };
 
 #if defined(CONFIG_NET_DEVMEM)
@@ -68,6 +77,12 @@ void net_devmem_unbind_dmabuf(struct net_devmem_dmabuf_binding *binding);
 int net_devmem_bind_dmabuf_to_queue(struct net_device *dev, u32 rxq_idx,
 				    struct net_devmem_dmabuf_binding *binding,
 				    struct netlink_ext_ack *extack);
+struct net_devmem_dmabuf_binding *
+net_devmem_rxq_binding(struct net_device *dev, u32 rxq_idx);
+int net_devmem_rebind_dmabuf_queue(struct net_device *dev, u32 rxq_idx,
+				   struct net_devmem_dmabuf_binding *old,
+				   struct net_devmem_dmabuf_binding *binding,
+				   struct netlink_ext_ack *extack);
 
 static inline struct dmabuf_genpool_chunk_owner *
 net_devmem_iov_to_chunk_owner(const struct net_iov *niov)
@@ -117,6 +132,23 @@ void net_devmem_free_dmabuf(struct net_iov *ppiov);
 
 bool net_is_devmem_iov(struct net_iov *niov);
 
+static inline void net_devmem_token_get(struct net_iov *niov)
+{
+	atomic_long_inc(&net_devmem_iov_binding(niov)->tokens);
+}
+
+static inline void net_devmem_token_put(netmem_ref netmem)
+{
+	struct net_iov *niov;
+
+	if (!netmem_is_net_iov(netmem))
+		return;
+
+	niov = netmem_to_net_iov(netmem);
+	if (net_is_devmem_iov(niov))
+		atomic_long_dec(&net_devmem_iov_binding(niov)->tokens);
+}
+
 #else
 struct net_devmem_dmabuf_binding;
 
@@ -146,6 +178,21 @@ net_devmem_bind_dmabuf_to_queue(struct net_device *dev, u32 rxq_idx,
 	return -EOPNOTSUPP;
 }
 
+static inline struct net_devmem_dmabuf_binding *
+net_devmem_rxq_binding(struct net_device *dev, u32 rxq_idx)
+{
+	return NULL;
+}
+
+static inline int
+net_devmem_rebind_dmabuf_queue(struct net_device *dev, u32 rxq_idx,
+			       struct net_devmem_dmabuf_binding *old,
+			       struct net_devmem_dmabuf_binding *binding,
+			       struct netlink_ext_ack *extack)
+{
+	return -EOPNOTSUPP;
+}
+
 static inline struct net_iov *
 net_devmem_alloc_dmabuf(struct net_devmem_dmabuf_binding *binding)
 {
@@ -170,6 +217,14 @@ static inline bool net_is_devmem_iov(struct net_iov *niov)
 {
 	return false;
 }
+
+static inline void net_devmem_token_get(struct net_iov *niov)
+{
+}
+
+static inline void net_devmem_token_put(netmem_ref netmem)
+{
+}
 #endif
 
 #endif /* _NET_DEVMEM_H */
@@ -24,6 +24,7 @@
 #include <linux/sysctl.h>
 #endif
 #include <linux/times.h>
+#include <linux/sched/clock.h>
 #include <net/net_namespace.h>
 #include <net/neighbour.h>
 #include <net/arp.h>
@@ -514,17 +515,18 @@ static struct neigh_hash_table *neigh_hash_alloc(unsigned int shift)
 	struct neigh_hash_table *ret;
 	int i;
 
-	ret = kmalloc(sizeof(*ret), GFP_ATOMIC);
+	ret = kmalloc(sizeof(*ret), GFP_KERNEL);
 	if (!ret)
 		return NULL;
 
-	hash_heads = kzalloc(size, GFP_ATOMIC);
+	hash_heads = kvzalloc(size, GFP_KERNEL);
 	if (!hash_heads) {
 		kfree(ret);
 		return NULL;
 	}
 	ret->hash_heads = hash_heads;
 	ret->hash_shift = shift;
+	RCU_INIT_POINTER(ret->future, NULL);
 	for (i = 0; i < NEIGH_NUM_HASH_RND; i++)
 		neigh_get_hash_rnd(&ret->hash_rnd[i]);
 	return ret;
@@ -536,42 +538,106 @@ static void neigh_hash_free_rcu(struct rcu_head *head)
 						    struct neigh_hash_table,
 						    rcu);
 
-	kfree(nht->hash_heads);
+	kvfree(nht->hash_heads);
 	kfree(nht);
 }
 
-static struct neigh_hash_table *neigh_hash_grow(struct neigh_table *tbl,
-						unsigned long new_shift)
+static struct neigh_hash_table *neigh_hash_future(struct neigh_table *tbl,
+						  struct neigh_hash_table *nht)
 {
-	unsigned int i, hash;
+	return rcu_dereference_check(nht->future, lockdep_is_held(&tbl->lock));
+}
+
+/* While a resize is in progress, walkers see the buckets of the old table
+ * followed by the buckets of the table being filled.
+ */
+static unsigned int neigh_hash_buckets(const struct neigh_hash_table *nht,
+				       const struct neigh_hash_table *future)
+{
+	return (1 << nht->hash_shift) + (future ? 1 << future->hash_shift : 0);
+}
+
+static struct hlist_head *neigh_hash_bucket(struct neigh_hash_table *nht,
+					    struct neigh_hash_table *future,
+					    unsigned int h)
+{
+	if (h < (1 << nht->hash_shift))
+		return &nht->hash_heads[h];
+	return &future->hash_heads[h - (1 << nht->hash_shift)];
+}
+
+static void neigh_lock_hold_stat(struct neigh_table *tbl, u64 start)
+{
+	unsigned long us = div_u64(local_clock() - start, NSEC_PER_USEC);
+
+	if (us > this_cpu_read(tbl->stats->lock_hold_max))
+		this_cpu_write(tbl->stats->lock_hold_max, us);
+}
+
+/* Buckets moved per tbl->lock hold when resizing */
+#define NEIGH_HASH_MIGRATE_BATCH	256
+
+/*
+ * Grow the hash table without stalling the table for the whole rehash: the
+ * new table is allocated in process context and hung off the current one,
+ * then entries are moved over a batch of buckets at a time. Lookups and
+ * inserts look at both tables until the move is complete.
+ */
+static void neigh_hash_grow_work(struct work_struct *work)
+{
+	struct neigh_table *tbl = container_of(work, struct neigh_table,
+					       grow_work);
 	struct neigh_hash_table *new_nht, *old_nht;
+	unsigned int i = 0, end;
+	u64 start;
 
-	NEIGH_CACHE_STAT_INC(tbl, hash_grows);
+	/* Only this work replaces tbl->nht */
+	old_nht = rcu_dereference_protected(tbl->nht, 1);
+	if (atomic_read(&tbl->entries) <= (1 << old_nht->hash_shift))
+		return;
 
-	old_nht = rcu_dereference_protected(tbl->nht,
-					    lockdep_is_held(&tbl->lock));
-	new_nht = neigh_hash_alloc(new_shift);
+	new_nht = neigh_hash_alloc(old_nht->hash_shift + 1);
 	if (!new_nht)
-		return old_nht;
+		return;
 
-	for (i = 0; i < (1 << old_nht->hash_shift); i++) {
-		struct hlist_node *tmp;
-		struct neighbour *n;
+	NEIGH_CACHE_STAT_INC(tbl, hash_grows);
+
+	write_lock_bh(&tbl->lock);
+	rcu_assign_pointer(old_nht->future, new_nht);
+	write_unlock_bh(&tbl->lock);
 
-		neigh_for_each_in_bucket_safe(n, tmp, &old_nht->hash_heads[i]) {
-			hash = tbl->hash(n->primary_key, n->dev,
-					 new_nht->hash_rnd);
+	while (i < (1 << old_nht->hash_shift)) {
+		end = min(i + NEIGH_HASH_MIGRATE_BATCH,
+			  1U << old_nht->hash_shift);
 
-			hash >>= (32 - new_nht->hash_shift);
+		write_lock_bh(&tbl->lock);
+		start = local_clock();
+		for (; i < end; i++) {
+			struct hlist_node *tmp;
+			struct neighbour *n;
+			u32 hash;
 
-			hlist_del_rcu(&n->hash);
-			hlist_add_head_rcu(&n->hash, &new_nht->hash_heads[hash]);
+			neigh_for_each_in_bucket_safe(n, tmp,
+						      &old_nht->hash_heads[i]) {
+				hash = tbl->hash(n->primary_key, n->dev,
+						 new_nht->hash_rnd);
+
+				hash >>= (32 - new_nht->hash_shift);
+
+				hlist_del_rcu(&n->hash);
+				hlist_add_head_rcu(&n->hash,
+						   &new_nht->hash_heads[hash]);
+			}
 		}
+		neigh_lock_hold_stat(tbl, start);
+		write_unlock_bh(&tbl->lock);
+		cond_resched();
 	}
 
+	write_lock_bh(&tbl->lock);
 	rcu_assign_pointer(tbl->nht, new_nht);
+	write_unlock_bh(&tbl->lock);
 	call_rcu(&old_nht->rcu, neigh_hash_free_rcu);
-	return new_nht;
 }
 
 struct neighbour *neigh_lookup(struct neigh_table *tbl, const void *pkey,
@@ -600,8 +666,8 @@ ___neigh_create(struct neigh_table *tbl, const void *pkey,
 		bool exempt_from_gc, bool want_ref)
 {
 	u32 hash_val, key_len = tbl->key_len;
+	struct neigh_hash_table *nht, *t;
 	struct neighbour *n1, *rc, *n;
-	struct neigh_hash_table *nht;
 	int error;
 
 	n = neigh_alloc(tbl, dev, flags, exempt_from_gc);
@@ -642,22 +708,28 @@ ___neigh_create(struct neigh_table *tbl, const void *pkey,
 	nht = rcu_dereference_protected(tbl->nht,
 					lockdep_is_held(&tbl->lock));
 
-	if (atomic_read(&tbl->entries) > (1 << nht->hash_shift))
-		nht = neigh_hash_grow(tbl, nht->hash_shift + 1);
-
-	hash_val = tbl->hash(n->primary_key, dev, nht->hash_rnd) >> (32 - nht->hash_shift);
+	if (atomic_read(&tbl->entries) > (1 << nht->hash_shift) &&
+	    !neigh_hash_future(tbl, nht))
+		queue_work(system_unbound_wq, &tbl->grow_work);
 
 	if (n->parms->dead) {
 		rc = ERR_PTR(-EINVAL);
 		goto out_tbl_unlock;
 	}
 
-	neigh_for_each_in_bucket(n1, &nht->hash_heads[hash_val]) {
-		if (dev == n1->dev && !memcmp(n1->primary_key, n->primary_key, key_len)) {
-			if (want_ref)
-				neigh_hold(n1);
-			rc = n1;
-			goto out_tbl_unlock;
+	/* Check both tables if resizing; new entries go to the new one. */
+	for (t = nht; t; t = neigh_hash_future(tbl, t)) {
+		nht = t;
+		hash_val = tbl->hash(n->primary_key, dev, nht->hash_rnd) >>
+			   (32 - nht->hash_shift);
+
+		neigh_for_each_in_bucket(n1, &nht->hash_heads[hash_val]) {
+			if (dev == n1->dev && !memcmp(n1->primary_key, n->primary_key, key_len)) {
+				if (want_ref)
+					neigh_hold(n1);
+				rc = n1;
+				goto out_tbl_unlock;
+			}
 		}
 	}
 
@@ -899,17 +971,24 @@ static void neigh_connect(struct neighbour *neigh)
 	WRITE_ONCE(neigh->output, neigh->ops->connected_output);
 }
 
+/* Periodic GC covers the table in this many runs */
+#define NEIGH_GC_SLICES		16
+
 static void neigh_periodic_work(struct work_struct *work)
 {
 	struct neigh_table *tbl = container_of(work, struct neigh_table, gc_work.work);
-	struct neigh_hash_table *nht;
+	struct neigh_hash_table *nht, *future;
+	unsigned long delay = NEIGH_VAR(&tbl->parms, BASE_REACHABLE_TIME) >> 1;
+	unsigned int i, end, nbuckets;
 	struct hlist_node *tmp;
 	struct neighbour *n;
-	unsigned int i;
+	u64 run_start, start;
 
 	NEIGH_CACHE_STAT_INC(tbl, periodic_gc_runs);
 
+	run_start = local_clock();
 	write_lock_bh(&tbl->lock);
+	start = run_start;
 	nht = rcu_dereference_protected(tbl->nht,
 					lockdep_is_held(&tbl->lock));
 
@@ -929,8 +1008,20 @@ static void neigh_periodic_work(struct work_struct *work)
 	if (atomic_read(&tbl->entries) < READ_ONCE(tbl->gc_thresh1))
 		goto out;
 
-	for (i = 0 ; i < (1 << nht->hash_shift); i++) {
-		neigh_for_each_in_bucket_safe(n, tmp, &nht->hash_heads[i]) {
+	/* Each run resumes where the previous one stopped and handles a
+	 * slice of the buckets, so a large table is not walked in one go.
+	 */
+	future = neigh_hash_future(tbl, nht);
+	nbuckets = neigh_hash_buckets(nht, future);
+	i = tbl->gc_bucket;
+	if (i >= nbuckets)
+		i = 0;
+	end = min(nbuckets, i + max(nbuckets / NEIGH_GC_SLICES, 1U));
+	delay = max(delay / NEIGH_GC_SLICES, 1UL);
+
+	for (; i < end; i++) {
+		neigh_for_each_in_bucket_safe(n, tmp,
+					      neigh_hash_bucket(nht, future, i)) {
 			unsigned int state;
 
 			write_lock(&n->lock);
@@ -961,22 +1052,32 @@ static void neigh_periodic_work(struct work_struct *work)
 		}
 		/*
 		 * It's fine to release lock here, even if hash table
-		 * grows while we are preempted.
+		 * grows while we are preempted: a finished resize only
+		 * shifts the bucket numbering, which the next slice copes
+		 * with.
 		 */
+		neigh_lock_hold_stat(tbl, start);
 		write_unlock_bh(&tbl->lock);
 		cond_resched();
 		write_lock_bh(&tbl->lock);
+		start = local_clock();
 		nht = rcu_dereference_protected(tbl->nht,
 						lockdep_is_held(&tbl->lock));
+		future = neigh_hash_future(tbl, nht);
+		nbuckets = neigh_hash_buckets(nht, future);
+		end = min(end, nbuckets);
 	}
+	tbl->gc_bucket = i;
 out:
 	/* Cycle through all hash buckets every BASE_REACHABLE_TIME/2 ticks.
 	 * ARP entry timeouts range from 1/2 BASE_REACHABLE_TIME to 3/2
 	 * BASE_REACHABLE_TIME.
 	 */
-	queue_delayed_work(system_power_efficient_wq, &tbl->gc_work,
-			      NEIGH_VAR(&tbl->parms, BASE_REACHABLE_TIME) >> 1);
+	queue_delayed_work(system_power_efficient_wq, &tbl->gc_work, delay);
+	neigh_lock_hold_stat(tbl, start);
 	write_unlock_bh(&tbl->lock);
+	this_cpu_add(tbl->stats->periodic_gc_time,
+		     div_u64(local_clock() - run_start, NSEC_PER_USEC));
 }
 
 static __inline__ int neigh_max_probes(struct neighbour *n)
@@ -1742,6 +1843,7 @@ void neigh_table_init(int index, struct neigh_table *tbl)
 #endif
 
 	RCU_INIT_POINTER(tbl->nht, neigh_hash_alloc(3));
+	INIT_WORK(&tbl->grow_work, neigh_hash_grow_work);
 
 	phsize = (PNEIGH_HASHMASK + 1) * sizeof(struct pneigh_entry *);
 	tbl->phash_buckets = kzalloc(phsize, GFP_KERNEL);
@@ -1786,6 +1888,7 @@ int neigh_table_clear(int index, struct neigh_table *tbl)
 	/* It is not clean... Fix it to unload IPv6 module safely */
 	cancel_delayed_work_sync(&tbl->managed_work);
 	cancel_delayed_work_sync(&tbl->gc_work);
+	cancel_work_sync(&tbl->grow_work);
 	timer_delete_sync(&tbl->proxy_timer);
 	pneigh_queue_purge(&tbl->proxy_queue, NULL, tbl->family);
 	neigh_ifdown(tbl, NULL);
@@ -2177,6 +2280,9 @@ static int neightbl_fill_info(struct sk_buff *skb, struct neigh_table *tbl,
 			ndst.ndts_periodic_gc_runs	+= READ_ONCE(st->periodic_gc_runs);
 			ndst.ndts_forced_gc_runs	+= READ_ONCE(st->forced_gc_runs);
 			ndst.ndts_table_fulls		+= READ_ONCE(st->table_fulls);
+			ndst.ndts_periodic_gc_time	+= READ_ONCE(st->periodic_gc_time);
+			ndst.ndts_lock_hold_max		= max_t(u64, ndst.ndts_lock_hold_max,
+								READ_ONCE(st->lock_hold_max));
 		}
 
 		if (nla_put_64bit(skb, NDTA_STATS, sizeof(ndst), &ndst,
@@ -2660,19 +2766,20 @@ static int neigh_dump_table(struct neigh_table *tbl, struct sk_buff *skb,
 	struct neighbour *n;
 	int err = 0, h, s_h = cb->args[1];
 	int idx, s_idx = idx = cb->args[2];
-	struct neigh_hash_table *nht;
+	struct neigh_hash_table *nht, *future;
 	unsigned int flags = NLM_F_MULTI;
 
 	if (filter->dev_idx || filter->master_idx)
 		flags |= NLM_F_DUMP_FILTERED;
 
 	nht = rcu_dereference(tbl->nht);
+	future = rcu_dereference(nht->future);
 
-	for (h = s_h; h < (1 << nht->hash_shift); h++) {
+	for (h = s_h; h < neigh_hash_buckets(nht, future); h++) {
 		if (h > s_h)
 			s_idx = 0;
 		idx = 0;
-		neigh_for_each_in_bucket_rcu(n, &nht->hash_heads[h]) {
+		neigh_for_each_in_bucket_rcu(n, neigh_hash_bucket(nht, future, h)) {
 			if (idx < s_idx || !net_eq(dev_net(n->dev), net))
 				goto next;
 			if (neigh_ifindex_filtered(n->dev, filter->dev_idx) ||
@@ -3031,16 +3138,17 @@ static int neigh_get(struct sk_buff *in_skb, struct nlmsghdr *nlh,
 void neigh_for_each(struct neigh_table *tbl, void (*cb)(struct neighbour *, void *), void *cookie)
 {
 	int chain;
-	struct neigh_hash_table *nht;
+	struct neigh_hash_table *nht, *future;
 
 	rcu_read_lock();
+	read_lock_bh(&tbl->lock); /* avoid resizes */
 	nht = rcu_dereference(tbl->nht);
+	future = neigh_hash_future(tbl, nht);
 
-	read_lock_bh(&tbl->lock); /* avoid resizes */
-	for (chain = 0; chain < (1 << nht->hash_shift); chain++) {
+	for (chain = 0; chain < neigh_hash_buckets(nht, future); chain++) {
 		struct neighbour *n;
 
-		neigh_for_each_in_bucket(n, &nht->hash_heads[chain])
+		neigh_for_each_in_bucket(n, neigh_hash_bucket(nht, future, chain))
 			cb(n, cookie);
 	}
 	read_unlock_bh(&tbl->lock);
@@ -3052,16 +3160,18 @@ EXPORT_SYMBOL(neigh_for_each);
 void __neigh_for_each_release(struct neigh_table *tbl,
 			      int (*cb)(struct neighbour *))
 {
-	struct neigh_hash_table *nht;
+	struct neigh_hash_table *nht, *future;
 	int chain;
 
 	nht = rcu_dereference_protected(tbl->nht,
 					lockdep_is_held(&tbl->lock));
-	for (chain = 0; chain < (1 << nht->hash_shift); chain++) {
+	future = neigh_hash_future(tbl, nht);
+	for (chain = 0; chain < neigh_hash_buckets(nht, future); chain++) {
 		struct hlist_node *tmp;
 		struct neighbour *n;
 
-		neigh_for_each_in_bucket_safe(n, tmp, &nht->hash_heads[chain]) {
+		neigh_for_each_in_bucket_safe(n, tmp,
+					      neigh_hash_bucket(nht, future, chain)) {
 			int release;
 
 			write_lock(&n->lock);
@@ -3161,12 +3271,14 @@ static struct neighbour *neigh_get_first(struct seq_file *seq)
 {
 	struct neigh_seq_state *state = seq->private;
 	struct neigh_hash_table *nht = state->nht;
+	struct neigh_hash_table *future = neigh_hash_future(state->tbl, nht);
 	struct neighbour *n, *tmp;
 
 	state->flags &= ~NEIGH_SEQ_IS_PNEIGH;
 
-	while (++state->bucket < (1 << nht->hash_shift)) {
-		neigh_for_each_in_bucket(n, &nht->hash_heads[state->bucket]) {
+	while (++state->bucket < neigh_hash_buckets(nht, future)) {
+		neigh_for_each_in_bucket(n, neigh_hash_bucket(nht, future,
+							      state->bucket)) {
 			tmp = neigh_get_valid(seq, n, NULL);
 			if (tmp)
 				return tmp;
@@ -3400,13 +3512,14 @@ static int neigh_stat_seq_show(struct seq_file *seq, void *v)
 	struct neigh_statistics *st = v;
 
 	if (v == SEQ_START_TOKEN) {
-		seq_puts(seq, "entries  allocs   destroys hash_grows lookups  hits     res_failed rcv_probes_mcast rcv_probes_ucast periodic_gc_runs forced_gc_runs unresolved_discards table_fulls\n");
+		seq_puts(seq, "entries  allocs   destroys hash_grows lookups  hits     res_failed rcv_probes_mcast rcv_probes_ucast periodic_gc_runs forced_gc_runs unresolved_discards table_fulls periodic_gc_time lock_hold_max\n");
 		return 0;
 	}
 
 	seq_printf(seq, "%08x %08lx %08lx %08lx   %08lx %08lx %08lx   "
 			"%08lx         %08lx         %08lx         "
-			"%08lx       %08lx            %08lx\n",
+			"%08lx       %08lx            %08lx    "
+			"%08lx         %08lx\n",
 		   atomic_read(&tbl->entries),
 
 		   st->allocs,
@@ -3424,7 +3537,9 @@ static int neigh_stat_seq_show(struct seq_file *seq, void *v)
 		   st->periodic_gc_runs,
 		   st->forced_gc_runs,
 		   st->unres_discards,
-		   st->table_fulls
+		   st->table_fulls,
+		   st->periodic_gc_time,
+		   st->lock_hold_max
 		   );
 
 	return 0;
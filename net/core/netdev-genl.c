@@ -207,6 +207,18 @@ netdev_nl_napi_fill_one(struct sk_buff *rsp, struct napi_struct *napi,
 			 gro_flush_timeout))
 		goto nla_put_failure;
 
+	if (nla_put_u32(rsp, NETDEV_A_NAPI_ADAPTIVE, napi_get_adaptive(napi)))
+		goto nla_put_failure;
+
+	if (napi_get_adaptive(napi) &&
+	    (nla_put_u32(rsp, NETDEV_A_NAPI_ADAPTIVE_LOAD,
+			 READ_ONCE(napi->adapt_load)) ||
+	     nla_put_u32(rsp, NETDEV_A_NAPI_ADAPTIVE_DEFER_HARD_IRQS,
+			 READ_ONCE(napi->adapt_defer)) ||
+	     nla_put_uint(rsp, NETDEV_A_NAPI_ADAPTIVE_GRO_FLUSH_TIMEOUT,
+			  READ_ONCE(napi->adapt_timeout))))
+		goto nla_put_failure;
+
 	genlmsg_end(rsp, hdr);
 
 	return 0;
@@ -341,6 +353,10 @@ netdev_nl_napi_set_config(struct napi_struct *napi, struct genl_info *info)
 		napi_set_gro_flush_timeout(napi, gro_flush_timeout);
 	}
 
+	if (info->attrs[NETDEV_A_NAPI_ADAPTIVE])
+		napi_set_adaptive(napi,
+				  nla_get_u32(info->attrs[NETDEV_A_NAPI_ADAPTIVE]));
+
 	return 0;
 }
 
@@ -407,6 +423,16 @@ netdev_nl_queue_fill_one(struct sk_buff *rsp, struct net_device *netdev,
 			if (nla_put_empty_nest(rsp, NETDEV_A_QUEUE_XSK))
 				goto nla_put_failure;
 #endif
+#ifdef CONFIG_RPS
+		if (rcu_access_pointer(rxq->rps_flow_table) &&
+		    (nla_put_uint(rsp, NETDEV_A_QUEUE_RFS_COLLISIONS,
+				  READ_ONCE(rxq->rfs_collisions)) ||
+		     nla_put_uint(rsp, NETDEV_A_QUEUE_RFS_STEER_CHANGES,
+				  READ_ONCE(rxq->rfs_steer_changes)) ||
+		     nla_put_uint(rsp, NETDEV_A_QUEUE_RFS_FILTER_UPDATES,
+				  READ_ONCE(rxq->rfs_filter_updates))))
+			goto nla_put_failure;
+#endif
 
 		break;
 	case NETDEV_QUEUE_TYPE_TX:
@@ -825,15 +851,44 @@ int netdev_nl_qstats_get_dumpit(struct sk_buff *skb,
 	return err;
 }
 
+static bool netdev_nl_sock_owns_binding(struct netdev_nl_sock *priv,
+					struct net_devmem_dmabuf_binding *binding)
+{
+	struct net_devmem_dmabuf_binding *pos;
+
+	list_for_each_entry(pos, &priv->bindings, list)
+		if (pos == binding)
+			return true;
+	return false;
+}
+
+/* Move the queues a failed bind had already taken over from other bindings
+ * back to them, so that they don't end up without a memory provider when the
+ * new binding is torn down.
+ */
+static void netdev_nl_bind_rx_restore(struct net_device *netdev,
+				      struct net_devmem_dmabuf_binding *binding,
+				      struct xarray *rebound)
+{
+	struct net_devmem_dmabuf_binding *old;
+	unsigned long rxq_idx;
+
+	xa_for_each(rebound, rxq_idx, old)
+		net_devmem_rebind_dmabuf_queue(netdev, rxq_idx, binding, old,
+					       NULL);
+}
+
 int netdev_nl_bind_rx_doit(struct sk_buff *skb, struct genl_info *info)
 {
 	struct nlattr *tb[ARRAY_SIZE(netdev_queue_id_nl_policy)];
-	struct net_devmem_dmabuf_binding *binding;
+	struct net_devmem_dmabuf_binding *binding, *old;
 	u32 ifindex, dmabuf_fd, rxq_idx;
 	struct netdev_nl_sock *priv;
 	struct net_device *netdev;
 	struct sk_buff *rsp;
 	struct nlattr *attr;
+	/* queues moved over from another binding, and where they came from */
+	struct xarray rebound;
 	int rem, err = 0;
 	void *hdr;
 
@@ -880,6 +935,8 @@ int netdev_nl_bind_rx_doit(struct sk_buff *skb, struct genl_info *info)
 		goto err_unlock;
 	}
 
+	xa_init(&rebound);
+
 	nla_for_each_attr_type(attr, NETDEV_A_DMABUF_QUEUES,
 			       genlmsg_data(info->genlhdr),
 			       genlmsg_len(info->genlhdr), rem) {
@@ -903,8 +960,24 @@ int netdev_nl_bind_rx_doit(struct sk_buff *skb, struct genl_info *info)
 
 		rxq_idx = nla_get_u32(tb[NETDEV_A_QUEUE_ID]);
 
-		err = net_devmem_bind_dmabuf_to_queue(netdev, rxq_idx, binding,
-						      info->extack);
+		/* A queue already bound to one of our own dmabufs is moved
+		 * over to the new one without going through an unbound state.
+		 */
+		old = net_devmem_rxq_binding(netdev, rxq_idx);
+		if (old && netdev_nl_sock_owns_binding(priv, old)) {
+			err = xa_insert(&rebound, rxq_idx, old, GFP_KERNEL);
+			if (err)
+				goto err_unbind;
+			err = net_devmem_rebind_dmabuf_queue(netdev, rxq_idx,
+							     old, binding,
+							     info->extack);
+			if (err)
+				xa_erase(&rebound, rxq_idx);
+		} else {
+			err = net_devmem_bind_dmabuf_to_queue(netdev, rxq_idx,
+							      binding,
+							      info->extack);
+		}
 		if (err)
 			goto err_unbind;
 	}
@@ -918,6 +991,7 @@ int netdev_nl_bind_rx_doit(struct sk_buff *skb, struct genl_info *info)
 	if (err)
 		goto err_unbind;
 
+	xa_destroy(&rebound);
 	netdev_unlock(netdev);
 
 	mutex_unlock(&priv->lock);
@@ -925,6 +999,8 @@ int netdev_nl_bind_rx_doit(struct sk_buff *skb, struct genl_info *info)
 	return 0;
 
 err_unbind:
+	netdev_nl_bind_rx_restore(netdev, binding, &rebound);
+	xa_destroy(&rebound);
 	net_devmem_unbind_dmabuf(binding);
 err_unlock:
 	netdev_unlock(netdev);
@@ -178,6 +178,37 @@ void __net_mp_close_rxq(struct net_device *dev, unsigned int ifq_idx,
 	WARN_ON(err && err != -ENETDOWN);
 }
 
+/* Replace the memory provider of a bound queue with a single restart. On
+ * failure the queue is left running with @old_p.
+ */
+int __net_mp_swap_rxq(struct net_device *dev, unsigned int rxq_idx,
+		      const struct pp_memory_provider_params *old_p,
+		      const struct pp_memory_provider_params *p,
+		      struct netlink_ext_ack *extack)
+{
+	struct netdev_rx_queue *rxq;
+	int ret;
+
+	if (rxq_idx >= dev->real_num_rx_queues) {
+		NL_SET_ERR_MSG(extack, "rx queue index out of range");
+		return -ERANGE;
+	}
+	rxq_idx = array_index_nospec(rxq_idx, dev->real_num_rx_queues);
+
+	rxq = __netif_get_rx_queue(dev, rxq_idx);
+	if (rxq->mp_params.mp_ops != old_p->mp_ops ||
+	    rxq->mp_params.mp_priv != old_p->mp_priv) {
+		NL_SET_ERR_MSG(extack, "designated queue bound to a different memory provider");
+		return -EBUSY;
+	}
+
+	rxq->mp_params = *p;
+	ret = netdev_rx_queue_restart(dev, rxq_idx);
+	if (ret)
+		rxq->mp_params = *old_p;
+	return ret;
+}
+
 void net_mp_close_rxq(struct net_device *dev, unsigned ifq_idx,
 		      struct pp_memory_provider_params *old_p)
 {
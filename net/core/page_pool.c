@@ -22,6 +22,8 @@
 #include <linux/page-flags.h>
 #include <linux/mm.h> /* for put_page() */
 #include <linux/poison.h>
+#include <linux/cpumask.h>
+#include <linux/sched/clock.h>
 #include <linux/ethtool.h>
 #include <linux/netdevice.h>
 
@@ -44,6 +46,7 @@ static DEFINE_PER_CPU(struct page_pool_recycle_stats, pp_system_recycle_stats);
 
 /* alloc_stat_inc is intended to be used in softirq context */
 #define alloc_stat_inc(pool, __stat)	(pool->alloc_stats.__stat++)
+#define alloc_stat_add(pool, __stat, val)	(pool->alloc_stats.__stat += (val))
 /* recycle_stat_inc is safe to use when preemption is possible. */
 #define recycle_stat_inc(pool, __stat)							\
 	do {										\
@@ -69,6 +72,10 @@ static const char pp_stats[][ETH_GSTRING_LEN] = {
 	"rx_pp_recycle_ring",
 	"rx_pp_recycle_ring_full",
 	"rx_pp_recycle_released_ref",
+	"rx_pp_alloc_remote",
+	"rx_pp_alloc_remote_latency",
+	"rx_pp_recycle_remote",
+	"rx_pp_recycle_remote_full",
 };
 
 /**
@@ -97,6 +104,8 @@ bool page_pool_get_stats(const struct page_pool *pool,
 	stats->alloc_stats.empty += pool->alloc_stats.empty;
 	stats->alloc_stats.refill += pool->alloc_stats.refill;
 	stats->alloc_stats.waive += pool->alloc_stats.waive;
+	stats->alloc_stats.remote += pool->alloc_stats.remote;
+	stats->alloc_stats.remote_latency += pool->alloc_stats.remote_latency;
 
 	for_each_possible_cpu(cpu) {
 		const struct page_pool_recycle_stats *pcpu =
@@ -107,6 +116,8 @@ bool page_pool_get_stats(const struct page_pool *pool,
 		stats->recycle_stats.ring += pcpu->ring;
 		stats->recycle_stats.ring_full += pcpu->ring_full;
 		stats->recycle_stats.released_refcnt += pcpu->released_refcnt;
+		stats->recycle_stats.remote += pcpu->remote;
+		stats->recycle_stats.remote_full += pcpu->remote_full;
 	}
 
 	return true;
@@ -147,6 +158,10 @@ u64 *page_pool_ethtool_stats_get(u64 *data, const void *stats)
 	*data++ = pool_stats->recycle_stats.ring;
 	*data++ = pool_stats->recycle_stats.ring_full;
 	*data++ = pool_stats->recycle_stats.released_refcnt;
+	*data++ = pool_stats->alloc_stats.remote;
+	*data++ = pool_stats->alloc_stats.remote_latency;
+	*data++ = pool_stats->recycle_stats.remote;
+	*data++ = pool_stats->recycle_stats.remote_full;
 
 	return data;
 }
@@ -154,10 +169,66 @@ EXPORT_SYMBOL(page_pool_ethtool_stats_get);
 
 #else
 #define alloc_stat_inc(pool, __stat)
+#define alloc_stat_add(pool, __stat, val)
 #define recycle_stat_inc(pool, __stat)
 #define recycle_stat_add(pool, __stat, val)
 #endif
 
+/* Per-CPU return ring, single producer (its CPU, BH off), single consumer
+ * (the allocation side). Only NAPI pools created while
+ * net.core.page_pool_remote_recycle is on get them.
+ */
+#define PP_REMOTE_RING_SIZE	64
+#define PP_REMOTE_RING_MASK	(PP_REMOTE_RING_SIZE - 1)
+/* Per-CPU share of the pool size below which rings aren't worth it */
+#define PP_REMOTE_RING_MIN	8
+
+DEFINE_STATIC_KEY_FALSE(page_pool_remote_recycle);
+
+struct page_pool_remote {
+	u32 head;
+	u32 tail;
+	/* when the ring last went from empty to non-empty */
+	u64 first_ts;
+	netmem_ref ring[PP_REMOTE_RING_SIZE];
+};
+
+/* The rings of all CPUs together hold at most @ring_qsize pages, the size
+ * of the ptr_ring they stand in front of.
+ */
+static int page_pool_remote_init(struct page_pool *pool,
+				 unsigned int ring_qsize)
+{
+	unsigned int share = ring_qsize / num_possible_cpus();
+
+	if (!static_branch_unlikely(&page_pool_remote_recycle))
+		return 0;
+	if (!pool->p.napi || pool->mp_ops || share < PP_REMOTE_RING_MIN)
+		return 0;
+#ifdef CONFIG_PAGE_POOL_STATS
+	if (pool->system)
+		return 0;
+#endif
+	pool->remote_cap = min_t(unsigned int, share, PP_REMOTE_RING_SIZE);
+
+	if (!zalloc_cpumask_var(&pool->remote_pending, GFP_KERNEL))
+		return -ENOMEM;
+	pool->remote = alloc_percpu(struct page_pool_remote);
+	if (!pool->remote) {
+		free_cpumask_var(pool->remote_pending);
+		return -ENOMEM;
+	}
+	return 0;
+}
+
+static void page_pool_remote_uninit(struct page_pool *pool)
+{
+	if (!pool->remote)
+		return;
+	free_percpu(pool->remote);
+	free_cpumask_var(pool->remote_pending);
+}
+
 static bool page_pool_producer_lock(struct page_pool *pool)
 	__acquires(&pool->ring.producer_lock)
 {
@@ -306,6 +377,14 @@ static int page_pool_init(struct page_pool *pool,
 		static_branch_inc(&page_pool_mem_providers);
 	}
 
+	/* Never fails for memory provider pools, no need to undo ->init */
+	err = page_pool_remote_init(pool, ring_qsize);
+	if (err) {
+		if (pool->dma_map)
+			put_device(pool->p.dev);
+		goto free_ptr_ring;
+	}
+
 	return 0;
 
 free_ptr_ring:
@@ -319,6 +398,7 @@ static int page_pool_init(struct page_pool *pool,
 
 static void page_pool_uninit(struct page_pool *pool)
 {
+	page_pool_remote_uninit(pool);
 	ptr_ring_cleanup(&pool->ring, NULL);
 
 	if (pool->dma_map)
@@ -376,27 +456,89 @@ EXPORT_SYMBOL(page_pool_create);
 
 static void page_pool_return_page(struct page_pool *pool, netmem_ref netmem);
 
-static noinline netmem_ref page_pool_refill_alloc_cache(struct page_pool *pool)
+/* Move pages from the remote return rings into the alloc cache. Called
+ * by the single consumer, i.e. the allocation side, or on teardown.
+ */
+static void page_pool_drain_remote(struct page_pool *pool, int pref_nid,
+				   bool all)
 {
-	struct ptr_ring *r = &pool->ring;
-	netmem_ref netmem;
-	int pref_nid; /* preferred NUMA node */
+	u64 now = local_clock(), latency = 0;
+	unsigned int cpu, nr = 0;
 
-	/* Quicker fallback, avoid locks when ring is empty */
-	if (__ptr_ring_empty(r)) {
-		alloc_stat_inc(pool, empty);
-		return 0;
+	for_each_cpu(cpu, pool->remote_pending) {
+		struct page_pool_remote *r = per_cpu_ptr(pool->remote, cpu);
+		u32 head, tail;
+
+		if (!all && pool->alloc.count >= PP_ALLOC_CACHE_REFILL)
+			break;
+
+		/* Clear before looking at head, see page_pool_recycle_remote() */
+		cpumask_clear_cpu(cpu, pool->remote_pending);
+		smp_mb__after_atomic();
+
+		head = smp_load_acquire(&r->head);
+		tail = r->tail;
+		if (head == tail)
+			continue;
+		latency += now - READ_ONCE(r->first_ts);
+
+		while (tail != head) {
+			netmem_ref netmem = r->ring[tail & PP_REMOTE_RING_MASK];
+
+			if (!all && pool->alloc.count == PP_ALLOC_CACHE_SIZE)
+				break;
+			tail++;
+			nr++;
+			if (!all && likely(netmem_is_pref_nid(netmem, pref_nid))) {
+				pool->alloc.cache[pool->alloc.count++] = netmem;
+			} else {
+				page_pool_return_page(pool, netmem);
+				if (!all)
+					alloc_stat_inc(pool, waive);
+			}
+		}
+		/* Pairs with the acquire in page_pool_recycle_remote() */
+		smp_store_release(&r->tail, tail);
+		if (tail != head)
+			cpumask_set_cpu(cpu, pool->remote_pending);
 	}
 
+	alloc_stat_add(pool, remote, nr);
+	alloc_stat_add(pool, remote_latency, latency);
+}
+
+static int page_pool_pref_nid(const struct page_pool *pool)
+{
 	/* Softirq guarantee CPU and thus NUMA node is stable. This,
 	 * assumes CPU refilling driver RX-ring will also run RX-NAPI.
 	 */
 #ifdef CONFIG_NUMA
-	pref_nid = (pool->p.nid == NUMA_NO_NODE) ? numa_mem_id() : pool->p.nid;
+	return (pool->p.nid == NUMA_NO_NODE) ? numa_mem_id() : pool->p.nid;
 #else
 	/* Ignore pool->p.nid setting if !CONFIG_NUMA, helps compiler */
-	pref_nid = numa_mem_id(); /* will be zero like page_to_nid() */
+	return numa_mem_id(); /* will be zero like page_to_nid() */
 #endif
+}
+
+static noinline netmem_ref page_pool_refill_alloc_cache(struct page_pool *pool)
+{
+	struct ptr_ring *r = &pool->ring;
+	netmem_ref netmem;
+	int pref_nid = page_pool_pref_nid(pool); /* preferred NUMA node */
+
+	if (pool->remote && !cpumask_empty(pool->remote_pending)) {
+		page_pool_drain_remote(pool, pref_nid, false);
+		if (pool->alloc.count) {
+			alloc_stat_inc(pool, refill);
+			return pool->alloc.cache[--pool->alloc.count];
+		}
+	}
+
+	/* Quicker fallback, avoid locks when ring is empty */
+	if (__ptr_ring_empty(r)) {
+		alloc_stat_inc(pool, empty);
+		return 0;
+	}
 
 	/* Refill alloc array, but only if NUMA match */
 	do {
@@ -722,6 +864,47 @@ static bool page_pool_recycle_in_ring(struct page_pool *pool, netmem_ref netmem)
 	return false;
 }
 
+/* Queue a page into this CPU's remote return ring. Returns the number of
+ * @bulk entries queued.
+ */
+static u32 page_pool_recycle_remote(struct page_pool *pool, netmem_ref *bulk,
+				    u32 bulk_len)
+{
+	struct page_pool_remote *r;
+	unsigned int cpu;
+	u32 head, tail, i;
+
+	if (!static_branch_unlikely(&page_pool_remote_recycle) ||
+	    !pool->remote || !READ_ONCE(pool->p.napi))
+		return 0;
+
+	/* Single producer per ring: BH off keeps other contexts of this CPU out */
+	local_bh_disable();
+	cpu = smp_processor_id();
+	r = per_cpu_ptr(pool->remote, cpu);
+	head = r->head;
+	tail = smp_load_acquire(&r->tail);
+	if (head == tail)
+		WRITE_ONCE(r->first_ts, local_clock());
+	for (i = 0; i < bulk_len && head - tail < pool->remote_cap; i++)
+		r->ring[head++ & PP_REMOTE_RING_MASK] = bulk[i];
+	if (i) {
+		smp_store_release(&r->head, head);
+		/* Order the head update against the pending check, pairs with
+		 * the barrier in page_pool_drain_remote().
+		 */
+		smp_mb();
+		if (!cpumask_test_cpu(cpu, pool->remote_pending))
+			cpumask_set_cpu(cpu, pool->remote_pending);
+		recycle_stat_add(pool, remote, i);
+	}
+	if (i < bulk_len)
+		recycle_stat_inc(pool, remote_full);
+	local_bh_enable();
+
+	return i;
+}
+
 /* Only allow direct recycling in special circumstances, into the
  * alloc side cache.  E.g. during RX-NAPI processing for XDP_DROP use-case.
  *
@@ -831,6 +1014,8 @@ void page_pool_put_unrefed_netmem(struct page_pool *pool, netmem_ref netmem,
 
 	netmem =
 		__page_pool_put_page(pool, netmem, dma_sync_size, allow_direct);
+	if (netmem && page_pool_recycle_remote(pool, &netmem, 1))
+		return;
 	if (netmem && !page_pool_recycle_in_ring(pool, netmem)) {
 		/* Cache full, fallback to free pages */
 		recycle_stat_inc(pool, ring_full);
@@ -852,12 +1037,18 @@ static void page_pool_recycle_ring_bulk(struct page_pool *pool,
 					u32 bulk_len)
 {
 	bool in_softirq;
-	u32 i;
+	u32 i, remote;
+
+	/* Whatever fits in this CPU's remote return ring needs no lock */
+	remote = page_pool_recycle_remote(pool, bulk, bulk_len);
+	if (remote == bulk_len)
+		return;
+	i = remote;
 
 	/* Bulk produce into ptr_ring page_pool cache */
 	in_softirq = page_pool_producer_lock(pool);
 
-	for (i = 0; i < bulk_len; i++) {
+	for (; i < bulk_len; i++) {
 		if (__ptr_ring_produce(&pool->ring, (__force void *)bulk[i])) {
 			/* ring full */
 			recycle_stat_inc(pool, ring_full);
@@ -866,7 +1057,7 @@ static void page_pool_recycle_ring_bulk(struct page_pool *pool,
 	}
 
 	page_pool_producer_unlock(pool, in_softirq);
-	recycle_stat_add(pool, ring, i);
+	recycle_stat_add(pool, ring, i - remote);
 
 	/* Hopefully all pages were returned into ptr_ring */
 	if (likely(i == bulk_len))
@@ -1034,6 +1225,9 @@ static void page_pool_empty_ring(struct page_pool *pool)
 {
 	netmem_ref netmem;
 
+	if (pool->remote)
+		page_pool_drain_remote(pool, NUMA_NO_NODE, true);
+
 	/* Empty recycle ring */
 	while ((netmem = (__force netmem_ref)ptr_ring_consume_bh(&pool->ring))) {
 		/* Verify the refcnt invariant of cached pages */
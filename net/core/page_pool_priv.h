@@ -8,6 +8,7 @@
 #include "netmem_priv.h"
 
 extern struct mutex page_pools_lock;
+extern struct static_key_false page_pool_remote_recycle;
 
 s32 page_pool_inflight(const struct page_pool *pool, bool strict);
 
@@ -157,7 +157,15 @@ page_pool_nl_stats_fill(struct sk_buff *rsp, const struct page_pool *pool,
 	    nla_put_uint(rsp, NETDEV_A_PAGE_POOL_STATS_RECYCLE_RING_FULL,
 			 stats.recycle_stats.ring_full) ||
 	    nla_put_uint(rsp, NETDEV_A_PAGE_POOL_STATS_RECYCLE_RELEASED_REFCNT,
-			 stats.recycle_stats.released_refcnt))
+			 stats.recycle_stats.released_refcnt) ||
+	    nla_put_uint(rsp, NETDEV_A_PAGE_POOL_STATS_ALLOC_REMOTE,
+			 stats.alloc_stats.remote) ||
+	    nla_put_uint(rsp, NETDEV_A_PAGE_POOL_STATS_ALLOC_REMOTE_LATENCY,
+			 stats.alloc_stats.remote_latency) ||
+	    nla_put_uint(rsp, NETDEV_A_PAGE_POOL_STATS_RECYCLE_REMOTE,
+			 stats.recycle_stats.remote) ||
+	    nla_put_uint(rsp, NETDEV_A_PAGE_POOL_STATS_RECYCLE_REMOTE_FULL,
+			 stats.recycle_stats.remote_full))
 		goto err_cancel_msg;
 
 	genlmsg_end(rsp, hdr);
@@ -238,6 +238,7 @@ static char *pkt_flag_names[] = {
 #define PKTGEN_MAGIC 0xbe9be955
 #define PG_PROC_DIR "pktgen"
 #define PGCTRL	    "pgctrl"
+#define PGRX	    "pgrx"
 
 #define MAX_CFLOWS  65536
 
@@ -443,10 +444,39 @@ struct pktgen_hdr {
 
 static unsigned int pg_net_id __read_mostly;
 
+/* Latency buckets are log2 of the one-way delay in usecs, the last one
+ * collects everything from ~0.5s up.
+ */
+#define PG_RX_HIST_BUCKETS 20
+
+struct pktgen_rx_queue {
+	atomic_long_t packets;
+	atomic_long_t bytes;
+	atomic_long_t lat_sum;		/* usecs */
+	atomic_long_t lat_max;		/* usecs */
+	atomic_long_t hist[PG_RX_HIST_BUCKETS];
+};
+
+/* Receive side of a benchmark: counts pktgen packets arriving on one device
+ * and correlates their TX timestamp with the time they were received.
+ */
+struct pktgen_rx {
+	struct packet_type	pt_ip;
+	struct packet_type	pt_ip6;
+	struct net_device	*dev;
+	netdevice_tracker	dev_tracker;
+	ktime_t			started;
+	atomic_long_t		no_stamp;	/* F_NO_TIMESTAMP packets */
+	atomic_long_t		clock_skew;	/* stamped in the future */
+	unsigned int		nr_queues;
+	struct pktgen_rx_queue	queues[] __counted_by(nr_queues);
+};
+
 struct pktgen_net {
 	struct net		*net;
 	struct proc_dir_entry	*proc_dir;
 	struct list_head	pktgen_threads;
+	struct pktgen_rx	*rx;		/* under pktgen_thread_lock */
 	bool			pktgen_exiting;
 };
 
@@ -487,6 +517,7 @@ static void pktgen_stop_all_threads(struct pktgen_net *pn);
 static void pktgen_stop(struct pktgen_thread *t);
 static void pktgen_clear_counters(struct pktgen_dev *pkt_dev);
 static void fill_imix_distribution(struct pktgen_dev *pkt_dev);
+static void pktgen_rx_stop(struct pktgen_net *pn);
 
 /* Module parameters, defaults. */
 static int pg_count_d __read_mostly = 1000;
@@ -2123,6 +2154,10 @@ static int pktgen_device_event(struct notifier_block *unused,
 
 	case NETDEV_UNREGISTER:
 		pktgen_mark_device(pn, dev->name);
+		mutex_lock(&pktgen_thread_lock);
+		if (pn->rx && pn->rx->dev == dev)
+			pktgen_rx_stop(pn);
+		mutex_unlock(&pktgen_thread_lock);
 		break;
 	}
 
@@ -3999,6 +4034,272 @@ static int pktgen_remove_device(struct pktgen_thread *t,
 	return 0;
 }
 
+static void pktgen_rx_account(struct pktgen_rx *rx, struct sk_buff *skb,
+			      const struct pktgen_hdr *pgh)
+{
+	struct pktgen_rx_queue *q;
+	struct timespec64 now;
+	long lat, max;
+	s64 delta;
+	int bucket;
+
+	q = &rx->queues[skb_rx_queue_recorded(skb) ?
+			skb_get_rx_queue(skb) % rx->nr_queues : 0];
+	atomic_long_inc(&q->packets);
+	atomic_long_add(skb->len, &q->bytes);
+
+	if (!pgh->tv_sec && !pgh->tv_usec) {
+		atomic_long_inc(&rx->no_stamp);
+		return;
+	}
+
+	ktime_get_real_ts64(&now);
+	delta = ((s64)(u32)now.tv_sec - ntohl(pgh->tv_sec)) * USEC_PER_SEC +
+		now.tv_nsec / NSEC_PER_USEC - ntohl(pgh->tv_usec);
+	if (delta < 0) {
+		atomic_long_inc(&rx->clock_skew);
+		return;
+	}
+
+	lat = min_t(s64, delta, LONG_MAX);
+	bucket = min_t(int, lat ? ilog2(lat) + 1 : 0, PG_RX_HIST_BUCKETS - 1);
+	atomic_long_inc(&q->hist[bucket]);
+	atomic_long_add(lat, &q->lat_sum);
+
+	max = atomic_long_read(&q->lat_max);
+	while (lat > max && !atomic_long_try_cmpxchg(&q->lat_max, &max, lat))
+		;
+}
+
+static int pktgen_rx_rcv(struct sk_buff *skb, struct net_device *dev,
+			 struct packet_type *pt, struct net_device *orig_dev)
+{
+	struct pktgen_rx *rx = pt->af_packet_priv;
+	struct pktgen_hdr _pgh, *pgh;
+	unsigned int offset;
+	u8 proto;
+
+	if (skb->pkt_type == PACKET_OUTGOING)
+		goto out;
+
+	if (pt == &rx->pt_ip) {
+		struct iphdr _iph, *iph;
+
+		iph = skb_header_pointer(skb, 0, sizeof(_iph), &_iph);
+		if (!iph || iph->ihl < 5)
+			goto out;
+		proto = iph->protocol;
+		offset = iph->ihl * 4;
+	} else {
+		struct ipv6hdr _ip6h, *ip6h;
+
+		ip6h = skb_header_pointer(skb, 0, sizeof(_ip6h), &_ip6h);
+		if (!ip6h)
+			goto out;
+		proto = ip6h->nexthdr;
+		offset = sizeof(*ip6h);
+	}
+
+	/* pktgen only builds plain UDP, don't bother walking headers */
+	if (proto != IPPROTO_UDP)
+		goto out;
+
+	pgh = skb_header_pointer(skb, offset + sizeof(struct udphdr),
+				 sizeof(_pgh), &_pgh);
+	if (pgh && pgh->pgh_magic == htonl(PKTGEN_MAGIC))
+		pktgen_rx_account(rx, skb, pgh);
+out:
+	consume_skb(skb);
+	return NET_RX_SUCCESS;
+}
+
+/* Called with pktgen_thread_lock held */
+static int pktgen_rx_start(struct pktgen_net *pn, const char *ifname)
+{
+	struct net_device *dev;
+	struct pktgen_rx *rx;
+
+	if (pn->rx)
+		return -EBUSY;
+
+	dev = netdev_get_by_name(pn->net, ifname, NULL, GFP_KERNEL);
+	if (!dev)
+		return -ENODEV;
+
+	rx = kvzalloc(struct_size(rx, queues, dev->num_rx_queues), GFP_KERNEL);
+	if (!rx) {
+		netdev_put(dev, NULL);
+		return -ENOMEM;
+	}
+
+	rx->nr_queues = dev->num_rx_queues;
+	rx->dev = dev;
+	netdev_tracker_alloc(dev, &rx->dev_tracker, GFP_KERNEL);
+	rx->started = ktime_get();
+
+	rx->pt_ip.type = htons(ETH_P_IP);
+	rx->pt_ip.dev = dev;
+	rx->pt_ip.func = pktgen_rx_rcv;
+	rx->pt_ip.af_packet_priv = rx;
+	rx->pt_ip6 = rx->pt_ip;
+	rx->pt_ip6.type = htons(ETH_P_IPV6);
+
+	pn->rx = rx;
+	dev_add_pack(&rx->pt_ip);
+	dev_add_pack(&rx->pt_ip6);
+	return 0;
+}
+
+/* Called with pktgen_thread_lock held */
+static void pktgen_rx_stop(struct pktgen_net *pn)
+{
+	struct pktgen_rx *rx = pn->rx;
+
+	if (!rx)
+		return;
+
+	pn->rx = NULL;
+	__dev_remove_pack(&rx->pt_ip);
+	__dev_remove_pack(&rx->pt_ip6);
+	synchronize_net();
+
+	netdev_put(rx->dev, &rx->dev_tracker);
+	kvfree(rx);
+}
+
+/* Called with pktgen_thread_lock held */
+static void pktgen_rx_reset(struct pktgen_rx *rx)
+{
+	unsigned int i;
+	int b;
+
+	for (i = 0; i < rx->nr_queues; i++) {
+		struct pktgen_rx_queue *q = &rx->queues[i];
+
+		atomic_long_set(&q->packets, 0);
+		atomic_long_set(&q->bytes, 0);
+		atomic_long_set(&q->lat_sum, 0);
+		atomic_long_set(&q->lat_max, 0);
+		for (b = 0; b < PG_RX_HIST_BUCKETS; b++)
+			atomic_long_set(&q->hist[b], 0);
+	}
+	atomic_long_set(&rx->no_stamp, 0);
+	atomic_long_set(&rx->clock_skew, 0);
+	rx->started = ktime_get();
+}
+
+static int pgrx_show(struct seq_file *seq, void *v)
+{
+	struct pktgen_net *pn = seq->private;
+	struct pktgen_rx *rx;
+	u64 elapsed;
+	unsigned int i;
+	int b;
+
+	mutex_lock(&pktgen_thread_lock);
+	rx = pn->rx;
+	if (!rx) {
+		seq_puts(seq, "Result: idle\n");
+		goto out;
+	}
+
+	elapsed = max_t(u64, ktime_us_delta(ktime_get(), rx->started), 1);
+	seq_printf(seq, "Receiving on: %s  elapsed: %lluusec\n",
+		   rx->dev->name, elapsed);
+	seq_printf(seq, "     no_stamp: %lu  clock_skew: %lu\n",
+		   atomic_long_read(&rx->no_stamp),
+		   atomic_long_read(&rx->clock_skew));
+
+	for (i = 0; i < rx->nr_queues; i++) {
+		struct pktgen_rx_queue *q = &rx->queues[i];
+		unsigned long pkts = atomic_long_read(&q->packets);
+		unsigned long stamped = 0;
+
+		if (!pkts)
+			continue;
+
+		for (b = 0; b < PG_RX_HIST_BUCKETS; b++)
+			stamped += atomic_long_read(&q->hist[b]);
+
+		seq_printf(seq, "Queue %u: pkts: %lu  bytes: %lu  %llupps %lluMb/sec\n",
+			   i, pkts, atomic_long_read(&q->bytes),
+			   div64_u64((u64)pkts * USEC_PER_SEC, elapsed),
+			   div64_u64((u64)atomic_long_read(&q->bytes) * 8,
+				     elapsed));
+		seq_printf(seq, "     lat_avg: %luusec  lat_max: %luusec\n",
+			   stamped ? atomic_long_read(&q->lat_sum) / stamped : 0,
+			   atomic_long_read(&q->lat_max));
+		seq_puts(seq, "     hist(usec<=):");
+		for (b = 0; b < PG_RX_HIST_BUCKETS; b++) {
+			unsigned long n = atomic_long_read(&q->hist[b]);
+
+			if (!n)
+				continue;
+			if (b == PG_RX_HIST_BUCKETS - 1)
+				seq_printf(seq, " inf:%lu", n);
+			else
+				seq_printf(seq, " %lu:%lu", b ? 1UL << b : 0, n);
+		}
+		seq_putc(seq, '\n');
+	}
+out:
+	mutex_unlock(&pktgen_thread_lock);
+	return 0;
+}
+
+static ssize_t pgrx_write(struct file *file, const char __user *buf,
+			  size_t count, loff_t *ppos)
+{
+	struct seq_file *seq = file->private_data;
+	struct pktgen_net *pn = seq->private;
+	char data[IFNAMSIZ + 8];
+	size_t max;
+	int ret = 0;
+
+	if (!capable(CAP_NET_ADMIN))
+		return -EPERM;
+
+	if (count < 1)
+		return -EINVAL;
+
+	max = min(count, sizeof(data) - 1);
+	if (copy_from_user(data, buf, max))
+		return -EFAULT;
+
+	if (data[max - 1] == '\n')
+		data[max - 1] = 0; /* strip trailing '\n', terminate string */
+	else
+		data[max] = 0; /* terminate string */
+
+	mutex_lock(&pktgen_thread_lock);
+	if (!strncmp(data, "rx ", 3)) {
+		ret = pktgen_rx_start(pn, strim(data + 3));
+	} else if (!strcmp(data, "stop")) {
+		pktgen_rx_stop(pn);
+	} else if (!strcmp(data, "reset")) {
+		if (pn->rx)
+			pktgen_rx_reset(pn->rx);
+	} else {
+		ret = -EINVAL;
+	}
+	mutex_unlock(&pktgen_thread_lock);
+
+	return ret ? ret : count;
+}
+
+static int pgrx_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, pgrx_show, pde_data(inode));
+}
+
+static const struct proc_ops pktgen_rx_proc_ops = {
+	.proc_open	= pgrx_open,
+	.proc_read	= seq_read,
+	.proc_lseek	= seq_lseek,
+	.proc_write	= pgrx_write,
+	.proc_release	= single_release,
+};
+
 static int __net_init pg_net_init(struct net *net)
 {
 	struct pktgen_net *pn = net_generic(net, pg_net_id);
@@ -4020,6 +4321,14 @@ static int __net_init pg_net_init(struct net *net)
 		goto remove;
 	}
 
+	pe = proc_create_data(PGRX, 0600, pn->proc_dir, &pktgen_rx_proc_ops,
+			      pn);
+	if (!pe) {
+		pr_err("cannot create %s procfs entry\n", PGRX);
+		ret = -EINVAL;
+		goto remove_entry;
+	}
+
 	cpus_read_lock();
 	for_each_online_cpu(cpu) {
 		int err;
@@ -4034,11 +4343,13 @@ static int __net_init pg_net_init(struct net *net)
 	if (list_empty(&pn->pktgen_threads)) {
 		pr_err("Initialization failed for all threads\n");
 		ret = -ENODEV;
-		goto remove_entry;
+		goto remove_rx;
 	}
 
 	return 0;
 
+remove_rx:
+	remove_proc_entry(PGRX, pn->proc_dir);
 remove_entry:
 	remove_proc_entry(PGCTRL, pn->proc_dir);
 remove:
@@ -4058,6 +4369,7 @@ static void __net_exit pg_net_exit(struct net *net)
 
 	mutex_lock(&pktgen_thread_lock);
 	list_splice_init(&pn->pktgen_threads, &list);
+	pktgen_rx_stop(pn);
 	mutex_unlock(&pktgen_thread_lock);
 
 	list_for_each_safe(q, n, &list) {
@@ -4067,6 +4379,7 @@ static void __net_exit pg_net_exit(struct net *net)
 		kfree(t);
 	}
 
+	remove_proc_entry(PGRX, pn->proc_dir);
 	remove_proc_entry(PGCTRL, pn->proc_dir);
 	remove_proc_entry(PG_PROC_DIR, pn->net->proc_net);
 }
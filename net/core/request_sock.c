@@ -40,6 +40,145 @@ void reqsk_queue_alloc(struct request_sock_queue *queue)
 	queue->rskq_accept_head = NULL;
 }
 
+int reqsk_queue_alloc_shards(struct request_sock_queue *queue)
+{
+	struct reqsk_accept_shard __percpu *shards;
+	int cpu;
+
+	if (queue->shards)
+		return 0;
+
+	shards = alloc_percpu(struct reqsk_accept_shard);
+	if (!shards)
+		return -ENOMEM;
+
+	for_each_possible_cpu(cpu)
+		spin_lock_init(&per_cpu_ptr(shards, cpu)->lock);
+
+	atomic_set(&queue->shards_qlen, 0);
+	queue->shards = shards;
+	return 0;
+}
+
+/* Called once the listener can no longer be found, nothing is queued. */
+void reqsk_queue_free_shards(struct request_sock_queue *queue)
+{
+	free_percpu(queue->shards);
+	queue->shards = NULL;
+}
+
+/* sk_ack_backlog of a sharded listener mirrors shards_qlen. Updaters race
+ * to store it, so each one stores again until what it stored is current.
+ */
+void reqsk_queue_sync_backlog(struct request_sock_queue *queue,
+			      struct sock *parent)
+{
+	int qlen = atomic_read(&queue->shards_qlen), cur;
+
+	for (;;) {
+		WRITE_ONCE(parent->sk_ack_backlog, qlen);
+		/* Order the store above against the load below */
+		smp_mb();
+		cur = atomic_read(&queue->shards_qlen);
+		if (cur == qlen)
+			break;
+		qlen = cur;
+	}
+}
+
+/* Wait for adders that saw the listener still in TCP_LISTEN. They link the
+ * child and bump shards_qlen under their shard lock, so once every shard
+ * lock has been taken after the state change, shards_qlen is final apart
+ * from removals.
+ */
+void reqsk_queue_quiesce_shards(struct request_sock_queue *queue)
+{
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		struct reqsk_accept_shard *shard = per_cpu_ptr(queue->shards, cpu);
+
+		spin_lock_bh(&shard->lock);
+		spin_unlock_bh(&shard->lock);
+	}
+}
+
+/* Called with the local CPU's shard lock held, from
+ * inet_csk_reqsk_queue_add().
+ */
+void reqsk_queue_add_sharded(struct request_sock_queue *queue,
+			     struct sock *parent, struct request_sock *req)
+{
+	struct reqsk_accept_shard *shard = this_cpu_ptr(queue->shards);
+
+	req->dl_next = NULL;
+	if (!shard->head)
+		WRITE_ONCE(shard->head, req);
+	else
+		shard->tail->dl_next = req;
+	shard->tail = req;
+	WRITE_ONCE(shard->qlen, shard->qlen + 1);
+
+	/* Publish only once the child can be found by a remover */
+	atomic_inc(&queue->shards_qlen);
+	reqsk_queue_sync_backlog(queue, parent);
+}
+
+static struct request_sock *reqsk_shard_pop(struct reqsk_accept_shard *shard)
+{
+	struct request_sock *req;
+
+	if (!READ_ONCE(shard->head))
+		return NULL;
+
+	spin_lock_bh(&shard->lock);
+	req = shard->head;
+	if (req) {
+		WRITE_ONCE(shard->head, req->dl_next);
+		if (!shard->head)
+			shard->tail = NULL;
+		WRITE_ONCE(shard->qlen, shard->qlen - 1);
+	}
+	spin_unlock_bh(&shard->lock);
+
+	return req;
+}
+
+#define REQSK_SHARD_MAX_PASSES	4
+
+/* Take a child from the local CPU's shard, or steal one from another CPU.
+ * A successful reservation on shards_qlen guarantees some shard holds a
+ * child for us, but other removers may keep taking the ones we are about
+ * to find. Rather than spin, give the reservation back after a few passes
+ * over the shards and return NULL with the queue still non-empty.
+ */
+struct request_sock *reqsk_queue_remove_sharded(struct request_sock_queue *queue,
+						struct sock *parent)
+{
+	struct request_sock *req;
+	int start, cpu, pass;
+
+	if (!atomic_add_unless(&queue->shards_qlen, -1, 0))
+		return NULL;
+	reqsk_queue_sync_backlog(queue, parent);
+
+	start = raw_smp_processor_id();
+	for (pass = 0; pass < REQSK_SHARD_MAX_PASSES; pass++) {
+		cpu = start;
+		do {
+			req = reqsk_shard_pop(per_cpu_ptr(queue->shards, cpu));
+			if (req)
+				return req;
+			cpu = cpumask_next_wrap(cpu, cpu_possible_mask);
+		} while (cpu != start);
+		cpu_relax();
+	}
+
+	atomic_inc(&queue->shards_qlen);
+	reqsk_queue_sync_backlog(queue, parent);
+	return NULL;
+}
+
 /*
  * This function is called to set a Fast Open socket's "fastopen_rsk" field
  * to NULL when a TFO socket no longer needs to access the request_sock.
@@ -5073,14 +5073,21 @@ static void skb_extensions_init(void) {}
 
 void __init skb_init(void)
 {
-	net_hotdata.skbuff_cache = kmem_cache_create_usercopy("skbuff_head_cache",
+	struct kmem_cache_args skbuff_args = {
+		.useroffset	= offsetof(struct sk_buff, cb),
+		.usersize	= sizeof_field(struct sk_buff, cb),
+		/* skbs are often freed on another cpu than the one that
+		 * allocated them, e.g. RX on one cpu and consumption on
+		 * another.
+		 */
+		.sheaf_capacity	= 32,
+	};
+
+	net_hotdata.skbuff_cache = kmem_cache_create("skbuff_head_cache",
 					      sizeof(struct sk_buff),
-					      0,
+					      &skbuff_args,
 					      SLAB_HWCACHE_ALIGN|SLAB_PANIC|
-						FLAG_SKB_NO_MERGE,
-					      offsetof(struct sk_buff, cb),
-					      sizeof_field(struct sk_buff, cb),
-					      NULL);
+						FLAG_SKB_NO_MERGE);
 	net_hotdata.skbuff_fclone_cache = kmem_cache_create("skbuff_fclone_cache",
 						sizeof(struct sk_buff_fclones),
 						0,
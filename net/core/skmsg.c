@@ -515,7 +515,8 @@ static struct sk_msg *alloc_sk_msg(gfp_t gfp)
 }
 
 static struct sk_msg *sk_psock_create_ingress_msg(struct sock *sk,
-						  struct sk_buff *skb)
+						  struct sk_buff *skb,
+						  gfp_t gfp)
 {
 	if (atomic_read(&sk->sk_rmem_alloc) > sk->sk_rcvbuf)
 		return NULL;
@@ -523,7 +524,7 @@ static struct sk_msg *sk_psock_create_ingress_msg(struct sock *sk,
 	if (!sk_rmem_schedule(sk, skb, skb->truesize))
 		return NULL;
 
-	return alloc_sk_msg(GFP_KERNEL);
+	return alloc_sk_msg(gfp);
 }
 
 static int sk_psock_skb_ingress_enqueue(struct sk_buff *skb,
@@ -558,8 +559,8 @@ static int sk_psock_skb_ingress_enqueue(struct sk_buff *skb,
 	msg->sg.end = num_sge;
 	msg->skb = skb;
 
+	/* The caller wakes up the reader, possibly once for a batch. */
 	sk_psock_queue_msg(psock, msg);
-	sk_psock_data_ready(sk, psock);
 	return copied;
 }
 
@@ -567,7 +568,7 @@ static int sk_psock_skb_ingress_self(struct sk_psock *psock, struct sk_buff *skb
 				     u32 off, u32 len);
 
 static int sk_psock_skb_ingress(struct sk_psock *psock, struct sk_buff *skb,
-				u32 off, u32 len)
+				u32 off, u32 len, gfp_t gfp)
 {
 	struct sock *sk = psock->sk;
 	struct sk_msg *msg;
@@ -579,7 +580,7 @@ static int sk_psock_skb_ingress(struct sk_psock *psock, struct sk_buff *skb,
 	 */
 	if (unlikely(skb->sk == sk))
 		return sk_psock_skb_ingress_self(psock, skb, off, len);
-	msg = sk_psock_create_ingress_msg(sk, skb);
+	msg = sk_psock_create_ingress_msg(sk, skb, gfp);
 	if (!msg)
 		return -EAGAIN;
 
@@ -627,7 +628,7 @@ static int sk_psock_handle_skb(struct sk_psock *psock, struct sk_buff *skb,
 		return skb_send_sock(psock->sk, skb, off, len);
 	}
 	skb_get(skb);
-	err = sk_psock_skb_ingress(psock, skb, off, len);
+	err = sk_psock_skb_ingress(psock, skb, off, len, GFP_KERNEL);
 	if (err < 0)
 		kfree_skb(skb);
 	return err;
@@ -645,6 +646,23 @@ static void sk_psock_skb_state(struct sk_psock *psock,
 	spin_unlock_bh(&psock->ingress_lock);
 }
 
+/* Max skbs handled per backlog run before yielding the worker */
+#define SK_PSOCK_BACKLOG_BATCH	64
+
+/* Called with psock->ingress_lock held */
+static void sk_psock_backlog_queue(struct sk_psock *psock, struct sk_buff *skb)
+{
+	u32 qlen;
+
+	if (skb_queue_empty(&psock->ingress_skb))
+		psock->backlog_ts = ktime_get_ns();
+	skb_queue_tail(&psock->ingress_skb, skb);
+	qlen = skb_queue_len(&psock->ingress_skb);
+	if (qlen > psock->backlog_max)
+		WRITE_ONCE(psock->backlog_max, qlen);
+	schedule_delayed_work(&psock->work, 0);
+}
+
 static void sk_psock_backlog(struct work_struct *work)
 {
 	struct delayed_work *dwork = to_delayed_work(work);
@@ -652,7 +670,9 @@ static void sk_psock_backlog(struct work_struct *work)
 	struct sk_psock_work_state *state = &psock->work_state;
 	struct sk_buff *skb = NULL;
 	u32 len = 0, off = 0;
-	bool ingress;
+	unsigned int done = 0;
+	bool ingress, wake = false;
+	u64 ts;
 	int ret;
 
 	mutex_lock(&psock->work_mutex);
@@ -661,7 +681,22 @@ static void sk_psock_backlog(struct work_struct *work)
 		off = state->off;
 	}
 
+	spin_lock_bh(&psock->ingress_lock);
+	ts = psock->backlog_ts;
+	psock->backlog_ts = 0;
+	spin_unlock_bh(&psock->ingress_lock);
+	if (ts)
+		WRITE_ONCE(psock->backlog_delay_ns,
+			   psock->backlog_delay_ns + ktime_get_ns() - ts);
+	WRITE_ONCE(psock->backlog_runs, psock->backlog_runs + 1);
+
+	/* Readers are woken once for the whole run rather than per skb. */
 	while ((skb = skb_peek(&psock->ingress_skb))) {
+		if (done == SK_PSOCK_BACKLOG_BATCH) {
+			if (sk_psock_test_state(psock, SK_PSOCK_TX_ENABLED))
+				schedule_delayed_work(&psock->work, 0);
+			break;
+		}
 		len = skb->len;
 		off = 0;
 		if (skb_bpf_strparser(skb)) {
@@ -693,15 +728,20 @@ static void sk_psock_backlog(struct work_struct *work)
 				sk_psock_clear_state(psock, SK_PSOCK_TX_ENABLED);
 				goto end;
 			}
+			wake |= ingress;
 			off += ret;
 			len -= ret;
 		} while (len);
 
 		skb = skb_dequeue(&psock->ingress_skb);
 		kfree_skb(skb);
+		done++;
 	}
 end:
+	WRITE_ONCE(psock->backlog_skbs, psock->backlog_skbs + done);
 	mutex_unlock(&psock->work_mutex);
+	if (wake)
+		sk_psock_data_ready(psock->sk, psock);
 }
 
 struct sk_psock *sk_psock_init(struct sock *sk, int node)
@@ -909,10 +949,38 @@ int sk_psock_msg_verdict(struct sock *sk, struct sk_psock *psock,
 }
 EXPORT_SYMBOL_GPL(sk_psock_msg_verdict);
 
+/* Deliver a redirected skb straight to the target's ingress queue. */
+static int sk_psock_skb_redirect_direct(struct sk_psock *psock,
+					struct sk_buff *skb)
+{
+	u32 off = 0, len = skb->len;
+	int ret;
+
+	if (skb_bpf_strparser(skb)) {
+		struct strp_msg *stm = strp_msg(skb);
+
+		off = stm->offset;
+		len = stm->full_len;
+	}
+
+	skb_bpf_redirect_clear(skb);
+	ret = sk_psock_skb_ingress(psock, skb, off, len, GFP_ATOMIC);
+	if (ret < 0) {
+		/* Keep the direction for the backlog */
+		skb_bpf_set_ingress(skb);
+		return ret;
+	}
+
+	WRITE_ONCE(psock->redirect_direct, psock->redirect_direct + 1);
+	sk_psock_data_ready(psock->sk, psock);
+	return 0;
+}
+
 static int sk_psock_skb_redirect(struct sk_psock *from, struct sk_buff *skb)
 {
 	struct sk_psock *psock_other;
 	struct sock *sk_other;
+	bool direct;
 
 	sk_other = skb_bpf_redirect_fetch(skb);
 	/* This error is a buggy BPF program, it returned a redirect
@@ -941,8 +1009,30 @@ static int sk_psock_skb_redirect(struct sk_psock *from, struct sk_buff *skb)
 		return -EIO;
 	}
 
-	skb_queue_tail(&psock_other->ingress_skb, skb);
-	schedule_delayed_work(&psock_other->work, 0);
+	/* An ingress redirect to a socket last read on this CPU doesn't need
+	 * the workqueue hop, as long as nothing is queued ahead of it.
+	 */
+	direct = skb_bpf_ingress(skb) &&
+		 skb_queue_empty(&psock_other->ingress_skb) &&
+		 READ_ONCE(sk_other->sk_incoming_cpu) == raw_smp_processor_id();
+	if (!direct) {
+		sk_psock_backlog_queue(psock_other, skb);
+		spin_unlock_bh(&psock_other->ingress_lock);
+		return 0;
+	}
+	spin_unlock_bh(&psock_other->ingress_lock);
+
+	if (!sk_psock_skb_redirect_direct(psock_other, skb))
+		return 0;
+
+	spin_lock_bh(&psock_other->ingress_lock);
+	if (!sk_psock_test_state(psock_other, SK_PSOCK_TX_ENABLED)) {
+		spin_unlock_bh(&psock_other->ingress_lock);
+		skb_bpf_redirect_clear(skb);
+		sock_drop(from->sk, skb);
+		return -EIO;
+	}
+	sk_psock_backlog_queue(psock_other, skb);
 	spin_unlock_bh(&psock_other->ingress_lock);
 	return 0;
 }
@@ -1015,12 +1105,13 @@ static int sk_psock_verdict_apply(struct sk_psock *psock, struct sk_buff *skb,
 				len = stm->full_len;
 			}
 			err = sk_psock_skb_ingress_self(psock, skb, off, len);
+			if (err > 0)
+				sk_psock_data_ready(sk_other, psock);
 		}
 		if (err < 0) {
 			spin_lock_bh(&psock->ingress_lock);
 			if (sk_psock_test_state(psock, SK_PSOCK_TX_ENABLED)) {
-				skb_queue_tail(&psock->ingress_skb, skb);
-				schedule_delayed_work(&psock->work, 0);
+				sk_psock_backlog_queue(psock, skb);
 				err = 0;
 			}
 			spin_unlock_bh(&psock->ingress_lock);
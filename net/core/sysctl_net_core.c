@@ -28,6 +28,7 @@
 #include <net/rps.h>
 
 #include "dev.h"
+#include "page_pool_priv.h"
 
 static int int_3600 = 3600;
 static int min_sndbuf = SOCK_MIN_SNDBUF;
@@ -172,7 +173,8 @@ static int rps_sock_flow_sysctl(const struct ctl_table *table, int write,
 				mutex_unlock(&sock_flow_mutex);
 				return -EINVAL;
 			}
-			size = roundup_pow_of_two(size);
+			size = max_t(unsigned int, roundup_pow_of_two(size),
+				     RPS_SOCK_FLOW_WAYS);
 			if (size != orig_size) {
 				sock_table =
 				    vmalloc(RPS_SOCK_FLOW_TABLE_SIZE(size));
@@ -615,6 +617,15 @@ static struct ctl_table net_core_table[] = {
 		.mode		= 0644,
 		.proc_handler	= proc_do_static_key,
 	},
+#ifdef CONFIG_PAGE_POOL
+	{
+		.procname	= "page_pool_remote_recycle",
+		.data		= &page_pool_remote_recycle.key,
+		.maxlen		= sizeof(page_pool_remote_recycle),
+		.mode		= 0644,
+		.proc_handler	= proc_do_static_key,
+	},
+#endif
 	{
 		.procname	= "gro_normal_batch",
 		.data		= &net_hotdata.gro_normal_batch,
@@ -140,6 +140,9 @@ void inet_sock_destruct(struct sock *sk)
 
 	sk_mem_reclaim_final(sk);
 
+	if (inet_test_bit(IS_ICSK, sk))
+		reqsk_queue_free_shards(&inet_csk(sk)->icsk_accept_queue);
+
 	if (sk->sk_type == SOCK_STREAM && sk->sk_state != TCP_CLOSE) {
 		pr_err("Attempt to release TCP socket in state %d %p\n",
 		       sk->sk_state, sk);
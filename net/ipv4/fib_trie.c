@@ -61,6 +61,8 @@
 #include <linux/export.h>
 #include <linux/vmalloc.h>
 #include <linux/notifier.h>
+#include <linux/hash.h>
+#include <linux/jump_label.h>
 #include <net/net_namespace.h>
 #include <net/inet_dscp.h>
 #include <net/ip.h>
@@ -151,6 +153,8 @@ struct trie_use_stats {
 	unsigned int semantic_match_miss;
 	unsigned int null_node_hit;
 	unsigned int resize_node_skipped;
+	unsigned int cache_hits;
+	unsigned int cache_misses;
 };
 #endif
 
@@ -164,11 +168,35 @@ struct trie_stat {
 	unsigned int nodesizes[MAX_STAT_DEPTH];
 };
 
+#ifdef CONFIG_IP_FIB_TRIE_CACHE
+#define FIB_CACHE_BITS	7
+#define FIB_CACHE_SIZE	(1U << FIB_CACHE_BITS)
+
+/* One remembered result of fib_table_lookup() and the flow it was for */
+struct fib_cache_entry {
+	u64			gen;
+	__be32			daddr;
+	int			oif;
+	int			flags;
+	dscp_t			dscp;
+	u8			scope;
+	struct fib_table	*tb;
+	struct fib_result	res;
+};
+
+struct fib_cache {
+	struct fib_cache_entry	ent[FIB_CACHE_SIZE];
+};
+#endif
+
 struct trie {
 	struct key_vector kv[1];
 #ifdef CONFIG_IP_FIB_TRIE_STATS
 	struct trie_use_stats __percpu *stats;
 #endif
+#ifdef CONFIG_IP_FIB_TRIE_CACHE
+	struct fib_cache __percpu *cache;
+#endif
 };
 
 static struct key_vector *resize(struct trie *t, struct key_vector *tn);
@@ -199,6 +227,83 @@ static inline struct tnode *tn_info(struct key_vector *kv)
 #define node_parent_rcu(tn) rcu_dereference_rtnl(tn_info(tn)->parent)
 #define get_child_rcu(tn, i) rcu_dereference_rtnl((tn)->tnode[i])
 
+#ifdef CONFIG_IP_FIB_TRIE_CACHE
+/*
+ * Per-CPU, direct mapped cache of lookup results in front of the trie walk.
+ *
+ * Any change that could alter the result of a lookup, in any table, bumps
+ * fib_cache_gen: route insertion, deletion and flushes, and every
+ * rt_cache_flush() for nexthop and device state changes. An entry is only
+ * used while its generation is current, so it never outlives the fib_info
+ * and leaf it points to. The generation is 64 bits wide so that it can't
+ * wrap back to the value of a stale entry.
+ */
+DEFINE_STATIC_KEY_FALSE(fib_lookup_cache);
+static atomic64_t fib_cache_gen = ATOMIC64_INIT(1);
+
+void fib_lookup_cache_invalidate(void)
+{
+	/* Paired with atomic64_read_acquire() in fib_table_lookup() */
+	smp_mb__before_atomic();
+	atomic64_inc(&fib_cache_gen);
+}
+
+/*
+ * Entries are only read and written from softirq context, so nothing else on
+ * this CPU can run on the same slot while it is in use. Process context
+ * lookups always walk the trie.
+ */
+static bool fib_cache_usable(const struct trie *t)
+{
+	return static_branch_unlikely(&fib_lookup_cache) && t->cache &&
+	       in_serving_softirq();
+}
+
+static struct fib_cache_entry *fib_cache_slot(struct trie *t,
+					      const struct flowi4 *flp)
+{
+	u32 hash = hash_32((__force u32)flp->daddr ^ flp->flowi4_oif,
+			   FIB_CACHE_BITS);
+
+	return &this_cpu_ptr(t->cache)->ent[hash];
+}
+
+static bool fib_cache_lookup(struct trie *t, struct fib_table *tb,
+			     const struct flowi4 *flp, struct fib_result *res,
+			     int fib_flags, u64 gen)
+{
+	const struct fib_cache_entry *e = fib_cache_slot(t, flp);
+
+	if (e->gen != gen || e->tb != tb || e->daddr != flp->daddr ||
+	    e->oif != flp->flowi4_oif || e->dscp != flp->flowi4_dscp ||
+	    e->scope != flp->flowi4_scope ||
+	    e->flags != (fib_flags & ~FIB_LOOKUP_NOREF))
+		return false;
+
+	*res = e->res;
+	if (!(fib_flags & FIB_LOOKUP_NOREF))
+		refcount_inc(&res->fi->fib_clntref);
+	return true;
+}
+
+static void fib_cache_store(struct trie *t, struct fib_table *tb,
+			    const struct flowi4 *flp,
+			    const struct fib_result *res, int fib_flags,
+			    u64 gen)
+{
+	struct fib_cache_entry *e = fib_cache_slot(t, flp);
+
+	e->gen = gen;
+	e->tb = tb;
+	e->daddr = flp->daddr;
+	e->oif = flp->flowi4_oif;
+	e->dscp = flp->flowi4_dscp;
+	e->scope = flp->flowi4_scope;
+	e->flags = fib_flags & ~FIB_LOOKUP_NOREF;
+	e->res = *res;
+}
+#endif
+
 /* wrapper for rcu_assign_pointer */
 static inline void node_set_parent(struct key_vector *n, struct key_vector *tp)
 {
@@ -1429,6 +1534,9 @@ int fib_table_lookup(struct fib_table *tb, const struct flowi4 *flp,
 	struct fib_alias *fa;
 	unsigned long index;
 	t_key cindex;
+#ifdef CONFIG_IP_FIB_TRIE_CACHE
+	u64 cache_gen = 0;
+#endif
 
 	pn = t->kv;
 	cindex = 0;
@@ -1443,6 +1551,25 @@ int fib_table_lookup(struct fib_table *tb, const struct flowi4 *flp,
 	this_cpu_inc(stats->gets);
 #endif
 
+#ifdef CONFIG_IP_FIB_TRIE_CACHE
+	if (fib_cache_usable(t)) {
+		/* Paired with fib_lookup_cache_invalidate(), taken before the
+		 * walk so a result stored below is never newer than its gen.
+		 */
+		cache_gen = atomic64_read_acquire(&fib_cache_gen);
+		if (fib_cache_lookup(t, tb, flp, res, fib_flags, cache_gen)) {
+#ifdef CONFIG_IP_FIB_TRIE_STATS
+			this_cpu_inc(stats->cache_hits);
+#endif
+			trace_fib_table_lookup(tb->tb_id, flp, res->nhc, 0);
+			return 0;
+		}
+#ifdef CONFIG_IP_FIB_TRIE_STATS
+		this_cpu_inc(stats->cache_misses);
+#endif
+	}
+#endif
+
 	/* Step 1: Travel to the longest prefix match in the trie */
 	for (;;) {
 		index = get_cindex(key, n);
@@ -1607,6 +1734,11 @@ int fib_table_lookup(struct fib_table *tb, const struct flowi4 *flp,
 			res->fi = fi;
 			res->table = tb;
 			res->fa_head = &n->leaf;
+#ifdef CONFIG_IP_FIB_TRIE_CACHE
+			if (cache_gen && !err)
+				fib_cache_store(t, tb, flp, res, fib_flags,
+						cache_gen);
+#endif
 #ifdef CONFIG_IP_FIB_TRIE_STATS
 			this_cpu_inc(stats->semantic_match_passed);
 #endif
@@ -1632,6 +1764,7 @@ static void fib_remove_alias(struct trie *t, struct key_vector *tp,
 
 	/* remove the fib_alias from the list */
 	hlist_del_rcu(&old->fa_list);
+	fib_lookup_cache_invalidate();
 
 	/* if we emptied the list this leaf will be freed and we can sort
 	 * out parent suffix lengths as a part of trie_rebalance
@@ -1865,6 +1998,9 @@ static void fib_trie_free(struct fib_table *tb)
 
 #ifdef CONFIG_IP_FIB_TRIE_STATS
 	free_percpu(t->stats);
+#endif
+#ifdef CONFIG_IP_FIB_TRIE_CACHE
+	free_percpu(t->cache);
 #endif
 	kfree(tb);
 }
@@ -1978,6 +2114,7 @@ void fib_table_flush_external(struct fib_table *tb)
 			 */
 			if (tb->tb_id != fa->tb_id) {
 				hlist_del_rcu(&fa->fa_list);
+				fib_lookup_cache_invalidate();
 				alias_free_mem_rcu(fa);
 				continue;
 			}
@@ -2067,6 +2204,7 @@ int fib_table_flush(struct net *net, struct fib_table *tb, bool flush_all)
 				rtmsg_fib(RTM_DELROUTE, htonl(n->key), fa,
 					  KEYLENGTH - fa->fa_slen, tb->tb_id, &info, 0);
 			hlist_del_rcu(&fa->fa_list);
+			fib_lookup_cache_invalidate();
 			fib_release_info(fa->fa_info);
 			alias_free_mem_rcu(fa);
 			found++;
@@ -2224,12 +2362,16 @@ int fib_notify(struct net *net, struct notifier_block *nb,
 static void __trie_free_rcu(struct rcu_head *head)
 {
 	struct fib_table *tb = container_of(head, struct fib_table, rcu);
-#ifdef CONFIG_IP_FIB_TRIE_STATS
-	struct trie *t = (struct trie *)tb->tb_data;
+	struct trie *t __maybe_unused = (struct trie *)tb->tb_data;
 
-	if (tb->tb_data == tb->__data)
+	if (tb->tb_data == tb->__data) {
+#ifdef CONFIG_IP_FIB_TRIE_STATS
 		free_percpu(t->stats);
-#endif /* CONFIG_IP_FIB_TRIE_STATS */
+#endif
+#ifdef CONFIG_IP_FIB_TRIE_CACHE
+		free_percpu(t->cache);
+#endif
+	}
 	kfree(tb);
 }
 
@@ -2407,9 +2549,13 @@ struct fib_table *fib_trie_table(u32 id, struct fib_table *alias)
 	t->stats = alloc_percpu(struct trie_use_stats);
 	if (!t->stats) {
 		kfree(tb);
-		tb = NULL;
+		return NULL;
 	}
 #endif
+#ifdef CONFIG_IP_FIB_TRIE_CACHE
+	/* Lookups simply bypass the cache if this fails */
+	t->cache = alloc_percpu_gfp(struct fib_cache, GFP_KERNEL | __GFP_NOWARN);
+#endif
 
 	return tb;
 }
@@ -2582,6 +2728,8 @@ static void trie_show_usage(struct seq_file *seq,
 		s.semantic_match_miss += pcpu->semantic_match_miss;
 		s.null_node_hit += pcpu->null_node_hit;
 		s.resize_node_skipped += pcpu->resize_node_skipped;
+		s.cache_hits += pcpu->cache_hits;
+		s.cache_misses += pcpu->cache_misses;
 	}
 
 	seq_printf(seq, "\nCounters:\n---------\n");
@@ -2591,7 +2739,9 @@ static void trie_show_usage(struct seq_file *seq,
 		   s.semantic_match_passed);
 	seq_printf(seq, "semantic match miss = %u\n", s.semantic_match_miss);
 	seq_printf(seq, "null node hit= %u\n", s.null_node_hit);
-	seq_printf(seq, "skipped node resize = %u\n\n", s.resize_node_skipped);
+	seq_printf(seq, "skipped node resize = %u\n", s.resize_node_skipped);
+	seq_printf(seq, "cache hits = %u\n", s.cache_hits);
+	seq_printf(seq, "cache misses = %u\n\n", s.cache_misses);
 }
 #endif /*  CONFIG_IP_FIB_TRIE_STATS */
 
@@ -663,33 +663,44 @@ struct sock *inet_csk_accept(struct sock *sk, struct proto_accept_arg *arg)
 {
 	struct inet_connection_sock *icsk = inet_csk(sk);
 	struct request_sock_queue *queue = &icsk->icsk_accept_queue;
-	struct request_sock *req;
+	struct request_sock *req = NULL;
+	bool locked = false;
 	struct sock *newsk;
 	int error;
 
-	lock_sock(sk);
-
-	/* We need to make sure that this socket is listening,
-	 * and that it has something pending.
+	/* A sharded queue can be drained without the listener lock, which
+	 * is then only needed to sleep for a connection.
 	 */
-	error = -EINVAL;
-	if (sk->sk_state != TCP_LISTEN)
-		goto out_err;
+	if (queue->shards && READ_ONCE(sk->sk_state) == TCP_LISTEN)
+		req = reqsk_queue_remove(queue, sk);
 
-	/* Find already established connection */
-	if (reqsk_queue_empty(queue)) {
+	if (!req) {
 		long timeo = sock_rcvtimeo(sk, arg->flags & O_NONBLOCK);
 
-		/* If this is a non blocking socket don't sleep */
-		error = -EAGAIN;
-		if (!timeo)
-			goto out_err;
+		lock_sock(sk);
+		locked = true;
 
-		error = inet_csk_wait_for_connect(sk, timeo);
-		if (error)
+		/* We need to make sure that this socket is listening,
+		 * and that it has something pending.
+		 */
+		error = -EINVAL;
+		if (sk->sk_state != TCP_LISTEN)
 			goto out_err;
+
+		/* Find already established connection. With shards a
+		 * lockless accept() may take it first, so wait again.
+		 */
+		while (!(req = reqsk_queue_remove(queue, sk))) {
+			/* If this is a non blocking socket don't sleep */
+			error = -EAGAIN;
+			if (!timeo)
+				goto out_err;
+
+			error = inet_csk_wait_for_connect(sk, timeo);
+			if (error)
+				goto out_err;
+		}
 	}
-	req = reqsk_queue_remove(queue, sk);
 	arg->is_empty = reqsk_queue_empty(queue);
 	newsk = req->sk;
 
@@ -710,7 +721,8 @@ struct sock *inet_csk_accept(struct sock *sk, struct proto_accept_arg *arg)
 	}
 
 out:
-	release_sock(sk);
+	if (locked)
+		release_sock(sk);
 	if (newsk && mem_cgroup_sockets_enabled) {
 		gfp_t gfp = GFP_KERNEL | __GFP_NOFAIL;
 		int amt = 0;
@@ -1248,6 +1260,7 @@ struct sock *inet_csk_clone_lock(const struct sock *sk,
 
 	newicsk->icsk_bind_hash = NULL;
 	newicsk->icsk_bind2_hash = NULL;
+	newicsk->icsk_accept_queue.shards = NULL;
 
 	newinet->inet_dport = ireq->ir_rmt_port;
 	newinet->inet_num = ireq->ir_num;
@@ -1412,6 +1425,21 @@ struct sock *inet_csk_reqsk_queue_add(struct sock *sk,
 {
 	struct request_sock_queue *queue = &inet_csk(sk)->icsk_accept_queue;
 
+	if (queue->shards) {
+		struct reqsk_accept_shard *shard = this_cpu_ptr(queue->shards);
+
+		spin_lock(&shard->lock);
+		if (unlikely(sk->sk_state != TCP_LISTEN)) {
+			inet_child_forget(sk, req, child);
+			child = NULL;
+		} else {
+			req->sk = child;
+			reqsk_queue_add_sharded(queue, sk, req);
+		}
+		spin_unlock(&shard->lock);
+		return child;
+	}
+
 	spin_lock(&queue->rskq_lock);
 	if (unlikely(sk->sk_state != TCP_LISTEN)) {
 		inet_child_forget(sk, req, child);
@@ -1495,10 +1523,21 @@ void inet_csk_listen_stop(struct sock *sk)
 	 * To be honest, we are not able to make either
 	 * of the variants now.			--ANK
 	 */
-	while ((req = reqsk_queue_remove(queue, sk)) != NULL) {
-		struct sock *child = req->sk, *nsk;
+	if (queue->shards)
+		reqsk_queue_quiesce_shards(queue);
+
+	while ((req = reqsk_queue_remove(queue, sk)) != NULL ||
+	       !reqsk_queue_empty(queue)) {
+		struct sock *child, *nsk;
 		struct request_sock *nreq;
 
+		/* A sharded queue can lose a race with lockless accept() */
+		if (!req) {
+			cond_resched();
+			continue;
+		}
+		child = req->sk;
+
 		local_bh_disable();
 		bh_lock_sock(child);
 		WARN_ON(sock_owned_by_user(child));
@@ -1549,6 +1588,8 @@ void inet_csk_listen_stop(struct sock *sk)
 			req = next;
 		}
 	}
+	if (queue->shards)
+		reqsk_queue_sync_backlog(queue, sk);
 	WARN_ON_ONCE(sk->sk_ack_backlog);
 }
 EXPORT_SYMBOL_GPL(inet_csk_listen_stop);
@@ -24,6 +24,7 @@
 #include <net/inet_timewait_sock.h>
 #include <net/inet6_hashtables.h>
 #include <net/bpf_sk_storage.h>
+#include <linux/skmsg.h>
 #include <net/netlink.h>
 
 #include <linux/inet.h>
@@ -118,10 +119,66 @@ static size_t inet_sk_attr_size(struct sock *sk,
 		+ nla_total_size(SK_MEMINFO_VARS * sizeof(u32))
 		+ nla_total_size(TCP_CA_NAME_MAX)
 		+ nla_total_size(sizeof(struct tcpvegas_info))
+		+ (sk->sk_state == TCP_LISTEN ?
+		   nla_total_size(nr_cpu_ids * sizeof(u32)) : 0)
+						     /* INET_DIAG_ACCEPTQ_SHARDS */
 		+ aux
 		+ 64;
 }
 
+#ifdef CONFIG_NET_SOCK_MSG
+static int inet_diag_psock_fill(struct sock *sk, struct sk_buff *skb)
+{
+	struct inet_diag_psock info;
+	struct sk_psock *psock;
+
+	rcu_read_lock();
+	psock = sk_psock(sk);
+	if (!psock) {
+		rcu_read_unlock();
+		return 0;
+	}
+
+	memset(&info, 0, sizeof(info));
+	info.psock_backlog_skbs = READ_ONCE(psock->backlog_skbs);
+	info.psock_backlog_runs = READ_ONCE(psock->backlog_runs);
+	info.psock_backlog_delay_ns = READ_ONCE(psock->backlog_delay_ns);
+	info.psock_redirect_direct = READ_ONCE(psock->redirect_direct);
+	info.psock_backlog_len = skb_queue_len_lockless(&psock->ingress_skb);
+	info.psock_backlog_max = READ_ONCE(psock->backlog_max);
+	rcu_read_unlock();
+
+	return nla_put(skb, INET_DIAG_PSOCK, sizeof(info), &info);
+}
+#endif
+
+static int inet_diag_acceptq_shards_fill(struct sock *sk, struct sk_buff *skb)
+{
+	struct reqsk_accept_shard __percpu *shards;
+	struct nlattr *attr;
+	u32 *depth;
+	int cpu;
+
+	if (sk->sk_state != TCP_LISTEN || !inet_test_bit(IS_ICSK, sk))
+		return 0;
+
+	shards = READ_ONCE(inet_csk(sk)->icsk_accept_queue.shards);
+	if (!shards)
+		return 0;
+
+	attr = nla_reserve(skb, INET_DIAG_ACCEPTQ_SHARDS,
+			   nr_cpu_ids * sizeof(u32));
+	if (!attr)
+		return -EMSGSIZE;
+
+	depth = nla_data(attr);
+	memset(depth, 0, nr_cpu_ids * sizeof(u32));
+	for_each_possible_cpu(cpu)
+		depth[cpu] = READ_ONCE(per_cpu_ptr(shards, cpu)->qlen);
+
+	return 0;
+}
+
 int inet_diag_msg_attrs_fill(struct sock *sk, struct sk_buff *skb,
 			     struct inet_diag_msg *r, int ext,
 			     struct user_namespace *user_ns,
@@ -200,6 +257,14 @@ int inet_diag_msg_attrs_fill(struct sock *sk, struct sk_buff *skb,
 		    &inet_sockopt))
 		goto errout;
 
+#ifdef CONFIG_NET_SOCK_MSG
+	if (inet_diag_psock_fill(sk, skb))
+		goto errout;
+#endif
+
+	if (inet_diag_acceptq_shards_fill(sk, skb))
+		goto errout;
+
 	return 0;
 errout:
 	return 1;
@@ -127,6 +127,18 @@ void inet_frags_fini(struct inet_frags *f)
 }
 EXPORT_SYMBOL(inet_frags_fini);
 
+/* Evict at most this many queues per inet_frag_find() over high_thresh */
+#define INET_FRAG_EVICT_MAX	32
+
+static void inet_frag_lru_del(struct inet_frag_queue *fq)
+{
+	struct fqdir *fqdir = fq->fqdir;
+
+	spin_lock_bh(&fqdir->lru_lock);
+	list_del_init(&fq->lru);
+	spin_unlock_bh(&fqdir->lru_lock);
+}
+
 /* called from rhashtable_free_and_destroy() at netns_frags dismantle */
 static void inet_frags_free_cb(void *ptr, void *arg)
 {
@@ -134,6 +146,7 @@ static void inet_frags_free_cb(void *ptr, void *arg)
 	int count;
 
 	count = timer_delete_sync(&fq->timer) ? 1 : 0;
+	inet_frag_lru_del(fq);
 
 	spin_lock_bh(&fq->lock);
 	fq->flags |= INET_FRAG_DROP;
@@ -195,6 +208,8 @@ int fqdir_init(struct fqdir **fqdirp, struct inet_frags *f, struct net *net)
 		return -ENOMEM;
 	fqdir->f = f;
 	fqdir->net = net;
+	spin_lock_init(&fqdir->lru_lock);
+	INIT_LIST_HEAD(&fqdir->lru_list);
 	res = rhashtable_init(&fqdir->rhashtable, &fqdir->f->rhash_params);
 	if (res < 0) {
 		kfree(fqdir);
@@ -234,6 +249,7 @@ void inet_frag_kill(struct inet_frag_queue *fq, int *refs)
 		struct fqdir *fqdir = fq->fqdir;
 
 		fq->flags |= INET_FRAG_COMPLETE;
+		inet_frag_lru_del(fq);
 		rcu_read_lock();
 		/* The RCU read lock provides a memory barrier
 		 * guaranteeing that if fqdir->dead is false then
@@ -322,6 +338,7 @@ static struct inet_frag_queue *inet_frag_alloc(struct fqdir *fqdir,
 		return NULL;
 
 	q->fqdir = fqdir;
+	INIT_LIST_HEAD(&q->lru);
 	f->constructor(q, arg);
 	add_frag_mem_limit(fqdir, f->qsize);
 
@@ -361,18 +378,77 @@ static struct inet_frag_queue *inet_frag_create(struct fqdir *fqdir,
 		inet_frag_putn(q, refs);
 		return NULL;
 	}
+
+	/* Only once hashed, so the evictor never kills a queue we are still
+	 * inserting. Another CPU may already have found and killed it; its
+	 * inet_frag_kill() runs under q->lock, so COMPLETE is stable here.
+	 */
+	spin_lock_bh(&q->lock);
+	if (!(q->flags & INET_FRAG_COMPLETE)) {
+		spin_lock(&fqdir->lru_lock);
+		list_add_tail(&q->lru, &fqdir->lru_list);
+		spin_unlock(&fqdir->lru_lock);
+	}
+	spin_unlock_bh(&q->lock);
 	return q;
 }
 
+/*
+ * Drop the oldest queues until memory usage is back under low_thresh, so a
+ * flood of fragments that never complete can't lock out new datagrams until
+ * the reassembly timeout expires.
+ */
+static void inet_frag_evict(struct fqdir *fqdir)
+{
+	long low_thresh = READ_ONCE(fqdir->low_thresh);
+	int budget = INET_FRAG_EVICT_MAX;
+
+	while (budget-- && frag_mem_limit(fqdir) > low_thresh) {
+		struct inet_frag_queue *fq;
+		unsigned long age;
+		int refs = 1;
+
+		spin_lock_bh(&fqdir->lru_lock);
+		fq = list_first_entry_or_null(&fqdir->lru_list,
+					      struct inet_frag_queue, lru);
+		if (fq && refcount_inc_not_zero(&fq->refcnt))
+			list_del_init(&fq->lru);
+		else
+			fq = NULL;
+		spin_unlock_bh(&fqdir->lru_lock);
+		if (!fq)
+			break;
+
+		spin_lock_bh(&fq->lock);
+		if (!(fq->flags & INET_FRAG_COMPLETE)) {
+			/* The timer is only armed at creation and reinit */
+			age = jiffies - (fq->timer.expires - fqdir->timeout);
+			fq->flags |= INET_FRAG_DROP;
+			inet_frag_kill(fq, &refs);
+			NET_INC_STATS(fqdir->net, LINUX_MIB_FRAGEVICTED);
+			NET_ADD_STATS(fqdir->net, LINUX_MIB_FRAGEVICTEDAGEMSECS,
+				      jiffies_to_msecs(age));
+		}
+		spin_unlock_bh(&fq->lock);
+		inet_frag_putn(fq, refs);
+	}
+}
+
 struct inet_frag_queue *inet_frag_find(struct fqdir *fqdir, void *key)
 {
 	/* This pairs with WRITE_ONCE() in fqdir_pre_exit(). */
 	long high_thresh = READ_ONCE(fqdir->high_thresh);
 	struct inet_frag_queue *fq = NULL, *prev;
 
-	if (!high_thresh || frag_mem_limit(fqdir) > high_thresh)
+	if (!high_thresh)
 		return NULL;
 
+	if (frag_mem_limit(fqdir) > high_thresh) {
+		inet_frag_evict(fqdir);
+		if (frag_mem_limit(fqdir) > high_thresh)
+			return NULL;
+	}
+
 	prev = rhashtable_lookup(&fqdir->rhashtable, key, fqdir->f->rhash_params);
 	if (!prev)
 		fq = inet_frag_create(fqdir, key, &prev);
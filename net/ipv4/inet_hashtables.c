@@ -1020,6 +1020,7 @@ int __inet_hash_connect(struct inet_timewait_death_row *death_row,
 	struct inet_bind_bucket *tb;
 	bool tb_created = false;
 	u32 remaining, offset;
+	u32 probes = 0;
 	int ret, i, low, high;
 	bool local_ports;
 	int step, l3mdev;
@@ -1062,6 +1063,7 @@ int __inet_hash_connect(struct inet_timewait_death_row *death_row,
 			port -= remaining;
 		if (inet_is_local_reserved_port(net, port))
 			continue;
+		probes++;
 		head = &hinfo->bhash[inet_bhashfn(net, port,
 						  hinfo->bhash_size)];
 		rcu_read_lock();
@@ -1120,6 +1122,8 @@ int __inet_hash_connect(struct inet_timewait_death_row *death_row,
 		if ((offset & 1) && remaining > 1)
 			goto other_parity_scan;
 	}
+	NET_ADD_STATS(net, LINUX_MIB_EPHEMERALPORTPROBES, probes);
+	NET_INC_STATS(net, LINUX_MIB_EPHEMERALPORTEXHAUSTED);
 	return -EADDRNOTAVAIL;
 
 ok:
@@ -1145,6 +1149,9 @@ int __inet_hash_connect(struct inet_timewait_death_row *death_row,
 	i = max_t(int, i, get_random_u32_below(8) * step);
 	WRITE_ONCE(table_perturb[index], READ_ONCE(table_perturb[index]) + i + step);
 
+	__NET_INC_STATS(net, LINUX_MIB_EPHEMERALPORTCONNECTS);
+	__NET_ADD_STATS(net, LINUX_MIB_EPHEMERALPORTPROBES, probes);
+
 	/* Head lock still held and bh's disabled */
 	inet_bind_hash(sk, tb, tb2, port);
 
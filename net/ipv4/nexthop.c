@@ -26,6 +26,8 @@ static void remove_nexthop(struct net *net, struct nexthop *nh,
 #define NH_DEV_HASHBITS  8
 #define NH_DEV_HASHSIZE (1U << NH_DEV_HASHBITS)
 
+#define NH_HTHR_MAP_MAX		4096
+
 #define NHA_OP_FLAGS_DUMP_ALL (NHA_OP_FLAG_DUMP_STATS |		\
 			       NHA_OP_FLAG_DUMP_HW_STATS)
 
@@ -498,7 +500,9 @@ static void nexthop_free_group(struct nexthop *nh)
 	if (nhg->resilient)
 		vfree(rcu_dereference_raw(nhg->res_table));
 
+	kfree(nhg->spare->hthr_map);
 	kfree(nhg->spare);
+	kfree(nhg->hthr_map);
 	kfree(nhg);
 }
 
@@ -1410,11 +1414,25 @@ static bool nexthop_is_good_nh(const struct nexthop *nh)
 	return false;
 }
 
+/* First entry whose upper bound may cover @hash, see nh_hthr_group_map() */
+static int nh_hthr_first_entry(const struct nh_group *nhg, int hash)
+{
+	u8 shift;
+	int i;
+
+	if (!nhg->hthr_map)
+		return 0;
+
+	shift = READ_ONCE(nhg->hthr_map_shift);
+	i = READ_ONCE(nhg->hthr_map[(u32)hash >> shift]);
+	return i < nhg->num_nh ? i : 0;
+}
+
 static struct nexthop *nexthop_select_path_fdb(struct nh_group *nhg, int hash)
 {
 	int i;
 
-	for (i = 0; i < nhg->num_nh; i++) {
+	for (i = nh_hthr_first_entry(nhg, hash); i < nhg->num_nh; i++) {
 		struct nh_grp_entry *nhge = &nhg->nh_entries[i];
 
 		if (hash > atomic_read(&nhge->hthr.upper_bound))
@@ -1431,12 +1449,13 @@ static struct nexthop *nexthop_select_path_fdb(struct nh_group *nhg, int hash)
 static struct nexthop *nexthop_select_path_hthr(struct nh_group *nhg, int hash)
 {
 	struct nh_grp_entry *nhge0 = NULL;
-	int i;
+	int first, i;
 
 	if (nhg->fdb_nh)
 		return nexthop_select_path_fdb(nhg, hash);
 
-	for (i = 0; i < nhg->num_nh; ++i) {
+	first = nh_hthr_first_entry(nhg, hash);
+	for (i = first; i < nhg->num_nh; ++i) {
 		struct nh_grp_entry *nhge = &nhg->nh_entries[i];
 
 		/* nexthops always check if it is good and does
@@ -1455,6 +1474,14 @@ static struct nexthop *nexthop_select_path_hthr(struct nh_group *nhg, int hash)
 		return nhge->nh;
 	}
 
+	/* The fallback is the first good entry of the whole group */
+	for (i = 0; i < first; ++i) {
+		if (nexthop_is_good_nh(nhg->nh_entries[i].nh)) {
+			nhge0 = &nhg->nh_entries[i];
+			break;
+		}
+	}
+
 	if (!nhge0)
 		nhge0 = &nhg->nh_entries[0];
 	nh_grp_entry_stats_inc(nhge0);
@@ -1985,6 +2012,44 @@ static void replace_nexthop_grp_res(struct nh_group *oldg,
 	nh_res_table_upkeep(old_res_table, true, false);
 }
 
+/* Slots in the hash-threshold map of a group with @num_nh entries */
+static u32 nh_hthr_map_slots(u16 num_nh)
+{
+	return min_t(u32, roundup_pow_of_two(num_nh) * 4, NH_HTHR_MAP_MAX);
+}
+
+static u16 *nh_hthr_map_alloc(u16 num_nh)
+{
+	return kcalloc(nh_hthr_map_slots(num_nh), sizeof(u16), GFP_KERNEL);
+}
+
+/*
+ * Split the 31 bit hash space into equal ranges and record for each the
+ * first entry whose upper bound reaches into it, so that path selection
+ * starts its walk there instead of at the head of the group. Readers may
+ * still be walking a spare group while it is rebuilt, hence WRITE_ONCE().
+ */
+static void nh_hthr_group_map(struct nh_group *nhg)
+{
+	u32 slots = nh_hthr_map_slots(nhg->num_nh);
+	u8 shift = 31 - ilog2(slots);
+	u32 s;
+	int i = 0;
+
+	if (!nhg->hthr_map)
+		return;
+
+	WRITE_ONCE(nhg->hthr_map_shift, shift);
+	for (s = 0; s < slots; s++) {
+		u32 start = s << shift;
+
+		while (i < nhg->num_nh - 1 &&
+		       start > atomic_read(&nhg->nh_entries[i].hthr.upper_bound))
+			i++;
+		WRITE_ONCE(nhg->hthr_map[s], i);
+	}
+}
+
 static void nh_hthr_group_rebalance(struct nh_group *nhg)
 {
 	u32 total = 0;
@@ -2002,6 +2067,8 @@ static void nh_hthr_group_rebalance(struct nh_group *nhg)
 		upper_bound = DIV_ROUND_CLOSEST_ULL((u64)w << 31, total) - 1;
 		atomic_set(&nhge->hthr.upper_bound, upper_bound);
 	}
+
+	nh_hthr_group_map(nhg);
 }
 
 static void remove_nh_grp_entry(struct net *net, struct nh_grp_entry *nhge,
@@ -2742,6 +2809,15 @@ static struct nexthop *nexthop_create_group(struct net *net,
 	}
 
 	if (cfg->nh_grp_type == NEXTHOP_GRP_TYPE_MPATH) {
+		/* Without the map selection just walks from the first entry */
+		nhg->hthr_map = nh_hthr_map_alloc(num_nh);
+		if (nhg->hthr_map) {
+			nhg->spare->hthr_map = nh_hthr_map_alloc(num_nh);
+			if (!nhg->spare->hthr_map) {
+				kfree(nhg->hthr_map);
+				nhg->hthr_map = NULL;
+			}
+		}
 		nhg->hash_threshold = 1;
 		nhg->is_multipath = true;
 	} else if (cfg->nh_grp_type == NEXTHOP_GRP_TYPE_RES) {
@@ -2781,7 +2857,9 @@ static struct nexthop *nexthop_create_group(struct net *net,
 		nexthop_put(nhg->nh_entries[i].nh);
 	}
 
+	kfree(nhg->spare->hthr_map);
 	kfree(nhg->spare);
+	kfree(nhg->hthr_map);
 	kfree(nhg);
 	kfree(nh);
 
@@ -307,6 +307,21 @@ static const struct snmp_mib snmp4_net_list[] = {
 	SNMP_MIB_ITEM("TCPAOKeyNotFound", LINUX_MIB_TCPAOKEYNOTFOUND),
 	SNMP_MIB_ITEM("TCPAOGood", LINUX_MIB_TCPAOGOOD),
 	SNMP_MIB_ITEM("TCPAODroppedIcmps", LINUX_MIB_TCPAODROPPEDICMPS),
+	SNMP_MIB_ITEM("TCPSackScoreboardAcks", LINUX_MIB_TCPSACKSCOREBOARDACKS),
+	SNMP_MIB_ITEM("TCPSackScoreboardOps", LINUX_MIB_TCPSACKSCOREBOARDOPS),
+	SNMP_MIB_ITEM("TCPGROAckCoalesce", LINUX_MIB_TCPGROACKCOALESCE),
+	SNMP_MIB_ITEM("EphemeralPortConnects", LINUX_MIB_EPHEMERALPORTCONNECTS),
+	SNMP_MIB_ITEM("EphemeralPortProbes", LINUX_MIB_EPHEMERALPORTPROBES),
+	SNMP_MIB_ITEM("EphemeralPortExhausted", LINUX_MIB_EPHEMERALPORTEXHAUSTED),
+	SNMP_MIB_ITEM("UDPReaderSplices", LINUX_MIB_UDPREADERSPLICES),
+	SNMP_MIB_ITEM("UDPReaderSplicedPkts", LINUX_MIB_UDPREADERSPLICEDPKTS),
+	SNMP_MIB_ITEM("FragEvicted", LINUX_MIB_FRAGEVICTED),
+	SNMP_MIB_ITEM("FragEvictedAgeMsecs", LINUX_MIB_FRAGEVICTEDAGEMSECS),
+	SNMP_MIB_ITEM("TCPBBRModelUpdates", LINUX_MIB_TCPBBRMODELUPDATES),
+	SNMP_MIB_ITEM("TCPBBRModelSkipped", LINUX_MIB_TCPBBRMODELSKIPPED),
+	SNMP_MIB_ITEM("TCPMetricsLockContended", LINUX_MIB_TCPMETRICSLOCKCONTENDED),
+	SNMP_MIB_ITEM("TCActCtFlowTableHits", LINUX_MIB_TCACTCTFLOWTABLEHITS),
+	SNMP_MIB_ITEM("TCActCtFlowTableSegs", LINUX_MIB_TCACTCTFLOWTABLESEGS),
 	SNMP_MIB_SENTINEL
 };
 
@@ -596,6 +596,13 @@ static struct ctl_table ipv4_table[] = {
 		.proc_handler	= proc_dointvec,
 	},
 #endif /* CONFIG_NETLABEL */
+	{
+		.procname	= "tcp_gro_ack_coalesce",
+		.data		= &tcp_gro_ack_coalesce.key,
+		.maxlen		= sizeof(tcp_gro_ack_coalesce),
+		.mode		= 0644,
+		.proc_handler	= proc_do_static_key,
+	},
 	{
 		.procname	= "tcp_available_ulp",
 		.maxlen		= TCP_ULP_BUF_MAX,
@@ -618,6 +625,15 @@ static struct ctl_table ipv4_table[] = {
 		.extra1		= &sysctl_fib_sync_mem_min,
 		.extra2		= &sysctl_fib_sync_mem_max,
 	},
+#ifdef CONFIG_IP_FIB_TRIE_CACHE
+	{
+		.procname	= "fib_lookup_cache",
+		.data		= &fib_lookup_cache.key,
+		.maxlen		= sizeof(fib_lookup_cache),
+		.mode		= 0644,
+		.proc_handler	= proc_do_static_key,
+	},
+#endif
 };
 
 static struct ctl_table ipv4_net_table[] = {
@@ -2430,6 +2430,7 @@ static int tcp_recvmsg_dmabuf(struct sock *sk, const struct sk_buff *skb,
 {
 	struct dmabuf_cmsg dmabuf_cmsg = { 0 };
 	struct tcp_xa_pool tcp_xa_pool;
+	struct net_iov *niov;
 	unsigned int start;
 	int i, copy, n;
 	int sent = 0;
@@ -2474,6 +2475,14 @@ static int tcp_recvmsg_dmabuf(struct sock *sk, const struct sk_buff *skb,
 
 			sent += copy;
 
+			if (skb_shinfo(skb)->nr_frags &&
+			    skb_frag_net_iov(&skb_shinfo(skb)->frags[0])) {
+				niov = skb_frag_net_iov(&skb_shinfo(skb)->frags[0]);
+				if (net_is_devmem_iov(niov))
+					atomic_long_add(copy,
+							&net_devmem_iov_binding(niov)->copied_bytes);
+			}
+
 			if (remaining_len == 0)
 				goto out;
 		}
@@ -2483,7 +2492,6 @@ static int tcp_recvmsg_dmabuf(struct sock *sk, const struct sk_buff *skb,
 		 */
 		for (i = 0; i < skb_shinfo(skb)->nr_frags; i++) {
 			skb_frag_t *frag = &skb_shinfo(skb)->frags[i];
-			struct net_iov *niov;
 			u64 frag_offset;
 			int end;
 
@@ -2537,6 +2545,7 @@ static int tcp_recvmsg_dmabuf(struct sock *sk, const struct sk_buff *skb,
 					goto out;
 
 				atomic_long_inc(&niov->pp_ref_count);
+				net_devmem_token_get(niov);
 				tcp_xa_pool.netmems[tcp_xa_pool.idx++] = skb_frag_netmem(frag);
 
 				sent += copy;
@@ -3870,6 +3879,19 @@ int do_tcp_setsockopt(struct sock *sk, int level, int optname,
 		__tcp_sock_set_nodelay(sk, val);
 		break;
 
+	case TCP_ACCEPTQ_SHARDED:
+		/* Has to be chosen before listen(), and sticks once chosen
+		 * as softirq may still look at the shards of a stopped
+		 * listener.
+		 */
+		if (sk->sk_state != TCP_CLOSE)
+			err = -EISCONN;
+		else if (val)
+			err = reqsk_queue_alloc_shards(&icsk->icsk_accept_queue);
+		else if (icsk->icsk_accept_queue.shards)
+			err = -EBUSY;
+		break;
+
 	case TCP_THIN_LINEAR_TIMEOUTS:
 		if (val < 0 || val > 1)
 			err = -EINVAL;
@@ -4694,6 +4716,9 @@ int do_tcp_getsockopt(struct sock *sk, int level,
 	case TCP_DELACK_MAX_US:
 		val = jiffies_to_usecs(READ_ONCE(inet_csk(sk)->icsk_delack_max));
 		break;
+	case TCP_ACCEPTQ_SHARDED:
+		val = !!READ_ONCE(icsk->icsk_accept_queue.shards);
+		break;
 	default:
 		return -ENOPROTOOPT;
 	}
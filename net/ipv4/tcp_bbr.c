@@ -100,7 +100,8 @@ struct bbr {
 		round_start:1,	     /* start of packet-timed tx->ack round? */
 		idle_restart:1,	     /* restarting after idle? */
 		probe_rtt_round_done:1,  /* a BBR_PROBE_RTT round at 4 pkts? */
-		unused:13,
+		model_acks:8,	     /* ACKs since last full model update */
+		unused:5,
 		lt_is_sampling:1,    /* taking long-term ("LT") samples now? */
 		lt_rtt_cnt:7,	     /* round trips in long-term interval */
 		lt_use_bw:1;	     /* use lt_bw as our bw estimate? */
@@ -201,6 +202,11 @@ static const u32 bbr_ack_epoch_acked_reset_thresh = 1U << 20;
 /* Time period for clamping cwnd increment due to ack aggregation */
 static const u32 bbr_extra_acked_max_us = 100 * 1000;
 
+/* In steady PROBE_BW, run the full model update only every this many ACKs */
+static unsigned int bbr_model_acks __read_mostly = 1;
+module_param(bbr_model_acks, uint, 0644);
+MODULE_PARM_DESC(bbr_model_acks, "ACKs per full model update in PROBE_BW (1 = every ACK, max 255)");
+
 static void bbr_check_probe_rtt_done(struct sock *sk);
 
 /* Do we estimate that STARTUP filled the pipe? */
@@ -1013,10 +1019,42 @@ static void bbr_update_gains(struct sock *sk)
 	}
 }
 
+/* Does this ACK need the full model update?
+ *
+ * The bandwidth filter and ACK aggregation accounting consume every ACK and
+ * always run. The rest of the model only acts on round starts, losses, new
+ * min_rtt samples, filter expiry or mode transitions, so in steady
+ * PROBE_BW it can be batched over bbr_model_acks ACKs, at the price of
+ * noticing a pacing gain cycle phase change up to that many ACKs late.
+ */
+static bool bbr_model_due(struct sock *sk, const struct rate_sample *rs)
+{
+	u32 acks = min(READ_ONCE(bbr_model_acks), 255U);
+	struct bbr *bbr = inet_csk_ca(sk);
+
+	if (acks <= 1 || bbr->mode != BBR_PROBE_BW || bbr->round_start ||
+	    bbr->idle_restart || rs->losses ||
+	    (rs->rtt_us >= 0 && rs->rtt_us < bbr->min_rtt_us) ||
+	    after(tcp_jiffies32,
+		  bbr->min_rtt_stamp + bbr_min_rtt_win_sec * HZ) ||
+	    ++bbr->model_acks >= acks) {
+		bbr->model_acks = 0;
+		return true;
+	}
+	return false;
+}
+
 static void bbr_update_model(struct sock *sk, const struct rate_sample *rs)
 {
 	bbr_update_bw(sk, rs);
 	bbr_update_ack_aggregation(sk, rs);
+	if (!bbr_model_due(sk, rs)) {
+		NET_INC_STATS(sock_net(sk), LINUX_MIB_TCPBBRMODELSKIPPED);
+		return;
+	}
+	/* Only worth counting against the skipped ones when batching */
+	if (READ_ONCE(bbr_model_acks) > 1)
+		NET_INC_STATS(sock_net(sk), LINUX_MIB_TCPBBRMODELUPDATES);
 	bbr_update_cycle_phase(sk, rs);
 	bbr_check_full_bw_reached(sk, rs);
 	bbr_check_drain(sk, rs);
@@ -1050,6 +1088,7 @@ __bpf_kfunc static void bbr_init(struct sock *sk)
 
 	bbr->probe_rtt_done_stamp = 0;
 	bbr->probe_rtt_round_done = 0;
+	bbr->model_acks = 0;
 	bbr->min_rtt_us = tcp_min_rtt(tp);
 	bbr->min_rtt_stamp = tcp_jiffies32;
 
@@ -1035,6 +1035,7 @@ struct tcp_sacktag_state {
 	u64	last_sackt;
 	u32	reord;
 	u32	sack_delivered;
+	u32	walked;		/* skbs visited while tagging */
 	int	flag;
 	unsigned int mss_now;
 	struct rate_sample *rate;
@@ -1747,6 +1748,8 @@ static struct sk_buff *tcp_sacktag_walk(struct sk_buff *skb, struct sock *sk,
 		if (!before(TCP_SKB_CB(skb)->seq, end_seq))
 			break;
 
+		state->walked++;
+
 		if (next_dup  &&
 		    before(TCP_SKB_CB(skb)->seq, next_dup->end_seq)) {
 			in_sack = tcp_match_skb_to_sack(sk, skb,
@@ -1875,6 +1878,7 @@ tcp_sacktag_write_queue(struct sock *sk, const struct sk_buff *ack_skb,
 
 	state->flag = 0;
 	state->reord = tp->snd_nxt;
+	state->walked = 0;
 
 	if (!tp->sacked_out)
 		tcp_highest_sack_reset(sk);
@@ -2040,6 +2044,11 @@ tcp_sacktag_write_queue(struct sock *sk, const struct sk_buff *ack_skb,
 	if (inet_csk(sk)->icsk_ca_state != TCP_CA_Loss || tp->undo_marker)
 		tcp_check_sack_reordering(sk, state->reord, 0);
 
+	NET_INC_STATS(sock_net(sk), LINUX_MIB_TCPSACKSCOREBOARDACKS);
+	if (state->walked)
+		NET_ADD_STATS(sock_net(sk), LINUX_MIB_TCPSACKSCOREBOARDOPS,
+			      state->walked);
+
 	tcp_verify_left_out(tp);
 out:
 
@@ -87,6 +87,8 @@
 
 #include <trace/events/tcp.h>
 
+#include "../core/devmem.h"
+
 #ifdef CONFIG_TCP_MD5SIG
 static int tcp_v4_md5_hash_hdr(char *md5_hash, const struct tcp_md5sig_key *key,
 			       __be32 daddr, __be32 saddr, const struct tcphdr *th);
@@ -2533,8 +2535,10 @@ static void tcp_release_user_frags(struct sock *sk)
 	unsigned long index;
 	void *netmem;
 
-	xa_for_each(&sk->sk_user_frags, index, netmem)
+	xa_for_each(&sk->sk_user_frags, index, netmem) {
+		net_devmem_token_put((__force netmem_ref)netmem);
 		WARN_ON_ONCE(!napi_pp_put_page((__force netmem_ref)netmem));
+	}
 #endif
 }
 
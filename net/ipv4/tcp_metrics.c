@@ -92,7 +92,9 @@ struct tcpm_hash_bucket {
 static struct tcpm_hash_bucket	*tcp_metrics_hash __read_mostly;
 static unsigned int		tcp_metrics_hash_log __read_mostly;
 
-static DEFINE_SPINLOCK(tcp_metrics_lock);
+/* Bucket locks, shared by the rows that map to them through the mask */
+static spinlock_t		*tcp_metrics_locks __read_mostly;
+static unsigned int		tcp_metrics_locks_mask __read_mostly;
 static DEFINE_SEQLOCK(fastopen_seqlock);
 
 static void tcpm_suck_dst(struct tcp_metrics_block *tm,
@@ -157,20 +159,29 @@ static void tcpm_check_stamp(struct tcp_metrics_block *tm,
 #define TCP_METRICS_RECLAIM_DEPTH	5
 #define TCP_METRICS_RECLAIM_PTR		(struct tcp_metrics_block *) 0x1UL
 
-#define deref_locked(p)	\
-	rcu_dereference_protected(p, lockdep_is_held(&tcp_metrics_lock))
+static spinlock_t *tcpm_hash_lock(unsigned int hash)
+{
+	return &tcp_metrics_locks[hash & tcp_metrics_locks_mask];
+}
+
+#define deref_locked(p, hash)	\
+	rcu_dereference_protected(p, lockdep_is_held(tcpm_hash_lock(hash)))
 
 static struct tcp_metrics_block *tcpm_new(struct dst_entry *dst,
 					  struct inetpeer_addr *saddr,
 					  struct inetpeer_addr *daddr,
 					  unsigned int hash)
 {
+	spinlock_t *lock = tcpm_hash_lock(hash);
 	struct tcp_metrics_block *tm;
 	struct net *net;
 	bool reclaim = false;
 
-	spin_lock_bh(&tcp_metrics_lock);
 	net = dev_net_rcu(dst->dev);
+	if (!spin_trylock_bh(lock)) {
+		NET_INC_STATS(net, LINUX_MIB_TCPMETRICSLOCKCONTENDED);
+		spin_lock_bh(lock);
+	}
 
 	/* While waiting for the spin-lock the cache might have been populated
 	 * with this entry and so we have to check again.
@@ -188,9 +199,9 @@ static struct tcp_metrics_block *tcpm_new(struct dst_entry *dst,
 	if (unlikely(reclaim)) {
 		struct tcp_metrics_block *oldest;
 
-		oldest = deref_locked(tcp_metrics_hash[hash].chain);
-		for (tm = deref_locked(oldest->tcpm_next); tm;
-		     tm = deref_locked(tm->tcpm_next)) {
+		oldest = deref_locked(tcp_metrics_hash[hash].chain, hash);
+		for (tm = deref_locked(oldest->tcpm_next, hash); tm;
+		     tm = deref_locked(tm->tcpm_next, hash)) {
 			if (time_before(READ_ONCE(tm->tcpm_stamp),
 					READ_ONCE(oldest->tcpm_stamp)))
 				oldest = tm;
@@ -215,7 +226,7 @@ static struct tcp_metrics_block *tcpm_new(struct dst_entry *dst,
 	}
 
 out_unlock:
-	spin_unlock_bh(&tcp_metrics_lock);
+	spin_unlock_bh(lock);
 	return tm;
 }
 
@@ -909,8 +920,9 @@ static void tcp_metrics_flush_all(struct net *net)
 		if (!rcu_access_pointer(*pp))
 			continue;
 
-		spin_lock_bh(&tcp_metrics_lock);
-		for (tm = deref_locked(*pp); tm; tm = deref_locked(*pp)) {
+		spin_lock_bh(tcpm_hash_lock(row));
+		for (tm = deref_locked(*pp, row); tm;
+		     tm = deref_locked(*pp, row)) {
 			match = net ? net_eq(tm_net(tm), net) :
 				!refcount_read(&tm_net(tm)->ns.count);
 			if (match) {
@@ -920,7 +932,7 @@ static void tcp_metrics_flush_all(struct net *net)
 				pp = &tm->tcpm_next;
 			}
 		}
-		spin_unlock_bh(&tcp_metrics_lock);
+		spin_unlock_bh(tcpm_hash_lock(row));
 		cond_resched();
 	}
 }
@@ -951,8 +963,8 @@ static int tcp_metrics_nl_cmd_del(struct sk_buff *skb, struct genl_info *info)
 	hash = hash_32(hash, tcp_metrics_hash_log);
 	hb = tcp_metrics_hash + hash;
 	pp = &hb->chain;
-	spin_lock_bh(&tcp_metrics_lock);
-	for (tm = deref_locked(*pp); tm; tm = deref_locked(*pp)) {
+	spin_lock_bh(tcpm_hash_lock(hash));
+	for (tm = deref_locked(*pp, hash); tm; tm = deref_locked(*pp, hash)) {
 		if (addr_same(&tm->tcpm_daddr, &daddr) &&
 		    (!src || addr_same(&tm->tcpm_saddr, &saddr)) &&
 		    net_eq(tm_net(tm), net)) {
@@ -963,7 +975,7 @@ static int tcp_metrics_nl_cmd_del(struct sk_buff *skb, struct genl_info *info)
 			pp = &tm->tcpm_next;
 		}
 	}
-	spin_unlock_bh(&tcp_metrics_lock);
+	spin_unlock_bh(tcpm_hash_lock(hash));
 	if (!found)
 		return -ESRCH;
 	return 0;
@@ -1032,6 +1044,15 @@ static void __init tcp_metrics_hash_alloc(void)
 	tcp_metrics_hash = kvzalloc(size, GFP_KERNEL);
 	if (!tcp_metrics_hash)
 		panic("Could not allocate the tcp_metrics hash table\n");
+
+	/* Enough locks that connection churn on different rows rarely
+	 * contends, without one lock per row.
+	 */
+	slots = min_t(unsigned int, 1U << tcp_metrics_hash_log,
+		      roundup_pow_of_two(num_possible_cpus()) * 8);
+	if (alloc_bucket_spinlocks(&tcp_metrics_locks, &tcp_metrics_locks_mask,
+				   slots, 0, GFP_KERNEL))
+		panic("Could not allocate the tcp_metrics hash locks\n");
 }
 
 static void __net_exit tcp_net_metrics_exit_batch(struct list_head *net_exit_list)
@@ -309,6 +309,60 @@ struct tcphdr *tcp_gro_pull_header(struct sk_buff *skb)
 	return th;
 }
 
+DEFINE_STATIC_KEY_FALSE(tcp_gro_ack_coalesce);
+
+/* A pure ACK (no payload, only ACK set, at most a timestamp option) may be
+ * held by GRO so that a later pure ACK of the same flow can replace it.
+ */
+static bool tcp_gro_ack_foldable(const struct tcphdr *th, unsigned int len)
+{
+	unsigned int thlen = th->doff * 4;
+
+	if (len || (tcp_flag_word(th) & (TCP_FLAG_CWR | TCP_FLAG_ECE |
+					 TCP_FLAG_URG | TCP_FLAG_ACK |
+					 TCP_FLAG_PSH | TCP_FLAG_RST |
+					 TCP_FLAG_SYN | TCP_FLAG_FIN)) !=
+		   TCP_FLAG_ACK)
+		return false;
+
+	if (thlen == sizeof(*th))
+		return true;
+
+	return thlen == sizeof(*th) + TCPOLEN_TSTAMP_ALIGNED &&
+	       *(__be32 *)(th + 1) == htonl((TCPOPT_NOP << 24) |
+					    (TCPOPT_NOP << 16) |
+					    (TCPOPT_TIMESTAMP << 8) |
+					    TCPOLEN_TIMESTAMP);
+}
+
+/* Fold pure ACK @skb into the held pure ACK @p by taking over its header.
+ * Only ACKs that advance snd_una are folded, so duplicate ACKs and their
+ * loss signal reach tcp_ack() unchanged; the rate sample and RTT come out
+ * the same as the last ACK's since both are cumulative.
+ */
+static bool tcp_gro_ack_fold(struct sk_buff *p, struct sk_buff *skb,
+			     struct tcphdr *th, struct tcphdr *th2)
+{
+	unsigned int thlen = th->doff * 4;
+
+	if (th2->doff != th->doff || th->seq != th2->seq ||
+	    !after(ntohl(th->ack_seq), ntohl(th2->ack_seq)) ||
+	    gro_receive_network_flush(th, th2, p) ||
+	    skb_header_cloned(p) || skb_cmp_decrypted(p, skb))
+		return false;
+
+	if (p->ip_summed == CHECKSUM_COMPLETE)
+		p->csum = csum_add(csum_sub(p->csum,
+					    csum_partial(th2, thlen, 0)),
+				   csum_partial(th, thlen, 0));
+	memcpy(th2, th, thlen);
+
+	NAPI_GRO_CB(skb)->same_flow = 1;
+	NAPI_GRO_CB(skb)->free = NAPI_GRO_FREE;
+	__NET_INC_STATS(dev_net(skb->dev), LINUX_MIB_TCPGROACKCOALESCE);
+	return true;
+}
+
 struct sk_buff *tcp_gro_receive(struct list_head *head, struct sk_buff *skb,
 				struct tcphdr *th)
 {
@@ -330,6 +384,12 @@ struct sk_buff *tcp_gro_receive(struct list_head *head, struct sk_buff *skb,
 		goto out_check_final;
 
 	th2 = tcp_hdr(p);
+
+	if (static_branch_unlikely(&tcp_gro_ack_coalesce) &&
+	    !NAPI_GRO_CB(p)->is_flist && tcp_gro_ack_foldable(th, len) &&
+	    tcp_gro_ack_foldable(th2, skb_gro_len(p)) &&
+	    tcp_gro_ack_fold(p, skb, th, th2))
+		return NULL;
 	flush = (__force int)(flags & TCP_FLAG_CWR);
 	flush |= (__force int)((flags ^ tcp_flag_word(th2)) &
 		  ~(TCP_FLAG_FIN | TCP_FLAG_PSH));
@@ -380,6 +440,11 @@ struct sk_buff *tcp_gro_receive(struct list_head *head, struct sk_buff *skb,
 	else
 		flush = len < mss;
 
+	/* Hold a lone pure ACK until the end of the NAPI poll instead. */
+	if (static_branch_unlikely(&tcp_gro_ack_coalesce) && !p &&
+	    tcp_gro_ack_foldable(th, len))
+		flush = 0;
+
 	flush |= (__force int)(flags & (TCP_FLAG_URG | TCP_FLAG_PSH |
 					TCP_FLAG_RST | TCP_FLAG_SYN |
 					TCP_FLAG_FIN));
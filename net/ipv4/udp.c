@@ -1797,6 +1797,7 @@ void udp_destruct_common(struct sock *sk)
 	/* reclaim completely the forward allocated memory */
 	struct udp_sock *up = udp_sk(sk);
 	unsigned int total = 0;
+	struct bpf_prog *prog;
 	struct sk_buff *skb;
 
 	skb_queue_splice_tail_init(&sk->sk_receive_queue, &up->reader_queue);
@@ -1805,6 +1806,10 @@ void udp_destruct_common(struct sock *sk)
 		kfree_skb(skb);
 	}
 	udp_rmem_release(sk, total, 0, true);
+
+	prog = rcu_dereference_protected(up->gro_prog, 1);
+	if (prog)
+		bpf_prog_put(prog);
 }
 EXPORT_IPV6_MOD_GPL(udp_destruct_common);
 
@@ -1960,8 +1965,14 @@ struct sk_buff *__skb_recv_udp(struct sock *sk, unsigned int flags,
 			 * keep both queues locked to avoid re-acquiring
 			 * the sk_receive_queue lock if fwd memory scheduling
 			 * is needed.
+			 * The splice is what batches a recvmmsg() loop, the
+			 * following calls dequeue from the reader queue without
+			 * touching sk_receive_queue.
 			 */
 			spin_lock(&sk_queue->lock);
+			__NET_INC_STATS(sock_net(sk), LINUX_MIB_UDPREADERSPLICES);
+			__NET_ADD_STATS(sock_net(sk), LINUX_MIB_UDPREADERSPLICEDPKTS,
+					skb_queue_len(sk_queue));
 			skb_queue_splice_tail_init(sk_queue, queue);
 
 			skb = __skb_try_recv_from_queue(sk, queue, flags, off,
@@ -2459,8 +2470,10 @@ static int udp_queue_rcv_skb(struct sock *sk, struct sk_buff *skb)
 	struct sk_buff *next, *segs;
 	int ret;
 
-	if (likely(!udp_unexpected_gso(sk, skb)))
+	if (likely(!udp_unexpected_gso(sk, skb))) {
+		udp_gro_account(sk, skb);
 		return udp_queue_rcv_one_skb(sk, skb);
+	}
 
 	BUILD_BUG_ON(sizeof(struct udp_skb_cb) > SKB_GSO_CB_OFFSET);
 	__skb_push(skb, -skb_mac_offset(skb));
@@ -2915,6 +2928,29 @@ static void set_xfrm_gro_udp_encap_rcv(__u16 encap_type, unsigned short family,
 #endif
 }
 
+/* Attach, replace or (fd < 0) detach the UDP_GRO_BPF program. It is a
+ * socket filter run once on each datagram in GRO, with the data pointing at
+ * the network header, so the program finds the UDP payload from the IP header
+ * itself; datagrams only coalesce with a held packet of the same
+ * 4-tuple when it returns the same non zero key, zero means don't coalesce.
+ */
+static int udp_set_gro_prog(struct sock *sk, int fd)
+{
+	struct bpf_prog *prog = NULL, *old;
+
+	if (fd >= 0) {
+		prog = bpf_prog_get_type(fd, BPF_PROG_TYPE_SOCKET_FILTER);
+		if (IS_ERR(prog))
+			return PTR_ERR(prog);
+		udp_tunnel_encap_enable(sk);
+	}
+
+	old = unrcu_pointer(xchg(&udp_sk(sk)->gro_prog, RCU_INITIALIZER(prog)));
+	if (old)
+		bpf_prog_put(old);
+	return 0;
+}
+
 /*
  *	Socket option code for UDP
  */
@@ -3009,6 +3045,10 @@ int udp_lib_setsockopt(struct sock *sk, int level, int optname,
 		set_xfrm_gro_udp_encap_rcv(up->encap_type, sk->sk_family, sk);
 		break;
 
+	case UDP_GRO_BPF:
+		err = udp_set_gro_prog(sk, val);
+		break;
+
 	/*
 	 * 	UDP-Lite's partial checksum coverage (RFC 3828).
 	 */
@@ -3070,6 +3110,20 @@ int udp_lib_getsockopt(struct sock *sk, int level, int optname,
 	if (len < 0)
 		return -EINVAL;
 
+	if (optname == UDP_GRO_STATS) {
+		struct udp_gro_stats stats = {
+			.packets	= atomic_long_read(&up->gro_packets),
+			.segments	= atomic_long_read(&up->gro_segs),
+		};
+
+		len = min_t(unsigned int, len, sizeof(stats));
+		if (put_user(len, optlen))
+			return -EFAULT;
+		if (copy_to_user(optval, &stats, len))
+			return -EFAULT;
+		return 0;
+	}
+
 	len = min_t(unsigned int, len, sizeof(int));
 
 	switch (optname) {
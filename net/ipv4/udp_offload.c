@@ -7,6 +7,7 @@
  */
 
 #include <linux/skbuff.h>
+#include <linux/filter.h>
 #include <net/gro.h>
 #include <net/gso.h>
 #include <net/udp.h>
@@ -476,14 +477,17 @@ static struct sk_buff *udp4_ufo_fragment(struct sk_buff *skb,
 
 
 #define UDP_GRO_CNT_MAX 64
-static struct sk_buff *udp_gro_receive_segment(struct list_head *head,
+static struct sk_buff *udp_gro_receive_segment(struct sock *sk,
+					       struct list_head *head,
 					       struct sk_buff *skb)
 {
 	struct udphdr *uh = udp_gro_udphdr(skb);
+	struct bpf_prog *prog = NULL;
 	struct sk_buff *pp = NULL;
 	struct udphdr *uh2;
 	struct sk_buff *p;
 	unsigned int ulen;
+	u32 key = 0;
 	int ret = 0;
 	int flush;
 
@@ -502,6 +506,22 @@ static struct sk_buff *udp_gro_receive_segment(struct list_head *head,
 	/* pull encapsulating udp header */
 	skb_gro_pull(skb, sizeof(struct udphdr));
 
+	/*
+	 * The UDP_GRO_BPF key is computed once per packet and kept in the cb,
+	 * where held packets are compared against it. The program reads the
+	 * packet through skb_header_pointer(), so it can be non linear.
+	 */
+	if (sk)
+		prog = rcu_dereference(udp_sk(sk)->gro_prog);
+	if (prog) {
+		key = bpf_prog_run_save_cb(prog, skb);
+		if (!key) {
+			NAPI_GRO_CB(skb)->flush = 1;
+			return NULL;
+		}
+	}
+	NAPI_GRO_CB(skb)->udp_gro_key = key;
+
 	list_for_each_entry(p, head, list) {
 		if (!NAPI_GRO_CB(p)->same_flow)
 			continue;
@@ -514,6 +534,11 @@ static struct sk_buff *udp_gro_receive_segment(struct list_head *head,
 			continue;
 		}
 
+		if (NAPI_GRO_CB(p)->udp_gro_key != key) {
+			NAPI_GRO_CB(p)->same_flow = 0;
+			continue;
+		}
+
 		if (NAPI_GRO_CB(skb)->is_flist != NAPI_GRO_CB(p)->is_flist) {
 			NAPI_GRO_CB(skb)->flush = 1;
 			return p;
@@ -587,7 +612,8 @@ struct sk_buff *udp_gro_receive(struct list_head *head, struct sk_buff *skb,
 
 		if ((!sk && (skb->dev->features & NETIF_F_GRO_UDP_FWD)) ||
 		    (sk && udp_test_bit(GRO_ENABLED, sk)) || NAPI_GRO_CB(skb)->is_flist)
-			return call_gro_receive(udp_gro_receive_segment, head, skb);
+			return call_gro_receive_sk(udp_gro_receive_segment, sk,
+						   head, skb);
 
 		/* no GRO, be sure flush the current packet */
 		goto out;
@@ -58,7 +58,10 @@ static int subflow_get_info(struct sock *sk, struct sk_buff *skb, bool net_admin
 	    nla_put_u32(skb, MPTCP_SUBFLOW_ATTR_TOKEN_LOC, sf->token) ||
 	    nla_put_u32(skb, MPTCP_SUBFLOW_ATTR_FLAGS, flags) ||
 	    nla_put_u8(skb, MPTCP_SUBFLOW_ATTR_ID_REM, sf->remote_id) ||
-	    nla_put_u8(skb, MPTCP_SUBFLOW_ATTR_ID_LOC, subflow_get_local_id(sf))) {
+	    nla_put_u8(skb, MPTCP_SUBFLOW_ATTR_ID_LOC, subflow_get_local_id(sf)) ||
+	    nla_put_u64_64bit(skb, MPTCP_SUBFLOW_ATTR_SCHED_COUNT,
+			      READ_ONCE(sf->sched_count),
+			      MPTCP_SUBFLOW_ATTR_PAD)) {
 		err = -EMSGSIZE;
 		goto nla_failure;
 	}
@@ -100,6 +103,7 @@ static size_t subflow_get_info_size(const struct sock *sk, bool net_admin)
 		nla_total_size(4) +	/* MPTCP_SUBFLOW_ATTR_FLAGS */
 		nla_total_size(1) +	/* MPTCP_SUBFLOW_ATTR_ID_REM */
 		nla_total_size(1) +	/* MPTCP_SUBFLOW_ATTR_ID_LOC */
+		nla_total_size_64bit(8) +	/* MPTCP_SUBFLOW_ATTR_SCHED_COUNT */
 		0;
 
 	if (net_admin)
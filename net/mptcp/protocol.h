@@ -497,6 +497,7 @@ struct mptcp_subflow_context {
 	struct_group(reset,
 
 	unsigned long avg_pacing_rate; /* protected by msk socket lock */
+	u64	sched_count;	    /* times picked by the scheduler, ditto */
 	u64	local_key;
 	u64	remote_key;
 	u64	idsn;
@@ -744,6 +745,7 @@ void mptcp_info2sockaddr(const struct mptcp_addr_info *info,
 			 struct sockaddr_storage *addr,
 			 unsigned short family);
 struct mptcp_sched_ops *mptcp_sched_find(const char *name);
+int mptcp_validate_scheduler(struct mptcp_sched_ops *sched);
 int mptcp_register_scheduler(struct mptcp_sched_ops *sched);
 void mptcp_unregister_scheduler(struct mptcp_sched_ops *sched);
 void mptcp_sched_init(void);
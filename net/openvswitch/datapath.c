@@ -1556,6 +1556,8 @@ static size_t ovs_dp_cmd_msg_size(void)
 	msgsize += nla_total_size(sizeof(u32)); /* OVS_DP_ATTR_USER_FEATURES */
 	msgsize += nla_total_size(sizeof(u32)); /* OVS_DP_ATTR_MASKS_CACHE_SIZE */
 	msgsize += nla_total_size(sizeof(u32) * nr_cpu_ids); /* OVS_DP_ATTR_PER_CPU_PIDS */
+	/* OVS_DP_ATTR_MASKS_USAGE */
+	msgsize += nla_total_size_64bit(sizeof(u64) * OVS_DP_MASKS_USAGE_MAX);
 
 	return msgsize;
 }
@@ -1568,7 +1570,8 @@ static int ovs_dp_cmd_fill_info(struct datapath *dp, struct sk_buff *skb,
 	struct ovs_dp_stats dp_stats;
 	struct ovs_dp_megaflow_stats dp_megaflow_stats;
 	struct dp_nlsk_pids *pids = ovsl_dereference(dp->upcall_portids);
-	int err, pids_len;
+	int err, pids_len, n_masks;
+	struct nlattr *nla;
 
 	ovs_header = genlmsg_put(skb, portid, seq, &dp_datapath_genl_family,
 				 flags, cmd);
@@ -1598,6 +1601,15 @@ static int ovs_dp_cmd_fill_info(struct datapath *dp, struct sk_buff *skb,
 			ovs_flow_tbl_masks_cache_size(&dp->table)))
 		goto nla_put_failure;
 
+	n_masks = min(ovs_flow_tbl_num_masks(&dp->table),
+		      OVS_DP_MASKS_USAGE_MAX);
+	nla = nla_reserve_64bit(skb, OVS_DP_ATTR_MASKS_USAGE,
+				n_masks * sizeof(u64), OVS_DP_ATTR_PAD);
+	if (!nla)
+		goto nla_put_failure;
+	memset(nla_data(nla), 0, n_masks * sizeof(u64));
+	ovs_flow_tbl_masks_usage(&dp->table, nla_data(nla), n_masks);
+
 	if (dp->user_features & OVS_DP_F_DISPATCH_UPCALL_PER_CPU && pids) {
 		pids_len = min(pids->n_pids, nr_cpu_ids) * sizeof(u32);
 		if (nla_put(skb, OVS_DP_ATTR_PER_CPU_PIDS, pids_len, &pids->pids))
@@ -187,32 +187,39 @@ static void mask_array_rcu_cb(struct rcu_head *rcu)
 	__mask_array_destroy(ma);
 }
 
+static u64 tbl_mask_array_usage(struct mask_array *ma, int i)
+{
+	u64 usage = 0;
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		struct mask_array_stats *stats;
+		unsigned int start;
+		u64 counter;
+
+		stats = per_cpu_ptr(ma->masks_usage_stats, cpu);
+		do {
+			start = u64_stats_fetch_begin(&stats->syncp);
+			counter = stats->usage_cntrs[i];
+		} while (u64_stats_fetch_retry(&stats->syncp, start));
+
+		usage += counter;
+	}
+
+	return usage;
+}
+
 static void tbl_mask_array_reset_counters(struct mask_array *ma)
 {
-	int i, cpu;
+	int i;
 
 	/* As the per CPU counters are not atomic we can not go ahead and
 	 * reset them from another CPU. To be able to still have an approximate
 	 * zero based counter we store the value at reset, and subtract it
 	 * later when processing.
 	 */
-	for (i = 0; i < ma->max; i++) {
-		ma->masks_usage_zero_cntr[i] = 0;
-
-		for_each_possible_cpu(cpu) {
-			struct mask_array_stats *stats;
-			unsigned int start;
-			u64 counter;
-
-			stats = per_cpu_ptr(ma->masks_usage_stats, cpu);
-			do {
-				start = u64_stats_fetch_begin(&stats->syncp);
-				counter = stats->usage_cntrs[i];
-			} while (u64_stats_fetch_retry(&stats->syncp, start));
-
-			ma->masks_usage_zero_cntr[i] += counter;
-		}
-	}
+	for (i = 0; i < ma->max; i++)
+		ma->masks_usage_zero_cntr[i] = tbl_mask_array_usage(ma, i);
 }
 
 static struct mask_array *tbl_mask_array_alloc(int size)
@@ -939,6 +946,25 @@ int ovs_flow_tbl_num_masks(const struct flow_table *table)
 	return READ_ONCE(ma->count);
 }
 
+/* Fill @usage with the hits of each mask since the last rebalance, in
+ * lookup order, and return how many entries were filled.
+ */
+int ovs_flow_tbl_masks_usage(const struct flow_table *table, u64 *usage,
+			     int max)
+{
+	struct mask_array *ma = rcu_dereference_ovsl(table->mask_array);
+	int i;
+
+	for (i = 0; i < min(ma->max, max); i++) {
+		if (!rcu_dereference_ovsl(ma->masks[i]))
+			break;
+		usage[i] = tbl_mask_array_usage(ma, i) -
+			   ma->masks_usage_zero_cntr[i];
+	}
+
+	return i;
+}
+
 u32 ovs_flow_tbl_masks_cache_size(const struct flow_table *table)
 {
 	struct mask_cache *mc = rcu_dereference_ovsl(table->mask_cache);
@@ -1118,28 +1144,13 @@ void ovs_flow_masks_rebalance(struct flow_table *table)
 
 	for (i = 0; i < ma->max; i++) {
 		struct sw_flow_mask *mask;
-		int cpu;
 
 		mask = rcu_dereference_ovsl(ma->masks[i]);
 		if (unlikely(!mask))
 			break;
 
 		masks_and_count[i].index = i;
-		masks_and_count[i].counter = 0;
-
-		for_each_possible_cpu(cpu) {
-			struct mask_array_stats *stats;
-			unsigned int start;
-			u64 counter;
-
-			stats = per_cpu_ptr(ma->masks_usage_stats, cpu);
-			do {
-				start = u64_stats_fetch_begin(&stats->syncp);
-				counter = stats->usage_cntrs[i];
-			} while (u64_stats_fetch_retry(&stats->syncp, start));
-
-			masks_and_count[i].counter += counter;
-		}
+		masks_and_count[i].counter = tbl_mask_array_usage(ma, i);
 
 		/* Subtract the zero count value. */
 		masks_and_count[i].counter -= ma->masks_usage_zero_cntr[i];
@@ -86,6 +86,8 @@ int ovs_flow_tbl_insert(struct flow_table *table, struct sw_flow *flow,
 			const struct sw_flow_mask *mask);
 void ovs_flow_tbl_remove(struct flow_table *table, struct sw_flow *flow);
 int  ovs_flow_tbl_num_masks(const struct flow_table *table);
+int  ovs_flow_tbl_masks_usage(const struct flow_table *table, u64 *usage,
+			      int max);
 u32  ovs_flow_tbl_masks_cache_size(const struct flow_table *table);
 int  ovs_flow_tbl_masks_cache_resize(struct flow_table *table, u32 size);
 struct sw_flow *ovs_flow_tbl_dump_next(struct table_instance *table,
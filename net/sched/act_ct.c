@@ -1021,6 +1021,13 @@ TC_INDIRECT_SCOPE int tcf_ct_act(struct sk_buff *skb, const struct tc_action *a,
 	cached = tcf_ct_skb_nfct_cached(net, skb, p);
 	if (!cached) {
 		if (tcf_ct_flow_table_lookup(p, skb, family)) {
+			/* A GRO super-packet stands for gso_segs wire packets
+			 * that all skipped nf_conntrack_in().
+			 */
+			__NET_INC_STATS(net, LINUX_MIB_TCACTCTFLOWTABLEHITS);
+			__NET_ADD_STATS(net, LINUX_MIB_TCACTCTFLOWTABLESEGS,
+					skb_is_gso(skb) ?
+					skb_shinfo(skb)->gso_segs : 1);
 			skip_add = true;
 			goto do_nat;
 		}
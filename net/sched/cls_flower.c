@@ -113,10 +113,18 @@ struct fl_flow_tmplt {
 	struct tcf_chain *chain;
 };
 
+/* Union of the dissectors and key ranges of all masks on a head */
+struct fl_masks_union {
+	struct flow_dissector dissector;
+	struct fl_flow_mask_range range;
+	struct rcu_head rcu;
+};
+
 struct cls_fl_head {
 	struct rhashtable ht;
 	spinlock_t masks_lock; /* Protect masks list */
 	struct list_head masks;
+	struct fl_masks_union __rcu *masks_union;
 	struct list_head hw_filters;
 	struct rcu_work rwork;
 	struct idr handle_idr;
@@ -321,34 +329,61 @@ static u16 fl_ct_info_to_flower_map[] = {
 					TCA_FLOWER_KEY_CT_FLAGS_NEW,
 };
 
+static void fl_dissect(struct sk_buff *skb, struct flow_dissector *dissector,
+		       struct fl_flow_key *skb_key)
+{
+	skb_flow_dissect_meta(skb, dissector, skb_key);
+	/* skb_flow_dissect() does not set n_proto in case an unknown
+	 * protocol, so do it rather here.
+	 */
+	skb_key->basic.n_proto = skb_protocol(skb, false);
+	skb_flow_dissect_tunnel_info(skb, dissector, skb_key);
+	skb_flow_dissect_ct(skb, dissector, skb_key,
+			    fl_ct_info_to_flower_map,
+			    ARRAY_SIZE(fl_ct_info_to_flower_map),
+			    tc_skb_cb(skb)->post_ct, tc_skb_cb(skb)->zone);
+	skb_flow_dissect_hash(skb, dissector, skb_key);
+	skb_flow_dissect(skb, dissector, skb_key,
+			 FLOW_DISSECTOR_F_STOP_BEFORE_ENCAP);
+}
+
+static bool fl_masks_union_covers(const struct fl_masks_union *u,
+				  const struct fl_flow_mask *mask)
+{
+	return !(mask->dissector.used_keys & ~u->dissector.used_keys) &&
+	       mask->range.start >= u->range.start &&
+	       mask->range.end <= u->range.end;
+}
+
 TC_INDIRECT_SCOPE int fl_classify(struct sk_buff *skb,
 				  const struct tcf_proto *tp,
 				  struct tcf_result *res)
 {
 	struct cls_fl_head *head = rcu_dereference_bh(tp->root);
-	bool post_ct = tc_skb_cb(skb)->post_ct;
-	u16 zone = tc_skb_cb(skb)->zone;
+	struct fl_masks_union *u = rcu_dereference_bh(head->masks_union);
 	struct fl_flow_key skb_key;
 	struct fl_flow_mask *mask;
 	struct cls_fl_filter *f;
 
-	list_for_each_entry_rcu(mask, &head->masks, list) {
+	/* Dissect once for all masks; each lookup only looks at its range */
+	if (u) {
 		flow_dissector_init_keys(&skb_key.control, &skb_key.basic);
-		fl_clear_masked_range(&skb_key, mask);
+		memset((u8 *)&skb_key + u->range.start, 0,
+		       u->range.end - u->range.start);
+		fl_dissect(skb, &u->dissector, &skb_key);
+	}
 
-		skb_flow_dissect_meta(skb, &mask->dissector, &skb_key);
-		/* skb_flow_dissect() does not set n_proto in case an unknown
-		 * protocol, so do it rather here.
-		 */
-		skb_key.basic.n_proto = skb_protocol(skb, false);
-		skb_flow_dissect_tunnel_info(skb, &mask->dissector, &skb_key);
-		skb_flow_dissect_ct(skb, &mask->dissector, &skb_key,
-				    fl_ct_info_to_flower_map,
-				    ARRAY_SIZE(fl_ct_info_to_flower_map),
-				    post_ct, zone);
-		skb_flow_dissect_hash(skb, &mask->dissector, &skb_key);
-		skb_flow_dissect(skb, &mask->dissector, &skb_key,
-				 FLOW_DISSECTOR_F_STOP_BEFORE_ENCAP);
+	list_for_each_entry_rcu(mask, &head->masks, list) {
+		/* A mask added after the union was built */
+		if (u && !fl_masks_union_covers(u, mask))
+			u = NULL;
+
+		if (!u) {
+			flow_dissector_init_keys(&skb_key.control,
+						 &skb_key.basic);
+			fl_clear_masked_range(&skb_key, mask);
+			fl_dissect(skb, &mask->dissector, &skb_key);
+		}
 
 		f = fl_mask_lookup(mask, &skb_key);
 		if (f && !tc_skip_sw(f->flags)) {
@@ -402,6 +437,41 @@ static void fl_uninit_mask_free_work(struct work_struct *work)
 	fl_mask_free(mask, false);
 }
 
+/* Rebuild the union of all masks, called with masks_lock held */
+static void fl_masks_union_update(struct cls_fl_head *head)
+{
+	struct fl_masks_union *u = NULL, *old;
+	struct fl_flow_mask *mask;
+	unsigned int i;
+
+	if (!list_empty(&head->masks)) {
+		/* Without it lookups just dissect once per mask */
+		u = kzalloc(sizeof(*u), GFP_ATOMIC);
+		if (u)
+			u->range.start = USHRT_MAX;
+	}
+
+	if (u) {
+		list_for_each_entry(mask, &head->masks, list) {
+			for (i = 0; i < FLOW_DISSECTOR_KEY_MAX; i++) {
+				if (!dissector_uses_key(&mask->dissector, i))
+					continue;
+				u->dissector.used_keys |= BIT_ULL(i);
+				u->dissector.offset[i] =
+					mask->dissector.offset[i];
+			}
+			u->range.start = min(u->range.start,
+					     mask->range.start);
+			u->range.end = max(u->range.end, mask->range.end);
+		}
+	}
+
+	old = rcu_replace_pointer(head->masks_union, u,
+				  lockdep_is_held(&head->masks_lock));
+	if (old)
+		kfree_rcu(old, rcu);
+}
+
 static bool fl_mask_put(struct cls_fl_head *head, struct fl_flow_mask *mask)
 {
 	if (!refcount_dec_and_test(&mask->refcnt))
@@ -411,6 +481,7 @@ static bool fl_mask_put(struct cls_fl_head *head, struct fl_flow_mask *mask)
 
 	spin_lock(&head->masks_lock);
 	list_del_rcu(&mask->list);
+	fl_masks_union_update(head);
 	spin_unlock(&head->masks_lock);
 
 	tcf_queue_work(&mask->rwork, fl_mask_free_work);
@@ -592,6 +663,7 @@ static void fl_destroy_sleepable(struct work_struct *work)
 						rwork);
 
 	rhashtable_destroy(&head->ht);
+	kfree(rcu_dereference_raw(head->masks_union));
 	kfree(head);
 	module_put(THIS_MODULE);
 }
@@ -2265,6 +2337,7 @@ static struct fl_flow_mask *fl_create_new_mask(struct cls_fl_head *head,
 
 	spin_lock(&head->masks_lock);
 	list_add_tail_rcu(&newmask->list, &head->masks);
+	fl_masks_union_update(head);
 	spin_unlock(&head->masks_lock);
 
 	return newmask;
@@ -44,6 +44,7 @@
 #include <linux/hash.h>
 #include <linux/prefetch.h>
 #include <linux/vmalloc.h>
+#include <linux/bitmap.h>
 #include <net/netlink.h>
 #include <net/pkt_sched.h>
 #include <net/sock.h>
@@ -90,8 +91,30 @@ struct fq_flow {
 	int		band;
 	struct fq_flow *next;		/* next pointer in RR lists */
 
-	struct rb_node  rate_node;	/* anchor in q->delayed tree */
+	union {
+		struct rb_node	rate_node;	/* anchor in q->delayed tree */
+		struct list_head wheel_node;	/* or in a q->wheel slot */
+	};
 	u64		time_next_packet;
+	u16		wheel_slot;
+	u8		in_wheel;
+};
+
+/*
+ * Optional timing wheel for throttled flows. Slot i holds the flows whose
+ * time_next_packet falls in [i * granularity, (i + 1) * granularity), for
+ * the FQ_WHEEL_SLOTS slots that follow the cursor. A slot is released once
+ * it has fully elapsed, so flows can be late by up to one granularity.
+ * Flows further out than the wheel span go to the q->delayed rbtree.
+ */
+#define FQ_WHEEL_SLOTS	4096
+#define FQ_WHEEL_MASK	(FQ_WHEEL_SLOTS - 1)
+
+struct fq_wheel {
+	u64		time;		/* absolute slot number of the cursor */
+	u32		flows;
+	unsigned long	map[BITS_TO_LONGS(FQ_WHEEL_SLOTS)]; /* non empty slots */
+	struct list_head slots[FQ_WHEEL_SLOTS];
 };
 
 struct fq_flow_head {
@@ -127,6 +150,7 @@ struct fq_sched_data {
 	u8		horizon_drop;
 	u8		prio2band[FQ_PRIO2BAND_CRUMB_SIZE];
 	u32		timer_slack; /* hrtimer slack in ns */
+	u32		wheel_granularity; /* timing wheel slot width in ns */
 
 /* Read/Write fields. */
 
@@ -136,6 +160,7 @@ struct fq_sched_data {
 
 	struct fq_flow	internal;	/* fastpath queue. */
 	struct rb_root	delayed;	/* for rate limited flows */
+	struct fq_wheel	*wheel;		/* optional, in front of delayed */
 	u64		time_next_delayed_flow;
 	unsigned long	unthrottle_latency_ns;
 
@@ -157,6 +182,7 @@ struct fq_sched_data {
 	u64		stat_flows_plimit;
 	u64		stat_pkts_too_long;
 	u64		stat_allocation_errors;
+	u64		stat_wheel_slack_ns;
 };
 
 /* return the i-th 2-bit value ("crumb") */
@@ -210,14 +236,51 @@ static void fq_flow_add_tail(struct fq_sched_data *q, struct fq_flow *flow,
 	flow->next = NULL;
 }
 
+static void fq_wheel_remove(struct fq_wheel *w, struct fq_flow *f)
+{
+	list_del(&f->wheel_node);
+	if (list_empty(&w->slots[f->wheel_slot]))
+		__clear_bit(f->wheel_slot, w->map);
+	f->in_wheel = 0;
+	w->flows--;
+}
+
+static bool fq_wheel_insert(struct fq_sched_data *q, struct fq_flow *f)
+{
+	struct fq_wheel *w = q->wheel;
+	u64 slot = div_u64(f->time_next_packet, q->wheel_granularity);
+	u64 deadline;
+	u32 idx;
+
+	if (slot < w->time)
+		slot = w->time;
+	else if (slot - w->time >= FQ_WHEEL_SLOTS)
+		return false;
+
+	idx = slot & FQ_WHEEL_MASK;
+	list_add_tail(&f->wheel_node, &w->slots[idx]);
+	__set_bit(idx, w->map);
+	f->wheel_slot = idx;
+	f->in_wheel = 1;
+	w->flows++;
+
+	deadline = (slot + 1) * q->wheel_granularity;
+	if (q->time_next_delayed_flow > deadline)
+		q->time_next_delayed_flow = deadline;
+	return true;
+}
+
 static void fq_flow_unset_throttled(struct fq_sched_data *q, struct fq_flow *f)
 {
-	rb_erase(&f->rate_node, &q->delayed);
+	if (f->in_wheel)
+		fq_wheel_remove(q->wheel, f);
+	else
+		rb_erase(&f->rate_node, &q->delayed);
 	q->throttled_flows--;
 	fq_flow_add_tail(q, f, OLD_FLOW);
 }
 
-static void fq_flow_set_throttled(struct fq_sched_data *q, struct fq_flow *f)
+static void fq_delayed_insert(struct fq_sched_data *q, struct fq_flow *f)
 {
 	struct rb_node **p = &q->delayed.rb_node, *parent = NULL;
 
@@ -233,12 +296,78 @@ static void fq_flow_set_throttled(struct fq_sched_data *q, struct fq_flow *f)
 	}
 	rb_link_node(&f->rate_node, parent, p);
 	rb_insert_color(&f->rate_node, &q->delayed);
+
+	if (q->time_next_delayed_flow > f->time_next_packet)
+		q->time_next_delayed_flow = f->time_next_packet;
+}
+
+static void fq_flow_set_throttled(struct fq_sched_data *q, struct fq_flow *f)
+{
+	if (!q->wheel || !fq_wheel_insert(q, f))
+		fq_delayed_insert(q, f);
 	q->throttled_flows++;
 	q->stat_throttled++;
 
 	f->next = &throttled;
-	if (q->time_next_delayed_flow > f->time_next_packet)
-		q->time_next_delayed_flow = f->time_next_packet;
+}
+
+/* Release the flows of every wheel slot that fully elapsed before @now */
+static void fq_wheel_advance(struct fq_sched_data *q, u64 now)
+{
+	struct fq_wheel *w = q->wheel;
+	u64 end = div_u64(now, q->wheel_granularity);
+	struct fq_flow *f, *tmp;
+
+	while (w->flows) {
+		u32 cur = w->time & FQ_WHEEL_MASK;
+		u32 idx = find_next_bit_wrap(w->map, FQ_WHEEL_SLOTS, cur);
+		u64 slot = w->time + ((idx - cur) & FQ_WHEEL_MASK);
+
+		if (slot >= end) {
+			u64 deadline = (slot + 1) * q->wheel_granularity;
+
+			if (q->time_next_delayed_flow > deadline)
+				q->time_next_delayed_flow = deadline;
+			break;
+		}
+		list_for_each_entry_safe(f, tmp, &w->slots[idx], wheel_node) {
+			q->stat_wheel_slack_ns += now - f->time_next_packet;
+			fq_flow_unset_throttled(q, f);
+		}
+		w->time = slot + 1;
+	}
+	/* No flow sits in the slots before @end */
+	w->time = max(w->time, end);
+}
+
+/* Move every wheel flow to the rbtree, before the wheel goes or changes */
+static void fq_wheel_drain(struct fq_sched_data *q)
+{
+	struct fq_wheel *w = q->wheel;
+	struct fq_flow *f, *tmp;
+	unsigned int idx;
+
+	for_each_set_bit(idx, w->map, FQ_WHEEL_SLOTS) {
+		list_for_each_entry_safe(f, tmp, &w->slots[idx], wheel_node) {
+			list_del(&f->wheel_node);
+			f->in_wheel = 0;
+			fq_delayed_insert(q, f);
+		}
+	}
+	bitmap_zero(w->map, FQ_WHEEL_SLOTS);
+	w->flows = 0;
+}
+
+static struct fq_wheel *fq_wheel_alloc(void)
+{
+	struct fq_wheel *w = kvzalloc(sizeof(*w), GFP_KERNEL);
+	int i;
+
+	if (w) {
+		for (i = 0; i < FQ_WHEEL_SLOTS; i++)
+			INIT_LIST_HEAD(&w->slots[i]);
+	}
+	return w;
 }
 
 
@@ -623,11 +752,14 @@ static void fq_check_throttled(struct fq_sched_data *q, u64 now)
 	now += q->offload_horizon;
 
 	q->time_next_delayed_flow = ~0ULL;
+	if (q->wheel)
+		fq_wheel_advance(q, now);
 	while ((p = rb_first(&q->delayed)) != NULL) {
 		struct fq_flow *f = rb_entry(p, struct fq_flow, rate_node);
 
 		if (f->time_next_packet > now) {
-			q->time_next_delayed_flow = f->time_next_packet;
+			q->time_next_delayed_flow = min(q->time_next_delayed_flow,
+							f->time_next_packet);
 			break;
 		}
 		fq_flow_unset_throttled(q, f);
@@ -828,6 +960,12 @@ static void fq_reset(struct Qdisc *sch)
 		q->band_flows[idx].old_flows.first = NULL;
 	}
 	q->delayed		= RB_ROOT;
+	if (q->wheel) {
+		for_each_set_bit(idx, q->wheel->map, FQ_WHEEL_SLOTS)
+			INIT_LIST_HEAD(&q->wheel->slots[idx]);
+		bitmap_zero(q->wheel->map, FQ_WHEEL_SLOTS);
+		q->wheel->flows = 0;
+	}
 	q->flows		= 0;
 	q->inactive_flows	= 0;
 	q->throttled_flows	= 0;
@@ -943,6 +1081,7 @@ static const struct nla_policy fq_policy[TCA_FQ_MAX + 1] = {
 	[TCA_FQ_PRIOMAP]		= NLA_POLICY_EXACT_LEN(sizeof(struct tc_prio_qopt)),
 	[TCA_FQ_WEIGHTS]		= NLA_POLICY_EXACT_LEN(FQ_BANDS * sizeof(s32)),
 	[TCA_FQ_OFFLOAD_HORIZON]	= { .type = NLA_U32 },
+	[TCA_FQ_TIMER_WHEEL]		= NLA_POLICY_MAX(NLA_U32, NSEC_PER_MSEC),
 };
 
 /* compress a u8 array with all elems <= 3 to an array of 2-bit fields */
@@ -1015,6 +1154,7 @@ static int fq_change(struct Qdisc *sch, struct nlattr *opt,
 {
 	struct fq_sched_data *q = qdisc_priv(sch);
 	struct nlattr *tb[TCA_FQ_MAX + 1];
+	struct fq_wheel *wheel = NULL;
 	int err, drop_count = 0;
 	unsigned drop_len = 0;
 	u32 fq_log;
@@ -1024,6 +1164,13 @@ static int fq_change(struct Qdisc *sch, struct nlattr *opt,
 	if (err < 0)
 		return err;
 
+	if (tb[TCA_FQ_TIMER_WHEEL] && nla_get_u32(tb[TCA_FQ_TIMER_WHEEL]) &&
+	    !q->wheel) {
+		wheel = fq_wheel_alloc();
+		if (!wheel)
+			return -ENOMEM;
+	}
+
 	sch_tree_lock(sch);
 
 	fq_log = q->fq_trees_log;
@@ -1129,6 +1276,19 @@ static int fq_change(struct Qdisc *sch, struct nlattr *opt,
 			err = -EINVAL;
 		}
 	}
+
+	if (!err && tb[TCA_FQ_TIMER_WHEEL]) {
+		u32 granularity = nla_get_u32(tb[TCA_FQ_TIMER_WHEEL]);
+
+		/* Slot positions depend on the granularity, start over */
+		if (q->wheel)
+			fq_wheel_drain(q);
+		if (!granularity || wheel)
+			swap(wheel, q->wheel);
+		WRITE_ONCE(q->wheel_granularity, granularity);
+		if (q->wheel)
+			q->wheel->time = div_u64(ktime_get_ns(), granularity);
+	}
 	if (!err) {
 
 		sch_tree_unlock(sch);
@@ -1147,6 +1307,7 @@ static int fq_change(struct Qdisc *sch, struct nlattr *opt,
 	qdisc_tree_reduce_backlog(sch, drop_count, drop_len);
 
 	sch_tree_unlock(sch);
+	kvfree(wheel);
 	return err;
 }
 
@@ -1156,6 +1317,7 @@ static void fq_destroy(struct Qdisc *sch)
 
 	fq_reset(sch);
 	fq_free(q->fq_root);
+	kvfree(q->wheel);
 	qdisc_watchdog_cancel(&q->watchdog);
 }
 
@@ -1258,6 +1420,8 @@ static int fq_dump(struct Qdisc *sch, struct sk_buff *skb)
 			READ_ONCE(q->timer_slack)) ||
 	    nla_put_u32(skb, TCA_FQ_HORIZON, (u32)horizon) ||
 	    nla_put_u32(skb, TCA_FQ_OFFLOAD_HORIZON, (u32)offload_horizon) ||
+	    nla_put_u32(skb, TCA_FQ_TIMER_WHEEL,
+			READ_ONCE(q->wheel_granularity)) ||
 	    nla_put_u8(skb, TCA_FQ_HORIZON_DROP,
 		       READ_ONCE(q->horizon_drop)))
 		goto nla_put_failure;
@@ -1285,6 +1449,7 @@ static int fq_dump_stats(struct Qdisc *sch, struct gnet_dump *d)
 	int i;
 
 	st.pad = 0;
+	st.pad2 = 0;
 
 	sch_tree_lock(sch);
 
@@ -1306,6 +1471,8 @@ static int fq_dump_stats(struct Qdisc *sch, struct gnet_dump *d)
 	st.ce_mark		  = q->stat_ce_mark;
 	st.horizon_drops	  = q->stat_horizon_drops;
 	st.horizon_caps		  = q->stat_horizon_caps;
+	st.wheel_slack_ns	  = q->stat_wheel_slack_ns;
+	st.wheel_flows		  = q->wheel ? q->wheel->flows : 0;
 	for (i = 0; i < FQ_BANDS; i++) {
 		st.band_drops[i]  = q->stat_band_drops[i];
 		st.band_pkt_count[i] = q->band_pkt_count[i];
@@ -661,8 +661,11 @@ static inline void htb_accnt_tokens(struct htb_class *cl, int bytes, s64 diff)
 	if (toks > cl->buffer)
 		toks = cl->buffer;
 	toks -= (s64) psched_l2t_ns(&cl->rate, bytes);
-	if (toks <= -cl->mbuffer)
+	if (toks <= -cl->mbuffer) {
+		/* debt beyond mbuffer is forgiven, shaping drifts */
+		cl->xstats.tokens_clamped++;
 		toks = 1 - cl->mbuffer;
+	}
 
 	cl->tokens = toks;
 }
@@ -674,8 +677,10 @@ static inline void htb_accnt_ctokens(struct htb_class *cl, int bytes, s64 diff)
 	if (toks > cl->cbuffer)
 		toks = cl->cbuffer;
 	toks -= (s64) psched_l2t_ns(&cl->ceil, bytes);
-	if (toks <= -cl->mbuffer)
+	if (toks <= -cl->mbuffer) {
+		cl->xstats.ctokens_clamped++;
 		toks = 1 - cl->mbuffer;
+	}
 
 	cl->ctokens = toks;
 }
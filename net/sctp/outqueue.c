@@ -794,6 +794,9 @@ struct sctp_flush_ctx {
 	/* Packet on the current transport above */
 	struct sctp_packet *packet;
 	gfp_t gfp;
+	/* Number of new DATA chunks and packets sent by this flush */
+	unsigned int data_chunks;
+	unsigned int packets;
 };
 
 /* transport: current transport */
@@ -1137,6 +1140,7 @@ static void sctp_outq_flush_data(struct sctp_flush_ctx *ctx,
 		 * chunk as sent, sched-wise.
 		 */
 		sctp_sched_dequeue_done(ctx->q, chunk);
+		ctx->data_chunks++;
 
 		list_add_tail(&chunk->transmitted_list,
 			      &ctx->transport->transmitted);
@@ -1173,6 +1177,7 @@ static void sctp_outq_flush_transports(struct sctp_flush_ctx *ctx)
 			error = sctp_packet_transmit(packet, ctx->gfp);
 			if (error < 0)
 				ctx->q->asoc->base.sk->sk_err = -error;
+			ctx->packets++;
 		}
 
 		/* Clear the burst limited state, if any */
@@ -1219,6 +1224,13 @@ static void sctp_outq_flush(struct sctp_outq *q, int rtx_timeout, gfp_t gfp)
 sctp_flush_out:
 
 	sctp_outq_flush_transports(&ctx);
+
+	SCTP_INC_STATS(ctx.asoc->base.net, SCTP_MIB_OUTQ_FLUSHES);
+	if (!ctx.packets)
+		SCTP_INC_STATS(ctx.asoc->base.net, SCTP_MIB_OUTQ_IDLE_FLUSHES);
+	else
+		SCTP_ADD_STATS(ctx.asoc->base.net, SCTP_MIB_OUTQ_FLUSH_DATA_CHUNKS,
+			       ctx.data_chunks);
 }
 
 /* Update unack_data based on the incoming SACK chunk */
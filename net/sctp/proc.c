@@ -52,6 +52,9 @@ static const struct snmp_mib sctp_snmp_list[] = {
 	SNMP_MIB_ITEM("SctpInPktBacklog", SCTP_MIB_IN_PKT_BACKLOG),
 	SNMP_MIB_ITEM("SctpInPktDiscards", SCTP_MIB_IN_PKT_DISCARDS),
 	SNMP_MIB_ITEM("SctpInDataChunkDiscards", SCTP_MIB_IN_DATA_CHUNK_DISCARDS),
+	SNMP_MIB_ITEM("SctpOutqFlushes", SCTP_MIB_OUTQ_FLUSHES),
+	SNMP_MIB_ITEM("SctpOutqIdleFlushes", SCTP_MIB_OUTQ_IDLE_FLUSHES),
+	SNMP_MIB_ITEM("SctpOutqFlushDataChunks", SCTP_MIB_OUTQ_FLUSH_DATA_CHUNKS),
 	SNMP_MIB_SENTINEL
 };
 
@@ -85,6 +85,10 @@ static int smc_nl_fill_stats_rmb_data(struct sk_buff *skb,
 			      stats_rmb_cnt->dgrade_cnt,
 			      SMC_NLA_STATS_RMB_PAD))
 		goto errattr;
+	if (nla_put_u64_64bit(skb, SMC_NLA_STATS_RMB_ALLOC_TIME_US,
+			      stats_rmb_cnt->alloc_time_us,
+			      SMC_NLA_STATS_RMB_PAD))
+		goto errattr;
 
 	nla_nest_end(skb, attrs);
 	return 0;
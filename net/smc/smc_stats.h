@@ -54,6 +54,7 @@ struct smc_stats_rmbcnt {
 	u64	reuse_cnt;
 	u64	alloc_cnt;
 	u64	dgrade_cnt;
+	u64	alloc_time_us;	/* creating and mapping new buffers */
 };
 
 struct smc_stats_memsize {
@@ -197,6 +198,27 @@ do { \
 } \
 while (0)
 
+#define SMC_STAT_RMB_TIME_SUB(_smc_stats, t, key, _us) \
+	this_cpu_add((*(_smc_stats)).smc[t].rmb ## _ ## key.alloc_time_us, _us)
+
+#define SMC_STAT_RMB_ALLOC_TIME(_smc, _is_smcd, _is_rx, _us) \
+do { \
+	struct net *net = sock_net(&(_smc)->sk); \
+	struct smc_stats __percpu *_smc_stats = net->smc.smc_stats; \
+	typeof(_is_smcd) is_d = (_is_smcd); \
+	typeof(_is_rx) is_r = (_is_rx); \
+	typeof(_us) us = (_us); \
+	if ((is_d) && (is_r)) \
+		SMC_STAT_RMB_TIME_SUB(_smc_stats, SMC_TYPE_D, rx, us); \
+	if ((is_d) && !(is_r)) \
+		SMC_STAT_RMB_TIME_SUB(_smc_stats, SMC_TYPE_D, tx, us); \
+	if (!(is_d) && (is_r)) \
+		SMC_STAT_RMB_TIME_SUB(_smc_stats, SMC_TYPE_R, rx, us); \
+	if (!(is_d) && !(is_r)) \
+		SMC_STAT_RMB_TIME_SUB(_smc_stats, SMC_TYPE_R, tx, us); \
+} \
+while (0)
+
 #define SMC_STAT_BUF_REUSE(smc, is_smcd, is_rx) \
 	SMC_STAT_RMB(smc, reuse, is_smcd, is_rx)
 
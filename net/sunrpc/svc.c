@@ -545,6 +545,8 @@ __svc_create(struct svc_program *prog, int nprogs, struct svc_stat *stats,
 		percpu_counter_init(&pool->sp_messages_arrived, 0, GFP_KERNEL);
 		percpu_counter_init(&pool->sp_sockets_queued, 0, GFP_KERNEL);
 		percpu_counter_init(&pool->sp_threads_woken, 0, GFP_KERNEL);
+		percpu_counter_init(&pool->sp_queue_wait_us, 0, GFP_KERNEL);
+		percpu_counter_init(&pool->sp_threads_idle, 0, GFP_KERNEL);
 	}
 
 	return serv;
@@ -629,6 +631,8 @@ svc_destroy(struct svc_serv **servp)
 		percpu_counter_destroy(&pool->sp_messages_arrived);
 		percpu_counter_destroy(&pool->sp_sockets_queued);
 		percpu_counter_destroy(&pool->sp_threads_woken);
+		percpu_counter_destroy(&pool->sp_queue_wait_us);
+		percpu_counter_destroy(&pool->sp_threads_idle);
 	}
 	kfree(serv->sv_pools);
 	kfree(serv);
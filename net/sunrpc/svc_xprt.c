@@ -488,6 +488,7 @@ void svc_xprt_enqueue(struct svc_xprt *xprt)
 	pool = svc_pool_for_cpu(xprt->xpt_server);
 
 	percpu_counter_inc(&pool->sp_sockets_queued);
+	xprt->xpt_qtime = ktime_get();
 	lwq_enqueue(&xprt->xpt_ready, &pool->sp_xprts);
 
 	svc_pool_wake_idle_thread(pool);
@@ -502,8 +503,11 @@ static struct svc_xprt *svc_xprt_dequeue(struct svc_pool *pool)
 	struct svc_xprt	*xprt = NULL;
 
 	xprt = lwq_dequeue(&pool->sp_xprts, struct svc_xprt, xpt_ready);
-	if (xprt)
+	if (xprt) {
+		percpu_counter_add(&pool->sp_queue_wait_us,
+				   ktime_us_delta(ktime_get(), xprt->xpt_qtime));
 		svc_xprt_get(xprt);
+	}
 	return xprt;
 }
 
@@ -727,6 +731,7 @@ static void svc_thread_wait_for_work(struct svc_rqst *rqstp)
 
 	if (svc_thread_should_sleep(rqstp)) {
 		set_current_state(TASK_IDLE | TASK_FREEZABLE);
+		percpu_counter_inc(&pool->sp_threads_idle);
 		llist_add(&rqstp->rq_idle, &pool->sp_idle_threads);
 		if (likely(svc_thread_should_sleep(rqstp)))
 			schedule();
@@ -745,6 +750,7 @@ static void svc_thread_wait_for_work(struct svc_rqst *rqstp)
 			set_current_state(TASK_IDLE | TASK_FREEZABLE);
 		}
 		__set_current_state(TASK_RUNNING);
+		percpu_counter_dec(&pool->sp_threads_idle);
 	} else {
 		cond_resched();
 	}
@@ -1451,15 +1457,18 @@ static int svc_pool_stats_show(struct seq_file *m, void *p)
 	struct svc_pool *pool = p;
 
 	if (p == SEQ_START_TOKEN) {
-		seq_puts(m, "# pool packets-arrived sockets-enqueued threads-woken threads-timedout\n");
+		seq_puts(m, "# pool packets-arrived sockets-enqueued threads-woken threads-timedout queue-wait-usecs threads-busy\n");
 		return 0;
 	}
 
-	seq_printf(m, "%u %llu %llu %llu 0\n",
+	seq_printf(m, "%u %llu %llu %llu 0 %llu %lld\n",
 		   pool->sp_id,
 		   percpu_counter_sum_positive(&pool->sp_messages_arrived),
 		   percpu_counter_sum_positive(&pool->sp_sockets_queued),
-		   percpu_counter_sum_positive(&pool->sp_threads_woken));
+		   percpu_counter_sum_positive(&pool->sp_threads_woken),
+		   percpu_counter_sum_positive(&pool->sp_queue_wait_us),
+		   max_t(s64, 0, (s64)pool->sp_nrthreads -
+			 percpu_counter_sum_positive(&pool->sp_threads_idle)));
 
 	return 0;
 }
@@ -1621,6 +1621,7 @@ xprt_transmit(struct rpc_task *task)
 {
 	struct rpc_rqst *next, *req = task->tk_rqstp;
 	struct rpc_xprt	*xprt = req->rq_xprt;
+	unsigned long sends = xprt->stat.sends;
 	int status;
 
 	spin_lock(&xprt->queue_lock);
@@ -1648,6 +1649,10 @@ xprt_transmit(struct rpc_task *task)
 		cond_resched_lock(&xprt->queue_lock);
 	}
 	spin_unlock(&xprt->queue_lock);
+
+	/* stat.sends / stat.xmit_batches is the requests sent per call */
+	if (xprt->stat.sends != sends)
+		xprt->stat.xmit_batches++;
 }
 
 static void xprt_complete_request_init(struct rpc_task *task)
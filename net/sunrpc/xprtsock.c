@@ -2906,7 +2906,7 @@ static void xs_tcp_print_stats(struct rpc_xprt *xprt, struct seq_file *seq)
 		idle_time = (long)(jiffies - xprt->last_used) / HZ;
 
 	seq_printf(seq, "\txprt:\ttcp %u %lu %lu %lu %ld %lu %lu %lu "
-			"%llu %llu %lu %llu %llu\n",
+			"%llu %llu %lu %llu %llu %lu\n",
 			transport->srcport,
 			xprt->stat.bind_count,
 			xprt->stat.connect_count,
@@ -2919,7 +2919,8 @@ static void xs_tcp_print_stats(struct rpc_xprt *xprt, struct seq_file *seq)
 			xprt->stat.bklog_u,
 			xprt->stat.max_slots,
 			xprt->stat.sending_u,
-			xprt->stat.pending_u);
+			xprt->stat.pending_u,
+			xprt->stat.xmit_batches);
 }
 
 /*
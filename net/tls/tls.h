@@ -50,6 +50,8 @@
 	SNMP_INC_STATS((net)->mib.tls_statistics, field)
 #define TLS_DEC_STATS(net, field)				\
 	SNMP_DEC_STATS((net)->mib.tls_statistics, field)
+#define TLS_ADD_STATS(net, field, val)				\
+	SNMP_ADD_STATS((net)->mib.tls_statistics, field, val)
 
 struct tls_cipher_desc {
 	unsigned int nonce;
@@ -1104,6 +1104,18 @@ static int tls_get_info(struct sock *sk, struct sk_buff *skb, bool net_admin)
 		if (err)
 			goto nla_failure;
 	}
+	if (ctx->tx_conf == TLS_SW) {
+		struct tls_sw_context_tx *sw_ctx = tls_sw_ctx_tx(ctx);
+
+		err = nla_put_uint(skb, TLS_INFO_TX_RECORDS,
+				   READ_ONCE(sw_ctx->tx_records));
+		if (err)
+			goto nla_failure;
+		err = nla_put_uint(skb, TLS_INFO_TX_BATCHES,
+				   READ_ONCE(sw_ctx->tx_batches));
+		if (err)
+			goto nla_failure;
+	}
 
 	rcu_read_unlock();
 	nla_nest_end(skb, start);
@@ -1126,6 +1138,8 @@ static size_t tls_get_info_size(const struct sock *sk, bool net_admin)
 		nla_total_size(sizeof(u16)) +	/* TLS_INFO_TXCONF */
 		nla_total_size(0) +		/* TLS_INFO_ZC_RO_TX */
 		nla_total_size(0) +		/* TLS_INFO_RX_NO_PAD */
+		nla_total_size(sizeof(u64)) +	/* TLS_INFO_TX_RECORDS */
+		nla_total_size(sizeof(u64)) +	/* TLS_INFO_TX_BATCHES */
 		0;
 
 	return size;
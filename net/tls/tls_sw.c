@@ -818,6 +818,8 @@ static int tls_push_record(struct sock *sk, int flags,
 
 	rc = tls_do_encryption(sk, tls_ctx, ctx, req,
 			       msg_pl->sg.size + prot->tail_size, i);
+	if (rc >= 0 || rc == -EINPROGRESS)
+		WRITE_ONCE(ctx->tx_records, ctx->tx_records + 1);
 	if (rc < 0) {
 		if (rc != -EINPROGRESS) {
 			tls_err_abort(sk, -EBADMSG);
@@ -1013,6 +1015,7 @@ static int tls_sw_sendmsg_locked(struct sock *sk, struct msghdr *msg,
 	unsigned char record_type = TLS_RECORD_TYPE_DATA;
 	bool is_kvec = iov_iter_is_kvec(&msg->msg_iter);
 	bool eor = !(msg->msg_flags & MSG_MORE);
+	u64 tx_records = ctx->tx_records;
 	size_t try_to_copy;
 	ssize_t copied = 0;
 	struct sk_msg *msg_pl, *msg_en;
@@ -1219,6 +1222,8 @@ static int tls_sw_sendmsg_locked(struct sock *sk, struct msghdr *msg,
 	}
 
 send_end:
+	if (ctx->tx_records != tx_records)
+		WRITE_ONCE(ctx->tx_batches, ctx->tx_batches + 1);
 	ret = sk_stream_error(sk, msg->msg_flags, ret);
 	return copied > 0 ? copied : ret;
 }
@@ -1998,6 +2003,7 @@ int tls_sw_recvmsg(struct sock *sk,
 	struct tls_msg *tlm;
 	ssize_t copied = 0;
 	ssize_t peeked = 0;
+	int nr_async = 0;
 	bool async = false;
 	int target, err;
 	bool is_kvec = iov_iter_is_kvec(&msg->msg_iter);
@@ -2079,6 +2085,7 @@ int tls_sw_recvmsg(struct sock *sk,
 		}
 
 		async |= darg.async;
+		nr_async += darg.async;
 
 		/* If the type of records being processed is not known yet,
 		 * set it to record type just dequeued. If it is already known,
@@ -2176,6 +2183,9 @@ int tls_sw_recvmsg(struct sock *sk,
 
 		/* Wait for all previously submitted records to be decrypted */
 		ret = tls_decrypt_async_wait(ctx);
+		TLS_INC_STATS(sock_net(sk), LINUX_MIB_TLSRXASYNCBATCHES);
+		TLS_ADD_STATS(sock_net(sk), LINUX_MIB_TLSRXASYNCRECORDS,
+			      nr_async);
 		__skb_queue_purge(&ctx->async_hold);
 
 		if (ret) {
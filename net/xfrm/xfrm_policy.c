@@ -2091,7 +2091,8 @@ static struct xfrm_policy *
 __xfrm_policy_eval_candidates(struct hlist_head *chain,
 			      struct xfrm_policy *prefer,
 			      const struct flowi *fl,
-			      u8 type, u16 family, u32 if_id)
+			      u8 type, u16 family, u32 if_id,
+			      unsigned int *evals)
 {
 	u32 priority = prefer ? prefer->priority : ~0u;
 	struct xfrm_policy *pol;
@@ -2105,6 +2106,7 @@ __xfrm_policy_eval_candidates(struct hlist_head *chain,
 		if (pol->priority > priority)
 			break;
 
+		(*evals)++;
 		err = xfrm_policy_match(pol, fl, type, family, if_id);
 		if (err) {
 			if (err != -ESRCH)
@@ -2130,7 +2132,8 @@ static struct xfrm_policy *
 xfrm_policy_eval_candidates(struct xfrm_pol_inexact_candidates *cand,
 			    struct xfrm_policy *prefer,
 			    const struct flowi *fl,
-			    u8 type, u16 family, u32 if_id)
+			    u8 type, u16 family, u32 if_id,
+			    unsigned int *evals)
 {
 	struct xfrm_policy *tmp;
 	int i;
@@ -2138,7 +2141,8 @@ xfrm_policy_eval_candidates(struct xfrm_pol_inexact_candidates *cand,
 	for (i = 0; i < ARRAY_SIZE(cand->res); i++) {
 		tmp = __xfrm_policy_eval_candidates(cand->res[i],
 						    prefer,
-						    fl, type, family, if_id);
+						    fl, type, family, if_id,
+						    evals);
 		if (!tmp)
 			continue;
 
@@ -2160,6 +2164,7 @@ static struct xfrm_policy *xfrm_policy_lookup_bytype(struct net *net, u8 type,
 	struct xfrm_pol_inexact_bin *bin;
 	struct xfrm_policy *pol, *ret;
 	struct hlist_head *chain;
+	unsigned int evals = 0;
 	unsigned int sequence;
 	int err;
 
@@ -2177,6 +2182,7 @@ static struct xfrm_policy *xfrm_policy_lookup_bytype(struct net *net, u8 type,
 
 	ret = NULL;
 	hlist_for_each_entry_rcu(pol, chain, bydst) {
+		evals++;
 		err = xfrm_policy_match(pol, fl, type, family, if_id);
 		if (err) {
 			if (err == -ESRCH)
@@ -2199,7 +2205,7 @@ static struct xfrm_policy *xfrm_policy_lookup_bytype(struct net *net, u8 type,
 		goto skip_inexact;
 
 	pol = xfrm_policy_eval_candidates(&cand, ret, fl, type,
-					  family, if_id);
+					  family, if_id, &evals);
 	if (pol) {
 		ret = pol;
 		if (IS_ERR(pol))
@@ -2215,6 +2221,9 @@ static struct xfrm_policy *xfrm_policy_lookup_bytype(struct net *net, u8 type,
 fail:
 	rcu_read_unlock();
 
+	XFRM_INC_STATS(net, LINUX_MIB_XFRMPOLLOOKUPS);
+	XFRM_ADD_STATS(net, LINUX_MIB_XFRMPOLLOOKUPEVALS, evals);
+
 	return ret;
 }
 
@@ -45,6 +45,8 @@ static const struct snmp_mib xfrm_mib_list[] = {
 	SNMP_MIB_ITEM("XfrmInStateDirError", LINUX_MIB_XFRMINSTATEDIRERROR),
 	SNMP_MIB_ITEM("XfrmInIptfsError", LINUX_MIB_XFRMINIPTFSERROR),
 	SNMP_MIB_ITEM("XfrmOutNoQueueSpace", LINUX_MIB_XFRMOUTNOQSPACE),
+	SNMP_MIB_ITEM("XfrmPolicyLookups", LINUX_MIB_XFRMPOLLOOKUPS),
+	SNMP_MIB_ITEM("XfrmPolicyLookupEvals", LINUX_MIB_XFRMPOLLOOKUPEVALS),
 	SNMP_MIB_SENTINEL
 };
 
@@ -1048,6 +1048,16 @@ enum {
  *   backup port that has VLAN tunnel mapping enabled (via the
  *   *IFLA_BRPORT_VLAN_TUNNEL* option). Setting a value of 0 (default) has
  *   the effect of not attaching any ID.
+ *
+ * @IFLA_BRPORT_LEARNING_RATE
+ *   Sets the maximum number of FDB entries that can be dynamically learned
+ *   or moved to a given port per second. Source addresses seen beyond this
+ *   rate are not learned, but the packets are still forwarded. Setting a
+ *   limit of 0 disables the limit. The default value is 0.
+ *
+ * @IFLA_BRPORT_LEARNING_DROPS
+ *   Number of learning events dropped on a given port because of
+ *   *IFLA_BRPORT_LEARNING_RATE*.
  */
 enum {
 	IFLA_BRPORT_UNSPEC,
@@ -1095,6 +1105,8 @@ enum {
 	IFLA_BRPORT_MCAST_MAX_GROUPS,
 	IFLA_BRPORT_NEIGH_VLAN_SUPPRESS,
 	IFLA_BRPORT_BACKUP_NHID,
+	IFLA_BRPORT_LEARNING_RATE,
+	IFLA_BRPORT_LEARNING_DROPS,
 	__IFLA_BRPORT_MAX
 };
 #define IFLA_BRPORT_MAX (__IFLA_BRPORT_MAX - 1)
@@ -121,6 +121,10 @@ enum {
 	NETDEV_A_PAGE_POOL_STATS_RECYCLE_RING,
 	NETDEV_A_PAGE_POOL_STATS_RECYCLE_RING_FULL,
 	NETDEV_A_PAGE_POOL_STATS_RECYCLE_RELEASED_REFCNT,
+	NETDEV_A_PAGE_POOL_STATS_ALLOC_REMOTE,
+	NETDEV_A_PAGE_POOL_STATS_ALLOC_REMOTE_LATENCY,
+	NETDEV_A_PAGE_POOL_STATS_RECYCLE_REMOTE,
+	NETDEV_A_PAGE_POOL_STATS_RECYCLE_REMOTE_FULL,
 
 	__NETDEV_A_PAGE_POOL_STATS_MAX,
 	NETDEV_A_PAGE_POOL_STATS_MAX = (__NETDEV_A_PAGE_POOL_STATS_MAX - 1)
@@ -134,6 +138,10 @@ enum {
 	NETDEV_A_NAPI_DEFER_HARD_IRQS,
 	NETDEV_A_NAPI_GRO_FLUSH_TIMEOUT,
 	NETDEV_A_NAPI_IRQ_SUSPEND_TIMEOUT,
+	NETDEV_A_NAPI_ADAPTIVE,
+	NETDEV_A_NAPI_ADAPTIVE_LOAD,
+	NETDEV_A_NAPI_ADAPTIVE_DEFER_HARD_IRQS,
+	NETDEV_A_NAPI_ADAPTIVE_GRO_FLUSH_TIMEOUT,
 
 	__NETDEV_A_NAPI_MAX,
 	NETDEV_A_NAPI_MAX = (__NETDEV_A_NAPI_MAX - 1)
@@ -152,6 +160,13 @@ enum {
 	NETDEV_A_QUEUE_DMABUF,
 	NETDEV_A_QUEUE_IO_URING,
 	NETDEV_A_QUEUE_XSK,
+	NETDEV_A_QUEUE_RFS_COLLISIONS,
+	NETDEV_A_QUEUE_RFS_STEER_CHANGES,
+	NETDEV_A_QUEUE_RFS_FILTER_UPDATES,
+	NETDEV_A_QUEUE_DMABUF_BOUND_BYTES,
+	NETDEV_A_QUEUE_DMABUF_INUSE_BYTES,
+	NETDEV_A_QUEUE_DMABUF_TOKENS,
+	NETDEV_A_QUEUE_DMABUF_COPIED_BYTES,
 
 	__NETDEV_A_QUEUE_MAX,
 	NETDEV_A_QUEUE_MAX = (__NETDEV_A_QUEUE_MAX - 1)
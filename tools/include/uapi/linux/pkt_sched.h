@@ -426,6 +426,8 @@ struct tc_htb_xstats {
 	__u32 giants;	/* unused since 'Make HTB scheduler work with TSO.' */
 	__s32 tokens;
 	__s32 ctokens;
+	__u32 tokens_clamped;	/* rate debt beyond mbuffer was forgiven */
+	__u32 ctokens_clamped;	/* ceil debt beyond mbuffer was forgiven */
 };
 
 /* HFSC section */